@@ -198,6 +198,10 @@
 #	include <stdint.h>
 #endif
 
+#ifdef HAVE_SYS_INOTIFY_H
+#	include <sys/inotify.h>
+#endif
+
 #ifdef HAVE_SYS_LOADAVG_H
 #	include <sys/loadavg.h>
 #endif
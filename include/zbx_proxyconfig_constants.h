@@ -0,0 +1,29 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#ifndef ZABBIX_ZBX_PROXYCONFIG_CONSTANTS_H
+#define ZABBIX_ZBX_PROXYCONFIG_CONSTANTS_H
+
+/* proxy configuration table data formats, the proxy requests the highest format it supports */
+#define ZBX_PROXYCONFIG_FORMAT_JSON		0
+#define ZBX_PROXYCONFIG_FORMAT_BINARY		1
+
+#define ZBX_PROXYCONFIG_FORMAT_CURRENT		ZBX_PROXYCONFIG_FORMAT_BINARY
+
+/* binary format column value kinds, stored as 2 bits per row */
+#define ZBX_PROXYCONFIG_VALUE_NULL		0
+#define ZBX_PROXYCONFIG_VALUE_NUMBER		1
+#define ZBX_PROXYCONFIG_VALUE_STRING		2
+
+#endif
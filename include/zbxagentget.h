@@ -17,10 +17,18 @@
 
 #include "zbxjson.h"
 #include "module.h"
+#include "zbxversion.h"
+
+/* agents starting with this version support JSON protocol of passive checks, */
+/* where a request can contain multiple keys                                  */
+#define ZBX_AGENT_JSON_PROTOCOL_VERSION	ZBX_COMPONENT_VERSION(7, 0, 0)
 
 int	zbx_get_agent_protocol_version_int(const char *version_str);
 void	zbx_agent_prepare_request(struct zbx_json *j, const char *key, int timeout);
+void	zbx_agent_prepare_request_add(struct zbx_json *j, const char *key, int timeout);
 int	zbx_agent_handle_response(char *buffer, size_t read_bytes, ssize_t received_len, const char *addr,
 		AGENT_RESULT *result, int *version);
+int	zbx_agent_handle_bulk_response(const char *buffer, ssize_t received_len, const char *addr,
+		AGENT_RESULT **results, int *rets, int *num, int *version, char **error);
 
 #endif
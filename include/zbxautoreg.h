@@ -49,7 +49,8 @@ typedef void	(*zbx_autoreg_update_host_func_t)(const zbx_dc_proxy_t *proxy, cons
 		unsigned short flags, int clock, const zbx_events_funcs_t *events_cbs);
 
 typedef void	(*zbx_autoreg_flush_hosts_func_t)(zbx_vector_autoreg_host_ptr_t *autoreg_hosts,
-		const zbx_dc_proxy_t *proxy, const zbx_events_funcs_t *events_cbs);
+		const zbx_dc_proxy_t *proxy, const zbx_events_funcs_t *events_cbs,
+		zbx_vector_escalation_new_ptr_t *escalations);
 
 typedef void	(*zbx_autoreg_prepare_host_func_t)(zbx_vector_autoreg_host_ptr_t *autoreg_hosts, const char *host,
 		const char *ip, const char *dns, unsigned short port, unsigned int connection_type,
@@ -819,6 +819,10 @@ void	zbx_dc_config_history_sync_get_triggers_by_itemids(zbx_hashset_t *trigger_i
 		zbx_vector_dc_trigger_t *trigger_order, const zbx_uint64_t *itemids, const zbx_timespec_t *timespecs,
 		int itemids_num);
 void	zbx_dc_config_clean_history_sync_items(zbx_history_sync_item_t *items, int *errcodes, size_t num);
+void	zbx_dc_config_history_sync_get_items_export_info(const zbx_uint64_t *itemids, size_t num, char **names,
+		zbx_vector_tags_ptr_t *tags);
+void	zbx_dc_config_history_sync_get_hosts_groups(const zbx_uint64_t *hostids, size_t num,
+		zbx_vector_str_t *groups);
 void	zbx_dc_config_history_sync_unset_existing_itemids(zbx_vector_uint64_t *itemids);
 int	zbx_dc_config_history_get_trends_sec(const char *trends_period, int trends_global, int hk_trends);
 
@@ -1047,6 +1051,10 @@ void	zbx_dc_correlation_rules_get(zbx_correlation_rules_t *rules);
 
 void	zbx_dc_get_nested_hostgroupids(zbx_uint64_t *groupids, int groupids_num, zbx_vector_uint64_t *nested_groupids);
 void	zbx_dc_get_hostids_by_group_name(const char *name, zbx_vector_uint64_t *hostids);
+void	zbx_dc_get_hostids_by_groupids(const zbx_vector_uint64_t *groupids, zbx_vector_uint64_t *hostids);
+void	zbx_dc_get_trigger_hostids(zbx_vector_uint64_t *triggerids, zbx_vector_uint64_pair_t *trigger_hosts);
+void	zbx_dc_get_item_hostids(zbx_vector_uint64_t *itemids, zbx_vector_uint64_pair_t *item_hosts);
+void	zbx_dc_get_item_template_hostids(zbx_vector_uint64_t *itemids, zbx_vector_uint64_pair_t *item_templates);
 
 void	zbx_free_item_tag(zbx_item_tag_t *item_tag);
 
@@ -1321,7 +1329,7 @@ void	zbx_dc_drules_get(time_t now, zbx_vector_dc_drule_ptr_t *drules, time_t *ne
 void	zbx_dc_drule_queue(time_t now, zbx_uint64_t druleid, int delay);
 int	zbx_dc_drule_revisions_get(zbx_uint64_t *rev_last, zbx_vector_uint64_pair_t *revisions);
 
-int	zbx_dc_httptest_next(time_t now, zbx_uint64_t *httptestid, time_t *nextcheck);
+int	zbx_dc_httptest_next(time_t now, zbx_uint64_t *httptestid, zbx_uint64_t *revision, time_t *nextcheck);
 void	zbx_dc_httptest_queue(time_t now, zbx_uint64_t httptestid, int delay);
 
 void	zbx_dc_get_upstream_revision(zbx_uint64_t *config_revision, zbx_uint64_t *hostmap_revision);
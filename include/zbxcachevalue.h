@@ -120,4 +120,12 @@ void	zbx_vc_flush_stats(void);
 
 void	zbx_vc_add_new_items(const zbx_vector_uint64_pair_t *items);
 
+void	zbx_vc_batch_begin(void);
+int	zbx_vc_batch_deferred_num(void);
+void	zbx_vc_batch_end(void);
+
+int	zbx_vc_snapshot_save(const char *path, const char *runid, char **error);
+void	zbx_vc_snapshot_load(const char *path, const char *runid);
+void	zbx_vc_snapshot_remove(const char *path);
+
 #endif
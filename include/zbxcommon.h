@@ -299,7 +299,8 @@ const char	*get_program_type_string(unsigned char program_type);
 #define ZBX_PROCESS_TYPE_PG_MANAGER		45
 #define ZBX_PROCESS_TYPE_BROWSERPOLLER		46
 #define ZBX_PROCESS_TYPE_HA_MANAGER		47
-#define ZBX_PROCESS_TYPE_COUNT			48	/* number of process types */
+#define ZBX_PROCESS_TYPE_METRICS_EXPORTER	48
+#define ZBX_PROCESS_TYPE_COUNT			49	/* number of process types */
 
 /* special processes that are not present worker list */
 #define ZBX_PROCESS_TYPE_MAIN			126
@@ -55,6 +55,7 @@ CURLMcode	zbx_curl_multi_wait(CURLM *multi_handle, int timeout_ms, int *numfds);
 /* added in 7.55.0 (0x073700) */
 #if LIBCURL_VERSION_NUM < 0x073700
 #	define CURLINFO_SPEED_DOWNLOAD_T	CURLINFO_SPEED_DOWNLOAD
+#	define CURLINFO_SIZE_UPLOAD_T		CURLINFO_SIZE_UPLOAD
 #	define curl_off_t			double
 #endif
 
@@ -317,6 +317,7 @@ void	zbx_dbconn_prepare_insert(zbx_dbconn_t *db, zbx_db_insert_t *db_insert, con
 void	zbx_db_insert_add_values(zbx_db_insert_t *db_insert, ...);
 void	zbx_db_insert_add_values_dyn(zbx_db_insert_t *db_insert, zbx_db_value_t **values, int values_num);
 int	zbx_db_insert_execute(zbx_db_insert_t *db_insert);
+int	zbx_db_insert_append_sql(zbx_db_insert_t *db_insert, char **sql, size_t *sql_alloc, size_t *sql_offset);
 void	zbx_db_insert_autoincrement(zbx_db_insert_t *db_insert, const char *field_name);
 zbx_uint64_t	zbx_db_insert_get_lastid(zbx_db_insert_t *self);
 void	zbx_db_insert_clean(zbx_db_insert_t *db_insert);
@@ -24,6 +24,7 @@ typedef struct zbx_es_env zbx_es_env_t;
 typedef struct
 {
 	zbx_es_env_t	*env;
+	int		connection_cache_size;
 }
 zbx_es_t;
 
@@ -33,6 +34,7 @@ int	zbx_es_init_env(zbx_es_t *es, const char *config_source_ip, char **error);
 int	zbx_es_destroy_env(zbx_es_t *es, char **error);
 int	zbx_es_is_env_initialized(zbx_es_t *es);
 int	zbx_es_init_browser_env(zbx_es_t *es, const char *endpoint, char **error);
+void	zbx_es_set_connection_cache(zbx_es_t *es, int size);
 
 int		zbx_es_fatal_error(zbx_es_t *es);
 int		zbx_es_compile(zbx_es_t *es, const char *script, char **code, int *size, char **error);
@@ -23,9 +23,13 @@
 
 typedef struct
 {
-	char	*name;
-	FILE	*file;
-	int	missing;
+	char		*name;
+	FILE		*file;
+	int		missing;
+	zbx_uint64_t	size;		/* file size tracked to avoid querying position on every write */
+	zbx_uint64_t	dev;
+	zbx_uint64_t	ino;
+	time_t		lastcheck;	/* last time the file was checked for removal or rotation */
 }
 zbx_export_file_t;
 
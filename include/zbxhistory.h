@@ -73,6 +73,8 @@ int	zbx_history_add_values(const zbx_vector_dc_history_ptr_t *history, int *ret_
 		int config_history_storage_pipelines);
 int	zbx_history_get_values(zbx_uint64_t itemid, int value_type, int start, int count, int end,
 		zbx_vector_history_record_t *values);
+int	zbx_history_get_values_multi(const zbx_vector_uint64_t *itemids, int value_type, int start, int end,
+		zbx_vector_history_record_t *values);
 
 int	zbx_history_requires_trends(int value_type);
 void	zbx_history_check_version(struct zbx_json *json, int *result, int config_allow_unsupported_db_versions,
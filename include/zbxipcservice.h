@@ -39,6 +39,20 @@ typedef struct
 }
 zbx_ipc_message_t;
 
+/* message data segment, allows sending message data stored in several buffers without merging them */
+typedef struct
+{
+	const unsigned char	*data;
+	zbx_uint32_t		size;
+}
+zbx_ipc_data_t;
+
+/* reference counted message data, allows queuing the same data for sending to several clients */
+typedef struct zbx_ipc_buffer zbx_ipc_buffer_t;
+
+/* shared memory ring, optionally used to pass messages from client to service */
+typedef struct zbx_ipc_shm zbx_ipc_shm_t;
+
 /* Messaging socket, providing blocking connections to IPC service. */
 /* The IPC socket api is used for simple write/read operations.     */
 typedef struct
@@ -50,6 +64,9 @@ typedef struct
 	unsigned char	rx_buffer[ZBX_IPC_SOCKET_BUFFER_SIZE];
 	zbx_uint32_t	rx_buffer_bytes;
 	zbx_uint32_t	rx_buffer_offset;
+
+	/* shared memory ring attached to the connection (if any) */
+	zbx_ipc_shm_t	*shm;
 }
 zbx_ipc_socket_t;
 
@@ -99,6 +116,9 @@ void	zbx_ipc_service_alert(zbx_ipc_service_t *service);
 void	zbx_ipc_service_close(zbx_ipc_service_t *service);
 
 int	zbx_ipc_client_send(zbx_ipc_client_t *client, zbx_uint32_t code, const unsigned char *data, zbx_uint32_t size);
+int	zbx_ipc_client_sendv(zbx_ipc_client_t *client, zbx_uint32_t code, const zbx_ipc_data_t *segments,
+		int segments_num);
+int	zbx_ipc_client_send_buffer(zbx_ipc_client_t *client, zbx_uint32_t code, zbx_ipc_buffer_t *buffer);
 void	zbx_ipc_client_close(zbx_ipc_client_t *client);
 int	zbx_ipc_client_get_fd(zbx_ipc_client_t *client);
 
@@ -114,8 +134,11 @@ int	zbx_ipc_socket_open(zbx_ipc_socket_t *csocket, const char *service_name, int
 void	zbx_ipc_socket_close(zbx_ipc_socket_t *csocket);
 int	zbx_ipc_socket_write(zbx_ipc_socket_t *csocket, zbx_uint32_t code, const unsigned char *data,
 		zbx_uint32_t size);
+int	zbx_ipc_socket_writev(zbx_ipc_socket_t *csocket, zbx_uint32_t code, const zbx_ipc_data_t *segments,
+		int segments_num);
 int	zbx_ipc_socket_read(zbx_ipc_socket_t *csocket, zbx_ipc_message_t *message);
 int	zbx_ipc_socket_connected(const zbx_ipc_socket_t *csocket);
+int	zbx_ipc_socket_enable_shm(zbx_ipc_socket_t *csocket, zbx_uint32_t size, char **error);
 
 int	zbx_ipc_async_socket_open(zbx_ipc_async_socket_t *asocket, const char *service_name, int timeout, char **error);
 void	zbx_ipc_async_socket_close(zbx_ipc_async_socket_t *asocket);
@@ -128,6 +151,9 @@ int	zbx_ipc_async_socket_connected(zbx_ipc_async_socket_t *asocket);
 int	zbx_ipc_async_exchange(const char *service_name, zbx_uint32_t code, int timeout, const unsigned char *data,
 		zbx_uint32_t size, unsigned char **out, char **error);
 
+zbx_ipc_buffer_t	*zbx_ipc_buffer_create(unsigned char *data, zbx_uint32_t size);
+void	zbx_ipc_buffer_release(zbx_ipc_buffer_t *buffer);
+
 void	zbx_ipc_message_free(zbx_ipc_message_t *message);
 void	zbx_ipc_message_clean(zbx_ipc_message_t *message);
 void	zbx_ipc_message_init(zbx_ipc_message_t *message);
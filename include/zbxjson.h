@@ -195,6 +195,7 @@
 #define ZBX_PROTO_TAG_PROXYIDS			"proxyids"
 #define ZBX_PROTO_TAG_SUPPRESS_UNTIL		"suppress_until"
 #define ZBX_PROTO_TAG_CONFIG_REVISION		"config_revision"
+#define ZBX_PROTO_TAG_CONFIG_FORMAT		"config_format"
 #define ZBX_PROTO_TAG_FULL_SYNC			"full_sync"
 #define ZBX_PROTO_TAG_MACRO_SECRETS		"macro.secrets"
 #define ZBX_PROTO_TAG_REMOVED_HOSTIDS		"del_hostids"
@@ -109,7 +109,9 @@ int	zbx_async_check_snmp(zbx_dc_item_t *item, AGENT_RESULT *result, zbx_async_ta
 void	zbx_set_snmp_bulkwalk_options(const char *progname);
 #endif
 
-typedef struct
+typedef struct zbx_agent_context_s	zbx_agent_context;
+
+struct zbx_agent_context_s
 {
 	zbx_dc_item_context_t		item;
 	void				*arg;
@@ -128,14 +130,47 @@ typedef struct
 	zbx_async_rdns_step_t		rdns_step;
 	char				*reverse_dns;
 	struct zbx_json			j;
-}
-zbx_agent_context;
+
+	/* items of the same interface requested over this context connection */
+	zbx_agent_context		**bulk;
+	int				bulk_num;
+
+	/* bulk item value was returned by agent */
+	int				bulk_resolved;
+
+	/* agent responded, but did not return values of all bulk items */
+	int				bulk_retry;
+
+	/* agent returned values of all bulk items: 1 - yes, 0 - no, -1 - unknown (no response) */
+	int				bulk_supported;
+};
 
 void	zbx_async_check_agent_clean(zbx_agent_context *agent_context);
+int	zbx_async_check_agent_bulk_requeue(zbx_agent_context *agent_context, zbx_agent_context *bulk_context,
+		zbx_async_task_clear_cb_t clear_cb, struct event_base *base, struct evdns_base *dnsbase);
 
 int	zbx_async_check_agent(zbx_dc_item_t *item, AGENT_RESULT *result,  zbx_async_task_clear_cb_t clear_cb,
 		void *arg, void *arg_action, struct event_base *base, struct evdns_base *dnsbase,
 		const char *config_source_ip, zbx_async_resolve_reverse_dns_t resolve_reverse_dns);
+void	zbx_async_check_agent_bulk(zbx_dc_item_t *items, AGENT_RESULT *results, int *errcodes, const int *indexes,
+		int num, zbx_async_task_clear_cb_t clear_cb, void *arg, void *arg_action, struct event_base *base,
+		struct evdns_base *dnsbase, const char *config_source_ip);
+
+/* agent poller connection statistics */
+typedef struct
+{
+	zbx_uint64_t	requests;		/* connections made to agents */
+	zbx_uint64_t	items;			/* values requested over the connections */
+	zbx_uint64_t	bulk_requests;		/* connections used to request multiple values */
+	zbx_uint64_t	bulk_items;		/* values requested over such connections */
+	zbx_uint64_t	bulk_retries;		/* values not returned by agent and requested again */
+	int		interfaces_bulk;	/* interfaces returning multiple values per request */
+	int		interfaces_single;	/* interfaces returning only the first value */
+}
+zbx_async_agent_stats_t;
+
+int	zbx_async_agent_stats_init(int pollers_num, char **error);
+void	zbx_async_agent_add_diag_info(struct zbx_json *json, const char *section);
 
 typedef struct zbx_async_manager	zbx_async_manager_t;
 
@@ -150,6 +185,8 @@ typedef struct
 	int			processed;
 	int			queued;
 	int			processing;
+	zbx_async_agent_stats_t	*agent_stats;
+	zbx_hashset_t		agent_interfaces;
 	int			config_unavailable_delay;
 	int			config_unreachable_delay;
 	int			config_unreachable_period;
@@ -161,6 +198,7 @@ typedef struct
 	const char		*config_ssl_key_location;
 	struct event		*async_wake_timer;
 	struct event		*async_timer;
+	struct event		*preproc_flush_timer;
 	struct event_base	*base;
 	struct evdns_base	*dnsbase;
 	zbx_hashset_t		interfaces;
@@ -15,6 +15,8 @@
 #ifndef ZABBIX_PROF_H
 #define ZABBIX_PROF_H
 
+#include "zbxcommon.h"
+
 #define ZBX_PROF_UNKNOWN	0x00
 #define ZBX_PROF_PROCESSING	0x01
 #define ZBX_PROF_RWLOCK		0x02
@@ -23,6 +25,40 @@
 
 typedef int zbx_prof_scope_t;
 
+/* statically registered hot path probes, names are kept in prof.c */
+typedef enum
+{
+	ZBX_PROF_PROBE_CONFIG_LOCK = 0,
+	ZBX_PROF_PROBE_VALUECACHE_MISS,
+	ZBX_PROF_PROBE_DB_QUERY,
+	ZBX_PROF_PROBE_IPC_SEND,
+	ZBX_PROF_PROBE_IPC_RECV,
+	ZBX_PROF_PROBE_PREPROC_STEP,
+	ZBX_PROF_PROBE_COUNT
+}
+zbx_prof_probe_t;
+
+typedef struct
+{
+	zbx_uint64_t	le;	/* bucket upper bound in nanoseconds */
+	zbx_uint64_t	count;
+}
+zbx_prof_bucket_t;
+
+typedef struct
+{
+	const char		*name;
+	zbx_uint64_t		count;
+	zbx_uint64_t		total_ns;
+	zbx_uint64_t		max_ns;
+	zbx_uint64_t		p50_ns;
+	zbx_uint64_t		p90_ns;
+	zbx_uint64_t		p99_ns;
+	zbx_prof_bucket_t	*buckets;	/* non-empty histogram buckets */
+	int			buckets_num;
+}
+zbx_prof_probe_stats_t;
+
 void	zbx_prof_enable(zbx_prof_scope_t scope);
 void	zbx_prof_disable(void);
 void	zbx_prof_start(const char *func_name, zbx_prof_scope_t scope);
@@ -30,4 +66,10 @@ void	zbx_prof_end_wait(void);
 void	zbx_prof_end(void);
 void	zbx_prof_update(const char *info, double time_now);
 
+int	zbx_prof_probes_init(zbx_get_config_forks_f get_config_forks, char **error);
+void	zbx_prof_probe_start(zbx_prof_probe_t probe);
+void	zbx_prof_probe_end(zbx_prof_probe_t probe);
+int	zbx_prof_probes_get_stats(zbx_prof_probe_stats_t *stats, int *processes_num);
+void	zbx_prof_probes_clear_stats(zbx_prof_probe_stats_t *stats);
+
 #endif
@@ -134,4 +134,9 @@
 zbx_uint32_t	zbx_serialize_uint31_compact(unsigned char *ptr, zbx_uint32_t value);
 zbx_uint32_t	zbx_deserialize_uint31_compact(const unsigned char *ptr, zbx_uint32_t *value);
 
+#define ZBX_UINT64_COMPACT_LEN_MAX	10
+
+zbx_uint32_t	zbx_serialize_uint64_compact(unsigned char *ptr, zbx_uint64_t value);
+zbx_uint32_t	zbx_deserialize_uint64_compact(const unsigned char *ptr, const unsigned char *end, zbx_uint64_t *value);
+
 #endif /* ZABBIX_SERIALIZE_H */
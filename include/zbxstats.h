@@ -18,6 +18,7 @@
 #include "zbxalgo.h"
 #include "zbxcomms.h"
 #include "zbxjson.h"
+#include "zbxthreads.h"
 
 typedef void (*zbx_zabbix_stats_ext_get_func_t)(struct zbx_json *json, const void *arg);
 
@@ -53,4 +54,19 @@ zbx_process_info_t;
 typedef void (*zbx_zabbix_stats_procinfo_func_t)(zbx_process_info_t *info);
 void	zbx_register_stats_procinfo_func(int proc_type, zbx_zabbix_stats_procinfo_func_t procinfo_cb);
 
+typedef struct
+{
+	const char	*config_listen_ip;
+	int		config_listen_port;
+	const char	*config_stats_allowed_ip;
+	int		config_startup_time;
+	int		config_timeout;
+	int		config_tcp_max_backlog_size;
+}
+zbx_thread_metrics_exporter_args;
+
+void	zbx_metrics_get(int config_startup_time, char **out, size_t *out_alloc, size_t *out_offset);
+
+ZBX_THREAD_ENTRY(zbx_metrics_exporter_thread, args);
+
 #endif
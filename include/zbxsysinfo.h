@@ -109,6 +109,7 @@ int	zbx_execute_agent_check(const char *in_command, unsigned flags, AGENT_RESULT
 void	zbx_set_user_parameter_dir(const char *path);
 int	zbx_add_user_parameter(const char *itemkey, char *command, char *error, size_t max_error_len);
 void	zbx_remove_user_parameters(void);
+int	zbx_is_user_parameter(const char *key);
 void	zbx_get_metrics_copy(zbx_metric_t **metrics);
 void	zbx_set_metrics(zbx_metric_t *metrics);
 void	zbx_test_parameters(void);
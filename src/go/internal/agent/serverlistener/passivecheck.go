@@ -64,12 +64,30 @@ func (pc *passiveCheck) formatError(msg string) (data []byte) {
 	return
 }
 
+// performCheck performs single check of the passive checks request and returns its response data.
+func (pc *passiveCheck) performCheck(check passiveCheckRequestData) any {
+	var value *string
+
+	timeout, err := scheduler.ParseItemTimeoutAny(check.Timeout)
+	if err == nil {
+		// direct passive check timeout is handled by the scheduler
+		value, err = pc.scheduler.PerformTask(check.Key, time.Second*time.Duration(timeout), agent.PassiveChecksClientID)
+	}
+
+	if err != nil {
+		errString := err.Error()
+
+		return passiveChecksErrorResponseData{Error: &errString}
+	}
+
+	return passiveChecksResponseData{Value: value}
+}
+
 // handleCheckJSON handles json formatted passive check request.
 // False is returned if the json parsing failed and request must
 // be treated as plain text format request.
 func (pc *passiveCheck) handleCheckJSON(data []byte) (errJson error) {
 	var request passiveChecksRequest
-	var timeout int
 	var err error
 
 	errJson = json.Unmarshal(data, &request)
@@ -93,26 +111,15 @@ func (pc *passiveCheck) handleCheckJSON(data []byte) (errJson error) {
 			Error:   &errString,
 		}
 	} else {
-		var value *string
-
-		if timeout, err = scheduler.ParseItemTimeoutAny(request.Data[0].Timeout); err == nil {
-			// direct passive check timeout is handled by the scheduler
-			value, err = pc.scheduler.PerformTask(request.Data[0].Key, time.Second*time.Duration(timeout), agent.PassiveChecksClientID)
+		response = passiveChecksResponse{
+			Version: version.Long(),
+			Variant: agent.Variant,
+			Data:    make([]any, 0, len(request.Data)),
 		}
 
-		if err != nil {
-			errString := err.Error()
-			response = passiveChecksResponse{
-				Version: version.Long(),
-				Variant: agent.Variant,
-				Data:    []any{passiveChecksErrorResponseData{Error: &errString}},
-			}
-		} else {
-			response = passiveChecksResponse{
-				Version: version.Long(),
-				Variant: agent.Variant,
-				Data:    []any{passiveChecksResponseData{Value: value}},
-			}
+		// results are returned in the same order as the keys were requested
+		for _, check := range request.Data {
+			response.Data = append(response.Data, pc.performCheck(check))
 		}
 	}
 
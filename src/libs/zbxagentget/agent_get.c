@@ -38,12 +38,55 @@ void	zbx_agent_prepare_request(struct zbx_json *j, const char *key, int timeout)
 	zbx_json_addstring(j, ZBX_PROTO_TAG_REQUEST, ZBX_PROTO_VALUE_GET_PASSIVE_CHECKS, ZBX_JSON_TYPE_STRING);
 	zbx_json_addarray(j, ZBX_PROTO_TAG_DATA);
 
+	zbx_agent_prepare_request_add(j, key, timeout);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: appends item key to passive checks request data array, so         *
+ *          multiple keys are requested over the same connection              *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_agent_prepare_request_add(struct zbx_json *j, const char *key, int timeout)
+{
 	zbx_json_addobject(j, NULL);
 	zbx_json_addstring(j, ZBX_PROTO_TAG_KEY, key, ZBX_JSON_TYPE_STRING);
 	zbx_json_addint64(j, ZBX_PROTO_TAG_TIMEOUT, (zbx_int64_t)timeout);
 	zbx_json_close(j);
 }
 
+static int	agent_handle_response_row(const struct zbx_json_parse *jp_row, AGENT_RESULT *result)
+{
+	size_t		value_alloc = 0;
+	char		*value = NULL, tmp[MAX_STRING_LEN];
+	zbx_json_type_t	value_type;
+
+	if (SUCCEED == zbx_json_value_by_name(jp_row, ZBX_PROTO_TAG_ERROR, tmp, sizeof(tmp), NULL))
+	{
+		zbx_replace_invalid_utf8(tmp);
+		SET_MSG_RESULT(result, zbx_strdup(NULL, tmp));
+		return NOTSUPPORTED;
+	}
+
+	if (FAIL == zbx_json_value_by_name_dyn(jp_row, ZBX_PROTO_TAG_VALUE, &value, &value_alloc, &value_type))
+	{
+		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "cannot parse response: %s", zbx_json_strerror()));
+		return NETWORK_ERROR;
+	}
+
+	if (ZBX_JSON_TYPE_NULL != value_type)
+	{
+		zbx_replace_invalid_utf8(value);
+		SET_TEXT_RESULT(result, zbx_strdup(NULL, value));
+	}
+	else
+		zbx_free_agent_result(result);
+
+	zbx_free(value);
+
+	return SUCCEED;
+}
+
 int	zbx_agent_handle_response(char *buffer, size_t read_bytes, ssize_t received_len, const char *addr,
 		AGENT_RESULT *result, int *version)
 {
@@ -57,13 +100,11 @@ int	zbx_agent_handle_response(char *buffer, size_t read_bytes, ssize_t received_
 		return NETWORK_ERROR;
 	}
 
-	if (ZBX_COMPONENT_VERSION(7, 0, 0) <= *version)
+	if (ZBX_AGENT_JSON_PROTOCOL_VERSION <= *version)
 	{
 		struct zbx_json_parse	jp, jp_data, jp_row;
 		const char		*p = NULL;
-		size_t			value_alloc = 0;
-		char			*value = NULL, tmp[MAX_STRING_LEN];
-		zbx_json_type_t		value_type;
+		char			tmp[MAX_STRING_LEN];
 
 		if (FAIL == zbx_json_open(buffer, &jp))
 		{
@@ -106,32 +147,7 @@ int	zbx_agent_handle_response(char *buffer, size_t read_bytes, ssize_t received_
 			return NETWORK_ERROR;
 		}
 
-		if (SUCCEED == zbx_json_value_by_name(&jp_row, ZBX_PROTO_TAG_ERROR, tmp, sizeof(tmp), NULL))
-		{
-			zbx_replace_invalid_utf8(tmp);
-			SET_MSG_RESULT(result, zbx_strdup(NULL, tmp));
-			return NOTSUPPORTED;
-		}
-
-		if (FAIL == zbx_json_value_by_name_dyn(&jp_row, ZBX_PROTO_TAG_VALUE, &value, &value_alloc,
-				&value_type))
-		{
-			SET_MSG_RESULT(result, zbx_dsprintf(NULL, "cannot parse response: %s",
-					zbx_json_strerror()));
-			return NETWORK_ERROR;
-		}
-
-		if (ZBX_JSON_TYPE_NULL != value_type)
-		{
-			zbx_replace_invalid_utf8(value);
-			SET_TEXT_RESULT(result, zbx_strdup(NULL, value));
-		}
-		else
-			zbx_free_agent_result(result);
-
-		zbx_free(value);
-
-		return SUCCEED;
+		return agent_handle_response_row(&jp_row, result);
 	}
 
 	if (0 == strcmp(buffer, ZBX_NOTSUPPORTED))
@@ -156,3 +172,97 @@ int	zbx_agent_handle_response(char *buffer, size_t read_bytes, ssize_t received_
 		return SUCCEED;
 	}
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parses passive checks response containing results for multiple   *
+ *          keys requested over the same connection                           *
+ *                                                                            *
+ * Parameters: buffer       - [IN] received response                          *
+ *             received_len - [IN]                                            *
+ *             addr         - [IN] agent address                              *
+ *             results      - [OUT] results in the same order as requested    *
+ *                                  keys                                      *
+ *             rets         - [OUT] return codes of individual results        *
+ *             num          - [IN/OUT] number of requested keys on input,     *
+ *                                     number of returned results on output   *
+ *             version      - [OUT] agent protocol version                    *
+ *             error        - [OUT] error message when the whole request      *
+ *                                  failed                                    *
+ *                                                                            *
+ * Return value: SUCCEED       - response was parsed, *num results returned    *
+ *               NETWORK_ERROR - response contains top level error or is      *
+ *                               malformed                                    *
+ *               FAIL          - response is not in JSON format, agent does   *
+ *                               not support current protocol                 *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_agent_handle_bulk_response(const char *buffer, ssize_t received_len, const char *addr,
+		AGENT_RESULT **results, int *rets, int *num, int *version, char **error)
+{
+	struct zbx_json_parse	jp, jp_data, jp_row;
+	const char		*p = NULL;
+	char			tmp[MAX_STRING_LEN];
+	int			i;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "get values from agent bulk result: '%s'", buffer);
+
+	if (0 == received_len)
+	{
+		*error = zbx_dsprintf(NULL, "Received empty response from Zabbix Agent at [%s]."
+				" Assuming that agent dropped connection because of access permissions.", addr);
+		return NETWORK_ERROR;
+	}
+
+	if (FAIL == zbx_json_open(buffer, &jp))
+	{
+		*version = 0;
+		return FAIL;
+	}
+
+	if (FAIL == zbx_json_value_by_name(&jp, ZBX_PROTO_TAG_VERSION, tmp, sizeof(tmp), NULL))
+	{
+		*error = zbx_dsprintf(NULL, "cannot find the \"%s\" object in the received JSON object.",
+				ZBX_PROTO_TAG_VERSION);
+		return NETWORK_ERROR;
+	}
+
+	*version = zbx_get_agent_protocol_version_int(tmp);
+
+	if (SUCCEED == zbx_json_value_by_name(&jp, ZBX_PROTO_TAG_ERROR, tmp, sizeof(tmp), NULL))
+	{
+		zbx_replace_invalid_utf8(tmp);
+		*error = zbx_strdup(NULL, tmp);
+		return NETWORK_ERROR;
+	}
+
+	if (FAIL == zbx_json_brackets_by_name(&jp, ZBX_PROTO_TAG_DATA, &jp_data))
+	{
+		*error = zbx_dsprintf(NULL, "cannot find the \"%s\" object in the received JSON object.",
+				ZBX_PROTO_TAG_DATA);
+		return NETWORK_ERROR;
+	}
+
+	for (i = 0; i < *num && NULL != (p = zbx_json_next(&jp_data, p)); i++)
+	{
+		if (FAIL == zbx_json_brackets_open(p, &jp_row))
+		{
+			SET_MSG_RESULT(results[i], zbx_dsprintf(NULL, "cannot parse response: %s",
+					zbx_json_strerror()));
+			rets[i] = NETWORK_ERROR;
+			continue;
+		}
+
+		rets[i] = agent_handle_response_row(&jp_row, results[i]);
+	}
+
+	if (0 == i)
+	{
+		*error = zbx_strdup(NULL, "received empty data response");
+		return NETWORK_ERROR;
+	}
+
+	*num = i;
+
+	return SUCCEED;
+}
@@ -37,6 +37,9 @@
 
 #define	ALARM_ACTION_TIMEOUT	40
 
+/* maximum number of idle webhook connections kept open for reuse */
+#define	ALERTER_CONNECTION_CACHE_SIZE	16
+
 ZBX_PTR_VECTOR_IMPL(am_source_stats_ptr, zbx_am_source_stats_t *)
 
 static zbx_es_t	es_engine;
@@ -359,6 +362,7 @@ ZBX_THREAD_ENTRY(zbx_alerter_thread, args)
 	zbx_setproctitle("%s [connecting to the database]", get_process_type_string(process_type));
 
 	zbx_es_init(&es_engine);
+	zbx_es_set_connection_cache(&es_engine, ALERTER_CONNECTION_CACHE_SIZE);
 
 	zbx_ipc_message_init(&message);
 
@@ -433,6 +437,9 @@ ZBX_THREAD_ENTRY(zbx_alerter_thread, args)
 		zbx_ipc_message_clean(&message);
 	}
 
+	/* close cached webhook connections */
+	zbx_es_destroy(&es_engine);
+
 	zbx_setproctitle("%s #%d [terminated]", get_process_type_string(process_type), process_num);
 
 	while (1)
@@ -3762,6 +3762,7 @@ static void	DCsync_items(zbx_dbsync_t *sync, zbx_uint64_t revision, int flags, z
 		ZBX_DBROW2UINT64(interfaceid, row[19]);
 
 		dc_strpool_replace(found, &item->history_period, row[22]);
+		dc_strpool_replace(found, &item->name, row[50]);
 
 		ZBX_STR2UCHAR(item->inventory_link, row[24]);
 		ZBX_DBROW2UINT64(item->valuemapid, row[25]);
@@ -4043,6 +4044,7 @@ static void	DCsync_items(zbx_dbsync_t *sync, zbx_uint64_t revision, int flags, z
 			zbx_binary_heap_remove_direct(&config->queues[item->poller_type], item->itemid);
 
 		dc_strpool_release(item->key);
+		dc_strpool_release(item->name);
 		dc_strpool_release(item->error);
 		dc_strpool_release(item->delay);
 		dc_strpool_release(item->history_period);
@@ -6994,7 +6996,7 @@ static void	dc_sync_httpstep_fields(zbx_dbsync_t *sync, zbx_uint64_t revision)
 		httpstep_field = (zbx_dc_httpstep_field_t *)DCfind_id(&config->httpstep_fields, httpstep_fieldid,
 				sizeof(zbx_dc_httpstep_field_t), &found);
 
-		httpstep_field->httpstepid = httpstep_fieldid;
+		httpstep_field->httpstepid = httpstepid;
 
 	}
 
@@ -14728,6 +14730,231 @@ void	zbx_dc_get_hostids_by_group_name(const char *name, zbx_vector_uint64_t *hos
 	zbx_vector_uint64_uniq(hostids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets hostids belonging to the specified groups                    *
+ *                                                                            *
+ * Parameter: groupids - [IN] the group identifiers (nested groups must be    *
+ *                            already included)                               *
+ *            hostids  - [OUT] the sorted hostids                             *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_get_hostids_by_groupids(const zbx_vector_uint64_t *groupids, zbx_vector_uint64_t *hostids)
+{
+	RDLOCK_CACHE;
+
+	for (int i = 0; i < groupids->values_num; i++)
+	{
+		zbx_hashset_iter_t	iter;
+		zbx_uint64_t		*phostid;
+		zbx_dc_hostgroup_t	*group;
+
+		if (NULL == (group = (zbx_dc_hostgroup_t *)zbx_hashset_search(&config->hostgroups,
+				&groupids->values[i])))
+		{
+			continue;
+		}
+
+		zbx_hashset_iter_reset(&group->hostids, &iter);
+
+		while (NULL != (phostid = (zbx_uint64_t *)zbx_hashset_iter_next(&iter)))
+			zbx_vector_uint64_append(hostids, *phostid);
+	}
+
+	UNLOCK_CACHE;
+
+	zbx_vector_uint64_sort(hostids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_vector_uint64_uniq(hostids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets hosts of triggers from configuration cache                   *
+ *                                                                            *
+ * Parameter: triggerids    - [IN/OUT] the trigger identifiers, triggers      *
+ *                                     resolved from cache are removed        *
+ *            trigger_hosts - [OUT] the sorted (triggerid, hostid) pairs      *
+ *                                                                            *
+ * Comments: Triggers are resolved only if all their items are cached, the    *
+ *           remaining triggers must be resolved from database.               *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_get_trigger_hostids(zbx_vector_uint64_t *triggerids, zbx_vector_uint64_pair_t *trigger_hosts)
+{
+	int	i, j = 0, hosts_num;
+
+	RDLOCK_CACHE;
+
+	for (i = 0; i < triggerids->values_num; i++)
+	{
+		const ZBX_DC_TRIGGER	*dc_trigger;
+		const zbx_uint64_t	*pitemid;
+
+		hosts_num = trigger_hosts->values_num;
+
+		if (NULL == (dc_trigger = (const ZBX_DC_TRIGGER *)zbx_hashset_search(&config->triggers,
+				&triggerids->values[i])) || NULL == dc_trigger->itemids)
+		{
+			triggerids->values[j++] = triggerids->values[i];
+			continue;
+		}
+
+		for (pitemid = dc_trigger->itemids; 0 != *pitemid; pitemid++)
+		{
+			const ZBX_DC_ITEM	*dc_item;
+			zbx_uint64_pair_t	pair;
+
+			if (NULL == (dc_item = (const ZBX_DC_ITEM *)zbx_hashset_search(&config->items, pitemid)))
+				break;
+
+			pair.first = dc_trigger->triggerid;
+			pair.second = dc_item->hostid;
+			zbx_vector_uint64_pair_append(trigger_hosts, pair);
+		}
+
+		if (0 != *pitemid)
+		{
+			trigger_hosts->values_num = hosts_num;
+			triggerids->values[j++] = triggerids->values[i];
+		}
+	}
+
+	UNLOCK_CACHE;
+
+	triggerids->values_num = j;
+
+	zbx_vector_uint64_pair_sort(trigger_hosts, ZBX_DEFAULT_UINT64_PAIR_COMPARE_FUNC);
+	zbx_vector_uint64_pair_uniq(trigger_hosts, ZBX_DEFAULT_UINT64_PAIR_COMPARE_FUNC);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets hosts of items from configuration cache                      *
+ *                                                                            *
+ * Parameter: itemids    - [IN/OUT] the item identifiers, items resolved from *
+ *                                  cache are removed                         *
+ *            item_hosts - [OUT] the sorted (itemid, hostid) pairs            *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_get_item_hostids(zbx_vector_uint64_t *itemids, zbx_vector_uint64_pair_t *item_hosts)
+{
+	int	i, j = 0;
+
+	RDLOCK_CACHE;
+
+	for (i = 0; i < itemids->values_num; i++)
+	{
+		const ZBX_DC_ITEM	*dc_item;
+		zbx_uint64_pair_t	pair;
+
+		if (NULL == (dc_item = (const ZBX_DC_ITEM *)zbx_hashset_search(&config->items, &itemids->values[i])))
+		{
+			itemids->values[j++] = itemids->values[i];
+			continue;
+		}
+
+		pair.first = dc_item->itemid;
+		pair.second = dc_item->hostid;
+		zbx_vector_uint64_pair_append(item_hosts, pair);
+	}
+
+	UNLOCK_CACHE;
+
+	itemids->values_num = j;
+
+	zbx_vector_uint64_pair_sort(item_hosts, ZBX_DEFAULT_UINT64_PAIR_COMPARE_FUNC);
+}
+
+#define ZBX_DC_TEMPLATE_LEVELS_MAX	100
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets hosts of templates the items are inherited from              *
+ *                                                                            *
+ * Parameter: itemids        - [IN/OUT] the item identifiers, items resolved  *
+ *                                      from cache are removed                *
+ *            item_templates - [OUT] the sorted (itemid, template hostid)     *
+ *                                   pairs, (itemid, 0) pair is returned for  *
+ *                                   items not inherited from templates       *
+ *                                                                            *
+ * Comments: Discovered items are resolved through their prototypes. All      *
+ *           template levels are returned.                                    *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_get_item_template_hostids(zbx_vector_uint64_t *itemids, zbx_vector_uint64_pair_t *item_templates)
+{
+	int	i, j = 0, templates_num;
+
+	RDLOCK_CACHE;
+
+	for (i = 0; i < itemids->values_num; i++)
+	{
+		const ZBX_DC_ITEM		*dc_item;
+		const ZBX_DC_TEMPLATE_ITEM	*template_item;
+		zbx_uint64_t			templateid;
+		zbx_uint64_pair_t		pair = {itemids->values[i], 0};
+
+		if (NULL == (dc_item = (const ZBX_DC_ITEM *)zbx_hashset_search(&config->items, &itemids->values[i])))
+		{
+			itemids->values[j++] = itemids->values[i];
+			continue;
+		}
+
+		templateid = dc_item->templateid;
+
+		if (0 != (dc_item->flags & ZBX_FLAG_DISCOVERY_CREATED))
+		{
+			const ZBX_DC_ITEM_DISCOVERY	*item_discovery;
+
+			if (NULL == (item_discovery = (const ZBX_DC_ITEM_DISCOVERY *)zbx_hashset_search(
+					&config->item_discovery, &dc_item->itemid)) ||
+					NULL == (template_item = (const ZBX_DC_TEMPLATE_ITEM *)zbx_hashset_search(
+					&config->template_items, &item_discovery->parent_itemid)))
+			{
+				itemids->values[j++] = itemids->values[i];
+				continue;
+			}
+
+			templateid = template_item->templateid;
+		}
+
+		templates_num = item_templates->values_num;
+
+		/* template items form a tree, but limit levels in the case of inconsistent cache data */
+		for (int level = 0; 0 != templateid && ZBX_DC_TEMPLATE_LEVELS_MAX > level; level++)
+		{
+			if (NULL == (template_item = (const ZBX_DC_TEMPLATE_ITEM *)zbx_hashset_search(
+					&config->template_items, &templateid)))
+			{
+				break;
+			}
+
+			pair.second = template_item->hostid;
+			zbx_vector_uint64_pair_append(item_templates, pair);
+			templateid = template_item->templateid;
+		}
+
+		if (0 != templateid)
+		{
+			item_templates->values_num = templates_num;
+			itemids->values[j++] = itemids->values[i];
+			continue;
+		}
+
+		if (templates_num == item_templates->values_num)
+			zbx_vector_uint64_pair_append(item_templates, pair);
+	}
+
+	UNLOCK_CACHE;
+
+	itemids->values_num = j;
+
+	zbx_vector_uint64_pair_sort(item_templates, ZBX_DEFAULT_UINT64_PAIR_COMPARE_FUNC);
+	zbx_vector_uint64_pair_uniq(item_templates, ZBX_DEFAULT_UINT64_PAIR_COMPARE_FUNC);
+}
+
+#undef ZBX_DC_TEMPLATE_LEVELS_MAX
+
 /******************************************************************************
  *                                                                            *
  * Purpose: gets active proxy data by its name from configuration cache       *
@@ -17004,6 +17231,8 @@ int	zbx_dc_drule_revisions_get(zbx_uint64_t *rev_last, zbx_vector_uint64_pair_t
  *                                                                            *
  * Parameter: now        - [IN] the current timestamp                         *
  *            httptestid - [OUT] the id of httptest to be processed           *
+ *            revision   - [OUT] the configuration revision of httptest, its  *
+ *                               fields, steps and step fields                *
  *            nextcheck  - [OUT] the timestamp of next httptest to be         *
  *                               processed, if there is no httptest to be     *
  *                               processed now and the queue is not empty.    *
@@ -17013,7 +17242,7 @@ int	zbx_dc_drule_revisions_get(zbx_uint64_t *rev_last, zbx_vector_uint64_pair_t
  *               FAIL    - no httptests are scheduled at current time         *
  *                                                                            *
  ******************************************************************************/
-int	zbx_dc_httptest_next(time_t now, zbx_uint64_t *httptestid, time_t *nextcheck)
+int	zbx_dc_httptest_next(time_t now, zbx_uint64_t *httptestid, zbx_uint64_t *revision, time_t *nextcheck)
 {
 	zbx_binary_heap_elem_t	*elem;
 	zbx_dc_httptest_t	*httptest;
@@ -17051,6 +17280,7 @@ int	zbx_dc_httptest_next(time_t now, zbx_uint64_t *httptestid, time_t *nextcheck
 
 			httptest->location = ZBX_LOC_POLLER;
 			*httptestid = httptest->httptestid;
+			*revision = httptest->revision;
 
 			ret = SUCCEED;
 		}
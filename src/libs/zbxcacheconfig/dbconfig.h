@@ -285,6 +285,7 @@ typedef struct
 	zbx_uint64_t		lastlogsize;
 	zbx_uint64_t		valuemapid;
 	const char		*key;
+	const char		*name;
 	const char		*port;
 	const char		*error;
 	const char		*delay;
@@ -842,6 +843,8 @@ typedef struct
 	int			active_until;
 	int			running_since;
 	int			running_until;
+	int			next_update;	/* the earliest time when maintenance state can change, */
+						/* reset on maintenance or its period changes           */
 	zbx_vector_uint64_t	groupids;
 	zbx_vector_uint64_t	hostids;
 	zbx_vector_ptr_t	tags;
@@ -1076,9 +1079,41 @@ void	set_dc_config(zbx_dc_config_t *in);
 int		zbx_get_sync_in_progress(void);
 zbx_rwlock_t	zbx_get_config_lock(void);
 
-#define	RDLOCK_CACHE	do { if (0 == zbx_get_sync_in_progress()) zbx_rwlock_rdlock(zbx_get_config_lock()); } while(0)
-#define	WRLOCK_CACHE	do { if (0 == zbx_get_sync_in_progress()) zbx_rwlock_wrlock(zbx_get_config_lock()); } while(0)
-#define	UNLOCK_CACHE	do { if (0 == zbx_get_sync_in_progress()) zbx_rwlock_unlock(zbx_get_config_lock()); } while(0)
+#define	RDLOCK_CACHE							\
+									\
+do									\
+{									\
+	if (0 == zbx_get_sync_in_progress())				\
+	{								\
+		zbx_rwlock_rdlock(zbx_get_config_lock());		\
+		zbx_prof_probe_start(ZBX_PROF_PROBE_CONFIG_LOCK);	\
+	}								\
+}									\
+while(0)
+
+#define	WRLOCK_CACHE							\
+									\
+do									\
+{									\
+	if (0 == zbx_get_sync_in_progress())				\
+	{								\
+		zbx_rwlock_wrlock(zbx_get_config_lock());		\
+		zbx_prof_probe_start(ZBX_PROF_PROBE_CONFIG_LOCK);	\
+	}								\
+}									\
+while(0)
+
+#define	UNLOCK_CACHE							\
+									\
+do									\
+{									\
+	if (0 == zbx_get_sync_in_progress())				\
+	{								\
+		zbx_prof_probe_end(ZBX_PROF_PROBE_CONFIG_LOCK);		\
+		zbx_rwlock_unlock(zbx_get_config_lock());		\
+	}								\
+}									\
+while(0)
 
 zbx_rwlock_t	zbx_get_config_history_lock(void);
 
@@ -105,6 +105,7 @@ void	DCsync_maintenances(zbx_dbsync_t *sync)
 		ZBX_STR2UCHAR(maintenance->tags_evaltype, row[4]);
 		maintenance->active_since = atoi(row[2]);
 		maintenance->active_until = atoi(row[3]);
+		maintenance->next_update = 0;
 	}
 
 	/* remove deleted maintenances */
@@ -313,6 +314,8 @@ void	DCsync_maintenance_periods(zbx_dbsync_t *sync)
 
 		if (0 == found)
 			zbx_vector_ptr_append(&maintenance->periods, period);
+
+		maintenance->next_update = 0;
 	}
 
 	/* remove deleted maintenance tags */
@@ -333,6 +336,8 @@ void	DCsync_maintenance_periods(zbx_dbsync_t *sync)
 
 			if (FAIL != index)
 				zbx_vector_ptr_remove_noorder(&maintenance->periods, index);
+
+			maintenance->next_update = 0;
 		}
 
 		zbx_hashset_remove_direct(&config->maintenance_periods, period);
@@ -708,6 +713,68 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: calculates the earliest time when maintenance state can change    *
+ *                                                                            *
+ * Parameter: maintenance - [IN] the maintenance with calculated state        *
+ *            now         - [IN] current time                                 *
+ *                                                                            *
+ * Return value: the time when maintenance state must be recalculated         *
+ *                                                                            *
+ * Comments: Maintenance state can change only when the maintenance becomes   *
+ *           active or inactive, the running period ends or a new period      *
+ *           starts. Recurring periods can start only at their start time of  *
+ *           day, so the next occurrence of it is used without checking the   *
+ *           period schedule.                                                 *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_calculate_maintenance_next_update(const zbx_dc_maintenance_t *maintenance, time_t now)
+{
+	struct tm	tm;
+	time_t		next, period_start;
+	int		seconds;
+
+	if (now < maintenance->active_since)
+		return maintenance->active_since;
+
+	if (now >= maintenance->active_until)
+		return ZBX_JAN_2038;
+
+	next = maintenance->active_until;
+
+	if (ZBX_MAINTENANCE_RUNNING == maintenance->state && maintenance->running_until < next)
+		next = maintenance->running_until;
+
+	tm = *localtime(&now);
+	seconds = tm.tm_hour * SEC_PER_HOUR + tm.tm_min * SEC_PER_MIN + tm.tm_sec;
+
+	for (int i = 0; i < maintenance->periods.values_num; i++)
+	{
+		const zbx_dc_maintenance_period_t	*period;
+
+		period = (const zbx_dc_maintenance_period_t *)maintenance->periods.values[i];
+
+		if (TIMEPERIOD_TYPE_ONETIME == period->type)
+		{
+			period_start = period->start_date;
+		}
+		else
+		{
+			period_start = dc_subtract_time(now, seconds, &tm);
+			period_start = dc_subtract_time(period_start, -period->start_time, &tm);
+
+			if (period_start <= now)
+				period_start = dc_subtract_time(period_start, -SEC_PER_DAY, &tm);
+		}
+
+		if (period_start > now && period_start < next)
+			next = period_start;
+	}
+
+	return (int)next;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: sets maintenance update flags for all timers                      *
@@ -861,7 +928,8 @@ int	zbx_dc_update_maintenances(zbx_maintenance_timer_t maintenance_timer)
 	zbx_dc_maintenance_t		*maintenance;
 	zbx_dc_maintenance_period_t	*period;
 	zbx_hashset_iter_t		iter;
-	int				i, running_num = 0, started_num = 0, stopped_num = 0, ret = FAIL;
+	int				i, running_num = 0, started_num = 0, stopped_num = 0, skipped_num = 0,
+					ret = FAIL;
 	unsigned char			state;
 	time_t				now, period_start, period_end, running_since, running_until;
 	zbx_dc_config_t			*config = get_dc_config();
@@ -882,6 +950,16 @@ int	zbx_dc_update_maintenances(zbx_maintenance_timer_t maintenance_timer)
 	zbx_hashset_iter_reset(&config->maintenances, &iter);
 	while (NULL != (maintenance = (zbx_dc_maintenance_t *)zbx_hashset_iter_next(&iter)))
 	{
+		/* maintenance state cannot change before the precalculated time */
+		if (now < maintenance->next_update)
+		{
+			if (ZBX_MAINTENANCE_RUNNING == maintenance->state)
+				running_num++;
+
+			skipped_num++;
+			continue;
+		}
+
 		state = ZBX_MAINTENANCE_IDLE;
 		running_since = 0;
 		running_until = 0;
@@ -948,6 +1026,8 @@ int	zbx_dc_update_maintenances(zbx_maintenance_timer_t maintenance_timer)
 				ret = SUCCEED;
 			}
 		}
+
+		maintenance->next_update = dc_calculate_maintenance_next_update(maintenance, now);
 	}
 
 	if (MAINTENANCE_TIMER_PENDING == maintenance_timer)
@@ -957,8 +1037,8 @@ int	zbx_dc_update_maintenances(zbx_maintenance_timer_t maintenance_timer)
 
 	UNLOCK_CACHE;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() started:%d stopped:%d running:%d", __func__,
-			started_num, stopped_num, running_num);
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() started:%d stopped:%d running:%d skipped:%d", __func__,
+			started_num, stopped_num, running_num, skipped_num);
 
 	return ret;
 }
@@ -238,6 +238,109 @@ void	zbx_dc_config_clean_history_sync_items(zbx_history_sync_item_t *items, int
 	}
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets item names and tags for history/trends export                *
+ *                                                                            *
+ * Parameters: itemids - [IN] item identifiers                                *
+ *             num     - [IN] number of items                                 *
+ *             names   - [OUT] item names, NULL if item was not found         *
+ *             tags    - [OUT] item tags sorted by tag name, the vectors must *
+ *                             be created by caller                           *
+ *                                                                            *
+ * Comments: The history read lock is used, the same as for retrieving        *
+ *           history sync items.                                              *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_config_history_sync_get_items_export_info(const zbx_uint64_t *itemids, size_t num, char **names,
+		zbx_vector_tags_ptr_t *tags)
+{
+	const ZBX_DC_ITEM	*dc_item;
+	zbx_dc_config_t		*dc_config = get_dc_config();
+
+	RDLOCK_CACHE_CONFIG_HISTORY;
+
+	for (size_t i = 0; i < num; i++)
+	{
+		if (NULL == (dc_item = (ZBX_DC_ITEM *)zbx_hashset_search(&dc_config->items, &itemids[i])))
+		{
+			names[i] = NULL;
+			continue;
+		}
+
+		names[i] = zbx_strdup(NULL, dc_item->name);
+
+		for (int j = 0; j < dc_item->tags.values_num; j++)
+		{
+			const zbx_dc_item_tag_t	*dc_tag = &dc_item->tags.values[j];
+			zbx_tag_t		*tag;
+
+			tag = (zbx_tag_t *)zbx_malloc(NULL, sizeof(zbx_tag_t));
+			tag->tag = zbx_strdup(NULL, dc_tag->tag);
+			tag->value = zbx_strdup(NULL, dc_tag->value);
+			zbx_vector_tags_ptr_append(&tags[i], tag);
+		}
+	}
+
+	UNLOCK_CACHE_CONFIG_HISTORY;
+
+	for (size_t i = 0; i < num; i++)
+		zbx_vector_tags_ptr_sort(&tags[i], zbx_compare_tags);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets host group names for history/trends export                   *
+ *                                                                            *
+ * Parameters: hostids - [IN] sorted host identifiers                         *
+ *             num     - [IN] number of hosts                                 *
+ *             groups  - [OUT] host group names sorted by name, the vectors   *
+ *                             must be created by caller                      *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_config_history_sync_get_hosts_groups(const zbx_uint64_t *hostids, size_t num,
+		zbx_vector_str_t *groups)
+{
+	zbx_dc_config_t	*dc_config = get_dc_config();
+
+	RDLOCK_CACHE_CONFIG_HISTORY;
+
+	/* host groups are indexed by name, so iterating them keeps group names sorted for each host */
+	for (int i = 0; i < dc_config->hostgroups_name.values_num; i++)
+	{
+		zbx_dc_hostgroup_t	*group = (zbx_dc_hostgroup_t *)dc_config->hostgroups_name.values[i];
+
+		if ((size_t)group->hostids.num_data < num)
+		{
+			zbx_hashset_iter_t	iter;
+			zbx_uint64_t		*phostid, *pindex;
+
+			zbx_hashset_iter_reset(&group->hostids, &iter);
+
+			while (NULL != (phostid = (zbx_uint64_t *)zbx_hashset_iter_next(&iter)))
+			{
+				if (NULL == (pindex = (zbx_uint64_t *)bsearch(phostid, hostids, num,
+						sizeof(zbx_uint64_t), ZBX_DEFAULT_UINT64_COMPARE_FUNC)))
+				{
+					continue;
+				}
+
+				zbx_vector_str_append(&groups[pindex - hostids], zbx_strdup(NULL, group->name));
+			}
+		}
+		else
+		{
+			for (size_t j = 0; j < num; j++)
+			{
+				if (NULL != zbx_hashset_search(&group->hostids, &hostids[j]))
+					zbx_vector_str_append(&groups[j], zbx_strdup(NULL, group->name));
+			}
+		}
+	}
+
+	UNLOCK_CACHE_CONFIG_HISTORY;
+}
+
 int	zbx_dc_config_history_get_trends_sec(const char *trends_period, int trends_global, int hk_trends)
 {
 	int	trends_sec;
@@ -950,7 +950,7 @@ int	zbx_trend_compare(const void *d1, const void *d2)
 typedef struct
 {
 	zbx_uint64_t		hostid;
-	zbx_vector_ptr_t	groups;
+	zbx_vector_str_t	groups;
 }
 zbx_host_info_t;
 
@@ -963,8 +963,8 @@ zbx_host_info_t;
  ******************************************************************************/
 static void	zbx_host_info_clean(zbx_host_info_t *host_info)
 {
-	zbx_vector_ptr_clear_ext(&host_info->groups, zbx_ptr_free);
-	zbx_vector_ptr_destroy(&host_info->groups);
+	zbx_vector_str_clear_ext(&host_info->groups, zbx_str_free);
+	zbx_vector_str_destroy(&host_info->groups);
 }
 
 /******************************************************************************
@@ -972,56 +972,28 @@ static void	zbx_host_info_clean(zbx_host_info_t *host_info)
  * Purpose: get hosts groups names                                            *
  *                                                                            *
  * Parameters: hosts_info - [IN/OUT] output names of host groups for a host   *
- *             hostids    - [IN] hosts identifiers                            *
+ *             hostids    - [IN] sorted hosts identifiers                     *
  *                                                                            *
  ******************************************************************************/
-static void	db_get_hosts_info_by_hostid(zbx_hashset_t *hosts_info, const zbx_vector_uint64_t *hostids)
+static void	dc_get_hosts_info_by_hostid(zbx_hashset_t *hosts_info, const zbx_vector_uint64_t *hostids)
 {
-	int		i;
-	size_t		sql_offset = 0;
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
-	zbx_host_info_t		*host_info;
-	zbx_hashset_iter_t	iter;
-
-	for (i = 0; i < hostids->values_num; i++)
-	{
-		zbx_host_info_t	host_info_new = {.hostid = hostids->values[i]};
+	zbx_vector_str_t	*groups;
 
-		zbx_vector_ptr_create(&host_info_new.groups);
-		zbx_hashset_insert(hosts_info, &host_info_new, sizeof(host_info_new));
-	}
-
-	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
-				"select distinct hg.hostid,g.name"
-				" from hstgrp g,hosts_groups hg"
-				" where g.groupid=hg.groupid"
-					" and");
+	groups = (zbx_vector_str_t *)zbx_malloc(NULL, sizeof(zbx_vector_str_t) * (size_t)hostids->values_num);
 
-	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "hg.hostid", hostids->values, hostids->values_num);
+	for (int i = 0; i < hostids->values_num; i++)
+		zbx_vector_str_create(&groups[i]);
 
-	result = zbx_db_select("%s", sql);
+	zbx_dc_config_history_sync_get_hosts_groups(hostids->values, (size_t)hostids->values_num, groups);
 
-	while (NULL != (row = zbx_db_fetch(result)))
+	for (int i = 0; i < hostids->values_num; i++)
 	{
-		zbx_uint64_t	hostid;
-
-		ZBX_DBROW2UINT64(hostid, row[0]);
+		zbx_host_info_t	host_info_new = {.hostid = hostids->values[i], .groups = groups[i]};
 
-		if (NULL == (host_info = (zbx_host_info_t *)zbx_hashset_search(hosts_info, &hostid)))
-		{
-			THIS_SHOULD_NEVER_HAPPEN;
-			continue;
-		}
-
-		zbx_vector_ptr_append(&host_info->groups, zbx_strdup(NULL, row[1]));
+		zbx_hashset_insert(hosts_info, &host_info_new, sizeof(host_info_new));
 	}
 
-	zbx_hashset_iter_reset(hosts_info, &iter);
-	while (NULL != (host_info = (zbx_host_info_t *)zbx_hashset_iter_next(&iter)))
-		zbx_vector_ptr_sort(&host_info->groups, ZBX_DEFAULT_STR_COMPARE_FUNC);
-
-	zbx_db_free_result(result);
+	zbx_free(groups);
 }
 
 typedef struct
@@ -1035,109 +1007,46 @@ zbx_item_info_t;
 
 /******************************************************************************
  *                                                                            *
- * Purpose: get item names                                                    *
+ * Purpose: get item names and item tags                                      *
  *                                                                            *
- * Parameters: items_info - [IN/OUT] output item names                        *
+ * Parameters: items_info - [IN/OUT] output item name and item tags           *
  *             itemids    - [IN] the item identifiers                         *
  *                                                                            *
  ******************************************************************************/
-static void	db_get_item_names_by_itemid(zbx_hashset_t *items_info, const zbx_vector_uint64_t *itemids)
+static void	dc_get_items_info_by_itemid(zbx_hashset_t *items_info, const zbx_vector_uint64_t *itemids)
 {
-	size_t		sql_offset = 0;
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
+	char			**names;
+	zbx_vector_tags_ptr_t	*tags;
 
-	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "select itemid,name from items where");
-	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "itemid", itemids->values, itemids->values_num);
+	names = (char **)zbx_malloc(NULL, sizeof(char *) * (size_t)itemids->values_num);
+	tags = (zbx_vector_tags_ptr_t *)zbx_malloc(NULL, sizeof(zbx_vector_tags_ptr_t) * (size_t)itemids->values_num);
 
-	result = zbx_db_select("%s", sql);
+	for (int i = 0; i < itemids->values_num; i++)
+		zbx_vector_tags_ptr_create(&tags[i]);
 
-	while (NULL != (row = zbx_db_fetch(result)))
+	zbx_dc_config_history_sync_get_items_export_info(itemids->values, (size_t)itemids->values_num, names, tags);
+
+	for (int i = 0; i < itemids->values_num; i++)
 	{
-		zbx_uint64_t	itemid;
 		zbx_item_info_t	*item_info;
 
-		ZBX_DBROW2UINT64(itemid, row[0]);
-
-		if (NULL == (item_info = (zbx_item_info_t *)zbx_hashset_search(items_info, &itemid)))
+		if (NULL == (item_info = (zbx_item_info_t *)zbx_hashset_search(items_info, &itemids->values[i])))
 		{
 			THIS_SHOULD_NEVER_HAPPEN;
-			continue;
+			zbx_free(names[i]);
+			zbx_vector_tags_ptr_clear_ext(&tags[i], zbx_free_tag);
 		}
-
-		item_info->name = zbx_strdup(item_info->name, row[1]);
-	}
-
-	zbx_db_free_result(result);
-}
-
-/******************************************************************************
- *                                                                            *
- * Purpose: get item tags                                                     *
- *                                                                            *
- * Parameters: items_info - [IN/OUT] output item tags                         *
- *             itemids    - [IN] the item identifiers                         *
- *                                                                            *
- ******************************************************************************/
-static void	db_get_item_tags_by_itemid(zbx_hashset_t *items_info, const zbx_vector_uint64_t *itemids)
-{
-	size_t		sql_offset = 0;
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
-	zbx_item_info_t	*item_info = NULL;
-
-	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "select itemid,tag,value from item_tag where");
-	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "itemid", itemids->values, itemids->values_num);
-	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, " order by itemid");
-
-	result = zbx_db_select("%s", sql);
-
-	while (NULL != (row = zbx_db_fetch(result)))
-	{
-		zbx_uint64_t	itemid;
-		zbx_tag_t	*item_tag;
-
-		ZBX_DBROW2UINT64(itemid, row[0]);
-
-		if (NULL == item_info || item_info->itemid != itemid)
+		else
 		{
-			if (NULL != item_info)
-			{
-				zbx_vector_tags_ptr_sort(&item_info->item_tags, zbx_compare_tags);
-			}
-			if (NULL == (item_info = (zbx_item_info_t *)zbx_hashset_search(items_info, &itemid)))
-			{
-				THIS_SHOULD_NEVER_HAPPEN;
-				continue;
-			}
+			item_info->name = names[i];
+			zbx_vector_tags_ptr_append_array(&item_info->item_tags, tags[i].values, tags[i].values_num);
 		}
 
-		item_tag = (zbx_tag_t *)zbx_malloc(NULL, sizeof(*item_tag));
-		item_tag->tag = zbx_strdup(NULL, row[1]);
-		item_tag->value = zbx_strdup(NULL, row[2]);
-		zbx_vector_tags_ptr_append(&item_info->item_tags, item_tag);
-	}
-
-	if (NULL != item_info)
-	{
-		zbx_vector_tags_ptr_sort(&item_info->item_tags, zbx_compare_tags);
+		zbx_vector_tags_ptr_destroy(&tags[i]);
 	}
 
-	zbx_db_free_result(result);
-}
-
-/******************************************************************************
- *                                                                            *
- * Purpose: get item names and item tags                                      *
- *                                                                            *
- * Parameters: items_info - [IN/OUT] output item name and item tags           *
- *             itemids    - [IN] the item identifiers                         *
- *                                                                            *
- ******************************************************************************/
-static void	db_get_items_info_by_itemid(zbx_hashset_t *items_info, const zbx_vector_uint64_t *itemids)
-{
-	db_get_item_names_by_itemid(items_info, itemids);
-	db_get_item_tags_by_itemid(items_info, itemids);
+	zbx_free(tags);
+	zbx_free(names);
 }
 
 /******************************************************************************
@@ -1542,6 +1451,7 @@ void	zbx_dc_export_history_and_trends(const zbx_dc_history_t *history, int histo
 		goto clean;
 
 	zbx_vector_uint64_sort(&item_info_ids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_vector_uint64_uniq(&item_info_ids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 	zbx_vector_uint64_sort(&hostids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 	zbx_vector_uint64_uniq(&hostids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
@@ -1549,9 +1459,8 @@ void	zbx_dc_export_history_and_trends(const zbx_dc_history_t *history, int histo
 			ZBX_DEFAULT_UINT64_COMPARE_FUNC, (zbx_clean_func_t)zbx_host_info_clean,
 			ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
 
-	db_get_hosts_info_by_hostid(&hosts_info, &hostids);
-
-	db_get_items_info_by_itemid(&items_info, &item_info_ids);
+	dc_get_hosts_info_by_hostid(&hosts_info, &hostids);
+	dc_get_items_info_by_itemid(&items_info, &item_info_ids);
 
 	if (0 != history_num)
 	{
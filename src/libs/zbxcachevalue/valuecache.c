@@ -20,6 +20,7 @@
 #include "zbxalgo.h"
 #include "zbxhistory.h"
 #include "zbxshmem.h"
+#include "zbxstr.h"
 
 /*
  * The cache (zbx_vc_cache_t) is organized as a hashset of item records (zbx_vc_item_t).
@@ -258,6 +259,28 @@ ZBX_VECTOR_IMPL(vc_itemupdate, zbx_vc_item_update_t)
 
 static zbx_vector_vc_itemupdate_t	vc_itemupdates;
 
+/* deferred request of item not cached in value cache */
+typedef struct
+{
+	zbx_uint64_t	itemid;
+	int		range_start;
+	unsigned char	value_type;
+}
+zbx_vc_batch_request_t;
+
+ZBX_VECTOR_DECL(vc_batch_request, zbx_vc_batch_request_t)
+ZBX_VECTOR_IMPL(vc_batch_request, zbx_vc_batch_request_t)
+
+/* the requests of items not in cache, collected during batch to be read with multi-item queries */
+static zbx_vector_vc_batch_request_t	vc_batch_requests;
+static int				vc_batch_started = 0;
+
+/* the period to read for count based requests without time limit */
+#define VC_BATCH_COUNT_PERIOD	(10 * SEC_PER_MIN)
+
+/* batch request start time is rounded down to group requests with close ranges into one query */
+#define VC_BATCH_RANGE_STEP	SEC_PER_MIN
+
 static void	vc_cache_item_update(zbx_uint64_t itemid, zbx_vc_item_update_type_t type, int arg1, int arg2)
 {
 	zbx_vc_item_update_t	*update;
@@ -1972,7 +1995,11 @@ static int	vch_item_cache_values_by_time(zbx_vc_item_t **item, int range_start)
 
 	UNLOCK_CACHE;
 
-	if (SUCCEED == (ret = vc_db_read_values_by_time(itemid, value_type, &records, range_start, range_end)))
+	zbx_prof_probe_start(ZBX_PROF_PROBE_VALUECACHE_MISS);
+	ret = vc_db_read_values_by_time(itemid, value_type, &records, range_start, range_end);
+	zbx_prof_probe_end(ZBX_PROF_PROBE_VALUECACHE_MISS);
+
+	if (SUCCEED == ret)
 	{
 		zbx_vector_history_record_sort(&records,
 				(zbx_compare_func_t)zbx_history_record_compare_asc_func);
@@ -2075,6 +2102,7 @@ static int	vch_item_cache_values_by_time_and_count(zbx_vc_item_t **item, int ran
 	UNLOCK_CACHE;
 
 	zbx_vector_history_record_create(&records);
+	zbx_prof_probe_start(ZBX_PROF_PROBE_VALUECACHE_MISS);
 
 	if (range_end > ts->sec)
 	{
@@ -2084,8 +2112,15 @@ static int	vch_item_cache_values_by_time_and_count(zbx_vc_item_t **item, int ran
 
 	records_offset = records.values_num;
 
-	if (SUCCEED == ret && SUCCEED == (ret = vc_db_read_values_by_time_and_count(itemid, value_type, &records,
-			range_start, count - cached_records, range_end, ts)))
+	if (SUCCEED == ret)
+	{
+		ret = vc_db_read_values_by_time_and_count(itemid, value_type, &records, range_start,
+				count - cached_records, range_end, ts);
+	}
+
+	zbx_prof_probe_end(ZBX_PROF_PROBE_VALUECACHE_MISS);
+
+	if (SUCCEED == ret)
 	{
 		zbx_vector_history_record_sort(&records,
 				(zbx_compare_func_t)zbx_history_record_compare_asc_func);
@@ -2357,6 +2392,112 @@ static size_t	vch_item_free_cache(zbx_vc_item_t *item)
 	return freed;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: defers request of item not in cache until the end of batch        *
+ *                                                                            *
+ * Parameters: itemid     - [IN] the item id                                  *
+ *             value_type - [IN] the item value type                          *
+ *             seconds    - [IN] the time period to retrieve data for         *
+ *             count      - [IN] the number of history values to retrieve     *
+ *             ts         - [IN] the period end timestamp                     *
+ *                                                                            *
+ * Comments: Count based requests are deferred as time based requests for     *
+ *           their time limit or VC_BATCH_COUNT_PERIOD if there is no limit.  *
+ *           If it is not enough to cover the requested count, the remaining  *
+ *           values are read by the following request.                        *
+ *                                                                            *
+ ******************************************************************************/
+static void	vc_batch_defer(zbx_uint64_t itemid, unsigned char value_type, int seconds, int count,
+		const zbx_timespec_t *ts)
+{
+	zbx_vc_batch_request_t	request = {.itemid = itemid, .value_type = value_type};
+
+	if (0 != count && 0 == seconds)
+		seconds = VC_BATCH_COUNT_PERIOD;
+
+	if (0 > (request.range_start = ts->sec - seconds))
+		request.range_start = 0;
+
+	request.range_start -= request.range_start % VC_BATCH_RANGE_STEP;
+
+	zbx_vector_vc_batch_request_append_ptr(&vc_batch_requests, &request);
+}
+
+static int	vc_batch_request_compare_by_itemid(const void *d1, const void *d2)
+{
+	const zbx_vc_batch_request_t	*r1 = (const zbx_vc_batch_request_t *)d1;
+	const zbx_vc_batch_request_t	*r2 = (const zbx_vc_batch_request_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(r1->itemid, r2->itemid);
+	ZBX_RETURN_IF_NOT_EQUAL(r1->range_start, r2->range_start);
+
+	return 0;
+}
+
+static int	vc_batch_request_compare_by_range(const void *d1, const void *d2)
+{
+	const zbx_vc_batch_request_t	*r1 = (const zbx_vc_batch_request_t *)d1;
+	const zbx_vc_batch_request_t	*r2 = (const zbx_vc_batch_request_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(r1->value_type, r2->value_type);
+	ZBX_RETURN_IF_NOT_EQUAL(r1->range_start, r2->range_start);
+	ZBX_RETURN_IF_NOT_EQUAL(r1->itemid, r2->itemid);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: caches item history data read by batch request                    *
+ *                                                                            *
+ * Parameters: itemid      - [IN] the item id                                 *
+ *             value_type  - [IN] the item value type                         *
+ *             range_start - [IN] the start time of read values               *
+ *             records     - [IN] the values read from database in ascending  *
+ *                                order                                       *
+ *             now         - [IN] the current time                            *
+ *                                                                            *
+ * Comments: The item might have been cached by other process while reading   *
+ *           values, in this case only the older values are added - same as   *
+ *           when caching values of single item.                              *
+ *                                                                            *
+ ******************************************************************************/
+static void	vc_batch_cache_item(zbx_uint64_t itemid, unsigned char value_type, int range_start,
+		const zbx_vector_history_record_t *records, int now)
+{
+	zbx_vc_item_t	*item;
+
+	if (NULL == (item = (zbx_vc_item_t *)zbx_hashset_search(&vc_cache->items, &itemid)))
+	{
+		zbx_vc_item_t	new_item = {.itemid = itemid, .value_type = value_type};
+
+		if (ZBX_VC_MODE_NORMAL != vc_cache->mode)
+			return;
+
+		if (NULL == (item = (zbx_vc_item_t *)zbx_hashset_insert(&vc_cache->items, &new_item,
+				sizeof(new_item))))
+		{
+			return;
+		}
+	}
+	else if (item->value_type != value_type)
+		return;
+
+	item->status = 0;
+
+	if (0 < records->values_num && SUCCEED != vch_item_add_values_at_tail(item, records->values,
+			records->values_num))
+	{
+		/* the item will be cached again by the following request */
+		vc_remove_item(item);
+		return;
+	}
+
+	vc_item_update_db_cached_from(item, range_start);
+	vc_update_statistics(item, 0, records->values_num, now);
+}
+
 /******************************************************************************************************************
  *                                                                                                                *
  * Public API                                                                                                     *
@@ -2428,6 +2569,8 @@ int	zbx_vc_init(zbx_uint64_t value_cache_size, char **error)
 	zbx_vector_vc_itemupdate_create(&vc_itemupdates);
 	zbx_vector_vc_itemupdate_reserve(&vc_itemupdates, 256);
 
+	zbx_vector_vc_batch_request_create(&vc_batch_requests);
+
 	ret = SUCCEED;
 out:
 	zbx_vc_disable();
@@ -2449,6 +2592,7 @@ void	zbx_vc_destroy(void)
 	if (NULL != vc_cache)
 	{
 		zbx_vector_vc_itemupdate_destroy(&vc_itemupdates);
+		zbx_vector_vc_batch_request_destroy(&vc_batch_requests);
 
 		zbx_hashset_destroy(&vc_cache->items);
 		zbx_hashset_destroy(&vc_cache->strpool);
@@ -2610,7 +2754,7 @@ int	zbx_vc_get_values(zbx_uint64_t itemid, unsigned char value_type, zbx_vector_
 		int seconds, int count, const zbx_timespec_t *ts)
 {
 	zbx_vc_item_t	*item, new_item;
-	int 		ret = FAIL, cache_used = 1;
+	int 		ret = FAIL, cache_used = 1, deferred = FAIL;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() itemid:" ZBX_FS_UI64 " value_type:%d count:%d period:%d end_timestamp"
 			" '%s'", __func__, itemid, value_type, count, seconds, zbx_timespec_str(ts));
@@ -2631,6 +2775,13 @@ int	zbx_vc_get_values(zbx_uint64_t itemid, unsigned char value_type, zbx_vector_
 		if (ZBX_VC_MODE_NORMAL != vc_cache->mode)
 			goto out;
 
+		if (0 != vc_batch_started)
+		{
+			vc_batch_defer(itemid, value_type, seconds, count, ts);
+			deferred = SUCCEED;
+			goto out;
+		}
+
 		memset(&new_item, 0, sizeof(new_item));
 		new_item.itemid = itemid;
 		new_item.value_type = value_type;
@@ -2641,12 +2792,14 @@ int	zbx_vc_get_values(zbx_uint64_t itemid, unsigned char value_type, zbx_vector_
 
 	ret = vch_item_get_values(item, values, seconds, count, ts);
 out:
-	if (FAIL == ret)
+	if (FAIL == ret && SUCCEED != deferred)
 	{
 		cache_used = 0;
 
 		UNLOCK_CACHE;
+		zbx_prof_probe_start(ZBX_PROF_PROBE_VALUECACHE_MISS);
 		ret = vc_db_get_values(itemid, value_type, values, seconds, count, ts);
+		zbx_prof_probe_end(ZBX_PROF_PROBE_VALUECACHE_MISS);
 		WRLOCK_CACHE;
 
 		if (ZBX_VC_DISABLED != vc_state)
@@ -2658,8 +2811,8 @@ out:
 
 	UNLOCK_CACHE;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s count:%d cached:%d",
-			__func__, zbx_result_string(ret), values->values_num, cache_used);
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s count:%d cached:%d deferred:%d",
+			__func__, zbx_result_string(ret), values->values_num, cache_used, SUCCEED == deferred);
 
 	return ret;
 }
@@ -2926,3 +3079,734 @@ void	zbx_vc_add_new_items(const zbx_vector_uint64_pair_t *items)
 
 	UNLOCK_CACHE;
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: starts collecting requests of items not in value cache            *
+ *                                                                            *
+ * Comments: While batch is started zbx_vc_get_values() fails without reading *
+ *           database for items not in cache and remembers the request        *
+ *           instead. The caller must check zbx_vc_batch_deferred_num() to    *
+ *           find if the request was deferred and repeat it after             *
+ *           zbx_vc_batch_end() has read the deferred items.                  *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_vc_batch_begin(void)
+{
+	if (ZBX_VC_DISABLED == vc_state)
+		return;
+
+	vc_batch_started = 1;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns the number of requests deferred since batch start         *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_vc_batch_deferred_num(void)
+{
+	if (0 == vc_batch_started)
+		return 0;
+
+	return vc_batch_requests.values_num;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reads history of items deferred during batch and caches it        *
+ *                                                                            *
+ * Comments: Requests are merged per item and grouped by value type and range *
+ *           start, reading each group with one multi-item query. Values read *
+ *           from database are cached in the same way as for single item, so  *
+ *           the repeated requests are served from cache. In the case of      *
+ *           errors the items are left uncached and read by the repeated      *
+ *           requests.                                                        *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_vc_batch_end(void)
+{
+	zbx_vector_uint64_t		itemids;
+	zbx_vector_history_record_t	*records = NULL;
+	int				i, j, k, now, records_alloc = 0, queries = 0;
+
+	if (0 == vc_batch_started)
+		return;
+
+	vc_batch_started = 0;
+
+	if (0 == vc_batch_requests.values_num)
+		return;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() requests:%d", __func__, vc_batch_requests.values_num);
+
+	/* keep the longest range request of each item */
+	zbx_vector_vc_batch_request_sort(&vc_batch_requests, vc_batch_request_compare_by_itemid);
+
+	for (i = 1, j = 0; i < vc_batch_requests.values_num; i++)
+	{
+		if (vc_batch_requests.values[i].itemid != vc_batch_requests.values[j].itemid)
+			vc_batch_requests.values[++j] = vc_batch_requests.values[i];
+	}
+	vc_batch_requests.values_num = j + 1;
+
+	zbx_vector_vc_batch_request_sort(&vc_batch_requests, vc_batch_request_compare_by_range);
+
+	zbx_vector_uint64_create(&itemids);
+
+	for (i = 0; i < vc_batch_requests.values_num; i = j)
+	{
+		const zbx_vc_batch_request_t	*request = &vc_batch_requests.values[i];
+		int				range_start, ret;
+
+		zbx_vector_uint64_clear(&itemids);
+
+		for (j = i; j < vc_batch_requests.values_num &&
+				vc_batch_requests.values[j].value_type == request->value_type &&
+				vc_batch_requests.values[j].range_start == request->range_start; j++)
+		{
+			zbx_vector_uint64_append(&itemids, vc_batch_requests.values[j].itemid);
+		}
+
+		if (records_alloc < itemids.values_num)
+		{
+			records_alloc = itemids.values_num;
+			records = (zbx_vector_history_record_t *)zbx_realloc(records,
+					sizeof(zbx_vector_history_record_t) * (size_t)records_alloc);
+		}
+
+		for (k = 0; k < itemids.values_num; k++)
+			zbx_history_record_vector_create(&records[k]);
+
+		/* decrement interval start point because interval starting point is excluded by history backend */
+		if (0 != (range_start = request->range_start))
+			range_start--;
+
+		zbx_prof_probe_start(ZBX_PROF_PROBE_VALUECACHE_MISS);
+		ret = zbx_history_get_values_multi(&itemids, request->value_type, range_start, ZBX_JAN_2038,
+				records);
+		zbx_prof_probe_end(ZBX_PROF_PROBE_VALUECACHE_MISS);
+		queries++;
+
+		if (SUCCEED == ret)
+		{
+			for (k = 0; k < itemids.values_num; k++)
+			{
+				zbx_vector_history_record_sort(&records[k],
+						(zbx_compare_func_t)zbx_history_record_compare_asc_func);
+			}
+
+			now = (int)time(NULL);
+
+			WRLOCK_CACHE;
+
+			for (k = 0; k < itemids.values_num; k++)
+			{
+				vc_batch_cache_item(itemids.values[k], request->value_type, request->range_start,
+						&records[k], now);
+			}
+
+			UNLOCK_CACHE;
+		}
+
+		for (k = 0; k < itemids.values_num; k++)
+			zbx_history_record_vector_destroy(&records[k], request->value_type);
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() items:%d queries:%d", __func__, vc_batch_requests.values_num,
+			queries);
+
+	zbx_free(records);
+	zbx_vector_uint64_destroy(&itemids);
+	zbx_vector_vc_batch_request_clear(&vc_batch_requests);
+}
+
+/******************************************************************************************************************
+ *                                                                                                                *
+ * Value cache snapshot                                                                                           *
+ *                                                                                                                *
+ ******************************************************************************************************************/
+/*
+ * The snapshot is a local binary file written by the main server process on clean
+ * shutdown and loaded right after value cache initialization, before history syncers
+ * are started. It uses host byte order and has the following layout:
+ *
+ *   header: magic (8 bytes), version (uint32), byte order mark (uint32), save time (int),
+ *           server run identifier (string), number of items (int)
+ *   item:   itemid (uint64), value_type (uchar), status (uchar), range_sync_hour (uchar),
+ *           active_range, daily_range, db_cached_from (int), hits (uint64),
+ *           number of values (int), values from the oldest to the newest
+ *   value:  timestamp seconds, nanoseconds (int) followed by the value data - double,
+ *           uint64, string (uint32 length + data) or log value (timestamp, logeventid,
+ *           severity (int), source string, value string)
+ *
+ * String length VC_SNAPSHOT_NULL_STRING marks NULL log source.
+ */
+
+#define VC_SNAPSHOT_MAGIC		"ZBXVCSNP"
+#define VC_SNAPSHOT_MAGIC_LEN		8
+#define VC_SNAPSHOT_VERSION		2
+#define VC_SNAPSHOT_BOM			0x01020304
+#define VC_SNAPSHOT_NULL_STRING		0xffffffff
+
+/* stop loading snapshot when less than the specified percent of cache memory is free */
+#define VC_SNAPSHOT_FREE_RESERVE	20
+
+typedef struct
+{
+	FILE		*file;
+	const char	*path;
+	zbx_uint64_t	size;
+	zbx_uint64_t	offset;
+}
+zbx_vc_snapshot_t;
+
+static int	vc_snapshot_write(zbx_vc_snapshot_t *snapshot, const void *data, size_t size)
+{
+	if (1 != fwrite(data, size, 1, snapshot->file))
+		return FAIL;
+
+	return SUCCEED;
+}
+
+static int	vc_snapshot_write_str(zbx_vc_snapshot_t *snapshot, const char *str)
+{
+	zbx_uint32_t	len;
+
+	if (NULL == str)
+	{
+		len = VC_SNAPSHOT_NULL_STRING;
+		return vc_snapshot_write(snapshot, &len, sizeof(len));
+	}
+
+	len = (zbx_uint32_t)strlen(str);
+
+	if (SUCCEED != vc_snapshot_write(snapshot, &len, sizeof(len)))
+		return FAIL;
+
+	if (0 == len)
+		return SUCCEED;
+
+	return vc_snapshot_write(snapshot, str, len);
+}
+
+static int	vc_snapshot_read(zbx_vc_snapshot_t *snapshot, void *data, size_t size)
+{
+	if (snapshot->size - snapshot->offset < size || 1 != fread(data, size, 1, snapshot->file))
+		return FAIL;
+
+	snapshot->offset += size;
+
+	return SUCCEED;
+}
+
+static int	vc_snapshot_read_str(zbx_vc_snapshot_t *snapshot, char **str)
+{
+	zbx_uint32_t	len;
+
+	if (SUCCEED != vc_snapshot_read(snapshot, &len, sizeof(len)))
+		return FAIL;
+
+	if (VC_SNAPSHOT_NULL_STRING == len)
+	{
+		*str = NULL;
+		return SUCCEED;
+	}
+
+	if (snapshot->size - snapshot->offset < len)
+		return FAIL;
+
+	*str = (char *)zbx_malloc(NULL, (size_t)len + 1);
+
+	if (0 != len && SUCCEED != vc_snapshot_read(snapshot, *str, len))
+	{
+		zbx_free(*str);
+		return FAIL;
+	}
+
+	(*str)[len] = '\0';
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: writes item history value to snapshot                             *
+ *                                                                            *
+ ******************************************************************************/
+static int	vc_snapshot_write_value(zbx_vc_snapshot_t *snapshot, const zbx_history_record_t *record,
+		unsigned char value_type)
+{
+	if (SUCCEED != vc_snapshot_write(snapshot, &record->timestamp.sec, sizeof(record->timestamp.sec)) ||
+			SUCCEED != vc_snapshot_write(snapshot, &record->timestamp.ns, sizeof(record->timestamp.ns)))
+	{
+		return FAIL;
+	}
+
+	switch (value_type)
+	{
+		case ITEM_VALUE_TYPE_FLOAT:
+			return vc_snapshot_write(snapshot, &record->value.dbl, sizeof(record->value.dbl));
+		case ITEM_VALUE_TYPE_UINT64:
+			return vc_snapshot_write(snapshot, &record->value.ui64, sizeof(record->value.ui64));
+		case ITEM_VALUE_TYPE_STR:
+		case ITEM_VALUE_TYPE_TEXT:
+			return vc_snapshot_write_str(snapshot, record->value.str);
+		case ITEM_VALUE_TYPE_LOG:
+			if (SUCCEED != vc_snapshot_write(snapshot, &record->value.log->timestamp,
+					sizeof(record->value.log->timestamp)) ||
+					SUCCEED != vc_snapshot_write(snapshot, &record->value.log->logeventid,
+					sizeof(record->value.log->logeventid)) ||
+					SUCCEED != vc_snapshot_write(snapshot, &record->value.log->severity,
+					sizeof(record->value.log->severity)) ||
+					SUCCEED != vc_snapshot_write_str(snapshot, record->value.log->source))
+			{
+				return FAIL;
+			}
+			return vc_snapshot_write_str(snapshot, record->value.log->value);
+		default:
+			THIS_SHOULD_NEVER_HAPPEN;
+			return FAIL;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reads item history value from snapshot                            *
+ *                                                                            *
+ * Comments: Additional memory is allocated to store string, text and log     *
+ *           value contents. This memory must be freed by the caller.         *
+ *                                                                            *
+ ******************************************************************************/
+static int	vc_snapshot_read_value(zbx_vc_snapshot_t *snapshot, zbx_history_record_t *record,
+		unsigned char value_type)
+{
+	zbx_log_value_t	*log;
+
+	if (SUCCEED != vc_snapshot_read(snapshot, &record->timestamp.sec, sizeof(record->timestamp.sec)) ||
+			SUCCEED != vc_snapshot_read(snapshot, &record->timestamp.ns, sizeof(record->timestamp.ns)))
+	{
+		return FAIL;
+	}
+
+	if (0 > record->timestamp.ns || VC_MAX_NANOSECONDS < record->timestamp.ns)
+		return FAIL;
+
+	switch (value_type)
+	{
+		case ITEM_VALUE_TYPE_FLOAT:
+			return vc_snapshot_read(snapshot, &record->value.dbl, sizeof(record->value.dbl));
+		case ITEM_VALUE_TYPE_UINT64:
+			return vc_snapshot_read(snapshot, &record->value.ui64, sizeof(record->value.ui64));
+		case ITEM_VALUE_TYPE_STR:
+		case ITEM_VALUE_TYPE_TEXT:
+			if (SUCCEED != vc_snapshot_read_str(snapshot, &record->value.str))
+				return FAIL;
+
+			if (NULL == record->value.str)
+				return FAIL;
+
+			return SUCCEED;
+		case ITEM_VALUE_TYPE_LOG:
+			log = (zbx_log_value_t *)zbx_malloc(NULL, sizeof(zbx_log_value_t));
+			log->source = NULL;
+			log->value = NULL;
+			record->value.log = log;
+
+			if (SUCCEED != vc_snapshot_read(snapshot, &log->timestamp, sizeof(log->timestamp)) ||
+					SUCCEED != vc_snapshot_read(snapshot, &log->logeventid,
+							sizeof(log->logeventid)) ||
+					SUCCEED != vc_snapshot_read(snapshot, &log->severity, sizeof(log->severity)) ||
+					SUCCEED != vc_snapshot_read_str(snapshot, &log->source) ||
+					SUCCEED != vc_snapshot_read_str(snapshot, &log->value) || NULL == log->value)
+			{
+				vc_history_logfree(log);
+				return FAIL;
+			}
+
+			return SUCCEED;
+		default:
+			THIS_SHOULD_NEVER_HAPPEN;
+			return FAIL;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sorts items by number of hits in descending order                 *
+ *                                                                            *
+ ******************************************************************************/
+static int	vc_compare_items_by_hits(const void *d1, const void *d2)
+{
+	const zbx_vc_item_t	*c1 = *(const zbx_vc_item_t * const *)d1;
+	const zbx_vc_item_t	*c2 = *(const zbx_vc_item_t * const *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(c2->hits, c1->hits);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: writes cached item and its history values to snapshot             *
+ *                                                                            *
+ ******************************************************************************/
+static int	vc_snapshot_write_item(zbx_vc_snapshot_t *snapshot, const zbx_vc_item_t *item)
+{
+	const zbx_vc_chunk_t	*chunk;
+
+	if (SUCCEED != vc_snapshot_write(snapshot, &item->itemid, sizeof(item->itemid)) ||
+			SUCCEED != vc_snapshot_write(snapshot, &item->value_type, sizeof(item->value_type)) ||
+			SUCCEED != vc_snapshot_write(snapshot, &item->status, sizeof(item->status)) ||
+			SUCCEED != vc_snapshot_write(snapshot, &item->range_sync_hour, sizeof(item->range_sync_hour)) ||
+			SUCCEED != vc_snapshot_write(snapshot, &item->active_range, sizeof(item->active_range)) ||
+			SUCCEED != vc_snapshot_write(snapshot, &item->daily_range, sizeof(item->daily_range)) ||
+			SUCCEED != vc_snapshot_write(snapshot, &item->db_cached_from, sizeof(item->db_cached_from)) ||
+			SUCCEED != vc_snapshot_write(snapshot, &item->hits, sizeof(item->hits)) ||
+			SUCCEED != vc_snapshot_write(snapshot, &item->values_total, sizeof(item->values_total)))
+	{
+		return FAIL;
+	}
+
+	for (chunk = item->tail; NULL != chunk; chunk = chunk->next)
+	{
+		int	i;
+
+		for (i = chunk->first_value; i <= chunk->last_value; i++)
+		{
+			if (SUCCEED != vc_snapshot_write_value(snapshot, &chunk->slots[i], item->value_type))
+				return FAIL;
+		}
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: saves recently accessed value cache items to snapshot file        *
+ *                                                                            *
+ * Parameters: path  - [IN] the snapshot file path                            *
+ *             runid - [IN] the identifier of current server run              *
+ *             error - [OUT] the error message                                *
+ *                                                                            *
+ * Return value: SUCCEED - the snapshot was saved                             *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: The snapshot is written to temporary file which is renamed to    *
+ *           the target path afterwards, so an interrupted save never leaves  *
+ *           partial snapshot. Items are written in the order of hits, so the *
+ *           most used items are loaded first when cache is smaller at the    *
+ *           next startup.                                                    *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_vc_snapshot_save(const char *path, const char *runid, char **error)
+{
+	zbx_vc_snapshot_t		snapshot = {.path = path};
+	zbx_vector_ptr_t		items;
+	zbx_hashset_iter_t		iter;
+	zbx_vc_item_t			*item;
+	char				*path_tmp;
+	int				ret = FAIL, i, now, timestamp;
+	zbx_uint32_t			version = VC_SNAPSHOT_VERSION, bom = VC_SNAPSHOT_BOM;
+
+	if (NULL == vc_cache)
+		return SUCCEED;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() path:'%s'", __func__, path);
+
+	path_tmp = zbx_dsprintf(NULL, "%s.tmp", path);
+
+	if (NULL == (snapshot.file = fopen(path_tmp, "wb")))
+	{
+		*error = zbx_dsprintf(*error, "cannot open file \"%s\": %s", path_tmp, zbx_strerror(errno));
+		goto out;
+	}
+
+	zbx_vector_ptr_create(&items);
+
+	RDLOCK_CACHE;
+
+	now = (int)time(NULL);
+	timestamp = now - ZBX_VC_ITEM_EXPIRE_PERIOD;
+
+	zbx_hashset_iter_reset(&vc_cache->items, &iter);
+
+	while (NULL != (item = (zbx_vc_item_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (item->last_accessed >= timestamp)
+			zbx_vector_ptr_append(&items, item);
+	}
+
+	zbx_vector_ptr_sort(&items, vc_compare_items_by_hits);
+
+	if (SUCCEED == vc_snapshot_write(&snapshot, VC_SNAPSHOT_MAGIC, VC_SNAPSHOT_MAGIC_LEN) &&
+			SUCCEED == vc_snapshot_write(&snapshot, &version, sizeof(version)) &&
+			SUCCEED == vc_snapshot_write(&snapshot, &bom, sizeof(bom)) &&
+			SUCCEED == vc_snapshot_write(&snapshot, &now, sizeof(now)) &&
+			SUCCEED == vc_snapshot_write_str(&snapshot, runid) &&
+			SUCCEED == vc_snapshot_write(&snapshot, &items.values_num, sizeof(items.values_num)))
+	{
+		for (i = 0; i < items.values_num; i++)
+		{
+			if (SUCCEED != vc_snapshot_write_item(&snapshot, (const zbx_vc_item_t *)items.values[i]))
+				break;
+		}
+
+		if (i == items.values_num)
+			ret = SUCCEED;
+	}
+
+	UNLOCK_CACHE;
+
+	if (0 != fclose(snapshot.file))
+		ret = FAIL;
+
+	if (SUCCEED != ret)
+	{
+		*error = zbx_dsprintf(*error, "cannot write file \"%s\": %s", path_tmp, zbx_strerror(errno));
+		unlink(path_tmp);
+	}
+	else if (0 != rename(path_tmp, path))
+	{
+		*error = zbx_dsprintf(*error, "cannot rename file \"%s\" to \"%s\": %s", path_tmp, path,
+				zbx_strerror(errno));
+		unlink(path_tmp);
+		ret = FAIL;
+	}
+	else
+	{
+		zabbix_log(LOG_LEVEL_INFORMATION, "saved %d items to value cache snapshot \"%s\"", items.values_num,
+				path);
+	}
+
+	zbx_vector_ptr_destroy(&items);
+out:
+	zbx_free(path_tmp);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reads item with its history values from snapshot and adds it to   *
+ *          value cache                                                       *
+ *                                                                            *
+ * Parameters: snapshot - [IN] the snapshot                                   *
+ *             now      - [IN] the current time                               *
+ *             full     - [OUT] 1 if there was not enough memory to cache the *
+ *                              item, 0 otherwise                             *
+ *                                                                            *
+ * Return value: SUCCEED - the item was read successfully                     *
+ *               FAIL    - the snapshot data is invalid                       *
+ *                                                                            *
+ ******************************************************************************/
+static int	vc_snapshot_load_item(zbx_vc_snapshot_t *snapshot, int now, int *full)
+{
+	zbx_vc_item_t			item_local = {0}, *item;
+	zbx_vector_history_record_t	records;
+	int				i, values_num, ret = FAIL;
+
+	if (SUCCEED != vc_snapshot_read(snapshot, &item_local.itemid, sizeof(item_local.itemid)) ||
+			SUCCEED != vc_snapshot_read(snapshot, &item_local.value_type, sizeof(item_local.value_type)) ||
+			SUCCEED != vc_snapshot_read(snapshot, &item_local.status, sizeof(item_local.status)) ||
+			SUCCEED != vc_snapshot_read(snapshot, &item_local.range_sync_hour,
+					sizeof(item_local.range_sync_hour)) ||
+			SUCCEED != vc_snapshot_read(snapshot, &item_local.active_range,
+					sizeof(item_local.active_range)) ||
+			SUCCEED != vc_snapshot_read(snapshot, &item_local.daily_range,
+					sizeof(item_local.daily_range)) ||
+			SUCCEED != vc_snapshot_read(snapshot, &item_local.db_cached_from,
+					sizeof(item_local.db_cached_from)) ||
+			SUCCEED != vc_snapshot_read(snapshot, &item_local.hits, sizeof(item_local.hits)) ||
+			SUCCEED != vc_snapshot_read(snapshot, &values_num, sizeof(values_num)))
+	{
+		return FAIL;
+	}
+
+	switch (item_local.value_type)
+	{
+		case ITEM_VALUE_TYPE_FLOAT:
+		case ITEM_VALUE_TYPE_STR:
+		case ITEM_VALUE_TYPE_LOG:
+		case ITEM_VALUE_TYPE_UINT64:
+		case ITEM_VALUE_TYPE_TEXT:
+			break;
+		default:
+			return FAIL;
+	}
+
+	/* each value takes at least 8 bytes in snapshot */
+	if (0 > values_num || (snapshot->size - snapshot->offset) / 8 < (zbx_uint64_t)values_num)
+		return FAIL;
+
+	zbx_history_record_vector_create(&records);
+	zbx_vector_history_record_reserve(&records, (size_t)values_num);
+
+	for (i = 0; i < values_num; i++)
+	{
+		zbx_history_record_t	record;
+
+		if (SUCCEED != vc_snapshot_read_value(snapshot, &record, item_local.value_type))
+			goto out;
+
+		zbx_vector_history_record_append_ptr(&records, &record);
+
+		/* values must be in ascending order without duplicates to keep cache consistent */
+		if (0 < i && 0 <= zbx_timespec_compare(&records.values[i - 1].timestamp, &record.timestamp))
+			goto out;
+	}
+
+	ret = SUCCEED;
+
+	/* items cached during startup have precedence over snapshot data */
+	if (NULL != zbx_hashset_search(&vc_cache->items, &item_local.itemid))
+		goto out;
+
+	item_local.last_accessed = now;
+
+	if (NULL == (item = (zbx_vc_item_t *)zbx_hashset_insert(&vc_cache->items, &item_local, sizeof(item_local))))
+	{
+		*full = 1;
+		goto out;
+	}
+
+	if (0 != records.values_num && SUCCEED != vch_item_add_values_at_tail(item, records.values,
+			records.values_num))
+	{
+		vc_remove_item(item);
+		*full = 1;
+	}
+out:
+	zbx_history_record_vector_destroy(&records, item_local.value_type);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: removes value cache snapshot file                                 *
+ *                                                                            *
+ * Parameters: path - [IN] the snapshot file path                             *
+ *                                                                            *
+ * Comments: Snapshot that is not loaded must be removed, otherwise it could  *
+ *           be loaded after history was written by the runs that skipped it. *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_vc_snapshot_remove(const char *path)
+{
+	if (0 != unlink(path) && ENOENT != errno)
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot remove value cache snapshot \"%s\": %s", path,
+				zbx_strerror(errno));
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: loads value cache items from snapshot file                        *
+ *                                                                            *
+ * Parameters: path  - [IN] the snapshot file path                            *
+ *             runid - [IN] the identifier of the previous server run         *
+ *                                                                            *
+ * Comments: This function must be called after value cache initialization    *
+ *           and before history syncers are started. The cached data is valid *
+ *           only if no history was written since snapshot was saved, so the  *
+ *           snapshot is loaded only if it was saved by the previous server   *
+ *           run and the file is removed after loading to avoid reusing it    *
+ *           after crash or failover.                                         *
+ *           Loading stops when cache free memory falls below the reserve,    *
+ *           leaving space for the values received after startup.             *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_vc_snapshot_load(const char *path, const char *runid)
+{
+	zbx_vc_snapshot_t	snapshot = {.path = path};
+	zbx_stat_t		st;
+	char			magic[VC_SNAPSHOT_MAGIC_LEN], *saved_runid = NULL;
+	zbx_uint32_t		version, bom;
+	int			i, items_num, saved, now, full = 0, loaded = 0;
+
+	if (NULL == vc_cache)
+		return;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() path:'%s' runid:'%s'", __func__, path, ZBX_NULL2EMPTY_STR(runid));
+
+	if (NULL == (snapshot.file = fopen(path, "rb")))
+	{
+		if (ENOENT != errno)
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "cannot open value cache snapshot \"%s\": %s", path,
+					zbx_strerror(errno));
+		}
+
+		goto out;
+	}
+
+	if (0 != zbx_fstat(fileno(snapshot.file), &st))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot obtain value cache snapshot \"%s\" information: %s", path,
+				zbx_strerror(errno));
+		goto close;
+	}
+
+	snapshot.size = (zbx_uint64_t)st.st_size;
+
+	if (SUCCEED != vc_snapshot_read(&snapshot, magic, sizeof(magic)) ||
+			0 != memcmp(magic, VC_SNAPSHOT_MAGIC, VC_SNAPSHOT_MAGIC_LEN) ||
+			SUCCEED != vc_snapshot_read(&snapshot, &version, sizeof(version)) ||
+			VC_SNAPSHOT_VERSION != version ||
+			SUCCEED != vc_snapshot_read(&snapshot, &bom, sizeof(bom)) || VC_SNAPSHOT_BOM != bom ||
+			SUCCEED != vc_snapshot_read(&snapshot, &saved, sizeof(saved)) ||
+			SUCCEED != vc_snapshot_read_str(&snapshot, &saved_runid) ||
+			SUCCEED != vc_snapshot_read(&snapshot, &items_num, sizeof(items_num)) || 0 > items_num)
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "unsupported value cache snapshot \"%s\" format", path);
+		goto close;
+	}
+
+	if (NULL == runid || NULL == saved_runid || 0 != strcmp(runid, saved_runid))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "value cache snapshot \"%s\" was not saved by the previous server run,"
+				" discarding it", path);
+		goto close;
+	}
+
+	now = (int)time(NULL);
+
+	WRLOCK_CACHE;
+
+	for (i = 0; i < items_num && 0 == full; i++)
+	{
+		if (vc_mem->free_size < vc_mem->total_size / 100 * VC_SNAPSHOT_FREE_RESERVE)
+			break;
+
+		if (SUCCEED != vc_snapshot_load_item(&snapshot, now, &full))
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "invalid value cache snapshot \"%s\" data at offset "
+					ZBX_FS_UI64, path, snapshot.offset);
+			break;
+		}
+
+		if (0 == full)
+			loaded++;
+	}
+
+	/* the snapshot must not switch cache into low memory mode for the next day */
+	vc_cache->mode = ZBX_VC_MODE_NORMAL;
+	vc_cache->mode_time = 0;
+
+	UNLOCK_CACHE;
+
+	zabbix_log(LOG_LEVEL_INFORMATION, "loaded %d of %d items from value cache snapshot \"%s\" saved %d seconds"
+			" ago", loaded, items_num, path, now - saved);
+close:
+	fclose(snapshot.file);
+	zbx_free(saved_runid);
+
+	zbx_vc_snapshot_remove(path);
+out:
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+}
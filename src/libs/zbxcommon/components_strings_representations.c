@@ -126,6 +126,8 @@ const char	*get_process_type_string(unsigned char proc_type)
 			return "proxy group manager";
 		case ZBX_PROCESS_TYPE_BROWSERPOLLER:
 			return "browser poller";
+		case ZBX_PROCESS_TYPE_METRICS_EXPORTER:
+			return "metrics exporter";
 			break;
 	}
 
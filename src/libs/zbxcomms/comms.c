@@ -1753,6 +1753,30 @@ void	zbx_tcp_unaccept(zbx_socket_t *s)
 	s->accepted = 0;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: releases accepted connection in the current process without       *
+ *          shutting it down                                                  *
+ *                                                                            *
+ * Comments: Used after the connection has been passed to a forked child      *
+ *           process, which continues to communicate with the peer.           *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_tcp_detach(zbx_socket_t *s)
+{
+#if defined(HAVE_GNUTLS) || defined(HAVE_OPENSSL)
+	zbx_tls_ctx_free(s);
+#endif
+	if (!s->accepted) return;
+
+	zbx_socket_free(s);
+	zbx_socket_close(s->socket);
+
+	s->socket = s->socket_orig;	/* restore main socket */
+	s->socket_orig = ZBX_SOCKET_ERROR;
+	s->accepted = 0;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: finds the next line in socket data buffer                         *
@@ -1934,7 +1934,24 @@ void	zbx_tls_close(zbx_socket_t *s)
 				break;
 			}
 		}
+	}
+
+	zbx_tls_ctx_free(s);
+}
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: release TLS context without shutting down TLS connection, used    *
+ *          when the connection is taken over by another process              *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_tls_ctx_free(zbx_socket_t *s)
+{
+	if (NULL == s->tls_ctx)
+		return;
+
+	if (NULL != s->tls_ctx->ctx)
+	{
 		gnutls_credentials_clear(s->tls_ctx->ctx);
 		gnutls_deinit(s->tls_ctx->ctx);
 	}
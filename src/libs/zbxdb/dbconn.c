@@ -20,6 +20,7 @@
 #include "zbxnum.h"
 #include "zbxstr.h"
 #include "zbxtime.h"
+#include "zbxprof.h"
 
 #if defined(HAVE_POSTGRESQL)
 #	define ZBX_PG_READ_ONLY	"25006"
@@ -746,6 +747,8 @@ static int	dbconn_vexecute(zbx_dbconn_t *db, const char *fmt, va_list args)
 	if (0 != db->config->log_slow_queries)
 		sec = zbx_time();
 
+	zbx_prof_probe_start(ZBX_PROF_PROBE_DB_QUERY);
+
 	sql = zbx_dvsprintf(sql, fmt, args);
 
 	if (0 == db->txn_level)
@@ -881,6 +884,8 @@ lbl_exec:
 		zbx_mutex_unlock(*db->sqlite_access);
 #endif	/* HAVE_SQLITE3 */
 
+	zbx_prof_probe_end(ZBX_PROF_PROBE_DB_QUERY);
+
 	if (0 != db->config->log_slow_queries)
 	{
 		sec = zbx_time() - sec;
@@ -1067,6 +1072,8 @@ static zbx_db_result_t	dbconn_vselect(zbx_dbconn_t *db, const char *fmt, va_list
 	if (0 != db->config->log_slow_queries)
 		sec = zbx_time();
 
+	zbx_prof_probe_start(ZBX_PROF_PROBE_DB_QUERY);
+
 	sql = zbx_dvsprintf(sql, fmt, args);
 
 	if (ZBX_DB_OK != db->txn_error)
@@ -1169,6 +1176,8 @@ lbl_get_table:
 	if (0 == db->txn_level)
 		zbx_mutex_unlock(*db->sqlite_access);
 #endif	/* HAVE_SQLITE3 */
+	zbx_prof_probe_end(ZBX_PROF_PROBE_DB_QUERY);
+
 	if (0 != db->config->log_slow_queries)
 	{
 		sec = zbx_time() - sec;
@@ -355,15 +355,22 @@ static void	decode_and_escape_binary_value_for_sql(zbx_dbconn_t *db, char **sql_
 
 /******************************************************************************
  *                                                                            *
- * Purpose: executes the prepared database bulk insert operation              *
+ * Purpose: appends the prepared database bulk insert operation to SQL buffer *
  *                                                                            *
- * Parameters: self - [IN] the bulk insert data                               *
+ * Parameters: db_insert  - [IN] the bulk insert data                         *
+ *             sql        - [IN/OUT] the SQL buffer                           *
+ *             sql_alloc  - [IN/OUT] the SQL buffer size                      *
+ *             sql_offset - [IN/OUT] the SQL buffer offset                    *
  *                                                                            *
  * Return value: SUCCEED if the operation completed successfully or           *
  *               FAIL otherwise.                                              *
  *                                                                            *
+ * Comments: The buffer is executed when it overflows, the remaining          *
+ *           statements must be flushed by the caller. This allows to         *
+ *           combine inserts into several tables into one database request.   *
+ *                                                                            *
  ******************************************************************************/
-int	zbx_db_insert_execute(zbx_db_insert_t *db_insert)
+int	zbx_db_insert_append_sql(zbx_db_insert_t *db_insert, char **sql, size_t *sql_alloc, size_t *sql_offset)
 {
 #ifdef HAVE_MULTIROW_INSERT
 #	define ZBX_ROW_DL	","
@@ -371,11 +378,10 @@ int	zbx_db_insert_execute(zbx_db_insert_t *db_insert)
 #	define ZBX_ROW_DL	";\n"
 #endif
 
-	int			ret = FAIL, i, j;
+	int			ret = SUCCEED, i, j, started = 0;
 	const zbx_db_field_t	*field;
-	char			*sql_command, delim[2] = {',', '('}, *sql;
-	size_t			sql_command_alloc = 512, sql_command_offset = 0,
-				sql_alloc = 16 * ZBX_KIBIBYTE, sql_offset = 0;
+	char			*sql_command, delim[2] = {',', '('};
+	size_t			sql_command_alloc = 512, sql_command_offset = 0;
 #ifdef HAVE_MYSQL
 	char		*sql_values = NULL;
 	size_t		sql_values_alloc = 0, sql_values_offset = 0;
@@ -408,7 +414,6 @@ int	zbx_db_insert_execute(zbx_db_insert_t *db_insert)
 		db_insert->autoincrement = -1;
 	}
 
-	sql = (char *)zbx_malloc(NULL, sql_alloc);
 	sql_command = (char *)zbx_malloc(NULL, sql_command_alloc);
 
 	/* create sql insert statement command */
@@ -454,10 +459,13 @@ int	zbx_db_insert_execute(zbx_db_insert_t *db_insert)
 		zbx_db_value_t	*values = (zbx_db_value_t *)db_insert->rows.values[i];
 
 #ifdef HAVE_MULTIROW_INSERT
-		if (16 > sql_offset)
-			zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, sql_command);
+		if (0 == started)
+		{
+			zbx_strcpy_alloc(sql, sql_alloc, sql_offset, sql_command);
+			started = 1;
+		}
 #else
-		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, sql_command);
+		zbx_strcpy_alloc(sql, sql_alloc, sql_offset, sql_command);
 #endif
 		for (j = 0; j < db_insert->fields.values_num; j++)
 		{
@@ -465,7 +473,7 @@ int	zbx_db_insert_execute(zbx_db_insert_t *db_insert)
 
 			field = (const zbx_db_field_t *)db_insert->fields.values[j];
 
-			zbx_chrcpy_alloc(&sql, &sql_alloc, &sql_offset, delim[0 == j]);
+			zbx_chrcpy_alloc(sql, sql_alloc, sql_offset, delim[0 == j]);
 
 			switch (field->type)
 			{
@@ -475,38 +483,38 @@ int	zbx_db_insert_execute(zbx_db_insert_t *db_insert)
 				case ZBX_TYPE_CUID:
 					if (0 != (field->flags & ZBX_UPPER))
 					{
-						zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, "upper(\'");
+						zbx_strcpy_alloc(sql, sql_alloc, sql_offset, "upper(\'");
 					}
 					else
-						zbx_chrcpy_alloc(&sql, &sql_alloc, &sql_offset, '\'');
+						zbx_chrcpy_alloc(sql, sql_alloc, sql_offset, '\'');
 
-					zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, value->str);
+					zbx_strcpy_alloc(sql, sql_alloc, sql_offset, value->str);
 
 					if (0 != (field->flags & ZBX_UPPER))
 					{
-						zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, "\')");
+						zbx_strcpy_alloc(sql, sql_alloc, sql_offset, "\')");
 					}
 					else
-						zbx_chrcpy_alloc(&sql, &sql_alloc, &sql_offset, '\'');
+						zbx_chrcpy_alloc(sql, sql_alloc, sql_offset, '\'');
 					break;
 				case ZBX_TYPE_BLOB:
-					zbx_chrcpy_alloc(&sql, &sql_alloc, &sql_offset, '\'');
+					zbx_chrcpy_alloc(sql, sql_alloc, sql_offset, '\'');
 					decode_and_escape_binary_value_for_sql(db_insert->db, &(value->str));
-					zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, value->str);
-					zbx_chrcpy_alloc(&sql, &sql_alloc, &sql_offset, '\'');
+					zbx_strcpy_alloc(sql, sql_alloc, sql_offset, value->str);
+					zbx_chrcpy_alloc(sql, sql_alloc, sql_offset, '\'');
 					break;
 				case ZBX_TYPE_INT:
-					zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "%d", value->i32);
+					zbx_snprintf_alloc(sql, sql_alloc, sql_offset, "%d", value->i32);
 					break;
 				case ZBX_TYPE_FLOAT:
-					zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, ZBX_FS_DBL64_SQL, value->dbl);
+					zbx_snprintf_alloc(sql, sql_alloc, sql_offset, ZBX_FS_DBL64_SQL, value->dbl);
 					break;
 				case ZBX_TYPE_UINT:
-					zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, ZBX_FS_UI64,
+					zbx_snprintf_alloc(sql, sql_alloc, sql_offset, ZBX_FS_UI64,
 							value->ui64);
 					break;
 				case ZBX_TYPE_ID:
-					zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset,
+					zbx_strcpy_alloc(sql, sql_alloc, sql_offset,
 							zbx_db_sql_id_ins(value->ui64));
 					break;
 				default:
@@ -516,35 +524,66 @@ int	zbx_db_insert_execute(zbx_db_insert_t *db_insert)
 		}
 #ifdef HAVE_MYSQL
 		if (NULL != sql_values)
-			zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, sql_values);
+			zbx_strcpy_alloc(sql, sql_alloc, sql_offset, sql_values);
 #endif
 
-		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, ")" ZBX_ROW_DL);
+		zbx_strcpy_alloc(sql, sql_alloc, sql_offset, ")" ZBX_ROW_DL);
 
-		if (SUCCEED != (ret = zbx_dbconn_execute_overflowed_sql(db_insert->db, &sql, &sql_alloc, &sql_offset)))
+		if (SUCCEED != (ret = zbx_dbconn_execute_overflowed_sql(db_insert->db, sql, sql_alloc, sql_offset)))
 			goto out;
+
+		/* executed statement must be started anew in the emptied buffer */
+		if (0 == *sql_offset)
+			started = 0;
 	}
 
-	if (0 != sql_offset)
-	{
 #ifdef HAVE_MULTIROW_INSERT
-		if (',' == sql[sql_offset - 1])
-		{
-			sql_offset--;
-			zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, ";\n");
-		}
-#endif
-
-		if (ZBX_DB_OK > zbx_dbconn_execute(db_insert->db, "%s", sql))
-			ret = FAIL;
+	if (0 != started)
+	{
+		(*sql_offset)--;
+		zbx_strcpy_alloc(sql, sql_alloc, sql_offset, ";\n");
 	}
+#endif
 out:
 	zbx_free(sql_command);
-	zbx_free(sql);
 #ifdef HAVE_MYSQL
 	zbx_free(sql_values);
 #endif
 
+	return ret;
+
+#undef ZBX_ROW_DL
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: executes the prepared database bulk insert operation              *
+ *                                                                            *
+ * Parameters: self - [IN] the bulk insert data                               *
+ *                                                                            *
+ * Return value: SUCCEED if the operation completed successfully or           *
+ *               FAIL otherwise.                                              *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_db_insert_execute(zbx_db_insert_t *db_insert)
+{
+	int	ret;
+	char	*sql;
+	size_t	sql_alloc = 16 * ZBX_KIBIBYTE, sql_offset = 0;
+
+	if (0 == db_insert->rows.values_num)
+		return SUCCEED;
+
+	sql = (char *)zbx_malloc(NULL, sql_alloc);
+
+	if (SUCCEED == (ret = zbx_db_insert_append_sql(db_insert, &sql, &sql_alloc, &sql_offset)) &&
+			ZBX_DB_OK > zbx_dbconn_flush_overflowed_sql(db_insert->db, sql, sql_offset))
+	{
+		ret = FAIL;
+	}
+
+	zbx_free(sql);
+
 	return ret;
 }
 
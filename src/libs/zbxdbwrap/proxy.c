@@ -2109,11 +2109,13 @@ json_parse_error:
 
 	for (i = 0; i < drules.values_num; i++)
 	{
-		zbx_uint64_t	unique_dcheckid;
-		int		ret2 = SUCCEED;
+		zbx_uint64_t			unique_dcheckid;
+		int				ret2 = SUCCEED, txn_error;
+		zbx_vector_escalation_new_ptr_t	escalations;
 
 		drule = (zbx_drule_t *)drules.values[i];
 
+		zbx_vector_escalation_new_ptr_create(&escalations);
 		zbx_db_begin();
 		result = zbx_db_select(
 				"select dcheckid"
@@ -2149,12 +2151,18 @@ json_parse_error:
 		}
 
 		if (NULL != events_cbs->process_events_cb)
-			events_cbs->process_events_cb(NULL, NULL, NULL);
+			events_cbs->process_events_cb(NULL, NULL, &escalations);
+
+		txn_error = zbx_db_commit();
+
+		/* escalations reference processed events, start them before cleaning events */
+		if (NULL != events_cbs->start_escalations_cb)
+			events_cbs->start_escalations_cb(&escalations, ZBX_DB_OK == txn_error);
 
 		if (NULL != events_cbs->clean_events_cb)
 			events_cbs->clean_events_cb();
 
-		zbx_db_commit();
+		zbx_vector_escalation_new_ptr_destroy(&escalations);
 	}
 
 	for (i = 0; i < drule_errors.values_num; i++)
@@ -2324,9 +2332,23 @@ static int	process_autoregistration_contents(struct zbx_json_parse *jp_data, con
 
 	if (0 != autoreg_hosts.values_num)
 	{
+		zbx_vector_escalation_new_ptr_t	escalations;
+		int				txn_error;
+
+		zbx_vector_escalation_new_ptr_create(&escalations);
+
 		zbx_db_begin();
-		autoreg_flush_hosts_cb(&autoreg_hosts, proxy, events_cbs);
-		zbx_db_commit();
+		autoreg_flush_hosts_cb(&autoreg_hosts, proxy, events_cbs, &escalations);
+		txn_error = zbx_db_commit();
+
+		/* escalations reference processed events, start them before cleaning events */
+		if (NULL != events_cbs->start_escalations_cb)
+			events_cbs->start_escalations_cb(&escalations, ZBX_DB_OK == txn_error);
+
+		if (NULL != events_cbs->clean_events_cb)
+			events_cbs->clean_events_cb();
+
+		zbx_vector_escalation_new_ptr_destroy(&escalations);
 		zbx_autoreg_host_invalidate_cache(&autoreg_hosts);
 	}
 
@@ -21,6 +21,7 @@
 #include "zbxconnector.h"
 #include "zbxlog.h"
 #include "zbxmutexs.h"
+#include "zbxprof.h"
 #include "zbxtime.h"
 #include "zbxnum.h"
 #include "zbxstr.h"
@@ -449,6 +450,66 @@ void	zbx_diag_add_locks_info(struct zbx_json *json)
 	zbx_json_close(json);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add hot path probe latency histograms to diagnostic information   *
+ *                                                                            *
+ * Parameters: json - [IN/OUT] the json to update                             *
+ *                                                                            *
+ * Comments: Probe statistics are merged from all processes, latencies are    *
+ *           reported in nanoseconds.                                         *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_diag_add_profiler_info(struct zbx_json *json)
+{
+	zbx_prof_probe_stats_t	stats[ZBX_PROF_PROBE_COUNT];
+	int			processes_num;
+
+	zbx_json_addobject(json, ZBX_DIAG_PROFILER);
+
+	if (SUCCEED != zbx_prof_probes_get_stats(stats, &processes_num))
+	{
+		zbx_json_addint64(json, "processes", 0);
+		zbx_json_close(json);
+		return;
+	}
+
+	zbx_json_addint64(json, "processes", processes_num);
+	zbx_json_addarray(json, "probes");
+
+	for (int i = 0; i < ZBX_PROF_PROBE_COUNT; i++)
+	{
+		const zbx_prof_probe_stats_t	*ps = &stats[i];
+
+		zbx_json_addobject(json, NULL);
+		zbx_json_addstring(json, "name", ps->name, ZBX_JSON_TYPE_STRING);
+		zbx_json_adduint64(json, "count", ps->count);
+		zbx_json_adduint64(json, "avg", 0 != ps->count ? ps->total_ns / ps->count : 0);
+		zbx_json_adduint64(json, "max", ps->max_ns);
+		zbx_json_adduint64(json, "p50", ps->p50_ns);
+		zbx_json_adduint64(json, "p90", ps->p90_ns);
+		zbx_json_adduint64(json, "p99", ps->p99_ns);
+
+		zbx_json_addarray(json, "histogram");
+
+		for (int j = 0; j < ps->buckets_num; j++)
+		{
+			zbx_json_addobject(json, NULL);
+			zbx_json_adduint64(json, "le", ps->buckets[j].le);
+			zbx_json_adduint64(json, "count", ps->buckets[j].count);
+			zbx_json_close(json);
+		}
+
+		zbx_json_close(json);
+		zbx_json_close(json);
+	}
+
+	zbx_json_close(json);
+	zbx_json_close(json);
+
+	zbx_prof_probes_clear_stats(stats);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: get diagnostic information                                        *
@@ -539,7 +600,7 @@ static void	diag_prepare_default_request(struct zbx_json *j, unsigned int flags)
 		diag_add_section_request(j, ZBX_DIAG_PREPROCESSING, "peak", "sequences", NULL);
 
 	if (0 != (flags & (1 << ZBX_DIAGINFO_LLD)))
-		diag_add_section_request(j, ZBX_DIAG_LLD, "values", NULL);
+		diag_add_section_request(j, ZBX_DIAG_LLD, "values", "time", NULL);
 
 	if (0 != (flags & (1 << ZBX_DIAGINFO_ALERTING)))
 		diag_add_section_request(j, ZBX_DIAG_ALERTING, "media.alerts", "source.alerts", NULL);
@@ -553,6 +614,12 @@ static void	diag_prepare_default_request(struct zbx_json *j, unsigned int flags)
 	if (0 != (flags & (1 << ZBX_DIAGINFO_PROXYBUFFER)))
 		diag_add_section_request(j, ZBX_DIAG_PROXYBUFFER, NULL);
 
+	if (0 != (flags & (1 << ZBX_DIAGINFO_PROFILER)))
+		diag_add_section_request(j, ZBX_DIAG_PROFILER, NULL);
+
+	if (0 != (flags & (1 << ZBX_DIAGINFO_POLLER)))
+		diag_add_section_request(j, ZBX_DIAG_POLLER, NULL);
+
 }
 
 /******************************************************************************
@@ -767,6 +834,7 @@ static void	diag_log_lld(struct zbx_json_parse *jp, char **out, size_t *out_allo
 	zbx_free(msg);
 
 	diag_log_top_view(jp, "top.values", "$.top.values", out, out_alloc, out_offset);
+	diag_log_top_view(jp, "top.time", "$.top.time", out, out_alloc, out_offset);
 
 	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "==");
 }
@@ -831,6 +899,44 @@ static void	diag_log_proxybuffer(struct zbx_json_parse *jp, char **out, size_t *
 	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "==");
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: log profiler diagnostic information                               *
+ *                                                                            *
+ ******************************************************************************/
+static void	diag_log_profiler(struct zbx_json_parse *jp, char **out, size_t *out_alloc, size_t *out_offset)
+{
+	char	*msg = NULL;
+
+	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "== profiler diagnostic information ==");
+
+	diag_get_simple_values(jp, &msg);
+	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "%s", msg);
+	zbx_free(msg);
+
+	diag_log_top_view(jp, "probes (ns)", "$.probes", out, out_alloc, out_offset);
+
+	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "==");
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: log agent poller diagnostic information                           *
+ *                                                                            *
+ ******************************************************************************/
+static void	diag_log_poller(struct zbx_json_parse *jp, char **out, size_t *out_alloc, size_t *out_offset)
+{
+	char	*msg = NULL;
+
+	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "== poller diagnostic information ==");
+
+	diag_get_simple_values(jp, &msg);
+	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "%s", msg);
+	zbx_free(msg);
+
+	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "==");
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: log diagnostic information                                        *
@@ -897,6 +1003,10 @@ void	zbx_diag_log_info(unsigned int flags, char **result)
 				diag_log_connector(&jp_section, result, &result_alloc, &result_offset);
 			else if (0 == strcmp(section, ZBX_DIAG_PROXYBUFFER))
 				diag_log_proxybuffer(&jp_section, result, &result_alloc, &result_offset);
+			else if (0 == strcmp(section, ZBX_DIAG_PROFILER))
+				diag_log_profiler(&jp_section, result, &result_alloc, &result_offset);
+			else if (0 == strcmp(section, ZBX_DIAG_POLLER))
+				diag_log_poller(&jp_section, result, &result_alloc, &result_offset);
 		}
 	}
 	else
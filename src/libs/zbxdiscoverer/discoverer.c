@@ -573,8 +573,9 @@ static int	process_results(zbx_discoverer_manager_t *manager, zbx_vector_uint64_
 
 		for (int i = 0; i < results.values_num; i++)
 		{
-			zbx_db_dhost	dhost;
-			int		host_status;
+			zbx_db_dhost			dhost;
+			int				host_status, txn_error;
+			zbx_vector_escalation_new_ptr_t	escalations;
 
 			result = results.values[i];
 
@@ -588,6 +589,7 @@ static int	process_results(zbx_discoverer_manager_t *manager, zbx_vector_uint64_
 
 			memset(&dhost, 0, sizeof(zbx_db_dhost));
 
+			zbx_vector_escalation_new_ptr_create(&escalations);
 			zbx_db_begin();
 
 			host_status = process_services(handle, result->druleid, &dhost, result->ip, result->dnsname,
@@ -599,12 +601,18 @@ static int	process_results(zbx_discoverer_manager_t *manager, zbx_vector_uint64_
 					host_status, result->now, events_cbs->add_event_cb);
 
 			if (NULL != events_cbs->process_events_cb)
-				events_cbs->process_events_cb(NULL, NULL, NULL);
+				events_cbs->process_events_cb(NULL, NULL, &escalations);
+
+			txn_error = zbx_db_commit();
+
+			/* escalations reference processed events, start them before cleaning events */
+			if (NULL != events_cbs->start_escalations_cb)
+				events_cbs->start_escalations_cb(&escalations, ZBX_DB_OK == txn_error);
 
 			if (NULL != events_cbs->clean_events_cb)
 				events_cbs->clean_events_cb();
 
-			zbx_db_commit();
+			zbx_vector_escalation_new_ptr_destroy(&escalations);
 		}
 
 		discovery_close_cb(handle);
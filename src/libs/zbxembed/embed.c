@@ -288,6 +288,7 @@ int	zbx_es_check_timeout(void *udata)
 void	zbx_es_init(zbx_es_t *es)
 {
 	es->env = NULL;
+	es->connection_cache_size = 0;
 }
 
 /******************************************************************************
@@ -328,6 +329,7 @@ int	zbx_es_init_env(zbx_es_t *es, const char *config_source_ip, char **error)
 	es->env->max_total_alloc = 0;
 
 	es->env->config_source_ip = config_source_ip;
+	es->env->connection_cache_size = es->connection_cache_size;
 
 	if (0 != setjmp(es->env->loc))
 	{
@@ -463,7 +465,11 @@ int	zbx_es_destroy_env(zbx_es_t *es, char **error)
 
 	duk_destroy_heap(es->env->ctx);
 	es_objmap_destroy(&es->env->objmap);
-
+#ifdef HAVE_LIBCURL
+	/* the share can be released only after all HttpRequest handles using it are cleaned up */
+	if (NULL != es->env->http_share)
+		es_httprequest_share_free(es->env->http_share);
+#endif
 	zbx_es_debug_disable(es);
 
 	zbx_free(es->env->browser_endpoint);
@@ -478,6 +484,24 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: enables sharing of connections between HttpRequest objects        *
+ *                                                                            *
+ * Parameters: es   - [IN] the embedded scripting engine                      *
+ *             size - [IN] the maximum number of cached connections, 0 to     *
+ *                         disable sharing                                    *
+ *                                                                            *
+ * Comments: Takes effect when the scripting engine environment is            *
+ *           initialized. The connection, DNS and TLS session caches live     *
+ *           until the environment is destroyed.                              *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_es_set_connection_cache(zbx_es_t *es, int size)
+{
+	es->connection_cache_size = size;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: checks if the scripting engine environment is initialized         *
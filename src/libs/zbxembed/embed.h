@@ -52,6 +52,8 @@ struct zbx_es_env
 	jmp_buf		loc;
 
 	int		http_req_objects;
+	int		connection_cache_size;
+	void		*http_share;
 
 	int		logged_msgs;
 
@@ -85,6 +85,69 @@ static size_t	curl_header_cb(void *ptr, size_t size, size_t nmemb, void *userdat
 	return r_size;
 }
 
+#if LIBCURL_VERSION_NUM >= 0x073900
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns cURL share of connection, DNS and TLS session caches used *
+ *          by HttpRequest objects                                            *
+ *                                                                            *
+ * Parameters: env - [IN] the scripting engine environment                    *
+ *                                                                            *
+ * Return value: cURL share or NULL if sharing is disabled or the share       *
+ *               cannot be initialized                                        *
+ *                                                                            *
+ * Comments: The share is kept for environment lifetime, so connections       *
+ *           opened by one script are reused by the following scripts         *
+ *           sending requests to the same endpoints without new TCP and TLS   *
+ *           handshakes. Cookies are not shared between HttpRequest objects.  *
+ *                                                                            *
+ ******************************************************************************/
+static CURLSH	*es_httprequest_share(zbx_es_env_t *env)
+{
+	CURLSH	*share;
+
+	if (0 == env->connection_cache_size)
+		return NULL;
+
+	if (NULL != env->http_share)
+		return (CURLSH *)env->http_share;
+
+	if (NULL == (share = curl_share_init()))
+		return NULL;
+
+	if (CURLSHE_OK != curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT) ||
+			CURLSHE_OK != curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS) ||
+			CURLSHE_OK != curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION))
+	{
+		curl_share_cleanup(share);
+		return NULL;
+	}
+
+	env->http_share = share;
+
+	return share;
+}
+#endif
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: releases cURL share used by HttpRequest objects                   *
+ *                                                                            *
+ * Parameters: share - [IN] the cURL share                                    *
+ *                                                                            *
+ * Comments: All handles attached to the share must be cleaned up before.     *
+ *                                                                            *
+ ******************************************************************************/
+void	es_httprequest_share_free(void *share)
+{
+#if LIBCURL_VERSION_NUM >= 0x073900
+	if (CURLSHE_OK != curl_share_cleanup((CURLSH *)share))
+		THIS_SHOULD_NEVER_HAPPEN;
+#else
+	ZBX_UNUSED(share);
+#endif
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: return backing C structure embedded in HttpRequest object         *
@@ -162,6 +225,9 @@ static duk_ret_t	es_httprequest_ctor(duk_context *ctx)
 	zbx_es_env_t		*env;
 	int			err_index = -1;
 	void			*objptr;
+#if LIBCURL_VERSION_NUM >= 0x073900
+	CURLSH			*share;
+#endif
 
 	if (!duk_is_constructor_call(ctx))
 		return DUK_RET_TYPE_ERROR;
@@ -198,6 +264,15 @@ static duk_ret_t	es_httprequest_ctor(duk_context *ctx)
 	if (NULL != env->config_source_ip)
 		ZBX_CURL_SETOPT(ctx, request->handle, CURLOPT_INTERFACE, env->config_source_ip, err);
 
+#if LIBCURL_VERSION_NUM >= 0x073900
+	if (NULL != (share = es_httprequest_share(env)))
+	{
+		ZBX_CURL_SETOPT(ctx, request->handle, CURLOPT_SHARE, share, err);
+		/* limits the shared connection cache, the oldest idle connections are closed first */
+		ZBX_CURL_SETOPT(ctx, request->handle, CURLOPT_MAXCONNECTS, (long)env->connection_cache_size, err);
+	}
+#endif
+
 	duk_push_c_function(ctx, es_httprequest_dtor, 1);
 	duk_set_finalizer(ctx, -2);
 out:
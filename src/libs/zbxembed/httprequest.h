@@ -19,5 +19,6 @@
 
 int	zbx_es_init_httprequest(zbx_es_t *es, char **error);
 void	es_httprequest_free(void *data);
+void	es_httprequest_share_free(void *share);
 
 #endif
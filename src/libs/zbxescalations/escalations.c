@@ -19,6 +19,10 @@
 #include "zbxipcservice.h"
 #include "zbx_rtc_constants.h"
 #include "zbxserialize.h"
+#include "zbxrtc.h"
+
+/* timeout of temporary RTC connection used by processes without permanent one */
+#define ZBX_ESCALATIONS_RTC_TIMEOUT	10
 
 static int				escalators_number;
 static zbx_rtc_notify_generic_cb_t	rtc_notify_generic_cb;
@@ -29,9 +33,40 @@ void	zbx_init_escalations(int escalators_num, zbx_rtc_notify_generic_cb_t rtc_no
 	rtc_notify_generic_cb = rtc_notify_cb;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: notifies escalators about new escalations                         *
+ *                                                                            *
+ * Parameters: rtc         - [IN] RTC socket, NULL to open temporary one      *
+ *             escalations - [IN] escalations created by committed transaction*
+ *                                                                            *
+ * Comments: Must be called after the escalations are committed and before    *
+ *           the events they reference are cleaned. Escalations that could    *
+ *           not be notified are picked up by escalator database rescan.      *
+ *                                                                            *
+ ******************************************************************************/
 void	zbx_start_escalations(zbx_ipc_async_socket_t *rtc, zbx_vector_escalation_new_ptr_t *escalations)
 {
 	zbx_vector_uint64_t	*escalator_escalationids;
+	zbx_ipc_async_socket_t	rtc_local;
+	char			*error = NULL;
+
+	if (0 == escalations->values_num || 0 == escalators_number)
+		return;
+
+	if (NULL == rtc)
+	{
+		if (FAIL == zbx_ipc_async_socket_open(&rtc_local, ZBX_IPC_SERVICE_RTC, ZBX_ESCALATIONS_RTC_TIMEOUT,
+				&error))
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "cannot connect to RTC service to notify escalators: %s",
+					error);
+			zbx_free(error);
+			return;
+		}
+
+		rtc = &rtc_local;
+	}
 
 	escalator_escalationids = (zbx_vector_uint64_t *)zbx_malloc(NULL, (size_t)escalators_number *
 			sizeof(zbx_vector_uint64_t));
@@ -42,15 +77,24 @@ void	zbx_start_escalations(zbx_ipc_async_socket_t *rtc, zbx_vector_escalation_ne
 	for (int i = 0; i < escalations->values_num; i++)
 	{
 		zbx_escalation_new_t	*escalation = escalations->values[i];
+		zbx_uint64_t		distribution_id;
 
-		if (EVENT_OBJECT_TRIGGER == escalation->event->object)
+		/* must match the escalation distribution between escalators in escalator process */
+		switch (escalation->event->object)
 		{
-			int	escalator_process_num;
-
-			escalator_process_num = (int)(escalation->event->objectid % (uint64_t)escalators_number + 1);
-			zbx_vector_uint64_append(&escalator_escalationids[escalator_process_num - 1],
-					escalation->escalationid);
+			case EVENT_OBJECT_TRIGGER:
+			case EVENT_OBJECT_ITEM:
+			case EVENT_OBJECT_LLDRULE:
+				distribution_id = escalation->event->objectid;
+				break;
+			case EVENT_OBJECT_SERVICE:
+				continue;
+			default:
+				distribution_id = escalation->escalationid;
 		}
+
+		zbx_vector_uint64_append(&escalator_escalationids[distribution_id % (zbx_uint64_t)escalators_number],
+				escalation->escalationid);
 	}
 
 	for (int i = 0; i < escalators_number; i++)
@@ -76,6 +120,14 @@ void	zbx_start_escalations(zbx_ipc_async_socket_t *rtc, zbx_vector_escalation_ne
 		zbx_vector_uint64_destroy(&escalator_escalationids[i]);
 
 	zbx_free(escalator_escalationids);
+
+	if (&rtc_local == rtc)
+	{
+		if (FAIL == zbx_ipc_async_socket_flush(rtc, ZBX_ESCALATIONS_RTC_TIMEOUT))
+			zabbix_log(LOG_LEVEL_WARNING, "cannot send escalator notifications to RTC service");
+
+		zbx_ipc_async_socket_close(rtc);
+	}
 }
 
 void	zbx_escalation_new_ptr_free(zbx_escalation_new_t *escalation)
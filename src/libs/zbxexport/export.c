@@ -22,6 +22,9 @@
 #define ZBX_OPTION_EXPTYPE_HISTORY	"history"
 #define ZBX_OPTION_EXPTYPE_TRENDS	"trends"
 
+#define ZBX_EXPORT_BUFFER_SIZE		(256 * ZBX_KIBIBYTE)
+#define ZBX_EXPORT_CHECK_PERIOD		1
+
 static zbx_get_export_file_f	get_history_file;
 static zbx_get_export_file_f	get_trends_file;
 static zbx_get_export_file_f	get_problems_file;
@@ -199,17 +202,72 @@ void	zbx_deinit_library_export(void)
 
 static int	open_export_file(zbx_export_file_t *file, char **error)
 {
+	zbx_stat_t	st;
+
 	if (NULL == (file->file = fopen(file->name, "a")))
 	{
 		*error = zbx_dsprintf(*error, "cannot open export file '%s': %s", file->name, zbx_strerror(errno));
 		return FAIL;
 	}
 
+	if (0 != zbx_fstat(fileno(file->file), &st))
+	{
+		*error = zbx_dsprintf(*error, "cannot get export file '%s' information: %s", file->name,
+				zbx_strerror(errno));
+		zbx_fclose(file->file);
+		return FAIL;
+	}
+
+	/* records are written with a single fwrite() call, so with a larger buffer */
+	/* they are passed to the file system in large chunks when flushing        */
+	setvbuf(file->file, NULL, _IOFBF, ZBX_EXPORT_BUFFER_SIZE);
+
+	file->size = (zbx_uint64_t)st.st_size;
+	file->dev = (zbx_uint64_t)st.st_dev;
+	file->ino = (zbx_uint64_t)st.st_ino;
+	file->lastcheck = time(NULL);
+
 	zabbix_log(LOG_LEVEL_DEBUG, "successfully created export file '%s'", file->name);
 
 	return SUCCEED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if opened export file was removed or renamed and must be   *
+ *          reopened                                                          *
+ *                                                                            *
+ * Parameters: file - [IN/OUT] export file                                    *
+ *                                                                            *
+ * Comments: The check is done at most once per ZBX_EXPORT_CHECK_PERIOD       *
+ *           instead of every write.                                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	export_check_file(zbx_export_file_t *file)
+{
+	zbx_stat_t	st;
+	time_t		now;
+
+	if (NULL == file->file || ZBX_EXPORT_CHECK_PERIOD > (now = time(NULL)) - file->lastcheck)
+		return;
+
+	file->lastcheck = now;
+
+	if (0 == zbx_stat(file->name, &st) && file->dev == (zbx_uint64_t)st.st_dev &&
+			file->ino == (zbx_uint64_t)st.st_ino)
+	{
+		return;
+	}
+
+	if (0 != fclose(file->file))
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "cannot close export file '%s': %s", file->name,
+				zbx_strerror(errno));
+	}
+
+	file->file = NULL;
+}
+
 static zbx_export_file_t	*export_init(const char *process_type, const char *process_name, int process_num)
 {
 	char			*export_dir, *error = NULL;
@@ -285,7 +343,6 @@ static void	export_write(const char *buf, size_t count, zbx_export_file_t *file)
 	static time_t	last_log_time = 0;
 	time_t		now;
 	char		*error_msg = NULL;
-	long		file_offset;
 
 	if (NULL == config_export)
 	{
@@ -293,14 +350,7 @@ static void	export_write(const char *buf, size_t count, zbx_export_file_t *file)
 		exit(EXIT_FAILURE);
 	}
 
-	if (0 == file->missing && 0 != access(file->name, F_OK))
-	{
-		if (NULL != file->file && 0 != fclose(file->file))
-			zabbix_log(LOG_LEVEL_DEBUG, "cannot close export file '%s': %s",file->name,
-					zbx_strerror(errno));
-
-		file->file = NULL;
-	}
+	export_check_file(file);
 
 	if (NULL == file->file && FAIL == open_export_file(file, &error_msg))
 	{
@@ -314,14 +364,7 @@ static void	export_write(const char *buf, size_t count, zbx_export_file_t *file)
 		zabbix_log(LOG_LEVEL_ERR, "regained access to export file '%s'", file->name);
 	}
 
-	if (-1 == (file_offset = ftell(file->file)))
-	{
-		error_msg = zbx_dsprintf(error_msg, "cannot get current position in export file '%s': %s",
-				file->name, zbx_strerror(errno));
-		goto error;
-	}
-
-	if (config_export->file_size <= count + (size_t)file_offset + 1)
+	if (config_export->file_size <= count + file->size + 1)
 	{
 		char	filename_old[MAX_STRING_LEN];
 
@@ -362,6 +405,8 @@ static void	export_write(const char *buf, size_t count, zbx_export_file_t *file)
 		goto error;
 	}
 
+	file->size += count + 1;
+
 	return;
 error:
 	if (NULL != file->file && 0 != fclose(file->file))
@@ -194,6 +194,49 @@ int	zbx_history_get_values(zbx_uint64_t itemid, int value_type, int start, int c
 	return ret;
 }
 
+/************************************************************************************
+ *                                                                                  *
+ * Purpose: gets history data of multiple items from history storage                *
+ *                                                                                  *
+ * Parameters:  itemids    - [IN] the sorted item identifiers                       *
+ *              value_type - [IN] the items value type                              *
+ *              start      - [IN] the period start timestamp                        *
+ *              end        - [IN] the period end timestamp                          *
+ *              values     - [OUT] the item history data values, the array of       *
+ *                                 itemids->values_num vectors matching itemids     *
+ *                                                                                  *
+ * Return value: SUCCEED - the history data were read successfully                  *
+ *               FAIL - otherwise                                                   *
+ *                                                                                  *
+ * Comments: This function reads all values from ]<start>,<end>] interval. The      *
+ *           history storages not supporting multi-item reads are queried for each  *
+ *           item separately.                                                       *
+ *                                                                                  *
+ ************************************************************************************/
+int	zbx_history_get_values_multi(const zbx_vector_uint64_t *itemids, int value_type, int start, int end,
+		zbx_vector_history_record_t *values)
+{
+	int			ret = SUCCEED;
+	zbx_history_iface_t	*writer = &history_ifaces[value_type];
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() itemids:%d value_type:%d start:%d end:%d", __func__,
+			itemids->values_num, value_type, start, end);
+
+	if (NULL != writer->get_values_multi)
+	{
+		ret = writer->get_values_multi(writer, itemids, start, end, values);
+	}
+	else
+	{
+		for (int i = 0; i < itemids->values_num && SUCCEED == ret; i++)
+			ret = writer->get_values(writer, itemids->values[i], start, 0, end, &values[i]);
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
+
+	return ret;
+}
+
 /************************************************************************************
  *                                                                                  *
  * Purpose: checks if the value type requires trends data calculations              *
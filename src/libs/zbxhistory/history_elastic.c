@@ -29,12 +29,21 @@
 #include "zbxvariant.h"
 #include "zbxcurl.h"
 #include "zbxcacheconfig.h"
+#include "zbxcompress.h"
 
 #define		ZBX_HISTORY_STORAGE_DOWN	10000 /* Timeout in milliseconds */
 
 #define		ZBX_IDX_JSON_ALLOCATE		256
 #define		ZBX_JSON_ALLOCATE		2048
 
+/* bulk requests smaller than this are sent uncompressed */
+#define		ZBX_ELASTIC_COMPRESS_MIN	1024
+
+/* number of items queried with a single multi search request */
+#define		ZBX_ELASTIC_MSEARCH_BATCH	100
+/* maximum number of hits returned per item by multi search, must not exceed index.max_result_window */
+#define		ZBX_ELASTIC_MSEARCH_SIZE	10000
+
 const char	*value_type_str[] = {"dbl", "str", "log", "uint", "text"};
 
 static zbx_uint32_t	ZBX_ELASTIC_SVERSION = ZBX_DBVERSION_UNDEFINED;
@@ -45,15 +54,22 @@ typedef struct
 	char	*post_url;
 	char	*buf;
 	CURL	*handle;
+	char	*bulk_buf;	/* bulk request body, must be kept until the request is completed */
+	size_t	bulk_size;
+	CURL	*bulk_handle;
 }
 zbx_elastic_data_t;
 
 typedef struct
 {
 	unsigned char		initialized;
+	unsigned char		posted;		/* the batch was posted and its responses are not yet received */
 	zbx_vector_ptr_t	ifaces;
 
+	/* the multi handle is kept between batches to reuse connections to elasticsearch */
 	CURLM			*handle;
+	struct curl_slist	*headers;
+	struct curl_slist	*headers_deflate;
 }
 zbx_elastic_writer_t;
 
@@ -251,6 +267,27 @@ static void	elastic_close(zbx_history_iface_t *hist)
 	}
 }
 
+/************************************************************************************
+ *                                                                                  *
+ * Purpose: releases bulk request resources of history storage interface            *
+ *                                                                                  *
+ * Parameters:  hist - [IN] the history storage interface                           *
+ *                                                                                  *
+ ************************************************************************************/
+static void	elastic_bulk_close(zbx_history_iface_t *hist)
+{
+	zbx_elastic_data_t	*data = hist->data.elastic_data;
+
+	zbx_free(data->bulk_buf);
+
+	if (NULL != data->bulk_handle)
+	{
+		curl_multi_remove_handle(writer.handle, data->bulk_handle);
+		curl_easy_cleanup(data->bulk_handle);
+		data->bulk_handle = NULL;
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: check an error from Elastic json response                         *
@@ -337,10 +374,17 @@ static void	elastic_writer_init(void)
 
 	zbx_vector_ptr_create(&writer.ifaces);
 
-	if (NULL == (writer.handle = curl_multi_init()))
+	if (NULL == writer.handle)
 	{
-		zbx_error("Cannot initialize cURL multi session");
-		exit(EXIT_FAILURE);
+		if (NULL == (writer.handle = curl_multi_init()))
+		{
+			zbx_error("Cannot initialize cURL multi session");
+			exit(EXIT_FAILURE);
+		}
+
+		writer.headers = curl_slist_append(NULL, "Content-Type: application/x-ndjson");
+		writer.headers_deflate = curl_slist_append(NULL, "Content-Type: application/x-ndjson");
+		writer.headers_deflate = curl_slist_append(writer.headers_deflate, "Content-Encoding: deflate");
 	}
 
 	writer.initialized = 1;
@@ -357,126 +401,60 @@ static void	elastic_writer_release(void)
 	int	i;
 
 	for (i = 0; i < writer.ifaces.values_num; i++)
-		elastic_close((zbx_history_iface_t *)writer.ifaces.values[i]);
-
-	curl_multi_cleanup(writer.handle);
-	writer.handle = NULL;
+		elastic_bulk_close((zbx_history_iface_t *)writer.ifaces.values[i]);
 
 	zbx_vector_ptr_destroy(&writer.ifaces);
 
 	writer.initialized = 0;
+	writer.posted = 0;
 }
 
 /************************************************************************************
  *                                                                                  *
- * Purpose: adds history storage interface to be flushed later                      *
- *                                                                                  *
- * Parameters: db_insert - [IN] bulk insert data                                    *
+ * Purpose: closes connections to elastic storage kept by the writer                *
  *                                                                                  *
  ************************************************************************************/
-static void	elastic_writer_add_iface(zbx_history_iface_t *hist)
+static void	elastic_writer_destroy(void)
 {
-	zbx_elastic_data_t	*data = hist->data.elastic_data;
-	CURLoption		opt;
-	CURLcode		err;
-	char			*error = NULL;
-
-	elastic_writer_init();
-
-	if (NULL == (data->handle = curl_easy_init()))
-	{
-		zabbix_log(LOG_LEVEL_ERR, "cannot initialize cURL session");
+	if (NULL == writer.handle)
 		return;
-	}
 
-	if (CURLE_OK != (err = curl_easy_setopt(data->handle, opt = CURLOPT_URL, data->post_url)) ||
-			CURLE_OK != (err = curl_easy_setopt(data->handle, opt = CURLOPT_POST, 1L)) ||
-			CURLE_OK != (err = curl_easy_setopt(data->handle, opt = CURLOPT_POSTFIELDS, data->buf)) ||
-			CURLE_OK != (err = curl_easy_setopt(data->handle, opt = CURLOPT_WRITEFUNCTION,
-					curl_write_cb)) ||
-			CURLE_OK != (err = curl_easy_setopt(data->handle, opt = CURLOPT_WRITEDATA,
-					&page_w[hist->value_type].page)) ||
-			CURLE_OK != (err = curl_easy_setopt(data->handle, opt = CURLOPT_FAILONERROR, 1L)) ||
-			CURLE_OK != (err = curl_easy_setopt(data->handle, opt = CURLOPT_ERRORBUFFER,
-					page_w[hist->value_type].errbuf)) ||
-			CURLE_OK != (err = curl_easy_setopt(data->handle, opt = CURLOPT_ACCEPT_ENCODING, "")))
-	{
-		zabbix_log(LOG_LEVEL_ERR, "cannot set cURL option %d: [%s]", (int)opt, curl_easy_strerror(err));
-		goto out;
-	}
-
-	if (SUCCEED != zbx_curl_setopt_https(data->handle, &error))
-	{
-		zabbix_log(LOG_LEVEL_ERR, error);
-		goto out;
-	}
-
-	*page_w[hist->value_type].errbuf = '\0';
-
-	if (CURLE_OK != (err = curl_easy_setopt(data->handle, opt = CURLOPT_PRIVATE, &page_w[hist->value_type])))
-	{
-		zabbix_log(LOG_LEVEL_ERR, "cannot set cURL option %d: [%s]", (int)opt, curl_easy_strerror(err));
-		goto out;
-	}
-
-	page_w[hist->value_type].page.offset = 0;
-
-	if (0 < page_w[hist->value_type].page.alloc)
-		*page_w[hist->value_type].page.data = '\0';
-
-	curl_multi_add_handle(writer.handle, data->handle);
-
-	zbx_vector_ptr_append(&writer.ifaces, hist);
+	curl_multi_cleanup(writer.handle);
+	writer.handle = NULL;
 
-	return;
-out:
-	zbx_free(error);
-	elastic_close(hist);
+	curl_slist_free_all(writer.headers);
+	writer.headers = NULL;
+	curl_slist_free_all(writer.headers_deflate);
+	writer.headers_deflate = NULL;
 }
 
 /************************************************************************************
  *                                                                                  *
- * Purpose: posts historical data to elastic storage                                *
+ * Purpose: waits until historical data posted to elastic storage are received      *
+ *                                                                                  *
+ * Comments: This function will try to send the data until it succeeds or           *
+ *           unrecoverable error occurs                                             *
  *                                                                                  *
  ************************************************************************************/
-static int	elastic_writer_flush(void)
+static void	elastic_writer_wait(void)
 {
-	struct curl_slist	*curl_headers = NULL;
 	int			i, running, previous, msgnum;
 	CURLMsg			*msg;
 	zbx_vector_ptr_t	retries;
-	CURLcode		err;
-	int			ret = SUCCEED;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
 	/* The writer might be uninitialized only if the history */
-	/* was already flushed. In that case, return SUCCEED */
+	/* was already flushed. In that case, there is nothing to wait for */
 	if (0 == writer.initialized)
 		goto end;
 
 	zbx_vector_ptr_create(&retries);
 
-	curl_headers = curl_slist_append(curl_headers, "Content-Type: application/x-ndjson");
-
-	for (i = 0; i < writer.ifaces.values_num; i++)
-	{
-		zbx_history_iface_t	*hist = (zbx_history_iface_t *)writer.ifaces.values[i];
-		zbx_elastic_data_t	*data = hist->data.elastic_data;
-
-		if (CURLE_OK != (err = curl_easy_setopt(data->handle, CURLOPT_HTTPHEADER, curl_headers)))
-		{
-			zabbix_log(LOG_LEVEL_ERR, "cannot set cURL option %d: [%s]", (int)CURLOPT_HTTPHEADER,
-					curl_easy_strerror(err));
-			ret = FAIL;
-			goto clean;
-		}
-
-		zabbix_log(LOG_LEVEL_DEBUG, "sending %s", data->buf);
-	}
-
 try_again:
-	previous = 0;
+	/* responses might have been already received while the data was being sent, */
+	/* so the messages must be checked at least once */
+	previous = -1;
 
 	do
 	{
@@ -584,17 +562,241 @@ try_again:
 		sleep(ZBX_HISTORY_STORAGE_DOWN / 1000);
 		goto try_again;
 	}
-clean:
-	curl_slist_free_all(curl_headers);
 
 	zbx_vector_ptr_destroy(&retries);
 
 	elastic_writer_release();
+end:
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+}
+
+/************************************************************************************
+ *                                                                                  *
+ * Purpose: prepares bulk request body for sending                                  *
+ *                                                                                  *
+ * Parameters: buf       - [IN/OUT] the bulk request data, freed or moved to        *
+ *                                  bulk_buf                                        *
+ *             bulk_buf  - [OUT] the request body to send                           *
+ *             bulk_size - [OUT] the request body size                              *
+ *                                                                                  *
+ * Return value: SUCCEED - the request body is compressed                           *
+ *               FAIL    - the request body is not compressed                       *
+ *                                                                                  *
+ * Comments: Bulk requests smaller than ZBX_ELASTIC_COMPRESS_MIN bytes are sent     *
+ *           uncompressed, also when compression fails.                             *
+ *                                                                                  *
+ ************************************************************************************/
+static int	elastic_bulk_compress(char **buf, char **bulk_buf, size_t *bulk_size)
+{
+	size_t	buf_size;
+
+	buf_size = strlen(*buf);
+
+	if (ZBX_ELASTIC_COMPRESS_MIN <= buf_size && SUCCEED == zbx_compress(*buf, buf_size, bulk_buf, bulk_size))
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "compressed bulk request from " ZBX_FS_SIZE_T " to " ZBX_FS_SIZE_T
+				" bytes", (zbx_fs_size_t)buf_size, (zbx_fs_size_t)*bulk_size);
+		zbx_free(*buf);
+
+		return SUCCEED;
+	}
+
+	*bulk_buf = *buf;
+	*buf = NULL;
+	*bulk_size = buf_size;
+
+	return FAIL;
+}
+
+/************************************************************************************
+ *                                                                                  *
+ * Purpose: adds history storage interface to be flushed later                      *
+ *                                                                                  *
+ * Parameters: hist - [IN] the history storage interface with prepared bulk data    *
+ *                                                                                  *
+ * Comments: The previously posted batch is completed first, so at most one batch   *
+ *           per process is being sent at any time. Larger bulk requests are        *
+ *           compressed.                                                            *
+ *                                                                                  *
+ ************************************************************************************/
+static void	elastic_writer_add_iface(zbx_history_iface_t *hist)
+{
+	zbx_elastic_data_t	*data = hist->data.elastic_data;
+	CURLoption		opt;
+	CURLcode		err;
+	char			*error = NULL;
+	size_t			bulk_size;
+	struct curl_slist	*headers;
+
+	if (0 != writer.posted)
+		elastic_writer_wait();
+
+	elastic_writer_init();
+
+	zabbix_log(LOG_LEVEL_DEBUG, "sending %s", data->buf);
+
+	if (SUCCEED == elastic_bulk_compress(&data->buf, &data->bulk_buf, &bulk_size))
+		headers = writer.headers_deflate;
+	else
+		headers = writer.headers;
+
+	data->bulk_size = bulk_size;
+
+	if (NULL == (data->bulk_handle = curl_easy_init()))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot initialize cURL session");
+		goto out;
+	}
+
+	if (CURLE_OK != (err = curl_easy_setopt(data->bulk_handle, opt = CURLOPT_URL, data->post_url)) ||
+			CURLE_OK != (err = curl_easy_setopt(data->bulk_handle, opt = CURLOPT_POST, 1L)) ||
+			CURLE_OK != (err = curl_easy_setopt(data->bulk_handle, opt = CURLOPT_POSTFIELDS,
+					data->bulk_buf)) ||
+			CURLE_OK != (err = curl_easy_setopt(data->bulk_handle, opt = CURLOPT_POSTFIELDSIZE,
+					(long)bulk_size)) ||
+			CURLE_OK != (err = curl_easy_setopt(data->bulk_handle, opt = CURLOPT_HTTPHEADER, headers)) ||
+			CURLE_OK != (err = curl_easy_setopt(data->bulk_handle, opt = CURLOPT_WRITEFUNCTION,
+					curl_write_cb)) ||
+			CURLE_OK != (err = curl_easy_setopt(data->bulk_handle, opt = CURLOPT_WRITEDATA,
+					&page_w[hist->value_type].page)) ||
+			CURLE_OK != (err = curl_easy_setopt(data->bulk_handle, opt = CURLOPT_FAILONERROR, 1L)) ||
+			CURLE_OK != (err = curl_easy_setopt(data->bulk_handle, opt = CURLOPT_ERRORBUFFER,
+					page_w[hist->value_type].errbuf)) ||
+			CURLE_OK != (err = curl_easy_setopt(data->bulk_handle, opt = CURLOPT_ACCEPT_ENCODING, "")))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot set cURL option %d: [%s]", (int)opt, curl_easy_strerror(err));
+		goto out;
+	}
+
+	if (SUCCEED != zbx_curl_setopt_https(data->bulk_handle, &error))
+	{
+		zabbix_log(LOG_LEVEL_ERR, error);
+		goto out;
+	}
+
+	*page_w[hist->value_type].errbuf = '\0';
+
+	if (CURLE_OK != (err = curl_easy_setopt(data->bulk_handle, opt = CURLOPT_PRIVATE,
+			&page_w[hist->value_type])))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot set cURL option %d: [%s]", (int)opt, curl_easy_strerror(err));
+		goto out;
+	}
+
+	page_w[hist->value_type].page.offset = 0;
+
+	if (0 < page_w[hist->value_type].page.alloc)
+		*page_w[hist->value_type].page.data = '\0';
+
+	curl_multi_add_handle(writer.handle, data->bulk_handle);
+
+	zbx_vector_ptr_append(&writer.ifaces, hist);
+
+	zbx_free(data->post_url);
+
+	return;
+out:
+	zbx_free(error);
+	elastic_bulk_close(hist);
+	elastic_close(hist);
+}
+
+/************************************************************************************
+ *                                                                                  *
+ * Purpose: checks if bodies of all posted bulk requests were sent                  *
+ *                                                                                  *
+ * Return value: SUCCEED - the request bodies were sent                             *
+ *               FAIL    - otherwise                                                *
+ *                                                                                  *
+ ************************************************************************************/
+static int	elastic_writer_sent(void)
+{
+	int	i;
+
+	for (i = 0; i < writer.ifaces.values_num; i++)
+	{
+		zbx_elastic_data_t	*data = ((zbx_history_iface_t *)writer.ifaces.values[i])->data.elastic_data;
+		curl_off_t		size;
+
+		if (CURLE_OK != curl_easy_getinfo(data->bulk_handle, CURLINFO_SIZE_UPLOAD_T, &size) ||
+				(curl_off_t)data->bulk_size > size)
+		{
+			return FAIL;
+		}
+	}
+
+	return SUCCEED;
+}
+
+/************************************************************************************
+ *                                                                                  *
+ * Purpose: posts historical data to elastic storage                                *
+ *                                                                                  *
+ * Comments: The request bodies are sent before returning, while the responses      *
+ *           are received in background when the caller continues with the next     *
+ *           batch. The responses are checked when the next batch is added or the   *
+ *           history storage is destroyed.                                          *
+ *           Sending is limited by ZBX_HISTORY_STORAGE_DOWN timeout, the remaining  *
+ *           data is sent when the responses are checked.                           *
+ *                                                                                  *
+ ************************************************************************************/
+static int	elastic_writer_flush(void)
+{
+	int		running, fds, timeout;
+	CURLMcode	code;
+	double		deadline;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	/* The writer might be uninitialized or posted only if the history */
+	/* was already flushed. In that case, return SUCCEED */
+	if (0 == writer.initialized || 0 != writer.posted)
+		goto end;
 
+	writer.posted = 1;
+	deadline = zbx_time() + ZBX_HISTORY_STORAGE_DOWN / 1000.0;
+
+	while (1)
+	{
+		if (CURLM_OK != (code = curl_multi_perform(writer.handle, &running)))
+		{
+			zabbix_log(LOG_LEVEL_ERR, "cannot perform on curl multi handle: %s", curl_multi_strerror(code));
+			break;
+		}
+
+		if (0 == running || SUCCEED == elastic_writer_sent())
+			break;
+
+		if (0 >= (timeout = (int)((deadline - zbx_time()) * 1000)))
+		{
+			zabbix_log(LOG_LEVEL_DEBUG, "%s() bulk requests were not sent in %d ms", __func__,
+					ZBX_HISTORY_STORAGE_DOWN);
+			break;
+		}
+
+		if (CURLM_OK != (code = zbx_curl_multi_wait(writer.handle, timeout, &fds)))
+		{
+			zabbix_log(LOG_LEVEL_ERR, "cannot wait on curl multi handle: %s", curl_multi_strerror(code));
+			break;
+		}
+	}
 end:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 
-	return ret;
+	return SUCCEED;
+}
+
+/************************************************************************************
+ *                                                                                  *
+ * Purpose: continues sending of the posted historical data without blocking        *
+ *                                                                                  *
+ ************************************************************************************/
+static void	elastic_writer_progress(void)
+{
+	int	running;
+
+	if (0 != writer.posted)
+		curl_multi_perform(writer.handle, &running);
 }
 
 /******************************************************************************************************************
@@ -614,12 +816,58 @@ static void	elastic_destroy(zbx_history_iface_t *hist)
 {
 	zbx_elastic_data_t	*data = hist->data.elastic_data;
 
+	elastic_writer_flush();
+	elastic_writer_wait();
+	elastic_writer_destroy();
+
 	elastic_close(hist);
 
 	zbx_free(data->base_url);
 	zbx_free(data);
 }
 
+/************************************************************************************
+ *                                                                                  *
+ * Purpose: adds item values search query to json                                   *
+ *                                                                                  *
+ * Parameters:  json    - [IN/OUT] the json search request                          *
+ *              itemid  - [IN] the itemid                                           *
+ *              start   - [IN] the period start timestamp (0 - not limited)         *
+ *              end     - [IN] the period end timestamp (0 - not limited)           *
+ *                                                                                  *
+ ************************************************************************************/
+static void	elastic_json_add_query(struct zbx_json *json, zbx_uint64_t itemid, time_t start, time_t end)
+{
+	zbx_json_addobject(json, "query");
+	zbx_json_addobject(json, "bool");
+	zbx_json_addarray(json, "must");
+	zbx_json_addobject(json, NULL);
+	zbx_json_addobject(json, "match");
+	zbx_json_adduint64(json, "itemid", itemid);
+	zbx_json_close(json);
+	zbx_json_close(json);
+	zbx_json_close(json);
+	zbx_json_addarray(json, "filter");
+	zbx_json_addobject(json, NULL);
+	zbx_json_addobject(json, "range");
+	zbx_json_addobject(json, "clock");
+
+	zbx_json_addstring(json, "format", "epoch_second", ZBX_JSON_TYPE_STRING);
+	if (0 < start)
+		zbx_json_adduint64(json, "gt", start);
+
+	if (0 < end)
+		zbx_json_adduint64(json, "lte", end);
+
+	zbx_json_close(json);
+	zbx_json_close(json);
+	zbx_json_close(json);
+	zbx_json_close(json);
+	zbx_json_close(json);
+	zbx_json_close(json);
+	zbx_json_close(json);
+}
+
 /************************************************************************************
  *                                                                                  *
  * Purpose: gets item history data from history storage                             *
@@ -662,6 +910,8 @@ static int	elastic_get_values_for_period(zbx_history_iface_t *hist, zbx_uint64_t
 				zbx_age2str(end - start), *count);
 	}
 
+	elastic_writer_progress();
+
 	if (0 != hist->config_log_slow_queries)
 		sec = zbx_time();
 
@@ -693,34 +943,7 @@ static int	elastic_get_values_for_period(zbx_history_iface_t *hist, zbx_uint64_t
 		zbx_json_close(&query);
 	}
 
-	zbx_json_addobject(&query, "query");
-	zbx_json_addobject(&query, "bool");
-	zbx_json_addarray(&query, "must");
-	zbx_json_addobject(&query, NULL);
-	zbx_json_addobject(&query, "match");
-	zbx_json_adduint64(&query, "itemid", itemid);
-	zbx_json_close(&query);
-	zbx_json_close(&query);
-	zbx_json_close(&query);
-	zbx_json_addarray(&query, "filter");
-	zbx_json_addobject(&query, NULL);
-	zbx_json_addobject(&query, "range");
-	zbx_json_addobject(&query, "clock");
-
-	zbx_json_addstring(&query, "format", "epoch_second", ZBX_JSON_TYPE_STRING);
-	if (0 < start)
-		zbx_json_adduint64(&query, "gt", start);
-
-	if (0 < end)
-		zbx_json_adduint64(&query, "lte", end);
-
-	zbx_json_close(&query);
-	zbx_json_close(&query);
-	zbx_json_close(&query);
-	zbx_json_close(&query);
-	zbx_json_close(&query);
-	zbx_json_close(&query);
-	zbx_json_close(&query);
+	elastic_json_add_query(&query, itemid, start, end);
 
 	curl_headers = curl_slist_append(curl_headers, "Content-Type: application/json");
 
@@ -1009,6 +1232,274 @@ static int	elastic_get_values(zbx_history_iface_t *hist, zbx_uint64_t itemid, in
 	return elastic_read_values_by_count(hist, itemid, count, end, values);
 }
 
+/************************************************************************************
+ *                                                                                  *
+ * Purpose: parses multi search response                                            *
+ *                                                                                  *
+ * Parameters:  response    - [IN] the multi search response                        *
+ *              value_type  - [IN] the value type of searched items                 *
+ *              itemids_num - [IN] the number of searches                           *
+ *              values      - [OUT] the item history data values, the array of      *
+ *                                  vectors matching searches                       *
+ *              reread      - [OUT] the indexes of searches that must be repeated   *
+ *                                  with scroll requests                            *
+ *                                                                                  *
+ * Return value: SUCCEED - the response was parsed                                  *
+ *               FAIL - the response has no responses array                         *
+ *                                                                                  *
+ * Comments: Failed searches, searches reaching ZBX_ELASTIC_MSEARCH_SIZE results    *
+ *           and searches without response are added to reread vector.              *
+ *                                                                                  *
+ ************************************************************************************/
+static int	elastic_msearch_parse(const char *response, unsigned char value_type, int itemids_num,
+		zbx_vector_history_record_t *values, zbx_vector_int32_t *reread)
+{
+	struct zbx_json_parse	jp, jp_responses;
+	const char		*p = NULL;
+	int			i;
+
+	if (NULL == response || SUCCEED != zbx_json_open(response, &jp) ||
+			SUCCEED != zbx_json_brackets_by_name(&jp, "responses", &jp_responses))
+	{
+		return FAIL;
+	}
+
+	/* the responses are returned in the same order as the searches were sent */
+	for (i = 0; i < itemids_num; i++)
+	{
+		struct zbx_json_parse	jp_response, jp_sub, jp_hits, jp_item, jp_source;
+		const char		*p_hit = NULL;
+		zbx_history_record_t	hr;
+		int			hits_num = 0;
+
+		if (NULL == (p = zbx_json_next(&jp_responses, p)))
+			break;
+
+		/* a failed search of a single item is reported in its response */
+		if (SUCCEED != zbx_json_brackets_open(p, &jp_response) ||
+				SUCCEED != zbx_json_brackets_by_name(&jp_response, "hits", &jp_sub) ||
+				SUCCEED != zbx_json_brackets_by_name(&jp_sub, "hits", &jp_hits))
+		{
+			zbx_vector_int32_append(reread, i);
+			continue;
+		}
+
+		while (NULL != (p_hit = zbx_json_next(&jp_hits, p_hit)))
+		{
+			hits_num++;
+
+			if (SUCCEED != zbx_json_brackets_open(p_hit, &jp_item))
+				continue;
+
+			if (SUCCEED != zbx_json_brackets_by_name(&jp_item, "_source", &jp_source))
+				continue;
+
+			if (SUCCEED != history_parse_value(&jp_source, value_type, &hr))
+				continue;
+
+			zbx_vector_history_record_append_ptr(&values[i], &hr);
+		}
+
+		if (ZBX_ELASTIC_MSEARCH_SIZE <= hits_num)
+		{
+			zbx_history_record_vector_clean(&values[i], value_type);
+			zbx_vector_int32_append(reread, i);
+			continue;
+		}
+
+		zbx_vector_history_record_sort(&values[i],
+				(zbx_compare_func_t)zbx_history_record_compare_desc_func);
+	}
+
+	for (; i < itemids_num; i++)
+		zbx_vector_int32_append(reread, i);
+
+	return SUCCEED;
+}
+
+/************************************************************************************
+ *                                                                                  *
+ * Purpose: gets history data of multiple items with a single multi search request  *
+ *                                                                                  *
+ * Parameters:  hist        - [IN] the history storage interface                    *
+ *              itemids     - [IN] the item identifiers                             *
+ *              itemids_num - [IN] the number of item identifiers                   *
+ *              start       - [IN] the period start timestamp                       *
+ *              end         - [IN] the period end timestamp                         *
+ *              values      - [OUT] the item history data values, the array of      *
+ *                                  vectors matching itemids                        *
+ *              reread      - [OUT] the indexes of items that must be read with     *
+ *                                  scroll requests                                 *
+ *                                                                                  *
+ * Return value: SUCCEED - the history data were read successfully                  *
+ *               FAIL - otherwise                                                   *
+ *                                                                                  *
+ * Comments: A single search returns at most ZBX_ELASTIC_MSEARCH_SIZE values, so    *
+ *           items reaching this limit or failed searches are returned in reread    *
+ *           vector, see elastic_msearch_parse().                                   *
+ *                                                                                  *
+ ************************************************************************************/
+static int	elastic_msearch_values(zbx_history_iface_t *hist, const zbx_uint64_t *itemids, int itemids_num,
+		time_t start, time_t end, zbx_vector_history_record_t *values, zbx_vector_int32_t *reread)
+{
+	zbx_elastic_data_t	*data = hist->data.elastic_data;
+	size_t			url_alloc = 0, url_offset = 0, body_alloc = 0, body_offset = 0;
+	int			i, ret = FAIL;
+	CURLcode		err;
+	struct zbx_json		header, query;
+	struct curl_slist	*curl_headers = NULL;
+	char			*body = NULL, errbuf[CURL_ERROR_SIZE], *error = NULL, index[16];
+	CURLoption		opt;
+	double			sec = 0;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() itemids:%d", __func__, itemids_num);
+
+	if (0 != hist->config_log_slow_queries)
+		sec = zbx_time();
+
+	zbx_snprintf(index, sizeof(index), "%s*", value_type_str[hist->value_type]);
+
+	zbx_json_init(&header, ZBX_IDX_JSON_ALLOCATE);
+	zbx_json_addstring(&header, "index", index, ZBX_JSON_TYPE_STRING);
+	zbx_json_close(&header);
+
+	for (i = 0; i < itemids_num; i++)
+	{
+		zbx_json_init(&query, ZBX_JSON_ALLOCATE);
+		zbx_json_adduint64(&query, "size", ZBX_ELASTIC_MSEARCH_SIZE);
+		elastic_json_add_query(&query, itemids[i], start, end);
+
+		zbx_snprintf_alloc(&body, &body_alloc, &body_offset, "%s\n%s\n", header.buffer, query.buffer);
+
+		zbx_json_free(&query);
+	}
+
+	if (NULL == (data->handle = curl_easy_init()))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot initialize cURL session");
+		goto out;
+	}
+
+	zbx_snprintf_alloc(&data->post_url, &url_alloc, &url_offset, "%s/_msearch", data->base_url);
+
+	curl_headers = curl_slist_append(curl_headers, "Content-Type: application/x-ndjson");
+
+	if (CURLE_OK != (err = curl_easy_setopt(data->handle, opt = CURLOPT_URL, data->post_url)) ||
+			CURLE_OK != (err = curl_easy_setopt(data->handle, opt = CURLOPT_POSTFIELDS, body)) ||
+			CURLE_OK != (err = curl_easy_setopt(data->handle, opt = CURLOPT_WRITEFUNCTION,
+					curl_write_cb)) ||
+			CURLE_OK != (err = curl_easy_setopt(data->handle, opt = CURLOPT_WRITEDATA, &page_r)) ||
+			CURLE_OK != (err = curl_easy_setopt(data->handle, opt = CURLOPT_HTTPHEADER, curl_headers)) ||
+			CURLE_OK != (err = curl_easy_setopt(data->handle, opt = CURLOPT_FAILONERROR, 1L)) ||
+			CURLE_OK != (err = curl_easy_setopt(data->handle, opt = CURLOPT_ERRORBUFFER, errbuf)) ||
+			CURLE_OK != (err = curl_easy_setopt(data->handle, opt = CURLOPT_ACCEPT_ENCODING, "")))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot set cURL option %d: [%s]", (int)opt, curl_easy_strerror(err));
+		goto out;
+	}
+
+	if (SUCCEED != zbx_curl_setopt_https(data->handle, &error))
+	{
+		zabbix_log(LOG_LEVEL_ERR, error);
+		goto out;
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "sending query to %s; post data: %s", data->post_url, body);
+
+	page_r.offset = 0;
+	*errbuf = '\0';
+	if (CURLE_OK != (err = curl_easy_perform(data->handle)))
+	{
+		elastic_log_error(data->handle, err, errbuf);
+		goto out;
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "received from elasticsearch: %s", page_r.data);
+
+	if (SUCCEED != elastic_msearch_parse(page_r.data, hist->value_type, itemids_num, values, reread))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "elasticsearch version is not compatible with zabbix server. "
+				"responses tag is absent");
+		goto out;
+	}
+
+	ret = SUCCEED;
+out:
+	elastic_close(hist);
+
+	curl_slist_free_all(curl_headers);
+
+	if (0 != hist->config_log_slow_queries)
+	{
+		sec = zbx_time() - sec;
+		if (sec > (double)hist->config_log_slow_queries / 1000.0)
+			zabbix_log(LOG_LEVEL_WARNING, "slow query: " ZBX_FS_DBL " sec, \"%s\"", sec, body);
+	}
+
+	zbx_json_free(&header);
+
+	zbx_free(body);
+	zbx_free(error);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s reread:%d", __func__, zbx_result_string(ret),
+			reread->values_num);
+
+	return ret;
+}
+
+/************************************************************************************
+ *                                                                                  *
+ * Purpose: gets history data of multiple items from history storage                *
+ *                                                                                  *
+ * Parameters:  hist    - [IN] the history storage interface                        *
+ *              itemids - [IN] the item identifiers                                 *
+ *              start   - [IN] the period start timestamp                           *
+ *              end     - [IN] the period end timestamp                             *
+ *              values  - [OUT] the item history data values, the array of vectors  *
+ *                              matching itemids                                    *
+ *                                                                                  *
+ * Return value: SUCCEED - the history data were read successfully                  *
+ *               FAIL - otherwise                                                   *
+ *                                                                                  *
+ * Comments: This function reads all values from ]<start>,<end>] interval using     *
+ *           multi search requests instead of scroll requests per item.             *
+ *                                                                                  *
+ ************************************************************************************/
+static int	elastic_get_values_multi(zbx_history_iface_t *hist, const zbx_vector_uint64_t *itemids, int start,
+		int end, zbx_vector_history_record_t *values)
+{
+	zbx_vector_int32_t	reread;
+	int			ret = SUCCEED;
+
+	zbx_vector_int32_create(&reread);
+
+	elastic_writer_progress();
+
+	for (int i = 0; i < itemids->values_num && SUCCEED == ret; i += ZBX_ELASTIC_MSEARCH_BATCH)
+	{
+		int	num = MIN(ZBX_ELASTIC_MSEARCH_BATCH, itemids->values_num - i);
+
+		zbx_vector_int32_clear(&reread);
+
+		if (SUCCEED != (ret = elastic_msearch_values(hist, itemids->values + i, num, start, end, values + i,
+				&reread)))
+		{
+			break;
+		}
+
+		for (int j = 0; j < reread.values_num && SUCCEED == ret; j++)
+		{
+			int	k = i + reread.values[j], count = 0;
+
+			ret = elastic_get_values_for_period(hist, itemids->values[k], start, &count, end, &values[k]);
+		}
+	}
+
+	zbx_vector_int32_destroy(&reread);
+
+	return ret;
+}
+
 /************************************************************************************
  *                                                                                  *
  * Purpose: sends history data to the storage                                       *
@@ -1153,6 +1644,7 @@ int	zbx_history_elastic_init(zbx_history_iface_t *hist, unsigned char value_type
 	hist->add_values = elastic_add_values;
 	hist->flush = elastic_flush;
 	hist->get_values = elastic_get_values;
+	hist->get_values_multi = elastic_get_values_multi;
 	hist->requires_trends = 0;
 	hist->config_log_slow_queries = config_log_slow_queries;
 
@@ -1329,6 +1821,10 @@ zbx_uint32_t	zbx_elastic_version_get(void)
 
 	return ZBX_ELASTIC_SVERSION;
 }
+
+#ifdef HAVE_TESTS
+#	include "../../../tests/libs/zbxhistory/history_elastic_test.c"
+#endif
 #else
 int	zbx_history_elastic_init(zbx_history_iface_t *hist, unsigned char value_type,
 		const char *config_history_storage_url, int config_log_slow_queries, char **error)
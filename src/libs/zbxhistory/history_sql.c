@@ -395,6 +395,98 @@ out:
 	return SUCCEED;
 }
 
+/*********************************************************************************
+ *                                                                               *
+ * Purpose: reads history data of multiple items from database                   *
+ *                                                                               *
+ * Parameters:  itemids       - [IN] the sorted item identifiers                 *
+ *              value_type    - [IN] the value type (see ITEM_VALUE_TYPE_* defs) *
+ *              values        - [OUT] the item history data values, the array of *
+ *                                    vectors matching itemids                   *
+ *              seconds       - [IN] the time period to read                     *
+ *              end_timestamp - [IN] the value timestamp to start reading with   *
+ *                                                                               *
+ * Return value: SUCCEED - the history data were read successfully               *
+ *               FAIL - otherwise                                                *
+ *                                                                               *
+ * Comments: This function reads all values with timestamps in range:            *
+ *             end_timestamp - seconds < <value timestamp> <= end_timestamp      *
+ *           Items are read in batches with one query per batch instead of one   *
+ *           query per item.                                                     *
+ *                                                                               *
+ *********************************************************************************/
+static int	db_read_values_by_time_multi(const zbx_vector_uint64_t *itemids, int value_type,
+		zbx_vector_history_record_t *values, int seconds, int end_timestamp)
+{
+	char			*sql = NULL;
+	size_t			sql_alloc = 0, sql_offset;
+	zbx_db_result_t		result;
+	zbx_db_row_t		row;
+	zbx_vc_history_table_t	*table = &vc_history_tables[value_type];
+	time_t			time_from;
+	int			ret = SUCCEED;
+
+	time_from = end_timestamp - seconds;
+
+	zbx_recalc_time_period(&time_from, ZBX_RECALC_TIME_PERIOD_HISTORY);
+
+	if (time_from >= end_timestamp)
+		return SUCCEED;
+
+	for (int i = 0; i < itemids->values_num && SUCCEED == ret; i += ZBX_DB_LARGE_QUERY_BATCH_SIZE)
+	{
+		int	batch_num = MIN(ZBX_DB_LARGE_QUERY_BATCH_SIZE, itemids->values_num - i);
+
+		sql_offset = 0;
+		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "select itemid,clock,ns,%s from %s where",
+				table->fields, table->name);
+		zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "itemid", itemids->values + i, batch_num);
+
+		if (ZBX_JAN_2038 == end_timestamp)
+		{
+			zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " and clock>" ZBX_FS_I64, time_from);
+		}
+		else
+		{
+			zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " and clock>" ZBX_FS_I64 " and clock<=%d",
+					time_from, end_timestamp);
+		}
+
+		if (NULL == (result = zbx_db_select("%s", sql)))
+		{
+			ret = FAIL;
+			break;
+		}
+
+		while (NULL != (row = zbx_db_fetch(result)))
+		{
+			zbx_uint64_t		itemid;
+			zbx_history_record_t	value;
+			int			index;
+
+			ZBX_STR2UINT64(itemid, row[0]);
+
+			if (FAIL == (index = zbx_vector_uint64_bsearch(itemids, itemid,
+					ZBX_DEFAULT_UINT64_COMPARE_FUNC)))
+			{
+				THIS_SHOULD_NEVER_HAPPEN;
+				continue;
+			}
+
+			value.timestamp.sec = atoi(row[1]);
+			value.timestamp.ns = atoi(row[2]);
+			table->rtov(&value.value, row + 3);
+
+			zbx_vector_history_record_append_ptr(&values[index], &value);
+		}
+		zbx_db_free_result(result);
+	}
+
+	zbx_free(sql);
+
+	return ret;
+}
+
 /************************************************************************************
  *                                                                                  *
  * Purpose: reads item history data from database                                   *
@@ -643,6 +735,27 @@ static int	sql_get_values(zbx_history_iface_t *hist, zbx_uint64_t itemid, int st
 	return db_read_values_by_time_and_count(itemid, hist->value_type, values, end - start, count, end);
 }
 
+/************************************************************************************
+ *                                                                                  *
+ * Purpose: gets history data of multiple items from history storage                *
+ *                                                                                  *
+ * Parameters:  hist    - [IN] the history storage interface                        *
+ *              itemids - [IN] the sorted item identifiers                          *
+ *              start   - [IN] the period start timestamp                           *
+ *              end     - [IN] the period end timestamp                             *
+ *              values  - [OUT] the item history data values, the array of vectors  *
+ *                              matching itemids                                    *
+ *                                                                                  *
+ * Return value: SUCCEED - the history data were read successfully                  *
+ *               FAIL - otherwise                                                   *
+ *                                                                                  *
+ ************************************************************************************/
+static int	sql_get_values_multi(zbx_history_iface_t *hist, const zbx_vector_uint64_t *itemids, int start,
+		int end, zbx_vector_history_record_t *values)
+{
+	return db_read_values_by_time_multi(itemids, hist->value_type, values, end - start, end);
+}
+
 /**********************************************************************************************
  *                                                                                            *
  * Purpose: sends history data to storage                                                     *
@@ -707,6 +820,7 @@ void	zbx_history_sql_init(zbx_history_iface_t *hist, unsigned char value_type)
 	hist->add_values = sql_add_values;
 	hist->flush = sql_flush;
 	hist->get_values = sql_get_values;
+	hist->get_values_multi = sql_get_values_multi;
 
 	switch (value_type)
 	{
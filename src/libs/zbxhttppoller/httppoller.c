@@ -22,6 +22,49 @@
 #include "httptest.h"
 #include "zbxtime.h"
 #include "zbxthreads.h"
+#include "zbxpreproc.h"
+
+static void	httppoller_timer(evutil_socket_t fd, short events, void *arg)
+{
+	ZBX_UNUSED(fd);
+	ZBX_UNUSED(events);
+	ZBX_UNUSED(arg);
+}
+
+#define HTTPPOLLER_PREPROC_FLUSH_DELAY	0.1
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sends cached values to preprocessing manager when the oldest one  *
+ *          is waiting long enough, otherwise arms the flush timer            *
+ *                                                                            *
+ * Comments: Results arrive one by one as steps finish, they are sent to      *
+ *           preprocessing in batches.                                        *
+ *                                                                            *
+ ******************************************************************************/
+static void	httppoller_preproc_flush(zbx_httptest_poller_t *poller)
+{
+	double		flush_delay;
+	struct timeval	tv;
+
+	if (0 >= (flush_delay = zbx_preprocessor_flush_delayed(HTTPPOLLER_PREPROC_FLUSH_DELAY)))
+		return;
+
+	if (0 != evtimer_pending(poller->preproc_flush_timer, NULL))
+		return;
+
+	tv.tv_sec = 0;
+	tv.tv_usec = (suseconds_t)(flush_delay * 1000000);
+	evtimer_add(poller->preproc_flush_timer, &tv);
+}
+
+static void	httppoller_preproc_flush_timer(evutil_socket_t fd, short events, void *arg)
+{
+	ZBX_UNUSED(fd);
+	ZBX_UNUSED(events);
+
+	httppoller_preproc_flush((zbx_httptest_poller_t *)arg);
+}
 
 /******************************************************************************
  *                                                                            *
@@ -32,13 +75,16 @@
  ******************************************************************************/
 ZBX_THREAD_ENTRY(zbx_httppoller_thread, args)
 {
-	int					sleeptime = -1, httptests_count = 0, old_httptests_count = 0,
+	int					httptests_count = 0,
 						server_num = ((zbx_thread_args_t *)args)->info.server_num,
 						process_num = ((zbx_thread_args_t *)args)->info.process_num;
-	double					total_sec = 0.0, old_total_sec = 0.0;
 	time_t					last_stat_time, nextcheck = 0;
 	const zbx_thread_info_t			*info = &((zbx_thread_args_t *)args)->info;
 	unsigned char				process_type = ((zbx_thread_args_t *)args)->info.process_type;
+	struct event_base			*base;
+	struct event				*timer;
+	struct timeval				tv = {1, 0};
+	zbx_httptest_poller_t			poller;
 
 	const zbx_thread_httppoller_args	*httppoller_args_in = (const zbx_thread_httppoller_args *)
 						(((zbx_thread_args_t *)args)->args);
@@ -56,28 +102,40 @@ ZBX_THREAD_ENTRY(zbx_httppoller_thread, args)
 
 	zbx_db_connect(ZBX_DB_CONNECT_NORMAL);
 
+	if (NULL == (base = event_base_new()))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot initialize event base");
+		exit(EXIT_FAILURE);
+	}
+
+	/* wake up at least once per second to start scheduled web scenarios */
+	if (NULL == (timer = event_new(base, -1, EV_PERSIST, httppoller_timer, NULL)))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot create web scenario timer event");
+		exit(EXIT_FAILURE);
+	}
+
+	evtimer_add(timer, &tv);
+
+	httptest_poller_init(&poller, base, httppoller_args_in, info);
+
+	if (NULL == (poller.preproc_flush_timer = evtimer_new(base, httppoller_preproc_flush_timer, &poller)))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot create preprocessing flush timer event");
+		exit(EXIT_FAILURE);
+	}
+
 	while (ZBX_IS_RUNNING())
 	{
 		double	sec = zbx_time();
 
 		zbx_update_env(get_process_type_string(process_type), sec);
 
-		if (0 != sleeptime)
-		{
-			zbx_setproctitle("%s #%d [got %d values in " ZBX_FS_DBL " sec, getting values]",
-					get_process_type_string(process_type), process_num, old_httptests_count,
-					old_total_sec);
-		}
-
 		if ((int)sec >= nextcheck)
 		{
 			time_t	now;
 
-			httptests_count += process_httptests((int)sec, httppoller_args_in->config_source_ip,
-					httppoller_args_in->config_ssl_ca_location,
-					httppoller_args_in->config_ssl_cert_location,
-					httppoller_args_in->config_ssl_key_location, &nextcheck);
-			total_sec += zbx_time() - sec;
+			httptests_count += process_httptests(&poller, (int)sec, &nextcheck);
 
 			now = time(NULL);
 
@@ -85,35 +143,46 @@ ZBX_THREAD_ENTRY(zbx_httppoller_thread, args)
 				nextcheck = now + POLLER_DELAY;
 		}
 
-		sleeptime = zbx_calculate_sleeptime(nextcheck, POLLER_DELAY);
+		if (ZBX_PROCESS_STATE_BUSY == poller.state &&
+				poller.runs.values_num < httppoller_args_in->config_max_concurrent_checks_per_poller)
+		{
+			zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_IDLE);
+			poller.state = ZBX_PROCESS_STATE_IDLE;
+		}
+
+		event_base_loop(base, EVLOOP_ONCE);
 
-		if (0 != sleeptime || STAT_INTERVAL <= time(NULL) - last_stat_time)
+		if (ZBX_IS_RUNNING())
+			httppoller_preproc_flush(&poller);
+
+		if (STAT_INTERVAL <= time(NULL) - last_stat_time)
 		{
-			if (0 == sleeptime)
-			{
-				zbx_setproctitle("%s #%d [got %d values in " ZBX_FS_DBL " sec, getting values]",
-						get_process_type_string(process_type), process_num, httptests_count,
-						total_sec);
-			}
-			else
-			{
-				zbx_setproctitle("%s #%d [got %d values in " ZBX_FS_DBL " sec, idle %d sec]",
-						get_process_type_string(process_type), process_num, httptests_count,
-						total_sec, sleeptime);
-				old_httptests_count = httptests_count;
-				old_total_sec = total_sec;
-			}
+			zbx_setproctitle("%s #%d [started %d, finished %d web scenarios in 5 sec, in progress %d]",
+					get_process_type_string(process_type), process_num, httptests_count,
+					poller.processed, poller.runs.values_num);
+
 			httptests_count = 0;
-			total_sec = 0.0;
+			poller.processed = 0;
 			last_stat_time = time(NULL);
 		}
-
-		zbx_sleep_loop(info, sleeptime);
 	}
 
+	evtimer_del(timer);
+	event_free(timer);
+	evtimer_del(poller.preproc_flush_timer);
+	event_free(poller.preproc_flush_timer);
+
+	httptest_poller_stop(&poller);
+	httptest_poller_destroy(&poller);
+	event_base_free(base);
+
+	zbx_preprocessor_flush();
+
 	zbx_setproctitle("%s #%d [terminated]", get_process_type_string(process_type), process_num);
 
 	while (1)
 		zbx_sleep(SEC_PER_MIN);
 #undef STAT_INTERVAL
 }
+
+#undef HTTPPOLLER_PREPROC_FLUSH_DELAY
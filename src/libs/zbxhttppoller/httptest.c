@@ -28,6 +28,7 @@
 #include "zbxdbhigh.h"
 #include "zbxstr.h"
 #include "zbxtime.h"
+#include "zbxself.h"
 #include "zbx_expression_constants.h"
 #include "zbxexpr.h"
 
@@ -47,6 +48,105 @@ zbx_httpstat_t;
 
 #endif	/* HAVE_LIBCURL */
 
+#define HTTPTEST_CLEANUP_PERIOD	SEC_PER_HOUR	/* how often to check for unused web scenario definitions */
+#define HTTPTEST_UNUSED_PERIOD	SEC_PER_DAY	/* remove web scenario definitions not run for this long */
+
+/* web scenario or step field as stored in database, macros are resolved on every run */
+typedef struct
+{
+	char	*name;
+	char	*value;
+	int	type;
+}
+zbx_httpfield_t;
+
+ZBX_PTR_VECTOR_DECL(httpfield_ptr, zbx_httpfield_t *)
+ZBX_PTR_VECTOR_IMPL(httpfield_ptr, zbx_httpfield_t *)
+
+/* web scenario or step items, up to 3 per object */
+typedef struct
+{
+	zbx_uint64_t	itemids[3];
+	unsigned char	types[3];
+	int		num;
+}
+zbx_httpitems_t;
+
+typedef struct
+{
+	zbx_uint64_t			httpstepid;
+	char				*name;
+	char				*url;
+	char				*timeout;
+	char				*posts;
+	char				*required;
+	char				*status_codes;
+	int				no;
+	int				post_type;
+	int				follow_redirects;
+	int				retrieve_mode;
+	zbx_vector_httpfield_ptr_t	fields;
+	zbx_httpitems_t			items;
+}
+zbx_httpstep_def_t;
+
+ZBX_PTR_VECTOR_DECL(httpstep_def_ptr, zbx_httpstep_def_t *)
+ZBX_PTR_VECTOR_IMPL(httpstep_def_ptr, zbx_httpstep_def_t *)
+
+/* web scenario definition cached by HTTP poller until configuration revision changes */
+typedef struct
+{
+	zbx_uint64_t			httptestid;
+	zbx_uint64_t			revision;
+	zbx_uint64_t			hostid;
+	char				*name;
+	char				*agent;
+	char				*http_user;
+	char				*http_password;
+	char				*http_proxy;
+	char				*ssl_cert_file;
+	char				*ssl_key_file;
+	char				*ssl_key_password;
+	char				*delay;
+	int				authentication;
+	int				retries;
+	int				verify_peer;
+	int				verify_host;
+	int				running;
+	unsigned char			stale;		/* replaced by newer revision, released after last run */
+	time_t				lastaccess;
+	zbx_vector_httpfield_ptr_t	fields;
+	zbx_vector_httpstep_def_ptr_t	steps;
+	zbx_httpitems_t			items;
+}
+zbx_httptest_def_t;
+
+/* web scenario run, progresses step by step as requests complete */
+typedef struct
+{
+	zbx_httptest_poller_t	*poller;
+	zbx_httptest_def_t	*def;
+	zbx_dc_host_t		host;
+	zbx_httptest_t		httptest;
+	zbx_db_httpstep		db_httpstep;
+	zbx_httpstep_t		httpstep;
+	int			step_index;
+	int			now;
+	int			delay;
+	int			lastfailedstep;
+	int			speed_download_num;
+	double			speed_download;
+	char			*err_str;
+#ifdef HAVE_LIBCURL
+	CURL			*easyhandle;
+	struct curl_slist	*headers_slist;
+	zbx_http_response_t	body;
+	zbx_http_response_t	header;
+	char			errbuf[CURL_ERROR_SIZE];
+#endif
+}
+zbx_httptest_context_t;
+
 /******************************************************************************
  *                                                                            *
  * Purpose: removes all macro variables cached during HTTP test execution     *
@@ -67,6 +167,340 @@ static void	httptest_remove_macros(zbx_httptest_t *httptest)
 	zbx_vector_ptr_pair_clear(&httptest->macros);
 }
 
+static void	httpfield_free(zbx_httpfield_t *field)
+{
+	zbx_free(field->name);
+	zbx_free(field->value);
+	zbx_free(field);
+}
+
+static void	httpstep_def_free(zbx_httpstep_def_t *step)
+{
+	zbx_vector_httpfield_ptr_clear_ext(&step->fields, httpfield_free);
+	zbx_vector_httpfield_ptr_destroy(&step->fields);
+
+	zbx_free(step->name);
+	zbx_free(step->url);
+	zbx_free(step->timeout);
+	zbx_free(step->posts);
+	zbx_free(step->required);
+	zbx_free(step->status_codes);
+	zbx_free(step);
+}
+
+static void	httptest_def_clean(zbx_httptest_def_t *def)
+{
+	zbx_vector_httpstep_def_ptr_clear_ext(&def->steps, httpstep_def_free);
+	zbx_vector_httpstep_def_ptr_destroy(&def->steps);
+	zbx_vector_httpfield_ptr_clear_ext(&def->fields, httpfield_free);
+	zbx_vector_httpfield_ptr_destroy(&def->fields);
+
+	zbx_free(def->name);
+	zbx_free(def->agent);
+	zbx_free(def->http_user);
+	zbx_free(def->http_password);
+	zbx_free(def->http_proxy);
+	zbx_free(def->ssl_cert_file);
+	zbx_free(def->ssl_key_file);
+	zbx_free(def->ssl_key_password);
+	zbx_free(def->delay);
+}
+
+static void	httpitems_add(zbx_httpitems_t *items, const char *type, const char *itemid)
+{
+	if (ARRSIZE(items->itemids) == items->num)
+	{
+		THIS_SHOULD_NEVER_HAPPEN;
+		return;
+	}
+
+	items->types[items->num] = (unsigned char)atoi(type);
+	ZBX_STR2UINT64(items->itemids[items->num], itemid);
+	items->num++;
+}
+
+static zbx_httpfield_t	*httpfield_create(const char *name, const char *value, const char *type)
+{
+	zbx_httpfield_t	*field;
+
+	field = (zbx_httpfield_t *)zbx_malloc(NULL, sizeof(zbx_httpfield_t));
+	field->name = zbx_strdup(NULL, name);
+	field->value = zbx_strdup(NULL, value);
+	field->type = atoi(type);
+
+	return field;
+}
+
+static int	httpstep_def_compare_id(const void *d1, const void *d2)
+{
+	const zbx_httpstep_def_t	*s1 = *(const zbx_httpstep_def_t * const *)d1;
+	const zbx_httpstep_def_t	*s2 = *(const zbx_httpstep_def_t * const *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(s1->httpstepid, s2->httpstepid);
+
+	return 0;
+}
+
+static zbx_httpstep_def_t	*httptest_def_find_step(zbx_httptest_def_t *def, const char *httpstepid)
+{
+	zbx_httpstep_def_t	step_local, *step = &step_local;
+	int			i;
+
+	ZBX_STR2UINT64(step_local.httpstepid, httpstepid);
+
+	if (FAIL == (i = zbx_vector_httpstep_def_ptr_search(&def->steps, step, httpstep_def_compare_id)))
+		return NULL;
+
+	return def->steps.values[i];
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: loads web scenario definition with its fields, steps and items    *
+ *          from database                                                     *
+ *                                                                            *
+ * Parameters: def - [IN/OUT] definition with httptestid set                  *
+ *                                                                            *
+ * Return value: SUCCEED - definition was loaded                              *
+ *               FAIL    - web scenario was not found                         *
+ *                                                                            *
+ ******************************************************************************/
+static int	httptest_def_load(zbx_httptest_def_t *def)
+{
+	zbx_db_result_t	result;
+	zbx_db_row_t	row;
+	int		ret = FAIL;
+
+	result = zbx_db_select(
+			"select hostid,name,agent,authentication,http_user,http_password,http_proxy,retries,"
+				"ssl_cert_file,ssl_key_file,ssl_key_password,verify_peer,verify_host,delay"
+			" from httptest"
+			" where httptestid=" ZBX_FS_UI64,
+			def->httptestid);
+
+	if (NULL != (row = zbx_db_fetch(result)))
+	{
+		ZBX_STR2UINT64(def->hostid, row[0]);
+		def->name = zbx_strdup(NULL, row[1]);
+		def->agent = zbx_strdup(NULL, row[2]);
+		def->authentication = atoi(row[3]);
+		def->http_user = zbx_strdup(NULL, row[4]);
+		def->http_password = zbx_strdup(NULL, row[5]);
+		def->http_proxy = zbx_strdup(NULL, row[6]);
+		def->retries = atoi(row[7]);
+		def->ssl_cert_file = zbx_strdup(NULL, row[8]);
+		def->ssl_key_file = zbx_strdup(NULL, row[9]);
+		def->ssl_key_password = zbx_strdup(NULL, row[10]);
+		def->verify_peer = atoi(row[11]);
+		def->verify_host = atoi(row[12]);
+		def->delay = zbx_strdup(NULL, row[13]);
+
+		ret = SUCCEED;
+	}
+	zbx_db_free_result(result);
+
+	if (SUCCEED != ret)
+		return FAIL;
+
+	result = zbx_db_select(
+			"select name,value,type"
+			" from httptest_field"
+			" where httptestid=" ZBX_FS_UI64
+			" order by httptest_fieldid",
+			def->httptestid);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+		zbx_vector_httpfield_ptr_append(&def->fields, httpfield_create(row[0], row[1], row[2]));
+	zbx_db_free_result(result);
+
+	result = zbx_db_select("select type,itemid from httptestitem where httptestid=" ZBX_FS_UI64,
+			def->httptestid);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+		httpitems_add(&def->items, row[0], row[1]);
+	zbx_db_free_result(result);
+
+	result = zbx_db_select(
+			"select httpstepid,no,name,url,timeout,posts,required,status_codes,post_type,follow_redirects,"
+				"retrieve_mode"
+			" from httpstep"
+			" where httptestid=" ZBX_FS_UI64
+			" order by no",
+			def->httptestid);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		zbx_httpstep_def_t	*step;
+
+		step = (zbx_httpstep_def_t *)zbx_malloc(NULL, sizeof(zbx_httpstep_def_t));
+
+		ZBX_STR2UINT64(step->httpstepid, row[0]);
+		step->no = atoi(row[1]);
+		step->name = zbx_strdup(NULL, row[2]);
+		step->url = zbx_strdup(NULL, row[3]);
+		step->timeout = zbx_strdup(NULL, row[4]);
+		step->posts = zbx_strdup(NULL, row[5]);
+		step->required = zbx_strdup(NULL, row[6]);
+		step->status_codes = zbx_strdup(NULL, row[7]);
+		step->post_type = atoi(row[8]);
+		step->follow_redirects = atoi(row[9]);
+		step->retrieve_mode = atoi(row[10]);
+		zbx_vector_httpfield_ptr_create(&step->fields);
+		memset(&step->items, 0, sizeof(step->items));
+
+		zbx_vector_httpstep_def_ptr_append(&def->steps, step);
+	}
+	zbx_db_free_result(result);
+
+	if (0 == def->steps.values_num)
+		return SUCCEED;
+
+	result = zbx_db_select(
+			"select f.httpstepid,f.name,f.value,f.type"
+			" from httpstep_field f,httpstep s"
+			" where f.httpstepid=s.httpstepid"
+				" and s.httptestid=" ZBX_FS_UI64
+			" order by f.httpstep_fieldid",
+			def->httptestid);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		zbx_httpstep_def_t	*step;
+
+		if (NULL != (step = httptest_def_find_step(def, row[0])))
+			zbx_vector_httpfield_ptr_append(&step->fields, httpfield_create(row[1], row[2], row[3]));
+	}
+	zbx_db_free_result(result);
+
+	result = zbx_db_select(
+			"select i.httpstepid,i.type,i.itemid"
+			" from httpstepitem i,httpstep s"
+			" where i.httpstepid=s.httpstepid"
+				" and s.httptestid=" ZBX_FS_UI64,
+			def->httptestid);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		zbx_httpstep_def_t	*step;
+
+		if (NULL != (step = httptest_def_find_step(def, row[0])))
+			httpitems_add(&step->items, row[1], row[2]);
+	}
+	zbx_db_free_result(result);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: moves definition of web scenario in progress out of definition    *
+ *          cache                                                             *
+ *                                                                            *
+ * Parameters: poller - [IN]                                                  *
+ *             def    - [IN] cached definition being replaced                 *
+ *                                                                            *
+ * Comments: Runs in progress are switched to the detached copy, it is        *
+ *           released when the last of them finishes.                         *
+ *                                                                            *
+ ******************************************************************************/
+static void	httptest_def_detach(zbx_httptest_poller_t *poller, zbx_httptest_def_t *def)
+{
+	zbx_httptest_def_t	*def_stale;
+
+	def_stale = (zbx_httptest_def_t *)zbx_malloc(NULL, sizeof(zbx_httptest_def_t));
+	memcpy(def_stale, def, sizeof(zbx_httptest_def_t));
+	def_stale->stale = 1;
+
+	for (int i = 0; i < poller->runs.values_num; i++)
+	{
+		zbx_httptest_context_t	*ctx = (zbx_httptest_context_t *)poller->runs.values[i];
+
+		if (ctx->def == def)
+			ctx->def = def_stale;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets web scenario definition, reloading it from database only if  *
+ *          configuration revision has changed                                *
+ *                                                                            *
+ * Parameters: poller     - [IN]                                              *
+ *             httptestid - [IN]                                              *
+ *             revision   - [IN] configuration cache revision of web scenario *
+ *             now        - [IN]                                              *
+ *                                                                            *
+ * Return value: web scenario definition or NULL if it was not found          *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_httptest_def_t	*httptest_def_get(zbx_httptest_poller_t *poller, zbx_uint64_t httptestid,
+		zbx_uint64_t revision, time_t now)
+{
+	zbx_httptest_def_t	*def, def_local;
+
+	if (NULL != (def = (zbx_httptest_def_t *)zbx_hashset_search(&poller->httptests, &httptestid)))
+	{
+		if (def->revision == revision)
+		{
+			def->lastaccess = now;
+			return def;
+		}
+
+		if (0 != def->running)
+			httptest_def_detach(poller, def);
+		else
+			httptest_def_clean(def);
+
+		zbx_hashset_remove_direct(&poller->httptests, def);
+	}
+
+	memset(&def_local, 0, sizeof(def_local));
+	def_local.httptestid = httptestid;
+	def_local.revision = revision;
+	def_local.lastaccess = now;
+	zbx_vector_httpfield_ptr_create(&def_local.fields);
+	zbx_vector_httpstep_def_ptr_create(&def_local.steps);
+
+	if (SUCCEED != httptest_def_load(&def_local))
+	{
+		httptest_def_clean(&def_local);
+		return NULL;
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "%s() loaded web scenario httptestid:" ZBX_FS_UI64 " revision:" ZBX_FS_UI64
+			" steps:%d", __func__, httptestid, revision, def_local.steps.values_num);
+
+	return (zbx_httptest_def_t *)zbx_hashset_insert(&poller->httptests, &def_local, sizeof(def_local));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: removes definitions of web scenarios that were not run recently,  *
+ *          e.g. deleted or moved to other poller                             *
+ *                                                                            *
+ ******************************************************************************/
+static void	httptest_defs_cleanup(zbx_httptest_poller_t *poller, time_t now)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_httptest_def_t	*def;
+
+	if (now < poller->httptests_cleanup)
+		return;
+
+	poller->httptests_cleanup = now + HTTPTEST_CLEANUP_PERIOD;
+
+	zbx_hashset_iter_reset(&poller->httptests, &iter);
+
+	while (NULL != (def = (zbx_httptest_def_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (0 != def->running || def->lastaccess + HTTPTEST_UNUSED_PERIOD > now)
+			continue;
+
+		httptest_def_clean(def);
+		zbx_hashset_iter_remove(&iter);
+	}
+}
+
 /* HTTP item types */
 #define ZBX_HTTPITEM_TYPE_RSPCODE	0
 #define ZBX_HTTPITEM_TYPE_TIME		1
@@ -74,11 +508,9 @@ static void	httptest_remove_macros(zbx_httptest_t *httptest)
 #define ZBX_HTTPITEM_TYPE_LASTSTEP	3
 #define ZBX_HTTPITEM_TYPE_LASTERROR	4
 
-static void	process_test_data(zbx_uint64_t httptestid, int lastfailedstep, double speed_download,
+static void	process_test_data(const zbx_httpitems_t *httpitems, int lastfailedstep, double speed_download,
 		const char *err_str, zbx_timespec_t *ts)
 {
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
 	unsigned char	types[3];
 	zbx_dc_item_t	items[3];
 	zbx_uint64_t	itemids[3];
@@ -88,17 +520,9 @@ static void	process_test_data(zbx_uint64_t httptestid, int lastfailedstep, doubl
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	result = zbx_db_select("select type,itemid from httptestitem where httptestid=" ZBX_FS_UI64, httptestid);
-
-	while (NULL != (row = zbx_db_fetch(result)))
+	for (int j = 0; j < httpitems->num; j++)
 	{
-		if (3 == num)
-		{
-			THIS_SHOULD_NEVER_HAPPEN;
-			break;
-		}
-
-		switch (types[num] = (unsigned char)atoi(row[0]))
+		switch (types[num] = httpitems->types[j])
 		{
 			case ZBX_HTTPITEM_TYPE_SPEED:
 			case ZBX_HTTPITEM_TYPE_LASTSTEP:
@@ -112,10 +536,9 @@ static void	process_test_data(zbx_uint64_t httptestid, int lastfailedstep, doubl
 				continue;
 		}
 
-		ZBX_STR2UINT64(itemids[num], row[1]);
+		itemids[num] = httpitems->itemids[j];
 		num++;
 	}
-	zbx_db_free_result(result);
 
 	if (0 < num)
 	{
@@ -166,6 +589,7 @@ static void	process_test_data(zbx_uint64_t httptestid, int lastfailedstep, doubl
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
+
 /******************************************************************************
  *                                                                            *
  * Purpose: performs concatenation of vector of pairs into delimited string   *
@@ -289,10 +713,8 @@ static int	macro_httptest_field_resolv(zbx_macro_resolv_data_t *p, va_list args,
 }
 
 #ifdef HAVE_LIBCURL
-static void	process_step_data(zbx_uint64_t httpstepid, zbx_httpstat_t *stat, zbx_timespec_t *ts)
+static void	process_step_data(const zbx_httpitems_t *httpitems, zbx_httpstat_t *stat, zbx_timespec_t *ts)
 {
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
 	unsigned char	types[3];
 	zbx_dc_item_t	items[3];
 	zbx_uint64_t	itemids[3];
@@ -303,27 +725,18 @@ static void	process_step_data(zbx_uint64_t httpstepid, zbx_httpstat_t *stat, zbx
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() rspcode:%ld time:" ZBX_FS_DBL " speed:%" CURL_FORMAT_CURL_OFF_T,
 			__func__, stat->rspcode, stat->total_time, stat->speed_download);
 
-	result = zbx_db_select("select type,itemid from httpstepitem where httpstepid=" ZBX_FS_UI64, httpstepid);
-
-	while (NULL != (row = zbx_db_fetch(result)))
+	for (int j = 0; j < httpitems->num; j++)
 	{
-		if (3 == num)
-		{
-			THIS_SHOULD_NEVER_HAPPEN;
-			break;
-		}
-
-		if (ZBX_HTTPITEM_TYPE_RSPCODE != (types[num] = (unsigned char)atoi(row[0])) &&
+		if (ZBX_HTTPITEM_TYPE_RSPCODE != (types[num] = httpitems->types[j]) &&
 				ZBX_HTTPITEM_TYPE_TIME != types[num] && ZBX_HTTPITEM_TYPE_SPEED != types[num])
 		{
 			THIS_SHOULD_NEVER_HAPPEN;
 			continue;
 		}
 
-		ZBX_STR2UINT64(itemids[num], row[1]);
+		itemids[num] = httpitems->itemids[j];
 		num++;
 	}
-	zbx_db_free_result(result);
 
 	if (0 < num)
 	{
@@ -376,20 +789,20 @@ static void	process_step_data(zbx_uint64_t httpstepid, zbx_httpstat_t *stat, zbx
 
 /******************************************************************************
  *                                                                            *
- * Purpose: loads HTTP fields of web scenario step                            *
+ * Purpose: prepares HTTP fields of web scenario step                         *
  *                                                                            *
  * Parameters: host     - [IN] host to be used in macro expansion             *
+ *             fields   - [IN] step fields                                    *
  *             httpstep - [IN/OUT] web scenario step                          *
  *                                                                            *
- * Return value: SUCCEED if HTTP fields were loaded and macro expansion was   *
+ * Return value: SUCCEED if HTTP fields were prepared and macro expansion was *
  *               successful. FAIL on error.                                   *
  *                                                                            *
  ******************************************************************************/
-static int	httpstep_load_pairs(zbx_dc_host_t *host, zbx_httpstep_t *httpstep)
+static int	httpstep_load_pairs(zbx_dc_host_t *host, const zbx_vector_httpfield_ptr_t *fields,
+		zbx_httpstep_t *httpstep)
 {
 	int			type, ret = SUCCEED;
-	zbx_db_result_t		result;
-	zbx_db_row_t		row;
 	size_t			alloc_len = 0, offset;
 	zbx_ptr_pair_t		pair;
 	zbx_vector_ptr_pair_t	*vector, headers, query_fields, post_fields;
@@ -404,18 +817,13 @@ static int	httpstep_load_pairs(zbx_dc_host_t *host, zbx_httpstep_t *httpstep)
 	zbx_vector_ptr_pair_create(&post_fields);
 	zbx_vector_ptr_pair_create(&httpstep->variables);
 
-	result = zbx_db_select(
-			"select name,value,type"
-			" from httpstep_field"
-			" where httpstepid=" ZBX_FS_UI64
-			" order by httpstep_fieldid",
-			httpstep->httpstep->httpstepid);
-
-	while (NULL != (row = zbx_db_fetch(result)))
+	for (int i = 0; i < fields->values_num; i++)
 	{
-		type = atoi(row[2]);
+		const zbx_httpfield_t	*field = fields->values[i];
+
+		type = field->type;
 
-		value = zbx_strdup(NULL, row[1]);
+		value = zbx_strdup(NULL, field->value);
 
 		/* from now on variable values can contain macros so proper URL encoding can be performed */
 
@@ -429,7 +837,7 @@ static int	httpstep_load_pairs(zbx_dc_host_t *host, zbx_httpstep_t *httpstep)
 			goto out;
 		}
 
-		key = zbx_strdup(NULL, row[0]);
+		key = zbx_strdup(NULL, field->name);
 
 		/* variable names cannot contain macros, and both variable names and variable values cannot contain */
 		/* another variables */
@@ -532,7 +940,6 @@ out:
 	httppairs_free(&headers);
 	httppairs_free(&query_fields);
 	httppairs_free(&post_fields);
-	zbx_db_free_result(result);
 
 	return ret;
 }
@@ -572,22 +979,23 @@ static void	add_http_headers(char *headers, struct curl_slist **headers_slist, c
 #undef ZBX_HTTPITEM_TYPE_LASTSTEP
 #undef ZBX_HTTPITEM_TYPE_LASTERROR
 
+
 /******************************************************************************
  *                                                                            *
- * Purpose: loads HTTP fields of web scenario                                 *
+ * Purpose: prepares HTTP fields of web scenario                              *
  *                                                                            *
  * Parameters: host     - [IN] host to be used in macro expansion             *
+ *             fields   - [IN] web scenario fields                            *
  *             httptest - [IN/OUT] web scenario                               *
  *                                                                            *
- * Return value: SUCCEED if HTTP fields were loaded and macro expansion was   *
+ * Return value: SUCCEED if HTTP fields were prepared and macro expansion was *
  *               successful. FAIL on error.                                   *
  *                                                                            *
  ******************************************************************************/
-static int	httptest_load_pairs(zbx_dc_host_t *host, zbx_httptest_t *httptest)
+static int	httptest_load_pairs(zbx_dc_host_t *host, const zbx_vector_httpfield_ptr_t *fields,
+		zbx_httptest_t *httptest)
 {
 	int			type, ret = SUCCEED;
-	zbx_db_result_t		result;
-	zbx_db_row_t		row;
 	size_t			alloc_len = 0, offset;
 	zbx_ptr_pair_t		pair;
 	zbx_vector_ptr_pair_t	*vector, headers;
@@ -597,17 +1005,13 @@ static int	httptest_load_pairs(zbx_dc_host_t *host, zbx_httptest_t *httptest)
 	zbx_vector_ptr_pair_create(&httptest->variables);
 
 	httptest->headers = NULL;
-	result = zbx_db_select(
-			"select name,value,type"
-			" from httptest_field"
-			" where httptestid=" ZBX_FS_UI64
-			" order by httptest_fieldid",
-			httptest->httptest.httptestid);
 
-	while (NULL != (row = zbx_db_fetch(result)))
+	for (int i = 0; i < fields->values_num; i++)
 	{
-		type = atoi(row[2]);
-		value = zbx_strdup(NULL, row[1]);
+		const zbx_httpfield_t	*field = fields->values[i];
+
+		type = field->type;
+		value = zbx_strdup(NULL, field->value);
 
 		/* from now on variable values can contain macros so proper URL encoding can be performed */
 		zbx_dc_um_handle_t	*um_handle = zbx_dc_open_user_macros_secure();
@@ -620,7 +1024,7 @@ static int	httptest_load_pairs(zbx_dc_host_t *host, zbx_httptest_t *httptest)
 			goto out;
 		}
 
-		key = zbx_strdup(NULL, row[0]);
+		key = zbx_strdup(NULL, field->name);
 
 		/* variable names cannot contain macros, and both variable names and variable values cannot contain */
 		/* another variables */
@@ -665,600 +1069,818 @@ static int	httptest_load_pairs(zbx_dc_host_t *host, zbx_httptest_t *httptest)
 	httpstep_pairs_join(&httptest->headers, &alloc_len, &offset, ":", "\r\n", &headers);
 out:
 	httppairs_free(&headers);
-	zbx_db_free_result(result);
 
 	return ret;
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: processes single scenario of HTTP test                            *
+ * Purpose: releases web scenario run, results are not reported               *
  *                                                                            *
  ******************************************************************************/
-static void	process_httptest(zbx_dc_host_t *host, zbx_httptest_t *httptest, int *delay,
-		const char *config_source_ip, const char *config_ssl_ca_location, const char *config_ssl_cert_location,
-		const char *config_ssl_key_location)
+static void	httptest_context_free(zbx_httptest_context_t *ctx)
 {
-	zbx_db_result_t		result;
-	zbx_db_httpstep		db_httpstep;
-	char			*err_str = NULL, *buffer = NULL;
-	zbx_timespec_t		ts;
-	double			speed_download = 0;
-	int			speed_download_num = 0, lastfailedstep = 0;
+	int	i;
+
 #ifdef HAVE_LIBCURL
-	zbx_db_row_t		row;
-	zbx_httpstat_t		stat;
-	char			errbuf[CURL_ERROR_SIZE];
-	CURL			*easyhandle = NULL;
-	CURLcode		err;
-	zbx_httpstep_t		httpstep;
-	zbx_http_response_t	body = {0}, header = {0};
+	curl_easy_cleanup(ctx->easyhandle);
 #endif
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s() httptestid:" ZBX_FS_UI64 " name:'%s'",
-			__func__, httptest->httptest.httptestid, httptest->httptest.name);
+	zbx_free(ctx->httptest.httptest.ssl_key_password);
+	zbx_free(ctx->httptest.httptest.ssl_key_file);
+	zbx_free(ctx->httptest.httptest.ssl_cert_file);
+	zbx_free(ctx->httptest.httptest.http_proxy);
+	zbx_free(ctx->httptest.httptest.http_password);
+	zbx_free(ctx->httptest.httptest.http_user);
+	zbx_free(ctx->httptest.httptest.agent);
+	zbx_free(ctx->httptest.headers);
+	httppairs_free(&ctx->httptest.variables);
+
+	httptest_remove_macros(&ctx->httptest);
+	zbx_vector_ptr_pair_destroy(&ctx->httptest.macros);
+
+	zbx_free(ctx->err_str);
+
+	if (0 == --ctx->def->running && 0 != ctx->def->stale)
+	{
+		httptest_def_clean(ctx->def);
+		zbx_free(ctx->def);
+	}
 
-	result = zbx_db_select(
-			"select httpstepid,no,name,url,timeout,posts,required,status_codes,post_type,follow_redirects,"
-				"retrieve_mode"
-			" from httpstep"
-			" where httptestid=" ZBX_FS_UI64
-			" order by no",
-			httptest->httptest.httptestid);
+	if (FAIL != (i = zbx_vector_ptr_search(&ctx->poller->runs, ctx, ZBX_DEFAULT_PTR_COMPARE_FUNC)))
+		zbx_vector_ptr_remove_noorder(&ctx->poller->runs, i);
 
-	buffer = zbx_strdup(buffer, httptest->httptest.delay);
-	zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &host->hostid, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
-				&buffer, ZBX_MACRO_TYPE_COMMON, NULL, 0);
+	zbx_free(ctx);
+}
 
-	/* Avoid the potential usage of uninitialized values when: */
-	/* 1) compile without libCURL support */
-	/* 2) update interval is invalid */
-	db_httpstep.name = NULL;
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reports web scenario results, schedules next check and releases   *
+ *          web scenario run                                                  *
+ *                                                                            *
+ ******************************************************************************/
+static void	httptest_finish(zbx_httptest_context_t *ctx)
+{
+	zbx_timespec_t	ts;
 
-	if (SUCCEED != zbx_is_time_suffix(buffer, delay, ZBX_LENGTH_UNLIMITED))
-	{
-		err_str = zbx_dsprintf(err_str, "update interval \"%s\" is invalid", buffer);
-		lastfailedstep = -1;
-		*delay = ZBX_DEFAULT_INTERVAL;
-		goto httptest_error;
-	}
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() httptestid:" ZBX_FS_UI64 " name:'%s'", __func__,
+			ctx->def->httptestid, ctx->def->name);
 
-#ifdef HAVE_LIBCURL
-	if (NULL == (easyhandle = curl_easy_init()))
-	{
-		err_str = zbx_strdup(err_str, "cannot initialize cURL library");
-		goto clean;
-	}
+	zbx_timespec(&ts);
 
-	if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_PROXY, httptest->httptest.http_proxy)) ||
-			CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_COOKIEFILE, "")) ||
-			CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_USERAGENT, httptest->httptest.agent)) ||
-			CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_ACCEPT_ENCODING, "")))
+	if (NULL != ctx->err_str)
 	{
-		err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-		goto clean;
-	}
+		if (0 >= ctx->lastfailedstep)
+		{
+			/* we are here because web scenario update interval is invalid, */
+			/* cURL initialization failed or we have been compiled without cURL library */
 
-	if (SUCCEED != zbx_curl_setopt_https(easyhandle, &err_str))
-		goto clean;
+			ctx->lastfailedstep = 1;
+		}
 
-	if (SUCCEED != zbx_http_prepare_ssl(easyhandle, httptest->httptest.ssl_cert_file,
-			httptest->httptest.ssl_key_file, httptest->httptest.ssl_key_password,
-			httptest->httptest.verify_peer, httptest->httptest.verify_host, config_source_ip,
-			config_ssl_ca_location, config_ssl_cert_location, config_ssl_key_location, &err_str))
-	{
-		goto clean;
+		if (NULL != ctx->db_httpstep.name)
+		{
+			zabbix_log(LOG_LEVEL_DEBUG, "cannot process step \"%s\" of web scenario \"%s\" on host \"%s\": "
+					"%s", ctx->db_httpstep.name, ctx->def->name, ctx->host.name, ctx->err_str);
+		}
 	}
 
-	httpstep.httptest = httptest;
-	httpstep.httpstep = &db_httpstep;
+	if (0 != ctx->speed_download_num)
+		ctx->speed_download /= ctx->speed_download_num;
 
-	while (NULL != (row = zbx_db_fetch(result)) && ZBX_IS_RUNNING())
-	{
-		struct curl_slist	*headers_slist = NULL;
-		char			*header_cookie = NULL;
-		zbx_curl_cb_t		curl_body_cb, curl_header_cb;
+	process_test_data(&ctx->def->items, ctx->lastfailedstep, ctx->speed_download, ctx->err_str, &ts);
+	zbx_dc_httptest_queue(ctx->now, ctx->def->httptestid, ctx->delay);
 
-		/* NOTE: do not break or return from this block! */
-		/*       process_step_data() call is required! */
+	ctx->poller->processed++;
 
-		ZBX_STR2UINT64(db_httpstep.httpstepid, row[0]);
-		db_httpstep.httptestid = httptest->httptest.httptestid;
-		db_httpstep.no = atoi(row[1]);
-		db_httpstep.name = row[2];
+	httptest_context_free(ctx);
 
-		db_httpstep.url = zbx_strdup(NULL, row[3]);
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+}
 
-		zbx_dc_um_handle_t	*um_handle = zbx_dc_open_user_macros_secure();
-		zbx_substitute_macros(&db_httpstep.url, NULL, 0, &macro_httptest_field_resolv, um_handle, host);
-		zbx_dc_close_user_macros(um_handle);
+#ifdef HAVE_LIBCURL
+static void	httpstep_clean(zbx_httptest_context_t *ctx)
+{
+	curl_slist_free_all(ctx->headers_slist);
+	ctx->headers_slist = NULL;
 
-		http_substitute_variables(httptest, &db_httpstep.url);
+	zbx_free(ctx->db_httpstep.status_codes);
+	zbx_free(ctx->db_httpstep.required);
+	zbx_free(ctx->db_httpstep.posts);
+	zbx_free(ctx->db_httpstep.url);
 
-		db_httpstep.required = zbx_strdup(NULL, row[6]);
+	httppairs_free(&ctx->httpstep.variables);
 
-		um_handle = zbx_dc_open_user_macros();
-		zbx_substitute_macros(&db_httpstep.required, NULL, 0, &macro_httptest_field_resolv, um_handle, host);
+	if (ZBX_POSTTYPE_FORM == ctx->db_httpstep.post_type)
+		zbx_free(ctx->httpstep.posts);
+
+	zbx_free(ctx->httpstep.url);
+	zbx_free(ctx->httpstep.headers);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: prepares current web scenario step and adds its request to        *
+ *          curl multi handle                                                 *
+ *                                                                            *
+ * Return value: SUCCEED - step request is in progress                        *
+ *               FAIL    - step failed, error is stored in run context        *
+ *                                                                            *
+ ******************************************************************************/
+static int	httpstep_start(zbx_httptest_context_t *ctx)
+{
+	zbx_httptest_t		*httptest = &ctx->httptest;
+	zbx_httpstep_t		*httpstep = &ctx->httpstep;
+	zbx_db_httpstep		*db_httpstep = &ctx->db_httpstep;
+	zbx_dc_host_t		*host = &ctx->host;
+	zbx_httpstep_def_t	*step = ctx->def->steps.values[ctx->step_index];
+	char			*header_cookie = NULL, *buffer;
+	zbx_curl_cb_t		curl_body_cb, curl_header_cb;
+	CURLcode		err;
+	CURLMcode		merr;
+	zbx_dc_um_handle_t	*um_handle;
+
+	db_httpstep->httpstepid = step->httpstepid;
+	db_httpstep->httptestid = ctx->def->httptestid;
+	db_httpstep->no = step->no;
+	db_httpstep->name = step->name;
+
+	db_httpstep->url = zbx_strdup(NULL, step->url);
+
+	um_handle = zbx_dc_open_user_macros_secure();
+	zbx_substitute_macros(&db_httpstep->url, NULL, 0, &macro_httptest_field_resolv, um_handle, host);
+	zbx_dc_close_user_macros(um_handle);
+
+	http_substitute_variables(httptest, &db_httpstep->url);
+
+	db_httpstep->required = zbx_strdup(NULL, step->required);
+
+	um_handle = zbx_dc_open_user_macros();
+	zbx_substitute_macros(&db_httpstep->required, NULL, 0, &macro_httptest_field_resolv, um_handle, host);
+	zbx_dc_close_user_macros(um_handle);
+
+	db_httpstep->status_codes = zbx_strdup(NULL, step->status_codes);
+	zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &host->hostid, NULL, NULL, NULL, NULL, NULL, NULL,
+			NULL, &db_httpstep->status_codes, ZBX_MACRO_TYPE_COMMON, NULL, 0);
+
+	db_httpstep->post_type = step->post_type;
+
+	if (ZBX_POSTTYPE_RAW == db_httpstep->post_type)
+	{
+		db_httpstep->posts = zbx_strdup(NULL, step->posts);
+
+		um_handle = zbx_dc_open_user_macros_secure();
+		zbx_substitute_macros(&db_httpstep->posts, NULL, 0, &macro_httptest_field_resolv, um_handle, host);
 		zbx_dc_close_user_macros(um_handle);
 
-		db_httpstep.status_codes = zbx_strdup(NULL, row[7]);
-		zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &host->hostid, NULL, NULL, NULL, NULL, NULL, NULL,
-				NULL, &db_httpstep.status_codes, ZBX_MACRO_TYPE_COMMON, NULL, 0);
+		http_substitute_variables(httptest, &db_httpstep->posts);
+	}
+	else
+		db_httpstep->posts = NULL;
 
-		db_httpstep.post_type = atoi(row[8]);
+	buffer = zbx_strdup(NULL, step->timeout);
 
-		if (ZBX_POSTTYPE_RAW == db_httpstep.post_type)
-		{
-			db_httpstep.posts = zbx_strdup(NULL, row[5]);
+	if (SUCCEED != httpstep_load_pairs(host, &step->fields, httpstep))
+	{
+		ctx->err_str = zbx_strdup(ctx->err_str, "cannot load web scenario step data");
+		goto out;
+	}
 
-			um_handle = zbx_dc_open_user_macros_secure();
-			zbx_substitute_macros(&db_httpstep.posts, NULL, 0, &macro_httptest_field_resolv, um_handle,
-					host);
-			zbx_dc_close_user_macros(um_handle);
+	zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &host->hostid, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+			&buffer, ZBX_MACRO_TYPE_COMMON, NULL, 0);
 
-			http_substitute_variables(httptest, &db_httpstep.posts);
-		}
-		else
-			db_httpstep.posts = NULL;
+	if (SUCCEED != zbx_is_time_suffix(buffer, &db_httpstep->timeout, ZBX_LENGTH_UNLIMITED))
+	{
+		ctx->err_str = zbx_dsprintf(ctx->err_str, "timeout \"%s\" is invalid", buffer);
+		goto out;
+	}
+	else if (db_httpstep->timeout < 1 || SEC_PER_HOUR < db_httpstep->timeout)
+	{
+		ctx->err_str = zbx_dsprintf(ctx->err_str, "timeout \"%s\" is out of 1-3600 seconds bounds", buffer);
+		goto out;
+	}
 
-		if (SUCCEED != httpstep_load_pairs(host, &httpstep))
-		{
-			err_str = zbx_strdup(err_str, "cannot load web scenario step data");
-			goto httpstep_error;
-		}
+	db_httpstep->follow_redirects = step->follow_redirects;
+	db_httpstep->retrieve_mode = step->retrieve_mode;
 
-		buffer = zbx_strdup(buffer, row[4]);
-		zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &host->hostid, NULL, NULL, NULL, NULL, NULL, NULL,
-				NULL, &buffer, ZBX_MACRO_TYPE_COMMON, NULL, 0);
+	zabbix_log(LOG_LEVEL_DEBUG, "%s() use step \"%s\"", __func__, db_httpstep->name);
+	zabbix_log(LOG_LEVEL_DEBUG, "%s() use post \"%s\"", __func__, ZBX_NULL2EMPTY_STR(httpstep->posts));
 
-		if (SUCCEED != zbx_is_time_suffix(buffer, &db_httpstep.timeout, ZBX_LENGTH_UNLIMITED))
-		{
-			err_str = zbx_dsprintf(err_str, "timeout \"%s\" is invalid", buffer);
-			goto httpstep_error;
-		}
-		else if (db_httpstep.timeout < 1 || SEC_PER_HOUR < db_httpstep.timeout)
+	if (CURLE_OK != (err = curl_easy_setopt(ctx->easyhandle, CURLOPT_POSTFIELDS, httpstep->posts)))
+	{
+		ctx->err_str = zbx_strdup(ctx->err_str, curl_easy_strerror(err));
+		goto out;
+	}
+
+	if (CURLE_OK != (err = curl_easy_setopt(ctx->easyhandle, CURLOPT_POST, (NULL != httpstep->posts &&
+			'\0' != *httpstep->posts) ? 1L : 0L)))
+	{
+		ctx->err_str = zbx_strdup(ctx->err_str, curl_easy_strerror(err));
+		goto out;
+	}
+
+	if (CURLE_OK != (err = curl_easy_setopt(ctx->easyhandle, CURLOPT_FOLLOWLOCATION,
+			0 == db_httpstep->follow_redirects ? 0L : 1L)))
+	{
+		ctx->err_str = zbx_strdup(ctx->err_str, curl_easy_strerror(err));
+		goto out;
+	}
+
+	if (0 != db_httpstep->follow_redirects)
+	{
+		if (CURLE_OK != (err = curl_easy_setopt(ctx->easyhandle, CURLOPT_MAXREDIRS, ZBX_CURLOPT_MAXREDIRS)))
 		{
-			err_str = zbx_dsprintf(err_str, "timeout \"%s\" is out of 1-3600 seconds bounds", buffer);
-			goto httpstep_error;
+			ctx->err_str = zbx_strdup(ctx->err_str, curl_easy_strerror(err));
+			goto out;
 		}
+	}
 
-		db_httpstep.follow_redirects = atoi(row[9]);
-		db_httpstep.retrieve_mode = atoi(row[10]);
+	/* headers defined in a step overwrite headers defined in scenario */
+	if (NULL != httpstep->headers && '\0' != *httpstep->headers)
+		add_http_headers(httpstep->headers, &ctx->headers_slist, &header_cookie);
+	else if (NULL != httptest->headers && '\0' != *httptest->headers)
+		add_http_headers(httptest->headers, &ctx->headers_slist, &header_cookie);
 
-		memset(&stat, 0, sizeof(stat));
+	err = curl_easy_setopt(ctx->easyhandle, CURLOPT_COOKIE, header_cookie);
+	zbx_free(header_cookie);
 
-		zabbix_log(LOG_LEVEL_DEBUG, "%s() use step \"%s\"", __func__, db_httpstep.name);
-		zabbix_log(LOG_LEVEL_DEBUG, "%s() use post \"%s\"", __func__, ZBX_NULL2EMPTY_STR(httpstep.posts));
+	if (CURLE_OK != err)
+	{
+		ctx->err_str = zbx_strdup(ctx->err_str, curl_easy_strerror(err));
+		goto out;
+	}
+
+	if (CURLE_OK != (err = curl_easy_setopt(ctx->easyhandle, CURLOPT_HTTPHEADER, ctx->headers_slist)))
+	{
+		ctx->err_str = zbx_strdup(ctx->err_str, curl_easy_strerror(err));
+		goto out;
+	}
 
-		if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_POSTFIELDS, httpstep.posts)))
+	switch (db_httpstep->retrieve_mode)
+	{
+		case ZBX_RETRIEVE_MODE_CONTENT:
+			curl_header_cb = zbx_curl_ignore_cb;
+			curl_body_cb = zbx_curl_write_cb;
+			break;
+		case ZBX_RETRIEVE_MODE_BOTH:
+			curl_header_cb = curl_body_cb = zbx_curl_write_cb;
+			break;
+		case ZBX_RETRIEVE_MODE_HEADERS:
+			curl_header_cb = zbx_curl_write_cb;
+			curl_body_cb = zbx_curl_ignore_cb;
+			break;
+		default:
+			THIS_SHOULD_NEVER_HAPPEN;
+			ctx->err_str = zbx_strdup(ctx->err_str, "invalid retrieve mode");
+			goto out;
+	}
+
+	if (SUCCEED != zbx_http_prepare_callbacks(ctx->easyhandle, &ctx->header, &ctx->body, curl_header_cb,
+			curl_body_cb, ctx->errbuf, &ctx->err_str))
+	{
+		goto out;
+	}
+
+	/* enable/disable fetching the body */
+	if (CURLE_OK != (err = curl_easy_setopt(ctx->easyhandle, CURLOPT_NOBODY,
+			ZBX_RETRIEVE_MODE_HEADERS == db_httpstep->retrieve_mode ? 1L : 0L)))
+	{
+		ctx->err_str = zbx_strdup(ctx->err_str, curl_easy_strerror(err));
+		goto out;
+	}
+
+	if (SUCCEED != zbx_http_prepare_auth(ctx->easyhandle, httptest->httptest.authentication,
+			httptest->httptest.http_user, httptest->httptest.http_password, NULL, &ctx->err_str))
+	{
+		goto out;
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "%s() go to URL \"%s\"", __func__, httpstep->url);
+
+	if (CURLE_OK != (err = curl_easy_setopt(ctx->easyhandle, CURLOPT_TIMEOUT, (long)db_httpstep->timeout)) ||
+			CURLE_OK != (err = curl_easy_setopt(ctx->easyhandle, CURLOPT_URL, httpstep->url)))
+	{
+		ctx->err_str = zbx_strdup(ctx->err_str, curl_easy_strerror(err));
+		goto out;
+	}
+
+	memset(&ctx->header, 0, sizeof(ctx->header));
+	memset(&ctx->body, 0, sizeof(ctx->body));
+	ctx->errbuf[0] = '\0';
+
+	if (CURLM_OK != (merr = curl_multi_add_handle(ctx->poller->asynchttppoller_config->curl_handle,
+			ctx->easyhandle)))
+	{
+		ctx->err_str = zbx_dsprintf(ctx->err_str, "cannot add a standard curl handle to the multi stack: %s",
+				curl_multi_strerror(merr));
+	}
+out:
+	zbx_free(buffer);
+
+	if (NULL != ctx->err_str)
+	{
+		httpstep_clean(ctx);
+		ctx->lastfailedstep = db_httpstep->no;
+
+		return FAIL;
+	}
+
+	return SUCCEED;
+}
+#endif
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: starts next web scenario step or finishes web scenario run when   *
+ *          there are no more steps                                           *
+ *                                                                            *
+ ******************************************************************************/
+static void	httptest_next_step(zbx_httptest_context_t *ctx)
+{
+#ifdef HAVE_LIBCURL
+	if (ctx->step_index < ctx->def->steps.values_num && ZBX_IS_RUNNING() && SUCCEED == httpstep_start(ctx))
+		return;
+#endif
+	httptest_finish(ctx);
+}
+
+#ifdef HAVE_LIBCURL
+/******************************************************************************
+ *                                                                            *
+ * Purpose: processes completed web scenario step request                     *
+ *                                                                            *
+ * Parameters: easy_handle - [IN] completed request                           *
+ *             err         - [IN] request result                              *
+ *             arg         - [IN] HTTP poller                                 *
+ *                                                                            *
+ * Comments: Failed requests are retried until the number of web scenario     *
+ *           retries is exhausted. The retries are shared by all steps.       *
+ *                                                                            *
+ ******************************************************************************/
+static void	httptest_process_result(CURL *easy_handle, CURLcode err, void *arg)
+{
+	zbx_httptest_poller_t	*poller = (zbx_httptest_poller_t *)arg;
+	zbx_httptest_context_t	*ctx;
+	zbx_httptest_t		*httptest;
+	zbx_httpstep_t		*httpstep;
+	zbx_db_httpstep		*db_httpstep;
+	zbx_httpstat_t		stat;
+	zbx_timespec_t		ts;
+	CURLcode		err_info;
+	CURLMcode		merr;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	if (CURLE_OK != (err_info = curl_easy_getinfo(easy_handle, CURLINFO_PRIVATE, &ctx)))
+	{
+		THIS_SHOULD_NEVER_HAPPEN;
+		zabbix_log(LOG_LEVEL_CRIT, "Cannot get pointer to private data: %s", curl_easy_strerror(err_info));
+
+		goto out;
+	}
+
+	curl_multi_remove_handle(poller->asynchttppoller_config->curl_handle, easy_handle);
+
+	httptest = &ctx->httptest;
+	httpstep = &ctx->httpstep;
+	db_httpstep = &ctx->db_httpstep;
+
+	if (CURLE_OK != err)
+	{
+		zbx_free(ctx->body.data);
+		zbx_free(ctx->header.data);
+
+		/* try to retrieve page several times depending on number of retries */
+		if (0 < --httptest->httptest.retries && ZBX_IS_RUNNING())
 		{
-			err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			goto httpstep_error;
-		}
+			memset(&ctx->header, 0, sizeof(ctx->header));
+			memset(&ctx->body, 0, sizeof(ctx->body));
+			ctx->errbuf[0] = '\0';
 
-		if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_POST, (NULL != httpstep.posts &&
-				'\0' != *httpstep.posts) ? 1L : 0L)))
+			if (CURLM_OK == (merr = curl_multi_add_handle(poller->asynchttppoller_config->curl_handle,
+					easy_handle)))
+			{
+				goto out;
+			}
+
+			ctx->err_str = zbx_dsprintf(ctx->err_str, "cannot add a standard curl handle to the multi"
+					" stack: %s", curl_multi_strerror(merr));
+		}
+		else
 		{
-			err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			goto httpstep_error;
+			ctx->err_str = zbx_dsprintf(ctx->err_str, "%s", 0 < strlen(ctx->errbuf) ? ctx->errbuf :
+					curl_easy_strerror(err));
 		}
+	}
+	else
+	{
+		char	*var_err_str = NULL, *data = NULL;
 
-		if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_FOLLOWLOCATION,
-				0 == db_httpstep.follow_redirects ? 0L : 1L)))
+		memset(&stat, 0, sizeof(stat));
+
+		if (NULL != ctx->body.data)
 		{
-			err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			goto httpstep_error;
+			zbx_http_convert_to_utf8(easy_handle, &ctx->body.data, &ctx->body.offset, &ctx->body.allocated);
+			data = ctx->body.data;
 		}
 
-		if (0 != db_httpstep.follow_redirects)
+		if (NULL != ctx->header.data)
 		{
-			if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_MAXREDIRS, ZBX_CURLOPT_MAXREDIRS)))
+			if (NULL != ctx->body.data)
 			{
-				err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-				goto httpstep_error;
+				zbx_strncpy_alloc(&ctx->header.data, &ctx->header.allocated, &ctx->header.offset,
+						ctx->body.data, ctx->body.offset);
 			}
+
+			data = ctx->header.data;
 		}
 
-		/* headers defined in a step overwrite headers defined in scenario */
-		if (NULL != httpstep.headers && '\0' != *httpstep.headers)
-			add_http_headers(httpstep.headers, &headers_slist, &header_cookie);
-		else if (NULL != httptest->headers && '\0' != *httptest->headers)
-			add_http_headers(httptest->headers, &headers_slist, &header_cookie);
+		if (NULL == data)
+			data = "";
 
-		err = curl_easy_setopt(easyhandle, CURLOPT_COOKIE, header_cookie);
-		zbx_free(header_cookie);
+		zabbix_log(LOG_LEVEL_TRACE, "%s() page.data from %s:'%s'", __func__, httpstep->url, data);
 
-		if (CURLE_OK != err)
+		/* first get the data that is needed even if step fails */
+		if (CURLE_OK != (err = curl_easy_getinfo(easy_handle, CURLINFO_RESPONSE_CODE, &stat.rspcode)))
 		{
-			err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			goto httpstep_error;
+			ctx->err_str = zbx_strdup(ctx->err_str, curl_easy_strerror(err));
 		}
-
-		if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_HTTPHEADER, headers_slist)))
+		else if ('\0' != *db_httpstep->status_codes &&
+				FAIL == zbx_int_in_list(db_httpstep->status_codes, stat.rspcode))
 		{
-			err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			goto httpstep_error;
+			ctx->err_str = zbx_dsprintf(ctx->err_str, "response code \"%ld\" did not match any of the"
+					" required status codes \"%s\"", stat.rspcode, db_httpstep->status_codes);
 		}
 
-		switch (db_httpstep.retrieve_mode)
+		if (CURLE_OK != (err = curl_easy_getinfo(easy_handle, CURLINFO_TOTAL_TIME, &stat.total_time)) &&
+				NULL == ctx->err_str)
 		{
-			case ZBX_RETRIEVE_MODE_CONTENT:
-				curl_header_cb = zbx_curl_ignore_cb;
-				curl_body_cb = zbx_curl_write_cb;
-				break;
-			case ZBX_RETRIEVE_MODE_BOTH:
-				curl_header_cb = curl_body_cb = zbx_curl_write_cb;
-				break;
-			case ZBX_RETRIEVE_MODE_HEADERS:
-				curl_header_cb = zbx_curl_write_cb;
-				curl_body_cb = zbx_curl_ignore_cb;
-				break;
-			default:
-				THIS_SHOULD_NEVER_HAPPEN;
-				err_str = zbx_strdup(err_str, "invalid retrieve mode");
-				goto httpstep_error;
+			ctx->err_str = zbx_strdup(ctx->err_str, curl_easy_strerror(err));
 		}
 
-		if (SUCCEED != zbx_http_prepare_callbacks(easyhandle, &header, &body, curl_header_cb, curl_body_cb,
-				errbuf, &err_str))
+		if (CURLE_OK != (err = curl_easy_getinfo(easy_handle, CURLINFO_SPEED_DOWNLOAD_T,
+				&stat.speed_download)) && NULL == ctx->err_str)
 		{
-			goto httpstep_error;
+			ctx->err_str = zbx_strdup(ctx->err_str, curl_easy_strerror(err));
 		}
-
-		/* enable/disable fetching the body */
-		if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_NOBODY,
-				ZBX_RETRIEVE_MODE_HEADERS == db_httpstep.retrieve_mode ? 1L : 0L)))
+		else
 		{
-			err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			goto httpstep_error;
+			ctx->speed_download += (double)stat.speed_download;
+			ctx->speed_download_num++;
 		}
 
-		if (SUCCEED != zbx_http_prepare_auth(easyhandle, httptest->httptest.authentication,
-				httptest->httptest.http_user, httptest->httptest.http_password, NULL, &err_str))
+		/* required pattern */
+		if (NULL == ctx->err_str && '\0' != *db_httpstep->required &&
+				NULL == zbx_regexp_match(data, db_httpstep->required, NULL))
 		{
-			goto httpstep_error;
+			ctx->err_str = zbx_dsprintf(ctx->err_str, "required pattern \"%s\" was not found on %s",
+					db_httpstep->required, httpstep->url);
 		}
 
-		zabbix_log(LOG_LEVEL_DEBUG, "%s() go to URL \"%s\"", __func__, httpstep.url);
-
-		if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_TIMEOUT, (long)db_httpstep.timeout)) ||
-				CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_URL, httpstep.url)))
+		/* variables defined in scenario */
+		if (NULL == ctx->err_str && FAIL == http_process_variables(httptest, &httptest->variables, data,
+				&var_err_str))
 		{
-			err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			goto httpstep_error;
+			char	*variables = NULL;
+			size_t	alloc_len = 0, offset;
+
+			httpstep_pairs_join(&variables, &alloc_len, &offset, "=", " ", &httptest->variables);
+
+			ctx->err_str = zbx_dsprintf(ctx->err_str, "error in scenario variables \"%s\": %s", variables,
+					var_err_str);
+
+			zbx_free(variables);
 		}
 
-		/* try to retrieve page several times depending on number of retries */
-		do
+		/* variables defined in a step */
+		if (NULL == ctx->err_str && FAIL == http_process_variables(httptest, &httpstep->variables, data,
+				&var_err_str))
 		{
-			memset(&header, 0, sizeof(header));
-			memset(&body, 0, sizeof(body));
-			errbuf[0] = '\0';
+			char	*variables = NULL;
+			size_t	alloc_len = 0, offset;
 
-			if (CURLE_OK == (err = curl_easy_perform(easyhandle)))
-				break;
+			httpstep_pairs_join(&variables, &alloc_len, &offset, "=", " ", &httpstep->variables);
 
-			zbx_free(body.data);
-			zbx_free(header.data);
+			ctx->err_str = zbx_dsprintf(ctx->err_str, "error in step variables \"%s\": %s", variables,
+					var_err_str);
+
+			zbx_free(variables);
 		}
-		while (0 < --httptest->httptest.retries);
 
-		if (CURLE_OK == err)
-		{
-			char	*var_err_str = NULL, *data = NULL;
+		zbx_free(var_err_str);
 
-			if (NULL != body.data)
-			{
-				zbx_http_convert_to_utf8(easyhandle, &body.data, &body.offset, &body.allocated);
-				data = body.data;
-			}
+		zbx_timespec(&ts);
+		process_step_data(&ctx->def->steps.values[ctx->step_index]->items, &stat, &ts);
 
-			if (NULL != header.data)
-			{
-				if (NULL != body.data)
-				{
-					zbx_strncpy_alloc(&header.data, &header.allocated, &header.offset, body.data,
-							body.offset);
-				}
+		zbx_free(ctx->header.data);
+		zbx_free(ctx->body.data);
+	}
 
-				data = header.data;
-			}
+	httpstep_clean(ctx);
 
-			if (NULL == data)
-				data = "";
+	if (NULL != ctx->err_str)
+	{
+		ctx->lastfailedstep = db_httpstep->no;
+		httptest_finish(ctx);
+	}
+	else
+	{
+		ctx->step_index++;
+		httptest_next_step(ctx);
+	}
+out:
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+}
+#endif
 
-			zabbix_log(LOG_LEVEL_TRACE, "%s() page.data from %s:'%s'", __func__, httpstep.url, data);
+/******************************************************************************
+ *                                                                            *
+ * Purpose: starts web scenario run                                           *
+ *                                                                            *
+ * Parameters: poller - [IN]                                                  *
+ *             def    - [IN] web scenario definition                          *
+ *             host   - [IN] web scenario host                                *
+ *             now    - [IN] current timestamp                                *
+ *                                                                            *
+ * Return value: SUCCEED - web scenario was started or finished with error    *
+ *               FAIL    - web scenario data could not be prepared            *
+ *                                                                            *
+ ******************************************************************************/
+static int	httptest_start(zbx_httptest_poller_t *poller, zbx_httptest_def_t *def, const zbx_dc_host_t *host,
+		int now)
+{
+	zbx_httptest_context_t	*ctx;
+	zbx_db_httptest		*httptest;
+	zbx_dc_um_handle_t	*um_handle;
+	char			*buffer;
+#ifdef HAVE_LIBCURL
+	CURLcode		err;
+#endif
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() httptestid:" ZBX_FS_UI64 " name:'%s'", __func__, def->httptestid,
+			def->name);
 
-			/* first get the data that is needed even if step fails */
-			if (CURLE_OK != (err = curl_easy_getinfo(easyhandle, CURLINFO_RESPONSE_CODE, &stat.rspcode)))
-			{
-				err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			}
-			else if ('\0' != *db_httpstep.status_codes &&
-					FAIL == zbx_int_in_list(db_httpstep.status_codes, stat.rspcode))
-			{
-				err_str = zbx_dsprintf(err_str, "response code \"%ld\" did not match any of the"
-						" required status codes \"%s\"", stat.rspcode,
-						db_httpstep.status_codes);
-			}
+	ctx = (zbx_httptest_context_t *)zbx_malloc(NULL, sizeof(zbx_httptest_context_t));
+	memset(ctx, 0, sizeof(zbx_httptest_context_t));
 
-			if (CURLE_OK != (err = curl_easy_getinfo(easyhandle, CURLINFO_TOTAL_TIME, &stat.total_time)) &&
-					NULL == err_str)
-			{
-				err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			}
+	ctx->poller = poller;
+	ctx->def = def;
+	ctx->host = *host;
+	ctx->now = now;
 
-			if (CURLE_OK != (err = curl_easy_getinfo(easyhandle, CURLINFO_SPEED_DOWNLOAD_T,
-					&stat.speed_download)) && NULL == err_str)
-			{
-				err_str = zbx_strdup(err_str, curl_easy_strerror(err));
-			}
-			else
-			{
-				speed_download += (double)stat.speed_download;
-				speed_download_num++;
-			}
+	def->running++;
+	zbx_vector_ptr_append(&poller->runs, ctx);
 
-			/* required pattern */
-			if (NULL == err_str && '\0' != *db_httpstep.required &&
-					NULL == zbx_regexp_match(data, db_httpstep.required, NULL))
-			{
-				err_str = zbx_dsprintf(err_str, "required pattern \"%s\" was not found on %s",
-						db_httpstep.required, httpstep.url);
-			}
+	/* create macro cache to use in HTTP test */
+	zbx_vector_ptr_pair_create(&ctx->httptest.macros);
 
-			/* variables defined in scenario */
-			if (NULL == err_str && FAIL == http_process_variables(httptest, &httptest->variables,
-					data, &var_err_str))
-			{
-				char	*variables = NULL;
-				size_t	alloc_len = 0, offset;
+	httptest = &ctx->httptest.httptest;
+	httptest->httptestid = def->httptestid;
+	httptest->name = def->name;
 
-				httpstep_pairs_join(&variables, &alloc_len, &offset, "=", " ", &httptest->variables);
+	if (SUCCEED != httptest_load_pairs(&ctx->host, &def->fields, &ctx->httptest))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot process web scenario \"%s\" on host \"%s\": "
+				"cannot load web scenario data", def->name, ctx->host.name);
+		THIS_SHOULD_NEVER_HAPPEN;
+		httptest_context_free(ctx);
 
-				err_str = zbx_dsprintf(err_str, "error in scenario variables \"%s\": %s", variables,
-						var_err_str);
+		return FAIL;
+	}
 
-				zbx_free(variables);
-			}
+	httptest->agent = zbx_strdup(NULL, def->agent);
+	zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &ctx->host.hostid, NULL, NULL, NULL, NULL, NULL, NULL,
+			NULL, &httptest->agent, ZBX_MACRO_TYPE_COMMON, NULL, 0);
 
-			/* variables defined in a step */
-			if (NULL == err_str && FAIL == http_process_variables(httptest, &httpstep.variables, data,
-					&var_err_str))
-			{
-				char	*variables = NULL;
-				size_t	alloc_len = 0, offset;
+	if (HTTPTEST_AUTH_NONE != (httptest->authentication = def->authentication))
+	{
+		httptest->http_user = zbx_strdup(NULL, def->http_user);
+		zbx_substitute_simple_macros_unmasked(NULL, NULL, NULL, NULL, &ctx->host.hostid, NULL, NULL, NULL,
+				NULL, NULL, NULL, NULL, &httptest->http_user, ZBX_MACRO_TYPE_COMMON, NULL, 0);
 
-				httpstep_pairs_join(&variables, &alloc_len, &offset, "=", " ", &httpstep.variables);
+		httptest->http_password = zbx_strdup(NULL, def->http_password);
+		zbx_substitute_simple_macros_unmasked(NULL, NULL, NULL, NULL, &ctx->host.hostid, NULL, NULL, NULL,
+				NULL, NULL, NULL, NULL, &httptest->http_password, ZBX_MACRO_TYPE_COMMON, NULL, 0);
+	}
 
-				err_str = zbx_dsprintf(err_str, "error in step variables \"%s\": %s", variables,
-						var_err_str);
+	if ('\0' != *def->http_proxy)
+	{
+		httptest->http_proxy = zbx_strdup(NULL, def->http_proxy);
+		zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &ctx->host.hostid, NULL, NULL, NULL, NULL, NULL,
+				NULL, NULL, &httptest->http_proxy, ZBX_MACRO_TYPE_COMMON, NULL, 0);
+	}
 
-				zbx_free(variables);
-			}
+	httptest->retries = def->retries;
 
-			zbx_free(var_err_str);
+	httptest->ssl_cert_file = zbx_strdup(NULL, def->ssl_cert_file);
+	httptest->ssl_key_file = zbx_strdup(NULL, def->ssl_key_file);
 
-			zbx_timespec(&ts);
-			process_step_data(db_httpstep.httpstepid, &stat, &ts);
+	um_handle = zbx_dc_open_user_macros();
+	zbx_substitute_macros(&httptest->ssl_cert_file, NULL, 0, &macro_httptest_field_resolv, um_handle, &ctx->host);
+	zbx_substitute_macros(&httptest->ssl_key_file, NULL, 0, &macro_httptest_field_resolv, um_handle, &ctx->host);
+	zbx_dc_close_user_macros(um_handle);
 
-			zbx_free(header.data);
-			zbx_free(body.data);
-		}
-		else
-			err_str = zbx_dsprintf(err_str, "%s", 0 < strlen(errbuf) ? errbuf : curl_easy_strerror(err));
-httpstep_error:
-		curl_slist_free_all(headers_slist);
-		zbx_free(db_httpstep.status_codes);
-		zbx_free(db_httpstep.required);
-		zbx_free(db_httpstep.posts);
-		zbx_free(db_httpstep.url);
+	httptest->ssl_key_password = zbx_strdup(NULL, def->ssl_key_password);
+	zbx_substitute_simple_macros_unmasked(NULL, NULL, NULL, NULL, &ctx->host.hostid, NULL, NULL, NULL, NULL, NULL,
+			NULL, NULL, &httptest->ssl_key_password, ZBX_MACRO_TYPE_COMMON, NULL, 0);
 
-		httppairs_free(&httpstep.variables);
+	httptest->verify_peer = def->verify_peer;
+	httptest->verify_host = def->verify_host;
+	httptest->delay = def->delay;
 
-		if (ZBX_POSTTYPE_FORM == httpstep.httpstep->post_type)
-			zbx_free(httpstep.posts);
+	/* add httptest variables to the current test macro cache */
+	http_process_variables(&ctx->httptest, &ctx->httptest.variables, NULL, NULL);
 
-		zbx_free(httpstep.url);
-		zbx_free(httpstep.headers);
+	buffer = zbx_strdup(NULL, def->delay);
+	zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &ctx->host.hostid, NULL, NULL, NULL, NULL, NULL, NULL,
+			NULL, &buffer, ZBX_MACRO_TYPE_COMMON, NULL, 0);
 
-		if (NULL != err_str)
-		{
-			lastfailedstep = db_httpstep.no;
-			break;
-		}
+	if (SUCCEED != zbx_is_time_suffix(buffer, &ctx->delay, ZBX_LENGTH_UNLIMITED))
+	{
+		ctx->err_str = zbx_dsprintf(ctx->err_str, "update interval \"%s\" is invalid", buffer);
+		ctx->lastfailedstep = -1;
+		ctx->delay = ZBX_DEFAULT_INTERVAL;
+		zbx_free(buffer);
+		goto out;
 	}
-clean:
-	curl_easy_cleanup(easyhandle);
-#else
-	ZBX_UNUSED(config_source_ip);
-	ZBX_UNUSED(config_ssl_ca_location);
-	ZBX_UNUSED(config_ssl_cert_location);
-	ZBX_UNUSED(config_ssl_key_location);
 
-	err_str = zbx_strdup(err_str, "cURL library is required for Web monitoring support");
-#endif	/* HAVE_LIBCURL */
+	zbx_free(buffer);
 
-httptest_error:
-	zbx_timespec(&ts);
+#ifdef HAVE_LIBCURL
+	if (NULL == (ctx->easyhandle = curl_easy_init()))
+	{
+		ctx->err_str = zbx_strdup(ctx->err_str, "cannot initialize cURL library");
+		goto out;
+	}
 
-	if (NULL != err_str)
+	if (CURLE_OK != (err = curl_easy_setopt(ctx->easyhandle, CURLOPT_PROXY, httptest->http_proxy)) ||
+			CURLE_OK != (err = curl_easy_setopt(ctx->easyhandle, CURLOPT_COOKIEFILE, "")) ||
+			CURLE_OK != (err = curl_easy_setopt(ctx->easyhandle, CURLOPT_USERAGENT, httptest->agent)) ||
+			CURLE_OK != (err = curl_easy_setopt(ctx->easyhandle, CURLOPT_ACCEPT_ENCODING, "")) ||
+			CURLE_OK != (err = curl_easy_setopt(ctx->easyhandle, CURLOPT_PRIVATE, ctx)))
 	{
-		if (0 >= lastfailedstep)
-		{
-			/* we are here because web scenario update interval is invalid, */
-			/* cURL initialization failed or we have been compiled without cURL library */
+		ctx->err_str = zbx_strdup(ctx->err_str, curl_easy_strerror(err));
+		goto out;
+	}
 
-			lastfailedstep = 1;
-		}
+	if (SUCCEED != zbx_curl_setopt_https(ctx->easyhandle, &ctx->err_str))
+		goto out;
 
-		if (NULL != db_httpstep.name)
-		{
-			zabbix_log(LOG_LEVEL_DEBUG, "cannot process step \"%s\" of web scenario \"%s\" on host \"%s\": "
-					"%s", db_httpstep.name, httptest->httptest.name, host->name, err_str);
-		}
+	if (SUCCEED != zbx_http_prepare_ssl(ctx->easyhandle, httptest->ssl_cert_file, httptest->ssl_key_file,
+			httptest->ssl_key_password, httptest->verify_peer, httptest->verify_host,
+			poller->args->config_source_ip, poller->args->config_ssl_ca_location,
+			poller->args->config_ssl_cert_location, poller->args->config_ssl_key_location, &ctx->err_str))
+	{
+		goto out;
 	}
-	zbx_db_free_result(result);
 
-	if (0 != speed_download_num)
-		speed_download /= speed_download_num;
+	ctx->httpstep.httptest = &ctx->httptest;
+	ctx->httpstep.httpstep = &ctx->db_httpstep;
+#else
+	ctx->err_str = zbx_strdup(ctx->err_str, "cURL library is required for Web monitoring support");
+#endif	/* HAVE_LIBCURL */
+out:
+	if (NULL != ctx->err_str)
+		httptest_finish(ctx);
+	else
+		httptest_next_step(ctx);
 
-	process_test_data(httptest->httptest.httptestid, lastfailedstep, speed_download, err_str, &ts);
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 
-	zbx_free(buffer);
-	zbx_free(err_str);
-	zbx_preprocessor_flush();
+	return SUCCEED;
+}
 
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+#ifdef HAVE_LIBCURL
+static void	httptest_poller_update_selfmon_counter(void *arg)
+{
+	zbx_httptest_poller_t	*poller = (zbx_httptest_poller_t *)arg;
+
+	if (ZBX_PROCESS_STATE_IDLE == poller->state)
+	{
+		zbx_update_selfmon_counter(poller->info, ZBX_PROCESS_STATE_BUSY);
+		poller->state = ZBX_PROCESS_STATE_BUSY;
+	}
 }
+#endif
 
 /******************************************************************************
  *                                                                            *
- * Parameters: now                      - [IN] current timestamp              *
- *             config_source_ip         - [IN]                                *
- *             config_ssl_ca_location   - [IN]                                *
- *             config_ssl_cert_location - [IN]                                *
- *             config_ssl_key_location  - [IN]                                *
- *             nextcheck                - [OUT]                               *
+ * Purpose: starts web scenarios scheduled for processing                     *
+ *                                                                            *
+ * Parameters: poller    - [IN]                                               *
+ *             now       - [IN] current timestamp                             *
+ *             nextcheck - [OUT]                                              *
  *                                                                            *
- * Return value: number of processed httptests                                *
+ * Return value: number of started web scenarios                              *
  *                                                                            *
- * Comments: always SUCCEED                                                   *
+ * Comments: Web scenarios are started until the number of web scenarios in   *
+ *           progress reaches MaxConcurrentChecksPerPoller.                   *
  *                                                                            *
  ******************************************************************************/
-int	process_httptests(int now, const char *config_source_ip, const char *config_ssl_ca_location,
-		const char *config_ssl_cert_location, const char *config_ssl_key_location, time_t *nextcheck)
+int	process_httptests(zbx_httptest_poller_t *poller, int now, time_t *nextcheck)
 {
-	zbx_db_result_t		result;
-	zbx_db_row_t		row;
-	zbx_uint64_t		httptestid;
-	zbx_httptest_t		httptest;
-	zbx_dc_host_t		host;
-	int			httptests_count = 0;
-	zbx_dc_um_handle_t	*um_handle;
+	zbx_uint64_t	httptestid, revision;
+	int		httptests_count = 0;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	if (SUCCEED != zbx_dc_httptest_next(now, &httptestid, nextcheck))
-		goto out;
-
-	/* create macro cache to use in HTTP tests */
-	zbx_vector_ptr_pair_create(&httptest.macros);
-
-	do
+	while (ZBX_IS_RUNNING() && poller->runs.values_num < poller->args->config_max_concurrent_checks_per_poller &&
+			SUCCEED == zbx_dc_httptest_next(now, &httptestid, &revision, nextcheck))
 	{
-		int	delay = 0;
-
-		result = zbx_db_select(
-				"select h.hostid,h.host,h.name,t.httptestid,t.name,t.agent,"
-					"t.authentication,t.http_user,t.http_password,t.http_proxy,t.retries,"
-					"t.ssl_cert_file,t.ssl_key_file,t.ssl_key_password,t.verify_peer,"
-					"t.verify_host,t.delay"
-				" from httptest t,hosts h"
-				" where t.hostid=h.hostid"
-					" and t.httptestid=" ZBX_FS_UI64,
-				httptestid);
+		zbx_httptest_def_t	*def;
+		zbx_dc_host_t		host;
 
-		if (NULL != (row = zbx_db_fetch(result)))
-		{
-			ZBX_STR2UINT64(host.hostid, row[0]);
-			zbx_strscpy(host.host, row[1]);
-			zbx_strlcpy_utf8(host.name, row[2], sizeof(host.name));
-
-			ZBX_STR2UINT64(httptest.httptest.httptestid, row[3]);
-			httptest.httptest.name = row[4];
-
-			if (SUCCEED != httptest_load_pairs(&host, &httptest))
-			{
-				zabbix_log(LOG_LEVEL_WARNING, "cannot process web scenario \"%s\" on host \"%s\": "
-						"cannot load web scenario data", httptest.httptest.name, host.name);
-				zbx_db_free_result(result);
-				THIS_SHOULD_NEVER_HAPPEN;
-				continue;
-			}
+		if (NULL == (def = httptest_def_get(poller, httptestid, revision, now)))
+			continue;
 
-			httptest.httptest.agent = zbx_strdup(NULL, row[5]);
-			zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &host.hostid, NULL, NULL, NULL, NULL, NULL,
-					NULL, NULL, &httptest.httptest.agent, ZBX_MACRO_TYPE_COMMON, NULL, 0);
+		if (SUCCEED != zbx_dc_get_host_by_hostid(&host, def->hostid))
+			continue;
 
-			if (HTTPTEST_AUTH_NONE != (httptest.httptest.authentication = atoi(row[6])))
-			{
-				httptest.httptest.http_user = zbx_strdup(NULL, row[7]);
-				zbx_substitute_simple_macros_unmasked(NULL, NULL, NULL, NULL, &host.hostid, NULL, NULL,
-						NULL, NULL, NULL, NULL, NULL, &httptest.httptest.http_user,
-						ZBX_MACRO_TYPE_COMMON, NULL, 0);
-
-				httptest.httptest.http_password = zbx_strdup(NULL, row[8]);
-				zbx_substitute_simple_macros_unmasked(NULL, NULL, NULL, NULL, &host.hostid, NULL, NULL,
-						NULL, NULL, NULL, NULL, NULL, &httptest.httptest.http_password,
-						ZBX_MACRO_TYPE_COMMON, NULL, 0);
-			}
+		if (SUCCEED == httptest_start(poller, def, &host, now))
+			httptests_count++;	/* performance metric */
+	}
 
-			if ('\0' != *row[9])
-			{
-				httptest.httptest.http_proxy = zbx_strdup(NULL, row[9]);
-				zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, &host.hostid, NULL, NULL, NULL,
-						NULL, NULL, NULL, NULL, &httptest.httptest.http_proxy,
-						ZBX_MACRO_TYPE_COMMON, NULL, 0);
-			}
-			else
-				httptest.httptest.http_proxy = NULL;
+	httptest_defs_cleanup(poller, now);
 
-			httptest.httptest.retries = atoi(row[10]);
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() started:%d in progress:%d", __func__, httptests_count,
+			poller->runs.values_num);
 
-			httptest.httptest.ssl_cert_file = zbx_strdup(NULL, row[11]);
-			httptest.httptest.ssl_key_file = zbx_strdup(NULL, row[12]);
+	return httptests_count;
+}
 
-			um_handle = zbx_dc_open_user_macros();
-			zbx_substitute_macros(&httptest.httptest.ssl_cert_file, NULL, 0, &macro_httptest_field_resolv,
-					um_handle, &host);
-			zbx_substitute_macros(&httptest.httptest.ssl_key_file, NULL, 0, &macro_httptest_field_resolv,
-					um_handle, &host);
-			zbx_dc_close_user_macros(um_handle);
+/******************************************************************************
+ *                                                                            *
+ * Purpose: initializes web scenario processing                               *
+ *                                                                            *
+ * Parameters: poller - [OUT]                                                 *
+ *             base   - [IN] event base                                       *
+ *             args   - [IN] HTTP poller configuration                        *
+ *             info   - [IN] process information                              *
+ *                                                                            *
+ ******************************************************************************/
+void	httptest_poller_init(zbx_httptest_poller_t *poller, struct event_base *base,
+		const zbx_thread_httppoller_args *args, const zbx_thread_info_t *info)
+{
+#ifdef HAVE_LIBCURL
+	char	*error = NULL;
+#endif
 
-			httptest.httptest.ssl_key_password = zbx_strdup(NULL, row[13]);
-			zbx_substitute_simple_macros_unmasked(NULL, NULL, NULL, NULL, &host.hostid, NULL, NULL, NULL,
-					NULL, NULL, NULL, NULL, &httptest.httptest.ssl_key_password,
-					ZBX_MACRO_TYPE_COMMON, NULL, 0);
+	memset(poller, 0, sizeof(zbx_httptest_poller_t));
 
-			httptest.httptest.verify_peer = atoi(row[14]);
-			httptest.httptest.verify_host = atoi(row[15]);
+	poller->base = base;
+	poller->args = args;
+	poller->info = info;
+	poller->state = ZBX_PROCESS_STATE_BUSY;
 
-			httptest.httptest.delay = row[16];
+	zbx_vector_ptr_create(&poller->runs);
+	zbx_hashset_create(&poller->httptests, 100, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
-			/* add httptest variables to the current test macro cache */
-			http_process_variables(&httptest, &httptest.variables, NULL, NULL);
+#ifdef HAVE_LIBCURL
+	zbx_async_httpagent_init();
 
-			process_httptest(&host, &httptest, &delay, config_source_ip, config_ssl_ca_location,
-					config_ssl_cert_location, config_ssl_key_location);
-			zbx_dc_httptest_queue(now, httptestid, delay);
+	if (NULL == (poller->asynchttppoller_config = zbx_async_httpagent_create(base, httptest_process_result,
+			httptest_poller_update_selfmon_counter, poller, &error)))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "zbx_async_httpagent_create() error: %s", error);
+		zbx_free(error);
+		exit(EXIT_FAILURE);
+	}
+#endif
+}
 
-			zbx_free(httptest.httptest.ssl_key_password);
-			zbx_free(httptest.httptest.ssl_key_file);
-			zbx_free(httptest.httptest.ssl_cert_file);
-			zbx_free(httptest.httptest.http_proxy);
+/******************************************************************************
+ *                                                                            *
+ * Purpose: aborts web scenarios in progress without reporting their results  *
+ *                                                                            *
+ ******************************************************************************/
+void	httptest_poller_stop(zbx_httptest_poller_t *poller)
+{
+	while (0 != poller->runs.values_num)
+	{
+		zbx_httptest_context_t	*ctx = (zbx_httptest_context_t *)poller->runs.values[0];
 
-			if (HTTPTEST_AUTH_NONE != httptest.httptest.authentication)
-			{
-				zbx_free(httptest.httptest.http_password);
-				zbx_free(httptest.httptest.http_user);
-			}
-			zbx_free(httptest.httptest.agent);
-			zbx_free(httptest.headers);
-			httppairs_free(&httptest.variables);
+#ifdef HAVE_LIBCURL
+		curl_multi_remove_handle(poller->asynchttppoller_config->curl_handle, ctx->easyhandle);
+		zbx_free(ctx->body.data);
+		zbx_free(ctx->header.data);
+		httpstep_clean(ctx);
+#endif
+		httptest_context_free(ctx);
+	}
+}
 
-			/* clear the macro cache used in this HTTP test */
-			httptest_remove_macros(&httptest);
+void	httptest_poller_destroy(zbx_httptest_poller_t *poller)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_httptest_def_t	*def;
 
-			httptests_count++;	/* performance metric */
-		}
-		zbx_db_free_result(result);
-	}
-	while (ZBX_IS_RUNNING() && SUCCEED == zbx_dc_httptest_next(now, &httptestid, nextcheck));
+#ifdef HAVE_LIBCURL
+	zbx_async_httpagent_clean(poller->asynchttppoller_config);
+	zbx_free(poller->asynchttppoller_config);
+#endif
+	zbx_hashset_iter_reset(&poller->httptests, &iter);
 
-	/* destroy the macro cache used in HTTP tests */
-	zbx_vector_ptr_pair_destroy(&httptest.macros);
-out:
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+	while (NULL != (def = (zbx_httptest_def_t *)zbx_hashset_iter_next(&iter)))
+		httptest_def_clean(def);
 
-	return httptests_count;
+	zbx_hashset_destroy(&poller->httptests);
+	zbx_vector_ptr_destroy(&poller->runs);
 }
@@ -16,8 +16,38 @@
 #define ZABBIX_HTTPTEST_H
 
 #include "zbxcommon.h"
+#include "zbxalgo.h"
+#include "zbxthreads.h"
+#include "zbxhttppoller.h"
 
-int	process_httptests(int now, const char *config_source_ip, const char *config_ssl_ca_location,
-		const char *config_ssl_cert_location, const char *config_ssl_key_location, time_t *nextcheck);
+#include <event2/event.h>
+
+#ifdef HAVE_LIBCURL
+#	include "zbxasynchttppoller.h"
+#endif
+
+typedef struct
+{
+	struct event_base			*base;
+	struct event				*preproc_flush_timer;
+#ifdef HAVE_LIBCURL
+	zbx_asynchttppoller_config		*asynchttppoller_config;
+#endif
+	const zbx_thread_httppoller_args	*args;
+	const zbx_thread_info_t			*info;
+	unsigned char				state;		/* process self-monitoring state */
+	zbx_vector_ptr_t			runs;		/* web scenarios in progress */
+	int					processed;	/* number of finished web scenarios */
+	zbx_hashset_t				httptests;	/* web scenario definitions by httptestid */
+	time_t					httptests_cleanup;
+}
+zbx_httptest_poller_t;
+
+void	httptest_poller_init(zbx_httptest_poller_t *poller, struct event_base *base,
+		const zbx_thread_httppoller_args *args, const zbx_thread_info_t *info);
+void	httptest_poller_stop(zbx_httptest_poller_t *poller);
+void	httptest_poller_destroy(zbx_httptest_poller_t *poller);
+
+int	process_httptests(zbx_httptest_poller_t *poller, int now, time_t *nextcheck);
 
 #endif
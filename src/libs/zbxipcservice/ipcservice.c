@@ -26,6 +26,18 @@
 #include "zbxalgo.h"
 #include "zbxstr.h"
 #include "zbxtime.h"
+#include "zbxprof.h"
+
+#include <sys/uio.h>
+
+#if defined(__linux__)
+#	include <sys/mman.h>
+#	include <sys/syscall.h>
+#	include <linux/futex.h>
+#	if defined(SYS_memfd_create) && defined(SYS_futex)
+#		define ZBX_IPC_SHM
+#	endif
+#endif
 
 #define ZBX_IPC_PATH_MAX	sizeof(((struct sockaddr_un *)0)->sun_path)
 
@@ -54,7 +66,7 @@ struct zbx_ipc_client
 	struct event		*rx_event;
 
 	zbx_uint32_t		tx_header[2];
-	unsigned char		*tx_data;
+	zbx_ipc_buffer_t	*tx_buffer;
 	zbx_uint32_t		tx_bytes;
 	zbx_queue_ptr_t		tx_queue;
 	struct event		*tx_event;
@@ -69,6 +81,80 @@ struct zbx_ipc_client
 
 ZBX_PTR_VECTOR_IMPL(ipc_client_ptr, zbx_ipc_client_t *)
 
+struct zbx_ipc_buffer
+{
+	unsigned char	*data;
+	zbx_uint32_t	size;
+	zbx_uint32_t	refcount;
+};
+
+/* message queued for sending to client */
+typedef struct
+{
+	zbx_uint32_t		code;
+	zbx_uint32_t		size;
+	zbx_ipc_buffer_t	*buffer;
+}
+zbx_ipc_tx_message_t;
+
+/* number of message segments that can be written without allocating io vector */
+#define ZBX_IPC_IOV_STATIC	16
+
+#ifdef IOV_MAX
+#	define ZBX_IPC_IOV_MAX	IOV_MAX
+#else
+#	define ZBX_IPC_IOV_MAX	16
+#endif
+
+#ifdef ZBX_IPC_SHM
+/* control messages of shared memory ring transport, never passed to service/client users */
+#define ZBX_IPC_SHM_ATTACH		0xfffffff0
+#define ZBX_IPC_SHM_NOTIFY		0xfffffff1
+#define ZBX_IPC_SHM_ACCEPT		0xfffffff2
+#define ZBX_IPC_SHM_REJECT		0xfffffff3
+
+#define ZBX_IPC_SHM_SIZE_MIN		(64 * ZBX_KIBIBYTE)
+#define ZBX_IPC_SHM_SIZE_MAX		(ZBX_GIBIBYTE)
+#define ZBX_IPC_SHM_WAIT_TIMEOUT	1
+
+/* Shared memory ring header, followed by ring data. The ring is written only by client and  */
+/* read only by service, so the head and tail offsets are placed in different cache lines.    */
+typedef struct
+{
+	/* ring data size, power of two */
+	zbx_uint32_t	size;
+
+	/* number of bytes written by client (modulo 2^32) */
+	zbx_uint32_t	head;
+
+	/* client waits for free space */
+	zbx_uint32_t	writer_wait;
+
+	unsigned char	padding1[64 - sizeof(zbx_uint32_t) * 3];
+
+	/* number of bytes read by service (modulo 2^32) */
+	zbx_uint32_t	tail;
+
+	/* service has read all data and must be notified through socket about new data */
+	zbx_uint32_t	reader_idle;
+
+	unsigned char	padding2[64 - sizeof(zbx_uint32_t) * 2];
+}
+zbx_ipc_shm_ring_t;
+
+struct zbx_ipc_shm
+{
+	zbx_ipc_shm_ring_t	*ring;
+	unsigned char		*data;
+	size_t			map_size;
+
+	/* the message being read from ring by service */
+	zbx_uint32_t		rx_header[2];
+	unsigned char		*rx_data;
+	zbx_uint32_t		rx_bytes;
+};
+#endif
+
 /*
  * Private API
  */
@@ -210,9 +296,384 @@ static int	ipc_write_data(int fd, const unsigned char *data, zbx_uint32_t size,
 
 /******************************************************************************
  *                                                                            *
- * Purpose: reads data from a socket                                          *
+ * Purpose: writes data segments to a socket                                  *
  *                                                                            *
  * Parameters: fd        - [IN] the socket file descriptor                    *
+ *             iov       - [IN/OUT] the data segments, modified when data is  *
+ *                                  partially written                         *
+ *             iov_num   - [IN] the number of data segments                   *
+ *             size_sent - [OUT] the actual size written to socket            *
+ *                                                                            *
+ * Return value: SUCCEED - no socket errors were detected. Either the data or *
+ *                         a part of it was written to socket or a write to   *
+ *                         non-blocking socket would block                    *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	ipc_writev_data(int fd, struct iovec *iov, int iov_num, zbx_uint32_t *size_sent)
+{
+	zbx_uint32_t	offset = 0;
+	int		ret = SUCCEED;
+	ssize_t		n;
+
+	while (0 < iov_num)
+	{
+		n = writev(fd, iov, MIN(iov_num, ZBX_IPC_IOV_MAX));
+
+		if (-1 == n)
+		{
+			if (EINTR == errno)
+				continue;
+
+			if (EWOULDBLOCK == errno || EAGAIN == errno)
+				break;
+
+			zabbix_log(LOG_LEVEL_WARNING, "cannot write to IPC socket: %s", strerror(errno));
+			ret = FAIL;
+			break;
+		}
+
+		offset += (zbx_uint32_t)n;
+
+		/* skip written segments and adjust the partially written one */
+		while (0 < iov_num && (size_t)n >= iov->iov_len)
+		{
+			n -= (ssize_t)iov->iov_len;
+			iov++;
+			iov_num--;
+		}
+
+		if (0 < iov_num)
+		{
+			iov->iov_base = (char *)iov->iov_base + n;
+			iov->iov_len -= (size_t)n;
+		}
+	}
+
+	*size_sent = offset;
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: calculates total size of message data segments                    *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_uint32_t	ipc_data_size(const zbx_ipc_data_t *segments, int segments_num)
+{
+	zbx_uint32_t	size = 0;
+	int		i;
+
+	for (i = 0; i < segments_num; i++)
+		size += segments[i].size;
+
+	return size;
+}
+
+#ifdef ZBX_IPC_SHM
+/******************************************************************************
+ *                                                                            *
+ * Purpose: frees shared memory ring mapping                                  *
+ *                                                                            *
+ * Parameters: shm - [IN] the shared memory ring                              *
+ *                                                                            *
+ ******************************************************************************/
+static void	ipc_shm_free(zbx_ipc_shm_t *shm)
+{
+	if (NULL != shm->ring)
+		munmap(shm->ring, shm->map_size);
+
+	zbx_free(shm->rx_data);
+	zbx_free(shm);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: maps shared memory ring                                           *
+ *                                                                            *
+ * Parameters: fd       - [IN] the shared memory file descriptor              *
+ *             map_size - [IN] the mapping size                               *
+ *             error    - [OUT] the error message                             *
+ *                                                                            *
+ * Return value: The mapped shared memory ring or NULL on error.              *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_ipc_shm_t	*ipc_shm_map(int fd, size_t map_size, char **error)
+{
+	zbx_ipc_shm_t	*shm;
+	void		*addr;
+
+	if (MAP_FAILED == (addr = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)))
+	{
+		*error = zbx_dsprintf(*error, "cannot map shared memory: %s", zbx_strerror(errno));
+		return NULL;
+	}
+
+	shm = (zbx_ipc_shm_t *)zbx_malloc(NULL, sizeof(zbx_ipc_shm_t));
+	memset(shm, 0, sizeof(zbx_ipc_shm_t));
+	shm->ring = (zbx_ipc_shm_ring_t *)addr;
+	shm->data = (unsigned char *)addr + sizeof(zbx_ipc_shm_ring_t);
+	shm->map_size = map_size;
+
+	return shm;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: attaches shared memory ring received from client to the socket    *
+ *                                                                            *
+ * Parameters: csocket - [IN] the service side client socket                  *
+ *             fd      - [IN] the shared memory file descriptor               *
+ *                                                                            *
+ ******************************************************************************/
+static void	ipc_shm_attach(zbx_ipc_socket_t *csocket, int fd)
+{
+	zbx_stat_t	st;
+	char		*error = NULL;
+	zbx_uint32_t	size;
+
+	if (NULL != csocket->shm)
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "IPC client shared memory ring is already attached");
+		return;
+	}
+
+	if (0 != fstat(fd, &st))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot get IPC shared memory size: %s", zbx_strerror(errno));
+		return;
+	}
+
+	if ((zbx_uint64_t)st.st_size <= sizeof(zbx_ipc_shm_ring_t))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "invalid IPC shared memory size " ZBX_FS_UI64,
+				(zbx_uint64_t)st.st_size);
+		return;
+	}
+
+	if (NULL == (csocket->shm = ipc_shm_map(fd, (size_t)st.st_size, &error)))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot attach IPC shared memory ring: %s", error);
+		zbx_free(error);
+		return;
+	}
+
+	size = csocket->shm->ring->size;
+
+	/* validate ring size set by client before using it to access data */
+	if (0 == size || 0 != (size & (size - 1)) || size > st.st_size - sizeof(zbx_ipc_shm_ring_t))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "invalid IPC shared memory ring size %u", size);
+		ipc_shm_free(csocket->shm);
+		csocket->shm = NULL;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: notifies service about new data in shared memory ring if it has   *
+ *          read all previous data                                            *
+ *                                                                            *
+ * Parameters: csocket - [IN] the client socket                               *
+ *                                                                            *
+ * Return value: SUCCEED - service was notified or is already reading data    *
+ *               FAIL    - socket error                                       *
+ *                                                                            *
+ ******************************************************************************/
+static int	ipc_shm_notify(zbx_ipc_socket_t *csocket)
+{
+	zbx_uint32_t	header[2] = {ZBX_IPC_SHM_NOTIFY, 0}, size_sent;
+
+	if (0 == __atomic_exchange_n(&csocket->shm->ring->reader_idle, 0, __ATOMIC_SEQ_CST))
+		return SUCCEED;
+
+	if (FAIL == ipc_write_data(csocket->fd, (unsigned char *)header, ZBX_IPC_HEADER_SIZE, &size_sent) ||
+			ZBX_IPC_HEADER_SIZE != size_sent)
+	{
+		return FAIL;
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: waits until service reads data from full shared memory ring       *
+ *                                                                            *
+ * Parameters: csocket - [IN] the client socket                               *
+ *             tail    - [IN] the ring tail when the ring was full            *
+ *                                                                            *
+ * Return value: SUCCEED - ring tail has been (or might have been) changed    *
+ *               FAIL    - service has closed connection                      *
+ *                                                                            *
+ ******************************************************************************/
+static int	ipc_shm_wait(zbx_ipc_socket_t *csocket, zbx_uint32_t tail)
+{
+	zbx_ipc_shm_ring_t	*ring = csocket->shm->ring;
+	struct timespec		ts = {ZBX_IPC_SHM_WAIT_TIMEOUT, 0};
+	struct pollfd		pfd = {.fd = csocket->fd, .events = 0};
+
+	if (FAIL == ipc_shm_notify(csocket))
+		return FAIL;
+
+	__atomic_store_n(&ring->writer_wait, 1, __ATOMIC_SEQ_CST);
+
+	if (tail == __atomic_load_n(&ring->tail, __ATOMIC_SEQ_CST) &&
+			-1 == syscall(SYS_futex, &ring->tail, FUTEX_WAIT, tail, &ts, NULL, 0) && ETIMEDOUT == errno)
+	{
+		/* check if service is still alive */
+		if (0 < poll(&pfd, 1, 0) && 0 != (pfd.revents & (POLLHUP | POLLERR)))
+		{
+			__atomic_store_n(&ring->writer_wait, 0, __ATOMIC_SEQ_CST);
+			return FAIL;
+		}
+	}
+
+	__atomic_store_n(&ring->writer_wait, 0, __ATOMIC_SEQ_CST);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: writes data to shared memory ring                                 *
+ *                                                                            *
+ * Parameters: csocket - [IN] the client socket                               *
+ *             data    - [IN] the data                                        *
+ *             size    - [IN] the data size                                   *
+ *                                                                            *
+ * Return value: SUCCEED - the data was written                               *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: Data larger than ring is written in parts, waiting for service   *
+ *           to read the previous parts.                                      *
+ *                                                                            *
+ ******************************************************************************/
+static int	ipc_shm_write_data(zbx_ipc_socket_t *csocket, const unsigned char *data, zbx_uint32_t size)
+{
+	zbx_ipc_shm_ring_t	*ring = csocket->shm->ring;
+	zbx_uint32_t		offset = 0, mask = ring->size - 1;
+
+	while (offset < size)
+	{
+		zbx_uint32_t	head, tail, chunk, pos, part;
+
+		head = ring->head;
+		tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+		if (0 == (chunk = MIN(ring->size - (head - tail), size - offset)))
+		{
+			if (FAIL == ipc_shm_wait(csocket, tail))
+				return FAIL;
+
+			continue;
+		}
+
+		pos = head & mask;
+		part = MIN(chunk, ring->size - pos);
+
+		memcpy(csocket->shm->data + pos, data + offset, part);
+
+		if (part < chunk)
+			memcpy(csocket->shm->data, data + offset + part, chunk - part);
+
+		__atomic_store_n(&ring->head, head + chunk, __ATOMIC_SEQ_CST);
+		offset += chunk;
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: writes IPC message to shared memory ring                          *
+ *                                                                            *
+ * Parameters: csocket      - [IN] the client socket                          *
+ *             code         - [IN] the message code                           *
+ *             segments     - [IN] the message data segments                  *
+ *             segments_num - [IN] the number of data segments                *
+ *                                                                            *
+ * Return value: SUCCEED - the message was written                            *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	ipc_shm_write_message(zbx_ipc_socket_t *csocket, zbx_uint32_t code, const zbx_ipc_data_t *segments,
+		int segments_num)
+{
+	zbx_uint32_t	header[2] = {code, ipc_data_size(segments, segments_num)};
+	int		i;
+
+	if (FAIL == ipc_shm_write_data(csocket, (const unsigned char *)header, ZBX_IPC_HEADER_SIZE))
+		return FAIL;
+
+	for (i = 0; i < segments_num; i++)
+	{
+		if (0 != segments[i].size && FAIL == ipc_shm_write_data(csocket, segments[i].data, segments[i].size))
+			return FAIL;
+	}
+
+	return ipc_shm_notify(csocket);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: receives data from socket, attaching shared memory ring if its    *
+ *          descriptor was passed by client                                   *
+ *                                                                            *
+ ******************************************************************************/
+static ssize_t	ipc_socket_recv(zbx_ipc_socket_t *csocket, unsigned char *buffer, zbx_uint32_t size)
+{
+	struct msghdr	msg;
+	struct iovec	iov = {.iov_base = buffer, .iov_len = size};
+	ssize_t		n;
+	union
+	{
+		struct cmsghdr	align;
+		char		buf[CMSG_SPACE(sizeof(int))];
+	}
+	control;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control.buf;
+	msg.msg_controllen = sizeof(control.buf);
+
+#ifdef MSG_CMSG_CLOEXEC
+	n = recvmsg(csocket->fd, &msg, MSG_CMSG_CLOEXEC);
+#else
+	n = recvmsg(csocket->fd, &msg, 0);
+#endif
+	if (0 < n && 0 != (msg.msg_flags & MSG_CTRUNC))
+		zabbix_log(LOG_LEVEL_WARNING, "cannot receive IPC shared memory descriptor: control data truncated");
+
+	if (0 < n && 0 != msg.msg_controllen)
+	{
+		struct cmsghdr	*cmsg;
+
+		for (cmsg = CMSG_FIRSTHDR(&msg); NULL != cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+		{
+			int	fd;
+
+			if (SOL_SOCKET != cmsg->cmsg_level || SCM_RIGHTS != cmsg->cmsg_type)
+				continue;
+
+			memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+			ipc_shm_attach(csocket, fd);
+			close(fd);
+		}
+	}
+
+	return n;
+}
+#endif
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reads data from a socket                                          *
+ *                                                                            *
+ * Parameters: csocket   - [IN] the IPC socket                                *
  *             data      - [IN] the data                                      *
  *             size      - [IN] the data size                                 *
  *             size_sent - [IN] the actual size read from socket              *
@@ -224,13 +685,18 @@ static int	ipc_write_data(int fd, const unsigned char *data, zbx_uint32_t size,
  *           returned also if there were no more data to read.                *
  *                                                                            *
  ******************************************************************************/
-static int	ipc_read_data(int fd, unsigned char *buffer, zbx_uint32_t size, zbx_uint32_t *read_size)
+static int	ipc_read_data(zbx_ipc_socket_t *csocket, unsigned char *buffer, zbx_uint32_t size,
+		zbx_uint32_t *read_size)
 {
 	int	n;
 
 	*read_size = 0;
 
-	while (-1 == (n = read(fd, buffer + *read_size, size - *read_size)))
+#ifdef ZBX_IPC_SHM
+	while (-1 == (n = (int)ipc_socket_recv(csocket, buffer + *read_size, size - *read_size)))
+#else
+	while (-1 == (n = read(csocket->fd, buffer + *read_size, size - *read_size)))
+#endif
 	{
 		if (EINTR == errno)
 			continue;
@@ -253,7 +719,7 @@ static int	ipc_read_data(int fd, unsigned char *buffer, zbx_uint32_t size, zbx_u
  *                                                                            *
  * Purpose: reads data from a socket until the requested data has been read   *
  *                                                                            *
- * Parameters: fd        - [IN] the socket file descriptor                    *
+ * Parameters: csocket   - [IN] the IPC socket                                *
  *             buffer    - [IN] the data                                      *
  *             size      - [IN] the data size                                 *
  *             read_size - [IN] the actual size read from socket              *
@@ -266,7 +732,8 @@ static int	ipc_read_data(int fd, unsigned char *buffer, zbx_uint32_t size, zbx_u
  *           the requested data has been read.                                *
  *                                                                            *
  ******************************************************************************/
-static int	ipc_read_data_full(int fd, unsigned char *buffer, zbx_uint32_t size, zbx_uint32_t *read_size)
+static int	ipc_read_data_full(zbx_ipc_socket_t *csocket, unsigned char *buffer, zbx_uint32_t size,
+		zbx_uint32_t *read_size)
 {
 	int		ret = FAIL;
 	zbx_uint32_t	offset = 0, chunk_size;
@@ -275,7 +742,7 @@ static int	ipc_read_data_full(int fd, unsigned char *buffer, zbx_uint32_t size,
 
 	while (offset < size)
 	{
-		if (FAIL == ipc_read_data(fd, buffer + offset, size - offset, &chunk_size))
+		if (FAIL == ipc_read_data(csocket, buffer + offset, size - offset, &chunk_size))
 			goto out;
 
 		if (0 == chunk_size)
@@ -295,11 +762,11 @@ out:
  *                                                                            *
  * Purpose: writes IPC message to socket                                      *
  *                                                                            *
- * Parameters: csocket - [IN] the IPC socket                                  *
- *             code    - [IN] the message code                                *
- *             data    - [IN] the data                                        *
- *             size    - [IN] the data size                                   *
- *             tx_size - [IN] the actual size written to socket               *
+ * Parameters: csocket      - [IN] the IPC socket                             *
+ *             code         - [IN] the message code                           *
+ *             segments     - [IN] the message data segments                  *
+ *             segments_num - [IN] the number of data segments                *
+ *             tx_size      - [OUT] the actual size written to socket         *
  *                                                                            *
  * Return value: SUCCEED - no socket errors were detected. Either the data or *
  *                         a part of it was written to socket or a write to   *
@@ -311,32 +778,33 @@ out:
  *           sent successfully.                                               *
  *                                                                            *
  ******************************************************************************/
-static int	ipc_socket_write_message(zbx_ipc_socket_t *csocket, zbx_uint32_t code, const unsigned char *data,
-		zbx_uint32_t size, zbx_uint32_t *tx_size)
+static int	ipc_socket_write_message(zbx_ipc_socket_t *csocket, zbx_uint32_t code, const zbx_ipc_data_t *segments,
+		int segments_num, zbx_uint32_t *tx_size)
 {
-	int		ret;
-	zbx_uint32_t	size_data, buffer[ZBX_IPC_SOCKET_BUFFER_SIZE / sizeof(zbx_uint32_t)];
+	int		ret, i, iov_num = 1;
+	zbx_uint32_t	header[2] = {code, ipc_data_size(segments, segments_num)};
+	struct iovec	iov_local[ZBX_IPC_IOV_STATIC + 1], *iov = iov_local;
 
-	buffer[0] = code;
-	buffer[1] = size;
+	if (ZBX_IPC_IOV_STATIC < segments_num)
+		iov = (struct iovec *)zbx_malloc(NULL, sizeof(struct iovec) * (size_t)(segments_num + 1));
 
-	if (ZBX_IPC_SOCKET_BUFFER_SIZE - ZBX_IPC_HEADER_SIZE >= size)
+	/* header and data are written with a single system call, without copying them to a common buffer */
+	iov[0].iov_base = header;
+	iov[0].iov_len = ZBX_IPC_HEADER_SIZE;
+
+	for (i = 0; i < segments_num; i++)
 	{
-		if (0 != size)
-			memcpy(buffer + 2, data, size);
+		if (0 == segments[i].size)
+			continue;
 
-		return ipc_write_data(csocket->fd, (unsigned char *)buffer, size + ZBX_IPC_HEADER_SIZE, tx_size);
+		iov[iov_num].iov_base = (void *)segments[i].data;
+		iov[iov_num++].iov_len = segments[i].size;
 	}
 
-	if (FAIL == ipc_write_data(csocket->fd, (unsigned char *)buffer, ZBX_IPC_HEADER_SIZE, tx_size))
-		return FAIL;
-
-	/* in the case of non-blocking sockets only a part of the header might be sent */
-	if (ZBX_IPC_HEADER_SIZE != *tx_size)
-		return SUCCEED;
+	ret = ipc_writev_data(csocket->fd, iov, iov_num, tx_size);
 
-	ret = ipc_write_data(csocket->fd, data, size, &size_data);
-	*tx_size += size_data;
+	if (iov != iov_local)
+		zbx_free(iov);
 
 	return ret;
 }
@@ -469,13 +937,13 @@ static int	ipc_socket_read_message(zbx_ipc_socket_t *csocket, zbx_uint32_t *head
 			/* long messages will be read directly into message buffer */
 			if (ZBX_IPC_SOCKET_BUFFER_SIZE * 0.75 < data_size)
 			{
-				ret = ipc_read_data_full(csocket->fd, *data + offset, data_size, &read_size);
+				ret = ipc_read_data_full(csocket, *data + offset, data_size, &read_size);
 				*rx_bytes += read_size;
 				goto out;
 			}
 		}
 
-		if (FAIL == ipc_read_data(csocket->fd, csocket->rx_buffer, ZBX_IPC_SOCKET_BUFFER_SIZE, &read_size))
+		if (FAIL == ipc_read_data(csocket, csocket->rx_buffer, ZBX_IPC_SOCKET_BUFFER_SIZE, &read_size))
 			goto out;
 
 		/* it's possible that nothing will be read on non-blocking sockets, return success */
@@ -529,6 +997,7 @@ static void	ipc_client_free_events(zbx_ipc_client_t *client)
 static void	ipc_client_free(zbx_ipc_client_t *client)
 {
 	zbx_ipc_message_t	*message;
+	zbx_ipc_tx_message_t	*tx_message;
 
 	ipc_client_free_events(client);
 	zbx_ipc_socket_close(&client->csocket);
@@ -539,11 +1008,14 @@ static void	ipc_client_free(zbx_ipc_client_t *client)
 	zbx_queue_ptr_destroy(&client->rx_queue);
 	zbx_free(client->rx_data);
 
-	while (NULL != (message = (zbx_ipc_message_t *)zbx_queue_ptr_pop(&client->tx_queue)))
-		zbx_ipc_message_free(message);
+	while (NULL != (tx_message = (zbx_ipc_tx_message_t *)zbx_queue_ptr_pop(&client->tx_queue)))
+	{
+		zbx_ipc_buffer_release(tx_message->buffer);
+		zbx_free(tx_message);
+	}
 
 	zbx_queue_ptr_destroy(&client->tx_queue);
-	zbx_free(client->tx_data);
+	zbx_ipc_buffer_release(client->tx_buffer);
 
 	ipc_client_free_events(client);
 
@@ -580,21 +1052,152 @@ static void	ipc_client_push_rx_message(zbx_ipc_client_t *client)
  ******************************************************************************/
 static void	ipc_client_pop_tx_message(zbx_ipc_client_t *client)
 {
-	zbx_ipc_message_t	*message;
+	zbx_ipc_tx_message_t	*message;
 
-	zbx_free(client->tx_data);
+	zbx_ipc_buffer_release(client->tx_buffer);
+	client->tx_buffer = NULL;
 	client->tx_bytes = 0;
 
-	if (NULL == (message = (zbx_ipc_message_t *)zbx_queue_ptr_pop(&client->tx_queue)))
+	if (NULL == (message = (zbx_ipc_tx_message_t *)zbx_queue_ptr_pop(&client->tx_queue)))
 		return;
 
 	client->tx_bytes = ZBX_IPC_HEADER_SIZE + message->size;
 	client->tx_header[ZBX_IPC_MESSAGE_CODE] = message->code;
 	client->tx_header[ZBX_IPC_MESSAGE_SIZE] = message->size;
-	client->tx_data = message->data;
+	client->tx_buffer = message->buffer;
 	zbx_free(message);
 }
 
+#ifdef ZBX_IPC_SHM
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reads messages from client shared memory ring                     *
+ *                                                                            *
+ * Parameters: client - [IN] the client to read                               *
+ *             limit  - [IN] the maximum number of bytes to read, 0 - read    *
+ *                           all available data                               *
+ *                                                                            *
+ * Return value: SUCCEED - all available data was read                        *
+ *               FAIL    - the read limit was reached                         *
+ *                                                                            *
+ ******************************************************************************/
+static int	ipc_client_read_shm(zbx_ipc_client_t *client, zbx_uint32_t limit)
+{
+	zbx_ipc_shm_t		*shm = client->csocket.shm;
+	zbx_ipc_shm_ring_t	*ring = shm->ring;
+	zbx_uint32_t		mask = ring->size - 1, total = 0;
+
+	while (1)
+	{
+		zbx_uint32_t	head, tail, size, pos, part, offset = 0;
+
+		tail = ring->tail;
+
+		if (tail == (head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)))
+		{
+			/* mark reader as idle and recheck to avoid missing data written meanwhile */
+			__atomic_store_n(&ring->reader_idle, 1, __ATOMIC_SEQ_CST);
+
+			if (tail == __atomic_load_n(&ring->head, __ATOMIC_SEQ_CST) ||
+					0 == __atomic_exchange_n(&ring->reader_idle, 0, __ATOMIC_SEQ_CST))
+			{
+				/* either ring is empty or writer has already sent notification */
+				return SUCCEED;
+			}
+
+			continue;
+		}
+
+		if (0 != limit && total >= limit)
+			return FAIL;
+
+		/* ring size is validated on attach, so invalid head cannot cause reading outside of ring */
+		if ((size = head - tail) > ring->size)
+			size = ring->size;
+
+		pos = tail & mask;
+		part = MIN(size, ring->size - pos);
+
+		while (offset < size)
+		{
+			const unsigned char	*data;
+			zbx_uint32_t		chunk, n;
+			int			rc;
+
+			if (offset < part)
+			{
+				data = shm->data + pos + offset;
+				chunk = part - offset;
+			}
+			else
+			{
+				data = shm->data + offset - part;
+				chunk = size - offset;
+			}
+
+			rc = ipc_read_buffer(shm->rx_header, &shm->rx_data, shm->rx_bytes, data, chunk, &n);
+			shm->rx_bytes += n;
+			offset += n;
+
+			if (SUCCEED == rc)
+			{
+				zbx_ipc_message_t	*message;
+
+				message = (zbx_ipc_message_t *)zbx_malloc(NULL, sizeof(zbx_ipc_message_t));
+				message->code = shm->rx_header[ZBX_IPC_MESSAGE_CODE];
+				message->size = shm->rx_header[ZBX_IPC_MESSAGE_SIZE];
+				message->data = shm->rx_data;
+				zbx_queue_ptr_push(&client->rx_queue, message);
+
+				shm->rx_data = NULL;
+				shm->rx_bytes = 0;
+			}
+		}
+
+		__atomic_store_n(&ring->tail, tail + size, __ATOMIC_SEQ_CST);
+		total += size;
+
+		if (0 != __atomic_load_n(&ring->writer_wait, __ATOMIC_SEQ_CST))
+			syscall(SYS_futex, &ring->tail, FUTEX_WAKE, 1, NULL, NULL, 0);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: discards shared memory ring control message                       *
+ *                                                                            *
+ * Parameters: client - [IN] the client                                       *
+ *                                                                            *
+ * Return value: SUCCEED - the received message was a control message         *
+ *               FAIL    - the received message is not a control message      *
+ *                                                                            *
+ * Comments: The ring is attached when its descriptor is received, so the     *
+ *           attach message is only a carrier for the descriptor. Client      *
+ *           waits for the attach result and falls back to socket if the ring *
+ *           was rejected. Notify message only wakes up service to read ring. *
+ *                                                                            *
+ ******************************************************************************/
+static int	ipc_client_discard_shm_message(zbx_ipc_client_t *client)
+{
+	switch (client->rx_header[ZBX_IPC_MESSAGE_CODE])
+	{
+		case ZBX_IPC_SHM_ATTACH:
+			zbx_ipc_client_send(client, NULL != client->csocket.shm ? ZBX_IPC_SHM_ACCEPT :
+					ZBX_IPC_SHM_REJECT, NULL, 0);
+			break;
+		case ZBX_IPC_SHM_NOTIFY:
+			break;
+		default:
+			return FAIL;
+	}
+
+	zbx_free(client->rx_data);
+	client->rx_bytes = 0;
+
+	return SUCCEED;
+}
+#endif
+
 /******************************************************************************
  *                                                                            *
  * Purpose: reads data from IPC service client                                *
@@ -618,15 +1221,32 @@ static int	ipc_client_read(zbx_ipc_client_t *client)
 		{
 			zbx_free(client->rx_data);
 			client->rx_bytes = 0;
+#ifdef ZBX_IPC_SHM
+			/* process messages written to ring before client closed connection */
+			if (NULL != client->csocket.shm)
+				ipc_client_read_shm(client, 0);
+#endif
 			return FAIL;
 		}
 
 		if (SUCCEED == (rc = ipc_message_is_completed(client->rx_header, client->rx_bytes)))
+		{
+#ifdef ZBX_IPC_SHM
+			if (SUCCEED == ipc_client_discard_shm_message(client))
+				continue;
+#endif
 			ipc_client_push_rx_message(client);
+		}
 	}
-
 	while (SUCCEED == rc);
 
+#ifdef ZBX_IPC_SHM
+	/* limit data read from ring at once so other clients are not starved, re-activating */
+	/* read event to continue with the rest of data                                      */
+	if (NULL != client->csocket.shm && FAIL == ipc_client_read_shm(client, client->csocket.shm->ring->size))
+		event_active(client->rx_event, EV_READ, 1);
+#endif
+
 	return SUCCEED;
 }
 
@@ -667,8 +1287,8 @@ static int	ipc_client_write(zbx_ipc_client_t *client)
 
 	while (0 < client->tx_bytes)
 	{
-		if (SUCCEED != ipc_write_data(client->csocket.fd, client->tx_data + data_size - client->tx_bytes,
-				client->tx_bytes, &write_size))
+		if (SUCCEED != ipc_write_data(client->csocket.fd,
+				client->tx_buffer->data + data_size - client->tx_bytes, client->tx_bytes, &write_size))
 		{
 			return FAIL;
 		}
@@ -955,33 +1575,45 @@ static void	ipc_service_accept(zbx_ipc_service_t *service)
 
 /******************************************************************************
  *                                                                            *
- * Purpose: creates IPC message                                               *
+ * Purpose: gets message data buffer for queuing                              *
  *                                                                            *
- * Parameters: code    - [IN] the message code                                *
- *             data    - [IN] the data                                        *
- *             size    - [IN] the data size                                   *
+ * Parameters: buffer       - [IN] the message data buffer (optional)         *
+ *             segments     - [IN] the message data segments                  *
+ *             segments_num - [IN] the number of data segments                *
+ *             size         - [IN] the total data size                        *
  *                                                                            *
- * Return value: The created message.                                         *
+ * Return value: The referenced buffer if it was specified, otherwise new     *
+ *               buffer with data segments copied into it. NULL is returned   *
+ *               for messages without data.                                   *
  *                                                                            *
  ******************************************************************************/
-static zbx_ipc_message_t	*ipc_message_create(zbx_uint32_t code, const unsigned char *data, zbx_uint32_t size)
+static zbx_ipc_buffer_t	*ipc_buffer_acquire(zbx_ipc_buffer_t *buffer, const zbx_ipc_data_t *segments,
+		int segments_num, zbx_uint32_t size)
 {
-	zbx_ipc_message_t	*message;
+	unsigned char	*data, *ptr;
+	int		i;
 
-	message = (zbx_ipc_message_t *)zbx_malloc(NULL, sizeof(zbx_ipc_message_t));
+	if (NULL != buffer)
+	{
+		buffer->refcount++;
+		return buffer;
+	}
 
-	message->code = code;
-	message->size = size;
+	if (0 == size)
+		return NULL;
 
-	if (0 != size)
+	ptr = data = (unsigned char *)zbx_malloc(NULL, size);
+
+	for (i = 0; i < segments_num; i++)
 	{
-		message->data = (unsigned char *)zbx_malloc(NULL, size);
-		memcpy(message->data, data, size);
+		if (0 == segments[i].size)
+			continue;
+
+		memcpy(ptr, segments[i].data, segments[i].size);
+		ptr += segments[i].size;
 	}
-	else
-		message->data = NULL;
 
-	return message;
+	return zbx_ipc_buffer_create(data, size);
 }
 
 /******************************************************************************
@@ -1109,6 +1741,8 @@ int	zbx_ipc_socket_open(zbx_ipc_socket_t *csocket, const char *service_name, int
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
+	csocket->shm = NULL;
+
 	if (NULL == (socket_path = ipc_make_path(service_name, error)))
 		goto out;
 
@@ -1163,9 +1797,156 @@ void	zbx_ipc_socket_close(zbx_ipc_socket_t *csocket)
 		csocket->fd = -1;
 	}
 
+#ifdef ZBX_IPC_SHM
+	if (NULL != csocket->shm)
+	{
+		ipc_shm_free(csocket->shm);
+		csocket->shm = NULL;
+	}
+#endif
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: enables shared memory ring transport for messages written to      *
+ *          IPC service                                                       *
+ *                                                                            *
+ * Parameters: csocket - [IN] an opened IPC socket to the service             *
+ *             size    - [IN] the ring size, rounded up to power of two       *
+ *             error   - [OUT] the error message                              *
+ *                                                                            *
+ * Return value: SUCCEED - shared memory ring transport was enabled           *
+ *               FAIL    - otherwise, messages are written to socket          *
+ *                                                                            *
+ * Comments: Messages written with zbx_ipc_socket_write() are copied to ring  *
+ *           shared with service instead of being sent through socket. The    *
+ *           socket is used to pass ring descriptor, to wake up service when  *
+ *           it has read all previous data and to read service responses.     *
+ *           The ring is used only after service confirms it was attached.    *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_ipc_socket_enable_shm(zbx_ipc_socket_t *csocket, zbx_uint32_t size, char **error)
+{
+#ifdef ZBX_IPC_SHM
+	int		fd, ret = FAIL;
+	zbx_uint32_t	header[2] = {ZBX_IPC_SHM_ATTACH, 0}, rx_header[2], rx_bytes = 0;
+	unsigned char	*rx_data = NULL;
+	size_t		map_size;
+	zbx_ipc_shm_t	*shm = NULL;
+	struct msghdr	msg;
+	struct iovec	iov = {.iov_base = header, .iov_len = ZBX_IPC_HEADER_SIZE};
+	ssize_t		n;
+	union
+	{
+		struct cmsghdr	align;
+		char		buf[CMSG_SPACE(sizeof(int))];
+	}
+	control;
+	struct cmsghdr	*cmsg;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() size:%u", __func__, size);
+
+	if (NULL != csocket->shm)
+	{
+		ret = SUCCEED;
+		goto out;
+	}
+
+	size = MAX(size, ZBX_IPC_SHM_SIZE_MIN);
+	size = MIN(size, ZBX_IPC_SHM_SIZE_MAX);
+
+	/* round up to power of two so ring offsets can be masked */
+	size--;
+	size |= size >> 1;
+	size |= size >> 2;
+	size |= size >> 4;
+	size |= size >> 8;
+	size |= size >> 16;
+	size++;
+
+	map_size = sizeof(zbx_ipc_shm_ring_t) + size;
+
+	/* 1 - MFD_CLOEXEC */
+	if (-1 == (fd = (int)syscall(SYS_memfd_create, "zbx_ipc", 1)))
+	{
+		*error = zbx_dsprintf(*error, "cannot create shared memory: %s", zbx_strerror(errno));
+		goto out;
+	}
+
+	if (0 != ftruncate(fd, (off_t)map_size))
+	{
+		*error = zbx_dsprintf(*error, "cannot set shared memory size: %s", zbx_strerror(errno));
+		goto close;
+	}
+
+	if (NULL == (shm = ipc_shm_map(fd, map_size, error)))
+		goto close;
+
+	shm->ring->size = size;
+	shm->ring->reader_idle = 1;
+
+	memset(&msg, 0, sizeof(msg));
+	memset(&control, 0, sizeof(control));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control.buf;
+	msg.msg_controllen = sizeof(control.buf);
+
+	cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+	memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+	while (-1 == (n = sendmsg(csocket->fd, &msg, 0)) && EINTR == errno)
+		;
+
+	if (ZBX_IPC_HEADER_SIZE != n)
+	{
+		*error = zbx_dsprintf(*error, "cannot pass shared memory to service: %s",
+				-1 == n ? zbx_strerror(errno) : "partial write");
+		ipc_shm_free(shm);
+		goto close;
+	}
+
+	/* wait for service to attach the ring, otherwise client could wait for ring data to be read forever */
+	if (SUCCEED != ipc_socket_read_message(csocket, rx_header, &rx_data, &rx_bytes) ||
+			SUCCEED != ipc_message_is_completed(rx_header, rx_bytes))
+	{
+		*error = zbx_strdup(*error, "cannot read shared memory attach response from service");
+		zbx_free(rx_data);
+		ipc_shm_free(shm);
+		goto close;
+	}
+
+	zbx_free(rx_data);
+
+	if (ZBX_IPC_SHM_ACCEPT != rx_header[ZBX_IPC_MESSAGE_CODE])
+	{
+		*error = zbx_strdup(*error, "service cannot attach shared memory");
+		ipc_shm_free(shm);
+		goto close;
+	}
+
+	csocket->shm = shm;
+	ret = SUCCEED;
+close:
+	close(fd);
+out:
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
+
+	return ret;
+#else
+	ZBX_UNUSED(csocket);
+	ZBX_UNUSED(size);
+
+	*error = zbx_strdup(*error, "shared memory transport is not supported on this platform");
+
+	return FAIL;
+#endif
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: writes a message to IPC service                                   *
@@ -1180,19 +1961,52 @@ void	zbx_ipc_socket_close(zbx_ipc_socket_t *csocket)
  *                                                                            *
  ******************************************************************************/
 int	zbx_ipc_socket_write(zbx_ipc_socket_t *csocket, zbx_uint32_t code, const unsigned char *data, zbx_uint32_t size)
+{
+	zbx_ipc_data_t	segment = {.data = data, .size = size};
+
+	return zbx_ipc_socket_writev(csocket, code, &segment, 1);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: writes a message composed of several data segments to IPC service *
+ *                                                                            *
+ * Parameters: csocket      - [IN] an opened IPC socket to the service        *
+ *             code         - [IN] the message code                           *
+ *             segments     - [IN] the message data segments                  *
+ *             segments_num - [IN] the number of data segments                *
+ *                                                                            *
+ * Return value: SUCCEED - the message was successfully written               *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_ipc_socket_writev(zbx_ipc_socket_t *csocket, zbx_uint32_t code, const zbx_ipc_data_t *segments,
+		int segments_num)
 {
 	int		ret;
 	zbx_uint32_t	size_sent;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	if (SUCCEED == ipc_socket_write_message(csocket, code, data, size, &size_sent) &&
-			size_sent == size + ZBX_IPC_HEADER_SIZE)
+	zbx_prof_probe_start(ZBX_PROF_PROBE_IPC_SEND);
+#ifdef ZBX_IPC_SHM
+	if (NULL != csocket->shm)
+	{
+		ret = ipc_shm_write_message(csocket, code, segments, segments_num);
+		goto out;
+	}
+#endif
+	if (SUCCEED == ipc_socket_write_message(csocket, code, segments, segments_num, &size_sent) &&
+			size_sent == ipc_data_size(segments, segments_num) + ZBX_IPC_HEADER_SIZE)
 	{
 		ret = SUCCEED;
 	}
 	else
 		ret = FAIL;
+#ifdef ZBX_IPC_SHM
+out:
+#endif
+	zbx_prof_probe_end(ZBX_PROF_PROBE_IPC_SEND);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
 
@@ -1221,9 +2035,15 @@ int	zbx_ipc_socket_read(zbx_ipc_socket_t *csocket, zbx_ipc_message_t *message)
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	if (SUCCEED != ipc_socket_read_message(csocket, header, &data, &rx_bytes))
+	zbx_prof_probe_start(ZBX_PROF_PROBE_IPC_RECV);
+	ret = ipc_socket_read_message(csocket, header, &data, &rx_bytes);
+	zbx_prof_probe_end(ZBX_PROF_PROBE_IPC_RECV);
+
+	if (SUCCEED != ret)
 		goto out;
 
+	ret = FAIL;
+
 	if (SUCCEED != ipc_message_is_completed(header, rx_bytes))
 	{
 		zbx_free(data);
@@ -1267,6 +2087,47 @@ int	zbx_ipc_socket_connected(const zbx_ipc_socket_t *csocket)
 	return 0 < csocket->fd ? SUCCEED : FAIL;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: creates reference counted message data                           *
+ *                                                                            *
+ * Parameters: data - [IN] the data, allocated with zbx_malloc()              *
+ *             size - [IN] the data size                                      *
+ *                                                                            *
+ * Return value: The created buffer with a single reference.                  *
+ *                                                                            *
+ * Comments: The buffer takes ownership of the data, which is freed when the  *
+ *           last buffer reference is released.                               *
+ *                                                                            *
+ ******************************************************************************/
+zbx_ipc_buffer_t	*zbx_ipc_buffer_create(unsigned char *data, zbx_uint32_t size)
+{
+	zbx_ipc_buffer_t	*buffer;
+
+	buffer = (zbx_ipc_buffer_t *)zbx_malloc(NULL, sizeof(zbx_ipc_buffer_t));
+	buffer->data = data;
+	buffer->size = size;
+	buffer->refcount = 1;
+
+	return buffer;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: releases reference counted message data                           *
+ *                                                                            *
+ * Parameters: buffer - [IN] the message data buffer                          *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_ipc_buffer_release(zbx_ipc_buffer_t *buffer)
+{
+	if (NULL == buffer || 0 != --buffer->refcount)
+		return;
+
+	zbx_free(buffer->data);
+	zbx_free(buffer);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: frees the resources allocated to store IPC message data           *
@@ -1663,43 +2524,52 @@ void	zbx_ipc_service_alert(zbx_ipc_service_t *service)
 
 /******************************************************************************
  *                                                                            *
- * Purpose: Sends IPC message to client                                       *
+ * Purpose: sends IPC message to client                                       *
  *                                                                            *
- * Parameters: client - [IN] the IPC client                                   *
- *             code   - [IN] the message code                                 *
- *             data   - [IN] the data                                         *
- *             size   - [IN] the data size                                    *
+ * Parameters: client       - [IN] the IPC client                             *
+ *             code         - [IN] the message code                           *
+ *             segments     - [IN] the message data segments                  *
+ *             segments_num - [IN] the number of data segments                *
+ *             buffer       - [IN] the buffer holding message data (optional) *
  *                                                                            *
  * Comments: If data can't be written directly to socket (buffer full) then   *
  *           the message is queued and sent during zbx_ipc_service_recv()     *
- *           messaging loop whenever socket becomes ready.                    *
+ *           messaging loop whenever socket becomes ready. Queued message     *
+ *           references the data buffer if it was specified, otherwise the    *
+ *           data segments are copied.                                        *
  *                                                                            *
  ******************************************************************************/
-int	zbx_ipc_client_send(zbx_ipc_client_t *client, zbx_uint32_t code, const unsigned char *data, zbx_uint32_t size)
+static int	ipc_client_send(zbx_ipc_client_t *client, zbx_uint32_t code, const zbx_ipc_data_t *segments,
+		int segments_num, zbx_ipc_buffer_t *buffer)
 {
-	zbx_uint32_t		tx_size = 0;
-	zbx_ipc_message_t	*message;
-	int			ret = FAIL;
+	zbx_uint32_t	tx_size = 0, size;
+	int		ret = FAIL;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() clientid:" ZBX_FS_UI64, __func__, client->id);
 
+	size = ipc_data_size(segments, segments_num);
+
 	if (0 != client->tx_bytes)
 	{
-		message = ipc_message_create(code, data, size);
+		zbx_ipc_tx_message_t	*message;
+
+		message = (zbx_ipc_tx_message_t *)zbx_malloc(NULL, sizeof(zbx_ipc_tx_message_t));
+		message->code = code;
+		message->size = size;
+		message->buffer = ipc_buffer_acquire(buffer, segments, segments_num, size);
 		zbx_queue_ptr_push(&client->tx_queue, message);
 		ret = SUCCEED;
 		goto out;
 	}
 
-	if (FAIL == ipc_socket_write_message(&client->csocket, code, data, size, &tx_size))
+	if (FAIL == ipc_socket_write_message(&client->csocket, code, segments, segments_num, &tx_size))
 		goto out;
 
 	if (tx_size != ZBX_IPC_HEADER_SIZE + size)
 	{
 		client->tx_header[ZBX_IPC_MESSAGE_CODE] = code;
 		client->tx_header[ZBX_IPC_MESSAGE_SIZE] = size;
-		client->tx_data = (unsigned char *)zbx_malloc(NULL, size);
-		memcpy(client->tx_data, data, size);
+		client->tx_buffer = ipc_buffer_acquire(buffer, segments, segments_num, size);
 		client->tx_bytes = ZBX_IPC_HEADER_SIZE + size - tx_size;
 		event_add(client->tx_event, NULL);
 	}
@@ -1711,6 +2581,66 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: Sends IPC message to client                                       *
+ *                                                                            *
+ * Parameters: client - [IN] the IPC client                                   *
+ *             code   - [IN] the message code                                 *
+ *             data   - [IN] the data                                         *
+ *             size   - [IN] the data size                                    *
+ *                                                                            *
+ * Comments: If data can't be written directly to socket (buffer full) then   *
+ *           the message is queued and sent during zbx_ipc_service_recv()     *
+ *           messaging loop whenever socket becomes ready.                    *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_ipc_client_send(zbx_ipc_client_t *client, zbx_uint32_t code, const unsigned char *data, zbx_uint32_t size)
+{
+	zbx_ipc_data_t	segment = {.data = data, .size = size};
+
+	return ipc_client_send(client, code, &segment, 1, NULL);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sends IPC message composed of several data segments to client     *
+ *                                                                            *
+ * Parameters: client       - [IN] the IPC client                             *
+ *             code         - [IN] the message code                           *
+ *             segments     - [IN] the message data segments                  *
+ *             segments_num - [IN] the number of data segments                *
+ *                                                                            *
+ * Comments: The data segments are written to socket with a single system     *
+ *           call and are merged only if the message must be queued.          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_ipc_client_sendv(zbx_ipc_client_t *client, zbx_uint32_t code, const zbx_ipc_data_t *segments,
+		int segments_num)
+{
+	return ipc_client_send(client, code, segments, segments_num, NULL);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sends IPC message with reference counted data to client           *
+ *                                                                            *
+ * Parameters: client - [IN] the IPC client                                   *
+ *             code   - [IN] the message code                                 *
+ *             buffer - [IN] the message data                                 *
+ *                                                                            *
+ * Comments: If the message must be queued, the buffer is referenced instead  *
+ *           of copying its data, so the same buffer can be sent to several   *
+ *           clients. The caller must release its own buffer reference.       *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_ipc_client_send_buffer(zbx_ipc_client_t *client, zbx_uint32_t code, zbx_ipc_buffer_t *buffer)
+{
+	zbx_ipc_data_t	segment = {.data = buffer->data, .size = buffer->size};
+
+	return ipc_client_send(client, code, &segment, 1, buffer);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: closes client socket and frees resources allocated for client     *
@@ -705,6 +705,56 @@ out:
 #define SMTP_SECURITY_STARTTLS	1
 #define SMTP_SECURITY_SSL	2
 
+#ifdef HAVE_LIBCURL
+/* SMTP sessions are kept open between emails in cURL handle connection cache */
+#define SMTP_SESSION_IDLE_TIMEOUT	60
+#define SMTP_SESSIONS_MAX		10
+
+static CURL	*smtp_easyhandle = NULL;
+static time_t	smtp_easyhandle_lastuse;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets cURL handle for sending email, reusing the handle of         *
+ *          previous emails to reuse its open SMTP sessions                   *
+ *                                                                            *
+ * Return value: cURL handle or NULL if handle cannot be initialized          *
+ *                                                                            *
+ * Comments: The handle with all its sessions is discarded if it has not been *
+ *           used for SMTP_SESSION_IDLE_TIMEOUT seconds.                      *
+ *                                                                            *
+ ******************************************************************************/
+static CURL	*smtp_easyhandle_get(void)
+{
+	time_t	now = time(NULL);
+
+	if (NULL != smtp_easyhandle && SMTP_SESSION_IDLE_TIMEOUT < now - smtp_easyhandle_lastuse)
+	{
+		curl_easy_cleanup(smtp_easyhandle);
+		smtp_easyhandle = NULL;
+	}
+
+	if (NULL == smtp_easyhandle)
+		smtp_easyhandle = curl_easy_init();
+
+	smtp_easyhandle_lastuse = now;
+
+	return smtp_easyhandle;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: resets options of cURL handle after sending email, keeping the    *
+ *          open SMTP sessions                                                *
+ *                                                                            *
+ ******************************************************************************/
+static void	smtp_easyhandle_release(CURL *easyhandle)
+{
+	curl_easy_reset(easyhandle);
+	smtp_easyhandle_lastuse = time(NULL);
+}
+#endif
+
 static int	send_email_curl(const char *smtp_server, unsigned short smtp_port, const char *smtp_helo,
 		zbx_vector_ptr_t *from_mails, zbx_vector_ptr_t *to_mails, const char *inreplyto,
 		const char *mailsubject, const char *mailbody, unsigned char smtp_security, unsigned char
@@ -727,7 +777,7 @@ static int	send_email_curl(const char *smtp_server, unsigned short smtp_port, co
 	if (SMTP_AUTHENTICATION_NONE != smtp_authentication && SUCCEED != zbx_curl_has_smtp_auth(error))
 		goto out;
 
-	if (NULL == (easyhandle = curl_easy_init()))
+	if (NULL == (easyhandle = smtp_easyhandle_get()))
 	{
 		*error = zbx_strdup(*error, "cannot initialize cURL library");
 		goto out;
@@ -785,6 +835,13 @@ static int	send_email_curl(const char *smtp_server, unsigned short smtp_port, co
 	if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_URL, url)))
 		goto error;
 
+	if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_MAXCONNECTS, (long)SMTP_SESSIONS_MAX)))
+		goto error;
+#if LIBCURL_VERSION_NUM >= 0x074100
+	if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_MAXAGE_CONN, (long)SMTP_SESSION_IDLE_TIMEOUT)))
+		goto error;
+#endif
+
 	if (SMTP_SECURITY_NONE != smtp_security)
 	{
 		if (CURLE_OK != (err = curl_easy_setopt(easyhandle, CURLOPT_SSL_VERIFYPEER,
@@ -878,15 +935,26 @@ static int	send_email_curl(const char *smtp_server, unsigned short smtp_port, co
 		goto clean;
 	}
 
+	if (SUCCEED == ZBX_CHECK_LOG_LEVEL(LOG_LEVEL_DEBUG))
+	{
+		long	connects = 0;
+
+		(void)curl_easy_getinfo(easyhandle, CURLINFO_NUM_CONNECTS, &connects);
+		zabbix_log(LOG_LEVEL_DEBUG, "%s() email sent using %s SMTP session", __func__,
+				0 == connects ? "existing" : "new");
+	}
+
 	ret = SUCCEED;
 	goto clean;
 error:
 	*error = zbx_strdup(*error, curl_easy_strerror(err));
 clean:
+	/* options referring to local data must be reset before freeing it */
+	smtp_easyhandle_release(easyhandle);
+
 	zbx_free(payload_status.payload);
 
 	curl_slist_free_all(recipients);
-	curl_easy_cleanup(easyhandle);
 out:
 	return ret;
 #else
@@ -985,6 +1053,11 @@ clean:
 #undef SMTP_SECURITY_STARTTLS
 #undef SMTP_SECURITY_SSL
 
+#ifdef HAVE_LIBCURL
+#undef SMTP_SESSION_IDLE_TIMEOUT
+#undef SMTP_SESSIONS_MAX
+#endif
+
 char	*zbx_email_make_body(const char *message, unsigned char message_format,  const char *attachment_name,
 		const char *attachment_type, const char *attachment, size_t attachment_size)
 {
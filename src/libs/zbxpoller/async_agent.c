@@ -49,6 +49,72 @@ static const char	*get_agent_step_string(zbx_zabbix_agent_step_t step)
 	}
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: distributes values of multiple keys received over the same        *
+ *          connection between item contexts                                  *
+ *                                                                            *
+ * Parameters: agent_context - [IN/OUT] context that owns the connection      *
+ *                                                                            *
+ * Return value: result code of the context that owns the connection          *
+ *                                                                            *
+ ******************************************************************************/
+static int	agent_handle_bulk_response(zbx_agent_context *agent_context)
+{
+	AGENT_RESULT	**results;
+	int		*rets, num = agent_context->bulk_num + 1, ret;
+	char		*error = NULL;
+
+	results = (AGENT_RESULT **)zbx_malloc(NULL, sizeof(AGENT_RESULT *) * (size_t)num);
+	rets = (int *)zbx_malloc(NULL, sizeof(int) * (size_t)num);
+
+	results[0] = &agent_context->item.result;
+
+	for (int i = 0; i < agent_context->bulk_num; i++)
+		results[i + 1] = &agent_context->bulk[i]->item.result;
+
+	switch (ret = zbx_agent_handle_bulk_response(agent_context->s.buffer,
+			agent_context->s.read_bytes + agent_context->tcp_recv_context.offset,
+			agent_context->item.interface.addr, results, rets, &num, &agent_context->item.version, &error))
+	{
+		case SUCCEED:
+			for (int i = 0; i < agent_context->bulk_num; i++)
+			{
+				zbx_agent_context	*bulk_context = agent_context->bulk[i];
+
+				bulk_context->item.version = agent_context->item.version;
+
+				if (i + 1 < num)
+				{
+					bulk_context->item.ret = rets[i + 1];
+					bulk_context->bulk_resolved = 1;
+				}
+			}
+
+			zabbix_log(LOG_LEVEL_DEBUG, "%s() itemid:" ZBX_FS_UI64 " received %d of %d values", __func__,
+					agent_context->item.itemid, num, agent_context->bulk_num + 1);
+
+			/* agents that do not support multiple keys per request return the first value only */
+			agent_context->bulk_retry = 1;
+			agent_context->bulk_supported = (num == agent_context->bulk_num + 1 ? 1 : 0);
+			ret = rets[0];
+			break;
+		case FAIL:
+			/* agent does not support current protocol, request bulk items one by one */
+			agent_context->bulk_retry = 1;
+			agent_context->bulk_supported = 0;
+			break;
+		default:
+			SET_MSG_RESULT(&agent_context->item.result, error);
+			break;
+	}
+
+	zbx_free(rets);
+	zbx_free(results);
+
+	return ret;
+}
+
 static int	agent_task_process(short event, void *data, int *fd, const char *addr, char *dnserr,
 		struct event *timeout_event)
 {
@@ -135,7 +201,7 @@ static int	agent_task_process(short event, void *data, int *fd, const char *addr
 			/* initialization */
 			agent_context->step = ZABBIX_AGENT_STEP_CONNECT_WAIT;
 
-			if (ZBX_COMPONENT_VERSION(7, 0, 0) <= agent_context->item.version)
+			if (ZBX_AGENT_JSON_PROTOCOL_VERSION <= agent_context->item.version)
 			{
 				zbx_tcp_send_context_init(agent_context->j.buffer, agent_context->j.buffer_size, 0,
 						ZBX_TCP_PROTOCOL, &agent_context->tcp_send_context);
@@ -265,11 +331,21 @@ static int	agent_task_process(short event, void *data, int *fd, const char *addr
 				}
 			}
 
-			if (FAIL == (agent_context->item.ret = zbx_agent_handle_response(
-					agent_context->s.buffer, agent_context->s.read_bytes,
-					agent_context->s.read_bytes + agent_context->tcp_recv_context.offset,
-					agent_context->item.interface.addr, &agent_context->item.result,
-					&agent_context->item.version)))
+			if (0 != agent_context->bulk_num &&
+					ZBX_AGENT_JSON_PROTOCOL_VERSION <= agent_context->item.version)
+			{
+				agent_context->item.ret = agent_handle_bulk_response(agent_context);
+			}
+			else
+			{
+				agent_context->item.ret = zbx_agent_handle_response(agent_context->s.buffer,
+						agent_context->s.read_bytes,
+						agent_context->s.read_bytes + agent_context->tcp_recv_context.offset,
+						agent_context->item.interface.addr, &agent_context->item.result,
+						&agent_context->item.version);
+			}
+
+			if (FAIL == agent_context->item.ret)
 			{
 				/* retry with other protocol */
 				agent_context->step = ZABBIX_AGENT_STEP_CONNECT_INIT;
@@ -302,15 +378,15 @@ void	zbx_async_check_agent_clean(zbx_agent_context *agent_context)
 	zbx_free(agent_context->tls_arg1);
 	zbx_free(agent_context->tls_arg2);
 	zbx_free(agent_context->reverse_dns);
+	zbx_free(agent_context->bulk);
 	zbx_free_agent_result(&agent_context->item.result);
 }
 
-int	zbx_async_check_agent(zbx_dc_item_t *item, AGENT_RESULT *result,  zbx_async_task_clear_cb_t clear_cb,
-		void *arg, void *arg_action, struct event_base *base, struct evdns_base *dnsbase,
-		const char *config_source_ip, zbx_async_resolve_reverse_dns_t resolve_reverse_dns)
+static zbx_agent_context	*agent_context_create(zbx_dc_item_t *item, AGENT_RESULT *result, void *arg,
+		void *arg_action, const char *config_source_ip, zbx_async_resolve_reverse_dns_t resolve_reverse_dns,
+		int *ret)
 {
 	zbx_agent_context	*agent_context = zbx_malloc(NULL, sizeof(zbx_agent_context));
-	int			ret = NOTSUPPORTED;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() key:'%s' host:'%s' addr:'%s'  conn:'%s'", __func__, item->key,
 			item->host.host, item->interface.addr, zbx_tcp_connection_type_name(item->host.tls_connect));
@@ -339,6 +415,12 @@ int	zbx_async_check_agent(zbx_dc_item_t *item, AGENT_RESULT *result,  zbx_async_
 	agent_context->rdns_step = ZABBIX_ASYNC_STEP_DEFAULT;
 	agent_context->reverse_dns = NULL;
 
+	agent_context->bulk = NULL;
+	agent_context->bulk_num = 0;
+	agent_context->bulk_resolved = 0;
+	agent_context->bulk_retry = 0;
+	agent_context->bulk_supported = -1;
+
 	agent_context->tls_connect = item->host.tls_connect;
 	zbx_strlcpy(agent_context->item.host, item->host.host, sizeof(agent_context->item.host));
 
@@ -370,7 +452,7 @@ int	zbx_async_check_agent(zbx_dc_item_t *item, AGENT_RESULT *result,  zbx_async_
 		case ZBX_TCP_SEC_TLS_PSK:
 			SET_MSG_RESULT(result, zbx_dsprintf(NULL, "A TLS connection is configured to be used with agent"
 					" but support for TLS was not compiled in"));
-			ret = CONFIG_ERROR;
+			*ret = CONFIG_ERROR;
 			agent_context->tls_arg1 = NULL;
 			agent_context->tls_arg2 = NULL;
 			goto out;
@@ -378,7 +460,7 @@ int	zbx_async_check_agent(zbx_dc_item_t *item, AGENT_RESULT *result,  zbx_async_
 		default:
 			THIS_SHOULD_NEVER_HAPPEN;
 			SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid TLS connection parameters."));
-			ret = CONFIG_ERROR;
+			*ret = CONFIG_ERROR;
 			agent_context->tls_arg1 = NULL;
 			agent_context->tls_arg2 = NULL;
 			goto out;
@@ -390,21 +472,146 @@ int	zbx_async_check_agent(zbx_dc_item_t *item, AGENT_RESULT *result,  zbx_async_
 		agent_context->server_name = NULL;
 #endif
 
-	if (ZBX_COMPONENT_VERSION(7, 0, 0) <= agent_context->item.version)
+	if (ZBX_AGENT_JSON_PROTOCOL_VERSION <= agent_context->item.version)
 		zbx_agent_prepare_request(&agent_context->j, agent_context->item.key, item->timeout);
 
 	agent_context->step = ZABBIX_AGENT_STEP_CONNECT_INIT;
+	*ret = SUCCEED;
 
-	zbx_async_poller_add_task(base, dnsbase, agent_context->item.interface.addr, agent_context, item->timeout + 1,
-			agent_task_process, clear_cb);
-
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(SUCCEED));
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(*ret));
 
-	return SUCCEED;
+	return agent_context;
 out:
 	zbx_async_check_agent_clean(agent_context);
 	zbx_free(agent_context);
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(*ret));
 
-	return ret;
+	return NULL;
+}
+
+int	zbx_async_check_agent(zbx_dc_item_t *item, AGENT_RESULT *result,  zbx_async_task_clear_cb_t clear_cb,
+		void *arg, void *arg_action, struct event_base *base, struct evdns_base *dnsbase,
+		const char *config_source_ip, zbx_async_resolve_reverse_dns_t resolve_reverse_dns)
+{
+	zbx_agent_context	*agent_context;
+	int			ret;
+
+	if (NULL == (agent_context = agent_context_create(item, result, arg, arg_action, config_source_ip,
+			resolve_reverse_dns, &ret)))
+	{
+		return ret;
+	}
+
+	zbx_async_poller_add_task(base, dnsbase, agent_context->item.interface.addr, agent_context, item->timeout + 1,
+			agent_task_process, clear_cb);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: requests values of multiple items of the same interface over      *
+ *          single connection                                                 *
+ *                                                                            *
+ * Parameters: items      - [IN] items                                        *
+ *             results    - [OUT] results, set for items failed to be queued  *
+ *             errcodes   - [OUT] error codes                                 *
+ *             indexes    - [IN] indexes of items of the same interface to    *
+ *                               request                                      *
+ *             num        - [IN] number of indexes                            *
+ *             ...        - [IN] see zbx_async_check_agent()                  *
+ *                                                                            *
+ * Comments: Values of all items are sent to agent in one request, values not *
+ *           returned by agent (older agents return only the first value) are *
+ *           requested again separately, see                                  *
+ *           zbx_async_check_agent_bulk_requeue().                            *
+ *           The callback is called for the context owning the connection,    *
+ *           which is responsible for finishing attached bulk contexts.       *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_async_check_agent_bulk(zbx_dc_item_t *items, AGENT_RESULT *results, int *errcodes, const int *indexes,
+		int num, zbx_async_task_clear_cb_t clear_cb, void *arg, void *arg_action, struct event_base *base,
+		struct evdns_base *dnsbase, const char *config_source_ip)
+{
+	zbx_agent_context	*agent_context = NULL;
+	int			timeout = 0;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() num:%d", __func__, num);
+
+	for (int i = 0; i < num; i++)
+	{
+		zbx_agent_context	*context;
+		zbx_dc_item_t		*item = &items[indexes[i]];
+
+		if (NULL == (context = agent_context_create(item, &results[indexes[i]], arg, arg_action,
+				config_source_ip, ZABBIX_ASYNC_RESOLVE_REVERSE_DNS_NO, &errcodes[indexes[i]])))
+		{
+			continue;
+		}
+
+		timeout += item->timeout;
+
+		if (NULL == agent_context)
+		{
+			agent_context = context;
+			agent_context->bulk = (zbx_agent_context **)zbx_malloc(NULL,
+					sizeof(zbx_agent_context *) * (size_t)(num - 1));
+			continue;
+		}
+
+		agent_context->bulk[agent_context->bulk_num++] = context;
+
+		if (ZBX_AGENT_JSON_PROTOCOL_VERSION <= agent_context->item.version)
+			zbx_agent_prepare_request_add(&agent_context->j, context->item.key, item->timeout);
+	}
+
+	if (NULL != agent_context)
+	{
+		zbx_async_poller_add_task(base, dnsbase, agent_context->item.interface.addr, agent_context,
+				timeout + 1, agent_task_process, clear_cb);
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: finishes item context attached to the context that owned the      *
+ *          connection                                                        *
+ *                                                                            *
+ * Parameters: agent_context - [IN] context that owned the connection         *
+ *             bulk_context  - [IN/OUT] attached item context                 *
+ *             clear_cb      - [IN] callback for separate request             *
+ *             base          - [IN]                                           *
+ *             dnsbase       - [IN]                                           *
+ *                                                                            *
+ * Return value: SUCCEED - value was not returned by agent, item was queued   *
+ *                         for separate request and will be finished by       *
+ *                         clear callback                                     *
+ *               FAIL    - item result is set and must be processed by caller *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_async_check_agent_bulk_requeue(zbx_agent_context *agent_context, zbx_agent_context *bulk_context,
+		zbx_async_task_clear_cb_t clear_cb, struct event_base *base, struct evdns_base *dnsbase)
+{
+	if (0 != bulk_context->bulk_resolved)
+		return FAIL;
+
+	if (0 != agent_context->bulk_retry || SUCCEED == agent_context->item.ret)
+	{
+		bulk_context->item.version = agent_context->item.version;
+		bulk_context->step = ZABBIX_AGENT_STEP_CONNECT_INIT;
+
+		zbx_async_poller_add_task(base, dnsbase, bulk_context->item.interface.addr, bulk_context,
+				bulk_context->config_timeout + 1, agent_task_process, clear_cb);
+
+		return SUCCEED;
+	}
+
+	/* connection failed, the error applies to all items requested over it */
+	bulk_context->item.ret = agent_context->item.ret;
+	SET_MSG_RESULT(&bulk_context->item.result, zbx_strdup(NULL,
+			ZBX_NULL2EMPTY_STR(agent_context->item.result.msg)));
+
+	return FAIL;
 }
@@ -43,8 +43,11 @@
 #include "zbxtime.h"
 #include "zbxtypes.h"
 #include "zbxasyncpoller.h"
+#include "zbxagentget.h"
+#include "zbxdiag.h"
 
 #include <event2/dns.h>
+#include <sys/mman.h>
 
 #ifndef EVDNS_BASE_INITIALIZE_NAMESERVERS
 #	define EVDNS_BASE_INITIALIZE_NAMESERVERS	1
@@ -121,11 +124,229 @@ static void	process_async_result(zbx_dc_item_context_t *item, zbx_poller_config_
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(item->ret));
 }
 
+/* time after which interface not returning multiple values per request is checked again, */
+/* for example after agent upgrade                                                        */
+#define ASYNC_AGENT_BULK_RECHECK	SEC_PER_HOUR
+/* time after which state of interfaces without multiple value requests is forgotten */
+#define ASYNC_AGENT_INTERFACE_TTL	SEC_PER_DAY
+
+typedef struct
+{
+	zbx_uint64_t	interfaceid;
+	int		bulk_supported;
+	time_t		lastcheck;
+}
+zbx_async_agent_interface_t;
+
+static zbx_async_agent_stats_t	*agent_stats;
+static int			agent_stats_num;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: allocates shared agent poller statistics                          *
+ *                                                                            *
+ * Parameters: pollers_num - [IN] number of agent pollers                     *
+ *             error       - [OUT] error message                              *
+ *                                                                            *
+ * Return value: SUCCEED - the statistics were allocated                      *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: Must be called by the main process before forking. Each agent    *
+ *           poller updates its own slot, diagnostic information sums them.   *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_async_agent_stats_init(int pollers_num, char **error)
+{
+	void	*addr;
+
+	if (0 == pollers_num)
+		return SUCCEED;
+
+	if (MAP_FAILED == (addr = mmap(NULL, sizeof(zbx_async_agent_stats_t) * (size_t)pollers_num,
+			PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0)))
+	{
+		*error = zbx_dsprintf(NULL, "cannot allocate agent poller statistics: %s", zbx_strerror(errno));
+		return FAIL;
+	}
+
+	agent_stats = (zbx_async_agent_stats_t *)addr;
+	agent_stats_num = pollers_num;
+
+	return SUCCEED;
+}
+
+static zbx_async_agent_stats_t	*async_agent_stats_get(unsigned char poller_type, int process_num)
+{
+	static zbx_async_agent_stats_t	stats_local;
+
+	if (ZBX_POLLER_TYPE_AGENT != poller_type || NULL == agent_stats || agent_stats_num < process_num)
+		return &stats_local;
+
+	return &agent_stats[process_num - 1];
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds agent poller connection statistics to diagnostic             *
+ *          information                                                       *
+ *                                                                            *
+ * Parameters: json    - [IN/OUT] the json to update                          *
+ *             section - [IN] diagnostic section name                         *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_async_agent_add_diag_info(struct zbx_json *json, const char *section)
+{
+	zbx_async_agent_stats_t	total = {0};
+
+	for (int i = 0; i < agent_stats_num; i++)
+	{
+		const zbx_async_agent_stats_t	*stats = &agent_stats[i];
+
+		total.requests += stats->requests;
+		total.items += stats->items;
+		total.bulk_requests += stats->bulk_requests;
+		total.bulk_items += stats->bulk_items;
+		total.bulk_retries += stats->bulk_retries;
+		total.interfaces_bulk += stats->interfaces_bulk;
+		total.interfaces_single += stats->interfaces_single;
+	}
+
+	zbx_json_addobject(json, section);
+	zbx_json_addint64(json, "pollers", agent_stats_num);
+	zbx_json_adduint64(json, "requests", total.requests);
+	zbx_json_adduint64(json, "items", total.items);
+	zbx_json_adduint64(json, "bulk.requests", total.bulk_requests);
+	zbx_json_adduint64(json, "bulk.items", total.bulk_items);
+	zbx_json_adduint64(json, "bulk.retries", total.bulk_retries);
+	zbx_json_addint64(json, "interfaces.bulk", total.interfaces_bulk);
+	zbx_json_addint64(json, "interfaces.single", total.interfaces_single);
+	zbx_json_close(json);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if multiple values can be requested from interface over    *
+ *          one connection                                                    *
+ *                                                                            *
+ * Comments: Interfaces are probed with multiple value request first. If      *
+ *           agent returns only the first value, single value requests are    *
+ *           used until the check is repeated after ASYNC_AGENT_BULK_RECHECK. *
+ *                                                                            *
+ ******************************************************************************/
+static int	async_agent_bulk_allowed(zbx_poller_config_t *poller_config, const zbx_dc_item_t *item, time_t now)
+{
+	zbx_async_agent_interface_t	*interface;
+
+	if (ZBX_AGENT_JSON_PROTOCOL_VERSION > item->interface.version)
+		return FAIL;
+
+	if (NULL == (interface = (zbx_async_agent_interface_t *)zbx_hashset_search(&poller_config->agent_interfaces,
+			&item->interface.interfaceid)))
+	{
+		return SUCCEED;
+	}
+
+	if (0 != interface->bulk_supported || interface->lastcheck + ASYNC_AGENT_BULK_RECHECK <= now)
+		return SUCCEED;
+
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remembers if agent returned all values requested over one         *
+ *          connection                                                        *
+ *                                                                            *
+ ******************************************************************************/
+static void	async_agent_bulk_update(zbx_poller_config_t *poller_config, zbx_uint64_t interfaceid,
+		int bulk_supported)
+{
+	zbx_async_agent_interface_t	*interface;
+	zbx_async_agent_stats_t		*stats = poller_config->agent_stats;
+
+	if (NULL == (interface = (zbx_async_agent_interface_t *)zbx_hashset_search(&poller_config->agent_interfaces,
+			&interfaceid)))
+	{
+		zbx_async_agent_interface_t	interface_local = {.interfaceid = interfaceid,
+							.bulk_supported = bulk_supported};
+
+		interface = (zbx_async_agent_interface_t *)zbx_hashset_insert(&poller_config->agent_interfaces,
+				&interface_local, sizeof(interface_local));
+
+		if (0 != bulk_supported)
+			stats->interfaces_bulk++;
+		else
+			stats->interfaces_single++;
+	}
+	else if (interface->bulk_supported != bulk_supported)
+	{
+		if (0 != bulk_supported)
+		{
+			stats->interfaces_single--;
+			stats->interfaces_bulk++;
+		}
+		else
+		{
+			stats->interfaces_bulk--;
+			stats->interfaces_single++;
+		}
+
+		interface->bulk_supported = bulk_supported;
+	}
+
+	interface->lastcheck = time(NULL);
+}
+
+static void	async_agent_interfaces_prune(zbx_poller_config_t *poller_config, time_t now)
+{
+	zbx_hashset_iter_t		iter;
+	zbx_async_agent_interface_t	*interface;
+
+	zbx_hashset_iter_reset(&poller_config->agent_interfaces, &iter);
+
+	while (NULL != (interface = (zbx_async_agent_interface_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (interface->lastcheck + ASYNC_AGENT_INTERFACE_TTL > now)
+			continue;
+
+		if (0 != interface->bulk_supported)
+			poller_config->agent_stats->interfaces_bulk--;
+		else
+			poller_config->agent_stats->interfaces_single--;
+
+		zbx_hashset_iter_remove(&iter);
+	}
+}
+
 static void	process_agent_result(void *data)
 {
 	zbx_agent_context	*agent_context = (zbx_agent_context *)data;
 	zbx_poller_config_t	*poller_config = (zbx_poller_config_t *)agent_context->arg;
 
+	if (0 != agent_context->bulk_num && -1 != agent_context->bulk_supported)
+	{
+		async_agent_bulk_update(poller_config, agent_context->item.interface.interfaceid,
+				agent_context->bulk_supported);
+	}
+
+	for (int i = 0; i < agent_context->bulk_num; i++)
+	{
+		zbx_agent_context	*bulk_context = agent_context->bulk[i];
+
+		if (SUCCEED == zbx_async_check_agent_bulk_requeue(agent_context, bulk_context, process_agent_result,
+				poller_config->base, poller_config->dnsbase))
+		{
+			poller_config->agent_stats->requests++;
+			poller_config->agent_stats->bulk_retries++;
+			continue;
+		}
+
+		process_async_result(&bulk_context->item, poller_config);
+
+		zbx_async_check_agent_clean(bulk_context);
+		zbx_free(bulk_context);
+	}
+
 	process_async_result(&agent_context->item, poller_config);
 
 	zbx_async_check_agent_clean(agent_context);
@@ -219,6 +440,112 @@ static void	async_wake(evutil_socket_t fd, short events, void *arg)
 	ZBX_UNUSED(arg);
 }
 
+#define ASYNC_POLLER_PREPROC_FLUSH_DELAY	0.1
+
+#define ASYNC_AGENT_BULK_MAX		16
+#define ASYNC_AGENT_BULK_TIMEOUT_MAX	30
+
+typedef struct
+{
+	zbx_uint64_t	interfaceid;
+	int		indexes[ASYNC_AGENT_BULK_MAX];
+	int		num;
+	int		timeout;
+}
+zbx_async_agent_bulk_t;
+
+static void	async_check_agent_bulk(zbx_poller_config_t *poller_config, zbx_dc_item_t *items,
+		AGENT_RESULT *results, int *errcodes, zbx_async_agent_bulk_t *bulk)
+{
+	if (1 == bulk->num)
+	{
+		int	i = bulk->indexes[0];
+
+		errcodes[i] = zbx_async_check_agent(&items[i], &results[i], process_agent_result, poller_config,
+				poller_config, poller_config->base, poller_config->dnsbase,
+				poller_config->config_source_ip, ZABBIX_ASYNC_RESOLVE_REVERSE_DNS_NO);
+	}
+	else
+	{
+		zbx_async_check_agent_bulk(items, results, errcodes, bulk->indexes, bulk->num, process_agent_result,
+				poller_config, poller_config, poller_config->base, poller_config->dnsbase,
+				poller_config->config_source_ip);
+
+		poller_config->agent_stats->bulk_requests++;
+		poller_config->agent_stats->bulk_items += (zbx_uint64_t)bulk->num;
+	}
+
+	poller_config->agent_stats->requests++;
+	poller_config->agent_stats->items += (zbx_uint64_t)bulk->num;
+
+	for (int i = 0; i < bulk->num; i++)
+	{
+		if (SUCCEED == errcodes[bulk->indexes[i]])
+			poller_config->processing++;
+	}
+
+	bulk->num = 0;
+	bulk->timeout = 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: initiates agent checks, requesting items of the same interface    *
+ *          over single connection when agent supports it                     *
+ *                                                                            *
+ ******************************************************************************/
+static void	async_check_agent_items(zbx_poller_config_t *poller_config, zbx_dc_item_t *items,
+		AGENT_RESULT *results, int *errcodes, int num)
+{
+	zbx_hashset_t		bulks;
+	zbx_hashset_iter_t	iter;
+	zbx_async_agent_bulk_t	*bulk;
+	time_t			now = time(NULL);
+
+	zbx_hashset_create(&bulks, (size_t)num, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+	for (int i = 0; i < num; i++)
+	{
+		if (SUCCEED != errcodes[i] || ITEM_TYPE_ZABBIX != items[i].type)
+			continue;
+
+		if (SUCCEED != async_agent_bulk_allowed(poller_config, &items[i], now))
+		{
+			zbx_async_agent_bulk_t	bulk_local = {.indexes = {i}, .num = 1};
+
+			async_check_agent_bulk(poller_config, items, results, errcodes, &bulk_local);
+			continue;
+		}
+
+		if (NULL == (bulk = (zbx_async_agent_bulk_t *)zbx_hashset_search(&bulks,
+				&items[i].interface.interfaceid)))
+		{
+			zbx_async_agent_bulk_t	bulk_local = {.interfaceid = items[i].interface.interfaceid};
+
+			bulk = (zbx_async_agent_bulk_t *)zbx_hashset_insert(&bulks, &bulk_local, sizeof(bulk_local));
+		}
+
+		if (0 != bulk->num && ASYNC_AGENT_BULK_TIMEOUT_MAX < bulk->timeout + items[i].timeout)
+			async_check_agent_bulk(poller_config, items, results, errcodes, bulk);
+
+		bulk->indexes[bulk->num++] = i;
+		bulk->timeout += items[i].timeout;
+
+		if (ASYNC_AGENT_BULK_MAX == bulk->num)
+			async_check_agent_bulk(poller_config, items, results, errcodes, bulk);
+	}
+
+	zbx_hashset_iter_reset(&bulks, &iter);
+
+	while (NULL != (bulk = (zbx_async_agent_bulk_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (0 != bulk->num)
+			async_check_agent_bulk(poller_config, items, results, errcodes, bulk);
+	}
+
+	zbx_hashset_destroy(&bulks);
+}
+
 static void	async_initiate_queued_checks(zbx_poller_config_t *poller_config, const char *zbx_progname)
 {
 	zbx_dc_item_t			*items = NULL;
@@ -283,10 +610,8 @@ static void	async_initiate_queued_checks(zbx_poller_config_t *poller_config, con
 			}
 			else if (ITEM_TYPE_ZABBIX == items[i].type)
 			{
-				errcodes[i] = zbx_async_check_agent(&items[i], &results[i], process_agent_result,
-						poller_config, poller_config, poller_config->base,
-						poller_config->dnsbase, poller_config->config_source_ip,
-						ZABBIX_ASYNC_RESOLVE_REVERSE_DNS_NO);
+				/* agent checks are initiated below, grouped by interface */
+				continue;
 			}
 			else
 			{
@@ -308,6 +633,8 @@ static void	async_initiate_queued_checks(zbx_poller_config_t *poller_config, con
 				poller_config->processing++;
 		}
 
+		async_check_agent_items(poller_config, items, results, errcodes, num);
+
 		zbx_timespec(&timespec);
 
 		/* process item values */
@@ -356,6 +683,40 @@ static void	async_timer(evutil_socket_t fd, short events, void *arg)
 		zbx_async_manager_queue_sync(poller_config->manager);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sends cached values to preprocessing manager when the oldest one  *
+ *          is waiting long enough, otherwise arms the flush timer            *
+ *                                                                            *
+ * Comments: Results arrive one by one as checks finish, they are sent to     *
+ *           preprocessing in batches. The same timer event is rescheduled,   *
+ *           so at most one flush timeout is pending.                         *
+ *                                                                            *
+ ******************************************************************************/
+static void	async_preproc_flush(zbx_poller_config_t *poller_config)
+{
+	double		flush_delay;
+	struct timeval	tv;
+
+	if (0 >= (flush_delay = zbx_preprocessor_flush_delayed(ASYNC_POLLER_PREPROC_FLUSH_DELAY)))
+		return;
+
+	if (0 != evtimer_pending(poller_config->preproc_flush_timer, NULL))
+		return;
+
+	tv.tv_sec = 0;
+	tv.tv_usec = (suseconds_t)(flush_delay * 1000000);
+	evtimer_add(poller_config->preproc_flush_timer, &tv);
+}
+
+static void	async_preproc_flush_timer(evutil_socket_t fd, short events, void *arg)
+{
+	ZBX_UNUSED(fd);
+	ZBX_UNUSED(events);
+
+	async_preproc_flush((zbx_poller_config_t *)arg);
+}
+
 static void	async_poller_init(zbx_poller_config_t *poller_config, zbx_thread_poller_args *poller_args_in,
 		int process_num)
 {
@@ -367,6 +728,8 @@ static void	async_poller_init(zbx_poller_config_t *poller_config, zbx_thread_pol
 	zbx_hashset_create_ext(&poller_config->interfaces, 100, ZBX_DEFAULT_UINT64_HASH_FUNC,
 			ZBX_DEFAULT_UINT64_COMPARE_FUNC, (zbx_clean_func_t)zbx_interface_status_clean,
 			ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	zbx_hashset_create(&poller_config->agent_interfaces, 0, ZBX_DEFAULT_UINT64_HASH_FUNC,
+			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	if (NULL == (poller_config->base = event_base_new()))
 	{
@@ -387,6 +750,7 @@ static void	async_poller_init(zbx_poller_config_t *poller_config, zbx_thread_pol
 			poller_args_in->config_max_concurrent_checks_per_poller;
 	poller_config->clear_cache = 0;
 	poller_config->process_num = process_num;
+	poller_config->agent_stats = async_agent_stats_get(poller_config->poller_type, process_num);
 
 	if (NULL == (poller_config->async_wake_timer = event_new(poller_config->base, -1, EV_PERSIST, async_wake,
 			poller_config)))
@@ -406,6 +770,13 @@ static void	async_poller_init(zbx_poller_config_t *poller_config, zbx_thread_pol
 
 	evtimer_add(poller_config->async_timer, &tv);
 
+	if (NULL == (poller_config->preproc_flush_timer = evtimer_new(poller_config->base, async_preproc_flush_timer,
+			poller_config)))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot create preprocessing flush timer event");
+		exit(EXIT_FAILURE);
+	}
+
 	if (NULL == (poller_config->manager = zbx_async_manager_create(1, async_wake_cb,
 			(void *)poller_config->async_wake_timer, poller_args_in, &error)))
 	{
@@ -462,6 +833,7 @@ static void	async_poller_stop(zbx_poller_config_t *poller_config)
 
 	evtimer_del(poller_config->async_timer);
 	evtimer_del(poller_config->async_wake_timer);
+	evtimer_del(poller_config->preproc_flush_timer);
 	event_base_dispatch(poller_config->base);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
@@ -470,9 +842,11 @@ static void	async_poller_stop(zbx_poller_config_t *poller_config)
 static void	async_poller_destroy(zbx_poller_config_t *poller_config)
 {
 	zbx_async_manager_free(poller_config->manager);
+	event_free(poller_config->preproc_flush_timer);
 	event_base_free(poller_config->base);
 	zbx_hashset_clear(&poller_config->interfaces);
 	zbx_hashset_destroy(&poller_config->interfaces);
+	zbx_hashset_destroy(&poller_config->agent_interfaces);
 }
 
 #ifdef HAVE_LIBCURL
@@ -499,7 +873,7 @@ ZBX_THREAD_ENTRY(zbx_async_poller_thread, args)
 {
 	zbx_thread_poller_args		*poller_args_in = (zbx_thread_poller_args *)(((zbx_thread_args_t *)args)->args);
 
-	time_t				last_stat_time;
+	time_t				last_stat_time, last_agent_interfaces_hk_time;
 #ifdef HAVE_NETSNMP
 	time_t				last_snmp_engineid_hk_time = 0;
 #endif
@@ -524,7 +898,7 @@ ZBX_THREAD_ENTRY(zbx_async_poller_thread, args)
 			server_num, get_process_type_string(process_type), process_num);
 
 	zbx_setproctitle("%s #%d started", get_process_type_string(process_type), process_num);
-	last_stat_time = time(NULL);
+	last_stat_time = last_agent_interfaces_hk_time = time(NULL);
 
 	zbx_rtc_subscribe(process_type, process_num, rtc_msgs, msgs_num, poller_args_in->config_comms->config_timeout,
 			&rtc);
@@ -602,7 +976,7 @@ ZBX_THREAD_ENTRY(zbx_async_poller_thread, args)
 		}
 
 		if (ZBX_IS_RUNNING())
-			zbx_preprocessor_flush();
+			async_preproc_flush(&poller_config);
 
 		if (STAT_INTERVAL <= time(NULL) - last_stat_time)
 		{
@@ -644,6 +1018,12 @@ ZBX_THREAD_ENTRY(zbx_async_poller_thread, args)
 		}
 #undef SNMP_ENGINEID_HK_INTERVAL
 #endif
+		if (ZBX_POLLER_TYPE_AGENT == poller_type && time(NULL) >= SEC_PER_HOUR + last_agent_interfaces_hk_time)
+		{
+			last_agent_interfaces_hk_time = time(NULL);
+			async_agent_interfaces_prune(&poller_config, last_agent_interfaces_hk_time);
+		}
+
 		if (ZBX_POLLER_TYPE_HTTPAGENT != poller_type)
 			zbx_async_dns_update_host_addresses(poller_config.dnsbase);
 	}
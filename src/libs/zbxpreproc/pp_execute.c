@@ -25,6 +25,7 @@
 #include "zbxjson.h"
 #include "zbxnum.h"
 #include "zbxstr.h"
+#include "zbxprof.h"
 
 #ifdef HAVE_LIBXML2
 #	ifndef LIBXML_THREAD_ENABLED
@@ -1259,6 +1260,7 @@ void	pp_execute(zbx_pp_context_t *ctx, zbx_pp_item_preproc_t *preproc, zbx_pp_ca
 		zbx_variant_t		history_value_out, history_none;
 		const zbx_variant_t	*history_value_in;
 		zbx_timespec_t		history_ts;
+		int			ret;
 
 		if (ZBX_VARIANT_ERR == value_out->type && ZBX_PREPROC_VALIDATE_NOT_SUPPORTED != preproc->steps[i].type)
 			break;
@@ -1275,8 +1277,13 @@ void	pp_execute(zbx_pp_context_t *ctx, zbx_pp_item_preproc_t *preproc, zbx_pp_ca
 			history_value_in = &history_none;
 		}
 
-		if (SUCCEED != pp_execute_step(ctx, cache, um_handle, preproc->hostid, preproc->value_type, value_out,
-				ts, preproc->steps + i, history_value_in, &history_value_out, &history_ts, config_source_ip))
+		zbx_prof_probe_start(ZBX_PROF_PROBE_PREPROC_STEP);
+		ret = pp_execute_step(ctx, cache, um_handle, preproc->hostid, preproc->value_type, value_out, ts,
+				preproc->steps + i, history_value_in, &history_value_out, &history_ts,
+				config_source_ip);
+		zbx_prof_probe_end(ZBX_PROF_PROBE_PREPROC_STEP);
+
+		if (SUCCEED != ret)
 		{
 			zbx_variant_copy(&value_raw, value_out);
 
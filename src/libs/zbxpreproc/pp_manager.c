@@ -714,121 +714,6 @@ static void	preprocessor_sync_configuration(zbx_pp_manager_t *manager)
 			manager->items.num_data, old_revision, revision);
 }
 
-/******************************************************************************
- *                                                                            *
- * Purpose: frees resources allocated by preprocessor item value              *
- *                                                                            *
- * Parameters: value - [IN] value to be freed                                 *
- *                                                                            *
- ******************************************************************************/
-static void	preproc_item_value_clear(zbx_preproc_item_value_t *value)
-{
-	zbx_free(value->error);
-	zbx_free(value->ts);
-
-	if (NULL != value->result)
-	{
-		zbx_free_agent_result(value->result);
-		zbx_free(value->result);
-	}
-}
-
-/******************************************************************************
- *                                                                            *
- * Purpose: extract value, timestamp and optional data from preprocessing     *
- *          item value.                                                       *
- *                                                                            *
- * Parameters: value - [IN] preprocessing item value                          *
- *             var   - [OUT] extracted value (including error message)        *
- *             ts    - [OUT] extracted timestamp                              *
- *             opt   - [OUT] extracted optional data                          *
- *                                                                            *
- ******************************************************************************/
-static void	preproc_item_value_extract_data(zbx_preproc_item_value_t *value, zbx_variant_t *var, zbx_timespec_t *ts,
-		zbx_pp_value_opt_t *opt)
-{
-	opt->flags = ZBX_PP_VALUE_OPT_NONE;
-
-	if (NULL != value->ts)
-	{
-		*ts = *value->ts;
-	}
-	else
-	{
-		ts->sec = 0;
-		ts->ns = 0;
-	}
-
-	if (ITEM_STATE_NOTSUPPORTED == value->state)
-	{
-		if (NULL != value->error)
-		{
-			zbx_variant_set_error(var, value->error);
-			value->error = NULL;
-		}
-		else if (NULL != value->result && ZBX_ISSET_MSG(value->result))
-			zbx_variant_set_error(var, zbx_strdup(NULL, value->result->msg));
-		else
-			zbx_variant_set_error(var, zbx_strdup(NULL, "Unknown error."));
-
-		return;
-	}
-
-	if (NULL == value->result)
-	{
-		zbx_variant_set_none(var);
-		return;
-	}
-
-	if (ZBX_ISSET_LOG(value->result))
-	{
-		zbx_variant_set_str(var, value->result->log->value);
-		value->result->log->value = NULL;
-
-		opt->source = value->result->log->source;
-		value->result->log->source = NULL;
-
-		opt->logeventid = value->result->log->logeventid;
-		opt->severity = value->result->log->severity;
-		opt->timestamp = value->result->log->timestamp;
-
-		opt->flags |= ZBX_PP_VALUE_OPT_LOG;
-	}
-	else if (ZBX_ISSET_UI64(value->result))
-	{
-		zbx_variant_set_ui64(var, value->result->ui64);
-	}
-	else if (ZBX_ISSET_DBL(value->result))
-	{
-		zbx_variant_set_dbl(var, value->result->dbl);
-	}
-	else if (ZBX_ISSET_STR(value->result))
-	{
-		zbx_variant_set_str(var, value->result->str);
-		value->result->str = NULL;
-	}
-	else if (ZBX_ISSET_TEXT(value->result))
-	{
-		zbx_variant_set_str(var, value->result->text);
-		value->result->text = NULL;
-	}
-	else if (ZBX_ISSET_BIN(value->result))
-	{
-		THIS_SHOULD_NEVER_HAPPEN;
-		exit(EXIT_FAILURE);
-	}
-	else
-		zbx_variant_set_none(var);
-
-	if (ZBX_ISSET_META(value->result))
-	{
-		opt->lastlogsize = value->result->lastlogsize;
-		opt->mtime = value->result->mtime;
-
-		opt->flags |= ZBX_PP_VALUE_OPT_META;
-	}
-}
-
 /******************************************************************************
  *                                                                            *
  * Purpose: flush preprocessed value                                          *
@@ -862,9 +747,12 @@ static void	preprocessing_flush_value(zbx_pp_manager_t *manager, zbx_uint64_t it
 static zbx_uint64_t	preprocessor_add_request(zbx_pp_manager_t *manager, zbx_ipc_message_t *message,
 		zbx_uint64_t *direct_num)
 {
-	zbx_uint32_t			offset = 0;
-	zbx_preproc_item_value_t	value;
-	zbx_uint64_t			queued_num = 0;
+	zbx_pp_batch_t			batch;
+	zbx_uint64_t			queued_num = 0, itemid;
+	unsigned char			value_type, flags;
+	zbx_variant_t			var;
+	zbx_pp_value_opt_t		var_opt;
+	zbx_timespec_t			ts;
 	zbx_vector_pp_task_ptr_t	tasks;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
@@ -874,32 +762,32 @@ static zbx_uint64_t	preprocessor_add_request(zbx_pp_manager_t *manager, zbx_ipc_
 
 	preprocessor_sync_configuration(manager);
 
-	while (offset < message->size)
+	if (SUCCEED != zbx_preprocessor_unpack_batch(&batch, message->data, message->size))
 	{
-		zbx_variant_t		var;
-		zbx_pp_value_opt_t	var_opt;
-		zbx_timespec_t		ts;
-		zbx_pp_task_t		*task;
+		THIS_SHOULD_NEVER_HAPPEN;
+		batch.values_num = 0;
+	}
 
-		offset += zbx_preprocessor_unpack_value(&value, message->data + offset);
-		preproc_item_value_extract_data(&value, &var, &ts, &var_opt);
+	while (SUCCEED == zbx_preprocessor_batch_next(&batch, &itemid, &value_type, &flags, &var, &ts, &var_opt))
+	{
+		zbx_pp_task_t	*task;
 
-		if (NULL == (task = zbx_pp_manager_create_task(manager, value.itemid, &var, ts, &var_opt)))
+		if (NULL == (task = zbx_pp_manager_create_task(manager, itemid, &var, ts, &var_opt)))
 		{
 			(*direct_num)++;
 			/* allow empty values */
-			preprocessing_flush_value(manager, value.itemid, value.item_value_type, value.item_flags,
-					&var, ts, &var_opt);
+			preprocessing_flush_value(manager, itemid, value_type, flags, &var, ts, &var_opt);
 
 			zbx_variant_clear(&var);
 			zbx_pp_value_opt_clear(&var_opt);
 		}
 		else
 			zbx_vector_pp_task_ptr_append(&tasks, task);
-
-		preproc_item_value_clear(&value);
 	}
 
+	if (batch.index != batch.values_num)
+		THIS_SHOULD_NEVER_HAPPEN;
+
 	if (0 != tasks.values_num)
 		zbx_pp_manager_queue_value_preproc(manager, &tasks);
 
@@ -981,6 +869,7 @@ static void	preprocessor_reply_test_result(zbx_pp_task_t *task)
 	zbx_pp_result_t		*results;
 	int			results_num;
 	zbx_pp_history_t	*history;
+	zbx_ipc_buffer_t	*buffer;
 
 	zbx_pp_test_task_get_data(task, &client, &result, &results, &results_num, &history);
 
@@ -988,8 +877,10 @@ static void	preprocessor_reply_test_result(zbx_pp_task_t *task)
 
 	zbx_pp_test_task_history_release(task, &history);
 
-	zbx_ipc_client_send(client, ZBX_IPC_PREPROCESSOR_TEST_RESULT, data, len);
-	zbx_free(data);
+	/* test results can be large, pass the packed data without copying if it must be queued */
+	buffer = zbx_ipc_buffer_create(data, len);
+	zbx_ipc_client_send_buffer(client, ZBX_IPC_PREPROCESSOR_TEST_RESULT, buffer);
+	zbx_ipc_buffer_release(buffer);
 }
 
 /******************************************************************************
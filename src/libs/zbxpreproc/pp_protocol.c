@@ -29,8 +29,26 @@
 #define PACKED_FIELD(value, size)	\
 		(zbx_packed_field_t){(value), (size), (0 == (size) ? PACKED_FIELD_STRING : PACKED_FIELD_RAW)}
 
-static zbx_ipc_message_t	cached_message;
-static int			cached_values;
+/* values are cached in columns and sent to preprocessing manager in batches */
+#define PP_CACHED_VALUES_MAX		(ZBX_PREPROCESSING_BATCH_SIZE + 1)
+#define PP_CACHED_STRINGS_INIT_SIZE	(64 * ZBX_KIBIBYTE)
+#define PP_CACHED_STRINGS_FLUSH_SIZE	(4 * ZBX_MEBIBYTE)
+
+/* element sizes of item value batch columns, see zbx_pp_batch_column_t */
+static const zbx_uint32_t	pp_batch_column_sizes[ZBX_PP_BATCH_COLUMNS_NUM] = {
+	sizeof(zbx_uint64_t), sizeof(zbx_uint64_t), sizeof(zbx_uint64_t), sizeof(zbx_uint64_t),
+	sizeof(int), sizeof(int), sizeof(int), sizeof(int), sizeof(int), sizeof(int),
+	sizeof(zbx_uint32_t), sizeof(zbx_uint32_t),
+	sizeof(unsigned char), sizeof(unsigned char), sizeof(unsigned char), sizeof(unsigned char)
+};
+
+static unsigned char	*cached_columns[ZBX_PP_BATCH_COLUMNS_NUM];
+static char		*cached_strings;
+static zbx_uint32_t	cached_strings_size, cached_strings_alloc;
+static unsigned char	*cached_data;
+static zbx_uint32_t	cached_data_alloc;
+static int		cached_values;
+static double		cached_time;
 
 ZBX_PTR_VECTOR_IMPL(ipcmsg, zbx_ipc_message_t *)
 
@@ -126,63 +144,205 @@ static zbx_uint32_t	message_pack_data(zbx_ipc_message_t *message, zbx_packed_fie
 
 /******************************************************************************
  *                                                                            *
- * Purpose: pack item value data into a single buffer that can be used in IPC *
+ * Purpose: sets column element of the value being cached                     *
  *                                                                            *
- * Parameters: message - [OUT] IPC message                                    *
- *             value   - [IN] value to be packed                              *
+ ******************************************************************************/
+static void	pp_batch_column_set(zbx_pp_batch_column_t column, int index, const void *value)
+{
+	memcpy(cached_columns[column] + (size_t)index * pp_batch_column_sizes[column], value,
+			pp_batch_column_sizes[column]);
+}
+
+/******************************************************************************
  *                                                                            *
- * Return value: size of packed data                                          *
+ * Purpose: appends string to cached batch strings                            *
+ *                                                                            *
+ * Return value: size of the appended string including terminating zero or 0  *
+ *               if the string is NULL                                        *
  *                                                                            *
  ******************************************************************************/
-static zbx_uint32_t	preprocessor_pack_value(zbx_ipc_message_t *message, zbx_preproc_item_value_t *value)
+static zbx_uint32_t	pp_batch_strings_add(const char *str)
 {
-	zbx_packed_field_t	fields[24], *offset = fields;	/* 24 - max field count */
-	unsigned char		ts_marker, result_marker, log_marker;
+	zbx_uint32_t	size;
 
-	ts_marker = (NULL != value->ts);
-	result_marker = (NULL != value->result);
+	if (NULL == str)
+		return 0;
 
-	*offset++ = PACKED_FIELD(&value->itemid, sizeof(zbx_uint64_t));
-	*offset++ = PACKED_FIELD(&value->hostid, sizeof(zbx_uint64_t));
-	*offset++ = PACKED_FIELD(&value->item_value_type, sizeof(unsigned char));
-	*offset++ = PACKED_FIELD(&value->item_flags, sizeof(unsigned char));
-	*offset++ = PACKED_FIELD(&value->state, sizeof(unsigned char));
-	*offset++ = PACKED_FIELD(value->error, 0);
-	*offset++ = PACKED_FIELD(&ts_marker, sizeof(unsigned char));
+	size = (zbx_uint32_t)strlen(str) + 1;
 
-	if (NULL != value->ts)
+	if (cached_strings_alloc - cached_strings_size < size)
 	{
-		*offset++ = PACKED_FIELD(&value->ts->sec, sizeof(int));
-		*offset++ = PACKED_FIELD(&value->ts->ns, sizeof(int));
+		if (0 == cached_strings_alloc)
+			cached_strings_alloc = PP_CACHED_STRINGS_INIT_SIZE;
+
+		while (cached_strings_alloc - cached_strings_size < size)
+			cached_strings_alloc *= 2;
+
+		cached_strings = (char *)zbx_realloc(cached_strings, cached_strings_alloc);
 	}
 
-	*offset++ = PACKED_FIELD(&result_marker, sizeof(unsigned char));
+	memcpy(cached_strings + cached_strings_size, str, size);
+	cached_strings_size += size;
 
-	if (NULL != value->result)
+	return size;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: caches item value in batch columns                                *
+ *                                                                            *
+ * Parameters: itemid     - [IN]                                              *
+ *             hostid     - [IN]                                              *
+ *             value_type - [IN] item value type                              *
+ *             flags      - [IN] item flags                                   *
+ *             result     - [IN] agent result containing the value, optional  *
+ *             ts         - [IN] value timestamp, optional                    *
+ *             state      - [IN] item state                                   *
+ *             error      - [IN] error message for not supported items        *
+ *                                                                            *
+ * Comments: Only the data used by preprocessing manager is cached - the      *
+ *           value selected from agent result and its log and meta data.      *
+ *                                                                            *
+ ******************************************************************************/
+static void	preprocessor_cache_value(zbx_uint64_t itemid, zbx_uint64_t hostid, unsigned char value_type,
+		unsigned char flags, const AGENT_RESULT *result, const zbx_timespec_t *ts, unsigned char state,
+		const char *error)
+{
+	unsigned char	var_type = ZBX_VARIANT_NONE, opt_flags = ZBX_PP_VALUE_OPT_NONE;
+	const char	*value = NULL, *source = NULL;
+	zbx_uint64_t	numeric = 0, lastlogsize = 0;
+	zbx_uint32_t	value_size, source_size;
+	int		ts_sec = 0, ts_ns = 0, mtime = 0, log_timestamp = 0, log_severity = 0, log_eventid = 0,
+			index = cached_values;
+
+	if (NULL == cached_columns[0])
 	{
+		for (int i = 0; i < ZBX_PP_BATCH_COLUMNS_NUM; i++)
+		{
+			cached_columns[i] = (unsigned char *)zbx_malloc(NULL,
+					(size_t)pp_batch_column_sizes[i] * PP_CACHED_VALUES_MAX);
+		}
+	}
+
+	if (NULL != ts)
+	{
+		ts_sec = ts->sec;
+		ts_ns = ts->ns;
+	}
+
+	if (ITEM_STATE_NOTSUPPORTED == state)
+	{
+		var_type = ZBX_VARIANT_ERR;
+
+		if (NULL != error)
+			value = error;
+		else if (NULL != result && ZBX_ISSET_MSG(result))
+			value = result->msg;
+		else
+			value = "Unknown error.";
+	}
+	else if (NULL != result)
+	{
+		if (ZBX_ISSET_LOG(result))
+		{
+			var_type = ZBX_VARIANT_STR;
+			value = result->log->value;
+			source = result->log->source;
+			log_timestamp = result->log->timestamp;
+			log_severity = result->log->severity;
+			log_eventid = result->log->logeventid;
+			opt_flags |= ZBX_PP_VALUE_OPT_LOG;
+		}
+		else if (ZBX_ISSET_UI64(result))
+		{
+			var_type = ZBX_VARIANT_UI64;
+			numeric = result->ui64;
+		}
+		else if (ZBX_ISSET_DBL(result))
+		{
+			var_type = ZBX_VARIANT_DBL;
+			memcpy(&numeric, &result->dbl, sizeof(numeric));
+		}
+		else if (ZBX_ISSET_STR(result))
+		{
+			var_type = ZBX_VARIANT_STR;
+			value = result->str;
+		}
+		else if (ZBX_ISSET_TEXT(result))
+		{
+			var_type = ZBX_VARIANT_STR;
+			value = result->text;
+		}
 
-		*offset++ = PACKED_FIELD(&value->result->lastlogsize, sizeof(zbx_uint64_t));
-		*offset++ = PACKED_FIELD(&value->result->ui64, sizeof(zbx_uint64_t));
-		*offset++ = PACKED_FIELD(&value->result->dbl, sizeof(double));
-		*offset++ = PACKED_FIELD(value->result->str, 0);
-		*offset++ = PACKED_FIELD(value->result->text, 0);
-		*offset++ = PACKED_FIELD(value->result->msg, 0);
-		*offset++ = PACKED_FIELD(&value->result->type, sizeof(int));
-		*offset++ = PACKED_FIELD(&value->result->mtime, sizeof(int));
-
-		log_marker = (NULL != value->result->log);
-		*offset++ = PACKED_FIELD(&log_marker, sizeof(unsigned char));
-		if (NULL != value->result->log)
+		if (ZBX_ISSET_META(result))
 		{
-			*offset++ = PACKED_FIELD(value->result->log->value, 0);
-			*offset++ = PACKED_FIELD(value->result->log->source, 0);
-			*offset++ = PACKED_FIELD(&value->result->log->timestamp, sizeof(int));
-			*offset++ = PACKED_FIELD(&value->result->log->severity, sizeof(int));
-			*offset++ = PACKED_FIELD(&value->result->log->logeventid, sizeof(int));
+			lastlogsize = result->lastlogsize;
+			mtime = result->mtime;
+			opt_flags |= ZBX_PP_VALUE_OPT_META;
 		}
 	}
 
-	return message_pack_data(message, fields, (int)(offset - fields));
+	value_size = pp_batch_strings_add(value);
+	source_size = pp_batch_strings_add(source);
+
+	pp_batch_column_set(ZBX_PP_BATCH_ITEMID, index, &itemid);
+	pp_batch_column_set(ZBX_PP_BATCH_HOSTID, index, &hostid);
+	pp_batch_column_set(ZBX_PP_BATCH_NUMERIC, index, &numeric);
+	pp_batch_column_set(ZBX_PP_BATCH_LASTLOGSIZE, index, &lastlogsize);
+	pp_batch_column_set(ZBX_PP_BATCH_TS_SEC, index, &ts_sec);
+	pp_batch_column_set(ZBX_PP_BATCH_TS_NS, index, &ts_ns);
+	pp_batch_column_set(ZBX_PP_BATCH_MTIME, index, &mtime);
+	pp_batch_column_set(ZBX_PP_BATCH_LOG_TIMESTAMP, index, &log_timestamp);
+	pp_batch_column_set(ZBX_PP_BATCH_LOG_SEVERITY, index, &log_severity);
+	pp_batch_column_set(ZBX_PP_BATCH_LOG_EVENTID, index, &log_eventid);
+	pp_batch_column_set(ZBX_PP_BATCH_VALUE_SIZE, index, &value_size);
+	pp_batch_column_set(ZBX_PP_BATCH_SOURCE_SIZE, index, &source_size);
+	pp_batch_column_set(ZBX_PP_BATCH_VALUE_TYPE, index, &value_type);
+	pp_batch_column_set(ZBX_PP_BATCH_ITEM_FLAGS, index, &flags);
+	pp_batch_column_set(ZBX_PP_BATCH_VAR_TYPE, index, &var_type);
+	pp_batch_column_set(ZBX_PP_BATCH_OPT_FLAGS, index, &opt_flags);
+
+	cached_values++;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: packs cached item values into batch message data                  *
+ *                                                                            *
+ * Return value: size of packed data                                          *
+ *                                                                            *
+ * Comments: The batch is packed as value count, strings size, the columns    *
+ *           (see zbx_pp_batch_column_t) and the strings. The packed data     *
+ *           buffer is kept for the next batch.                               *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_uint32_t	preprocessor_pack_cached_values(void)
+{
+	zbx_uint32_t	size = 2 * sizeof(zbx_uint32_t) + cached_strings_size, values_num = (zbx_uint32_t)cached_values;
+	unsigned char	*ptr;
+
+	for (int i = 0; i < ZBX_PP_BATCH_COLUMNS_NUM; i++)
+		size += pp_batch_column_sizes[i] * values_num;
+
+	if (cached_data_alloc < size)
+	{
+		cached_data_alloc = size;
+		cached_data = (unsigned char *)zbx_realloc(cached_data, cached_data_alloc);
+	}
+
+	ptr = cached_data;
+	ptr += zbx_serialize_value(ptr, values_num);
+	ptr += zbx_serialize_value(ptr, cached_strings_size);
+
+	for (int i = 0; i < ZBX_PP_BATCH_COLUMNS_NUM; i++)
+	{
+		memcpy(ptr, cached_columns[i], pp_batch_column_sizes[i] * values_num);
+		ptr += pp_batch_column_sizes[i] * values_num;
+	}
+
+	memcpy(ptr, cached_strings, cached_strings_size);
+
+	return size;
 }
 
 /******************************************************************************
@@ -590,72 +750,185 @@ zbx_uint32_t	zbx_preprocessor_pack_top_stats_result(unsigned char **data, zbx_ve
 
 /******************************************************************************
  *                                                                            *
- * Purpose: unpack item value data from IPC data buffer                       *
+ * Purpose: gets column element of the current batch value                    *
  *                                                                            *
- * Parameters: value - [OUT] unpacked item value                              *
- *             data  - [IN]  IPC data buffer                                  *
+ ******************************************************************************/
+static void	pp_batch_column_get(const zbx_pp_batch_t *batch, zbx_pp_batch_column_t column, void *value)
+{
+	memcpy(value, batch->columns[column] + (size_t)batch->index * pp_batch_column_sizes[column],
+			pp_batch_column_sizes[column]);
+}
+
+/******************************************************************************
  *                                                                            *
- * Return value: size of packed data                                          *
+ * Purpose: gets next string from item value batch                            *
+ *                                                                            *
+ * Parameters: batch - [IN/OUT]                                               *
+ *             size  - [IN] string size including terminating zero, 0 if the  *
+ *                          string is not set                                 *
+ *             str   - [OUT] allocated copy of the string or NULL             *
+ *                                                                            *
+ * Return value: SUCCEED - the string was extracted                           *
+ *               FAIL    - the string is out of batch bounds                  *
+ *                                                                            *
+ ******************************************************************************/
+static int	pp_batch_strings_get(zbx_pp_batch_t *batch, zbx_uint32_t size, char **str)
+{
+	if (0 == size)
+	{
+		*str = NULL;
+		return SUCCEED;
+	}
+
+	if (batch->strings_size - batch->strings_offset < size ||
+			'\0' != batch->strings[batch->strings_offset + size - 1])
+	{
+		return FAIL;
+	}
+
+	*str = (char *)zbx_malloc(NULL, size);
+	memcpy(*str, batch->strings + batch->strings_offset, size);
+	batch->strings_offset += size;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: prepares item value batch for unpacking                           *
+ *                                                                            *
+ * Parameters: batch - [OUT]                                                  *
+ *             data  - [IN] IPC data buffer                                   *
+ *             size  - [IN] IPC data buffer size                              *
+ *                                                                            *
+ * Return value: SUCCEED - the batch was prepared                             *
+ *               FAIL    - the data buffer does not contain valid batch       *
+ *                                                                            *
+ * Comments: The batch references the data buffer, the values are unpacked    *
+ *           with zbx_preprocessor_batch_next().                              *
  *                                                                            *
  ******************************************************************************/
-zbx_uint32_t	zbx_preprocessor_unpack_value(zbx_preproc_item_value_t *value, unsigned char *data)
+int	zbx_preprocessor_unpack_batch(zbx_pp_batch_t *batch, const unsigned char *data, zbx_uint32_t size)
 {
-	zbx_uint32_t	value_len;
-	zbx_timespec_t	*timespec = NULL;
-	AGENT_RESULT	*agent_result = NULL;
-	zbx_log_t	*log = NULL;
-	unsigned char	*offset = data, ts_marker, result_marker, log_marker;
-
-	offset += zbx_deserialize_uint64(offset, &value->itemid);
-	offset += zbx_deserialize_uint64(offset, &value->hostid);
-	offset += zbx_deserialize_char(offset, &value->item_value_type);
-	offset += zbx_deserialize_char(offset, &value->item_flags);
-	offset += zbx_deserialize_char(offset, &value->state);
-	offset += zbx_deserialize_str(offset, &value->error, value_len);
-	offset += zbx_deserialize_char(offset, &ts_marker);
-
-	if (0 != ts_marker)
+	const unsigned char	*ptr = data;
+	zbx_uint64_t		columns_size = 0;
+
+	if (2 * sizeof(zbx_uint32_t) > size)
+		return FAIL;
+
+	ptr += zbx_deserialize_value(ptr, &batch->values_num);
+	ptr += zbx_deserialize_value(ptr, &batch->strings_size);
+
+	for (int i = 0; i < ZBX_PP_BATCH_COLUMNS_NUM; i++)
+		columns_size += (zbx_uint64_t)pp_batch_column_sizes[i] * batch->values_num;
+
+	if ((zbx_uint64_t)size - 2 * sizeof(zbx_uint32_t) != columns_size + batch->strings_size)
+		return FAIL;
+
+	for (int i = 0; i < ZBX_PP_BATCH_COLUMNS_NUM; i++)
 	{
-		timespec = (zbx_timespec_t *)zbx_malloc(NULL, sizeof(zbx_timespec_t));
+		batch->columns[i] = ptr;
+		ptr += pp_batch_column_sizes[i] * batch->values_num;
+	}
+
+	batch->strings = (const char *)ptr;
+	batch->strings_offset = 0;
+	batch->index = 0;
 
-		offset += zbx_deserialize_int(offset, &timespec->sec);
-		offset += zbx_deserialize_int(offset, &timespec->ns);
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: unpacks next item value from batch                                *
+ *                                                                            *
+ * Parameters: batch      - [IN/OUT]                                          *
+ *             itemid     - [OUT]                                             *
+ *             value_type - [OUT] item value type                             *
+ *             flags      - [OUT] item flags                                  *
+ *             value      - [OUT] item value (including error message)        *
+ *             ts         - [OUT] value timestamp                             *
+ *             opt        - [OUT] optional value data                         *
+ *                                                                            *
+ * Return value: SUCCEED - the value was unpacked                             *
+ *               FAIL    - there are no more values or the batch is corrupted *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_preprocessor_batch_next(zbx_pp_batch_t *batch, zbx_uint64_t *itemid, unsigned char *value_type,
+		unsigned char *flags, zbx_variant_t *value, zbx_timespec_t *ts, zbx_pp_value_opt_t *opt)
+{
+	unsigned char	var_type, opt_flags;
+	zbx_uint32_t	value_size, source_size;
+	zbx_uint64_t	numeric;
+	double		dbl;
+	char		*str, *source;
+
+	if (batch->index >= batch->values_num)
+		return FAIL;
+
+	pp_batch_column_get(batch, ZBX_PP_BATCH_VALUE_SIZE, &value_size);
+	pp_batch_column_get(batch, ZBX_PP_BATCH_SOURCE_SIZE, &source_size);
+
+	if (SUCCEED != pp_batch_strings_get(batch, value_size, &str))
+		return FAIL;
+
+	if (SUCCEED != pp_batch_strings_get(batch, source_size, &source))
+	{
+		zbx_free(str);
+		return FAIL;
 	}
 
-	value->ts = timespec;
+	pp_batch_column_get(batch, ZBX_PP_BATCH_ITEMID, itemid);
+	pp_batch_column_get(batch, ZBX_PP_BATCH_VALUE_TYPE, value_type);
+	pp_batch_column_get(batch, ZBX_PP_BATCH_ITEM_FLAGS, flags);
+	pp_batch_column_get(batch, ZBX_PP_BATCH_TS_SEC, &ts->sec);
+	pp_batch_column_get(batch, ZBX_PP_BATCH_TS_NS, &ts->ns);
+	pp_batch_column_get(batch, ZBX_PP_BATCH_VAR_TYPE, &var_type);
+	pp_batch_column_get(batch, ZBX_PP_BATCH_OPT_FLAGS, &opt_flags);
+
+	opt->flags = opt_flags;
+	opt->source = source;
 
-	offset += zbx_deserialize_char(offset, &result_marker);
-	if (0 != result_marker)
+	if (0 != (opt_flags & ZBX_PP_VALUE_OPT_LOG))
 	{
-		agent_result = (AGENT_RESULT *)zbx_malloc(NULL, sizeof(AGENT_RESULT));
-
-		offset += zbx_deserialize_uint64(offset, &agent_result->lastlogsize);
-		offset += zbx_deserialize_uint64(offset, &agent_result->ui64);
-		offset += zbx_deserialize_double(offset, &agent_result->dbl);
-		offset += zbx_deserialize_str(offset, &agent_result->str, value_len);
-		offset += zbx_deserialize_str(offset, &agent_result->text, value_len);
-		offset += zbx_deserialize_str(offset, &agent_result->msg, value_len);
-		offset += zbx_deserialize_int(offset, &agent_result->type);
-		offset += zbx_deserialize_int(offset, &agent_result->mtime);
-
-		offset += zbx_deserialize_char(offset, &log_marker);
-		if (0 != log_marker)
-		{
-			log = (zbx_log_t *)zbx_malloc(NULL, sizeof(zbx_log_t));
+		pp_batch_column_get(batch, ZBX_PP_BATCH_LOG_TIMESTAMP, &opt->timestamp);
+		pp_batch_column_get(batch, ZBX_PP_BATCH_LOG_SEVERITY, &opt->severity);
+		pp_batch_column_get(batch, ZBX_PP_BATCH_LOG_EVENTID, &opt->logeventid);
+	}
 
-			offset += zbx_deserialize_str(offset, &log->value, value_len);
-			offset += zbx_deserialize_str(offset, &log->source, value_len);
-			offset += zbx_deserialize_int(offset, &log->timestamp);
-			offset += zbx_deserialize_int(offset, &log->severity);
-			offset += zbx_deserialize_int(offset, &log->logeventid);
-		}
+	if (0 != (opt_flags & ZBX_PP_VALUE_OPT_META))
+	{
+		pp_batch_column_get(batch, ZBX_PP_BATCH_LASTLOGSIZE, &opt->lastlogsize);
+		pp_batch_column_get(batch, ZBX_PP_BATCH_MTIME, &opt->mtime);
+	}
 
-		agent_result->log = log;
+	switch (var_type)
+	{
+		case ZBX_VARIANT_UI64:
+			pp_batch_column_get(batch, ZBX_PP_BATCH_NUMERIC, &numeric);
+			zbx_variant_set_ui64(value, numeric);
+			break;
+		case ZBX_VARIANT_DBL:
+			pp_batch_column_get(batch, ZBX_PP_BATCH_NUMERIC, &numeric);
+			memcpy(&dbl, &numeric, sizeof(dbl));
+			zbx_variant_set_dbl(value, dbl);
+			break;
+		case ZBX_VARIANT_STR:
+			zbx_variant_set_str(value, NULL != str ? str : zbx_strdup(NULL, ""));
+			str = NULL;
+			break;
+		case ZBX_VARIANT_ERR:
+			zbx_variant_set_error(value, NULL != str ? str : zbx_strdup(NULL, "Unknown error."));
+			str = NULL;
+			break;
+		default:
+			zbx_variant_set_none(value);
 	}
 
-	value->result = agent_result;
+	zbx_free(str);
+	batch->index++;
 
-	return (zbx_uint32_t)(offset - data);
+	return SUCCEED;
 }
 
 /******************************************************************************
@@ -804,11 +1077,21 @@ static void	preprocessor_send(zbx_uint32_t code, unsigned char *data, zbx_uint32
 	static zbx_ipc_socket_t	socket = {0};
 
 	/* each process has a permanent connection to preprocessing manager */
-	if (0 == socket.fd && FAIL == zbx_ipc_socket_open(&socket, ZBX_IPC_SERVICE_PREPROCESSING, SEC_PER_MIN,
-			&error))
+	if (0 == socket.fd)
 	{
-		zabbix_log(LOG_LEVEL_CRIT, "cannot connect to preprocessing service: %s", error);
-		exit(EXIT_FAILURE);
+		if (FAIL == zbx_ipc_socket_open(&socket, ZBX_IPC_SERVICE_PREPROCESSING, SEC_PER_MIN, &error))
+		{
+			zabbix_log(LOG_LEVEL_CRIT, "cannot connect to preprocessing service: %s", error);
+			exit(EXIT_FAILURE);
+		}
+
+		/* values are sent through shared memory ring when supported, falling back to socket */
+		if (FAIL == zbx_ipc_socket_enable_shm(&socket, ZBX_MEBIBYTE, &error))
+		{
+			zabbix_log(LOG_LEVEL_DEBUG, "cannot enable shared memory transport for preprocessing service:"
+					" %s", error);
+			zbx_free(error);
+		}
 	}
 
 	if (FAIL == zbx_ipc_socket_write(&socket, code, data, size))
@@ -843,10 +1126,7 @@ static void	preprocessor_send(zbx_uint32_t code, unsigned char *data, zbx_uint32
 void	zbx_preprocess_item_value(zbx_uint64_t itemid, zbx_uint64_t hostid, unsigned char item_value_type,
 		unsigned char item_flags, AGENT_RESULT *result, zbx_timespec_t *ts, unsigned char state, char *error)
 {
-	zbx_preproc_item_value_t	value = {.itemid = itemid, .hostid = hostid, .item_value_type = item_value_type,
-					.error = error, .item_flags = item_flags, .state = state, .ts = ts,
-					.result = result};
-	size_t				value_len = 0, len;
+	size_t	value_len = 0, len;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -875,19 +1155,18 @@ void	zbx_preprocess_item_value(zbx_uint64_t itemid, zbx_uint64_t hostid, unsigne
 
 		if (ZBX_MAX_RECV_DATA_SIZE < value_len)
 		{
-			value.result = NULL;
-			value.state = ITEM_STATE_NOTSUPPORTED;
-			value.error = "Value is too large.";
+			result = NULL;
+			state = ITEM_STATE_NOTSUPPORTED;
+			error = "Value is too large.";
 		}
 	}
 
-	if (0 == preprocessor_pack_value(&cached_message, &value))
-	{
-		zbx_preprocessor_flush();
-		preprocessor_pack_value(&cached_message, &value);
-	}
+	preprocessor_cache_value(itemid, hostid, item_value_type, item_flags, result, ts, state, error);
 
-	if (ZBX_PREPROCESSING_BATCH_SIZE < ++cached_values)
+	if (1 == cached_values)
+		cached_time = zbx_time();
+
+	if (ZBX_PREPROCESSING_BATCH_SIZE < cached_values || PP_CACHED_STRINGS_FLUSH_SIZE <= cached_strings_size)
 		zbx_preprocessor_flush();
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
@@ -900,14 +1179,55 @@ void	zbx_preprocess_item_value(zbx_uint64_t itemid, zbx_uint64_t hostid, unsigne
  ******************************************************************************/
 void	zbx_preprocessor_flush(void)
 {
-	if (0 < cached_message.size)
+	zbx_uint32_t	size;
+
+	if (0 == cached_values)
+		return;
+
+	size = preprocessor_pack_cached_values();
+	preprocessor_send(ZBX_IPC_PREPROCESSOR_REQUEST, cached_data, size, NULL);
+
+	/* keep the buffers for the next batch unless they were grown by large values */
+	if (PP_CACHED_STRINGS_FLUSH_SIZE < cached_strings_alloc)
 	{
-		preprocessor_send(ZBX_IPC_PREPROCESSOR_REQUEST, cached_message.data, cached_message.size, NULL);
+		zbx_free(cached_strings);
+		cached_strings_alloc = 0;
+		zbx_free(cached_data);
+		cached_data_alloc = 0;
+	}
+
+	cached_strings_size = 0;
+	cached_values = 0;
+}
 
-		zbx_ipc_message_clean(&cached_message);
-		zbx_ipc_message_init(&cached_message);
-		cached_values = 0;
+/******************************************************************************
+ *                                                                            *
+ * Purpose: send cached values to preprocessing manager if the oldest cached  *
+ *          value is waiting longer than the specified delay                  *
+ *                                                                            *
+ * Parameters: delay - [IN] maximum time in seconds values can be cached      *
+ *                                                                            *
+ * Return value: time in seconds until the cached values must be flushed or   *
+ *               0 if there are no cached values                              *
+ *                                                                            *
+ * Comments: Used by processes receiving values in small portions to send     *
+ *           them in larger batches without delaying preprocessing too long.  *
+ *                                                                            *
+ ******************************************************************************/
+double	zbx_preprocessor_flush_delayed(double delay)
+{
+	double	elapsed;
+
+	if (0 == cached_values)
+		return 0;
+
+	if (delay <= (elapsed = zbx_time() - cached_time) || 0 > elapsed)
+	{
+		zbx_preprocessor_flush();
+		return 0;
 	}
+
+	return delay - elapsed;
 }
 
 /******************************************************************************
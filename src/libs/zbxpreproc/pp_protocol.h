@@ -35,19 +35,40 @@
 #define ZBX_IPC_PREPROCESSOR_USAGE_STATS		10009
 #define ZBX_IPC_PREPROCESSOR_TOP_PEAK			10010
 
-/* item value data used in preprocessing manager */
+/* item value batch columns, ordered by element size to keep the columns aligned */
+typedef enum
+{
+	ZBX_PP_BATCH_ITEMID = 0,
+	ZBX_PP_BATCH_HOSTID,
+	ZBX_PP_BATCH_NUMERIC,		/* unsigned integer value or double value bits */
+	ZBX_PP_BATCH_LASTLOGSIZE,
+	ZBX_PP_BATCH_TS_SEC,
+	ZBX_PP_BATCH_TS_NS,
+	ZBX_PP_BATCH_MTIME,
+	ZBX_PP_BATCH_LOG_TIMESTAMP,
+	ZBX_PP_BATCH_LOG_SEVERITY,
+	ZBX_PP_BATCH_LOG_EVENTID,
+	ZBX_PP_BATCH_VALUE_SIZE,	/* string or error value size including terminating zero, 0 if none */
+	ZBX_PP_BATCH_SOURCE_SIZE,	/* log source size including terminating zero, 0 if none */
+	ZBX_PP_BATCH_VALUE_TYPE,
+	ZBX_PP_BATCH_ITEM_FLAGS,
+	ZBX_PP_BATCH_VAR_TYPE,		/* ZBX_VARIANT_* type of the value */
+	ZBX_PP_BATCH_OPT_FLAGS,		/* ZBX_PP_VALUE_OPT_* flags of the value */
+	ZBX_PP_BATCH_COLUMNS_NUM
+}
+zbx_pp_batch_column_t;
+
+/* item value batch being unpacked by preprocessing manager */
 typedef struct
 {
-	zbx_uint64_t		itemid;		 /* item id */
-	zbx_uint64_t		hostid;		 /* host id */
-	unsigned char		item_value_type; /* item value type */
-	AGENT_RESULT		*result;	 /* item value (if any) */
-	zbx_timespec_t		*ts;		 /* timestamp of a value */
-	char			*error;		 /* error message (if any) */
-	unsigned char		item_flags;	 /* item flags */
-	unsigned char		state;		 /* item state */
+	const unsigned char	*columns[ZBX_PP_BATCH_COLUMNS_NUM];
+	const char		*strings;
+	zbx_uint32_t		strings_size;
+	zbx_uint32_t		strings_offset;
+	zbx_uint32_t		values_num;
+	zbx_uint32_t		index;
 }
-zbx_preproc_item_value_t;
+zbx_pp_batch_t;
 
 ZBX_PTR_VECTOR_DECL(ipcmsg, zbx_ipc_message_t *)
 
@@ -60,7 +81,9 @@ typedef struct
 }
 zbx_packed_field_t;
 
-zbx_uint32_t	zbx_preprocessor_unpack_value(zbx_preproc_item_value_t *value, unsigned char *data);
+int	zbx_preprocessor_unpack_batch(zbx_pp_batch_t *batch, const unsigned char *data, zbx_uint32_t size);
+int	zbx_preprocessor_batch_next(zbx_pp_batch_t *batch, zbx_uint64_t *itemid, unsigned char *value_type,
+		unsigned char *flags, zbx_variant_t *value, zbx_timespec_t *ts, zbx_pp_value_opt_t *opt);
 
 void	zbx_preprocessor_unpack_test_request(zbx_pp_item_preproc_t *preproc, zbx_variant_t *value, zbx_timespec_t *ts,
 		const unsigned char *data);
@@ -21,6 +21,8 @@
 #include "zbxalgo.h"
 #include "zbxregexp.h"
 #include "zbxthreads.h"
+#include "zbxprof.h"
+#include "zbxtime.h"
 
 #define PP_WORKER_INIT_NONE	0x00
 #define PP_WORKER_INIT_THREAD	0x01
@@ -137,6 +139,8 @@ static void	*pp_worker_entry(void *args)
 		{
 			pp_task_queue_unlock(queue);
 
+			/* worker threads do not update environment, toggle profiling here instead */
+			zbx_prof_update(get_process_type_string(ZBX_PROCESS_TYPE_PREPROCESSOR), zbx_time());
 			zbx_timekeeper_update(worker->timekeeper, worker->id - 1, ZBX_PROCESS_STATE_BUSY);
 
 			zabbix_log(LOG_LEVEL_TRACE, "%s() process task type:%u itemid:" ZBX_FS_UI64, __func__,
@@ -16,6 +16,17 @@
 #include "zbxalgo.h"
 #include "zbxtime.h"
 
+#ifndef _WINDOWS
+#	include <sys/mman.h>
+#endif
+
+#if defined(__GNUC__) && (defined(MAP_ANONYMOUS) || defined(MAP_ANON))
+#	define ZBX_PROF_PROBES
+#	if !defined(MAP_ANONYMOUS)
+#		define MAP_ANONYMOUS	MAP_ANON
+#	endif
+#endif
+
 #define PROF_LEVEL_MAX	10
 
 typedef struct
@@ -228,6 +239,370 @@ void	zbx_prof_disable(void)
 	zbx_prof_scope_requested = 0;
 }
 
+#ifdef ZBX_PROF_PROBES
+
+/* log-linear histogram - values below PROF_HIST_SUB ticks get a bucket each, */
+/* every following power of two is split into PROF_HIST_SUB buckets          */
+#define PROF_HIST_SUB_BITS	2
+#define PROF_HIST_SUB		(1 << PROF_HIST_SUB_BITS)
+#define PROF_HIST_EXP_MAX	40
+#define PROF_HIST_BUCKETS	((PROF_HIST_EXP_MAX - PROF_HIST_SUB_BITS + 1) * PROF_HIST_SUB)
+
+typedef struct
+{
+	zbx_uint64_t	count;
+	zbx_uint64_t	total;
+	zbx_uint64_t	max;
+	zbx_uint64_t	buckets[PROF_HIST_BUCKETS];
+}
+zbx_prof_hist_t;
+
+typedef struct
+{
+	int		enabled;
+	zbx_prof_hist_t	hist[ZBX_PROF_PROBE_COUNT];
+}
+zbx_prof_slot_t;
+
+typedef struct
+{
+	zbx_uint64_t	ticks_init;
+	zbx_uint64_t	ns_init;
+	int		slots_num;
+	int		slots_used;
+	zbx_prof_slot_t	slots[1];
+}
+zbx_prof_shmem_t;
+
+static const char	*prof_probe_names[ZBX_PROF_PROBE_COUNT] = {"config lock", "valuecache miss", "db query",
+				"ipc send", "ipc recv", "preprocessing step"};
+
+static zbx_prof_shmem_t				*prof_shmem;
+
+static ZBX_THREAD_LOCAL zbx_prof_slot_t		*prof_slot;
+static ZBX_THREAD_LOCAL zbx_prof_slot_t		*prof_slot_active;
+static ZBX_THREAD_LOCAL pid_t			prof_slot_pid;
+static ZBX_THREAD_LOCAL int			prof_slot_unavailable;
+static ZBX_THREAD_LOCAL zbx_uint64_t		prof_probe_ticks[ZBX_PROF_PROBE_COUNT];
+
+static zbx_uint64_t	prof_get_ns(void)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (zbx_uint64_t)ts.tv_sec * 1000000000 + (zbx_uint64_t)ts.tv_nsec;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: read the cheapest available monotonic tick counter                *
+ *                                                                            *
+ * Comments: Time stamp counter is used on x86 platforms, otherwise the ticks *
+ *           are monotonic clock nanoseconds.                                 *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_uint64_t	prof_get_ticks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __builtin_ia32_rdtsc();
+#else
+	return prof_get_ns();
+#endif
+}
+
+static int	prof_hist_index(zbx_uint64_t ticks)
+{
+	int	exp, index;
+
+	if (PROF_HIST_SUB > ticks)
+		return (int)ticks;
+
+	exp = 63 - __builtin_clzll(ticks);
+	index = (exp - PROF_HIST_SUB_BITS + 1) * PROF_HIST_SUB +
+			(int)((ticks >> (exp - PROF_HIST_SUB_BITS)) & (PROF_HIST_SUB - 1));
+
+	return MIN(index, PROF_HIST_BUCKETS - 1);
+}
+
+static zbx_uint64_t	prof_hist_bound(int index)
+{
+	int	exp;
+
+	if (PROF_HIST_SUB > index)
+		return (zbx_uint64_t)index + 1;
+
+	exp = index / PROF_HIST_SUB + PROF_HIST_SUB_BITS - 1;
+
+	return (zbx_uint64_t)(PROF_HIST_SUB + index % PROF_HIST_SUB + 1) << (exp - PROF_HIST_SUB_BITS);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: allocate shared probe histograms for all server/proxy processes   *
+ *                                                                            *
+ * Parameters: get_config_forks - [IN] callback returning process forks       *
+ *             error            - [OUT] error message                         *
+ *                                                                            *
+ * Return value: SUCCEED - the histograms were allocated                      *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: Must be called by the main process before forking. Slots are     *
+ *           claimed by processes and threads when profiling is enabled.      *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_prof_probes_init(zbx_get_config_forks_f get_config_forks, char **error)
+{
+	int		slots_num = 1;
+	size_t		size;
+	unsigned char	proc_type;
+	void		*addr;
+
+	for (proc_type = 0; ZBX_PROCESS_TYPE_COUNT > proc_type; proc_type++)
+		slots_num += get_config_forks(proc_type);
+
+	size = sizeof(zbx_prof_shmem_t) + sizeof(zbx_prof_slot_t) * (size_t)(slots_num - 1);
+
+	/* anonymous mapping pages are committed only when the slots get used */
+	if (MAP_FAILED == (addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0)))
+	{
+		*error = zbx_dsprintf(NULL, "cannot allocate profiler memory: %s", zbx_strerror(errno));
+		return FAIL;
+	}
+
+	prof_shmem = (zbx_prof_shmem_t *)addr;
+	prof_shmem->slots_num = slots_num;
+	prof_shmem->ns_init = prof_get_ns();
+	prof_shmem->ticks_init = prof_get_ticks();
+
+	return SUCCEED;
+}
+
+static void	prof_probes_activate(void)
+{
+	if (NULL == prof_shmem || NULL != prof_slot_active || 0 != prof_slot_unavailable)
+		return;
+
+	if (NULL == prof_slot || getpid() != prof_slot_pid)
+	{
+		int	index;
+
+		/* only the calling thread is left without probes, other threads keep their slots */
+		if (prof_shmem->slots_num <= (index = __atomic_fetch_add(&prof_shmem->slots_used, 1,
+				__ATOMIC_RELAXED)))
+		{
+			prof_slot_unavailable = 1;
+			zabbix_log(LOG_LEVEL_WARNING, "no free profiler slots, probes are disabled");
+			return;
+		}
+
+		prof_slot = &prof_shmem->slots[index];
+		prof_slot_pid = getpid();
+	}
+
+	memset(prof_slot->hist, 0, sizeof(prof_slot->hist));
+	memset(prof_probe_ticks, 0, sizeof(prof_probe_ticks));
+	prof_slot->enabled = 1;
+	prof_slot_active = prof_slot;
+}
+
+static void	prof_probes_deactivate(void)
+{
+	if (NULL == prof_slot_active)
+		return;
+
+	prof_slot_active->enabled = 0;
+	prof_slot_active = NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: mark start of probed operation                                    *
+ *                                                                            *
+ * Comments: Only the pointer check is done while profiling is disabled.      *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_prof_probe_start(zbx_prof_probe_t probe)
+{
+	if (NULL != prof_slot_active)
+		prof_probe_ticks[probe] = prof_get_ticks();
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: record duration of probed operation in the probe histogram        *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_prof_probe_end(zbx_prof_probe_t probe)
+{
+	zbx_prof_hist_t	*hist;
+	zbx_uint64_t	ticks, start;
+
+	if (NULL == prof_slot_active || 0 == (start = prof_probe_ticks[probe]))
+		return;
+
+	prof_probe_ticks[probe] = 0;
+
+	/* skip samples where time stamp counter went backwards after migration to another CPU */
+	if (start > (ticks = prof_get_ticks()))
+		return;
+
+	ticks -= start;
+
+	hist = &prof_slot_active->hist[probe];
+	hist->count++;
+	hist->total += ticks;
+	hist->buckets[prof_hist_index(ticks)]++;
+
+	if (hist->max < ticks)
+		hist->max = ticks;
+}
+
+static zbx_uint64_t	prof_hist_quantile(const zbx_uint64_t *buckets, zbx_uint64_t count, double q)
+{
+	zbx_uint64_t	rank, sum = 0;
+	int		i;
+
+	rank = (zbx_uint64_t)((double)count * q);
+
+	for (i = 0; i < PROF_HIST_BUCKETS; i++)
+	{
+		if (rank < (sum += buckets[i]))
+			return prof_hist_bound(i);
+	}
+
+	return prof_hist_bound(PROF_HIST_BUCKETS - 1);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get probe statistics merged from all process slots                *
+ *                                                                            *
+ * Parameters: stats         - [OUT] ZBX_PROF_PROBE_COUNT sized array of      *
+ *                                   probe statistics                         *
+ *             processes_num - [OUT] number of processes with enabled probes  *
+ *                                                                            *
+ * Return value: SUCCEED - the statistics were retrieved                      *
+ *               FAIL    - the probes are not initialized                     *
+ *                                                                            *
+ * Comments: The statistics must be freed with zbx_prof_probes_clear_stats(). *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_prof_probes_get_stats(zbx_prof_probe_stats_t *stats, int *processes_num)
+{
+	zbx_uint64_t	ticks, ns, buckets[PROF_HIST_BUCKETS];
+	double		ns_per_tick = 1;
+	int		probe, i, j, slots_used;
+
+	if (NULL == prof_shmem)
+		return FAIL;
+
+	ns = prof_get_ns();
+	ticks = prof_get_ticks();
+
+	if (ticks > prof_shmem->ticks_init)
+		ns_per_tick = (double)(ns - prof_shmem->ns_init) / (double)(ticks - prof_shmem->ticks_init);
+
+	slots_used = MIN(__atomic_load_n(&prof_shmem->slots_used, __ATOMIC_RELAXED), prof_shmem->slots_num);
+
+	*processes_num = 0;
+
+	for (i = 0; i < slots_used; i++)
+	{
+		if (0 != prof_shmem->slots[i].enabled)
+			(*processes_num)++;
+	}
+
+	for (probe = 0; probe < ZBX_PROF_PROBE_COUNT; probe++)
+	{
+		zbx_prof_probe_stats_t	*ps = &stats[probe];
+		zbx_uint64_t		total = 0, max = 0;
+
+		memset(ps, 0, sizeof(zbx_prof_probe_stats_t));
+		memset(buckets, 0, sizeof(buckets));
+		ps->name = prof_probe_names[probe];
+
+		for (i = 0; i < slots_used; i++)
+		{
+			const zbx_prof_hist_t	*hist = &prof_shmem->slots[i].hist[probe];
+
+			ps->count += hist->count;
+			total += hist->total;
+
+			if (max < hist->max)
+				max = hist->max;
+
+			for (j = 0; j < PROF_HIST_BUCKETS; j++)
+				buckets[j] += hist->buckets[j];
+		}
+
+		if (0 == ps->count)
+			continue;
+
+		ps->total_ns = (zbx_uint64_t)((double)total * ns_per_tick);
+		ps->max_ns = (zbx_uint64_t)((double)max * ns_per_tick);
+		ps->p50_ns = (zbx_uint64_t)((double)prof_hist_quantile(buckets, ps->count, 0.5) * ns_per_tick);
+		ps->p90_ns = (zbx_uint64_t)((double)prof_hist_quantile(buckets, ps->count, 0.9) * ns_per_tick);
+		ps->p99_ns = (zbx_uint64_t)((double)prof_hist_quantile(buckets, ps->count, 0.99) * ns_per_tick);
+
+		ps->buckets = (zbx_prof_bucket_t *)zbx_malloc(NULL, sizeof(zbx_prof_bucket_t) * PROF_HIST_BUCKETS);
+
+		for (j = 0; j < PROF_HIST_BUCKETS; j++)
+		{
+			if (0 == buckets[j])
+				continue;
+
+			ps->buckets[ps->buckets_num].le = (zbx_uint64_t)((double)prof_hist_bound(j) * ns_per_tick);
+			ps->buckets[ps->buckets_num++].count = buckets[j];
+		}
+	}
+
+	return SUCCEED;
+}
+
+#undef PROF_HIST_SUB_BITS
+#undef PROF_HIST_SUB
+#undef PROF_HIST_EXP_MAX
+#undef PROF_HIST_BUCKETS
+
+#else
+
+int	zbx_prof_probes_init(zbx_get_config_forks_f get_config_forks, char **error)
+{
+	ZBX_UNUSED(get_config_forks);
+	ZBX_UNUSED(error);
+
+	return SUCCEED;
+}
+
+void	zbx_prof_probe_start(zbx_prof_probe_t probe)
+{
+	ZBX_UNUSED(probe);
+}
+
+void	zbx_prof_probe_end(zbx_prof_probe_t probe)
+{
+	ZBX_UNUSED(probe);
+}
+
+int	zbx_prof_probes_get_stats(zbx_prof_probe_stats_t *stats, int *processes_num)
+{
+	ZBX_UNUSED(stats);
+	ZBX_UNUSED(processes_num);
+
+	return FAIL;
+}
+
+#endif	/* ZBX_PROF_PROBES */
+
+void	zbx_prof_probes_clear_stats(zbx_prof_probe_stats_t *stats)
+{
+	int	probe;
+
+	for (probe = 0; probe < ZBX_PROF_PROBE_COUNT; probe++)
+		zbx_free(stats[probe].buckets);
+}
+
 static void	zbx_reset_prof(void)
 {
 	if (0 != zbx_prof_initialized)
@@ -243,9 +618,17 @@ void	zbx_prof_update(const char *info, double time_now)
 	{
 		zbx_prof_init();
 		zbx_prof_scope = zbx_prof_scope_requested;
+#ifdef ZBX_PROF_PROBES
+		prof_probes_activate();
+#endif
 	}
 	else
+	{
 		zbx_prof_scope = 0;
+#ifdef ZBX_PROF_PROBES
+		prof_probes_deactivate();
+#endif
+	}
 
 	if (PROF_UPDATE_INTERVAL < time_now - last_update)
 	{
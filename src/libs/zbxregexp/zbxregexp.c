@@ -275,6 +275,11 @@ int	zbx_regexp_compile_ext(const char *pattern, zbx_regexp_t **regexp, int flags
 	return regexp_compile(pattern, flags, regexp, err_msg);
 }
 
+/* the last used regexp, cached per thread */
+static ZBX_THREAD_LOCAL zbx_regexp_t	*curr_regexp = NULL;
+static ZBX_THREAD_LOCAL char		*curr_pattern = NULL;
+static ZBX_THREAD_LOCAL int		curr_flags = 0;
+
 /****************************************************************************************************
  *                                                                                                  *
  * Purpose: wrapper for zbx_regexp_compile. Caches and reuses the last used regexp.                 *
@@ -282,10 +287,7 @@ int	zbx_regexp_compile_ext(const char *pattern, zbx_regexp_t **regexp, int flags
  ****************************************************************************************************/
 static int	regexp_prepare(const char *pattern, int flags, zbx_regexp_t **regexp, char **err_msg)
 {
-	static ZBX_THREAD_LOCAL zbx_regexp_t	*curr_regexp = NULL;
-	static ZBX_THREAD_LOCAL char		*curr_pattern = NULL;
-	static ZBX_THREAD_LOCAL int		curr_flags = 0;
-	int					ret = SUCCEED;
+	int	ret = SUCCEED;
 
 	if (NULL == curr_regexp || 0 != strcmp(curr_pattern, pattern) || curr_flags != flags)
 	{
@@ -333,6 +335,25 @@ void	zbx_init_regexp_env(void)
 #endif
 }
 
+/****************************************************************************************************
+ *                                                                                                  *
+ * Purpose: releases regular expression execution environment of the calling thread                 *
+ *                                                                                                  *
+ * Comments: must be called by short lived threads using regular expressions before they exit       *
+ *                                                                                                  *
+ ****************************************************************************************************/
+void	zbx_deinit_regexp_env(void)
+{
+	if (NULL != curr_regexp)
+	{
+		zbx_regexp_free(curr_regexp);
+		curr_regexp = NULL;
+	}
+
+	zbx_free(curr_pattern);
+	curr_flags = 0;
+}
+
 static unsigned long int	compute_recursion_limit(void)
 {
 	if (0 == rxp_stacklimit)
@@ -205,7 +205,7 @@ static void	rtc_process_diaginfo(const char *data, char **result)
 	if (0 == strcmp(buf, "all"))
 	{
 		scope = (1 << ZBX_DIAGINFO_HISTORYCACHE) | (1 << ZBX_DIAGINFO_PREPROCESSING) |
-				(1 << ZBX_DIAGINFO_LOCKS);
+				(1 << ZBX_DIAGINFO_LOCKS) | (1 << ZBX_DIAGINFO_PROFILER) | (1 << ZBX_DIAGINFO_POLLER);
 	}
 	else if (0 == strcmp(buf, ZBX_DIAG_HISTORYCACHE))
 	{
@@ -219,6 +219,14 @@ static void	rtc_process_diaginfo(const char *data, char **result)
 	{
 		scope = 1 << ZBX_DIAGINFO_LOCKS;
 	}
+	else if (0 == strcmp(buf, ZBX_DIAG_PROFILER))
+	{
+		scope = 1 << ZBX_DIAGINFO_PROFILER;
+	}
+	else if (0 == strcmp(buf, ZBX_DIAG_POLLER))
+	{
+		scope = 1 << ZBX_DIAGINFO_POLLER;
+	}
 	else
 	{
 		if (NULL == *result)
@@ -518,21 +526,31 @@ static void	rtc_add_control_hook(zbx_rtc_t *rtc, zbx_ipc_client_t *client, zbx_u
  * Purpose: notify matching hooks and remove them                             *
  *                                                                            *
  ******************************************************************************/
-static void	rtc_notify_hooks(zbx_rtc_t *rtc, zbx_uint32_t code, unsigned char *data, zbx_uint32_t size)
+static void	rtc_notify_hooks(zbx_rtc_t *rtc, zbx_ipc_message_t *message)
 {
-	int	i;
+	int			i;
+	zbx_ipc_buffer_t	*buffer = NULL;
 
 	for (i = 0; i < rtc->hooks.values_num;)
 	{
-		if (rtc->hooks.values[i]->code == code)
+		if (rtc->hooks.values[i]->code == message->code)
 		{
-			(void)zbx_ipc_client_send(rtc->hooks.values[i]->client, code, data, size);
+			/* share the message data between all notified clients */
+			if (NULL == buffer)
+			{
+				buffer = zbx_ipc_buffer_create(message->data, message->size);
+				message->data = NULL;
+			}
+
+			(void)zbx_ipc_client_send_buffer(rtc->hooks.values[i]->client, message->code, buffer);
 			zbx_free(rtc->hooks.values[i]);
 			zbx_vector_rtc_hook_remove_noorder(&rtc->hooks, i);
 			continue;
 		}
 		i++;
 	}
+
+	zbx_ipc_buffer_release(buffer);
 }
 
 /******************************************************************************
@@ -604,7 +622,7 @@ void	zbx_rtc_dispatch(zbx_rtc_t *rtc, zbx_ipc_client_t *client, zbx_ipc_message_
 			break;
 		case ZBX_RTC_CONFIG_SYNC_NOTIFY:
 		case ZBX_RTC_SERVICE_SYNC_NOTIFY:
-			rtc_notify_hooks(rtc, message->code, message->data, message->size);
+			rtc_notify_hooks(rtc, message);
 			break;
 		default:
 			rtc_process(rtc, client, message->code, message->data, cb_proc_req);
@@ -92,3 +92,67 @@ zbx_uint32_t	zbx_deserialize_uint31_compact(const unsigned char *ptr, zbx_uint32
 		return pos;
 	}
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: serialize 64 bit unsigned integer into byte stream using 7 bits   *
+ *          per byte, with the high bit set on all bytes except the last      *
+ *                                                                            *
+ * Parameters: ptr   - [OUT] the output buffer, must have space for at least  *
+ *                           ZBX_UINT64_COMPACT_LEN_MAX bytes                 *
+ *             value - [IN] the value to serialize                            *
+ *                                                                            *
+ * Return value: The number of bytes written to the buffer.                   *
+ *                                                                            *
+ ******************************************************************************/
+zbx_uint32_t	zbx_serialize_uint64_compact(unsigned char *ptr, zbx_uint64_t value)
+{
+	zbx_uint32_t	len = 0;
+
+	while (0x7f < value)
+	{
+		ptr[len++] = (unsigned char)(0x80 | (value & 0x7f));
+		value >>= 7;
+	}
+
+	ptr[len++] = (unsigned char)value;
+
+	return len;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: deserialize 64 bit unsigned integer from byte stream              *
+ *                                                                            *
+ * Parameters: ptr   - [IN] the byte stream                                   *
+ *             end   - [IN] the end of byte stream                            *
+ *             value - [OUT] the deserialized value                           *
+ *                                                                            *
+ * Return value: The number of bytes read from byte stream or 0 if the stream *
+ *               was truncated or the value does not fit 64 bits.             *
+ *                                                                            *
+ ******************************************************************************/
+zbx_uint32_t	zbx_deserialize_uint64_compact(const unsigned char *ptr, const unsigned char *end, zbx_uint64_t *value)
+{
+	zbx_uint32_t	len = 0;
+	int		shift = 0;
+
+	*value = 0;
+
+	while (ptr + len < end && ZBX_UINT64_COMPACT_LEN_MAX > len)
+	{
+		unsigned char	byte = ptr[len++];
+
+		if (63 == shift && 1 < byte)
+			return 0;
+
+		*value |= (zbx_uint64_t)(byte & 0x7f) << shift;
+
+		if (0 == (byte & 0x80))
+			return len;
+
+		shift += 7;
+	}
+
+	return 0;
+}
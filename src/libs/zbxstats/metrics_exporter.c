@@ -0,0 +1,410 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxstats.h"
+
+#include "zbxalgo.h"
+#include "zbxjson.h"
+#include "zbxlog.h"
+#include "zbxnix.h"
+#include "zbxself.h"
+#include "zbxstr.h"
+#include "zbxtime.h"
+#include "zbxtimekeeper.h"
+
+#define METRICS_PREFIX		"zabbix"
+#define METRICS_PATH		"/metrics"
+#define METRICS_HEADERS_MAX	100
+
+#define METRICS_CONTENT_TYPE	"application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+typedef struct
+{
+	char		*family;
+	const char	*suffix;
+	const char	*type;
+	char		*labels;
+	char		*value;
+	int		index;
+}
+zbx_metrics_sample_t;
+
+ZBX_PTR_VECTOR_DECL(metrics_sample_ptr, zbx_metrics_sample_t *)
+ZBX_PTR_VECTOR_IMPL(metrics_sample_ptr, zbx_metrics_sample_t *)
+
+static void	metrics_sample_free(zbx_metrics_sample_t *sample)
+{
+	zbx_free(sample->family);
+	zbx_free(sample->labels);
+	zbx_free(sample->value);
+	zbx_free(sample);
+}
+
+static int	metrics_sample_compare(const void *d1, const void *d2)
+{
+	const zbx_metrics_sample_t	*s1 = *(const zbx_metrics_sample_t * const *)d1;
+	const zbx_metrics_sample_t	*s2 = *(const zbx_metrics_sample_t * const *)d2;
+	int				ret;
+
+	if (0 != (ret = strcmp(s1->family, s2->family)))
+		return ret;
+
+	ZBX_RETURN_IF_NOT_EQUAL(s1->index, s2->index);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: append json key to metric name, replacing characters that are     *
+ *          not allowed in metric names with underscores                      *
+ *                                                                            *
+ ******************************************************************************/
+static void	metrics_name_append(char **name, size_t *name_alloc, size_t *name_offset, const char *key)
+{
+	zbx_chrcpy_alloc(name, name_alloc, name_offset, '_');
+
+	for (; '\0' != *key; key++)
+	{
+		zbx_chrcpy_alloc(name, name_alloc, name_offset,
+				(0 != isalnum((unsigned char)*key) ? *key : '_'));
+	}
+}
+
+static char	*metrics_label_escape(const char *value)
+{
+	char	*out = NULL;
+	size_t	out_alloc = 0, out_offset = 0;
+
+	for (; '\0' != *value; value++)
+	{
+		switch (*value)
+		{
+			case '\\':
+			case '"':
+				zbx_chrcpy_alloc(&out, &out_alloc, &out_offset, '\\');
+				zbx_chrcpy_alloc(&out, &out_alloc, &out_offset, *value);
+				break;
+			case '\n':
+				zbx_strcpy_alloc(&out, &out_alloc, &out_offset, "\\n");
+				break;
+			default:
+				zbx_chrcpy_alloc(&out, &out_alloc, &out_offset, *value);
+		}
+	}
+
+	return NULL != out ? out : zbx_strdup(NULL, "");
+}
+
+static void	metrics_add_sample(zbx_vector_metrics_sample_ptr_t *samples, const char *family, const char *suffix,
+		const char *type, const char *labels, const char *value)
+{
+	zbx_metrics_sample_t	*sample;
+
+	sample = (zbx_metrics_sample_t *)zbx_malloc(NULL, sizeof(zbx_metrics_sample_t));
+	sample->family = zbx_strdup(NULL, family);
+	sample->suffix = suffix;
+	sample->type = type;
+	sample->labels = (NULL != labels ? zbx_strdup(NULL, labels) : NULL);
+	sample->value = zbx_strdup(NULL, value);
+	sample->index = samples->values_num;
+
+	zbx_vector_metrics_sample_ptr_append(samples, sample);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: convert statistics json object into metric samples                *
+ *                                                                            *
+ * Parameters: jp      - [IN] json object                                     *
+ *             prefix  - [IN] metric name prefix                              *
+ *             labels  - [IN] sample labels, can be NULL                      *
+ *             samples - [OUT] metric samples                                 *
+ *                                                                            *
+ * Comments: Nested object keys are joined into metric names, except process  *
+ *           types which are reported as type label of process metrics.       *
+ *                                                                            *
+ ******************************************************************************/
+static void	metrics_parse_object(const struct zbx_json_parse *jp, const char *prefix, const char *labels,
+		zbx_vector_metrics_sample_ptr_t *samples)
+{
+	const char		*pnext = NULL;
+	char			key[MAX_STRING_LEN], *value = NULL, *name = NULL;
+	size_t			value_alloc = 0, name_alloc = 0, name_offset;
+	struct zbx_json_parse	jp_obj;
+	zbx_json_type_t		type;
+
+	while (NULL != (pnext = zbx_json_pair_next(jp, pnext, key, sizeof(key))))
+	{
+		name_offset = 0;
+		zbx_strcpy_alloc(&name, &name_alloc, &name_offset, prefix);
+
+		if (SUCCEED == zbx_json_brackets_open(pnext, &jp_obj))
+		{
+			if (ZBX_JSON_TYPE_OBJECT != zbx_json_valuetype(pnext))
+				continue;
+
+			if (NULL == labels && 0 == strcmp(prefix, METRICS_PREFIX "_process"))
+			{
+				char	*type_label, *type_escaped;
+
+				type_escaped = metrics_label_escape(key);
+				type_label = zbx_dsprintf(NULL, "type=\"%s\"", type_escaped);
+				metrics_parse_object(&jp_obj, name, type_label, samples);
+				zbx_free(type_label);
+				zbx_free(type_escaped);
+				continue;
+			}
+
+			metrics_name_append(&name, &name_alloc, &name_offset, key);
+			metrics_parse_object(&jp_obj, name, labels, samples);
+			continue;
+		}
+
+		if (NULL == zbx_json_decodevalue_dyn(pnext, &value, &value_alloc, &type))
+			continue;
+
+		metrics_name_append(&name, &name_alloc, &name_offset, key);
+
+		switch (type)
+		{
+			case ZBX_JSON_TYPE_INT:
+			case ZBX_JSON_TYPE_NUMBER:
+				metrics_add_sample(samples, name, "", "gauge", labels, value);
+				break;
+			case ZBX_JSON_TYPE_STRING:
+				if (NULL == labels)
+				{
+					char	*escaped, *info_labels = NULL;
+					size_t	info_labels_alloc = 0, info_labels_offset = 0;
+
+					/* label name is built the same way as metric name, without leading '_' */
+					metrics_name_append(&info_labels, &info_labels_alloc, &info_labels_offset, key);
+					escaped = metrics_label_escape(value);
+					zbx_snprintf_alloc(&info_labels, &info_labels_alloc, &info_labels_offset,
+							"=\"%s\"", escaped);
+					metrics_add_sample(samples, name, "_info", "info", info_labels + 1, "1");
+					zbx_free(info_labels);
+					zbx_free(escaped);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+
+	zbx_free(name);
+	zbx_free(value);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: render internal statistics in OpenMetrics text format             *
+ *                                                                            *
+ * Parameters: config_startup_time - [IN] program startup time                *
+ *             out                 - [OUT] metrics text                       *
+ *             out_alloc           - [IN/OUT]                                 *
+ *             out_offset          - [IN/OUT]                                 *
+ *                                                                            *
+ * Comments: The statistics are the same as returned by zabbix[stats] and     *
+ *           are collected from shared memory without database access.        *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_metrics_get(int config_startup_time, char **out, size_t *out_alloc, size_t *out_offset)
+{
+	struct zbx_json			json;
+	struct zbx_json_parse		jp;
+	zbx_vector_metrics_sample_ptr_t	samples;
+	const char			*family = NULL;
+
+	zbx_vector_metrics_sample_ptr_create(&samples);
+
+	zbx_json_init(&json, ZBX_JSON_STAT_BUF_LEN);
+	zbx_zabbix_stats_get(&json, config_startup_time);
+
+	if (SUCCEED == zbx_json_open(json.buffer, &jp))
+		metrics_parse_object(&jp, METRICS_PREFIX, NULL, &samples);
+
+	zbx_json_free(&json);
+
+	/* samples of the same metric family must be grouped together */
+	zbx_vector_metrics_sample_ptr_sort(&samples, metrics_sample_compare);
+
+	for (int i = 0; i < samples.values_num; i++)
+	{
+		const zbx_metrics_sample_t	*sample = samples.values[i];
+
+		if (NULL == family || 0 != strcmp(family, sample->family))
+		{
+			family = sample->family;
+			zbx_snprintf_alloc(out, out_alloc, out_offset, "# TYPE %s %s\n", family, sample->type);
+		}
+
+		zbx_snprintf_alloc(out, out_alloc, out_offset, "%s%s", sample->family, sample->suffix);
+
+		if (NULL != sample->labels)
+			zbx_snprintf_alloc(out, out_alloc, out_offset, "{%s}", sample->labels);
+
+		zbx_snprintf_alloc(out, out_alloc, out_offset, " %s\n", sample->value);
+	}
+
+	zbx_strcpy_alloc(out, out_alloc, out_offset, "# EOF\n");
+
+	zbx_vector_metrics_sample_ptr_clear_ext(&samples, metrics_sample_free);
+	zbx_vector_metrics_sample_ptr_destroy(&samples);
+}
+
+static void	metrics_send_response(zbx_socket_t *s, const char *status, const char *content_type,
+		const char *body, size_t body_len, int timeout)
+{
+	char	*out = NULL;
+	size_t	out_alloc = 0, out_offset = 0;
+
+	zbx_snprintf_alloc(&out, &out_alloc, &out_offset, "HTTP/1.1 %s\r\n"
+			"Content-Type: %s\r\n"
+			"Content-Length: " ZBX_FS_SIZE_T "\r\n"
+			"Connection: close\r\n"
+			"\r\n", status, content_type, (zbx_fs_size_t)body_len);
+	zbx_strncpy_alloc(&out, &out_alloc, &out_offset, body, body_len);
+
+	if (SUCCEED != zbx_tcp_send_ext(s, out, out_offset, 0, 0, timeout))
+		zabbix_log(LOG_LEVEL_DEBUG, "cannot send metrics response: %s", zbx_socket_strerror());
+
+	zbx_free(out);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: read HTTP request and reply with metrics                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	metrics_process_request(zbx_socket_t *s, const zbx_thread_metrics_exporter_args *args)
+{
+	const char	*line;
+	char		method[16], path[MAX_STRING_LEN], *body = NULL;
+	size_t		body_alloc = 0, body_offset = 0;
+	int		i;
+
+	zbx_socket_set_deadline(s, args->config_timeout);
+
+	if (NULL == (line = zbx_tcp_recv_line(s)) || 2 != sscanf(line, "%15s %1023s", method, path))
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "cannot read metrics request from %s", s->peer);
+		goto out;
+	}
+
+	/* skip request headers */
+	for (i = 0; i < METRICS_HEADERS_MAX && NULL != (line = zbx_tcp_recv_line(s)) && '\0' != *line; i++)
+		;
+
+	if (NULL == args->config_stats_allowed_ip || SUCCEED != zbx_tcp_check_allowed_peers(s,
+			args->config_stats_allowed_ip))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "failed to accept an incoming metrics request: %s",
+				NULL == args->config_stats_allowed_ip ? "StatsAllowedIP not set" :
+				zbx_socket_strerror());
+		metrics_send_response(s, "403 Forbidden", "text/plain", "Permission denied.\n",
+				ZBX_CONST_STRLEN("Permission denied.\n"), args->config_timeout);
+		goto out;
+	}
+
+	if (0 != strcmp(method, "GET"))
+	{
+		metrics_send_response(s, "405 Method Not Allowed", "text/plain", "Method not allowed.\n",
+				ZBX_CONST_STRLEN("Method not allowed.\n"), args->config_timeout);
+		goto out;
+	}
+
+	/* query string is ignored */
+	path[strcspn(path, "?")] = '\0';
+
+	if (0 != strcmp(path, METRICS_PATH))
+	{
+		metrics_send_response(s, "404 Not Found", "text/plain", "Not found.\n",
+				ZBX_CONST_STRLEN("Not found.\n"), args->config_timeout);
+		goto out;
+	}
+
+	zbx_metrics_get(args->config_startup_time, &body, &body_alloc, &body_offset);
+	metrics_send_response(s, "200 OK", METRICS_CONTENT_TYPE, body, body_offset, args->config_timeout);
+	zbx_free(body);
+out:
+	zbx_socket_set_deadline(s, 0);
+}
+
+ZBX_THREAD_ENTRY(zbx_metrics_exporter_thread, args)
+{
+#define POLL_TIMEOUT	1
+	zbx_thread_metrics_exporter_args	*exporter_args_in = (zbx_thread_metrics_exporter_args *)
+							(((zbx_thread_args_t *)args)->args);
+	const zbx_thread_info_t			*info = &((zbx_thread_args_t *)args)->info;
+	int					server_num = info->server_num, process_num = info->process_num,
+						ret;
+	unsigned char				process_type = info->process_type;
+	zbx_socket_t				s;
+	double					sec = 0.0;
+
+	zabbix_log(LOG_LEVEL_INFORMATION, "%s #%d started [%s #%d]", get_program_type_string(info->program_type),
+			server_num, get_process_type_string(process_type), process_num);
+
+	zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_BUSY);
+
+	if (FAIL == zbx_tcp_listen(&s, exporter_args_in->config_listen_ip,
+			(unsigned short)exporter_args_in->config_listen_port, exporter_args_in->config_timeout,
+			exporter_args_in->config_tcp_max_backlog_size))
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "metrics listener failed: %s", zbx_socket_strerror());
+		exit(EXIT_FAILURE);
+	}
+
+	zbx_setproctitle("%s #%d [waiting for connection]", get_process_type_string(process_type), process_num);
+
+	while (ZBX_IS_RUNNING())
+	{
+		zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_IDLE);
+
+		ret = zbx_tcp_accept(&s, ZBX_TCP_SEC_UNENCRYPTED, POLL_TIMEOUT);
+		zbx_update_env(get_process_type_string(process_type), zbx_time());
+
+		if (TIMEOUT_ERROR == ret)
+			continue;
+
+		if (SUCCEED != ret)
+		{
+			zabbix_log(LOG_LEVEL_DEBUG, "failed to accept an incoming metrics connection: %s",
+					zbx_socket_strerror());
+			continue;
+		}
+
+		zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_BUSY);
+		zbx_setproctitle("%s #%d [processing request]", get_process_type_string(process_type), process_num);
+
+		sec = zbx_time();
+		metrics_process_request(&s, exporter_args_in);
+		sec = zbx_time() - sec;
+
+		zbx_tcp_unaccept(&s);
+
+		zbx_setproctitle("%s #%d [processed request in " ZBX_FS_DBL " sec, waiting for connection]",
+				get_process_type_string(process_type), process_num, sec);
+	}
+
+	zbx_tcp_unlisten(&s);
+
+	zbx_setproctitle("%s #%d [terminated]", get_process_type_string(process_type), process_num);
+
+	while (1)
+		zbx_sleep(SEC_PER_MIN);
+#undef POLL_TIMEOUT
+}
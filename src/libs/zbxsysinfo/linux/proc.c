@@ -34,6 +34,16 @@
 #define PROC_ID_TYPE_USER	0
 #define PROC_ID_TYPE_GROUP	1
 
+/* the time in seconds process snapshot is reused by proc.num and proc.mem checks */
+#define PROC_SNAPSHOT_TTL	1.0
+
+#define PROC_SNAPSHOT_VM_NUM	12
+
+/* memory statistics labels in /proc/<pid>/status cached in process snapshot */
+static const char	*proc_snapshot_vm_labels[PROC_SNAPSHOT_VM_NUM] = {"VmPeak:\t", "VmSize:\t", "VmLck:\t",
+		"VmPin:\t", "VmHWM:\t", "VmRSS:\t", "VmData:\t", "VmStk:\t", "VmExe:\t", "VmLib:\t", "VmPTE:\t",
+		"VmSwap:\t"};
+
 typedef struct
 {
 	pid_t		pid;
@@ -93,6 +103,43 @@ proc_data_t;
 ZBX_PTR_VECTOR_DECL(proc_data_ptr, proc_data_t *)
 ZBX_PTR_VECTOR_IMPL(proc_data_ptr, proc_data_t *)
 
+/* process data read from /proc/<pid>/status and /proc/<pid>/cmdline files */
+typedef struct
+{
+	/* real user id, ZBX_MAX_UINT64 if it could not be read */
+	zbx_uint64_t	uid;
+
+	/* the first character of process state, '\0' if it could not be read */
+	char		state;
+
+	/* process name from status file */
+	char		*name;
+
+	/* the process name taken from the 0th argument */
+	char		*name_arg0;
+
+	/* process command line in format <arg0> <arg1> ... <argN>\0 */
+	char		*cmdline;
+
+	/* memory statistics in proc_snapshot_vm_labels[] order */
+	zbx_uint64_t	vm[PROC_SNAPSHOT_VM_NUM];
+
+	/* bit masks of memory statistics that were found and that could not be parsed */
+	unsigned int	vm_found;
+	unsigned int	vm_invalid;
+}
+proc_snapshot_t;
+
+ZBX_PTR_VECTOR_DECL(proc_snapshot_ptr, proc_snapshot_t *)
+ZBX_PTR_VECTOR_IMPL(proc_snapshot_ptr, proc_snapshot_t *)
+
+/* The snapshot of system processes shared by proc.num and proc.mem checks executed */
+/* by the same process within PROC_SNAPSHOT_TTL, so that multiple checks in one     */
+/* polling round walk /proc only once.                                              */
+static zbx_vector_proc_snapshot_ptr_t	proc_snapshot;
+static double				proc_snapshot_time;
+static int				proc_snapshot_initialized;
+
 /******************************************************************************
  *                                                                            *
  * Purpose: frees process data structure                                      *
@@ -281,131 +328,6 @@ static int	get_cmdline(FILE *f_cmd, char **line, size_t *line_offset)
 	return FAIL;
 }
 
-static int	cmp_status(FILE *f_stat, const char *procname)
-{
-	char	tmp[MAX_STRING_LEN];
-
-	rewind(f_stat);
-
-	while (NULL != fgets(tmp, (int)sizeof(tmp), f_stat))
-	{
-		if (0 != strncmp(tmp, "Name:\t", 6))
-			continue;
-
-		zbx_rtrim(tmp + 6, "\n");
-		if (0 == strcmp(tmp + 6, procname))
-			return SUCCEED;
-		break;
-	}
-
-	return FAIL;
-}
-
-static int	check_procname(FILE *f_cmd, FILE *f_stat, const char *procname)
-{
-	char	*tmp = NULL, *p;
-	size_t	l;
-	int	ret = SUCCEED;
-
-	if (NULL == procname || '\0' == *procname)
-		return SUCCEED;
-
-	/* process name in /proc/[pid]/status contains limited number of characters */
-	if (SUCCEED == cmp_status(f_stat, procname))
-		return SUCCEED;
-
-	if (SUCCEED == get_cmdline(f_cmd, &tmp, &l))
-	{
-		if (NULL == (p = strrchr(tmp, '/')))
-			p = tmp;
-		else
-			p++;
-
-		if (0 == strcmp(p, procname))
-			goto clean;
-	}
-
-	ret = FAIL;
-clean:
-	zbx_free(tmp);
-
-	return ret;
-}
-
-static int	check_user(FILE *f_stat, struct passwd *usrinfo)
-{
-	zbx_uint64_t	uid;
-
-	if (NULL == usrinfo || (SUCCEED == proc_read_id(f_stat, PROC_ID_TYPE_USER, &uid) && usrinfo->pw_uid == uid))
-		return SUCCEED;
-
-	return FAIL;
-}
-
-static int	check_proccomm(FILE *f_cmd, const zbx_regexp_t *proccomm_rxp)
-{
-	char	*tmp = NULL;
-	size_t	l;
-	int	ret = SUCCEED;
-
-	if (NULL == proccomm_rxp)
-		return SUCCEED;
-
-	if (SUCCEED == get_cmdline(f_cmd, &tmp, &l))
-	{
-		l = l - 2;
-
-		for (size_t i = 0; i < l; i++)
-			if ('\0' == tmp[i])
-				tmp[i] = ' ';
-
-		if (0 == zbx_regexp_match_precompiled(tmp, proccomm_rxp))
-			goto clean;
-	}
-
-	ret = FAIL;
-clean:
-	zbx_free(tmp);
-
-	return ret;
-}
-
-static int	check_procstate(FILE *f_stat, int zbx_proc_stat)
-{
-	char	tmp[MAX_STRING_LEN], *p;
-
-	if (ZBX_PROC_STAT_ALL == zbx_proc_stat)
-		return SUCCEED;
-
-	rewind(f_stat);
-
-	while (NULL != fgets(tmp, (int)sizeof(tmp), f_stat))
-	{
-		if (0 != strncmp(tmp, "State:\t", 7))
-			continue;
-
-		p = tmp + 7;
-
-		switch (zbx_proc_stat)
-		{
-			case ZBX_PROC_STAT_RUN:
-				return ('R' == *p) ? SUCCEED : FAIL;
-			case ZBX_PROC_STAT_SLEEP:
-				return ('S' == *p) ? SUCCEED : FAIL;
-			case ZBX_PROC_STAT_ZOMB:
-				return ('Z' == *p) ? SUCCEED : FAIL;
-			case ZBX_PROC_STAT_DISK:
-				return ('D' == *p) ? SUCCEED : FAIL;
-			case ZBX_PROC_STAT_TRACE:
-				return ('T' == *p) ? SUCCEED : FAIL;
-			default:
-				return FAIL;
-		}
-	}
-
-	return FAIL;
-}
-
 /******************************************************************************
  *                                                                            *
  * Purpose: Reads amount of memory in bytes from a string                     *
@@ -572,6 +494,38 @@ out:
 	*bytes = ZBX_MAX_UINT64;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parses amount of memory in bytes from value part of /proc file    *
+ *          line, for example "   176712 kB\n"                                *
+ *                                                                            *
+ * Parameters: p_value - [IN] value to parse, modified during parsing         *
+ *             bytes   - [OUT] result in bytes                                *
+ *                                                                            *
+ * Return value: SUCCEED - value was parsed successfully                      *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	parse_byte_value(char *p_value, zbx_uint64_t *bytes)
+{
+	char	*p_unit;
+
+	if (NULL == (p_unit = strrchr(p_value, ' ')))
+		return FAIL;
+
+	*p_unit++ = '\0';
+
+	while (' ' == *p_value)
+		p_value++;
+
+	if (FAIL == zbx_is_uint64(p_value, bytes))
+		return FAIL;
+
+	convert_to_bytes(p_unit, bytes);
+
+	return SUCCEED;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: Reads amount of memory in bytes from a string in /proc file.      *
@@ -593,13 +547,12 @@ out:
  ******************************************************************************/
 int	byte_value_from_proc_file(FILE *f, const char *label, const char *guard, zbx_uint64_t *bytes)
 {
-	char	buf[MAX_STRING_LEN], *p_value, *p_unit;
+	char	buf[MAX_STRING_LEN];
 	size_t	label_len, guard_len;
 	long	pos = 0;
 	int	ret = NOTSUPPORTED;
 
 	label_len = strlen(label);
-	p_value = buf + label_len;
 
 	if (NULL != guard)
 	{
@@ -629,25 +582,7 @@ int	byte_value_from_proc_file(FILE *f, const char *label, const char *guard, zbx
 		if (0 != strncmp(buf, label, label_len))
 			continue;
 
-		if (NULL == (p_unit = strrchr(p_value, ' ')))
-		{
-			ret = FAIL;
-			break;
-		}
-
-		*p_unit++ = '\0';
-
-		while (' ' == *p_value)
-			p_value++;
-
-		if (FAIL == zbx_is_uint64(p_value, bytes))
-		{
-			ret = FAIL;
-			break;
-		}
-		convert_to_bytes(p_unit, bytes);
-
-		ret = SUCCEED;
+		ret = parse_byte_value(buf + label_len, bytes);
 		break;
 	}
 
@@ -668,6 +603,244 @@ static int	get_total_memory(zbx_uint64_t *total_memory)
 	return ret;
 }
 
+static void	proc_snapshot_free(proc_snapshot_t *proc)
+{
+	zbx_free(proc->name);
+	zbx_free(proc->name_arg0);
+	zbx_free(proc->cmdline);
+
+	zbx_free(proc);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reads process data for snapshot                                   *
+ *                                                                            *
+ * Parameters: pid - [IN] process identifier (/proc directory entry name)     *
+ *                                                                            *
+ * Return value: The process data or NULL if process files cannot be opened.  *
+ *                                                                            *
+ ******************************************************************************/
+static proc_snapshot_t	*proc_snapshot_read(const char *pid)
+{
+	char		tmp[MAX_STRING_LEN], *cmdline = NULL, *p;
+	FILE		*f_cmd, *f_stat;
+	size_t		l;
+	proc_snapshot_t	*proc;
+
+	zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/cmdline", pid);
+
+	if (NULL == (f_cmd = fopen(tmp, "r")))
+		return NULL;
+
+	zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/status", pid);
+
+	if (NULL == (f_stat = fopen(tmp, "r")))
+	{
+		zbx_fclose(f_cmd);
+		return NULL;
+	}
+
+	proc = (proc_snapshot_t *)zbx_malloc(NULL, sizeof(proc_snapshot_t));
+	memset(proc, 0, sizeof(proc_snapshot_t));
+	proc->uid = ZBX_MAX_UINT64;
+
+	if (SUCCEED == get_cmdline(f_cmd, &cmdline, &l))
+	{
+		if (NULL == (p = strrchr(cmdline, '/')))
+			p = cmdline;
+		else
+			p++;
+
+		proc->name_arg0 = zbx_strdup(NULL, p);
+
+		l = l - 2;
+
+		for (size_t i = 0; i < l; i++)
+			if ('\0' == cmdline[i])
+				cmdline[i] = ' ';
+
+		proc->cmdline = cmdline;
+	}
+
+	while (NULL != fgets(tmp, (int)sizeof(tmp), f_stat))
+	{
+		if (0 == strncmp(tmp, "Name:\t", ZBX_CONST_STRLEN("Name:\t")))
+		{
+			if (NULL == proc->name)
+			{
+				zbx_rtrim(tmp + ZBX_CONST_STRLEN("Name:\t"), "\n");
+				proc->name = zbx_strdup(NULL, tmp + ZBX_CONST_STRLEN("Name:\t"));
+			}
+		}
+		else if (0 == strncmp(tmp, "State:\t", ZBX_CONST_STRLEN("State:\t")))
+		{
+			if ('\0' == proc->state)
+				proc->state = tmp[ZBX_CONST_STRLEN("State:\t")];
+		}
+		else if (0 == strncmp(tmp, "Uid:", ZBX_CONST_STRLEN("Uid:")))
+		{
+			for (p = tmp + ZBX_CONST_STRLEN("Uid:"); ' ' == *p || '\t' == *p; p++)
+				;
+
+			proc->uid = (zbx_uint64_t)atoi(p);
+		}
+		else if (0 == strncmp(tmp, "Vm", ZBX_CONST_STRLEN("Vm")))
+		{
+			for (int i = 0; i < PROC_SNAPSHOT_VM_NUM; i++)
+			{
+				size_t	label_len = strlen(proc_snapshot_vm_labels[i]);
+
+				if (0 != strncmp(tmp, proc_snapshot_vm_labels[i], label_len))
+					continue;
+
+				if (SUCCEED == parse_byte_value(tmp + label_len, &proc->vm[i]))
+					proc->vm_found |= 1U << i;
+				else
+					proc->vm_invalid |= 1U << i;
+
+				break;
+			}
+		}
+	}
+
+	zbx_fclose(f_cmd);
+	zbx_fclose(f_stat);
+
+	return proc;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: refreshes system process snapshot if it is older than             *
+ *          PROC_SNAPSHOT_TTL                                                 *
+ *                                                                            *
+ * Return value: SUCCEED - snapshot is up to date                             *
+ *               FAIL    - failed to open /proc directory, errno is set       *
+ *                                                                            *
+ ******************************************************************************/
+static int	proc_snapshot_update(void)
+{
+	DIR		*dir;
+	struct dirent	*entries;
+	double		now;
+	proc_snapshot_t	*proc;
+
+	now = zbx_time();
+
+	if (0 == proc_snapshot_initialized)
+	{
+		zbx_vector_proc_snapshot_ptr_create(&proc_snapshot);
+		proc_snapshot_initialized = 1;
+	}
+	else if (now >= proc_snapshot_time && now - proc_snapshot_time < PROC_SNAPSHOT_TTL)
+		return SUCCEED;
+
+	zbx_vector_proc_snapshot_ptr_clear_ext(&proc_snapshot, proc_snapshot_free);
+	proc_snapshot_time = 0;
+
+	if (NULL == (dir = opendir("/proc")))
+		return FAIL;
+
+	while (NULL != (entries = readdir(dir)))
+	{
+		if (0 == atoi(entries->d_name))
+			continue;
+
+		if (NULL != (proc = proc_snapshot_read(entries->d_name)))
+			zbx_vector_proc_snapshot_ptr_append(&proc_snapshot, proc);
+	}
+
+	closedir(dir);
+
+	proc_snapshot_time = now;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if snapshot process matches name, user and command line    *
+ *          filters                                                           *
+ *                                                                            *
+ ******************************************************************************/
+static int	proc_snapshot_match(const proc_snapshot_t *proc, const char *procname, const struct passwd *usrinfo,
+		const zbx_regexp_t *proccomm_rxp)
+{
+	/* process name in /proc/[pid]/status contains limited number of characters */
+	if (NULL != procname && '\0' != *procname && (NULL == proc->name || 0 != strcmp(proc->name, procname)) &&
+			(NULL == proc->name_arg0 || 0 != strcmp(proc->name_arg0, procname)))
+	{
+		return FAIL;
+	}
+
+	if (NULL != usrinfo && usrinfo->pw_uid != proc->uid)
+		return FAIL;
+
+	if (NULL != proccomm_rxp && (NULL == proc->cmdline ||
+			0 != zbx_regexp_match_precompiled(proc->cmdline, proccomm_rxp)))
+	{
+		return FAIL;
+	}
+
+	return SUCCEED;
+}
+
+static int	proc_snapshot_match_state(const proc_snapshot_t *proc, int zbx_proc_stat)
+{
+	switch (zbx_proc_stat)
+	{
+		case ZBX_PROC_STAT_ALL:
+			return SUCCEED;
+		case ZBX_PROC_STAT_RUN:
+			return ('R' == proc->state) ? SUCCEED : FAIL;
+		case ZBX_PROC_STAT_SLEEP:
+			return ('S' == proc->state) ? SUCCEED : FAIL;
+		case ZBX_PROC_STAT_ZOMB:
+			return ('Z' == proc->state) ? SUCCEED : FAIL;
+		case ZBX_PROC_STAT_DISK:
+			return ('D' == proc->state) ? SUCCEED : FAIL;
+		case ZBX_PROC_STAT_TRACE:
+			return ('T' == proc->state) ? SUCCEED : FAIL;
+		default:
+			return FAIL;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets memory statistics of snapshot process                        *
+ *                                                                            *
+ * Parameters: proc  - [IN] snapshot process                                  *
+ *             label - [IN] memory statistics label, e.g. "VmData:\t"         *
+ *             bytes - [OUT] result in bytes                                  *
+ *                                                                            *
+ * Return value: SUCCEED      - statistics were returned                      *
+ *               NOTSUPPORTED - statistics were not found                     *
+ *               FAIL         - statistics were found but could not be parsed *
+ *                                                                            *
+ ******************************************************************************/
+static int	proc_snapshot_vm_get(const proc_snapshot_t *proc, const char *label, zbx_uint64_t *bytes)
+{
+	for (int i = 0; i < PROC_SNAPSHOT_VM_NUM; i++)
+	{
+		if (0 != strcmp(proc_snapshot_vm_labels[i], label))
+			continue;
+
+		if (0 != (proc->vm_invalid & (1U << i)))
+			return FAIL;
+
+		if (0 == (proc->vm_found & (1U << i)))
+			return NOTSUPPORTED;
+
+		*bytes = proc->vm[i];
+
+		return SUCCEED;
+	}
+
+	return NOTSUPPORTED;
+}
+
 int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 {
 #define ZBX_SIZE	0
@@ -685,12 +858,9 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 #define ZBX_VMEXE	12
 #define ZBX_VMPTE	13
 
-	char		tmp[MAX_STRING_LEN], *procname, *proccomm, *param;
-	DIR		*dir;
-	struct dirent	*entries;
+	char		*procname, *proccomm, *param;
 	struct passwd	*usrinfo;
 	zbx_regexp_t	*proccomm_rxp = NULL;
-	FILE		*f_cmd = NULL, *f_stat = NULL;
 	zbx_uint64_t	mem_size = 0, byte_value = 0, total_memory;
 	double		pct_size = 0.0, pct_value = 0.0;
 	int		do_task, res, mem_type_code, mem_type_tried = 0, proccount = 0, invalid_user = 0,
@@ -863,42 +1033,20 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 		}
 	}
 
-	if (NULL == (dir = opendir("/proc")))
+	if (SUCCEED != proc_snapshot_update())
 	{
 		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "Cannot open /proc: %s", zbx_strerror(errno)));
 		ret = SYSINFO_RET_FAIL;
 		goto clean_re;
 	}
 
-	while (NULL != (entries = readdir(dir)))
+	for (int i = 0; i < proc_snapshot.values_num; i++)
 	{
-		zbx_fclose(f_cmd);
-		zbx_fclose(f_stat);
-
-		if (0 == atoi(entries->d_name))
-			continue;
+		const proc_snapshot_t	*proc = proc_snapshot.values[i];
 
-		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/cmdline", entries->d_name);
-
-		if (NULL == (f_cmd = fopen(tmp, "r")))
+		if (SUCCEED != proc_snapshot_match(proc, procname, usrinfo, proccomm_rxp))
 			continue;
 
-		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/status", entries->d_name);
-
-		if (NULL == (f_stat = fopen(tmp, "r")))
-			continue;
-
-		if (FAIL == check_procname(f_cmd, f_stat, procname))
-			continue;
-
-		if (FAIL == check_user(f_stat, usrinfo))
-			continue;
-
-		if (FAIL == check_proccomm(f_cmd, proccomm_rxp))
-			continue;
-
-		rewind(f_stat);
-
 		if (0 == mem_type_tried)
 			mem_type_tried = 1;
 
@@ -916,7 +1064,7 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 			case ZBX_VMSTK:
 			case ZBX_VMEXE:
 			case ZBX_VMPTE:
-				res = byte_value_from_proc_file(f_stat, mem_type_search, NULL, &byte_value);
+				res = proc_snapshot_vm_get(proc, mem_type_search, &byte_value);
 
 				if (NOTSUPPORTED == res)
 					continue;
@@ -931,24 +1079,19 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 				{
 					zbx_uint64_t	m;
 
-					/* VmData, VmStk and VmExe follow in /proc/PID/status file in that order. */
-					/* Therefore we do not rewind f_stat between calls. */
-
 					mem_type_search = "VmData:\t";
 
-					if (SUCCEED == (res = byte_value_from_proc_file(f_stat, mem_type_search, NULL,
-							&byte_value)))
+					if (SUCCEED == (res = proc_snapshot_vm_get(proc, mem_type_search, &byte_value)))
 					{
 						mem_type_search = "VmStk:\t";
 
-						if (SUCCEED == (res = byte_value_from_proc_file(f_stat, mem_type_search,
-								NULL, &m)))
+						if (SUCCEED == (res = proc_snapshot_vm_get(proc, mem_type_search, &m)))
 						{
 							byte_value += m;
 							mem_type_search = "VmExe:\t";
 
-							if (SUCCEED == (res = byte_value_from_proc_file(f_stat,
-									mem_type_search, NULL, &m)))
+							if (SUCCEED == (res = proc_snapshot_vm_get(proc,
+									mem_type_search, &m)))
 							{
 								byte_value += m;
 							}
@@ -973,7 +1116,7 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 				break;
 			case ZBX_PMEM:
 				mem_type_search = "VmRSS:\t";
-				res = byte_value_from_proc_file(f_stat, mem_type_search, NULL, &byte_value);
+				res = proc_snapshot_vm_get(proc, mem_type_search, &byte_value);
 
 				if (SUCCEED == res)
 				{
@@ -1021,10 +1164,6 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 		}
 	}
 clean:
-	zbx_fclose(f_cmd);
-	zbx_fclose(f_stat);
-	closedir(dir);
-
 	if ((0 == proccount && 0 != mem_type_tried) || 0 != invalid_read)
 	{
 		char	*s;
@@ -1074,12 +1213,9 @@ clean_re:
 
 int	proc_num(AGENT_REQUEST *request, AGENT_RESULT *result)
 {
-	char		tmp[MAX_STRING_LEN], *procname, *proccomm, *param, *rxp_error = NULL;
-	DIR		*dir;
-	struct dirent	*entries;
+	char		*procname, *proccomm, *param, *rxp_error = NULL;
 	struct passwd	*usrinfo;
 	zbx_regexp_t	*proccomm_rxp = NULL;
-	FILE		*f_cmd = NULL, *f_stat = NULL;
 	int		proccount = 0, invalid_user = 0, zbx_proc_stat, ret = SYSINFO_RET_OK;
 
 	if (4 < request->nparam)
@@ -1151,48 +1287,25 @@ int	proc_num(AGENT_REQUEST *request, AGENT_RESULT *result)
 	if (1 == invalid_user)	/* handle 0 for non-existent user after all parameters have been parsed and validated */
 		goto out;
 
-	if (NULL == (dir = opendir("/proc")))
+	if (SUCCEED != proc_snapshot_update())
 	{
 		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "Cannot open /proc: %s", zbx_strerror(errno)));
 		ret = SYSINFO_RET_FAIL;
 		goto clean;
 	}
 
-	while (NULL != (entries = readdir(dir)))
+	for (int i = 0; i < proc_snapshot.values_num; i++)
 	{
-		zbx_fclose(f_cmd);
-		zbx_fclose(f_stat);
-
-		if (0 == atoi(entries->d_name))
-			continue;
-
-		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/cmdline", entries->d_name);
-
-		if (NULL == (f_cmd = fopen(tmp, "r")))
-			continue;
-
-		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/status", entries->d_name);
-
-		if (NULL == (f_stat = fopen(tmp, "r")))
-			continue;
-
-		if (FAIL == check_procname(f_cmd, f_stat, procname))
-			continue;
+		const proc_snapshot_t	*proc = proc_snapshot.values[i];
 
-		if (FAIL == check_user(f_stat, usrinfo))
+		if (SUCCEED != proc_snapshot_match(proc, procname, usrinfo, proccomm_rxp))
 			continue;
 
-		if (FAIL == check_proccomm(f_cmd, proccomm_rxp))
-			continue;
-
-		if (FAIL == check_procstate(f_stat, zbx_proc_stat))
+		if (SUCCEED != proc_snapshot_match_state(proc, zbx_proc_stat))
 			continue;
 
 		proccount++;
 	}
-	zbx_fclose(f_cmd);
-	zbx_fclose(f_stat);
-	closedir(dir);
 out:
 	SET_UI64_RESULT(result, proccount);
 clean:
@@ -287,6 +287,30 @@ void	zbx_remove_user_parameters(void)
 	}
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if item key is defined as user parameter                   *
+ *                                                                            *
+ * Parameters: key - [IN] item key without parameters                         *
+ *                                                                            *
+ * Return value: SUCCEED - the key is user parameter                          *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_is_user_parameter(const char *key)
+{
+	if (NULL == commands)
+		return FAIL;
+
+	for (int i = 0; NULL != commands[i].key; i++)
+	{
+		if (0 != (CF_USERPARAMETER & commands[i].flags) && 0 == strcmp(commands[i].key, key))
+			return SUCCEED;
+	}
+
+	return FAIL;
+}
+
 void	zbx_get_metrics_copy(zbx_metric_t **metrics)
 {
 	unsigned int	i;
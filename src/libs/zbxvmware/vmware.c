@@ -27,6 +27,7 @@
 
 #ifdef HAVE_LIBXML2
 #	include <libxml/xpath.h>
+#	include <libxml/SAX2.h>
 #endif
 
 #include "zbxmutexs.h"
@@ -485,26 +486,24 @@ int	zbx_soap_post(const char *fn_parent, CURL *easyhandle, const char *request,
  * Parameters: xdoc      - [IN] xml document                                  *
  *             propmap   - [IN] xpaths of properties to read                  *
  *             props_num - [IN] number of properties to read                  *
+ *             props     - [OUT] property values                              *
  *                                                                            *
- * Return value: array of property values                                     *
- *                                                                            *
- * Comments: The array with property values must be freed by the caller.      *
+ * Comments: Properties read from property collection stream are skipped.     *
  *                                                                            *
  ******************************************************************************/
-char	**xml_read_props(xmlDoc *xdoc, const zbx_vmware_propmap_t *propmap, int props_num)
+static void	xml_read_props(xmlDoc *xdoc, const zbx_vmware_propmap_t *propmap, int props_num, char **props)
 {
 	xmlXPathContext	*xpathCtx;
 	xmlXPathObject	*xpathObj;
 	xmlNodeSetPtr	nodeset;
 	xmlChar		*val;
-	char		**props;
 	int		i;
 
-	props = (char **)zbx_malloc(NULL, sizeof(char *) * props_num);
-	memset(props, 0, sizeof(char *) * props_num);
-
 	for (i = 0; i < props_num; i++)
 	{
+		if (0 != propmap[i].stream)
+			continue;
+
 		xpathCtx = xmlXPathNewContext(xdoc);
 
 		if (NULL != (xpathObj = xmlXPathEvalExpression((const xmlChar *)propmap[i].xpath, xpathCtx)))
@@ -537,8 +536,616 @@ char	**xml_read_props(xmlDoc *xdoc, const zbx_vmware_propmap_t *propmap, int pro
 
 		xmlXPathFreeContext(xpathCtx);
 	}
+}
+
+/* streaming SOAP response parser state */
+typedef struct
+{
+	xmlParserCtxtPtr		ctxt;
+	const zbx_soap_sax_handler_t	*handler;
+	const char			*fn_parent;
+	int				depth;
+	int				leaf;		/* no child elements since the last start element */
+	int				fault;		/* inside SOAP Fault element */
+	int				detail;		/* inside SOAP Fault detail element */
+	int				returnval;	/* inside response returnval element */
+	int				build_doc;	/* response document is built while parsing */
+	char				*text;
+	size_t				text_alloc;
+	size_t				text_offset;
+	char				*faultstring;
+	char				*detail_name;
+	char				*detail_value;
+	char				*token;
+}
+zbx_soap_sax_t;
+
+static void	soap_sax_start_element(void *ctx, const xmlChar *localname, const xmlChar *prefix,
+		const xmlChar *URI, int nb_namespaces, const xmlChar **namespaces, int nb_attributes, int nb_defaulted,
+		const xmlChar **attributes)
+{
+	zbx_soap_sax_t	*sax = (zbx_soap_sax_t *)ctx;
+	const char	*name = (const char *)localname;
+	char		*type = NULL;
+
+	if (0 != sax->build_doc)
+	{
+		xmlSAX2StartElementNs(sax->ctxt, localname, prefix, URI, nb_namespaces, namespaces, nb_attributes,
+				nb_defaulted, attributes);
+	}
+
+	sax->depth++;
+	sax->leaf = 1;
+	sax->text_offset = 0;
+
+	if (NULL != sax->text)
+		*sax->text = '\0';
+
+	if (3 == sax->depth)
+	{
+		if (0 != (sax->fault = (0 == strcmp(name, "Fault"))) && NULL == sax->faultstring)
+			sax->faultstring = zbx_strdup(NULL, "");
+	}
+	else if (4 == sax->depth)
+	{
+		if (0 != sax->fault)
+			sax->detail = (0 == strcmp(name, "detail"));
+		else
+			sax->returnval = (0 == strcmp(name, "returnval"));
+	}
+	else if (5 == sax->depth && 0 != sax->detail && NULL == sax->detail_name)
+		sax->detail_name = zbx_strdup(NULL, name);
+
+	if (NULL == sax->handler || 0 != sax->fault)
+		return;
+
+	/* attributes are passed as localname/prefix/URI/value/end quintuples, only unprefixed type is used */
+	/* by vSphere API to specify managed object reference type                                          */
+	for (int i = 0; i < nb_attributes; i++)
+	{
+		const xmlChar	**attr = &attributes[i * 5];
+
+		if (NULL == attr[1] && 0 == strcmp((const char *)attr[0], "type"))
+		{
+			type = zbx_malloc(NULL, (size_t)(attr[4] - attr[3]) + 1);
+			memcpy(type, attr[3], (size_t)(attr[4] - attr[3]));
+			type[attr[4] - attr[3]] = '\0';
+			break;
+		}
+	}
+
+	if (NULL != sax->handler->start)
+		sax->handler->start(sax->handler->data, sax->depth, name, type);
+
+	zbx_free(type);
+}
+
+static void	soap_sax_end_element(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI)
+{
+	zbx_soap_sax_t	*sax = (zbx_soap_sax_t *)ctx;
+	const char	*name = (const char *)localname, *text = NULL;
+
+	if (0 != sax->build_doc)
+		xmlSAX2EndElementNs(sax->ctxt, localname, prefix, URI);
+
+	if (0 != sax->leaf)
+	{
+		if (NULL == sax->text)
+			zbx_strcpy_alloc(&sax->text, &sax->text_alloc, &sax->text_offset, "");
+
+		text = sax->text;
+	}
+
+	if (0 != sax->fault)
+	{
+		if (4 == sax->depth && NULL != text && 0 == strcmp(name, "faultstring"))
+			sax->faultstring = zbx_strdup(sax->faultstring, text);
+		else if (5 <= sax->depth && 0 != sax->detail && NULL == sax->detail_value && NULL != text &&
+				0 == strcmp(name, "name"))
+		{
+			sax->detail_value = zbx_strdup(NULL, text);
+		}
+	}
+	else
+	{
+		if (5 == sax->depth && 0 != sax->returnval && NULL != text && 0 == strcmp(name, "token"))
+			sax->token = zbx_strdup(sax->token, text);
+
+		if (NULL != sax->handler && NULL != sax->handler->end)
+			sax->handler->end(sax->handler->data, sax->depth, name, text);
+	}
+
+	if (3 == sax->depth)
+		sax->fault = 0;
+	else if (4 == sax->depth)
+		sax->detail = sax->returnval = 0;
+
+	sax->leaf = 0;
+	sax->depth--;
+}
+
+static void	soap_sax_characters(void *ctx, const xmlChar *ch, int len)
+{
+	zbx_soap_sax_t	*sax = (zbx_soap_sax_t *)ctx;
+
+	if (0 != sax->build_doc)
+		xmlSAX2Characters(sax->ctxt, ch, len);
+
+	if (0 != sax->leaf)
+		zbx_strncpy_alloc(&sax->text, &sax->text_alloc, &sax->text_offset, (const char *)ch, (size_t)len);
+}
+
+static void	soap_sax_cdata(void *ctx, const xmlChar *ch, int len)
+{
+	zbx_soap_sax_t	*sax = (zbx_soap_sax_t *)ctx;
+
+	if (0 != sax->build_doc)
+		xmlSAX2CDataBlock(sax->ctxt, ch, len);
+
+	if (0 != sax->leaf)
+		zbx_strncpy_alloc(&sax->text, &sax->text_alloc, &sax->text_offset, (const char *)ch, (size_t)len);
+}
+
+static void	soap_sax_start_document(void *ctx)
+{
+	zbx_soap_sax_t	*sax = (zbx_soap_sax_t *)ctx;
+
+	if (0 != sax->build_doc)
+		xmlSAX2StartDocument(sax->ctxt);
+}
+
+static void	soap_sax_end_document(void *ctx)
+{
+	zbx_soap_sax_t	*sax = (zbx_soap_sax_t *)ctx;
+
+	if (0 != sax->build_doc)
+		xmlSAX2EndDocument(sax->ctxt);
+}
+
+static void	soap_sax_error(void *ctx, const xmlError *error)
+{
+	ZBX_UNUSED(ctx);
+	ZBX_UNUSED(error);
+}
+
+static size_t	soap_sax_write_cb(void *ptr, size_t size, size_t nmemb, void *userdata)
+{
+	size_t		r_size = size * nmemb;
+	zbx_soap_sax_t	*sax = (zbx_soap_sax_t *)userdata;
+
+	if (NULL != sax->fn_parent)
+		zabbix_log(LOG_LEVEL_TRACE, "%s() SOAP response: %.*s", sax->fn_parent, (int)r_size, (char *)ptr);
+
+	xmlParseChunk(sax->ctxt, (const char *)ptr, (int)r_size, 0);
+
+	if (0 == sax->ctxt->wellFormed)
+		return 0;	/* abort transfer, the response is not valid XML */
+
+	return r_size;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: posts vmware web service request and parses response while        *
+ *          it is being received without building xml document                *
+ *                                                                            *
+ * Parameters: fn_parent  - [IN] parent function name for Log records         *
+ *             easyhandle - [IN] CURL handle                                  *
+ *             request    - [IN] http request                                 *
+ *             handler    - [IN] callbacks for response elements (optional)   *
+ *             xdoc       - [OUT] response xml document (optional)            *
+ *             token      - [OUT] soap token for next query (optional)        *
+ *             error      - [OUT] error message in case of failure            *
+ *                                                                            *
+ * Return value: SUCCEED - SOAP request was completed successfully            *
+ *               FAIL    - SOAP request has failed                            *
+ *                                                                            *
+ * Comments: Elements are reported to handler with depth counted from SOAP    *
+ *           Envelope (1) and text for elements without child elements.       *
+ *           Elements of SOAP Fault are not reported, instead the fault is    *
+ *           returned as error. Unless xdoc is requested only the current     *
+ *           element text is kept in memory, so the response size is not      *
+ *           limited by available memory. The xdoc is built by the same       *
+ *           parser, the raw response is never buffered.                      *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_soap_post_sax(const char *fn_parent, CURL *easyhandle, const char *request,
+		const zbx_soap_sax_handler_t *handler, xmlDoc **xdoc, char **token, char **error)
+{
+/* according to libxml2 changelog XML_PARSE_HUGE option was introduced in version 2.7.0 */
+#if 20700 <= LIBXML_VERSION	/* version 2.7.0 */
+#	define ZBX_SOAP_SAX_PARSE_OPTS	(XML_PARSE_HUGE | XML_PARSE_NONET)
+#else
+#	define ZBX_SOAP_SAX_PARSE_OPTS	XML_PARSE_NONET
+#endif
+	xmlSAXHandler	sax_handler;
+	zbx_soap_sax_t	sax;
+	ZBX_HTTPPAGE	*resp;
+	CURLoption	opt;
+	CURLcode	err;
+	int		ret = FAIL;
+
+	if (CURLE_OK != (err = curl_easy_getinfo(easyhandle, CURLINFO_PRIVATE, (char **)&resp)))
+	{
+		*error = zbx_dsprintf(*error, "Cannot get response buffer: %s.", curl_easy_strerror(err));
+		return FAIL;
+	}
+
+	memset(&sax_handler, 0, sizeof(sax_handler));
+	sax_handler.initialized = XML_SAX2_MAGIC;
+	sax_handler.startDocument = soap_sax_start_document;
+	sax_handler.endDocument = soap_sax_end_document;
+	sax_handler.startElementNs = soap_sax_start_element;
+	sax_handler.endElementNs = soap_sax_end_element;
+	sax_handler.characters = soap_sax_characters;
+	sax_handler.cdataBlock = soap_sax_cdata;
+	sax_handler.serror = (xmlStructuredErrorFunc)soap_sax_error;
+
+	memset(&sax, 0, sizeof(sax));
+	sax.handler = handler;
+	sax.fn_parent = fn_parent;
+	sax.build_doc = (NULL != xdoc);
 
-	return props;
+	if (NULL == (sax.ctxt = xmlCreatePushParserCtxt(&sax_handler, &sax, NULL, 0, NULL)))
+	{
+		*error = zbx_strdup(*error, "Cannot create XML parser.");
+		return FAIL;
+	}
+
+	xmlCtxtUseOptions(sax.ctxt, ZBX_SOAP_SAX_PARSE_OPTS);
+
+	if (CURLE_OK != (err = curl_easy_setopt(easyhandle, opt = CURLOPT_POSTFIELDS, request)) ||
+			CURLE_OK != (err = curl_easy_setopt(easyhandle, opt = CURLOPT_WRITEFUNCTION,
+					soap_sax_write_cb)) ||
+			CURLE_OK != (err = curl_easy_setopt(easyhandle, opt = CURLOPT_WRITEDATA, &sax)))
+	{
+		*error = zbx_dsprintf(*error, "Cannot set cURL option %d: %s.", (int)opt, curl_easy_strerror(err));
+		goto out;
+	}
+
+	if (CURLE_OK == (err = curl_easy_perform(easyhandle)))
+		xmlParseChunk(sax.ctxt, NULL, 0, 1);
+
+	/* write callback aborts transfer when received data is not valid XML */
+	if (CURLE_OK != err && (CURLE_WRITE_ERROR != err || 0 != sax.ctxt->wellFormed))
+	{
+		*error = zbx_strdup(*error, curl_easy_strerror(err));
+	}
+	else if (0 == sax.ctxt->wellFormed)
+	{
+		*error = zbx_strdup(*error, "Received response has no valid XML data.");
+	}
+	else if (NULL != sax.faultstring)
+	{
+		if ('\0' != *sax.faultstring || NULL == sax.detail_name)
+		{
+			*error = zbx_strdup(*error, sax.faultstring);
+		}
+		else
+		{
+			*error = zbx_dsprintf(*error, "%s:%s", sax.detail_name,
+					ZBX_NULL2EMPTY_STR(sax.detail_value));
+		}
+	}
+	else
+		ret = SUCCEED;
+
+out:
+	/* restore default response buffer */
+	if (CURLE_OK != (err = curl_easy_setopt(easyhandle, opt = CURLOPT_WRITEFUNCTION, curl_write_cb)) ||
+			CURLE_OK != (err = curl_easy_setopt(easyhandle, opt = CURLOPT_WRITEDATA, resp)))
+	{
+		*error = zbx_dsprintf(*error, "Cannot set cURL option %d: %s.", (int)opt, curl_easy_strerror(err));
+		ret = FAIL;
+	}
+
+	if (SUCCEED == ret && NULL != token)
+	{
+		*token = sax.token;
+		sax.token = NULL;
+	}
+	else if (SUCCEED == ret && NULL != sax.token && NULL != fn_parent)
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "%s() SOAP response has next unprocessed page: %s", fn_parent, sax.token);
+	}
+
+	if (NULL != sax.ctxt->myDoc)
+	{
+		if (SUCCEED == ret && NULL != xdoc)
+			*xdoc = sax.ctxt->myDoc;
+		else
+			xmlFreeDoc(sax.ctxt->myDoc);
+
+		sax.ctxt->myDoc = NULL;
+	}
+
+	xmlFreeParserCtxt(sax.ctxt);
+	zbx_free(sax.text);
+	zbx_free(sax.faultstring);
+	zbx_free(sax.detail_name);
+	zbx_free(sax.detail_value);
+	zbx_free(sax.token);
+
+	return ret;
+#	undef ZBX_SOAP_SAX_PARSE_OPTS
+}
+
+/* streaming property collection state */
+typedef struct
+{
+	zbx_property_collection_obj_func_t	obj_cb;
+	void					*data;
+	char					*type;
+	char					*id;
+	char					*prop_name;
+	char					*prop_value;
+	zbx_vector_vmware_key_value_t		props;
+}
+zbx_property_collection_sax_t;
+
+static void	property_collection_sax_clear(zbx_property_collection_sax_t *pc)
+{
+	zbx_free(pc->type);
+	zbx_free(pc->id);
+	zbx_free(pc->prop_name);
+	zbx_free(pc->prop_value);
+	zbx_vector_vmware_key_value_clear_ext(&pc->props, zbx_vmware_key_value_free);
+}
+
+static void	property_collection_sax_start(void *data, int depth, const char *name, const char *type)
+{
+	zbx_property_collection_sax_t	*pc = (zbx_property_collection_sax_t *)data;
+
+	/* Envelope/Body/RetrievePropertiesExResponse/returnval/objects/{obj,propSet/{name,val}} */
+	if (5 == depth && 0 == strcmp(name, "objects"))
+		property_collection_sax_clear(pc);
+	else if (6 == depth && 0 == strcmp(name, "obj") && NULL != type)
+		pc->type = zbx_strdup(pc->type, type);
+}
+
+static void	property_collection_sax_end(void *data, int depth, const char *name, const char *text)
+{
+	zbx_property_collection_sax_t	*pc = (zbx_property_collection_sax_t *)data;
+
+	if (7 == depth)
+	{
+		if (0 == strcmp(name, "name"))
+			pc->prop_name = zbx_strdup(pc->prop_name, text);
+		else if (0 == strcmp(name, "val") && NULL != text)
+			pc->prop_value = zbx_strdup(pc->prop_value, text);
+	}
+	else if (6 == depth)
+	{
+		if (0 == strcmp(name, "obj"))
+		{
+			pc->id = zbx_strdup(pc->id, text);
+		}
+		else if (0 == strcmp(name, "propSet") && NULL != pc->prop_name)
+		{
+			zbx_vmware_key_value_t	kv = {.key = pc->prop_name, .value = pc->prop_value};
+
+			zbx_vector_vmware_key_value_append(&pc->props, kv);
+			pc->prop_name = pc->prop_value = NULL;
+		}
+	}
+	else if (5 == depth && 0 == strcmp(name, "objects"))
+	{
+		if (NULL != pc->type && NULL != pc->id)
+			pc->obj_cb(pc->type, pc->id, &pc->props, pc->data);
+
+		property_collection_sax_clear(pc);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: moves objects of property collection page into the document of  *
+ *          the first page                                                    *
+ *                                                                            *
+ * Parameters: xdoc - [IN/OUT] first page document                            *
+ *             page - [IN] next page document                                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	property_collection_doc_merge(xmlDoc *xdoc, xmlDoc *page)
+{
+#	define ZBX_XPATH_RETURNVAL	"/*/*/*/*[local-name()='returnval'][1]"
+
+	xmlNode	*returnval, *page_returnval;
+
+	if (NULL == (returnval = zbx_xml_doc_get(xdoc, ZBX_XPATH_RETURNVAL)) ||
+			NULL == (page_returnval = zbx_xml_doc_get(page, ZBX_XPATH_RETURNVAL)))
+	{
+		return;
+	}
+
+	for (xmlNode *node = page_returnval->children; NULL != node; node = node->next)
+	{
+		if (XML_ELEMENT_NODE == node->type && 0 == xmlStrcmp(node->name, (const xmlChar *)"objects"))
+			xmlAddChild(returnval, xmlDocCopyNode(node, xdoc, 1));
+	}
+
+#	undef ZBX_XPATH_RETURNVAL
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: retrieves all pages of property collection, passing each object   *
+ *          to callback as soon as it is parsed                               *
+ *                                                                            *
+ * Parameters: fn_parent                 - [IN] parent function name for Log  *
+ *                                              records                       *
+ *             easyhandle                - [IN] CURL handle                   *
+ *             property_collection_query - [IN] RetrievePropertiesEx request  *
+ *             property_collector        - [IN] property collector id         *
+ *             obj_cb                    - [IN] callback for each object      *
+ *             data                      - [IN] callback data                 *
+ *             xdoc                      - [OUT] xml document with objects of *
+ *                                               all pages (optional)         *
+ *             error                     - [OUT] error message in case of     *
+ *                                               failure                      *
+ *                                                                            *
+ * Return value: SUCCEED - all pages were retrieved                           *
+ *               FAIL    - request has failed                                 *
+ *                                                                            *
+ * Comments: Only properties with simple values are passed to the callback    *
+ *           with value, properties with complex values have NULL value.      *
+ *           The xdoc is requested by callers that still need XPath for       *
+ *           complex values, objects of next pages are moved into the first   *
+ *           page document.                                                   *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_property_collection_stream(const char *fn_parent, CURL *easyhandle,
+		const char *property_collection_query, const char *property_collector,
+		zbx_property_collection_obj_func_t obj_cb, void *data, xmlDoc **xdoc, char **error)
+{
+#	define ZBX_POST_CONTINUE_RETRIEVE_PROPERTIES								\
+		ZBX_POST_VSPHERE_HEADER										\
+		"<ns0:ContinueRetrievePropertiesEx xsi:type=\"ns0:ContinueRetrievePropertiesExRequestType\">"	\
+			"<ns0:_this type=\"PropertyCollector\">%s</ns0:_this>"					\
+			"<ns0:token>%s</ns0:token>"								\
+		"</ns0:ContinueRetrievePropertiesEx>"								\
+		ZBX_POST_VSPHERE_FOOTER
+
+	zbx_property_collection_sax_t	pc = {.obj_cb = obj_cb, .data = data};
+	zbx_soap_sax_handler_t		handler = {property_collection_sax_start, property_collection_sax_end,
+							&pc};
+	char				*token = NULL, *token_esc, post[MAX_STRING_LEN];
+	int				ret;
+	xmlDoc				*page = NULL;
+
+	zbx_vector_vmware_key_value_create(&pc.props);
+
+	ret = zbx_soap_post_sax(fn_parent, easyhandle, property_collection_query, &handler, xdoc, &token, error);
+
+	while (SUCCEED == ret && NULL != token)
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "%s() continue retrieving properties with token: '%s'", __func__, token);
+
+		token_esc = zbx_xml_escape_dyn(token);
+		zbx_snprintf(post, sizeof(post), ZBX_POST_CONTINUE_RETRIEVE_PROPERTIES, property_collector, token_esc);
+		zbx_free(token_esc);
+		zbx_free(token);
+
+		property_collection_sax_clear(&pc);
+		ret = zbx_soap_post_sax(fn_parent, easyhandle, post, &handler, NULL == xdoc ? NULL : &page, &token,
+				error);
+
+		if (NULL != page)
+		{
+			property_collection_doc_merge(*xdoc, page);
+			zbx_xml_doc_free(page);
+			page = NULL;
+		}
+	}
+
+	if (SUCCEED != ret && NULL != xdoc)
+	{
+		zbx_xml_doc_free(*xdoc);
+		*xdoc = NULL;
+	}
+
+	zbx_free(token);
+	property_collection_sax_clear(&pc);
+	zbx_vector_vmware_key_value_destroy(&pc.props);
+
+	return ret;
+
+#	undef ZBX_POST_CONTINUE_RETRIEVE_PROPERTIES
+}
+
+/* object properties read from property collection stream */
+typedef struct
+{
+	const char			*type;
+	const zbx_vmware_propmap_t	*propmap;
+	int				props_num;
+	char				**props;
+	int				found;
+}
+zbx_property_collection_props_t;
+
+static void	property_collection_props_parse(const char *type, const char *id,
+		const zbx_vector_vmware_key_value_t *props, void *data)
+{
+	zbx_property_collection_props_t	*pp = (zbx_property_collection_props_t *)data;
+
+	ZBX_UNUSED(id);
+
+	/* the same as xpath of propmap, only the first object of requested type is read */
+	if (0 != pp->found || 0 != strcmp(type, pp->type))
+		return;
+
+	pp->found = 1;
+
+	for (int i = 0; i < props->values_num; i++)
+	{
+		const zbx_vmware_key_value_t	*kv = &props->values[i];
+
+		/* empty value has no text node, xpath reads it as missing */
+		if (NULL == kv->value || '\0' == *kv->value)
+			continue;
+
+		for (int j = 0; j < pp->props_num; j++)
+		{
+			if (0 != pp->propmap[j].stream && NULL == pp->props[j] &&
+					0 == strcmp(pp->propmap[j].name, kv->key))
+			{
+				pp->props[j] = zbx_strdup(NULL, kv->value);
+			}
+		}
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: retrieves vmware object properties with property collection       *
+ *          stream                                                            *
+ *                                                                            *
+ * Parameters: fn_parent                 - [IN] parent function name for Log  *
+ *                                              records                       *
+ *             easyhandle                - [IN] CURL handle                   *
+ *             property_collection_query - [IN] RetrievePropertiesEx request  *
+ *             property_collector        - [IN] property collector id         *
+ *             type                      - [IN] object type                   *
+ *             propmap                   - [IN] properties to read            *
+ *             props_num                 - [IN] number of properties to read  *
+ *             props                     - [OUT] property values              *
+ *             xdoc                      - [OUT] xml document of response     *
+ *             error                     - [OUT] error message in case of     *
+ *                                               failure                      *
+ *                                                                            *
+ * Return value: SUCCEED - properties were retrieved                          *
+ *               FAIL    - request has failed                                 *
+ *                                                                            *
+ * Comments: Simple properties marked for stream are taken while response is  *
+ *           parsed. The document is built in the same pass for complex       *
+ *           properties and the remaining propmap xpaths, which avoids        *
+ *           buffering the raw response and evaluating xpath for every simple *
+ *           property.                                                        *
+ *           The array with property values must be freed by the caller.      *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_property_collection_read_props(const char *fn_parent, CURL *easyhandle,
+		const char *property_collection_query, const char *property_collector, const char *type,
+		const zbx_vmware_propmap_t *propmap, int props_num, char ***props, xmlDoc **xdoc, char **error)
+{
+	zbx_property_collection_props_t	pp = {.type = type, .propmap = propmap, .props_num = props_num};
+	int				ret;
+
+	pp.props = (char **)zbx_malloc(NULL, sizeof(char *) * (size_t)props_num);
+	memset(pp.props, 0, sizeof(char *) * (size_t)props_num);
+
+	if (SUCCEED != (ret = zbx_property_collection_stream(fn_parent, easyhandle, property_collection_query,
+			property_collector, property_collection_props_parse, &pp, xdoc, error)))
+	{
+		vmware_props_free(pp.props, props_num);
+		return ret;
+	}
+
+	xml_read_props(*xdoc, propmap, props_num, pp.props);
+	*props = pp.props;
+
+	return ret;
 }
 
 /******************************************************************************
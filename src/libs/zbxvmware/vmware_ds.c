@@ -367,55 +367,69 @@ out:
 
 /******************************************************************************
  *                                                                            *
- * Purpose: populates array of values from xml data                           *
+ * Purpose: finds value of property by name suffix                            *
  *                                                                            *
- * Parameters: xdoc    - [IN] xml document                                    *
- *             ds_node - [IN] xml node with datastore info                    *
- *             ds_id   - [IN] datastore id (for logging)                      *
+ * Parameters: props  - [IN] object properties                                *
+ *             suffix - [IN] property name suffix                             *
  *                                                                            *
- * Return: bitmap value of HV access mode to DS                               *
+ * Return value: property value or NULL if not found                          *
  *                                                                            *
  ******************************************************************************/
-static zbx_uint64_t	vmware_hv_get_ds_access(xmlDoc *xdoc, xmlNode *ds_node, const char *ds_id)
+static const char	*vmware_props_get_by_suffix(const zbx_vector_vmware_key_value_t *props, const char *suffix)
 {
-#	define ZBX_XPATH_PROP_SUFFIX(property)									\
-		"*[local-name()='propSet'][*[local-name()='name']"						\
-		"[substring(text(),string-length(text())-string-length('" property "')+1)='" property "']]"	\
-		"/*[local-name()='val']"
+	size_t	suffix_len = strlen(suffix);
+
+	for (int i = 0; i < props->values_num; i++)
+	{
+		const zbx_vmware_key_value_t	*prop = &props->values[i];
+		size_t				len = strlen(prop->key);
+
+		if (len >= suffix_len && 0 == strcmp(prop->key + len - suffix_len, suffix))
+			return prop->value;
+	}
+
+	return NULL;
+}
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets hv access mode to ds from datastore properties               *
+ *                                                                            *
+ * Parameters: props - [IN] datastore properties                              *
+ *             ds_id - [IN] datastore id (for logging)                        *
+ *                                                                            *
+ * Return: bitmap value of HV access mode to DS                               *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_uint64_t	vmware_hv_get_ds_access(const zbx_vector_vmware_key_value_t *props, const char *ds_id)
+{
 	zbx_uint64_t	mi_access = ZBX_VMWARE_DS_NONE;
-	char		*value;
+	const char	*value;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() for DS:%s", __func__, ds_id);
 
-	if (NULL != (value = zbx_xml_node_read_value(xdoc, ds_node, ZBX_XPATH_PROP_SUFFIX("mounted"))))
+	if (NULL != (value = vmware_props_get_by_suffix(props, "mounted")))
 	{
 		if (0 == strcmp(value, "true"))
 			mi_access |= ZBX_VMWARE_DS_MOUNTED;
-
-		zbx_free(value);
 	}
 	else
 		zabbix_log(LOG_LEVEL_DEBUG, "Cannot find item 'mounted' in mountinfo for DS:%s", ds_id);
 
-	if (NULL != (value = zbx_xml_node_read_value(xdoc, ds_node, ZBX_XPATH_PROP_SUFFIX("accessible"))))
+	if (NULL != (value = vmware_props_get_by_suffix(props, "accessible")))
 	{
 		if (0 == strcmp(value, "true"))
 			mi_access |= ZBX_VMWARE_DS_ACCESSIBLE;
-
-		zbx_free(value);
 	}
 	else
 		zabbix_log(LOG_LEVEL_DEBUG, "Cannot find item 'accessible' in accessible for DS:%s", ds_id);
 
-	if (NULL != (value = zbx_xml_node_read_value(xdoc, ds_node, ZBX_XPATH_PROP_SUFFIX("accessMode"))))
+	if (NULL != (value = vmware_props_get_by_suffix(props, "accessMode")))
 	{
 		if (0 == strcmp(value, "readWrite"))
 			mi_access |= ZBX_VMWARE_DS_READWRITE;
 		else
 			mi_access |= ZBX_VMWARE_DS_READ;
-
-		zbx_free(value);
 	}
 	else
 		zabbix_log(LOG_LEVEL_DEBUG, "Cannot find item 'accessMode' in mountinfo for DS:%s", ds_id);
@@ -423,93 +437,60 @@ static zbx_uint64_t	vmware_hv_get_ds_access(xmlDoc *xdoc, xmlNode *ds_node, cons
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() mountinfo:" ZBX_FS_UI64, __func__, mi_access);
 
 	return mi_access;
-#	undef ZBX_XPATH_PROP_SUFFIX
 }
 
+typedef struct
+{
+	const zbx_vector_str_t			*hv_dss;
+	const char				*hv_uuid;
+	const char				*hv_id;
+	zbx_vector_vmware_datastore_ptr_t	*dss;
+	int					parsed_num;
+}
+zbx_vmware_hv_ds_access_t;
+
 /******************************************************************************
  *                                                                            *
- * Purpose: reads access state of hv to ds                                    *
+ * Purpose: reads access state of hv to ds from streamed property collection  *
+ *          object                                                            *
  *                                                                            *
- * Parameters: xdoc    - [IN] xml data with DS access info                    *
- *             hv_dss  - [IN] vector with all DS connected to HV              *
- *             hv_uuid - [IN] uuid of HV                                      *
- *             hv_id   - [IN] id of HV (for logging)                          *
- *             dss     - [IN/OUT] vector with all datastores                  *
- *                                                                            *
- * Return value: count of updated DS                                          *
+ * Parameters: type  - [IN] object type                                       *
+ *             id    - [IN] object id                                         *
+ *             props - [IN] object properties                                 *
+ *             data  - [IN/OUT] hv datastore access update data               *
  *                                                                            *
  ******************************************************************************/
-static int	vmware_hv_ds_access_parse(xmlDoc *xdoc, const zbx_vector_str_t *hv_dss, const char *hv_uuid,
-		const char *hv_id, zbx_vector_vmware_datastore_ptr_t *dss)
+static void	vmware_hv_ds_access_parse(const char *type, const char *id,
+		const zbx_vector_vmware_key_value_t *props, void *data)
 {
-	int		parsed_num = 0;
-	xmlXPathContext	*xpathCtx;
-	xmlXPathObject	*xpathObj;
-	xmlNodeSetPtr	nodeset;
-
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+	zbx_vmware_hv_ds_access_t	*access = (zbx_vmware_hv_ds_access_t *)data;
+	int				j;
+	zbx_vmware_datastore_t		*ds, ds_cmp;
+	zbx_str_uint64_pair_t		hv_ds_access;
 
-	xpathCtx = xmlXPathNewContext(xdoc);
+	if (0 != strcmp(type, ZBX_VMWARE_SOAP_DS))
+		return;
 
-	if (NULL == (xpathObj = xmlXPathEvalExpression((xmlChar *)ZBX_XPATH_OBJECTS_BY_TYPE(ZBX_VMWARE_SOAP_DS),
-			xpathCtx)))
+	if (FAIL == (j = zbx_vector_str_bsearch(access->hv_dss, id, ZBX_DEFAULT_STR_COMPARE_FUNC)))
 	{
-		zabbix_log(LOG_LEVEL_DEBUG, "Cannot make xpath for Datastore list query.");
-		goto clean;
+		zabbix_log(LOG_LEVEL_DEBUG, "DS:%s not connected to HV:%s", id, access->hv_id);
+		return;
 	}
 
-	if (0 != xmlXPathNodeSetIsEmpty(xpathObj->nodesetval))
-	{
-		zabbix_log(LOG_LEVEL_DEBUG, "Cannot find Datastores in the list.");
-		goto clean;
-	}
-
-	nodeset = xpathObj->nodesetval;
+	ds_cmp.id = access->hv_dss->values[j];
 
-	for (int i = 0; i < nodeset->nodeNr; i++)
+	if (FAIL == (j = zbx_vector_vmware_datastore_ptr_bsearch(access->dss, &ds_cmp, vmware_ds_id_compare)))
 	{
-		int				j;
-		char				*value;
-		zbx_vmware_datastore_t		*ds, ds_cmp;
-		zbx_str_uint64_pair_t		hv_ds_access;
-
-		if (NULL == (value = zbx_xml_node_read_value(xdoc, nodeset->nodeTab[i], ZBX_XPATH_NN("obj"))))
-		{
-			zabbix_log(LOG_LEVEL_DEBUG, "skipping DS record without ID, xml number '%d'", i);
-			continue;
-		}
-
-		if (FAIL == (j = zbx_vector_str_bsearch(hv_dss, value, ZBX_DEFAULT_STR_COMPARE_FUNC)))
-		{
-			zabbix_log(LOG_LEVEL_DEBUG, "DS:%s not connected to HV:%s", value, hv_id);
-			zbx_str_free(value);
-			continue;
-		}
-
-		zbx_str_free(value);
-
-		ds_cmp.id = hv_dss->values[j];
-
-		if (FAIL == (j = zbx_vector_vmware_datastore_ptr_bsearch(dss, &ds_cmp, vmware_ds_id_compare)))
-		{
-			zabbix_log(LOG_LEVEL_DEBUG, "%s(): Datastore \"%s\" not found on hypervisor \"%s\".", __func__,
-					ds_cmp.id, hv_id);
-			continue;
-		}
-
-		ds = dss->values[j];
-		hv_ds_access.name = zbx_strdup(NULL, hv_uuid);
-		hv_ds_access.value = vmware_hv_get_ds_access(xdoc, nodeset->nodeTab[i], ds->id);
-		zbx_vector_str_uint64_pair_append_ptr(&ds->hv_uuids_access, &hv_ds_access);
-		parsed_num++;
+		zabbix_log(LOG_LEVEL_DEBUG, "%s(): Datastore \"%s\" not found on hypervisor \"%s\".", __func__,
+				ds_cmp.id, access->hv_id);
+		return;
 	}
-clean:
-	xmlXPathFreeObject(xpathObj);
-	xmlXPathFreeContext(xpathCtx);
 
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() parsed:%d", __func__, parsed_num);
-
-	return parsed_num;
+	ds = access->dss->values[j];
+	hv_ds_access.name = zbx_strdup(NULL, access->hv_uuid);
+	hv_ds_access.value = vmware_hv_get_ds_access(props, ds->id);
+	zbx_vector_str_uint64_pair_append_ptr(&ds->hv_uuids_access, &hv_ds_access);
+	access->parsed_num++;
 }
 
 /******************************************************************************
@@ -559,9 +540,8 @@ int	vmware_hv_ds_access_update(zbx_vmware_service_t *service, CURL *easyhandle,
 
 	char				*hvid_esc, tmp[MAX_STRING_LEN];
 	const char			*pcollector = get_vmware_service_objects()[service->type].property_collector;
-	int				ret = FAIL, updated = 0;
-	xmlDoc				*doc = NULL;
-	zbx_property_collection_iter	*iter = NULL;
+	int				ret;
+	zbx_vmware_hv_ds_access_t	access = {hv_dss, hv_uuid, hv_id, dss, 0};
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() hv id:%s hv dss:%d dss:%d", __func__, hv_id, hv_dss->values_num,
 			dss->values_num);
@@ -570,27 +550,11 @@ int	vmware_hv_ds_access_update(zbx_vmware_service_t *service, CURL *easyhandle,
 	zbx_snprintf(tmp, sizeof(tmp), ZBX_POST_HV_DS_ACCESS, pcollector, hvid_esc, hvid_esc, hvid_esc, hvid_esc);
 	zbx_free(hvid_esc);
 
-	if (SUCCEED != zbx_property_collection_init(easyhandle, tmp, pcollector, __func__, &iter, &doc, error))
-		goto out;
-
-	updated += vmware_hv_ds_access_parse(doc, hv_dss, hv_uuid, hv_id, dss);
-
-	while (NULL != iter->token)
-	{
-		zbx_xml_doc_free(doc);
-
-		if (SUCCEED != zbx_property_collection_next(__func__, iter, &doc, error))
-			goto out;
-
-		updated += vmware_hv_ds_access_parse(doc, hv_dss, hv_uuid, hv_id, dss);
-	}
+	ret = zbx_property_collection_stream(__func__, easyhandle, tmp, pcollector, vmware_hv_ds_access_parse,
+			&access, NULL, error);
 
-	ret = SUCCEED;
-out:
-	zbx_property_collection_free(iter);
-	zbx_xml_doc_free(doc);
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s for %d / %d", __func__, zbx_result_string(ret), updated,
-			hv_dss->values_num);
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s for %d / %d", __func__, zbx_result_string(ret),
+			access.parsed_num, hv_dss->values_num);
 
 	return ret;
 
@@ -35,9 +35,9 @@
 #endif
 
 #define ZBX_HVPROPMAP_EXT(property, func, ver)								\
-	{property, ZBX_XPATH_PROP_OBJECT(ZBX_VMWARE_SOAP_HV) ZBX_XPATH_PROP_NAME_NODE(property), func, ver}
-#define ZBX_HVPROPMAP(property)			\
-	ZBX_HVPROPMAP_EXT(property, NULL, 0)
+	{property, ZBX_XPATH_PROP_OBJECT(ZBX_VMWARE_SOAP_HV) ZBX_XPATH_PROP_NAME_NODE(property), func, ver, 0}
+#define ZBX_HVPROPMAP(property)										\
+	{property, ZBX_XPATH_PROP_OBJECT(ZBX_VMWARE_SOAP_HV) ZBX_XPATH_PROP_NAME_NODE(property), NULL, 0, 1}
 
 #define ZBX_XPATH_HV_SENSOR_STATUS(node, sensor)			\
 	ZBX_XPATH_PROP_NAME(node) "/*[local-name()='HostNumericSensorInfo']"				\
@@ -57,7 +57,7 @@ static zbx_vmware_propmap_t	hv_propmap[] = {
 	ZBX_HVPROPMAP("summary.hardware.vendor"), 		/* ZBX_VMWARE_HVPROP_HW_VENDOR */
 	ZBX_HVPROPMAP("summary.quickStats.overallMemoryUsage"),	/* ZBX_VMWARE_HVPROP_MEMORY_USED */
 	{NULL, ZBX_XPATH_HV_SENSOR_STATUS("runtime.healthSystemRuntime.systemHealthInfo.numericSensorInfo",
-			"VMware Rollup Health State"), NULL, 0},/* ZBX_VMWARE_HVPROP_HEALTH_STATE */
+			"VMware Rollup Health State"), NULL, 0, 0},/* ZBX_VMWARE_HVPROP_HEALTH_STATE */
 	ZBX_HVPROPMAP("summary.quickStats.uptime"),		/* ZBX_VMWARE_HVPROP_UPTIME */
 	ZBX_HVPROPMAP("summary.config.product.version"),	/* ZBX_VMWARE_HVPROP_VERSION */
 	ZBX_HVPROPMAP("summary.config.name"),			/* ZBX_VMWARE_HVPROP_NAME */
@@ -67,7 +67,7 @@ static zbx_vmware_propmap_t	hv_propmap[] = {
 			zbx_xmlnode_to_json, 0),		/* ZBX_VMWARE_HVPROP_SENSOR */
 	{"config.network.dnsConfig", "concat("			/* ZBX_VMWARE_HVPROP_NET_NAME */
 			ZBX_XPATH_PROP_NAME("config.network.dnsConfig") "/*[local-name()='hostName']" ",'.',"
-			ZBX_XPATH_PROP_NAME("config.network.dnsConfig") "/*[local-name()='domainName'])", NULL, 0},
+			ZBX_XPATH_PROP_NAME("config.network.dnsConfig") "/*[local-name()='domainName'])", NULL, 0, 0},
 	ZBX_HVPROPMAP("parent"),				/* ZBX_VMWARE_HVPROP_PARENT */
 	ZBX_HVPROPMAP("runtime.connectionState"),		/* ZBX_VMWARE_HVPROP_CONNECTIONSTATE */
 	ZBX_HVPROPMAP_EXT("hardware.systemInfo.serialNumber", NULL, 67),/* ZBX_VMWARE_HVPROP_HW_SERIALNUMBER */
@@ -239,6 +239,7 @@ void	vmware_hv_clean(zbx_vmware_hv_t *hv)
  *             propmap    - [IN] xpaths of properties to read                 *
  *             props_num  - [IN] number of properties to read                 *
  *             cq_prop    - [IN] soap part of query with cq property          *
+ *             hv_props   - [OUT] values of propmap properties                *
  *             xdoc       - [OUT] reference to output xml document            *
  *             error      - [OUT] error message in case of failure            *
  *                                                                            *
@@ -247,7 +248,8 @@ void	vmware_hv_clean(zbx_vmware_hv_t *hv)
  *                                                                            *
  ******************************************************************************/
 static int	vmware_service_get_hv_data(const zbx_vmware_service_t *service, CURL *easyhandle, const char *hvid,
-		const zbx_vmware_propmap_t *propmap, int props_num, const char *cq_prop, xmlDoc **xdoc, char **error)
+		const zbx_vmware_propmap_t *propmap, int props_num, const char *cq_prop, char ***hv_props,
+		xmlDoc **xdoc, char **error)
 {
 #	define ZBX_POST_HV_DETAILS 										\
 		ZBX_POST_VSPHERE_HEADER										\
@@ -277,8 +279,9 @@ static int	vmware_service_get_hv_data(const zbx_vmware_service_t *service, CURL
 		"</ns0:RetrievePropertiesEx>"									\
 		ZBX_POST_VSPHERE_FOOTER
 
-	char	*tmp, props[ZBX_VMWARE_HVPROPS_NUM * 150], *hvid_esc;
-	int	ret = FAIL;
+	char		*tmp, props[ZBX_VMWARE_HVPROPS_NUM * 150], *hvid_esc;
+	const char	*pcollector = get_vmware_service_objects()[service->type].property_collector;
+	int		ret = FAIL;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() guesthvid:'%s'", __func__, hvid);
 	props[0] = '\0';
@@ -297,12 +300,12 @@ static int	vmware_service_get_hv_data(const zbx_vmware_service_t *service, CURL
 	}
 
 	hvid_esc = zbx_xml_escape_dyn(hvid);
-	tmp = zbx_dsprintf(NULL, ZBX_POST_HV_DETAILS, get_vmware_service_objects()[service->type].property_collector,
-			props, cq_prop, hvid_esc);
+	tmp = zbx_dsprintf(NULL, ZBX_POST_HV_DETAILS, pcollector, props, cq_prop, hvid_esc);
 	zbx_free(hvid_esc);
 	zabbix_log(LOG_LEVEL_TRACE, "%s() SOAP request: %s", __func__, tmp);
 
-	ret = zbx_soap_post(__func__, easyhandle, tmp, xdoc, NULL, error);
+	ret = zbx_property_collection_read_props(__func__, easyhandle, tmp, pcollector, ZBX_VMWARE_SOAP_HV, propmap,
+			props_num, hv_props, xdoc, error);
 	zbx_str_free(tmp);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
@@ -1258,8 +1261,8 @@ int	vmware_service_init_hv(zbx_vmware_service_t *service, CURL *easyhandle, cons
 
 	zbx_vector_vmware_pnic_ptr_create(&hv->pnics);
 	cq_prop = vmware_cq_prop_soap_request(cq_values, ZBX_VMWARE_SOAP_HV, id, &cqvs);
-	ret = vmware_service_get_hv_data(service, easyhandle, id, hv_propmap, ZBX_VMWARE_HVPROPS_NUM, cq_prop, &details,
-			error);
+	ret = vmware_service_get_hv_data(service, easyhandle, id, hv_propmap, ZBX_VMWARE_HVPROPS_NUM, cq_prop,
+			&hv->props, &details, error);
 	zbx_str_free(cq_prop);
 
 	if (FAIL == ret)
@@ -1267,9 +1270,6 @@ int	vmware_service_init_hv(zbx_vmware_service_t *service, CURL *easyhandle, cons
 
 	ret = FAIL;
 
-	if (NULL == (hv->props = xml_read_props(details, hv_propmap, ZBX_VMWARE_HVPROPS_NUM)))
-		goto out;
-
 	if (NULL == hv->props[ZBX_VMWARE_HVPROP_HW_UUID])
 		goto out;
 
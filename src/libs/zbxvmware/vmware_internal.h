@@ -163,11 +163,10 @@ typedef struct
 	const char	*xpath;
 	nodeprocfunc_t	func;
 	unsigned short	vc_min;
+	unsigned char	stream;	/* simple value, read from property collection stream instead of xpath */
 }
 zbx_vmware_propmap_t;
 
-char	**xml_read_props(xmlDoc *xdoc, const zbx_vmware_propmap_t *propmap, int props_num);
-
 int	vmware_service_get_alarms_data(const char *func_parent, const zbx_vmware_service_t *service,
 		CURL *easyhandle, xmlDoc *xdoc, xmlNode *node, zbx_vector_str_t *ids,
 		zbx_vmware_alarms_data_t *alarms_data, char **error);
@@ -211,6 +210,29 @@ zbx_vmware_key_value_t;
 ZBX_PTR_VECTOR_DECL(vmware_key_value, zbx_vmware_key_value_t)
 void	zbx_vmware_key_value_free(zbx_vmware_key_value_t value);
 
+/* streaming SOAP response element callbacks, depth is counted from SOAP Envelope (1), */
+/* type is the value of element type attribute and text is set only for leaf elements */
+typedef struct
+{
+	void	(*start)(void *data, int depth, const char *name, const char *type);
+	void	(*end)(void *data, int depth, const char *name, const char *text);
+	void	*data;
+}
+zbx_soap_sax_handler_t;
+
+int	zbx_soap_post_sax(const char *fn_parent, CURL *easyhandle, const char *request,
+		const zbx_soap_sax_handler_t *handler, xmlDoc **xdoc, char **token, char **error);
+
+typedef void	(*zbx_property_collection_obj_func_t)(const char *type, const char *id,
+		const zbx_vector_vmware_key_value_t *props, void *data);
+
+int	zbx_property_collection_stream(const char *fn_parent, CURL *easyhandle,
+		const char *property_collection_query, const char *property_collector,
+		zbx_property_collection_obj_func_t obj_cb, void *data, xmlDoc **xdoc, char **error);
+int	zbx_property_collection_read_props(const char *fn_parent, CURL *easyhandle,
+		const char *property_collection_query, const char *property_collector, const char *type,
+		const zbx_vmware_propmap_t *propmap, int props_num, char ***props, xmlDoc **xdoc, char **error);
+
 #define REFCOUNT_FIELD_SIZE	sizeof(zbx_uint32_t)
 
 int	vmware_shared_is_ready(void);
@@ -666,146 +666,189 @@ void	vmware_service_update_perf_entities(zbx_vmware_service_t *service)
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() entities:%d", __func__, service->entities.num_data);
 }
 
+/* performance counter response parser state */
+typedef struct
+{
+	zbx_vector_vmware_perf_data_ptr_t	*perfdata;
+	zbx_vmware_perf_data_t			*data;		/* entity being parsed */
+	int					ret;		/* SUCCEED if entity has valid values */
+	char					*counter;
+	char					*instance;
+	char					*value;		/* last value other than -1 */
+	char					*value_last;
+}
+zbx_vmware_perf_parser_t;
+
+static void	vmware_perf_parser_clear_value(zbx_vmware_perf_parser_t *parser)
+{
+	zbx_free(parser->counter);
+	zbx_free(parser->instance);
+	zbx_free(parser->value);
+	zbx_free(parser->value_last);
+}
+
 /******************************************************************************
  *                                                                            *
- * Purpose: updates vmware performance statistics data                        *
- *                                                                            *
- * Parameters: perfdata  - [OUT] performance counter values                   *
- *             xdoc      - [IN] xml document containing performance           *
- *                              counter values for all entities               *
- *             node      - [IN] xml node containing performance counter       *
- *                              values for specified entity                   *
+ * Purpose: adds parsed performance counter value to entity data              *
  *                                                                            *
- * Return value: SUCCEED - performance entity data was parsed                 *
- *               FAIL    - performance entity data did not contain valid      *
- *                         values                                             *
+ * Parameters: parser - [IN/OUT] performance counter response parser state    *
  *                                                                            *
  ******************************************************************************/
-static int	vmware_service_process_perf_entity_data(zbx_vmware_perf_data_t *perfdata, xmlDoc *xdoc, xmlNode *node)
+static void	vmware_perf_parser_add_value(zbx_vmware_perf_parser_t *parser)
 {
-	xmlXPathContext				*xpathCtx;
-	xmlXPathObject				*xpathObj;
-	xmlNodeSetPtr				nodeset;
-	char					*instance, *counter, *value;
-	int					values = 0, ret = FAIL;
-	zbx_vector_vmware_perf_value_ptr_t	*pervalues = &perfdata->values;
-	zbx_vmware_perf_value_t			*perfvalue;
+	zbx_vmware_perf_data_t	*perfdata = parser->data;
+	zbx_vmware_perf_value_t	*perfvalue;
+	const char		*value;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+	if (NULL == (value = (NULL != parser->value ? parser->value : parser->value_last)) || NULL == parser->counter)
+		return;
 
-	xpathCtx = xmlXPathNewContext(xdoc);
-	xpathCtx->node = node;
+	perfvalue = (zbx_vmware_perf_value_t *)zbx_malloc(NULL, sizeof(zbx_vmware_perf_value_t));
 
-	if (NULL == (xpathObj = xmlXPathEvalExpression((const xmlChar *)"*[local-name()='value']", xpathCtx)))
-		goto out;
+	ZBX_STR2UINT64(perfvalue->counterid, parser->counter);
+	perfvalue->instance = (NULL != parser->instance ? parser->instance : zbx_strdup(NULL, ""));
+	parser->instance = NULL;
 
-	if (0 != xmlXPathNodeSetIsEmpty(xpathObj->nodesetval))
-		goto out;
+	if (0 == strcmp(value, "-1") || SUCCEED != zbx_is_uint64(value, &perfvalue->value))
+	{
+		perfvalue->value = ZBX_MAX_UINT64;
+		zabbix_log(LOG_LEVEL_DEBUG, "PerfCounter inaccessible. type:%s object id:%s "
+				"counter id:" ZBX_FS_UI64 " instance:%s value:%s", ZBX_NULL2EMPTY_STR(perfdata->type),
+				ZBX_NULL2EMPTY_STR(perfdata->id), perfvalue->counterid, perfvalue->instance, value);
+	}
+	else
+		parser->ret = SUCCEED;
 
-	nodeset = xpathObj->nodesetval;
-	zbx_vector_vmware_perf_value_ptr_reserve(pervalues, (size_t)(nodeset->nodeNr + pervalues->values_alloc));
+	zbx_vector_vmware_perf_value_ptr_append(&perfdata->values, perfvalue);
+}
 
-	for (int i = 0; i < nodeset->nodeNr; i++)
+static void	vmware_perf_parser_start(void *data, int depth, const char *name, const char *type)
+{
+	zbx_vmware_perf_parser_t	*parser = (zbx_vmware_perf_parser_t *)data;
+
+	/* Envelope/Body/QueryPerfResponse/returnval/{entity,value/{id/{counterId,instance},value}} */
+	if (4 == depth && 0 == strcmp(name, "returnval"))
 	{
-		if (NULL == (value = zbx_xml_node_read_value(xdoc, nodeset->nodeTab[i],
-				"*[local-name()='value'][text() != '-1'][last()]")))
-		{
-			value = zbx_xml_node_read_value(xdoc, nodeset->nodeTab[i], "*[local-name()='value'][last()]");
-		}
+		if (NULL != parser->data)
+			vmware_free_perfdata(parser->data);
+
+		parser->data = (zbx_vmware_perf_data_t *)zbx_malloc(NULL, sizeof(zbx_vmware_perf_data_t));
+		parser->data->id = NULL;
+		parser->data->type = NULL;
+		parser->data->error = NULL;
+		zbx_vector_vmware_perf_value_ptr_create(&parser->data->values);
+		parser->ret = FAIL;
+	}
+	else if (NULL == parser->data || 5 != depth)
+	{
+		return;
+	}
+	else if (0 == strcmp(name, "entity"))
+	{
+		if (NULL != type)
+			parser->data->type = zbx_strdup(parser->data->type, type);
+	}
+	else if (0 == strcmp(name, "value"))
+		vmware_perf_parser_clear_value(parser);
+}
 
-		instance = zbx_xml_node_read_value(xdoc, nodeset->nodeTab[i], "*[local-name()='id']"
-				"/*[local-name()='instance']");
-		counter = zbx_xml_node_read_value(xdoc, nodeset->nodeTab[i], "*[local-name()='id']"
-				"/*[local-name()='counterId']");
+static void	vmware_perf_parser_end(void *data, int depth, const char *name, const char *text)
+{
+	zbx_vmware_perf_parser_t	*parser = (zbx_vmware_perf_parser_t *)data;
 
-		if (NULL != value && NULL != counter)
-		{
-			perfvalue = (zbx_vmware_perf_value_t *)zbx_malloc(NULL, sizeof(zbx_vmware_perf_value_t));
+	if (NULL == parser->data)
+		return;
 
-			ZBX_STR2UINT64(perfvalue->counterid, counter);
-			perfvalue->instance = (NULL != instance ? instance : zbx_strdup(NULL, ""));
+	/* empty elements are treated as missing, the same as in xpath based parsing */
+	if (NULL != text && '\0' == *text)
+		text = NULL;
 
-			if (0 == strcmp(value, "-1") || SUCCEED != zbx_is_uint64(value, &perfvalue->value))
+	switch (depth)
+	{
+		case 7:
+			if (NULL == text)
+				break;
+
+			if (0 == strcmp(name, "counterId"))
+				parser->counter = zbx_strdup(parser->counter, text);
+			else if (0 == strcmp(name, "instance"))
+				parser->instance = zbx_strdup(parser->instance, text);
+			break;
+		case 6:
+			if (NULL == text || 0 != strcmp(name, "value"))
+				break;
+
+			parser->value_last = zbx_strdup(parser->value_last, text);
+
+			if (0 != strcmp(text, "-1"))
+				parser->value = zbx_strdup(parser->value, text);
+			break;
+		case 5:
+			if (0 == strcmp(name, "entity"))
 			{
-				perfvalue->value = ZBX_MAX_UINT64;
-				zabbix_log(LOG_LEVEL_DEBUG, "PerfCounter inaccessible. type:%s object id:%s "
-						"counter id:" ZBX_FS_UI64 " instance:%s value:%s", perfdata->type,
-						perfdata->id, perfvalue->counterid, perfvalue->instance, value);
+				if (NULL != text)
+					parser->data->id = zbx_strdup(parser->data->id, text);
 			}
-			else if (FAIL == ret)
-				ret = SUCCEED;
-
-			zbx_vector_vmware_perf_value_ptr_append(pervalues, perfvalue);
+			else if (0 == strcmp(name, "value"))
+			{
+				vmware_perf_parser_add_value(parser);
+				vmware_perf_parser_clear_value(parser);
+			}
+			break;
+		case 4:
+			if (0 != strcmp(name, "returnval"))
+				break;
 
-			instance = NULL;
-			values++;
-		}
+			if (NULL != parser->data->type && NULL != parser->data->id && SUCCEED == parser->ret)
+				zbx_vector_vmware_perf_data_ptr_append(parser->perfdata, parser->data);
+			else
+				vmware_free_perfdata(parser->data);
 
-		zbx_free(counter);
-		zbx_free(instance);
-		zbx_free(value);
+			parser->data = NULL;
+			break;
 	}
-
-out:
-	xmlXPathFreeObject(xpathObj);
-	xmlXPathFreeContext(xpathCtx);
-
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() values:%d", __func__, values);
-
-	return ret;
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: updates vmware performance statistics data                        *
+ * Purpose: requests vmware performance statistics and parses response into   *
+ *          performance entity data while it is being received                *
+ *                                                                            *
+ * Parameters: easyhandle - [IN] prepared cURL connection handle              *
+ *             request    - [IN] QueryPerf request                            *
+ *             perfdata   - [OUT] performance entity data                     *
+ *             error      - [OUT] error message in case of failure            *
  *                                                                            *
- * Parameters: perfdata - [OUT] performance entity data                       *
- *             xdoc     - [IN] performance data xml document                  *
+ * Return value: SUCCEED - performance data was retrieved                     *
+ *               FAIL    - otherwise, no entity data is added                 *
  *                                                                            *
  ******************************************************************************/
-static void	vmware_service_parse_perf_data(zbx_vector_vmware_perf_data_ptr_t *perfdata, xmlDoc *xdoc)
+static int	vmware_service_query_perf_data(CURL *easyhandle, const char *request,
+		zbx_vector_vmware_perf_data_ptr_t *perfdata, char **error)
 {
-	xmlXPathContext	*xpathCtx;
-	xmlXPathObject	*xpathObj;
-	xmlNodeSetPtr	nodeset;
+	zbx_vmware_perf_parser_t	parser = {.perfdata = perfdata};
+	zbx_soap_sax_handler_t		handler = {vmware_perf_parser_start, vmware_perf_parser_end, &parser};
+	int				ret, values_num = perfdata->values_num;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	xpathCtx = xmlXPathNewContext(xdoc);
-
-	if (NULL == (xpathObj = xmlXPathEvalExpression((const xmlChar *)"/*/*/*/*", xpathCtx)))
-		goto clean;
-
-	if (0 != xmlXPathNodeSetIsEmpty(xpathObj->nodesetval))
-		goto clean;
-
-	nodeset = xpathObj->nodesetval;
-	zbx_vector_vmware_perf_data_ptr_reserve(perfdata, (size_t)(nodeset->nodeNr + perfdata->values_alloc));
-
-	for (int i = 0; i < nodeset->nodeNr; i++)
+	if (SUCCEED != (ret = zbx_soap_post_sax(__func__, easyhandle, request, &handler, NULL, NULL, error)))
 	{
-		zbx_vmware_perf_data_t	*data;
-		int			ret = FAIL;
+		for (int i = values_num; i < perfdata->values_num; i++)
+			vmware_free_perfdata(perfdata->values[i]);
 
-		data = (zbx_vmware_perf_data_t *)zbx_malloc(NULL, sizeof(zbx_vmware_perf_data_t));
+		perfdata->values_num = values_num;
+	}
 
-		data->id = zbx_xml_node_read_value(xdoc, nodeset->nodeTab[i], "*[local-name()='entity']");
-		data->type = zbx_xml_node_read_value(xdoc, nodeset->nodeTab[i], "*[local-name()='entity']/@type");
-		data->error = NULL;
-		zbx_vector_vmware_perf_value_ptr_create(&data->values);
+	if (NULL != parser.data)
+		vmware_free_perfdata(parser.data);
 
-		if (NULL != data->type && NULL != data->id)
-			ret = vmware_service_process_perf_entity_data(data, xdoc, nodeset->nodeTab[i]);
+	vmware_perf_parser_clear_value(&parser);
 
-		if (SUCCEED == ret)
-			zbx_vector_vmware_perf_data_ptr_append(perfdata, data);
-		else
-			vmware_free_perfdata(data);
-	}
-clean:
-	xmlXPathFreeObject(xpathObj);
-	xmlXPathFreeContext(xpathCtx);
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s entities:%d", __func__, zbx_result_string(ret),
+			perfdata->values_num - values_num);
+
+	return ret;
 }
 
 /******************************************************************************
@@ -913,7 +956,6 @@ static void	vmware_service_retrieve_perf_counters(zbx_vmware_service_t *service,
 	size_t				tmp_alloc = 0, tmp_offset;
 	int				i, j, start_counter = 0;
 	zbx_vmware_perf_entity_t	*entity;
-	xmlDoc				*doc = NULL;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() counters_max:%d", __func__, counters_max);
 
@@ -1000,14 +1042,14 @@ static void	vmware_service_retrieve_perf_counters(zbx_vmware_service_t *service,
 		}
 
 		zbx_vmware_unlock();
-		zbx_xml_doc_free(doc);
 
 		zbx_strcpy_alloc(&tmp, &tmp_alloc, &tmp_offset, "</ns0:QueryPerf>");
 		zbx_strcpy_alloc(&tmp, &tmp_alloc, &tmp_offset, ZBX_POST_VSPHERE_FOOTER);
 
 		zabbix_log(LOG_LEVEL_TRACE, "%s() SOAP request: %s", __func__, tmp);
 
-		if (SUCCEED != zbx_soap_post(__func__, easyhandle, tmp, &doc, NULL, &error))
+		/* parse performance data into local memory */
+		if (SUCCEED != vmware_service_query_perf_data(easyhandle, tmp, perfdata, &error))
 		{
 			for (j = i + 1; j < entities->values_num; j++)
 			{
@@ -1019,15 +1061,11 @@ static void	vmware_service_retrieve_perf_counters(zbx_vmware_service_t *service,
 			break;
 		}
 
-		/* parse performance data into local memory */
-		vmware_service_parse_perf_data(perfdata, doc);
-
 		while (entities->values_num > i + 1)
 			zbx_vector_vmware_perf_entity_ptr_remove_noorder(entities, entities->values_num - 1);
 	}
 
 	zbx_free(tmp);
-	zbx_xml_doc_free(doc);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
@@ -31,7 +31,7 @@
 #include "zbxnum.h"
 
 #define ZBX_VMPROPMAP(property)										\
-	{property, ZBX_XPATH_PROP_OBJECT(ZBX_VMWARE_SOAP_VM) ZBX_XPATH_PROP_NAME_NODE(property), NULL, 0}
+	{property, ZBX_XPATH_PROP_OBJECT(ZBX_VMWARE_SOAP_VM) ZBX_XPATH_PROP_NAME_NODE(property), NULL, 0, 1}
 
 static int	vmware_service_get_vm_snapshot(void *xml_node, char **jstr);
 
@@ -59,9 +59,9 @@ static zbx_vmware_propmap_t	vm_propmap[] = {
 	ZBX_VMPROPMAP("parent"),				/* ZBX_VMWARE_VMPROP_FOLDER */
 	{"layoutEx</ns0:pathSet><ns0:pathSet>snapshot",		/* ZBX_VMWARE_VMPROP_SNAPSHOT */
 			ZBX_XPATH_PROP_OBJECT(ZBX_VMWARE_SOAP_VM) ZBX_XPATH_PROP_NAME_NODE("snapshot"),
-			vmware_service_get_vm_snapshot, 0},
+			vmware_service_get_vm_snapshot, 0, 0},
 	{"datastore", ZBX_XPATH_PROP_OBJECT(ZBX_VMWARE_SOAP_VM)/* ZBX_VMWARE_VMPROP_DATASTOREID */
-			ZBX_XPATH_PROP_NAME_NODE("datastore") ZBX_XPATH_LN("ManagedObjectReference"), NULL, 0},
+			ZBX_XPATH_PROP_NAME_NODE("datastore") ZBX_XPATH_LN("ManagedObjectReference"), NULL, 0, 0},
 	ZBX_VMPROPMAP("summary.runtime.consolidationNeeded"),	/* ZBX_VMWARE_VMPROP_CONSOLIDATION_NEEDED */
 	ZBX_VMPROPMAP("resourcePool"),				/* ZBX_VMWARE_VMPROP_RESOURCEPOOL */
 	ZBX_VMPROPMAP("guest.toolsVersion"),			/* ZBX_VMWARE_VMPROP_TOOLS_VERSION */
@@ -602,6 +602,7 @@ clean:
  *             propmap      - [IN] xpaths of properties to read               *
  *             props_num    - [IN] number of properties to read               *
  *             cq_prop      - [IN] soap part of query with cq property        *
+ *             vm_props     - [OUT] values of propmap properties              *
  *             xdoc         - [OUT] reference to output xml document          *
  *             error        - [OUT] error message in case of failure          *
  *                                                                            *
@@ -610,7 +611,8 @@ clean:
  *                                                                            *
  ******************************************************************************/
 static int	vmware_service_get_vm_data(zbx_vmware_service_t *service, CURL *easyhandle, const char *vmid,
-		const zbx_vmware_propmap_t *propmap, int props_num, const char *cq_prop, xmlDoc **xdoc, char **error)
+		const zbx_vmware_propmap_t *propmap, int props_num, const char *cq_prop, char ***vm_props,
+		xmlDoc **xdoc, char **error)
 {
 #	define ZBX_POST_VMWARE_VM_STATUS_EX 						\
 		ZBX_POST_VSPHERE_HEADER							\
@@ -661,8 +663,9 @@ static int	vmware_service_get_vm_data(zbx_vmware_service_t *service, CURL *easyh
 		"</ns0:RetrievePropertiesEx>"						\
 		ZBX_POST_VSPHERE_FOOTER
 
-	char	*tmp, props[ZBX_VMWARE_VMPROPS_NUM * 150], *vmid_esc;
-	int	ret;
+	char		*tmp, props[ZBX_VMWARE_VMPROPS_NUM * 150], *vmid_esc;
+	const char	*pcollector = get_vmware_service_objects()[service->type].property_collector;
+	int		ret;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() vmid:'%s'", __func__, vmid);
 	props[0] = '\0';
@@ -675,11 +678,11 @@ static int	vmware_service_get_vm_data(zbx_vmware_service_t *service, CURL *easyh
 	}
 
 	vmid_esc = zbx_xml_escape_dyn(vmid);
-	tmp = zbx_dsprintf(NULL, ZBX_POST_VMWARE_VM_STATUS_EX,
-			get_vmware_service_objects()[service->type].property_collector, props, cq_prop, vmid_esc);
+	tmp = zbx_dsprintf(NULL, ZBX_POST_VMWARE_VM_STATUS_EX, pcollector, props, cq_prop, vmid_esc);
 
 	zbx_free(vmid_esc);
-	ret = zbx_soap_post(__func__, easyhandle, tmp, xdoc, NULL, error);
+	ret = zbx_property_collection_read_props(__func__, easyhandle, tmp, pcollector, ZBX_VMWARE_SOAP_VM, propmap,
+			props_num, vm_props, xdoc, error);
 	zbx_str_free(tmp);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
@@ -1054,7 +1057,7 @@ zbx_vmware_vm_t	*vmware_service_create_vm(zbx_vmware_service_t *service, CURL *e
 	zbx_vector_cq_value_ptr_create(&cqvs);
 	cq_prop = vmware_cq_prop_soap_request(cq_values, ZBX_VMWARE_SOAP_VM, id, &cqvs);
 	ret = vmware_service_get_vm_data(service, easyhandle, id, vm_propmap, ZBX_VMWARE_VMPROPS_NUM, cq_prop,
-			&details, error);
+			&vm->props, &details, error);
 	zbx_str_free(cq_prop);
 
 	if (FAIL == ret)
@@ -1069,9 +1072,6 @@ zbx_vmware_vm_t	*vmware_service_create_vm(zbx_vmware_service_t *service, CURL *e
 	vm->uuid = value;
 	vm->id = zbx_strdup(NULL, id);
 
-	if (NULL == (vm->props = xml_read_props(details, vm_propmap, ZBX_VMWARE_VMPROPS_NUM)))
-		goto out;
-
 	if (NULL != vm->props[ZBX_VMWARE_VMPROP_FOLDER] &&
 			SUCCEED != vmware_service_get_vm_folder(details, &vm->props[ZBX_VMWARE_VMPROP_FOLDER]))
 	{
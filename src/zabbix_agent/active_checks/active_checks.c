@@ -282,6 +282,7 @@ static void	add_check(const char *key, zbx_uint64_t itemid, const char *delay, z
 			metric->logfiles_num = 0;
 			metric->start_time = 0.0;
 			metric->processed_bytes = 0;
+			metric->watch_gen = 0;
 #if !defined(_WINDOWS) && !defined(__MINGW32__)
 			if (NULL != metric->persistent_file_name)
 			{
@@ -365,6 +366,7 @@ static void	add_check(const char *key, zbx_uint64_t itemid, const char *delay, z
 	metric->start_time = 0.0;
 	metric->processed_bytes = 0;
 	metric->persistent_file_name = NULL;	/* initialized but not used on Microsoft Windows */
+	metric->watch_gen = 0;
 
 	zbx_vector_active_metrics_ptr_append(&active_metrics, metric);
 out:
@@ -32,18 +32,124 @@
 
 #ifndef _WINDOWS
 static volatile sig_atomic_t	need_update_userparam;
+
+/* the maximum number of requests with slow item keys processed concurrently in worker processes */
+#define LISTENER_WORKERS_MAX	8
+
+static pid_t	listener_workers[LISTENER_WORKERS_MAX];
+static int	listener_workers_num;
+
+/* the number of requests processed by the listener itself and passed to worker processes */
+static zbx_uint64_t	requests_inline, requests_offloaded;
+
+/* item keys which can take long time to process */
+static const char	*slow_keys[] = {"net.dns", "net.dns.perf", "net.dns.record", "net.tcp.service",
+		"net.tcp.service.perf", "net.udp.service", "net.udp.service.perf", "system.run", "system.sw.packages",
+		"system.sw.packages.get", "vfs.dir.count", "vfs.dir.get", "vfs.dir.size", "vfs.file.cksum",
+		"vfs.file.contents", "vfs.file.get", "vfs.file.md5sum", "vfs.file.regexp", "vfs.file.regmatch",
+		"web.page.get", "web.page.perf", "web.page.regexp", NULL};
 #endif
-static int	process_passive_checks_json(zbx_socket_t *s, int config_timeout, struct zbx_json_parse *jp)
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: validates passive check request row                               *
+ *                                                                            *
+ ******************************************************************************/
+static int	passive_check_row_validate(const char *p, char **error)
 {
-	struct zbx_json_parse	jp_data, jp_row;
-	const char		*p = NULL;
+	struct zbx_json_parse	jp_row;
+
+	if (FAIL == zbx_json_brackets_open(p, &jp_row))
+	{
+		*error = zbx_dsprintf(NULL, "%s", zbx_json_strerror());
+		return FAIL;
+	}
+
+	if (NULL == zbx_json_pair_by_name(&jp_row, ZBX_PROTO_TAG_TIMEOUT))
+	{
+		*error = zbx_dsprintf(NULL, "cannot find the \"%s\" object in the received JSON object: %s",
+				ZBX_PROTO_TAG_TIMEOUT, zbx_json_strerror());
+		return FAIL;
+	}
+
+	if (NULL == zbx_json_pair_by_name(&jp_row, ZBX_PROTO_TAG_KEY))
+	{
+		*error = zbx_dsprintf(NULL, "cannot find the \"%s\" object in the received JSON object: %s",
+				ZBX_PROTO_TAG_KEY, zbx_json_strerror());
+		return FAIL;
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: executes passive check request row and adds result to response    *
+ *                                                                            *
+ ******************************************************************************/
+static void	process_passive_check_row(const char *p, struct zbx_json *j)
+{
+	struct zbx_json_parse	jp_row;
 	size_t			key_alloc = 0;
-	char			tmp[MAX_STRING_LEN], error_tmp[MAX_STRING_LEN], *key = NULL, *error = NULL;
-	int			timeout, ret = SUCCEED;
-	struct zbx_json		j;
+	char			tmp[MAX_STRING_LEN], error_tmp[MAX_STRING_LEN], *key = NULL;
+	int			timeout;
 	AGENT_RESULT		result;
 	char			**value;
 
+	zbx_json_addobject(j, NULL);
+
+	if (FAIL == zbx_json_brackets_open(p, &jp_row) ||
+			FAIL == zbx_json_value_by_name(&jp_row, ZBX_PROTO_TAG_TIMEOUT, tmp, sizeof(tmp), NULL) ||
+			FAIL == zbx_json_value_by_name_dyn(&jp_row, ZBX_PROTO_TAG_KEY, &key, &key_alloc, NULL))
+	{
+		zbx_json_addstring(j, ZBX_PROTO_TAG_ERROR, zbx_json_strerror(), ZBX_JSON_TYPE_STRING);
+		goto out;
+	}
+
+	zbx_init_agent_result(&result);
+
+	if (FAIL == zbx_validate_item_timeout(tmp, &timeout, error_tmp, sizeof(error_tmp)))
+	{
+		zbx_json_addstring(j, ZBX_PROTO_TAG_ERROR, error_tmp, ZBX_JSON_TYPE_STRING);
+	}
+	else
+	{
+		if (SUCCEED == zbx_execute_agent_check(key, ZBX_PROCESS_WITH_ALIAS, &result, timeout))
+		{
+			if (NULL != (value = ZBX_GET_TEXT_RESULT(&result)))
+				zbx_json_addstring(j, ZBX_PROTO_TAG_VALUE, *value, ZBX_JSON_TYPE_STRING);
+			else
+				zbx_json_addraw(j, ZBX_PROTO_TAG_VALUE, "null");
+		}
+		else
+		{
+			if (NULL != (value = ZBX_GET_MSG_RESULT(&result)))
+				zbx_json_addstring(j, ZBX_PROTO_TAG_ERROR, *value, ZBX_JSON_TYPE_STRING);
+			else
+				zbx_json_addstring(j, ZBX_PROTO_TAG_ERROR, ZBX_NOTSUPPORTED, ZBX_JSON_TYPE_STRING);
+		}
+	}
+
+	zbx_free_agent_result(&result);
+out:
+	zbx_json_close(j);
+	zbx_free(key);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: processes passive checks request, results of all requested keys  *
+ *          are returned in the same order as requested                       *
+ *                                                                            *
+ ******************************************************************************/
+static int	process_passive_checks_json(zbx_socket_t *s, int config_timeout, struct zbx_json_parse *jp)
+{
+	struct zbx_json_parse	jp_data;
+	const char		*p = NULL;
+	char			tmp[MAX_STRING_LEN], *error = NULL;
+	int			ret = SUCCEED;
+	struct zbx_json		j;
+
 	zbx_json_init(&j, ZBX_JSON_STAT_BUF_LEN);
 	zbx_json_addstring(&j, ZBX_PROTO_TAG_VERSION, ZABBIX_VERSION, ZBX_JSON_TYPE_STRING);
 	zbx_json_addint64(&j, ZBX_PROTO_TAG_VARIANT, ZBX_PROGRAM_VARIANT_AGENT);
@@ -68,144 +174,257 @@ static int	process_passive_checks_json(zbx_socket_t *s, int config_timeout, stru
 		goto fail;
 	}
 
-	if (NULL == (p = zbx_json_next(&jp_data, p)))
+	if (NULL == zbx_json_next(&jp_data, NULL))
 	{
 		error = zbx_dsprintf(NULL, "received empty \"%s\" tag", ZBX_PROTO_TAG_DATA);
 		goto fail;
 	}
 
-	if (FAIL == zbx_json_brackets_open(p, &jp_row))
+	/* validate whole request before executing checks, malformed request fails as a whole */
+	while (NULL != (p = zbx_json_next(&jp_data, p)))
 	{
-		error = zbx_dsprintf(NULL, "%s", zbx_json_strerror());
-		goto fail;
+		if (FAIL == passive_check_row_validate(p, &error))
+			goto fail;
 	}
 
-	if (FAIL == zbx_json_value_by_name(&jp_row, ZBX_PROTO_TAG_TIMEOUT, tmp, sizeof(tmp), NULL))
-	{
-		error = zbx_dsprintf(NULL, "cannot find the \"%s\" object in the received JSON object: %s",
-				ZBX_PROTO_TAG_TIMEOUT, zbx_json_strerror());
-		goto fail;
-	}
+	zbx_json_addarray(&j, ZBX_PROTO_TAG_DATA);
 
-	if (FAIL == zbx_json_value_by_name_dyn(&jp_row, ZBX_PROTO_TAG_KEY, &key, &key_alloc,
-			NULL))
-	{
-		error = zbx_dsprintf(NULL, "cannot find the \"%s\" object in the received JSON object: %s",
-				ZBX_PROTO_TAG_KEY, zbx_json_strerror());
-		goto fail;
-	}
+	while (NULL != (p = zbx_json_next(&jp_data, p)))
+		process_passive_check_row(p, &j);
 
-	zbx_init_agent_result(&result);
+	zbx_json_close(&j);
+fail:
+	if (NULL != error)
+		zbx_json_addstring(&j, ZBX_PROTO_TAG_ERROR, error, ZBX_JSON_TYPE_STRING);
 
-	zbx_json_addarray(&j, ZBX_PROTO_TAG_DATA);
-	zbx_json_addobject(&j, NULL);
+	zbx_json_close(&j);
 
-	if (FAIL == zbx_validate_item_timeout(tmp, &timeout, error_tmp, sizeof(error_tmp)))
+	zabbix_log(LOG_LEVEL_DEBUG, "Sending back [%s]", j.buffer);
+	ret = zbx_tcp_send_bytes_to(s, j.buffer, j.buffer_size, config_timeout);
+
+	zbx_json_free(&j);
+	zbx_free(error);
+
+	return ret;
+}
+
+static int	process_request(zbx_socket_t *s, int config_timeout)
+{
+	struct zbx_json_parse	jp;
+	int			ret = SUCCEED;
+
+	if (SUCCEED == zbx_json_open(s->buffer, &jp))
 	{
-		zbx_json_addstring(&j, ZBX_PROTO_TAG_ERROR, error_tmp, ZBX_JSON_TYPE_STRING);
+		ret = process_passive_checks_json(s, config_timeout, &jp);
 	}
 	else
 	{
-		if (SUCCEED == zbx_execute_agent_check(key, ZBX_PROCESS_WITH_ALIAS, &result, timeout))
+		AGENT_RESULT	result;
+		char		**value = NULL;
+
+		zbx_init_agent_result(&result);
+
+		if (SUCCEED == zbx_execute_agent_check(s->buffer, ZBX_PROCESS_WITH_ALIAS, &result, config_timeout))
 		{
 			if (NULL != (value = ZBX_GET_TEXT_RESULT(&result)))
-				zbx_json_addstring(&j, ZBX_PROTO_TAG_VALUE, *value, ZBX_JSON_TYPE_STRING);
-			else
-				zbx_json_addraw(&j, ZBX_PROTO_TAG_VALUE, "null");
+			{
+				zabbix_log(LOG_LEVEL_DEBUG, "Sending back [%s]", *value);
+				ret = zbx_tcp_send_to(s, *value, config_timeout);
+			}
 		}
 		else
 		{
-			if (NULL != (value = ZBX_GET_MSG_RESULT(&result)))
-				zbx_json_addstring(&j, ZBX_PROTO_TAG_ERROR, *value, ZBX_JSON_TYPE_STRING);
+			value = ZBX_GET_MSG_RESULT(&result);
+
+			if (NULL != value)
+			{
+				static char	*buffer = NULL;
+				static size_t	buffer_alloc = 256;
+				size_t		buffer_offset = 0;
+
+				zabbix_log(LOG_LEVEL_DEBUG, "Sending back [" ZBX_NOTSUPPORTED ": %s]", *value);
+
+				if (NULL == buffer)
+					buffer = (char *)zbx_malloc(buffer, buffer_alloc);
+
+				zbx_strncpy_alloc(&buffer, &buffer_alloc, &buffer_offset,
+						ZBX_NOTSUPPORTED, ZBX_CONST_STRLEN(ZBX_NOTSUPPORTED));
+				buffer_offset++;
+				zbx_strcpy_alloc(&buffer, &buffer_alloc, &buffer_offset, *value);
+
+				ret = zbx_tcp_send_bytes_to(s, buffer, buffer_offset, config_timeout);
+			}
 			else
-				zbx_json_addstring(&j, ZBX_PROTO_TAG_ERROR, ZBX_NOTSUPPORTED, ZBX_JSON_TYPE_STRING);
+			{
+				zabbix_log(LOG_LEVEL_DEBUG, "Sending back [" ZBX_NOTSUPPORTED "]");
+				ret = zbx_tcp_send_to(s, ZBX_NOTSUPPORTED, config_timeout);
+			}
 		}
+
+		zbx_free_agent_result(&result);
 	}
 
-	zbx_json_close(&j);
-	zbx_json_close(&j);
+	return ret;
+}
 
-	zbx_free_agent_result(&result);
-fail:
-	if (NULL != error)
-		zbx_json_addstring(&j, ZBX_PROTO_TAG_ERROR, error, ZBX_JSON_TYPE_STRING);
+#ifndef _WINDOWS
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if item key belongs to keys which can take long time to    *
+ *          process                                                           *
+ *                                                                            *
+ ******************************************************************************/
+static int	listener_key_is_slow(const char *itemkey)
+{
+	AGENT_REQUEST	request;
+	int		ret = FAIL;
 
-	zbx_json_close(&j);
+	zbx_init_agent_request(&request);
 
-	zabbix_log(LOG_LEVEL_DEBUG, "Sending back [%s]", j.buffer);
-	ret = zbx_tcp_send_bytes_to(s, j.buffer, j.buffer_size, config_timeout);
+	if (SUCCEED != zbx_parse_item_key(zbx_alias_get(itemkey), &request))
+		goto out;
 
-	zbx_free(key);
-	zbx_json_free(&j);
-	zbx_free(error);
+	if (SUCCEED == zbx_is_user_parameter(request.key))
+	{
+		ret = SUCCEED;
+		goto out;
+	}
+
+	for (int i = 0; NULL != slow_keys[i]; i++)
+	{
+		if (0 == strcmp(slow_keys[i], request.key))
+		{
+			ret = SUCCEED;
+			break;
+		}
+	}
+out:
+	zbx_free_agent_request(&request);
 
 	return ret;
 }
 
-
-static void	process_listener(zbx_socket_t *s, int config_timeout)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if passive check request contains item keys which can take *
+ *          long time to process                                              *
+ *                                                                            *
+ ******************************************************************************/
+static int	listener_request_is_slow(const char *buffer)
 {
-	int	ret;
+	struct zbx_json_parse	jp, jp_data, jp_row;
+	const char		*p = NULL;
+	char			*key = NULL;
+	size_t			key_alloc = 0;
+	int			ret = FAIL;
 
-	if (SUCCEED == (ret = zbx_tcp_recv_to(s, config_timeout)))
+	if (SUCCEED != zbx_json_open(buffer, &jp))
+		return listener_key_is_slow(buffer);
+
+	if (FAIL == zbx_json_brackets_by_name(&jp, ZBX_PROTO_TAG_DATA, &jp_data))
+		return FAIL;
+
+	while (FAIL == ret && NULL != (p = zbx_json_next(&jp_data, p)))
 	{
-		struct zbx_json_parse	jp;
+		if (FAIL == zbx_json_brackets_open(p, &jp_row) ||
+				FAIL == zbx_json_value_by_name_dyn(&jp_row, ZBX_PROTO_TAG_KEY, &key, &key_alloc, NULL))
+		{
+			continue;
+		}
 
-		zbx_rtrim(s->buffer, "\r\n");
+		ret = listener_key_is_slow(key);
+	}
 
-		zabbix_log(LOG_LEVEL_DEBUG, "Requested [%s]", s->buffer);
+	zbx_free(key);
+
+	return ret;
+}
 
-		if (SUCCEED == zbx_json_open(s->buffer, &jp))
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reaps finished worker processes                                   *
+ *                                                                            *
+ ******************************************************************************/
+static void	listener_workers_reap(void)
+{
+	for (int i = 0; i < listener_workers_num;)
+	{
+		if (0 == waitpid(listener_workers[i], NULL, WNOHANG))
 		{
-			ret = process_passive_checks_json(s, config_timeout, &jp);
+			i++;
+			continue;
 		}
-		else
-		{
-			AGENT_RESULT	result;
-			char		**value = NULL;
 
-			zbx_init_agent_result(&result);
+		listener_workers[i] = listener_workers[--listener_workers_num];
+	}
+}
 
-			if (SUCCEED == zbx_execute_agent_check(s->buffer, ZBX_PROCESS_WITH_ALIAS, &result,
-					config_timeout))
-			{
-				if (NULL != (value = ZBX_GET_TEXT_RESULT(&result)))
-				{
-					zabbix_log(LOG_LEVEL_DEBUG, "Sending back [%s]", *value);
-					ret = zbx_tcp_send_to(s, *value, config_timeout);
-				}
-			}
-			else
-			{
-				value = ZBX_GET_MSG_RESULT(&result);
+/******************************************************************************
+ *                                                                            *
+ * Purpose: passes request with slow item keys to a worker process, so the    *
+ *          listener can continue accepting connections                       *
+ *                                                                            *
+ * Parameters: s              - [IN/OUT] accepted connection with received    *
+ *                                       request                              *
+ *             config_timeout - [IN]                                          *
+ *                                                                            *
+ * Return value: SUCCEED - the request is processed by worker process and the *
+ *                         connection is released in the listener             *
+ *               FAIL    - the request must be processed by the listener      *
+ *                                                                            *
+ ******************************************************************************/
+static int	listener_offload_request(zbx_socket_t *s, int config_timeout)
+{
+	pid_t	pid;
 
-				if (NULL != value)
-				{
-					static char	*buffer = NULL;
-					static size_t	buffer_alloc = 256;
-					size_t		buffer_offset = 0;
+	listener_workers_reap();
 
-					zabbix_log(LOG_LEVEL_DEBUG, "Sending back [" ZBX_NOTSUPPORTED ": %s]", *value);
+	if (LISTENER_WORKERS_MAX == listener_workers_num || SUCCEED != listener_request_is_slow(s->buffer))
+		return FAIL;
 
-					if (NULL == buffer)
-						buffer = (char *)zbx_malloc(buffer, buffer_alloc);
+	if (-1 == (pid = zbx_fork()))
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "cannot fork worker process: %s", zbx_strerror(errno));
+		return FAIL;
+	}
 
-					zbx_strncpy_alloc(&buffer, &buffer_alloc, &buffer_offset,
-							ZBX_NOTSUPPORTED, ZBX_CONST_STRLEN(ZBX_NOTSUPPORTED));
-					buffer_offset++;
-					zbx_strcpy_alloc(&buffer, &buffer_alloc, &buffer_offset, *value);
+	if (0 == pid)
+	{
+		if (FAIL == process_request(s, config_timeout))
+			zabbix_log(LOG_LEVEL_DEBUG, "Process listener error: %s", zbx_socket_strerror());
 
-					ret = zbx_tcp_send_bytes_to(s, buffer, buffer_offset, config_timeout);
-				}
-				else
-				{
-					zabbix_log(LOG_LEVEL_DEBUG, "Sending back [" ZBX_NOTSUPPORTED "]");
-					ret = zbx_tcp_send_to(s, ZBX_NOTSUPPORTED, config_timeout);
-				}
-			}
+		zbx_tcp_unaccept(s);
 
-			zbx_free_agent_result(&result);
+		exit(EXIT_SUCCESS);
+	}
+
+	listener_workers[listener_workers_num++] = pid;
+	zbx_tcp_detach(s);
+
+	return SUCCEED;
+}
+#endif
+
+static void	process_listener(zbx_socket_t *s, int config_timeout)
+{
+	int	ret;
+
+	if (SUCCEED == (ret = zbx_tcp_recv_to(s, config_timeout)))
+	{
+		zbx_rtrim(s->buffer, "\r\n");
+
+		zabbix_log(LOG_LEVEL_DEBUG, "Requested [%s]", s->buffer);
+
+#ifndef _WINDOWS
+		if (SUCCEED == listener_offload_request(s, config_timeout))
+		{
+			requests_offloaded++;
+			return;
 		}
+
+		requests_inline++;
+#endif
+		ret = process_request(s, config_timeout);
 	}
 
 	if (FAIL == ret)
@@ -262,7 +481,15 @@ ZBX_THREAD_ENTRY(listener_thread, args)
 		}
 #endif
 
+#ifndef _WINDOWS
+		listener_workers_reap();
+
+		zbx_setproctitle("listener #%d [waiting for connection, processed " ZBX_FS_UI64 " requests, "
+				ZBX_FS_UI64 " in workers, %d workers busy]", process_num,
+				requests_inline + requests_offloaded, requests_offloaded, listener_workers_num);
+#else
 		zbx_setproctitle("listener #%d [waiting for connection]", process_num);
+#endif
 		ret = zbx_tcp_accept(&s, init_child_args_in->zbx_config_tls->accept_modes, POLL_TIMEOUT);
 		zbx_update_env(get_process_type_string(process_type), zbx_time());
 
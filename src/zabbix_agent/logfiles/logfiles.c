@@ -3824,6 +3824,325 @@ static int	init_persistent_dir_parameter(const char *server, unsigned short port
 #endif
 }
 
+#if defined(HAVE_SYS_INOTIFY_H)
+#define LOG_WATCH_RESCAN_PERIOD	60	/* seconds, force full scan of watched directory at least this often */
+#define LOG_WATCH_IDLE_PERIOD	3600	/* seconds, stop watching directory not checked for this long */
+#define LOG_WATCH_EVENTS	(IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |	\
+		IN_DELETE_SELF | IN_MOVE_SELF)
+
+typedef struct
+{
+	char		*directory;
+	int		wd;		/* inotify watch descriptor, -1 - directory is not watched */
+	zbx_uint64_t	gen;		/* changes with every event in directory, 0 - not watched */
+	time_t		rescan_time;	/* time of the next forced full scan or watch retry */
+	time_t		lastaccess;
+}
+zbx_log_watch_t;
+
+/* Change notifier is per process. It is used only by C agent active checks process which is single-threaded. */
+static int		log_watch_fd = -1, log_watch_failed = 0;
+static zbx_hashset_t	log_watches;
+static zbx_uint64_t	log_watch_gen;	/* generation source, re-created watch never repeats old value */
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if other watch uses the same inotify watch descriptor      *
+ *                                                                            *
+ * Comments: inotify returns the same descriptor for the same directory       *
+ *           inode, so directories reached through different paths (e.g.      *
+ *           symbolic links) share it.                                        *
+ *                                                                            *
+ ******************************************************************************/
+static int	log_watch_wd_shared(const zbx_log_watch_t *watch)
+{
+	zbx_hashset_iter_t	iter;
+	const zbx_log_watch_t	*other;
+
+	zbx_hashset_iter_reset(&log_watches, &iter);
+
+	while (NULL != (other = (const zbx_log_watch_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (other != watch && other->wd == watch->wd)
+			return SUCCEED;
+	}
+
+	return FAIL;
+}
+
+static void	log_watch_clean(zbx_log_watch_t *watch)
+{
+	if (-1 != watch->wd && SUCCEED != log_watch_wd_shared(watch))
+		inotify_rm_watch(log_watch_fd, watch->wd);
+
+	zbx_free(watch->directory);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reads pending inotify events and marks changed directories dirty  *
+ *                                                                            *
+ ******************************************************************************/
+static void	log_watch_read_events(void)
+{
+	union
+	{
+		struct inotify_event	event;
+		char			buf[4096];
+	}
+	events;
+	ssize_t			nbytes;
+	zbx_hashset_iter_t	iter;
+	zbx_log_watch_t		*watch;
+
+	while (0 < (nbytes = read(log_watch_fd, events.buf, sizeof(events.buf))) || (-1 == nbytes && EINTR == errno))
+	{
+		const char	*ptr;
+
+		for (ptr = events.buf; ptr < events.buf + nbytes;)
+		{
+			const struct inotify_event	*event = (const struct inotify_event *)ptr;
+
+			ptr += sizeof(struct inotify_event) + event->len;
+
+			if (0 != (IN_Q_OVERFLOW & event->mask))
+			{
+				/* events were lost, consider all directories changed */
+				zbx_hashset_iter_reset(&log_watches, &iter);
+
+				while (NULL != (watch = (zbx_log_watch_t *)zbx_hashset_iter_next(&iter)))
+					watch->gen = ++log_watch_gen;
+
+				continue;
+			}
+
+			/* the same directory can be watched through several paths sharing the descriptor */
+			zbx_hashset_iter_reset(&log_watches, &iter);
+
+			while (NULL != (watch = (zbx_log_watch_t *)zbx_hashset_iter_next(&iter)))
+			{
+				if (event->wd != watch->wd)
+					continue;
+
+				watch->gen = ++log_watch_gen;
+
+				/* watch is gone or follows the directory to its new name, set it up again in the */
+				/* next check                                                                     */
+				if (0 != ((IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT) & event->mask))
+				{
+					if (0 != (IN_IGNORED & event->mask))
+						watch->wd = -1;
+
+					log_watch_clean(watch);
+					zbx_hashset_iter_remove(&iter);
+				}
+			}
+		}
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if inotify reliably reports changes on the file system     *
+ *                                                                            *
+ * Comments: Changes made on other hosts are not reported for network and     *
+ *           FUSE file systems.                                               *
+ *                                                                            *
+ ******************************************************************************/
+static int	log_watch_fs_supported(const char *directory)
+{
+	struct statfs	buf;
+
+	if (0 != statfs(directory, &buf))
+		return FAIL;
+
+	switch ((unsigned int)buf.f_type)
+	{
+		case 0x6969:		/* NFS */
+		case 0x517B:		/* SMB */
+		case 0xFF534D42:	/* CIFS */
+		case 0xFE534D42:	/* SMB2 */
+		case 0x65735546:	/* FUSE */
+		case 0x00C36400:	/* CEPH */
+		case 0x01021997:	/* 9P */
+		case 0x5346414F:	/* AFS */
+		case 0x7461636F:	/* OCFS2 */
+		case 0x01161970:	/* GFS2 */
+			return FAIL;
+		default:
+			return SUCCEED;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets change generation of directory, starts watching it if needed *
+ *                                                                            *
+ * Parameters: directory - [IN] directory with log files, ending with '/'     *
+ *                                                                            *
+ * Return value: current generation of directory or 0 if directory cannot be  *
+ *               watched                                                      *
+ *                                                                            *
+ * Comments: Generation changes when anything in directory changes and also   *
+ *           every LOG_WATCH_RESCAN_PERIOD seconds to recover from events     *
+ *           inotify cannot report (e.g. writes through hard links in other   *
+ *           directories).                                                    *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_uint64_t	log_watch_get(const char *directory)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_log_watch_t		*watch, watch_local;
+	time_t			now;
+
+	if (-1 == log_watch_fd)
+	{
+		if (0 != log_watch_failed)
+			return 0;
+
+		if (-1 == (log_watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)))
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "cannot initialize inotify, log file changes will be detected by"
+					" scanning directories: %s", zbx_strerror(errno));
+			log_watch_failed = 1;
+			return 0;
+		}
+
+		zbx_hashset_create(&log_watches, 0, ZBX_DEFAULT_STRING_PTR_HASH_FUNC,
+				ZBX_DEFAULT_STR_COMPARE_FUNC);
+	}
+
+	log_watch_read_events();
+
+	now = time(NULL);
+
+	zbx_hashset_iter_reset(&log_watches, &iter);
+
+	while (NULL != (watch = (zbx_log_watch_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (watch->lastaccess + LOG_WATCH_IDLE_PERIOD < now)
+		{
+			log_watch_clean(watch);
+			zbx_hashset_iter_remove(&iter);
+		}
+	}
+
+	watch_local.directory = (char *)directory;
+
+	if (NULL == (watch = (zbx_log_watch_t *)zbx_hashset_search(&log_watches, &watch_local)))
+	{
+		watch_local.directory = zbx_strdup(NULL, directory);
+		watch_local.wd = -1;
+		watch_local.gen = 0;
+		watch_local.rescan_time = 0;
+
+		watch = (zbx_log_watch_t *)zbx_hashset_insert(&log_watches, &watch_local, sizeof(watch_local));
+	}
+
+	watch->lastaccess = now;
+
+	if (-1 == watch->wd)
+	{
+		if (now < watch->rescan_time)
+			return 0;
+
+		watch->rescan_time = now + LOG_WATCH_RESCAN_PERIOD;
+
+		if (SUCCEED != log_watch_fs_supported(directory) ||
+				-1 == (watch->wd = inotify_add_watch(log_watch_fd, directory, LOG_WATCH_EVENTS)))
+		{
+			zabbix_log(LOG_LEVEL_DEBUG, "%s(): cannot watch directory \"%s\"", __func__, directory);
+			watch->wd = -1;
+			watch->gen = 0;
+			return 0;
+		}
+
+		watch->gen = ++log_watch_gen;
+	}
+	else if (now >= watch->rescan_time)
+	{
+		watch->rescan_time = now + LOG_WATCH_RESCAN_PERIOD;
+		watch->gen = ++log_watch_gen;
+	}
+
+	return watch->gen;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets directory to watch for log[] or logrt[] item file parameter  *
+ *                                                                            *
+ ******************************************************************************/
+static char	*log_watch_directory(const char *filename)
+{
+	const char	*separator;
+
+	if (NULL == (separator = strrchr(filename, ZBX_PATH_SEPARATOR)))
+		return NULL;
+
+	return zbx_substr(filename, 0, (size_t)(separator - filename));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if a log file list can be trusted while its directory      *
+ *          reports no changes                                                *
+ *                                                                            *
+ * Comments: Writes through a symbolic link are reported in the directory of  *
+ *           link target only.                                                *
+ *                                                                            *
+ ******************************************************************************/
+static int	log_watch_files_local(const struct st_logfile *logfiles, int logfiles_num)
+{
+	for (int i = 0; i < logfiles_num; i++)
+	{
+		struct stat	buf;
+
+		if (0 != lstat(logfiles[i].filename, &buf) || S_ISLNK(buf.st_mode))
+			return FAIL;
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if log[] or logrt[] item check can be skipped because      *
+ *          nothing has changed since the previous full check                 *
+ *                                                                            *
+ * Parameters: metric        - [IN]                                           *
+ *             gen           - [IN] current generation of item directory      *
+ *             rotation_type - [IN]                                           *
+ *                                                                            *
+ * Return value: SUCCEED - all files were completely analyzed and directory   *
+ *                         has not changed since then                         *
+ *               FAIL    - full check is required                             *
+ *                                                                            *
+ * Comments: Copies (rotation by 'copytruncate') are always checked fully as  *
+ *           their handling spans several checks.                             *
+ *                                                                            *
+ ******************************************************************************/
+static int	log_watch_unchanged(const zbx_active_metric_t *metric, zbx_uint64_t gen,
+		zbx_log_rotation_options_t rotation_type)
+{
+	if (0 == gen || gen != metric->watch_gen || 0 == metric->logfiles_num || 0 != metric->skip_old_data ||
+			0 != metric->big_rec || 0 != metric->error_count || ZBX_LOG_ROTATION_LOGCPT == rotation_type)
+	{
+		return FAIL;
+	}
+
+	for (int i = 0; i < metric->logfiles_num; i++)
+	{
+		const struct st_logfile	*logfile = &metric->logfiles[i];
+
+		if (logfile->size != logfile->processed_size || 0 != logfile->incomplete || 0 != logfile->retry)
+			return FAIL;
+	}
+
+	return SUCCEED;
+}
+#endif
+
 /******************************************************************************
  *                                                                            *
  * Comments: Function body is thread-safe if config_hostname is not updated   *
@@ -3848,6 +4167,11 @@ int	process_log_check(zbx_vector_addr_ptr_t *addrs, zbx_vector_ptr_t *agent2_res
 	zbx_uint64_t			lastlogsize_orig;
 	float				max_delay;
 	struct st_logfile		*logfiles_new = NULL;
+	int				logfiles_unchanged = 0;
+#if defined(HAVE_SYS_INOTIFY_H)
+	zbx_uint64_t			watch_gen = 0;
+	char				*watch_directory;
+#endif
 
 	if (0 != (ZBX_METRIC_FLAG_LOG_COUNT & metric->flags))
 		is_count_item = 1;
@@ -4066,6 +4390,32 @@ int	process_log_check(zbx_vector_addr_ptr_t *addrs, zbx_vector_ptr_t *agent2_res
 			zbx_free(err_msg);
 		}
 	}
+#endif
+#if defined(HAVE_SYS_INOTIFY_H)
+	/* Change notifier is per process, Agent2 runs log checks concurrently and does not use it ('addrs' is NULL). */
+	if (NULL != addrs && NULL != (watch_directory = log_watch_directory(filename)))
+	{
+		watch_gen = log_watch_get(watch_directory);
+		zbx_free(watch_directory);
+	}
+
+	if (SUCCEED == log_watch_unchanged(metric, watch_gen, rotation_type))
+	{
+		/* all files were analyzed in the previous check and nothing changed since then */
+		zabbix_log(LOG_LEVEL_DEBUG, "%s(): item \"%s\": no changes in log files directory, skipping scan",
+				__func__, metric->key);
+
+		logfiles_unchanged = 1;
+
+		if (0.0f != max_delay)
+		{
+			metric->start_time = 0.0;
+			metric->processed_bytes = 0;
+		}
+
+		ret = SUCCEED;
+	}
+	else
 #endif
 	ret = process_logrt(metric->flags, filename, &metric->lastlogsize, &metric->mtime, lastlogsize_sent, mtime_sent,
 			&metric->skip_old_data, &metric->big_rec, &metric->use_ino, error, &metric->logfiles,
@@ -4113,9 +4463,12 @@ int	process_log_check(zbx_vector_addr_ptr_t *addrs, zbx_vector_ptr_t *agent2_res
 				*mtime_sent = metric->mtime;
 
 				/* switch to the new log file list */
-				destroy_logfile_list(&metric->logfiles, NULL, &metric->logfiles_num);
-				metric->logfiles = logfiles_new;
-				metric->logfiles_num = logfiles_num_new;
+				if (0 == logfiles_unchanged)
+				{
+					destroy_logfile_list(&metric->logfiles, NULL, &metric->logfiles_num);
+					metric->logfiles = logfiles_new;
+					metric->logfiles_num = logfiles_num_new;
+				}
 			}
 			else
 			{
@@ -4128,6 +4481,9 @@ int	process_log_check(zbx_vector_addr_ptr_t *addrs, zbx_vector_ptr_t *agent2_res
 
 				/* the old log file list 'metric->logfiles' stays in its place, drop the new list */
 				destroy_logfile_list(&logfiles_new, NULL, &logfiles_num_new);
+#if defined(HAVE_SYS_INOTIFY_H)
+				watch_gen = 0;
+#endif
 			}
 		}
 	}
@@ -4157,6 +4513,19 @@ int	process_log_check(zbx_vector_addr_ptr_t *addrs, zbx_vector_ptr_t *agent2_res
 			ret = SUCCEED;
 		}
 	}
+#if defined(HAVE_SYS_INOTIFY_H)
+	/* trust the log file list in the next check only if it is complete and committed */
+	if (0 == logfiles_unchanged)
+	{
+		if (SUCCEED != ret || 0 != metric->error_count ||
+				SUCCEED != log_watch_files_local(metric->logfiles, metric->logfiles_num))
+		{
+			watch_gen = 0;
+		}
+
+		metric->watch_gen = watch_gen;
+	}
+#endif
 out:
 	zbx_free(encoding_uc);
 	zbx_free_agent_request(&request);
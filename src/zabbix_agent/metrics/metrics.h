@@ -57,6 +57,8 @@ typedef struct
 	zbx_uint64_t		processed_bytes;	/* number of processed bytes for log[], log.count[], logrt[], */
 							/* logrt.count[] items */
 	char			*persistent_file_name;	/* not used on Microsoft Windows */
+	zbx_uint64_t		watch_gen;	/* generation of log file directory when 'logfiles' were */
+						/* completely analyzed, 0 - unknown (see log_watch_get()) */
 
 	int			timeout;
 }
@@ -306,7 +306,8 @@ static int	config_forks[ZBX_PROCESS_TYPE_COUNT] = {
 	0, /* ZBX_PROCESS_TYPE_DBCONFIGWORKER */
 	0, /* ZBX_PROCESS_TYPE_PG_MANAGER */
 	0, /* ZBX_PROCESS_TYPE_BROWSERPOLLER */
-	0 /* ZBX_PROCESS_TYPE_HA_MANAGER */
+	0, /* ZBX_PROCESS_TYPE_HA_MANAGER */
+	0 /* ZBX_PROCESS_TYPE_METRICS_EXPORTER */
 };
 
 static char	*config_file	= NULL;
@@ -19,6 +19,7 @@
 #include "zbxtime.h"
 #include "zbxproxybuffer.h"
 #include "zbxpreproc.h"
+#include "zbxpoller.h"
 #include "zbxjson.h"
 
 #define ZBX_DIAG_PROXYBUFFER_MEMORY	0x00000001
@@ -104,6 +105,16 @@ int	diag_add_section_info(const char *section, const struct zbx_json_parse *jp,
 		zbx_diag_add_locks_info(json);
 		ret = SUCCEED;
 	}
+	else if (0 == strcmp(section, ZBX_DIAG_PROFILER))
+	{
+		zbx_diag_add_profiler_info(json);
+		ret = SUCCEED;
+	}
+	else if (0 == strcmp(section, ZBX_DIAG_POLLER))
+	{
+		zbx_async_agent_add_diag_info(json, ZBX_DIAG_POLLER);
+		ret = SUCCEED;
+	}
 	else
 		*error = zbx_dsprintf(*error, "Unsupported diagnostics section: %s", section);
 
@@ -28,6 +28,7 @@
 
 #include "zbxnix.h"
 #include "zbxself.h"
+#include "zbxprof.h"
 #include "zbxpoller.h"
 #include "zbxhttppoller.h"
 #include "zbxvmware.h"
@@ -110,8 +111,9 @@ static const char	*help_message[] = {
 	"                                   target is not specified",
 	"      " ZBX_SNMP_CACHE_RELOAD "          Reload SNMP cache",
 	"      " ZBX_DIAGINFO "=section           Log internal diagnostic information of the",
-	"                                 section (historycache, preprocessing, locks) or",
-	"                                 everything if section is not specified",
+	"                                 section (historycache, preprocessing, locks,",
+	"                                 profiler, poller) or everything if section is",
+	"                                 not specified",
 	"      " ZBX_PROF_ENABLE "=target         Enable profiling, affects all processes if",
 	"                                   target is not specified",
 	"      " ZBX_PROF_DISABLE "=target        Disable profiling, affects all processes if",
@@ -238,7 +240,8 @@ int	config_forks[ZBX_PROCESS_TYPE_COUNT] = {
 	0, /* ZBX_PROCESS_TYPE_DBCONFIGWORKER */
 	0, /* ZBX_PROCESS_TYPE_PG_MANAGER */
 	1, /* ZBX_PROCESS_TYPE_BROWSERPOLLER */
-	0 /* ZBX_PROCESS_TYPE_HA_MANAGER */
+	0, /* ZBX_PROCESS_TYPE_HA_MANAGER */
+	0 /* ZBX_PROCESS_TYPE_METRICS_EXPORTER */
 };
 
 static int	get_config_forks(unsigned char process_type)
@@ -260,6 +263,8 @@ static int	config_histsyncer_frequency	= 1;
 
 static int	config_listen_port		= ZBX_DEFAULT_SERVER_PORT;
 static char	*config_listen_ip		= NULL;
+static int	config_metrics_listen_port	= 0;
+static char	*config_metrics_listen_ip	= NULL;
 
 static int	config_heartbeat_frequency	= -1;
 
@@ -341,7 +346,8 @@ static const zbx_events_funcs_t	events_cbs = {
 	.clean_events_cb		= NULL,
 	.reset_event_recovery_cb	= NULL,
 	.export_events_cb		= NULL,
-	.events_update_itservices_cb	= NULL
+	.events_update_itservices_cb	= NULL,
+	.start_escalations_cb		= NULL
 };
 
 typedef struct
@@ -488,6 +494,11 @@ static int	get_process_info_by_thread(int local_server_num, unsigned char *local
 		*local_process_type = ZBX_PROCESS_TYPE_INTERNAL_POLLER;
 		*local_process_num = local_server_num - server_count + config_forks[ZBX_PROCESS_TYPE_INTERNAL_POLLER];
 	}
+	else if (local_server_num <= (server_count += config_forks[ZBX_PROCESS_TYPE_METRICS_EXPORTER]))
+	{
+		*local_process_type = ZBX_PROCESS_TYPE_METRICS_EXPORTER;
+		*local_process_num = local_server_num - server_count + config_forks[ZBX_PROCESS_TYPE_METRICS_EXPORTER];
+	}
 	else
 		return FAIL;
 
@@ -584,6 +595,9 @@ static void	zbx_set_defaults(void)
 	if (0 != config_forks[ZBX_PROCESS_TYPE_DISCOVERER])
 		config_forks[ZBX_PROCESS_TYPE_DISCOVERYMANAGER] = 1;
 
+	if (0 != config_metrics_listen_port)
+		config_forks[ZBX_PROCESS_TYPE_METRICS_EXPORTER] = 1;
+
 	if (NULL == zbx_config_vault.url)
 		zbx_config_vault.url = zbx_strdup(zbx_config_vault.url, "https://127.0.0.1:8200");
 
@@ -673,6 +687,15 @@ static void	zbx_validate_config(ZBX_TASK_EX *task)
 		zbx_free(ch_error);
 		err = 1;
 	}
+
+	if (0 != config_metrics_listen_port && (1024 > config_metrics_listen_port ||
+			(0 != config_forks[ZBX_PROCESS_TYPE_TRAPPER] &&
+			config_metrics_listen_port == config_listen_port)))
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "invalid \"MetricsListenPort\" configuration parameter: must be 0 or"
+				" between 1024 and 32767 and differ from \"ListenPort\"");
+		err = 1;
+	}
 #if !defined(HAVE_IPV6)
 	err |= (FAIL == zbx_check_cfg_feature_str("Fping6Location", zbx_config_fping6_location, "IPv6 support"));
 #endif
@@ -931,6 +954,10 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 				ZBX_CONF_PARM_OPT,	0,			0},
 		{"ListenPort",			&config_listen_port,			ZBX_CFG_TYPE_INT,
 				ZBX_CONF_PARM_OPT,	1024,			32767},
+		{"MetricsListenIP",		&config_metrics_listen_ip,		ZBX_CFG_TYPE_STRING_LIST,
+				ZBX_CONF_PARM_OPT,	0,			0},
+		{"MetricsListenPort",		&config_metrics_listen_port,		ZBX_CFG_TYPE_INT,
+				ZBX_CONF_PARM_OPT,	0,			32767},
 		{"SourceIP",			&zbx_config_source_ip,			ZBX_CFG_TYPE_STRING,
 				ZBX_CONF_PARM_OPT,	0,			0},
 		{"DebugLevel",			&config_log_level,			ZBX_CFG_TYPE_INT,
@@ -1488,7 +1515,8 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 								zbx_config_enable_remote_commands,
 								config_ssh_key_location, config_webdriver_url};
 	zbx_thread_httppoller_args		httppoller_args = {zbx_config_source_ip, config_ssl_ca_location,
-								config_ssl_cert_location, config_ssl_key_location};
+								config_ssl_cert_location, config_ssl_key_location,
+								config_max_concurrent_checks_per_poller};
 	zbx_thread_discoverer_args		discoverer_args = {zbx_config_tls, get_zbx_program_type,
 								get_zbx_progname, zbx_config_timeout,
 								config_forks[ZBX_PROCESS_TYPE_DISCOVERER],
@@ -1528,6 +1556,10 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 								config_vmware_perf_frequency, config_vmware_timeout};
 	zbx_thread_snmptrapper_args		snmptrapper_args = {.config_snmptrap_file = zbx_config_snmptrap_file,
 								.config_ha_node_name = NULL};
+	zbx_thread_metrics_exporter_args	metrics_exporter_args = {config_metrics_listen_ip,
+								config_metrics_listen_port, config_stats_allowed_ip,
+								config_startup_time, zbx_config_timeout,
+								config_tcp_max_backlog_size};
 
 	zbx_rtc_process_request_ex_func_t	rtc_process_request_func = NULL;
 
@@ -1676,6 +1708,20 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 		exit(EXIT_FAILURE);
 	}
 
+	if (SUCCEED != zbx_prof_probes_init(get_config_forks, &error))
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize profiler: %s", error);
+		zbx_free(error);
+		exit(EXIT_FAILURE);
+	}
+
+	if (SUCCEED != zbx_async_agent_stats_init(get_config_forks(ZBX_PROCESS_TYPE_AGENT_POLLER), &error))
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize agent poller statistics: %s", error);
+		zbx_free(error);
+		exit(EXIT_FAILURE);
+	}
+
 	if (0 != config_forks[ZBX_PROCESS_TYPE_VMWARE] && SUCCEED != zbx_vmware_init(&config_vmware_cache_size, &error))
 	{
 		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize VMware cache: %s", error);
@@ -1854,6 +1900,10 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 				thread_args.args = &vmware_args;
 				zbx_thread_start(zbx_vmware_thread, &thread_args, &zbx_threads[i]);
 				break;
+			case ZBX_PROCESS_TYPE_METRICS_EXPORTER:
+				thread_args.args = &metrics_exporter_args;
+				zbx_thread_start(zbx_metrics_exporter_thread, &thread_args, &zbx_threads[i]);
+				break;
 #ifdef HAVE_OPENIPMI
 			case ZBX_PROCESS_TYPE_IPMIMANAGER:
 				thread_args.args = &ipmimanager_args;
@@ -34,6 +34,7 @@
 #include "zbxipcservice.h"
 #include "zbxnum.h"
 #include "zbxjson.h"
+#include "zbx_proxyconfig_constants.h"
 
 static void	process_configuration_sync(size_t *data_size, zbx_synced_new_config_t *synced,
 		const zbx_thread_info_t *thread_info, zbx_thread_proxyconfig_args *args)
@@ -41,7 +42,7 @@ static void	process_configuration_sync(size_t *data_size, zbx_synced_new_config_
 	zbx_socket_t			sock;
 	struct	zbx_json_parse		jp, jp_kvs_paths = {0};
 	char				value[16], *error = NULL, *buffer = NULL;
-	size_t				buffer_size, reserved;
+	size_t				buffer_size, reserved, json_size;
 	struct zbx_json			j;
 	int				ret = FAIL;
 	zbx_uint64_t			config_revision, hostmap_revision;
@@ -60,6 +61,7 @@ static void	process_configuration_sync(size_t *data_size, zbx_synced_new_config_
 	zbx_json_addstring(&j, ZBX_PROTO_TAG_VERSION, ZABBIX_VERSION, ZBX_JSON_TYPE_STRING);
 	zbx_json_addstring(&j, ZBX_PROTO_TAG_SESSION, zbx_dc_get_session_token(), ZBX_JSON_TYPE_STRING);
 	zbx_json_adduint64(&j, ZBX_PROTO_TAG_CONFIG_REVISION, config_revision);
+	zbx_json_addint64(&j, ZBX_PROTO_TAG_CONFIG_FORMAT, ZBX_PROXYCONFIG_FORMAT_CURRENT);
 
 	if (0 != hostmap_revision)
 		zbx_json_adduint64(&j, ZBX_PROTO_TAG_HOSTMAP_REVISION, hostmap_revision);
@@ -125,7 +127,11 @@ static void	process_configuration_sync(size_t *data_size, zbx_synced_new_config_
 		goto error;
 	}
 
-	if (SUCCEED == (ret = zbx_proxyconfig_process(sock.peer, &jp, &status, &error)))
+	/* binary table data follows terminating zero of configuration json */
+	json_size = strlen(sock.buffer) + 1;
+
+	if (SUCCEED == (ret = zbx_proxyconfig_process(sock.peer, &jp, (unsigned char *)sock.buffer + json_size,
+			sock.read_bytes > json_size ? sock.read_bytes - json_size : 0, &status, &error)))
 	{
 		zbx_dc_sync_configuration(ZBX_DBSYNC_UPDATE, *synced, NULL, args->config_vault,
 				args->config_proxyconfig_frequency);
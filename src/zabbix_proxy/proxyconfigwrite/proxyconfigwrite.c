@@ -25,6 +25,8 @@
 #include "zbxjson.h"
 #include "zbxnum.h"
 #include "zbxstr.h"
+#include "zbxserialize.h"
+#include "zbx_proxyconfig_constants.h"
 
 /*
  * The configuration sync is split into 4 parts for each table:
@@ -107,10 +109,16 @@ ZBX_PTR_VECTOR_DECL(table_row_ptr, struct zbx_table_row *)
 /* bit defines for proxyconfig row flags, lower bits are reserved for field update flags */
 #define PROXYCONFIG_ROW_EXISTS		127
 
+/* offset of null value in table data value offsets */
+#define PROXYCONFIG_NULL_OFFSET		ZBX_MAX_UINT64
+
 typedef struct zbx_table_row
 {
 	zbx_uint64_t			recid;
-	struct zbx_json_parse		columns;
+
+	/* index of the first row value offset in table data value offsets */
+	int				offset;
+
 	zbx_flags128_t			flags;
 }
 zbx_table_row_t;
@@ -142,6 +150,13 @@ typedef struct
 
 	/* optional sql filter to limit managed object scope (exclude templates from hosts) */
 	char				*sql_filter;
+
+	/* received row values - zero terminated strings stored in value pool */
+	/* and referenced by offsets, fields.values_num offsets per row       */
+	char				*pool;
+	size_t				pool_alloc;
+	size_t				pool_offset;
+	zbx_vector_uint64_t		offsets;
 }
 zbx_table_data_t;
 
@@ -154,10 +169,74 @@ static void	table_data_free(zbx_table_data_t *td)
 	zbx_vector_uint64_destroy(&td->del_ids);
 	zbx_vector_table_row_ptr_destroy(&td->updates);
 	zbx_hashset_destroy(&td->rows);
+	zbx_vector_uint64_destroy(&td->offsets);
+	zbx_free(td->pool);
 	zbx_free(td->sql_filter);
 	zbx_free(td);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get received row value                                            *
+ *                                                                            *
+ * Parameters: td    - [IN] the table                                         *
+ *             row   - [IN] the row                                           *
+ *             index - [IN] the field index                                   *
+ *                                                                            *
+ * Return value: The row value or NULL if the value is null.                  *
+ *                                                                            *
+ ******************************************************************************/
+static const char	*table_row_value(const zbx_table_data_t *td, const zbx_table_row_t *row, int index)
+{
+	zbx_uint64_t	offset = td->offsets.values[row->offset + index];
+
+	if (PROXYCONFIG_NULL_OFFSET == offset)
+		return NULL;
+
+	return td->pool + offset;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: copy received value to table data value pool                      *
+ *                                                                            *
+ * Parameters: td    - [IN] the table                                         *
+ *             value - [IN] the value, NULL for null value                    *
+ *             len   - [IN] the value length                                  *
+ *                                                                            *
+ * Return value: The value offset in pool.                                    *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_uint64_t	table_data_pool_add(zbx_table_data_t *td, const char *value, size_t len)
+{
+	zbx_uint64_t	offset;
+
+	if (NULL == value)
+		return PROXYCONFIG_NULL_OFFSET;
+
+	offset = (zbx_uint64_t)td->pool_offset;
+
+	/* keep the terminating zero in pool */
+	zbx_strncpy_alloc(&td->pool, &td->pool_alloc, &td->pool_offset, value, len);
+	td->pool_offset++;
+
+	return offset;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add received row value to table data                              *
+ *                                                                            *
+ * Parameters: td    - [IN] the table                                         *
+ *             value - [IN] the value, NULL for null value                    *
+ *             len   - [IN] the value length                                  *
+ *                                                                            *
+ ******************************************************************************/
+static void	table_data_add_value(zbx_table_data_t *td, const char *value, size_t len)
+{
+	zbx_vector_uint64_append(&td->offsets, table_data_pool_add(td, value, len));
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: get table data by name from configuration updates                 *
@@ -245,11 +324,12 @@ out:
  ******************************************************************************/
 static int	proxyconfig_parse_table_rows(zbx_table_data_t *td, struct zbx_json_parse *jp_table, char **error)
 {
-	const char		*p;
-	int			ret = FAIL;
+	const char		*p, *pf;
+	int			ret = FAIL, i;
 	struct zbx_json_parse	jp, jp_row;
 	char			*buf;
 	size_t			buf_alloc = ZBX_KIBIBYTE;
+	zbx_json_type_t		type;
 
 	buf = (char *)zbx_malloc(NULL, buf_alloc);
 
@@ -276,8 +356,26 @@ static int	proxyconfig_parse_table_rows(zbx_table_data_t *td, struct zbx_json_pa
 			*error = zbx_dsprintf(*error, "invalid record identifier: \"%s\"", buf);
 			goto out;
 		}
+		row_local.offset = td->offsets.values_num;
+
+		for (i = 0, pf = NULL; NULL != (pf = zbx_json_next_value_dyn(&jp_row, pf, &buf, &buf_alloc, &type));
+				i++)
+		{
+			if (ZBX_JSON_TYPE_NULL == type)
+				table_data_add_value(td, NULL, 0);
+			else
+				table_data_add_value(td, buf, strlen(buf));
+		}
+
+		if (i != td->fields.values_num)
+		{
+			*error = zbx_dsprintf(*error, "invalid number of values in table \"%s\" record " ZBX_FS_UI64,
+					td->table->table, row_local.recid);
+			goto out;
+		}
+
 		row = (zbx_table_row_t *)zbx_hashset_insert(&td->rows, &row_local, sizeof(row_local));
-		row->columns = jp_row;
+		row->offset = row_local.offset;
 		zbx_flags128_init(&row->flags);
 	}
 
@@ -318,6 +416,10 @@ static zbx_table_data_t	*proxyconfig_create_table(const char *name)
 	zbx_hashset_create(&td->rows, 100, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 	zbx_vector_uint64_create(&td->del_ids);
 	zbx_vector_table_row_ptr_create(&td->updates);
+	zbx_vector_uint64_create(&td->offsets);
+	td->pool = NULL;
+	td->pool_alloc = 0;
+	td->pool_offset = 0;
 
 	/* apply table specific configuration settings */
 
@@ -461,6 +563,253 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: read compact unsigned integer from binary configuration data      *
+ *                                                                            *
+ ******************************************************************************/
+static int	proxyconfig_read_uint64(const unsigned char **ptr, const unsigned char *end, zbx_uint64_t *value)
+{
+	zbx_uint32_t	len;
+
+	if (0 == (len = zbx_deserialize_uint64_compact(*ptr, end, value)))
+		return FAIL;
+
+	*ptr += len;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: read length prefixed byte sequence from binary configuration data *
+ *                                                                            *
+ ******************************************************************************/
+static int	proxyconfig_read_bytes(const unsigned char **ptr, const unsigned char *end, const unsigned char **data,
+		size_t *len)
+{
+	zbx_uint64_t	value;
+
+	if (SUCCEED != proxyconfig_read_uint64(ptr, end, &value) || (zbx_uint64_t)(end - *ptr) < value)
+		return FAIL;
+
+	*data = *ptr;
+	*len = (size_t)value;
+	*ptr += value;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parse column of table rows in binary configuration data           *
+ *                                                                            *
+ * Parameters: td       - [IN] the table                                      *
+ *             index    - [IN] the column index                               *
+ *             rows_num - [IN] the number of table rows                       *
+ *             ptr      - [IN/OUT] the binary data                            *
+ *             end      - [IN] the end of binary data                         *
+ *             recids   - [OUT] the record identifiers, parsed from first     *
+ *                              column only                                   *
+ *                                                                            *
+ * Return: SUCCEED - the column was parsed successfully                       *
+ *         FAIL    - otherwise                                                *
+ *                                                                            *
+ ******************************************************************************/
+static int	proxyconfig_parse_table_column_bin(zbx_table_data_t *td, int index, int rows_num,
+		const unsigned char **ptr, const unsigned char *end, zbx_vector_uint64_t *recids)
+{
+	const unsigned char	*kinds, *values, *values_end;
+	size_t			kinds_len, values_len;
+	zbx_uint64_t		number = 0, delta;
+	char			buf[ZBX_MAX_UINT64_LEN];
+
+	/* kinds take 2 bits per row */
+	if (SUCCEED != proxyconfig_read_bytes(ptr, end, &kinds, &kinds_len) ||
+			kinds_len != (size_t)(rows_num + 3) / 4 ||
+			SUCCEED != proxyconfig_read_bytes(ptr, end, &values, &values_len))
+	{
+		return FAIL;
+	}
+
+	values_end = values + values_len;
+
+	for (int i = 0; i < rows_num; i++)
+	{
+		zbx_uint64_t	*offset = &td->offsets.values[i * td->fields.values_num + index];
+		const char	*str;
+		size_t		len;
+
+		switch ((kinds[i >> 2] >> ((i & 3) << 1)) & 3)
+		{
+			case ZBX_PROXYCONFIG_VALUE_NULL:
+				if (0 == index)
+					return FAIL;
+
+				*offset = PROXYCONFIG_NULL_OFFSET;
+				break;
+			case ZBX_PROXYCONFIG_VALUE_NUMBER:
+				if (SUCCEED != proxyconfig_read_uint64(&values, values_end, &delta))
+					return FAIL;
+
+				/* numbers are stored as zigzag encoded differences from the previous column number */
+				number += (delta >> 1) ^ (0 - (delta & 1));
+
+				if (0 == index)
+					zbx_vector_uint64_append(recids, number);
+
+				len = zbx_snprintf(buf, sizeof(buf), ZBX_FS_UI64, number);
+				*offset = table_data_pool_add(td, buf, len);
+				break;
+			case ZBX_PROXYCONFIG_VALUE_STRING:
+				if (0 == index || SUCCEED != proxyconfig_read_bytes(&values, values_end,
+						(const unsigned char **)&str, &len))
+				{
+					return FAIL;
+				}
+
+				*offset = table_data_pool_add(td, str, len);
+				break;
+			default:
+				return FAIL;
+		}
+	}
+
+	return values == values_end ? SUCCEED : FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parse received configuration data in binary format                *
+ *                                                                            *
+ * Parameters: data          - [IN] the configuration table data              *
+ *             data_size     - [IN] the configuration table data size         *
+ *             config_tables - [OUT] the parsed table data                    *
+ *             error         - [OUT] the error message                        *
+ *                                                                            *
+ * Return: SUCCEED - the tables were parsed successfully                      *
+ *         FAIL    - otherwise                                                *
+ *                                                                            *
+ * Comments: See proxy configuration reader on server for format description. *
+ *                                                                            *
+ ******************************************************************************/
+static int	proxyconfig_parse_data_bin(const unsigned char *data, size_t data_size,
+		zbx_vector_table_data_ptr_t *config_tables, char **error)
+{
+	const unsigned char	*ptr = data, *end = data + data_size, *str;
+	char			name[ZBX_TABLENAME_LEN_MAX];
+	size_t			len;
+	zbx_uint64_t		value;
+	zbx_table_data_t	*td = NULL;
+	zbx_vector_uint64_t	recids;
+	int			ret = FAIL, rows_num;
+
+	zbx_vector_uint64_create(&recids);
+
+	while (1)
+	{
+		if (SUCCEED != proxyconfig_read_bytes(&ptr, end, &str, &len) || sizeof(name) <= len)
+			goto truncated;
+
+		/* table list is terminated by empty table name */
+		if (0 == len)
+			break;
+
+		memcpy(name, str, len);
+		name[len] = '\0';
+
+		if (NULL == (td = proxyconfig_create_table(name)))
+		{
+			*error = zbx_dsprintf(NULL, "invalid table name \"%s\"", name);
+			goto out;
+		}
+
+		if (SUCCEED != proxyconfig_read_uint64(&ptr, end, &value))
+			goto truncated;
+
+		if (value != (zbx_uint64_t)td->fields.values_num)
+		{
+			*error = zbx_dsprintf(NULL, "unexpected number of fields " ZBX_FS_UI64 " in table \"%s\"",
+					value, td->table->table);
+			goto out;
+		}
+
+		for (int i = 0; i < td->fields.values_num; i++)
+		{
+			const char	*field_name = td->fields.values[i].field->name;
+
+			if (SUCCEED != proxyconfig_read_bytes(&ptr, end, &str, &len))
+				goto truncated;
+
+			if (len != strlen(field_name) || 0 != memcmp(str, field_name, len))
+			{
+				*error = zbx_dsprintf(NULL, "unexpected field \"%s.%.*s\"", td->table->table, (int)len,
+						(const char *)str);
+				goto out;
+			}
+		}
+
+		/* each row takes at least 2 bits in every column */
+		if (SUCCEED != proxyconfig_read_uint64(&ptr, end, &value) ||
+				value > (zbx_uint64_t)(end - ptr) * 4 ||
+				(zbx_uint64_t)(INT_MAX / td->fields.values_num) < value)
+		{
+			goto truncated;
+		}
+
+		rows_num = (int)value;
+
+		zbx_vector_uint64_reserve(&td->offsets, (size_t)(rows_num * td->fields.values_num));
+		td->offsets.values_num = rows_num * td->fields.values_num;
+		zbx_hashset_reserve(&td->rows, rows_num);
+
+		for (int i = 0; i < td->fields.values_num; i++)
+		{
+			if (SUCCEED != proxyconfig_parse_table_column_bin(td, i, rows_num, &ptr, end, &recids))
+			{
+				*error = zbx_dsprintf(NULL, "invalid data of field \"%s.%s\"", td->table->table,
+						td->fields.values[i].field->name);
+				goto out;
+			}
+		}
+
+		for (int i = 0; i < rows_num; i++)
+		{
+			zbx_table_row_t	*row, row_local;
+
+			row_local.recid = recids.values[i];
+			row_local.offset = i * td->fields.values_num;
+
+			row = (zbx_table_row_t *)zbx_hashset_insert(&td->rows, &row_local, sizeof(row_local));
+			row->offset = row_local.offset;
+			zbx_flags128_init(&row->flags);
+		}
+
+		zbx_vector_uint64_clear(&recids);
+		zbx_vector_table_data_ptr_append(config_tables, td);
+		td = NULL;
+	}
+
+	if (ptr != end)
+	{
+		*error = zbx_strdup(NULL, "unexpected data after configuration tables");
+		goto out;
+	}
+
+	ret = SUCCEED;
+	goto out;
+truncated:
+	*error = zbx_dsprintf(NULL, "invalid or truncated configuration data%s%s", NULL != td ? " in table " : "",
+			NULL != td ? td->table->table : "");
+out:
+	if (NULL != td)
+		table_data_free(td);
+
+	zbx_vector_uint64_destroy(&recids);
+
+	return ret;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: add default tables to configuration data                          *
@@ -496,13 +845,10 @@ static void	proxyconfig_add_default_tables(zbx_vector_table_data_ptr_t *config_t
 static void	proxyconfig_dump_table(zbx_table_data_t *td)
 {
 	char			*str = NULL;
-	size_t			str_alloc = 0, str_offset = 0, buf_alloc = ZBX_KIBIBYTE;
+	size_t			str_alloc = 0, str_offset = 0;
 	int			i;
 	zbx_hashset_iter_t	iter;
 	zbx_table_row_t		*row;
-	char			*buf;
-
-	buf = (char *)zbx_malloc(NULL, buf_alloc);
 
 	zabbix_log(LOG_LEVEL_TRACE, "table:%s", td->table->table);
 
@@ -516,19 +862,19 @@ static void	proxyconfig_dump_table(zbx_table_data_t *td)
 	zbx_hashset_iter_reset(&td->rows, &iter);
 	while (NULL != (row = (zbx_table_row_t *)zbx_hashset_iter_next(&iter)))
 	{
-		const char	*pf = NULL;
-
 		str_offset = 0;
 		zbx_chrcpy_alloc(&str, &str_alloc, &str_offset, '|');
 
-		while (NULL != (pf = zbx_json_next_value_dyn(&row->columns, pf, &buf, &buf_alloc, NULL)))
-			zbx_snprintf_alloc(&str, &str_alloc, &str_offset, "%s|", buf);
+		for (i = 0; i < td->fields.values_num; i++)
+		{
+			zbx_snprintf_alloc(&str, &str_alloc, &str_offset, "%s|",
+					ZBX_NULL2EMPTY_STR(table_row_value(td, row, i)));
+		}
 
 		zabbix_log(LOG_LEVEL_TRACE, "  %s", str);
 	}
 
 	zbx_free(str);
-	zbx_free(buf);
 }
 
 /******************************************************************************
@@ -552,10 +898,9 @@ static void	proxyconfig_dump_data(const zbx_vector_table_data_ptr_t *config_tabl
  *                                                                            *
  * Purpose: compare database row with received data                           *
  *                                                                            *
- * Parameters: row       - [IN] the received row                              *
+ * Parameters: td        - [IN] the table data object                         *
+ *             row       - [IN] the received row                              *
  *             dbrow     - [IN] the database row                              *
- *             buf       - [IN/OUT] the buffer for value parsing              *
- *             buf_alloc - [IN/OUT] the buffer size                           *
  *                                                                            *
  * Return value: SUCCEED - the rows match                                     *
  *               FAIl - the rows doesn't match                                *
@@ -565,25 +910,23 @@ static void	proxyconfig_dump_data(const zbx_vector_table_data_ptr_t *config_tabl
  *           update flag will be set if at last one match failed.             *
  *                                                                            *
  ******************************************************************************/
-static int	proxyconfig_compare_row(zbx_table_row_t *row, zbx_db_row_t dbrow, char **buf, size_t *buf_alloc)
+static int	proxyconfig_compare_row(const zbx_table_data_t *td, zbx_table_row_t *row, zbx_db_row_t dbrow)
 {
-	int		i, ret = SUCCEED;
-	const char	*pf;
-	zbx_json_type_t	type;
-
-	/* skip first row containing record id */
-	pf = zbx_json_next(&row->columns, NULL);
+	int	i, ret = SUCCEED;
 
-	for (i = 1; NULL != (pf = zbx_json_next_value_dyn(&row->columns, pf, buf, buf_alloc, &type)); i++)
+	/* skip first column containing record id */
+	for (i = 1; i < td->fields.values_num; i++)
 	{
-		if (ZBX_JSON_TYPE_NULL == type)
+		const char	*value = table_row_value(td, row, i);
+
+		if (NULL == value)
 		{
 			if (SUCCEED != zbx_db_is_null(dbrow[i]))
 				zbx_flags128_set(&row->flags, i);
 			continue;
 		}
 
-		if (SUCCEED == zbx_db_is_null(dbrow[i]) || 0 != strcmp(*buf, dbrow[i]))
+		if (SUCCEED == zbx_db_is_null(dbrow[i]) || 0 != strcmp(value, dbrow[i]))
 			zbx_flags128_set(&row->flags, i);
 	}
 
@@ -764,8 +1107,7 @@ out:
  *                                                                            *
  * Parameters: table - [IN]                                                   *
  *             field - [IN]                                                   *
- *             buf   - [IN] the value to convert                              *
- *             type  - [IN] the json value type                               *
+ *             buf   - [IN] the value to convert, NULL for null value         *
  *             value - [OUT] the converted value (optional)                   *
  *             error - [OUT] the error message                                *
  *                                                                            *
@@ -777,7 +1119,7 @@ out:
  *                                                                            *
  ******************************************************************************/
 static int	proxyconfig_convert_value(const zbx_db_table_t *table, const zbx_db_field_t *field, const char *buf,
-		zbx_json_type_t type, zbx_db_value_t **value, char **error)
+		zbx_db_value_t **value, char **error)
 {
 	zbx_db_value_t	value_local;
 	int		ret;
@@ -785,13 +1127,13 @@ static int	proxyconfig_convert_value(const zbx_db_table_t *table, const zbx_db_f
 	switch (field->type)
 	{
 		case ZBX_TYPE_INT:
-			ret = zbx_is_int(buf, &value_local.i32);
+			ret = zbx_is_int(ZBX_NULL2EMPTY_STR(buf), &value_local.i32);
 			break;
 		case ZBX_TYPE_UINT:
-			ret = zbx_is_uint64(buf, &value_local.ui64);
+			ret = zbx_is_uint64(ZBX_NULL2EMPTY_STR(buf), &value_local.ui64);
 			break;
 		case ZBX_TYPE_ID:
-			if (ZBX_JSON_TYPE_NULL == type)
+			if (NULL == buf)
 			{
 				value_local.ui64 = 0;
 				ret = SUCCEED;
@@ -800,7 +1142,7 @@ static int	proxyconfig_convert_value(const zbx_db_table_t *table, const zbx_db_f
 				ret = zbx_is_uint64(buf, &value_local.ui64);
 			break;
 		case ZBX_TYPE_FLOAT:
-			ret = zbx_is_double(buf, &value_local.dbl);
+			ret = zbx_is_double(ZBX_NULL2EMPTY_STR(buf), &value_local.dbl);
 			break;
 		case ZBX_TYPE_CHAR:
 		case ZBX_TYPE_TEXT:
@@ -818,7 +1160,7 @@ static int	proxyconfig_convert_value(const zbx_db_table_t *table, const zbx_db_f
 	if (SUCCEED != ret)
 	{
 		*error = zbx_dsprintf(*error, "invalid field \"%s.%s\" value \"%s\"",
-				table->table, field->name, buf);
+				table->table, field->name, ZBX_NULL2EMPTY_STR(buf));
 		return FAIL;
 	}
 
@@ -844,29 +1186,24 @@ static int	proxyconfig_convert_value(const zbx_db_table_t *table, const zbx_db_f
  ******************************************************************************/
 static int	proxyconfig_update_rows(zbx_table_data_t *td, char **error)
 {
-	char	*sql = NULL, *buf;
-	size_t	sql_alloc = 0, sql_offset = 0, buf_alloc = ZBX_KIBIBYTE;
+	char	*sql = NULL;
+	size_t	sql_alloc = 0, sql_offset = 0;
 	int	i, j, ret = FAIL;
 
 	if (0 == td->updates.values_num)
 		return SUCCEED;
 
-	buf = (char *)zbx_malloc(NULL, buf_alloc);
-
 	for (i = 0; i < td->updates.values_num; i++)
 	{
 		char		delim = ' ';
-		const char	*pf;
 		zbx_table_row_t	*row = td->updates.values[i];
-		zbx_json_type_t	type;
 
 		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "update %s set", td->table->table);
 
-		pf = zbx_json_next(&row->columns, NULL);
-
-		for (j = 1; NULL != (pf = zbx_json_next_value_dyn(&row->columns, pf, &buf, &buf_alloc, &type)); j++)
+		for (j = 1; j < td->fields.values_num; j++)
 		{
 			const zbx_db_field_t	*field = td->fields.values[j].field;
+			const char		*buf;
 			char			*value_esc;
 
 			if (SUCCEED != zbx_flags128_isset(&row->flags, j))
@@ -875,13 +1212,13 @@ static int	proxyconfig_update_rows(zbx_table_data_t *td, char **error)
 			zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "%c%s=", delim, field->name);
 			delim = ',';
 
-			if (ZBX_JSON_TYPE_NULL == type)
+			if (NULL == (buf = table_row_value(td, row, j)))
 			{
 				zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, "null");
 				continue;
 			}
 
-			if (SUCCEED != proxyconfig_convert_value(td->table, field, buf, type, NULL, error))
+			if (SUCCEED != proxyconfig_convert_value(td->table, field, buf, NULL, error))
 				goto out;
 
 			switch (field->type)
@@ -919,7 +1256,6 @@ static int	proxyconfig_update_rows(zbx_table_data_t *td, char **error)
 	ret = SUCCEED;
 out:
 	zbx_free(sql);
-	zbx_free(buf);
 
 	if (SUCCEED != ret && NULL == *error)
 		*error = zbx_dsprintf(NULL, "cannot update rows in table \"%s\"", td->table->table);
@@ -964,10 +1300,6 @@ static int	proxyconfig_insert_rows(zbx_table_data_t *td, char **error)
 		zbx_db_insert_t			db_insert;
 		const zbx_db_field_t		*fields[ZBX_MAX_FIELDS];
 		int				i, j;
-		char				*buf;
-		size_t				buf_alloc = ZBX_KIBIBYTE;
-
-		buf = (char *)zbx_malloc(NULL, buf_alloc);
 
 		zbx_vector_db_value_ptr_create(&values);
 
@@ -978,13 +1310,9 @@ static int	proxyconfig_insert_rows(zbx_table_data_t *td, char **error)
 
 		for (i = 0; i < rows.values_num && SUCCEED == ret; i++)
 		{
-			const char	*pf = NULL;
-			zbx_json_type_t	type;
-
 			row = rows.values[i];
 
-			for (j = 0; NULL != (pf = zbx_json_next_value_dyn(&row->columns, pf, &buf, &buf_alloc, &type));
-					j++)
+			for (j = 0; j < td->fields.values_num; j++)
 			{
 				zbx_db_value_t	*value;
 
@@ -1016,8 +1344,8 @@ static int	proxyconfig_insert_rows(zbx_table_data_t *td, char **error)
 				}
 				else
 				{
-					if (SUCCEED != (ret = proxyconfig_convert_value(td->table, fields[j], buf, type,
-							&value, error)))
+					if (SUCCEED != (ret = proxyconfig_convert_value(td->table, fields[j],
+							table_row_value(td, row, j), &value, error)))
 					{
 						goto clean;
 					}
@@ -1047,8 +1375,6 @@ clean:
 
 		zbx_db_insert_clean(&db_insert);
 		zbx_vector_db_value_ptr_destroy(&values);
-		zbx_free(buf);
-
 	}
 
 	zbx_vector_table_row_ptr_destroy(&rows);
@@ -1079,8 +1405,8 @@ static void	proxyconfig_prepare_table(zbx_table_data_t *td, const char *key_fiel
 {
 	zbx_db_result_t	result;
 	zbx_db_row_t	dbrow;
-	char		*sql = NULL, *buf, *delim = " where";
-	size_t		sql_alloc = 0, sql_offset = 0, buf_alloc = ZBX_KIBIBYTE;
+	char		*sql = NULL, *delim = " where";
+	size_t		sql_alloc = 0, sql_offset = 0;
 	zbx_uint64_t	recid;
 	zbx_table_row_t	*row;
 	int		i;
@@ -1088,8 +1414,6 @@ static void	proxyconfig_prepare_table(zbx_table_data_t *td, const char *key_fiel
 	if (NULL != key_ids && 0 == key_ids->values_num)
 		return;
 
-	buf = (char *)zbx_malloc(NULL, buf_alloc);
-
 	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "select %s", td->table->recid);
 
 	for (i = 1; i < td->fields.values_num; i++)
@@ -1123,13 +1447,12 @@ static void	proxyconfig_prepare_table(zbx_table_data_t *td, const char *key_fiel
 			continue;
 		}
 
-		if (SUCCEED != proxyconfig_compare_row(row, dbrow, &buf, &buf_alloc))
+		if (SUCCEED != proxyconfig_compare_row(td, row, dbrow))
 			zbx_vector_table_row_ptr_append(&td->updates, row);
 	}
 	zbx_db_free_result(result);
 
 	zbx_free(sql);
-	zbx_free(buf);
 
 	if (0 != td->del_ids.values_num)
 		zbx_vector_uint64_sort(&td->del_ids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
@@ -1470,14 +1793,11 @@ static void	proxyconfig_prepare_hostmacros(zbx_table_data_t *hostmacro, zbx_tabl
 		zbx_hashset_iter_reset(&hostmacro->rows, &iter);
 		while (NULL != (row = (zbx_table_row_t *)zbx_hashset_iter_next(&iter)))
 		{
-			const char	*pf;
-			char		buf[ZBX_MAX_UINT64_LEN + 1];
+			const char	*value;
 			zbx_uint64_t	hostid;
 
-			pf = zbx_json_next(&row->columns, NULL);
-
-			if (NULL != zbx_json_next_value(&row->columns, pf, buf, sizeof(buf), NULL) &&
-					SUCCEED == zbx_is_uint64(buf, &hostid))
+			if (NULL != (value = table_row_value(hostmacro, row, 1)) &&
+					SUCCEED == zbx_is_uint64(value, &hostid))
 			{
 				zbx_vector_uint64_append(&hostids, hostid);
 			}
@@ -1486,14 +1806,11 @@ static void	proxyconfig_prepare_hostmacros(zbx_table_data_t *hostmacro, zbx_tabl
 		zbx_hashset_iter_reset(&hosts_templates->rows, &iter);
 		while (NULL != (row = (zbx_table_row_t *)zbx_hashset_iter_next(&iter)))
 		{
-			const char	*pf;
-			char		buf[ZBX_MAX_UINT64_LEN + 1];
+			const char	*value;
 			zbx_uint64_t	hostid;
 
-			pf = zbx_json_next(&row->columns, NULL);
-
-			if (NULL != zbx_json_next_value(&row->columns, pf, buf, sizeof(buf), NULL) &&
-					SUCCEED == zbx_is_uint64(buf, &hostid))
+			if (NULL != (value = table_row_value(hosts_templates, row, 1)) &&
+					SUCCEED == zbx_is_uint64(value, &hostid))
 			{
 				zbx_vector_uint64_append(&hostids, hostid);
 			}
@@ -1541,20 +1858,17 @@ static int	proxyconfig_sync_templates(zbx_table_data_t *hosts_templates, zbx_tab
 	zbx_hashset_iter_reset(&hosts_templates->rows, &iter);
 	while (NULL != (row = (zbx_table_row_t *)zbx_hashset_iter_next(&iter)))
 	{
-		const char	*pf;
-		char		buf[ZBX_MAX_UINT64_LEN + 1];
+		const char	*value;
 		zbx_uint64_t	templateid;
 
-		pf = zbx_json_next(&row->columns, NULL);
-
-		if (NULL != (pf = zbx_json_next_value(&row->columns, pf, buf, sizeof(buf), NULL)) &&
-				SUCCEED == zbx_is_uint64(buf, &templateid))
+		if (NULL != (value = table_row_value(hosts_templates, row, 1)) &&
+				SUCCEED == zbx_is_uint64(value, &templateid))
 		{
 			zbx_vector_uint64_append(&templateids, templateid);
 		}
 
-		if (NULL != zbx_json_next_value(&row->columns, pf, buf, sizeof(buf), NULL) &&
-				SUCCEED == zbx_is_uint64(buf, &templateid))
+		if (NULL != (value = table_row_value(hosts_templates, row, 2)) &&
+				SUCCEED == zbx_is_uint64(value, &templateid))
 		{
 			zbx_vector_uint64_append(&templateids, templateid);
 		}
@@ -1563,14 +1877,11 @@ static int	proxyconfig_sync_templates(zbx_table_data_t *hosts_templates, zbx_tab
 	zbx_hashset_iter_reset(&hostmacro->rows, &iter);
 	while (NULL != (row = (zbx_table_row_t *)zbx_hashset_iter_next(&iter)))
 	{
-		const char	*pf;
-		char		buf[ZBX_MAX_UINT64_LEN + 1];
+		const char	*value;
 		zbx_uint64_t	templateid;
 
-		pf = zbx_json_next(&row->columns, NULL);
-
-		if (NULL != zbx_json_next_value(&row->columns, pf, buf, sizeof(buf), NULL) &&
-				SUCCEED == zbx_is_uint64(buf, &templateid))
+		if (NULL != (value = table_row_value(hostmacro, row, 1)) &&
+				SUCCEED == zbx_is_uint64(value, &templateid))
 		{
 			zbx_vector_uint64_append(&templateids, templateid);
 		}
@@ -2081,12 +2392,24 @@ static int	proxyconfig_prepare_proxy_group(zbx_vector_table_data_ptr_t *config_t
  *                                                                            *
  * Purpose: update configuration                                              *
  *                                                                            *
+ * Parameters: addr      - [IN] the server address                            *
+ *             jp        - [IN] the configuration data                        *
+ *             data      - [IN] the binary table data following               *
+ *                              configuration json                            *
+ *             data_size - [IN] the binary table data size                    *
+ *             status    - [OUT] the configuration update status              *
+ *             error     - [OUT] the error message                            *
+ *                                                                            *
+ * Return value: SUCCEED - the configuration was updated successfully         *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
  ******************************************************************************/
-int	zbx_proxyconfig_process(const char *addr, struct zbx_json_parse *jp, zbx_proxyconfig_write_status_t *status,
-		char **error)
+int	zbx_proxyconfig_process(const char *addr, struct zbx_json_parse *jp, const unsigned char *data,
+		size_t data_size, zbx_proxyconfig_write_status_t *status, char **error)
 {
 	zbx_vector_table_data_ptr_t	config_tables;
-	int			ret = SUCCEED, full_sync = 0, delete_globalmacros = 0, loglevel;
+	int			ret = SUCCEED, full_sync = 0, delete_globalmacros = 0, loglevel,
+				format = ZBX_PROXYCONFIG_FORMAT_JSON;
 	char			tmp[ZBX_MAX_UINT64_LEN + 1];
 	struct zbx_json_parse	jp_data = {NULL, NULL}, jp_del_hostids = {NULL, NULL}, jp_proxy_group = {NULL, NULL},
 				jp_del_macro_hostids = {NULL, NULL};
@@ -2100,8 +2423,12 @@ int	zbx_proxyconfig_process(const char *addr, struct zbx_json_parse *jp, zbx_pro
 	(void)zbx_json_brackets_by_name(jp, ZBX_PROTO_TAG_REMOVED_MACRO_HOSTIDS, &jp_del_macro_hostids);
 	(void)zbx_json_brackets_by_name(jp, ZBX_PROTO_TAG_PROXY_GROUP, &jp_proxy_group);
 
-	if ((NULL == jp_data.start || 1 == jp_data.end - jp_data.start) && NULL == jp_del_hostids.start &&
-			NULL == jp_del_macro_hostids.start)
+	if (SUCCEED == zbx_json_value_by_name(jp, ZBX_PROTO_TAG_CONFIG_FORMAT, tmp, sizeof(tmp), NULL))
+		format = atoi(tmp);
+
+	/* binary table data contains at least the terminating empty table name */
+	if ((NULL == jp_data.start || 1 == jp_data.end - jp_data.start) && 1 >= data_size &&
+			NULL == jp_del_hostids.start && NULL == jp_del_macro_hostids.start)
 	{
 		loglevel = LOG_LEVEL_DEBUG;
 	}
@@ -2109,7 +2436,7 @@ int	zbx_proxyconfig_process(const char *addr, struct zbx_json_parse *jp, zbx_pro
 		loglevel = LOG_LEVEL_WARNING;
 
 	zabbix_log(loglevel, "received configuration data from server at \"%s\", datalen " ZBX_FS_SSIZE_T,
-			addr, jp->end - jp->start + 1);
+			addr, jp->end - jp->start + 1 + (ssize_t)data_size);
 
 	if (1 == jp->end - jp->start)
 	{
@@ -2138,11 +2465,25 @@ int	zbx_proxyconfig_process(const char *addr, struct zbx_json_parse *jp, zbx_pro
 	zbx_vector_uint64_create(&del_hostids);
 	zbx_vector_uint64_create(&del_macro_hostids);
 
-	if (NULL != jp_data.start)
+	if (ZBX_PROXYCONFIG_FORMAT_BINARY == format)
+	{
+		if (SUCCEED != (ret = proxyconfig_parse_data_bin(data, data_size, &config_tables, error)))
+			goto clean;
+	}
+	else if (ZBX_PROXYCONFIG_FORMAT_JSON != format)
+	{
+		*error = zbx_dsprintf(NULL, "unsupported proxy configuration format %d", format);
+		ret = FAIL;
+		goto clean;
+	}
+	else if (NULL != jp_data.start)
 	{
 		if (SUCCEED != (ret = proxyconfig_parse_data(&jp_data, &config_tables, error)))
 			goto clean;
+	}
 
+	if (0 != config_tables.values_num)
+	{
 		if (SUCCEED == ZBX_CHECK_LOG_LEVEL(LOG_LEVEL_TRACE))
 			proxyconfig_dump_data(&config_tables);
 
@@ -2231,6 +2572,7 @@ void	zbx_recv_proxyconfig(zbx_socket_t *sock, const zbx_config_tls_t *config_tls
 	int				ret;
 	struct zbx_json			j;
 	char				*error = NULL;
+	size_t				json_size;
 	zbx_uint64_t			config_revision, hostmap_revision;
 	zbx_proxyconfig_write_status_t	status = ZBX_PROXYCONFIG_WRITE_STATUS_DATA;
 
@@ -2248,6 +2590,7 @@ void	zbx_recv_proxyconfig(zbx_socket_t *sock, const zbx_config_tls_t *config_tls
 	zbx_json_addstring(&j, ZBX_PROTO_TAG_VERSION, ZABBIX_VERSION, ZBX_JSON_TYPE_STRING);
 	zbx_json_addstring(&j, ZBX_PROTO_TAG_SESSION, zbx_dc_get_session_token(), ZBX_JSON_TYPE_STRING);
 	zbx_json_adduint64(&j, ZBX_PROTO_TAG_CONFIG_REVISION, config_revision);
+	zbx_json_addint64(&j, ZBX_PROTO_TAG_CONFIG_FORMAT, ZBX_PROXYCONFIG_FORMAT_CURRENT);
 
 	if (0 != hostmap_revision)
 		zbx_json_adduint64(&j, ZBX_PROTO_TAG_HOSTMAP_REVISION, hostmap_revision);
@@ -2283,7 +2626,11 @@ void	zbx_recv_proxyconfig(zbx_socket_t *sock, const zbx_config_tls_t *config_tls
 		goto out;
 	}
 
-	if (SUCCEED == (ret = zbx_proxyconfig_process(sock->peer, &jp_config, &status, &error)))
+	/* binary table data follows terminating zero of configuration json */
+	json_size = strlen(sock->buffer) + 1;
+
+	if (SUCCEED == (ret = zbx_proxyconfig_process(sock->peer, &jp_config, (unsigned char *)sock->buffer + json_size,
+			sock->read_bytes > json_size ? sock->read_bytes - json_size : 0, &status, &error)))
 	{
 		if (SUCCEED == zbx_rtc_reload_config_cache(&error))
 		{
@@ -25,8 +25,8 @@ typedef enum {
 }
 zbx_proxyconfig_write_status_t;
 
-int	zbx_proxyconfig_process(const char *addr, struct zbx_json_parse *jp, zbx_proxyconfig_write_status_t *status,
-		char **error);
+int	zbx_proxyconfig_process(const char *addr, struct zbx_json_parse *jp, const unsigned char *data,
+		size_t data_size, zbx_proxyconfig_write_status_t *status, char **error);
 
 void	zbx_recv_proxyconfig(zbx_socket_t *sock, const zbx_config_tls_t *config_tls,
 		const zbx_config_vault_t *config_vault, int config_timeout, int config_trapper_timeout,
@@ -131,6 +131,152 @@ static void	get_object_ids(const zbx_vector_db_event_t *esc_events, zbx_vector_u
 	zbx_vector_uint64_uniq(objectids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 }
 
+#define ACTION_HOSTS_MATCH_ANY		0	/* any object host is in the set */
+#define ACTION_HOSTS_MATCH_NONE		1	/* no object host is in the set */
+#define ACTION_HOSTS_MATCH_ANY_OTHER	2	/* any object host is not in the set */
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: saves eventids of objects whose hosts match the host set          *
+ *                                                                            *
+ * Parameters: esc_events   - [IN] events to check                            *
+ *             condition    - [IN/OUT] condition for matching, outputs        *
+ *                                     event ids that match condition         *
+ *             object       - [IN] event object                               *
+ *             object_hosts - [IN] sorted (objectid, hostid) pairs, 0 hostid  *
+ *                                 marks object without hosts                 *
+ *             hostids      - [IN] sorted host set                            *
+ *             match        - [IN] ACTION_HOSTS_MATCH_* mode                  *
+ *                                                                            *
+ ******************************************************************************/
+static void	add_condition_host_matches(const zbx_vector_db_event_t *esc_events, zbx_condition_t *condition,
+		int object, const zbx_vector_uint64_pair_t *object_hosts, const zbx_vector_uint64_t *hostids, int match)
+{
+	for (int i = 0; i < object_hosts->values_num;)
+	{
+		zbx_uint64_t	objectid = object_hosts->values[i].first;
+		int		in = 0, other = 0, matched;
+
+		for (; i < object_hosts->values_num && objectid == object_hosts->values[i].first; i++)
+		{
+			if (0 == object_hosts->values[i].second)
+				continue;
+
+			if (FAIL != zbx_vector_uint64_bsearch(hostids, object_hosts->values[i].second,
+					ZBX_DEFAULT_UINT64_COMPARE_FUNC))
+			{
+				in = 1;
+			}
+			else
+				other = 1;
+		}
+
+		switch (match)
+		{
+			case ACTION_HOSTS_MATCH_ANY:
+				matched = in;
+				break;
+			case ACTION_HOSTS_MATCH_NONE:
+				matched = (0 == in);
+				break;
+			default:
+				matched = other;
+		}
+
+		if (0 != matched)
+			add_condition_match(esc_events, condition, objectid, object);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: matches objects against host set using object hosts from          *
+ *          configuration cache                                               *
+ *                                                                            *
+ * Parameters: esc_events - [IN] events to check                              *
+ *             condition  - [IN/OUT] condition for matching, outputs event    *
+ *                                   ids that match condition                 *
+ *             object     - [IN] event object                                 *
+ *             objectids  - [IN/OUT] sorted object ids, objects found in      *
+ *                                   cache are removed and must be checked    *
+ *                                   by caller with database queries          *
+ *             hostids    - [IN] sorted host set                              *
+ *             match      - [IN] ACTION_HOSTS_MATCH_* mode                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	check_cached_object_hosts(const zbx_vector_db_event_t *esc_events, zbx_condition_t *condition,
+		int object, zbx_vector_uint64_t *objectids, const zbx_vector_uint64_t *hostids, int match)
+{
+	zbx_vector_uint64_pair_t	object_hosts;
+
+	zbx_vector_uint64_pair_create(&object_hosts);
+
+	if (EVENT_OBJECT_TRIGGER == object)
+		zbx_dc_get_trigger_hostids(objectids, &object_hosts);
+	else	/* EVENT_OBJECT_ITEM, EVENT_OBJECT_LLDRULE */
+		zbx_dc_get_item_hostids(objectids, &object_hosts);
+
+	add_condition_host_matches(esc_events, condition, object, &object_hosts, hostids, match);
+
+	zbx_vector_uint64_pair_destroy(&object_hosts);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks host group condition using configuration cache            *
+ *                                                                            *
+ * Parameters: esc_events - [IN] events to check                              *
+ *             condition  - [IN/OUT] condition for matching, outputs event    *
+ *                                   ids that match condition                 *
+ *             object     - [IN] event object                                 *
+ *             objectids  - [IN/OUT] sorted object ids, objects found in      *
+ *                                   cache are removed                        *
+ *             groupids   - [IN] condition host group with nested groups     *
+ *                                                                            *
+ ******************************************************************************/
+static void	check_cached_host_group_condition(const zbx_vector_db_event_t *esc_events,
+		zbx_condition_t *condition, int object, zbx_vector_uint64_t *objectids, const zbx_vector_uint64_t *groupids)
+{
+	zbx_vector_uint64_t	hostids;
+
+	zbx_vector_uint64_create(&hostids);
+	zbx_dc_get_hostids_by_groupids(groupids, &hostids);
+
+	check_cached_object_hosts(esc_events, condition, object, objectids, &hostids,
+			ZBX_CONDITION_OPERATOR_EQUAL == condition->op ? ACTION_HOSTS_MATCH_ANY :
+			ACTION_HOSTS_MATCH_NONE);
+
+	zbx_vector_uint64_destroy(&hostids);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks host condition using configuration cache                   *
+ *                                                                            *
+ * Parameters: esc_events      - [IN] events to check                         *
+ *             condition       - [IN/OUT] condition for matching, outputs     *
+ *                                        event ids that match condition      *
+ *             object          - [IN] event object                            *
+ *             objectids       - [IN/OUT] sorted object ids, objects found in *
+ *                                        cache are removed                   *
+ *             condition_value - [IN] condition hostid                        *
+ *                                                                            *
+ ******************************************************************************/
+static void	check_cached_host_condition(const zbx_vector_db_event_t *esc_events, zbx_condition_t *condition,
+		int object, zbx_vector_uint64_t *objectids, zbx_uint64_t condition_value)
+{
+	zbx_vector_uint64_t	hostids;
+
+	zbx_vector_uint64_create(&hostids);
+	zbx_vector_uint64_append(&hostids, condition_value);
+
+	check_cached_object_hosts(esc_events, condition, object, objectids, &hostids,
+			ZBX_CONDITION_OPERATOR_EQUAL == condition->op ? ACTION_HOSTS_MATCH_ANY :
+			ACTION_HOSTS_MATCH_ANY_OTHER);
+
+	zbx_vector_uint64_destroy(&hostids);
+}
+
 /******************************************************************************
  *                                                                            *
  * Parameters: esc_events - [IN]     events to check                          *
@@ -161,6 +307,12 @@ static int	check_host_group_condition(const zbx_vector_db_event_t *esc_events, z
 	get_object_ids(esc_events, &objectids);
 	zbx_dc_get_nested_hostgroupids(&condition_value, 1, &groupids);
 
+	/* query database only for triggers that are not found in configuration cache */
+	check_cached_host_group_condition(esc_events, condition, EVENT_OBJECT_TRIGGER, &objectids, &groupids);
+
+	if (0 == objectids.values_num)
+		goto out;
+
 	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
 		"select distinct f.triggerid"
 		" from hosts_groups hg,hosts h,items i,functions f"
@@ -205,7 +357,7 @@ static int	check_host_group_condition(const zbx_vector_db_event_t *esc_events, z
 		for (i = 0; i < objectids.values_num; i++)
 			add_condition_match(esc_events, condition, objectids.values[i], EVENT_OBJECT_TRIGGER);
 	}
-
+out:
 	zbx_vector_uint64_destroy(&groupids);
 	zbx_vector_uint64_destroy(&objectids);
 	zbx_free(sql);
@@ -488,6 +640,12 @@ static int	check_host_condition(const zbx_vector_db_event_t *esc_events, zbx_con
 
 	get_object_ids(esc_events, &objectids);
 
+	/* query database only for triggers that are not found in configuration cache */
+	check_cached_host_condition(esc_events, condition, EVENT_OBJECT_TRIGGER, &objectids, condition_value);
+
+	if (0 == objectids.values_num)
+		goto out;
+
 	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
 			"select distinct f.triggerid"
 			" from items i,functions f"
@@ -510,7 +668,7 @@ static int	check_host_condition(const zbx_vector_db_event_t *esc_events, zbx_con
 		add_condition_match(esc_events, condition, objectid, EVENT_OBJECT_TRIGGER);
 	}
 	zbx_db_free_result(result);
-
+out:
 	zbx_vector_uint64_destroy(&objectids);
 	zbx_free(sql);
 
@@ -2125,6 +2283,12 @@ static int	check_intern_host_group_condition(const zbx_vector_db_event_t *esc_ev
 	{
 		size_t	sql_offset = 0;
 
+		if (0 == objectids[i].values_num)
+			continue;
+
+		/* query database only for objects that are not found in configuration cache */
+		check_cached_host_group_condition(esc_events, condition, objects[i], &objectids[i], &groupids);
+
 		if (0 == objectids[i].values_num)
 			continue;
 
@@ -2224,6 +2388,40 @@ static void	item_parents_sql_alloc(char **sql, size_t *sql_alloc, zbx_vector_uin
 			objectids_tmp->values, objectids_tmp->values_num);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks host template condition for items using configuration     *
+ *          cache                                                             *
+ *                                                                            *
+ * Parameters: esc_events      - [IN] events to check                         *
+ *             condition       - [IN/OUT] condition for matching, outputs     *
+ *                                        event ids that match condition      *
+ *             object          - [IN] event object                            *
+ *             objectids       - [IN/OUT] sorted item ids, items found in     *
+ *                                        cache are removed                   *
+ *             condition_value - [IN] condition template id                   *
+ *                                                                            *
+ ******************************************************************************/
+static void	check_cached_item_template_condition(const zbx_vector_db_event_t *esc_events,
+		zbx_condition_t *condition, int object, zbx_vector_uint64_t *objectids, zbx_uint64_t condition_value)
+{
+	zbx_vector_uint64_pair_t	item_templates;
+	zbx_vector_uint64_t		hostids;
+
+	zbx_vector_uint64_pair_create(&item_templates);
+	zbx_vector_uint64_create(&hostids);
+	zbx_vector_uint64_append(&hostids, condition_value);
+
+	zbx_dc_get_item_template_hostids(objectids, &item_templates);
+
+	add_condition_host_matches(esc_events, condition, object, &item_templates, &hostids,
+			ZBX_CONDITION_OPERATOR_EQUAL == condition->op ? ACTION_HOSTS_MATCH_ANY :
+			ACTION_HOSTS_MATCH_NONE);
+
+	zbx_vector_uint64_destroy(&hostids);
+	zbx_vector_uint64_pair_destroy(&item_templates);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: checks host template condition for internal events                *
@@ -2269,6 +2467,16 @@ static int	check_intern_host_template_condition(const zbx_vector_db_event_t *esc
 		if (0 == objectids_ptr->values_num)
 			continue;
 
+		/* item template hierarchy is cached, query database only for items not found in cache */
+		if (EVENT_OBJECT_TRIGGER != objects[i])
+		{
+			check_cached_item_template_condition(esc_events, condition, objects[i], objectids_ptr,
+					condition_value);
+
+			if (0 == objectids_ptr->values_num)
+				continue;
+		}
+
 		objectids_to_pair(objectids_ptr, objectids_pair_ptr);
 
 		if (EVENT_OBJECT_TRIGGER == objects[i])
@@ -2365,6 +2573,12 @@ static int	check_intern_host_condition(const zbx_vector_db_event_t *esc_events,
 	{
 		size_t	sql_offset = 0;
 
+		if (0 == objectids[i].values_num)
+			continue;
+
+		/* query database only for objects that are not found in configuration cache */
+		check_cached_host_condition(esc_events, condition, objects[i], &objectids[i], condition_value);
+
 		if (0 == objectids[i].values_num)
 			continue;
 
@@ -3367,10 +3581,13 @@ static void	free_ack_escalation(zbx_ack_escalation_t *ack_escalation)
  *                                                                            *
  * Purpose: processes actions for each acknowledgment in array                *
  *                                                                            *
- * Parameters: ack_tasks - [IN]                                               *
+ * Parameters: ack_tasks   - [IN]                                             *
+ *             escalations - [OUT] created escalations to be passed to        *
+ *                                 escalators, optional                       *
  *                                                                            *
  ******************************************************************************/
-int	process_actions_by_acknowledgments(const zbx_vector_ack_task_ptr_t *ack_tasks)
+int	process_actions_by_acknowledgments(const zbx_vector_ack_task_ptr_t *ack_tasks,
+		zbx_vector_escalation_new_ptr_t *escalations)
 {
 	zbx_vector_action_eval_ptr_t	actions;
 	zbx_hashset_t			uniq_conditions[EVENT_SOURCE_COUNT];
@@ -3485,6 +3702,7 @@ int	process_actions_by_acknowledgments(const zbx_vector_ack_task_ptr_t *ack_task
 	if (0 != ack_escalations.values_num)
 	{
 		zbx_db_insert_t	db_insert;
+		zbx_uint64_t	escalationid = zbx_db_get_maxid_num("escalations", ack_escalations.values_num);
 
 		zbx_db_insert_prepare(&db_insert, "escalations", "escalationid", "actionid", "status", "triggerid",
 						"itemid", "eventid", "r_eventid", "acknowledgeid", (char *)NULL);
@@ -3495,12 +3713,31 @@ int	process_actions_by_acknowledgments(const zbx_vector_ack_task_ptr_t *ack_task
 		{
 			ack_escalation = ack_escalations.values[i];
 
-			zbx_db_insert_add_values(&db_insert, __UINT64_C(0), ack_escalation->actionid,
+			zbx_db_insert_add_values(&db_insert, escalationid, ack_escalation->actionid,
 				(int)ESCALATION_STATUS_ACTIVE, ack_escalation->triggerid, __UINT64_C(0),
 				ack_escalation->eventid, __UINT64_C(0), ack_escalation->acknowledgeid);
+
+			if (NULL != escalations)
+			{
+				zbx_escalation_new_t	*new_escalation;
+				zbx_db_event		*esc_event;
+
+				esc_event = (zbx_db_event *)zbx_malloc(NULL, sizeof(zbx_db_event));
+				memset(esc_event, 0, sizeof(zbx_db_event));
+				esc_event->eventid = ack_escalation->eventid;
+				esc_event->object = EVENT_OBJECT_TRIGGER;
+				esc_event->objectid = ack_escalation->triggerid;
+
+				new_escalation = (zbx_escalation_new_t *)zbx_malloc(NULL, sizeof(zbx_escalation_new_t));
+				new_escalation->actionid = 0;
+				new_escalation->escalationid = escalationid;
+				new_escalation->event = esc_event;
+				zbx_vector_escalation_new_ptr_append(escalations, new_escalation);
+			}
+
+			escalationid++;
 		}
 
-		zbx_db_insert_autoincrement(&db_insert, "escalationid");
 		zbx_db_insert_execute(&db_insert);
 		zbx_db_insert_clean(&db_insert);
 
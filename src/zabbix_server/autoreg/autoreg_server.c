@@ -173,8 +173,22 @@ static int	compare_autoreg_host_by_hostid(const void *d1, const void *d2)
 	return 0;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: writes autoregistration hosts and processes their events          *
+ *                                                                            *
+ * Parameters: autoreg_hosts - [IN]                                           *
+ *             proxy         - [IN]                                           *
+ *             events_cbs    - [IN]                                           *
+ *             escalations   - [OUT] escalations created by the events        *
+ *                                                                            *
+ * Comments: Must be called inside transaction. The processed events are      *
+ *           referenced by escalations, so caller must start escalations      *
+ *           after commit and clean events afterwards.                        *
+ *                                                                            *
+ ******************************************************************************/
 void	zbx_autoreg_flush_hosts_server(zbx_vector_autoreg_host_ptr_t *autoreg_hosts, const zbx_dc_proxy_t *proxy,
-		const zbx_events_funcs_t *events_cbs)
+		const zbx_events_funcs_t *events_cbs, zbx_vector_escalation_new_ptr_t *escalations)
 {
 	zbx_autoreg_host_t	*autoreg_host;
 	zbx_uint64_t		autoreg_hostid = 0;
@@ -289,10 +303,7 @@ void	zbx_autoreg_flush_hosts_server(zbx_vector_autoreg_host_ptr_t *autoreg_hosts
 	}
 
 	if (NULL != events_cbs->process_events_cb)
-		events_cbs->process_events_cb(NULL, NULL, NULL);
-
-	if (NULL != events_cbs->clean_events_cb)
-		events_cbs->clean_events_cb();
+		events_cbs->process_events_cb(NULL, NULL, escalations);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
@@ -335,14 +346,25 @@ void	zbx_autoreg_update_host_server(const zbx_dc_proxy_t *proxy, const char *hos
 		int clock, const zbx_events_funcs_t *events_cbs)
 {
 	zbx_vector_autoreg_host_ptr_t	autoreg_hosts;
+	zbx_vector_escalation_new_ptr_t	escalations;
+	int				txn_error;
 
 	zbx_vector_autoreg_host_ptr_create(&autoreg_hosts);
+	zbx_vector_escalation_new_ptr_create(&escalations);
 
 	zbx_autoreg_prepare_host_server(&autoreg_hosts, host, ip, dns, port, connection_type, host_metadata, flags,
 			clock);
 	zbx_db_begin();
-	zbx_autoreg_flush_hosts_server(&autoreg_hosts, proxy, events_cbs);
-	zbx_db_commit();
+	zbx_autoreg_flush_hosts_server(&autoreg_hosts, proxy, events_cbs, &escalations);
+	txn_error = zbx_db_commit();
+
+	if (NULL != events_cbs->start_escalations_cb)
+		events_cbs->start_escalations_cb(&escalations, ZBX_DB_OK == txn_error);
+
+	if (NULL != events_cbs->clean_events_cb)
+		events_cbs->clean_events_cb();
+
+	zbx_vector_escalation_new_ptr_destroy(&escalations);
 
 	zbx_vector_autoreg_host_ptr_clear_ext(&autoreg_hosts, zbx_autoreg_host_free_server);
 	zbx_vector_autoreg_host_ptr_destroy(&autoreg_hosts);
@@ -27,7 +27,7 @@ void	zbx_autoreg_update_host_server(const zbx_dc_proxy_t *proxy, const char *hos
 		int clock, const zbx_events_funcs_t *events_cbs);
 
 void	zbx_autoreg_flush_hosts_server(zbx_vector_autoreg_host_ptr_t *autoreg_hosts, const zbx_dc_proxy_t *proxy,
-		const zbx_events_funcs_t *events_cbs);
+		const zbx_events_funcs_t *events_cbs, zbx_vector_escalation_new_ptr_t *escalations);
 
 void	zbx_autoreg_prepare_host_server(zbx_vector_autoreg_host_ptr_t *autoreg_hosts, const char *host, const char *ip,
 		const char *dns, unsigned short port, unsigned int connection_type, const char *host_metadata,
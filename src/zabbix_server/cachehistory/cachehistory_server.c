@@ -1402,9 +1402,12 @@ void	zbx_sync_server_history(int *values_num, int *triggers_num, const zbx_event
 
 				do
 				{
+					zbx_vector_escalation_new_ptr_t	escalations;
+
 					if (0 == item_diff.values_num && 0 == inventory_values.values_num)
 						break;
 
+					zbx_vector_escalation_new_ptr_create(&escalations);
 					zbx_db_begin();
 
 					zbx_db_mass_update_items(&item_diff, &inventory_values);
@@ -1412,14 +1415,22 @@ void	zbx_sync_server_history(int *values_num, int *triggers_num, const zbx_event
 					if (NULL != events_cbs->process_events_cb)
 					{
 						/* process internal events generated by DCmass_prepare_history() */
-						events_cbs->process_events_cb(NULL, NULL, NULL);
+						events_cbs->process_events_cb(NULL, NULL, &escalations);
 					}
 
-					if (ZBX_DB_OK != (txn_error = zbx_db_commit()))
+					if (ZBX_DB_OK == (txn_error = zbx_db_commit()))
+					{
+						if (NULL != rtc)
+							zbx_start_escalations(rtc, &escalations);
+					}
+					else if (NULL != events_cbs->reset_event_recovery_cb)
 					{
-						if (NULL != events_cbs->reset_event_recovery_cb)
-							events_cbs->reset_event_recovery_cb();
+						events_cbs->reset_event_recovery_cb();
 					}
+
+					zbx_vector_escalation_new_ptr_clear_ext(&escalations,
+							zbx_escalation_new_ptr_free);
+					zbx_vector_escalation_new_ptr_destroy(&escalations);
 				}
 				while (ZBX_DB_DOWN == txn_error);
 			}
@@ -230,19 +230,66 @@ static void	populate_function_items(const zbx_vector_uint64_t *functionids, zbx_
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() ifuncs_num:%d", __func__, ifuncs->num_data);
 }
 
+/* function evaluation deferred until history of items missing in value cache is read */
+typedef struct
+{
+	zbx_func_t			*func;
+	const zbx_history_sync_item_t	*item;
+	char				*params;
+}
+zbx_func_deferred_t;
+
+ZBX_VECTOR_DECL(func_deferred, zbx_func_deferred_t)
+ZBX_VECTOR_IMPL(func_deferred, zbx_func_deferred_t)
+
+static void	evaluate_item_function(zbx_func_t *func, const zbx_history_sync_item_t *item, const char *params)
+{
+	char			*error = NULL;
+	zbx_dc_evaluate_item_t	evaluate_item;
+
+	evaluate_item.itemid = item->itemid;
+	evaluate_item.value_type = item->value_type;
+	evaluate_item.proxyid = item->host.proxyid;
+	evaluate_item.host = item->host.host;
+	evaluate_item.key_orig = item->key_orig;
+
+	if (SUCCEED != zbx_evaluate_function(&func->value, &evaluate_item, func->function, params, &func->timespec,
+			&error))
+	{
+		/* compose and store error message for future use */
+		zbx_variant_clear(&func->value);
+		zbx_variant_set_error(&func->value,
+				zbx_eval_format_function_error(func->function, item->host.host,
+						item->key_orig, params, error));
+		zbx_free(error);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluate trigger functions                                        *
+ *                                                                            *
+ * Comments: Functions are evaluated while value cache batch is started, so   *
+ *           the requests of items not in value cache are deferred. After all *
+ *           functions are evaluated, the history of deferred items is read   *
+ *           with multi-item queries and the functions which made deferred    *
+ *           requests are evaluated again.                                    *
+ *                                                                            *
+ ******************************************************************************/
 static void	evaluate_item_functions(zbx_hashset_t *funcs, const zbx_vector_uint64_t *history_itemids,
 		const zbx_history_sync_item_t *history_items, const int *history_errcodes,
 		zbx_history_sync_item_t **items, int **items_err, int *items_num)
 {
-	char			*error = NULL;
-	int			i;
-	zbx_func_t		*func;
-	zbx_vector_uint64_t	itemids;
-	zbx_hashset_iter_t	iter;
+	int				i;
+	zbx_func_t			*func;
+	zbx_vector_uint64_t		itemids;
+	zbx_hashset_iter_t		iter;
+	zbx_vector_func_deferred_t	deferred;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() funcs_num:%d", __func__, funcs->num_data);
 
 	zbx_vector_uint64_create(&itemids);
+	zbx_vector_func_deferred_create(&deferred);
 
 	zbx_hashset_iter_reset(funcs, &iter);
 	while (NULL != (func = (zbx_func_t *)zbx_hashset_iter_next(&iter)))
@@ -265,13 +312,14 @@ static void	evaluate_item_functions(zbx_hashset_t *funcs, const zbx_vector_uint6
 				(size_t)itemids.values_num, ZBX_ITEM_GET_SYNC);
 	}
 
+	zbx_vc_batch_begin();
+
 	zbx_hashset_iter_reset(funcs, &iter);
 	while (NULL != (func = (zbx_func_t *)zbx_hashset_iter_next(&iter)))
 	{
-		int				errcode, ret;
+		int				errcode, deferred_num;
 		const zbx_history_sync_item_t	*item;
 		char				*params;
-		zbx_dc_evaluate_item_t		evaluate_item;
 
 		/* avoid double copying from configuration cache if already retrieved when saving history */
 		if (FAIL != (i = zbx_vector_uint64_bsearch(history_itemids, func->itemid,
@@ -361,27 +409,32 @@ static void	evaluate_item_functions(zbx_hashset_t *funcs, const zbx_vector_uint6
 
 		params = zbx_dc_expand_user_macros_in_func_params(func->parameter, item->host.hostid);
 
-		evaluate_item.itemid = item->itemid;
-		evaluate_item.value_type = item->value_type;
-		evaluate_item.proxyid = item->host.proxyid;
-		evaluate_item.host = item->host.host;
-		evaluate_item.key_orig = item->key_orig;
+		deferred_num = zbx_vc_batch_deferred_num();
 
-		ret = zbx_evaluate_function(&func->value, &evaluate_item, func->function, params, &func->timespec, &error);
+		evaluate_item_function(func, item, params);
 
-		if (SUCCEED != ret)
+		if (deferred_num != zbx_vc_batch_deferred_num())
 		{
-			/* compose and store error message for future use */
-			zbx_variant_set_error(&func->value,
-					zbx_eval_format_function_error(func->function, item->host.host,
-							item->key_orig, params, error));
-			zbx_free(error);
+			zbx_func_deferred_t	func_deferred = {.func = func, .item = item, .params = params};
+
+			zbx_variant_clear(&func->value);
+			zbx_vector_func_deferred_append(&deferred, func_deferred);
+			continue;
 		}
 
 		zbx_free(params);
 	}
 
+	zbx_vc_batch_end();
+
+	for (i = 0; i < deferred.values_num; i++)
+	{
+		evaluate_item_function(deferred.values[i].func, deferred.values[i].item, deferred.values[i].params);
+		zbx_free(deferred.values[i].params);
+	}
+
 	zbx_vc_flush_stats();
+	zbx_vector_func_deferred_destroy(&deferred);
 	zbx_vector_uint64_destroy(&itemids);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
@@ -21,6 +21,7 @@
 #include "zbxalerter.h"
 #include "zbxtime.h"
 #include "zbxpreproc.h"
+#include "zbxpoller.h"
 #include "zbxalgo.h"
 #include "zbxshmem.h"
 #include "zbxjson.h"
@@ -221,17 +222,25 @@ out:
  * Purpose: add lld item top list to output json                              *
  *                                                                            *
  ******************************************************************************/
-static void	diag_add_lld_items(struct zbx_json *json, const char *field, const zbx_vector_uint64_pair_t *items)
+static void	diag_add_lld_items(struct zbx_json *json, const char *field,
+		const zbx_vector_lld_rule_info_ptr_t *rule_infos)
 {
-	int	i;
+	const char	*phases[ZBX_LLD_PHASE_COUNT] = {"time.rows", "time.items", "time.triggers", "time.graphs",
+				"time.hosts"};
 
 	zbx_json_addarray(json, field);
 
-	for (i = 0; i < items->values_num; i++)
+	for (int i = 0; i < rule_infos->values_num; i++)
 	{
+		const zbx_lld_rule_info_t	*rule_info = rule_infos->values[i];
+
 		zbx_json_addobject(json, NULL);
-		zbx_json_adduint64(json, "itemid", items->values[i].first);
-		zbx_json_adduint64(json, "values", items->values[i].second);
+		zbx_json_adduint64(json, "itemid", rule_info->itemid);
+		zbx_json_adduint64(json, "values", (zbx_uint64_t)rule_info->values_num);
+
+		for (int j = 0; j < ZBX_LLD_PHASE_COUNT; j++)
+			zbx_json_addfloat(json, phases[j], rule_info->timings.phases[j]);
+
 		zbx_json_close(json);
 	}
 
@@ -293,23 +302,29 @@ static int	diag_add_lld_info(const struct zbx_json_parse *jp, struct zbx_json *j
 			{
 				zbx_diag_map_t	*map = tops.values[i];
 
-				if (0 == strcmp(map->name, "values"))
+				if (0 == strcmp(map->name, "values") || 0 == strcmp(map->name, "time"))
 				{
-					zbx_vector_uint64_pair_t	items;
+					zbx_vector_lld_rule_info_ptr_t	rule_infos;
+					int				field;
 
-					zbx_vector_uint64_pair_create(&items);
+					field = (0 == strcmp(map->name, "time") ? ZBX_LLD_TOP_TIME : ZBX_LLD_TOP_VALUES);
+
+					zbx_vector_lld_rule_info_ptr_create(&rule_infos);
 
 					time1 = zbx_time();
-					if (FAIL == (ret = zbx_lld_get_top_items(map->value, &items, error)))
-					{
-						zbx_vector_uint64_pair_destroy(&items);
-						goto out;
-					}
+					ret = zbx_lld_get_top_items(field, map->value, &rule_infos, error);
 					time2 = zbx_time();
 					time_total += time2 - time1;
 
-					diag_add_lld_items(json, map->name, &items);
-					zbx_vector_uint64_pair_destroy(&items);
+					if (SUCCEED == ret)
+						diag_add_lld_items(json, map->name, &rule_infos);
+
+					zbx_vector_lld_rule_info_ptr_clear_ext(&rule_infos,
+							(zbx_lld_rule_info_ptr_free_func_t)zbx_ptr_free);
+					zbx_vector_lld_rule_info_ptr_destroy(&rule_infos);
+
+					if (SUCCEED != ret)
+						goto out;
 				}
 				else
 				{
@@ -541,6 +556,16 @@ int	diag_add_section_info(const char *section, const struct zbx_json_parse *jp,
 		zbx_diag_add_locks_info(json);
 		ret = SUCCEED;
 	}
+	else if (0 == strcmp(section, ZBX_DIAG_PROFILER))
+	{
+		zbx_diag_add_profiler_info(json);
+		ret = SUCCEED;
+	}
+	else if (0 == strcmp(section, ZBX_DIAG_POLLER))
+	{
+		zbx_async_agent_add_diag_info(json, ZBX_DIAG_POLLER);
+		ret = SUCCEED;
+	}
 	else if (0 == strcmp(section, ZBX_DIAG_CONNECTOR))
 		ret = zbx_diag_add_connector_info(jp, json, error);
 	else
@@ -47,7 +47,8 @@
 #include "zbx_rtc_constants.h"
 #include "zbxserialize.h"
 
-#define CONFIG_ESCALATOR_FREQUENCY	3
+#define CONFIG_ESCALATOR_FREQUENCY		3
+#define CONFIG_ESCALATOR_RESCAN_FREQUENCY	SEC_PER_MIN
 
 #define ZBX_ESCALATION_SOURCE_DEFAULT	0
 #define ZBX_ESCALATION_SOURCE_ITEM	1
@@ -100,6 +101,25 @@ typedef struct
 }
 zbx_service_role_t;
 
+/* escalation scheduled for processing at nextcheck */
+typedef struct
+{
+	zbx_uint64_t	escalationid;
+	int		nextcheck;
+}
+zbx_escalation_timer_t;
+
+/* In-memory schedule of the escalations handled by escalator process. It is fed by the escalations */
+/* created in other processes (ZBX_RTC_ESCALATOR_NOTIFY) and by the escalation processing results,   */
+/* while escalations table is scanned only at start and every CONFIG_ESCALATOR_RESCAN_FREQUENCY      */
+/* seconds to recover the escalations that were not passed to the escalator.                        */
+typedef struct
+{
+	zbx_hashset_t		timers;
+	zbx_binary_heap_t	queue;
+}
+zbx_escalation_schedule_t;
+
 ZBX_VECTOR_DECL(service_alarm, zbx_service_alarm_t)
 ZBX_VECTOR_IMPL(service_alarm, zbx_service_alarm_t)
 
@@ -3097,11 +3117,168 @@ static void	service_role_clean(zbx_service_role_t *role)
 	zbx_vector_uint64_destroy(&role->serviceids);
 }
 
+static int	escalation_timer_compare(const void *d1, const void *d2)
+{
+	const zbx_binary_heap_elem_t	*e1 = (const zbx_binary_heap_elem_t *)d1;
+	const zbx_binary_heap_elem_t	*e2 = (const zbx_binary_heap_elem_t *)d2;
+	const zbx_escalation_timer_t	*timer1 = (const zbx_escalation_timer_t *)e1->data;
+	const zbx_escalation_timer_t	*timer2 = (const zbx_escalation_timer_t *)e2->data;
+
+	ZBX_RETURN_IF_NOT_EQUAL(timer1->nextcheck, timer2->nextcheck);
+	ZBX_RETURN_IF_NOT_EQUAL(timer1->escalationid, timer2->escalationid);
+
+	return 0;
+}
+
+static void	escalation_schedule_init(zbx_escalation_schedule_t *schedule)
+{
+	zbx_hashset_create(&schedule->timers, 100, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_binary_heap_create(&schedule->queue, escalation_timer_compare, ZBX_BINARY_HEAP_OPTION_DIRECT);
+}
+
+static void	escalation_schedule_destroy(zbx_escalation_schedule_t *schedule)
+{
+	zbx_binary_heap_destroy(&schedule->queue);
+	zbx_hashset_destroy(&schedule->timers);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: schedules escalation or updates its schedule                      *
+ *                                                                            *
+ * Parameters: schedule     - [IN/OUT]                                        *
+ *             escalationid - [IN]                                            *
+ *             nextcheck    - [IN] time when escalation must be processed     *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalation_schedule_set(zbx_escalation_schedule_t *schedule, zbx_uint64_t escalationid,
+		int nextcheck)
+{
+	zbx_escalation_timer_t	*timer;
+	zbx_binary_heap_elem_t	elem;
+
+	if (NULL == (timer = (zbx_escalation_timer_t *)zbx_hashset_search(&schedule->timers, &escalationid)))
+	{
+		zbx_escalation_timer_t	timer_local = {.escalationid = escalationid, .nextcheck = nextcheck};
+
+		timer = (zbx_escalation_timer_t *)zbx_hashset_insert(&schedule->timers, &timer_local,
+				sizeof(timer_local));
+
+		elem.key = escalationid;
+		elem.data = (void *)timer;
+		zbx_binary_heap_insert(&schedule->queue, &elem);
+	}
+	else if (timer->nextcheck != nextcheck)
+	{
+		timer->nextcheck = nextcheck;
+
+		elem.key = escalationid;
+		elem.data = (void *)timer;
+		zbx_binary_heap_update_direct(&schedule->queue, &elem);
+	}
+}
+
+static void	escalation_schedule_remove(zbx_escalation_schedule_t *schedule, zbx_uint64_t escalationid)
+{
+	zbx_escalation_timer_t	*timer;
+
+	if (NULL == (timer = (zbx_escalation_timer_t *)zbx_hashset_search(&schedule->timers, &escalationid)))
+		return;
+
+	zbx_binary_heap_remove_direct(&schedule->queue, escalationid);
+	zbx_hashset_remove_direct(&schedule->timers, timer);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: removes due escalations from schedule                             *
+ *                                                                            *
+ * Parameters: schedule      - [IN/OUT]                                       *
+ *             now           - [IN] current time                              *
+ *             escalationids - [OUT] identifiers of due escalations           *
+ *             max_num       - [IN] maximum number of escalationids           *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalation_schedule_pop_due(zbx_escalation_schedule_t *schedule, int now,
+		zbx_vector_uint64_t *escalationids, int max_num)
+{
+	while (FAIL == zbx_binary_heap_empty(&schedule->queue) && escalationids->values_num < max_num)
+	{
+		zbx_binary_heap_elem_t	*elem = zbx_binary_heap_find_min(&schedule->queue);
+		zbx_escalation_timer_t	*timer = (zbx_escalation_timer_t *)elem->data;
+
+		if (timer->nextcheck > now)
+			break;
+
+		zbx_vector_uint64_append(escalationids, timer->escalationid);
+
+		zbx_binary_heap_remove_min(&schedule->queue);
+		zbx_hashset_remove_direct(&schedule->timers, timer);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets time of the earliest scheduled escalation                    *
+ *                                                                            *
+ * Parameters: schedule  - [IN]                                               *
+ *             nextcheck - [IN/OUT] time of next invocation                   *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalation_schedule_get_nextcheck(const zbx_escalation_schedule_t *schedule, int *nextcheck)
+{
+	const zbx_escalation_timer_t	*timer;
+
+	if (SUCCEED == zbx_binary_heap_empty(&schedule->queue))
+		return;
+
+	timer = (const zbx_escalation_timer_t *)zbx_binary_heap_find_min(&schedule->queue)->data;
+
+	if (timer->nextcheck < *nextcheck)
+		*nextcheck = timer->nextcheck;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reschedules processed escalations                                 *
+ *                                                                            *
+ * Parameters: schedule      - [IN/OUT]                                       *
+ *             now           - [IN] current time                              *
+ *             escalations   - [IN] processed escalations                     *
+ *             escalationids - [IN] identifiers of deleted escalations        *
+ *                                                                            *
+ * Comments: Escalations that are left due (skipped or recovered ones) are    *
+ *           rescheduled after CONFIG_ESCALATOR_FREQUENCY seconds - the same  *
+ *           as they would be picked up again by escalations table polling.   *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalation_schedule_update(zbx_escalation_schedule_t *schedule, int now,
+		const zbx_vector_db_escalation_ptr_t *escalations, const zbx_vector_uint64_t *escalationids)
+{
+	for (int i = 0; i < escalations->values_num; i++)
+	{
+		const zbx_db_escalation	*escalation = escalations->values[i];
+		int			nextcheck;
+
+		/* nextcheck of recovered escalations is reset in database, see process_db_escalations() */
+		nextcheck = (0 == escalation->r_eventid ? escalation->nextcheck : 0);
+
+		if (nextcheck <= now)
+			nextcheck = now + CONFIG_ESCALATOR_FREQUENCY;
+
+		escalation_schedule_set(schedule, escalation->escalationid, nextcheck);
+	}
+
+	for (int i = 0; i < escalationids->values_num; i++)
+		escalation_schedule_remove(schedule, escalationids->values[i]);
+}
+
 static int	process_db_escalations(int now, int *nextcheck, zbx_vector_db_escalation_ptr_t *escalations,
 		zbx_vector_uint64_t *eventids, zbx_vector_uint64_t *problem_eventids, zbx_vector_uint64_t *actionids,
 		const char *default_timezone, int config_timeout, int config_trapper_timeout,
 		const char *config_source_ip, const char *config_ssh_key_location,
-		zbx_get_config_forks_f get_config_forks, int config_enable_global_scripts, unsigned char program_type)
+		zbx_get_config_forks_f get_config_forks, int config_enable_global_scripts, unsigned char program_type,
+		zbx_escalation_schedule_t *schedule)
 {
 	int					ret;
 	zbx_vector_uint64_t			escalationids, symptom_eventids;
@@ -3442,6 +3619,9 @@ static int	process_db_escalations(int now, int *nextcheck, zbx_vector_db_escalat
 out:
 	zbx_dc_close_user_macros(um_handle);
 
+	if (NULL != schedule)
+		escalation_schedule_update(schedule, now, escalations, &escalationids);
+
 	zbx_vector_escalation_diff_ptr_clear_ext(&diffs, (void (*)(zbx_escalation_diff_t *))zbx_ptr_free);
 	zbx_vector_escalation_diff_ptr_destroy(&diffs);
 
@@ -3491,7 +3671,10 @@ out:
  *             config_ssh_key_location - [IN]                                   *
  *             get_config_forks        - [IN]                                   *
  *             program_type            - [IN]                                   *
- *             escalationids           - [IN]                                   *
+ *             escalationids           - [IN] escalations to be processed,      *
+ *                                                optional                      *
+ *             schedule                - [IN/OUT] in-memory schedule of         *
+ *                                                escalations, optional         *
  *                                                                              *
  * Return value: count of deleted escalations                                   *
  *                                                                              *
@@ -3506,9 +3689,9 @@ static int	process_escalations(int now, int *nextcheck, unsigned int escalation_
 		const char *default_timezone, int process_num, int config_timeout, int config_trapper_timeout,
 		const char *config_source_ip, const char *config_ssh_key_location,
 		zbx_get_config_forks_f get_config_forks, int config_enable_global_scripts, unsigned char program_type,
-		zbx_vector_uint64_t *escalationids)
+		zbx_vector_uint64_t *escalationids, zbx_escalation_schedule_t *schedule)
 {
-	int				ret = 0;
+	int				ret = 0, horizon;
 	zbx_db_result_t			result;
 	zbx_db_row_t			row;
 	char				*filter = NULL;
@@ -3595,12 +3778,15 @@ static int	process_escalations(int now, int *nextcheck, unsigned int escalation_
 		}
 	}
 
+	/* when scheduling escalations in memory select also the ones due until the next escalations table scan */
+	horizon = now + (NULL != schedule ? CONFIG_ESCALATOR_RESCAN_FREQUENCY : CONFIG_ESCALATOR_FREQUENCY);
+
 	result = zbx_db_select("select escalationid,actionid,triggerid,eventid,r_eventid,nextcheck,esc_step,status,"
 					"itemid,acknowledgeid,servicealarmid,serviceid"
 				" from escalations"
 				" where %s and nextcheck<=%d"
 				" order by actionid,triggerid,itemid," ZBX_SQL_SORT_ASC("r_eventid") ",escalationid",
-				filter, now + CONFIG_ESCALATOR_FREQUENCY);
+				filter, horizon);
 	zbx_free(filter);
 
 	while (NULL != (row = zbx_db_fetch(result)) && ZBX_IS_RUNNING())
@@ -3611,9 +3797,17 @@ static int	process_escalations(int now, int *nextcheck, unsigned int escalation_
 
 		esc_nextcheck = atoi(row[5]);
 
-		/* skip escalations that must be checked in next CONFIG_ESCALATOR_FREQUENCY period */
+		/* skip escalations that must be checked later */
 		if (esc_nextcheck > now)
 		{
+			if (NULL != schedule)
+			{
+				zbx_uint64_t	escalationid;
+
+				ZBX_STR2UINT64(escalationid, row[0]);
+				escalation_schedule_set(schedule, escalationid, esc_nextcheck);
+			}
+
 			if (esc_nextcheck < *nextcheck)
 				*nextcheck = esc_nextcheck;
 
@@ -3646,7 +3840,8 @@ static int	process_escalations(int now, int *nextcheck, unsigned int escalation_
 		{
 			ret += process_db_escalations(now, nextcheck, &escalations, &eventids, &problem_eventids,
 					&actionids, default_timezone, config_timeout, config_trapper_timeout,
-					config_source_ip, config_ssh_key_location, get_config_forks, config_enable_global_scripts, program_type);
+					config_source_ip, config_ssh_key_location, get_config_forks,
+					config_enable_global_scripts, program_type, schedule);
 			zbx_vector_db_escalation_ptr_clear_ext(&escalations,
 					(void (*)(zbx_db_escalation *))zbx_ptr_free);
 			zbx_vector_uint64_clear(&actionids);
@@ -3662,7 +3857,8 @@ static int	process_escalations(int now, int *nextcheck, unsigned int escalation_
 	{
 		ret += process_db_escalations(now, nextcheck, &escalations, &eventids, &problem_eventids,
 				&actionids, default_timezone, config_timeout, config_trapper_timeout,
-				config_source_ip, config_ssh_key_location, get_config_forks, config_enable_global_scripts, program_type);
+				config_source_ip, config_ssh_key_location, get_config_forks,
+				config_enable_global_scripts, program_type, schedule);
 		zbx_vector_db_escalation_ptr_clear_ext(&escalations, (void (*)(zbx_db_escalation *))zbx_ptr_free);
 	}
 
@@ -3693,7 +3889,7 @@ static	void deserialize_escalationids(zbx_vector_uint64_t *escalationids, const
 
 /******************************************************************************
  *                                                                            *
- * Purpose: periodically checks table escalations and generates alerts        *
+ * Purpose: processes scheduled escalations and generates alerts             *
  *                                                                            *
  * Comments: never returns                                                    *
  *                                                                            *
@@ -3717,6 +3913,10 @@ ZBX_THREAD_ENTRY(escalator_thread, args)
 	zbx_ipc_socket_t		alerter;
 	char				*error = NULL;
 	zbx_vector_uint64_t		escalationids;
+	zbx_escalation_schedule_t	schedule;
+	int				rescan_time = 0;
+	const unsigned int		scheduled_sources[] = {ZBX_ESCALATION_SOURCE_TRIGGER,
+							ZBX_ESCALATION_SOURCE_ITEM, ZBX_ESCALATION_SOURCE_DEFAULT};
 
 	zabbix_log(LOG_LEVEL_INFORMATION, "%s #%d started [%s #%d]", get_program_type_string(info->program_type),
 			server_num, get_process_type_string(process_type), process_num);
@@ -3743,6 +3943,7 @@ ZBX_THREAD_ENTRY(escalator_thread, args)
 			&rtc);
 
 	zbx_vector_uint64_create(&escalationids);
+	escalation_schedule_init(&schedule);
 
 	while (ZBX_IS_RUNNING())
 	{
@@ -3766,30 +3967,64 @@ ZBX_THREAD_ENTRY(escalator_thread, args)
 
 		zbx_config_get(&cfg, ZBX_CONFIG_FLAGS_DEFAULT_TIMEZONE);
 
-		nextcheck = time(NULL) + CONFIG_ESCALATOR_FREQUENCY;
-		escalations_count += process_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_TRIGGER,
-				cfg.default_timezone, process_num, escalator_args_in->config_timeout,
-				escalator_args_in->config_trapper_timeout, escalator_args_in->config_source_ip,
-				escalator_args_in->config_ssh_key_location, escalator_args_in->get_process_forks_cb_arg,
-				escalator_args_in->config_enable_global_scripts, info->program_type, &escalationids);
-		escalations_count += process_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_ITEM,
-				cfg.default_timezone, process_num, escalator_args_in->config_timeout,
-				escalator_args_in->config_trapper_timeout, escalator_args_in->config_source_ip,
-				escalator_args_in->config_ssh_key_location, escalator_args_in->get_process_forks_cb_arg,
-				escalator_args_in->config_enable_global_scripts, info->program_type, NULL);
+		now = (int)time(NULL);
+		nextcheck = now + CONFIG_ESCALATOR_FREQUENCY;
+
+		if (rescan_time <= now)
+		{
+			/* scan escalations table to (re)build the schedule, the notified escalations are included */
+			zbx_vector_uint64_clear(&escalationids);
+
+			for (size_t i = 0; i < ARRSIZE(scheduled_sources); i++)
+			{
+				escalations_count += process_escalations(time(NULL), &nextcheck, scheduled_sources[i],
+						cfg.default_timezone, process_num, escalator_args_in->config_timeout,
+						escalator_args_in->config_trapper_timeout,
+						escalator_args_in->config_source_ip,
+						escalator_args_in->config_ssh_key_location,
+						escalator_args_in->get_process_forks_cb_arg,
+						escalator_args_in->config_enable_global_scripts,
+						info->program_type, NULL, &schedule);
+			}
+
+			rescan_time = now + CONFIG_ESCALATOR_RESCAN_FREQUENCY;
+		}
+		else
+		{
+			escalation_schedule_pop_due(&schedule, now, &escalationids, ESCALATOR_BATCH_SIZE);
+
+			if (0 != escalationids.values_num)
+			{
+				zbx_vector_uint64_sort(&escalationids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+				zbx_vector_uint64_uniq(&escalationids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+				/* escalations are selected by identifiers, the source is not used */
+				escalations_count += process_escalations(time(NULL), &nextcheck,
+						ZBX_ESCALATION_SOURCE_TRIGGER, cfg.default_timezone, process_num,
+						escalator_args_in->config_timeout,
+						escalator_args_in->config_trapper_timeout,
+						escalator_args_in->config_source_ip,
+						escalator_args_in->config_ssh_key_location,
+						escalator_args_in->get_process_forks_cb_arg,
+						escalator_args_in->config_enable_global_scripts, info->program_type,
+						&escalationids, &schedule);
+			}
+		}
+
+		/* service escalations are created by service manager without notifying escalators */
 		escalations_count += process_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_SERVICE,
 				cfg.default_timezone, process_num, escalator_args_in->config_timeout,
 				escalator_args_in->config_trapper_timeout, escalator_args_in->config_source_ip,
 				escalator_args_in->config_ssh_key_location, escalator_args_in->get_process_forks_cb_arg,
-				escalator_args_in->config_enable_global_scripts, info->program_type, NULL);
-		escalations_count += process_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_DEFAULT,
-				cfg.default_timezone, process_num, escalator_args_in->config_timeout,
-				escalator_args_in->config_trapper_timeout, escalator_args_in->config_source_ip,
-				escalator_args_in->config_ssh_key_location, escalator_args_in->get_process_forks_cb_arg,
-				escalator_args_in->config_enable_global_scripts, info->program_type, NULL);
+				escalator_args_in->config_enable_global_scripts, info->program_type, NULL, NULL);
 
 		zbx_vector_uint64_clear(&escalationids);
 
+		escalation_schedule_get_nextcheck(&schedule, &nextcheck);
+
+		if (rescan_time < nextcheck)
+			nextcheck = rescan_time;
+
 		zbx_config_clean(&cfg);
 		total_sec += zbx_time() - sec;
 
@@ -3850,6 +4085,7 @@ ZBX_THREAD_ENTRY(escalator_thread, args)
 #		undef STAT_INTERVAL
 	}
 
+	escalation_schedule_destroy(&schedule);
 	zbx_vector_uint64_destroy(&escalationids);
 	notify_alerter(ALERTER_CLOSE);
 
@@ -552,8 +552,14 @@ static zbx_db_event	*close_trigger_event(zbx_uint64_t eventid, zbx_uint64_t obje
  *                                                                            *
  * Purpose: flushes the events into a database                                *
  *                                                                            *
+ * Parameters: sql        - [IN/OUT] SQL buffer                               *
+ *             sql_alloc  - [IN/OUT]                                          *
+ *             sql_offset - [IN/OUT]                                          *
+ *                                                                            *
+ * Return value: number of saved events                                       *
+ *                                                                            *
  ******************************************************************************/
-static int	save_events(void)
+static int	save_events(char **sql, size_t *sql_alloc, size_t *sql_offset)
 {
 	int			i;
 	zbx_db_insert_t		db_insert, db_insert_tags;
@@ -616,13 +622,13 @@ static int	save_events(void)
 		}
 	}
 
-	zbx_db_insert_execute(&db_insert);
+	zbx_db_insert_append_sql(&db_insert, sql, sql_alloc, sql_offset);
 	zbx_db_insert_clean(&db_insert);
 
 	if (0 != insert_tags)
 	{
 		zbx_db_insert_autoincrement(&db_insert_tags, "eventtagid");
-		zbx_db_insert_execute(&db_insert_tags);
+		zbx_db_insert_append_sql(&db_insert_tags, sql, sql_alloc, sql_offset);
 		zbx_db_insert_clean(&db_insert_tags);
 	}
 
@@ -634,8 +640,12 @@ static int	save_events(void)
  * Purpose: generates problems from problem events (trigger and internal      *
  *          event sources)                                                    *
  *                                                                            *
+ * Parameters: sql        - [IN/OUT] SQL buffer                               *
+ *             sql_alloc  - [IN/OUT]                                          *
+ *             sql_offset - [IN/OUT]                                          *
+ *                                                                            *
  ******************************************************************************/
-static void	save_problems(void)
+static void	save_problems(char **sql, size_t *sql_alloc, size_t *sql_offset)
 {
 	int			i;
 	zbx_vector_ptr_t	problems;
@@ -703,7 +713,7 @@ static void	save_problems(void)
 					event->severity);
 		}
 
-		zbx_db_insert_execute(&db_insert);
+		zbx_db_insert_append_sql(&db_insert, sql, sql_alloc, sql_offset);
 		zbx_db_insert_clean(&db_insert);
 
 		if (0 != tags_num)
@@ -730,7 +740,7 @@ static void	save_problems(void)
 			}
 
 			zbx_db_insert_autoincrement(&db_insert, "problemtagid");
-			zbx_db_insert_execute(&db_insert);
+			zbx_db_insert_append_sql(&db_insert, sql, sql_alloc, sql_offset);
 			zbx_db_insert_clean(&db_insert);
 		}
 	}
@@ -743,13 +753,15 @@ static void	save_problems(void)
  * Purpose: saves event recovery data and removes recovered events from       *
  *          problem table                                                     *
  *                                                                            *
+ * Parameters: sql        - [IN/OUT] SQL buffer                               *
+ *             sql_alloc  - [IN/OUT]                                          *
+ *             sql_offset - [IN/OUT]                                          *
+ *                                                                            *
  ******************************************************************************/
-static void	save_event_recovery(void)
+static void	save_event_recovery(char **sql, size_t *sql_alloc, size_t *sql_offset)
 {
 	zbx_db_insert_t		db_insert;
 	zbx_event_recovery_t	*recovery;
-	char			*sql = NULL;
-	size_t			sql_alloc = 0, sql_offset = 0;
 	zbx_hashset_iter_t	iter;
 
 	if (0 == event_recovery.num_data)
@@ -763,8 +775,14 @@ static void	save_event_recovery(void)
 	{
 		zbx_db_insert_add_values(&db_insert, recovery->eventid, recovery->r_event->eventid,
 				recovery->correlationid, recovery->c_eventid, recovery->userid);
+	}
 
-		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+	zbx_db_insert_append_sql(&db_insert, sql, sql_alloc, sql_offset);
+
+	zbx_hashset_iter_reset(&event_recovery, &iter);
+	while (NULL != (recovery = (zbx_event_recovery_t *)zbx_hashset_iter_next(&iter)))
+	{
+		zbx_snprintf_alloc(sql, sql_alloc, sql_offset,
 			"update problem set"
 			" r_eventid=" ZBX_FS_UI64
 			",r_clock=%d"
@@ -777,22 +795,17 @@ static void	save_event_recovery(void)
 
 		if (0 != recovery->correlationid)
 		{
-			zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, ",correlationid=" ZBX_FS_UI64,
+			zbx_snprintf_alloc(sql, sql_alloc, sql_offset, ",correlationid=" ZBX_FS_UI64,
 					recovery->correlationid);
 		}
 
-		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " where eventid=" ZBX_FS_UI64 ";\n",
+		zbx_snprintf_alloc(sql, sql_alloc, sql_offset, " where eventid=" ZBX_FS_UI64 ";\n",
 				recovery->eventid);
 
-		zbx_db_execute_overflowed_sql(&sql, &sql_alloc, &sql_offset);
+		zbx_db_execute_overflowed_sql(sql, sql_alloc, sql_offset);
 	}
 
-	zbx_db_insert_execute(&db_insert);
 	zbx_db_insert_clean(&db_insert);
-
-	(void)zbx_db_flush_overflowed_sql(sql, sql_offset);
-
-	zbx_free(sql);
 }
 
 /******************************************************************************
@@ -1342,42 +1355,69 @@ typedef enum
 }
 zbx_problem_state_t;
 
+/* problem matched by the correlation rule of new event */
+typedef struct
+{
+	int		index;
+	zbx_uint64_t	eventid;
+	zbx_uint64_t	objectid;
+	zbx_uint64_t	correlationid;
+}
+zbx_corr_old_event_t;
+
+ZBX_VECTOR_DECL(corr_old_event, zbx_corr_old_event_t)
+ZBX_VECTOR_IMPL(corr_old_event, zbx_corr_old_event_t)
+
+/* correlation rules matching new event */
+typedef struct
+{
+	zbx_db_event		*event;
+
+	/* correlations that can be executed without checking old events */
+	zbx_vector_ptr_t	corr_new;
+
+	/* correlations that use or affect old events */
+	zbx_vector_ptr_t	corr_old;
+}
+zbx_event_correlation_t;
+
+static int	corr_old_event_compare(const void *d1, const void *d2)
+{
+	const zbx_corr_old_event_t	*e1 = (const zbx_corr_old_event_t *)d1;
+	const zbx_corr_old_event_t	*e2 = (const zbx_corr_old_event_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(e1->index, e2->index);
+	ZBX_RETURN_IF_NOT_EQUAL(e1->eventid, e2->eventid);
+	ZBX_RETURN_IF_NOT_EQUAL(e1->correlationid, e2->correlationid);
+
+	return 0;
+}
+
 /******************************************************************************
  *                                                                            *
- * Purpose: find problem events that must be recovered by global correlation  *
- *          rules and check if the new event must be closed                   *
+ * Purpose: finds global correlation rules that must be executed for new      *
+ *          event                                                             *
  *                                                                            *
- * Parameters: event         - [IN] new event                                 *
+ * Parameters: event_corr    - [IN/OUT] new event and its correlation rules   *
  *             problem_state - [IN/OUT] problem state cache variable          *
  *                                                                            *
- * Comments: The correlation data (zbx_event_recovery_t) of events that       *
- *           must be closed are added to event_correlation hashset            *
- *                                                                            *
- *           The global event correlation matching is done in two parts:      *
+ * Comments: The global event correlation matching is done in two parts:      *
  *             1) exclude correlations that can't possibly match the event    *
  *                based on new event tag/value/group conditions               *
  *             2) assemble sql statement to select problems/correlations      *
- *                based on the rest correlation conditions                    *
+ *                based on the rest correlation conditions, see               *
+ *                correlation_add_old_events_query()                          *
  *                                                                            *
  ******************************************************************************/
-static void	correlate_event_by_global_rules(zbx_db_event *event, zbx_problem_state_t *problem_state)
+static void	correlation_match_event_rules(zbx_event_correlation_t *event_corr,
+		zbx_problem_state_t *problem_state)
 {
-	int			i;
-	zbx_correlation_t	*correlation;
-	zbx_vector_ptr_t	corr_old, corr_new;
-	char			*sql = NULL;
-	const char		*delim = "";
-	size_t			sql_alloc = 0, sql_offset = 0;
-	zbx_uint64_t		eventid, correlationid, objectid;
+	zbx_db_event	*event = event_corr->event;
 
-	zbx_vector_ptr_create(&corr_old);
-	zbx_vector_ptr_create(&corr_new);
-
-	for (i = 0; i < correlation_rules.correlations.values_num; i++)
+	for (int i = 0; i < correlation_rules.correlations.values_num; i++)
 	{
 		zbx_correlation_scope_t	scope;
-
-		correlation = correlation_rules.correlations.values[i];
+		zbx_correlation_t	*correlation = correlation_rules.correlations.values[i];
 
 		switch (correlation_match_new_event(correlation, event, SUCCEED))
 		{
@@ -1420,76 +1460,96 @@ static void	correlate_event_by_global_rules(zbx_db_event *event, zbx_problem_sta
 				/* so there is no need to check old events. Instead re-check if correlation  */
 				/* still matches the new event and must be processed in new event scope.     */
 				if (CORRELATION_MATCH == correlation_match_new_event(correlation, event, FAIL))
-					zbx_vector_ptr_append(&corr_new, correlation);
+					zbx_vector_ptr_append(&event_corr->corr_new, correlation);
 			}
 			else
-				zbx_vector_ptr_append(&corr_old, correlation);
+				zbx_vector_ptr_append(&event_corr->corr_old, correlation);
 		}
 		else
-			zbx_vector_ptr_append(&corr_new, correlation);
+			zbx_vector_ptr_append(&event_corr->corr_new, correlation);
 	}
+}
 
-	if (0 != corr_new.values_num)
-	{
-		/* Process correlations that matches new event and does not use or affect old events. */
-		/* Those correlations can be executed directly, without checking database.            */
-		for (i = 0; i < corr_new.values_num; i++)
-			correlation_execute_operations((zbx_correlation_t *)corr_new.values[i], event, 0, 0);
-	}
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds query selecting problems matching the correlation rules of   *
+ *          new event                                                         *
+ *                                                                            *
+ * Parameters: sql        - [IN/OUT]                                          *
+ *             sql_alloc  - [IN/OUT]                                          *
+ *             sql_offset - [IN/OUT]                                          *
+ *             index      - [IN] new event index returned with the problems   *
+ *             event_corr - [IN] new event and its correlation rules          *
+ *                                                                            *
+ ******************************************************************************/
+static void	correlation_add_old_events_query(char **sql, size_t *sql_alloc, size_t *sql_offset, int index,
+		const zbx_event_correlation_t *event_corr)
+{
+	const char	*delim = "";
 
-	if (0 != corr_old.values_num)
-	{
-		zbx_db_result_t	result;
-		zbx_db_row_t	row;
+	zbx_snprintf_alloc(sql, sql_alloc, sql_offset, "select %d,p.eventid,p.objectid,c.correlationid"
+			" from correlation c,problem p"
+			" where p.r_eventid is null"
+			" and p.source=" ZBX_STR(EVENT_SOURCE_TRIGGERS)
+			" and (", index);
 
-		/* Process correlations that matches new event and either uses old events in conditions */
-		/* or has operations involving old events.                                              */
+	for (int i = 0; i < event_corr->corr_old.values_num; i++)
+	{
+		zbx_strcpy_alloc(sql, sql_alloc, sql_offset, delim);
+		correlation_add_event_filter(sql, sql_alloc, sql_offset,
+				(const zbx_correlation_t *)event_corr->corr_old.values[i], event_corr->event);
+		delim = " or ";
+	}
 
-		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, "select p.eventid,p.objectid,c.correlationid"
-								" from correlation c,problem p"
-								" where p.r_eventid is null"
-								" and p.source=" ZBX_STR(EVENT_SOURCE_TRIGGERS)
-								" and (");
+	zbx_chrcpy_alloc(sql, sql_alloc, sql_offset, ')');
+}
 
-		for (i = 0; i < corr_old.values_num; i++)
-		{
-			correlation = (zbx_correlation_t *)corr_old.values[i];
+/******************************************************************************
+ *                                                                            *
+ * Purpose: executes global correlation rules for new event                   *
+ *                                                                            *
+ * Parameters: event_corr - [IN/OUT] new event and its correlation rules      *
+ *             old_events - [IN] problems matched by the correlation rules of *
+ *                               new events, sorted by new event index        *
+ *             index      - [IN] new event index                              *
+ *             old_next   - [IN/OUT] next problem in old_events               *
+ *                                                                            *
+ * Comments: The correlation data (zbx_event_recovery_t) of events that       *
+ *           must be closed are added to event_correlation hashset            *
+ *                                                                            *
+ ******************************************************************************/
+static void	correlate_event_by_global_rules(zbx_event_correlation_t *event_corr,
+		const zbx_vector_corr_old_event_t *old_events, int index, int *old_next)
+{
+	/* Process correlations that matches new event and does not use or affect old events. */
+	/* Those correlations can be executed directly, without checking database.            */
+	for (int i = 0; i < event_corr->corr_new.values_num; i++)
+	{
+		correlation_execute_operations((zbx_correlation_t *)event_corr->corr_new.values[i], event_corr->event,
+				0, 0);
+	}
 
-			zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, delim);
-			correlation_add_event_filter(&sql, &sql_alloc, &sql_offset, correlation, event);
-			delim = " or ";
-		}
+	/* Process correlations that matches new event and either uses old events in conditions */
+	/* or has operations involving old events.                                              */
+	for (; *old_next < old_events->values_num && index == old_events->values[*old_next].index; (*old_next)++)
+	{
+		const zbx_corr_old_event_t	*old_event = &old_events->values[*old_next];
+		int				i;
 
-		zbx_chrcpy_alloc(&sql, &sql_alloc, &sql_offset, ')');
-		result = zbx_db_select("%s", sql);
+		/* check if this event is not already recovered by another correlation rule */
+		if (NULL != zbx_hashset_search(&correlation_cache, &old_event->eventid))
+			continue;
 
-		while (NULL != (row = zbx_db_fetch(result)))
+		if (FAIL == (i = zbx_vector_ptr_bsearch(&event_corr->corr_old, &old_event->correlationid,
+				ZBX_DEFAULT_UINT64_PTR_COMPARE_FUNC)))
 		{
-			ZBX_STR2UINT64(eventid, row[0]);
-
-			/* check if this event is not already recovered by another correlation rule */
-			if (NULL != zbx_hashset_search(&correlation_cache, &eventid))
-				continue;
-
-			ZBX_STR2UINT64(correlationid, row[2]);
-
-			if (FAIL == (i = zbx_vector_ptr_bsearch(&corr_old, &correlationid,
-					ZBX_DEFAULT_UINT64_PTR_COMPARE_FUNC)))
-			{
-				THIS_SHOULD_NEVER_HAPPEN;
-				continue;
-			}
-
-			ZBX_STR2UINT64(objectid, row[1]);
-			correlation_execute_operations((zbx_correlation_t *)corr_old.values[i], event, eventid, objectid);
+			THIS_SHOULD_NEVER_HAPPEN;
+			continue;
 		}
 
-		zbx_db_free_result(result);
-		zbx_free(sql);
+		correlation_execute_operations((zbx_correlation_t *)event_corr->corr_old.values[i], event_corr->event,
+				old_event->eventid, old_event->objectid);
 	}
-
-	zbx_vector_ptr_destroy(&corr_new);
-	zbx_vector_ptr_destroy(&corr_old);
 }
 
 /******************************************************************************
@@ -1497,13 +1557,24 @@ static void	correlate_event_by_global_rules(zbx_db_event *event, zbx_problem_sta
  * Purpose: add events to the closing queue according to global correlation   *
  *          rules                                                             *
  *                                                                            *
+ * Comments: Problems matching correlation rules of a batch of new events are *
+ *           selected with a single query. This does not change correlation   *
+ *           results as problem table is not modified during correlation and  *
+ *           the new events are still correlated in their order.              *
+ *                                                                            *
  ******************************************************************************/
 static void	correlate_events_by_global_rules(zbx_vector_ptr_t *trigger_events,
 		zbx_vector_trigger_diff_ptr_t *trigger_diff)
 {
-	int			i, index;
-	zbx_trigger_diff_t	*diff;
-	zbx_problem_state_t	problem_state = ZBX_PROBLEM_STATE_UNKNOWN;
+#define ZBX_CORRELATION_EVENTS_BATCH_SIZE	100
+
+	int				index;
+	zbx_trigger_diff_t		*diff;
+	zbx_problem_state_t		problem_state = ZBX_PROBLEM_STATE_UNKNOWN;
+	zbx_event_correlation_t		*event_corrs = NULL;
+	zbx_vector_corr_old_event_t	old_events;
+	char				*sql = NULL;
+	size_t				sql_alloc = 0;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() events:%d", __func__, correlation_cache.num_data);
 
@@ -1512,33 +1583,106 @@ static void	correlate_events_by_global_rules(zbx_vector_ptr_t *trigger_events,
 	if (0 == correlation_rules.correlations.values_num)
 		goto out;
 
+	zbx_vector_corr_old_event_create(&old_events);
+	event_corrs = (zbx_event_correlation_t *)zbx_malloc(NULL, sizeof(zbx_event_correlation_t) *
+			ZBX_CORRELATION_EVENTS_BATCH_SIZE);
+
+	for (int i = 0; i < ZBX_CORRELATION_EVENTS_BATCH_SIZE; i++)
+	{
+		zbx_vector_ptr_create(&event_corrs[i].corr_new);
+		zbx_vector_ptr_create(&event_corrs[i].corr_old);
+	}
+
 	/* process global correlation and queue the events that must be closed */
-	for (i = 0; i < trigger_events->values_num; i++)
+	for (int i = 0; i < trigger_events->values_num;)
 	{
-		zbx_db_event	*event = (zbx_db_event *)trigger_events->values[i];
+		int	events_num = 0, old_next = 0;
+		size_t	sql_offset = 0;
 
-		if (0 == (ZBX_FLAGS_DB_EVENT_CREATE & event->flags))
-			continue;
+		for (; i < trigger_events->values_num && events_num < ZBX_CORRELATION_EVENTS_BATCH_SIZE; i++)
+		{
+			zbx_event_correlation_t	*event_corr = &event_corrs[events_num];
+			zbx_db_event		*event = (zbx_db_event *)trigger_events->values[i];
+
+			if (0 == (ZBX_FLAGS_DB_EVENT_CREATE & event->flags))
+				continue;
 
-		correlate_event_by_global_rules(event, &problem_state);
+			event_corr->event = event;
+			zbx_vector_ptr_clear(&event_corr->corr_new);
+			zbx_vector_ptr_clear(&event_corr->corr_old);
 
-		/* force value recalculation based on open problems for triggers with */
-		/* events closed by 'close new' correlation operation                */
-		if (0 != (event->flags & ZBX_FLAGS_DB_EVENT_NO_ACTION))
+			correlation_match_event_rules(event_corr, &problem_state);
+
+			if (0 != event_corr->corr_old.values_num)
+			{
+				if (0 != sql_offset)
+					zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, " union all ");
+
+				correlation_add_old_events_query(&sql, &sql_alloc, &sql_offset, events_num, event_corr);
+			}
+
+			events_num++;
+		}
+
+		if (0 != sql_offset)
 		{
-			zbx_trigger_diff_t	trigger_diff_cmp = {.triggerid = event->objectid};
+			zbx_db_result_t	result;
+			zbx_db_row_t	row;
 
-			if (FAIL != (index = zbx_vector_trigger_diff_ptr_bsearch(trigger_diff, &trigger_diff_cmp,
-					zbx_trigger_diff_compare_func)))
+			result = zbx_db_select("%s", sql);
+
+			while (NULL != (row = zbx_db_fetch(result)))
 			{
-				diff = trigger_diff->values[index];
-				diff->flags |= ZBX_FLAGS_TRIGGER_DIFF_RECALCULATE_PROBLEM_COUNT;
+				zbx_corr_old_event_t	old_event;
+
+				old_event.index = atoi(row[0]);
+				ZBX_STR2UINT64(old_event.eventid, row[1]);
+				ZBX_STR2UINT64(old_event.objectid, row[2]);
+				ZBX_STR2UINT64(old_event.correlationid, row[3]);
+				zbx_vector_corr_old_event_append(&old_events, old_event);
 			}
+			zbx_db_free_result(result);
+
+			zbx_vector_corr_old_event_sort(&old_events, corr_old_event_compare);
 		}
+
+		for (int j = 0; j < events_num; j++)
+		{
+			zbx_db_event	*event = event_corrs[j].event;
+
+			correlate_event_by_global_rules(&event_corrs[j], &old_events, j, &old_next);
+
+			/* force value recalculation based on open problems for triggers with */
+			/* events closed by 'close new' correlation operation                */
+			if (0 != (event->flags & ZBX_FLAGS_DB_EVENT_NO_ACTION))
+			{
+				zbx_trigger_diff_t	trigger_diff_cmp = {.triggerid = event->objectid};
+
+				if (FAIL != (index = zbx_vector_trigger_diff_ptr_bsearch(trigger_diff,
+						&trigger_diff_cmp, zbx_trigger_diff_compare_func)))
+				{
+					diff = trigger_diff->values[index];
+					diff->flags |= ZBX_FLAGS_TRIGGER_DIFF_RECALCULATE_PROBLEM_COUNT;
+				}
+			}
+		}
+
+		zbx_vector_corr_old_event_clear(&old_events);
 	}
 
+	for (int i = 0; i < ZBX_CORRELATION_EVENTS_BATCH_SIZE; i++)
+	{
+		zbx_vector_ptr_destroy(&event_corrs[i].corr_new);
+		zbx_vector_ptr_destroy(&event_corrs[i].corr_old);
+	}
+
+	zbx_free(event_corrs);
+	zbx_free(sql);
+	zbx_vector_corr_old_event_destroy(&old_events);
 out:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+
+#undef ZBX_CORRELATION_EVENTS_BATCH_SIZE
 }
 
 /******************************************************************************
@@ -2167,6 +2311,25 @@ exit:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: notifies escalators about escalations created by processes        *
+ *          without permanent RTC connection                                  *
+ *                                                                            *
+ * Parameters: escalations - [IN/OUT] escalations created by processed events,*
+ *                                    cleared on return                       *
+ *             committed   - [IN] 1 if the transaction creating escalations   *
+ *                                was committed, 0 otherwise                  *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_events_start_escalations(zbx_vector_escalation_new_ptr_t *escalations, int committed)
+{
+	if (0 != committed)
+		zbx_start_escalations(NULL, escalations);
+
+	zbx_vector_escalation_new_ptr_clear_ext(escalations, zbx_escalation_new_ptr_free);
+}
+
 void	zbx_events_update_itservices(void)
 {
 	unsigned char		*data = NULL;
@@ -2359,10 +2522,19 @@ static int	flush_events(zbx_vector_escalation_new_ptr_t *escalations)
 	zbx_event_recovery_t		*recovery;
 	zbx_vector_uint64_pair_t	closed_events;
 	zbx_hashset_iter_t		iter;
+	char				*sql;
+	size_t				sql_alloc = 16 * ZBX_KIBIBYTE, sql_offset = 0;
+
+	/* events, problems, their tags and recoveries are written with as few database requests as possible */
+	sql = (char *)zbx_malloc(NULL, sql_alloc);
+
+	ret = save_events(&sql, &sql_alloc, &sql_offset);
+	save_problems(&sql, &sql_alloc, &sql_offset);
+	save_event_recovery(&sql, &sql_alloc, &sql_offset);
+
+	(void)zbx_db_flush_overflowed_sql(sql, sql_offset);
+	zbx_free(sql);
 
-	ret = save_events();
-	save_problems();
-	save_event_recovery();
 	update_event_suppress_data();
 
 	zbx_vector_uint64_pair_create(&closed_events);
@@ -39,5 +39,6 @@ void	zbx_reset_event_recovery(void);
 void	zbx_export_events(int events_export_enabled, zbx_vector_connector_filter_t *connector_filters,
 		unsigned char **data, size_t *data_alloc, size_t *data_offset);
 void	zbx_events_update_itservices(void);
+void	zbx_events_start_escalations(zbx_vector_escalation_new_ptr_t *escalations, int committed);
 
 #endif
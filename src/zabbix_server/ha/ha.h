@@ -73,5 +73,6 @@ int	zbx_ha_set_failover_delay(int delay, char **error);
 int	zbx_ha_get_failover_delay(int *delay, char **error);
 int	zbx_ha_change_loglevel(int direction, char **error);
 const char	*zbx_ha_status_str(int ha_status);
+const char	*zbx_ha_get_sessionid(void);
 
 #endif
@@ -1539,6 +1539,19 @@ void	zbx_init_library_ha(void)
 	zbx_new_cuid(ha_sessionid.str);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get identifier of current server run                              *
+ *                                                                            *
+ * Comments: The session identifier is stored in the server node registry     *
+ *           when the node is registered.                                     *
+ *                                                                            *
+ ******************************************************************************/
+const char	*zbx_ha_get_sessionid(void)
+{
+	return ha_sessionid.str;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: get HA manager status                                             *
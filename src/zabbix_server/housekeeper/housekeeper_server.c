@@ -42,6 +42,9 @@
 #define HK_MIN_CLOCK_UNDEFINED		0
 #define HK_MIN_CLOCK_ALWAYS_RECHECK	-1
 
+/* the number of days native history/trends partitions are created in advance */
+#define HK_PARTITION_DAYS_AHEAD		7
+
 /* trends table offsets in the hk_cleanup_tables[] mapping  */
 #define HK_UPDATE_CACHE_OFFSET_TREND_FLOAT	(ITEM_VALUE_TYPE_BIN + 1)
 #define HK_UPDATE_CACHE_OFFSET_TREND_UINT	(HK_UPDATE_CACHE_OFFSET_TREND_FLOAT + 1)
@@ -140,9 +143,32 @@ typedef struct
 
 	/* the item delete queue */
 	zbx_vector_hk_delete_queue_ptr_t	delete_queue;
+
+	/* set when the table is natively range partitioned by clock column (non-TimescaleDB) */
+	unsigned char				native_partitions;
+
+	/* the longest storage period of items having data in the table, -1 if there are no such items */
+	int					history_max;
+
+	/* set when storage period of an item having data in the table cannot be resolved */
+	unsigned char				history_invalid;
 }
 zbx_hk_history_rule_t;
 
+/* native range partition of history (trends) table */
+typedef struct
+{
+	char	*name;
+
+	/* the partition bounds - clock_from is inclusive, clock_to is exclusive */
+	int	clock_from;
+	int	clock_to;
+}
+zbx_hk_partition_t;
+
+ZBX_PTR_VECTOR_DECL(hk_partition_ptr, zbx_hk_partition_t *)
+ZBX_PTR_VECTOR_IMPL(hk_partition_ptr, zbx_hk_partition_t *)
+
 static struct zbx_db_version_info_t	*db_version_info;
 
 #if defined(HAVE_POSTGRESQL)
@@ -368,6 +394,60 @@ static void	hk_history_item_update(zbx_hk_history_rule_t *rules, int count, cons
 		}
 
 		hk_history_delete_queue_append(rule, now, item_record, history);
+
+		if (rule->history_max < history)
+			rule->history_max = history;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: marks rules of tables that can have data of item with invalid     *
+ *          storage period                                                    *
+ *                                                                            *
+ * Parameters: rules    - [IN/OUT] history housekeeping rules                 *
+ *             count    - [IN] number of rules                                *
+ *             rule_add - [IN] rule of the current item value type, can be    *
+ *                             NULL                                           *
+ *             itemid   - [IN]                                                *
+ *                                                                            *
+ * Comments: The longest storage period of such tables is unknown, so their   *
+ *           partitions must not be dropped.                                  *
+ *                                                                            *
+ ******************************************************************************/
+static void	hk_history_item_invalidate(zbx_hk_history_rule_t *rules, int count,
+		const zbx_hk_history_rule_t *rule_add, zbx_uint64_t itemid)
+{
+	for (zbx_hk_history_rule_t *rule = rules; rule - rules < count; rule++)
+	{
+		if (rule_add == rule || (0 != rule->item_cache.num_slots &&
+				NULL != zbx_hashset_search(&rule->item_cache, &itemid)))
+		{
+			rule->history_invalid = 1;
+		}
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets trends housekeeping rule of item value type                  *
+ *                                                                            *
+ * Parameters: rules      - [IN] history housekeeping rules                   *
+ *             value_type - [IN] item value type                              *
+ *                                                                            *
+ * Return value: trends rule or NULL for non-numeric value types              *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_hk_history_rule_t	*hk_trends_rule_get(zbx_hk_history_rule_t *rules, int value_type)
+{
+	switch (value_type)
+	{
+		case ITEM_VALUE_TYPE_FLOAT:
+			return &rules[HK_UPDATE_CACHE_OFFSET_TREND_FLOAT];
+		case ITEM_VALUE_TYPE_UINT64:
+			return &rules[HK_UPDATE_CACHE_OFFSET_TREND_UINT];
+		default:
+			return NULL;
 	}
 }
 
@@ -421,13 +501,13 @@ static void	hk_history_update(zbx_hk_history_rule_t *rules, int now)
 			{
 				zabbix_log(LOG_LEVEL_WARNING, "invalid history storage period '%s' for itemid '%s'",
 						tmp, row[0]);
-				continue;
+				goto invalid;
 			}
 
 			if (0 != history && (ZBX_HK_HISTORY_MIN > history || ZBX_HK_PERIOD_MAX < history))
 			{
 				zabbix_log(LOG_LEVEL_WARNING, "invalid history storage period for itemid '%s'", row[0]);
-				continue;
+				goto invalid;
 			}
 
 			if (0 != history && ZBX_HK_OPTION_DISABLED != *rule->poption_global)
@@ -457,11 +537,15 @@ static void	hk_history_update(zbx_hk_history_rule_t *rules, int now)
 			{
 				zabbix_log(LOG_LEVEL_WARNING, "invalid trends storage period '%s' for itemid '%s'",
 						tmp, row[0]);
+				hk_history_item_invalidate(rules + HK_UPDATE_CACHE_OFFSET_TREND_FLOAT,
+						HK_UPDATE_CACHE_TREND_COUNT, rule_add, itemid);
 				continue;
 			}
 			else if (0 != trends && (ZBX_HK_TRENDS_MIN > trends || ZBX_HK_PERIOD_MAX < trends))
 			{
 				zabbix_log(LOG_LEVEL_WARNING, "invalid trends storage period for itemid '%s'", row[0]);
+				hk_history_item_invalidate(rules + HK_UPDATE_CACHE_OFFSET_TREND_FLOAT,
+						HK_UPDATE_CACHE_TREND_COUNT, rule_add, itemid);
 				continue;
 			}
 		}
@@ -479,6 +563,13 @@ static void	hk_history_update(zbx_hk_history_rule_t *rules, int now)
 
 		hk_history_item_update(rules + HK_UPDATE_CACHE_OFFSET_TREND_FLOAT, HK_UPDATE_CACHE_TREND_COUNT,
 				rule_add, now, itemid, trends);
+
+		continue;
+invalid:
+		/* trends of the item are not processed either, so their storage period is unknown too */
+		hk_history_item_invalidate(rules, ITEM_VALUE_TYPE_BIN + 1, rule, itemid);
+		hk_history_item_invalidate(rules + HK_UPDATE_CACHE_OFFSET_TREND_FLOAT, HK_UPDATE_CACHE_TREND_COUNT,
+				hk_trends_rule_get(rules, value_type), itemid);
 	}
 	zbx_db_free_result(result);
 
@@ -487,6 +578,512 @@ static void	hk_history_update(zbx_hk_history_rule_t *rules, int now)
 	zbx_free(tmp);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if table is natively range partitioned by clock column     *
+ *                                                                            *
+ * Parameters: table_name - [IN]                                              *
+ *                                                                            *
+ * Return value: SUCCEED - the table is partitioned by clock ranges           *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: TimescaleDB hypertables are not reported as partitioned, they    *
+ *           are handled by ZBX_HK_MODE_PARTITION mode.                       *
+ *                                                                            *
+ ******************************************************************************/
+static int	hk_partitions_check(const char *table_name)
+{
+#if defined(HAVE_POSTGRESQL) || defined(HAVE_MYSQL)
+	zbx_db_result_t	result;
+	zbx_db_row_t	row;
+	int		ret = FAIL;
+
+#if defined(HAVE_POSTGRESQL)
+	if (0 < tsdb_version)
+		return FAIL;
+
+	result = zbx_db_select(
+			"select pg_get_partkeydef(c.oid)"
+			" from pg_class c,pg_namespace n"
+			" where c.relnamespace=n.oid"
+				" and c.relkind='p'"
+				" and c.relname='%s'"
+				" and n.nspname='%s'",
+			table_name, zbx_db_get_schema_esc());
+
+	if (NULL != (row = zbx_db_fetch(result)) && 0 == strcasecmp(row[0], "RANGE (clock)"))
+		ret = SUCCEED;
+#else
+	result = zbx_db_select(
+			"select partition_method,partition_expression"
+			" from information_schema.partitions"
+			" where table_schema=database()"
+				" and table_name='%s'"
+				" and partition_name is not null"
+			" limit 1",
+			table_name);
+
+	if (NULL != (row = zbx_db_fetch(result)) &&
+			0 == strncmp(row[0], "RANGE", ZBX_CONST_STRLEN("RANGE")) &&
+			(0 == zbx_strcmp_null(row[1], "clock") || 0 == zbx_strcmp_null(row[1], "`clock`")))
+	{
+		ret = SUCCEED;
+	}
+#endif
+	zbx_db_free_result(result);
+
+	return ret;
+#else
+	ZBX_UNUSED(table_name);
+
+	return FAIL;
+#endif
+}
+
+static void	hk_partition_free(zbx_hk_partition_t *partition)
+{
+	zbx_free(partition->name);
+	zbx_free(partition);
+}
+
+static int	hk_partition_compare(const void *d1, const void *d2)
+{
+	const zbx_hk_partition_t	*p1 = *(const zbx_hk_partition_t * const *)d1;
+	const zbx_hk_partition_t	*p2 = *(const zbx_hk_partition_t * const *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(p1->clock_from, p2->clock_from);
+
+	return 0;
+}
+
+#if defined(HAVE_POSTGRESQL)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parses partition bound value from PostgreSQL partition bound      *
+ *          expression, for example 'FOR VALUES FROM (1) TO (2)'              *
+ *                                                                            *
+ * Parameters: expr      - [IN] partition bound expression                    *
+ *             keyword   - [IN] bound keyword ("FROM (" or "TO (")            *
+ *             unbounded - [IN] value to use for MINVALUE/MAXVALUE bounds     *
+ *             clock     - [OUT] parsed bound                                 *
+ *                                                                            *
+ * Return value: SUCCEED - bound was parsed successfully                      *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	hk_partition_bound_parse(const char *expr, const char *keyword, int unbounded, int *clock)
+{
+	const char	*ptr;
+	char		*end;
+	long		value;
+
+	if (NULL == (ptr = strstr(expr, keyword)))
+		return FAIL;
+
+	ptr += strlen(keyword);
+
+	if ('\'' == *ptr)
+		ptr++;
+
+	if (0 == strncmp(ptr, "MINVALUE", ZBX_CONST_STRLEN("MINVALUE")) ||
+			0 == strncmp(ptr, "MAXVALUE", ZBX_CONST_STRLEN("MAXVALUE")))
+	{
+		*clock = unbounded;
+		return SUCCEED;
+	}
+
+	value = strtol(ptr, &end, 10);
+
+	if (end == ptr || INT_MIN > value || INT_MAX < value)
+		return FAIL;
+
+	*clock = (int)value;
+
+	return SUCCEED;
+}
+#endif
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets native range partitions of table                             *
+ *                                                                            *
+ * Parameters: table_name - [IN]                                              *
+ *             partitions - [OUT] partitions sorted by their bounds           *
+ *             rows_max   - [OUT] the estimated number of rows in MySQL       *
+ *                                MAXVALUE partition, 0 otherwise             *
+ *                                                                            *
+ * Comments: PostgreSQL DEFAULT partition is not returned. MySQL MAXVALUE     *
+ *           partition is returned as the last partition with INT_MAX upper   *
+ *           bound.                                                           *
+ *                                                                            *
+ ******************************************************************************/
+static void	hk_partitions_get(const char *table_name, zbx_vector_hk_partition_ptr_t *partitions,
+		zbx_uint64_t *rows_max)
+{
+#if defined(HAVE_POSTGRESQL) || defined(HAVE_MYSQL)
+	zbx_db_result_t	result;
+	zbx_db_row_t	row;
+
+	*rows_max = 0;
+
+#if defined(HAVE_POSTGRESQL)
+	result = zbx_db_select(
+			"select c.relname,pg_get_expr(c.relpartbound,c.oid)"
+			" from pg_inherits i,pg_class c,pg_class p,pg_namespace n"
+			" where i.inhrelid=c.oid"
+				" and i.inhparent=p.oid"
+				" and p.relnamespace=n.oid"
+				" and p.relname='%s'"
+				" and n.nspname='%s'",
+			table_name, zbx_db_get_schema_esc());
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		zbx_hk_partition_t	*partition;
+		int			clock_from, clock_to;
+
+		if (SUCCEED != hk_partition_bound_parse(row[1], "FROM (", INT_MIN, &clock_from) ||
+				SUCCEED != hk_partition_bound_parse(row[1], "TO (", INT_MAX, &clock_to))
+		{
+			continue;
+		}
+
+		partition = (zbx_hk_partition_t *)zbx_malloc(NULL, sizeof(zbx_hk_partition_t));
+		partition->name = zbx_strdup(NULL, row[0]);
+		partition->clock_from = clock_from;
+		partition->clock_to = clock_to;
+		zbx_vector_hk_partition_ptr_append(partitions, partition);
+	}
+#else
+	int	clock_from = INT_MIN;
+
+	result = zbx_db_select(
+			"select partition_name,partition_description,table_rows"
+			" from information_schema.partitions"
+			" where table_schema=database()"
+				" and table_name='%s'"
+				" and partition_name is not null"
+			" order by partition_ordinal_position",
+			table_name);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		zbx_hk_partition_t	*partition;
+
+		partition = (zbx_hk_partition_t *)zbx_malloc(NULL, sizeof(zbx_hk_partition_t));
+		partition->name = zbx_strdup(NULL, row[0]);
+		partition->clock_from = clock_from;
+
+		if (0 == strcmp(row[1], "MAXVALUE"))
+		{
+			partition->clock_to = INT_MAX;
+
+			if (SUCCEED != zbx_db_is_null(row[2]))
+				ZBX_STR2UINT64(*rows_max, row[2]);
+		}
+		else
+			partition->clock_to = atoi(row[1]);
+
+		zbx_vector_hk_partition_ptr_append(partitions, partition);
+		clock_from = partition->clock_to;
+	}
+#endif
+	zbx_db_free_result(result);
+
+	zbx_vector_hk_partition_ptr_sort(partitions, hk_partition_compare);
+#else
+	ZBX_UNUSED(table_name);
+	ZBX_UNUSED(partitions);
+
+	*rows_max = 0;
+#endif
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: creates daily partitions for the current and the next             *
+ *          HK_PARTITION_DAYS_AHEAD days                                      *
+ *                                                                            *
+ * Parameters: table_name - [IN]                                              *
+ *             partitions - [IN/OUT] existing partitions, created partitions  *
+ *                                   are added                                *
+ *             rows_max   - [IN] the number of rows in MySQL MAXVALUE         *
+ *                               partition                                    *
+ *             now        - [IN] current timestamp                            *
+ *                                                                            *
+ * Comments: Partitions are named <table>_pYYYYMMDD on PostgreSQL and         *
+ *           pYYYYMMDD on MySQL, days are in UTC.                             *
+ *           MySQL partitions can only be added after the last partition, so  *
+ *           a non-empty MAXVALUE partition blocks partition creation to      *
+ *           avoid rebuilding it.                                             *
+ *                                                                            *
+ ******************************************************************************/
+static void	hk_partitions_create(const char *table_name, zbx_vector_hk_partition_ptr_t *partitions,
+		zbx_uint64_t rows_max, int now)
+{
+#if defined(HAVE_POSTGRESQL) || defined(HAVE_MYSQL)
+	int	day_from = now - now % SEC_PER_DAY;
+#if defined(HAVE_MYSQL)
+	int			clock_max = INT_MIN;
+	zbx_hk_partition_t	*partition_max = NULL;
+
+	for (int i = 0; i < partitions->values_num; i++)
+	{
+		if (INT_MAX == partitions->values[i]->clock_to)
+			partition_max = partitions->values[i];
+		else if (clock_max < partitions->values[i]->clock_to)
+			clock_max = partitions->values[i]->clock_to;
+	}
+
+	if (NULL != partition_max && 0 != rows_max)
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot create partitions for table \"%s\": MAXVALUE partition \"%s\""
+				" is not empty", table_name, partition_max->name);
+		return;
+	}
+#else
+	ZBX_UNUSED(rows_max);
+#endif
+
+	for (int i = 0; i <= HK_PARTITION_DAYS_AHEAD; i++, day_from += SEC_PER_DAY)
+	{
+		int			clock_from = day_from, day_to = day_from + SEC_PER_DAY, rc;
+		time_t			day = (time_t)day_from;
+		struct tm		tm;
+		char			name[64];
+		zbx_hk_partition_t	*partition;
+
+#if defined(HAVE_POSTGRESQL)
+		int	j;
+
+		for (j = 0; j < partitions->values_num; j++)
+		{
+			if (partitions->values[j]->clock_from < day_to && partitions->values[j]->clock_to > day_from)
+				break;
+		}
+
+		if (j != partitions->values_num)
+			continue;
+
+		gmtime_r(&day, &tm);
+		zbx_snprintf(name, sizeof(name), "%s_p%04d%02d%02d", table_name, tm.tm_year + 1900, tm.tm_mon + 1,
+				tm.tm_mday);
+
+		rc = zbx_db_execute("create table %s partition of %s for values from (%d) to (%d)", name, table_name,
+				day_from, day_to);
+#else
+		if (day_to <= clock_max)
+			continue;
+
+		gmtime_r(&day, &tm);
+		zbx_snprintf(name, sizeof(name), "p%04d%02d%02d", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+
+		if (NULL != partition_max)
+		{
+			rc = zbx_db_execute("alter table %s reorganize partition %s into"
+					" (partition %s values less than (%d),partition %s values less than maxvalue)",
+					table_name, partition_max->name, name, day_to, partition_max->name);
+		}
+		else
+		{
+			rc = zbx_db_execute("alter table %s add partition (partition %s values less than (%d))",
+					table_name, name, day_to);
+		}
+
+		if (clock_from < clock_max)
+			clock_from = clock_max;
+
+		clock_max = day_to;
+#endif
+		if (ZBX_DB_OK > rc)
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "cannot create partition \"%s\" for table \"%s\"", name,
+					table_name);
+			return;
+		}
+
+		zabbix_log(LOG_LEVEL_DEBUG, "created partition \"%s\" for table \"%s\"", name, table_name);
+#if defined(HAVE_MYSQL)
+		if (NULL != partition_max)
+			partition_max->clock_from = day_to;
+#endif
+		partition = (zbx_hk_partition_t *)zbx_malloc(NULL, sizeof(zbx_hk_partition_t));
+		partition->name = zbx_strdup(NULL, name);
+		partition->clock_from = clock_from;
+		partition->clock_to = day_to;
+		zbx_vector_hk_partition_ptr_append(partitions, partition);
+	}
+#else
+	ZBX_UNUSED(table_name);
+	ZBX_UNUSED(partitions);
+	ZBX_UNUSED(rows_max);
+	ZBX_UNUSED(now);
+#endif
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: drops partitions containing only expired data                     *
+ *                                                                            *
+ * Parameters: table_name - [IN]                                              *
+ *             partitions - [IN] table partitions                             *
+ *             keep_from  - [IN] the oldest timestamp of data to keep         *
+ *                                                                            *
+ * Return value: the upper bound of dropped partitions or 0 if no partitions  *
+ *               were dropped                                                 *
+ *                                                                            *
+ ******************************************************************************/
+static int	hk_partitions_drop(const char *table_name, const zbx_vector_hk_partition_ptr_t *partitions,
+		int keep_from)
+{
+	int	dropped_to = 0;
+#if defined(HAVE_POSTGRESQL)
+	for (int i = 0; i < partitions->values_num; i++)
+	{
+		const zbx_hk_partition_t	*partition = partitions->values[i];
+
+		if (partition->clock_to > keep_from)
+			continue;
+
+		if (ZBX_DB_OK > zbx_db_execute("drop table %s", partition->name))
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "cannot drop partition \"%s\" of table \"%s\"", partition->name,
+					table_name);
+			continue;
+		}
+
+		zabbix_log(LOG_LEVEL_DEBUG, "dropped partition \"%s\" of table \"%s\"", partition->name, table_name);
+
+		if (dropped_to < partition->clock_to)
+			dropped_to = partition->clock_to;
+	}
+#elif defined(HAVE_MYSQL)
+	char	*sql = NULL;
+	size_t	sql_alloc = 0, sql_offset = 0;
+	char	delim = ' ';
+
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "alter table %s drop partition", table_name);
+
+	/* MySQL does not allow dropping all partitions, keep the last one */
+	for (int i = 0; i < partitions->values_num - 1; i++)
+	{
+		const zbx_hk_partition_t	*partition = partitions->values[i];
+
+		if (partition->clock_to > keep_from)
+			break;
+
+		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "%c%s", delim, partition->name);
+		delim = ',';
+		dropped_to = partition->clock_to;
+	}
+
+	if (0 != dropped_to)
+	{
+		if (ZBX_DB_OK > zbx_db_execute("%s", sql))
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "cannot drop expired partitions of table \"%s\"", table_name);
+			dropped_to = 0;
+		}
+		else
+			zabbix_log(LOG_LEVEL_DEBUG, "dropped partitions of table \"%s\":%s", table_name, sql);
+	}
+
+	zbx_free(sql);
+#else
+	ZBX_UNUSED(table_name);
+	ZBX_UNUSED(partitions);
+	ZBX_UNUSED(keep_from);
+#endif
+	return dropped_to;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets storage period of natively partitioned table                 *
+ *                                                                            *
+ * Parameters: rule    - [IN] history housekeeping rule                       *
+ *             now     - [IN] current timestamp                               *
+ *             history - [OUT] storage period                                 *
+ *                                                                            *
+ * Return value: SUCCEED - expired partitions can be dropped                  *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	hk_history_partitions_period(const zbx_hk_history_rule_t *rule, int now, int *history)
+{
+	if (ZBX_HK_OPTION_DISABLED != *rule->poption_global)
+	{
+		*history = *rule->poption;
+	}
+	else if (0 != rule->history_invalid)
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot drop partitions of table \"%s\": storage period of some items"
+				" is invalid", rule->table);
+		return FAIL;
+	}
+	else
+		*history = rule->history_max;
+
+	if (0 > *history || *history > now)
+		return FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: maintains native partitions of history (trends) table             *
+ *                                                                            *
+ * Parameters: rule - [IN/OUT] history housekeeping rule                      *
+ *             now  - [IN] current timestamp                                  *
+ *                                                                            *
+ * Comments: Future daily partitions are created in advance and partitions    *
+ *           holding only data older than the storage period are dropped.     *
+ *           With global period override the override period is used,         *
+ *           otherwise the longest item storage period - items with shorter   *
+ *           periods are still cleaned by the delete queue.                   *
+ *                                                                            *
+ ******************************************************************************/
+static void	hk_history_native_partitions(zbx_hk_history_rule_t *rule, int now)
+{
+	zbx_vector_hk_partition_ptr_t	partitions;
+	zbx_uint64_t			rows_max;
+	int				history, dropped_to;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() table:%s", __func__, rule->table);
+
+	zbx_vector_hk_partition_ptr_create(&partitions);
+
+	hk_partitions_get(rule->table, &partitions, &rows_max);
+	hk_partitions_create(rule->table, &partitions, rows_max, now);
+
+	if (SUCCEED != hk_history_partitions_period(rule, now, &history))
+		goto out;
+
+	zbx_vector_hk_partition_ptr_sort(&partitions, hk_partition_compare);
+
+	if (0 != (dropped_to = hk_partitions_drop(rule->table, &partitions, now - history)) &&
+			0 != rule->item_cache.num_slots)
+	{
+		zbx_hashset_iter_t	iter;
+		zbx_hk_item_cache_t	*item_record;
+
+		/* the data before dropped partitions bound is gone, skip it when deleting by items */
+		zbx_hashset_iter_reset(&rule->item_cache, &iter);
+
+		while (NULL != (item_record = (zbx_hk_item_cache_t *)zbx_hashset_iter_next(&iter)))
+		{
+			if (item_record->min_clock < dropped_to)
+				item_record->min_clock = dropped_to;
+		}
+	}
+out:
+	zbx_vector_hk_partition_ptr_clear_ext(&partitions, hk_partition_free);
+	zbx_vector_hk_partition_ptr_destroy(&partitions);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: prepares history housekeeping delete queues for all defined       *
@@ -508,7 +1105,16 @@ static void	hk_history_delete_queue_prepare_all(zbx_hk_history_rule_t *rules, in
 	/* prepare history item cache (hashset containing itemid:min_clock values) */
 	for (zbx_hk_history_rule_t *rule = rules; NULL != rule->table; rule++)
 	{
-		if (ZBX_HK_MODE_REGULAR == *rule->poption_mode)
+		rule->native_partitions = 0;
+		rule->history_max = -1;
+		rule->history_invalid = 0;
+
+		if (ZBX_HK_MODE_REGULAR == *rule->poption_mode && SUCCEED == hk_partitions_check(rule->table))
+			rule->native_partitions = 1;
+
+		/* with global period override natively partitioned tables are cleaned by dropping partitions */
+		if (ZBX_HK_MODE_REGULAR == *rule->poption_mode &&
+				(0 == rule->native_partitions || ZBX_HK_OPTION_DISABLED == *rule->poption_global))
 		{
 			if (0 == rule->item_cache.num_slots)
 				hk_history_prepare(rule);
@@ -671,6 +1277,17 @@ static int	housekeeping_history_and_trends(int now)
 			goto skip;
 		}
 
+		/* Natively partitioned tables (PostgreSQL declarative or MySQL range partitioning by clock) */
+		/* have expired partitions dropped. Without global period override the per item delete queue */
+		/* is still processed for items with storage period shorter than the longest one.            */
+		if (0 != rule->native_partitions)
+		{
+			hk_history_native_partitions(rule, now);
+
+			if (ZBX_HK_OPTION_DISABLED != *rule->poption_global)
+				goto skip;
+		}
+
 #if defined(HAVE_POSTGRESQL)
 		if (0 < tsdb_version)
 		{
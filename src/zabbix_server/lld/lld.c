@@ -991,6 +991,193 @@ int	lld_validate_item_override_no_discover(const zbx_vector_lld_override_ptr_t *
 	return ZBX_PROTOTYPE_NO_DISCOVER == override_default ? FAIL : SUCCEED;
 }
 
+static void	lld_row_free(zbx_lld_row_t *lld_row);
+
+/* minimum number of LLD rows per filtering thread */
+#define LLD_ROWS_PARTITION_MIN	1000
+/* maximum number of threads used to filter LLD rows of a single rule */
+#define LLD_ROWS_THREADS_MAX	8
+
+typedef struct
+{
+	const zbx_lld_filter_t			*filter;
+	const zbx_vector_lld_macro_path_ptr_t	*lld_macro_paths;
+	const zbx_vector_lld_override_ptr_t	*overrides;
+
+	/* partition rows, rows not passing filter are freed and reset to NULL */
+	zbx_lld_row_t				**rows;
+	int					rows_num;
+
+	char					*info;
+	pthread_t				thread;
+}
+zbx_lld_rows_partition_t;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: applies filter and overrides to a partition of LLD rows           *
+ *                                                                            *
+ ******************************************************************************/
+static void	lld_rows_partition_filter(zbx_lld_rows_partition_t *partition)
+{
+	for (int i = 0; i < partition->rows_num; i++)
+	{
+		zbx_lld_row_t	*lld_row = partition->rows[i];
+
+		if (SUCCEED != filter_evaluate(partition->filter, &lld_row->jp_row, partition->lld_macro_paths,
+				&partition->info))
+		{
+			lld_row_free(lld_row);
+			partition->rows[i] = NULL;
+			continue;
+		}
+
+#define OVERRIDE_STOP_TRUE	1
+
+		for (int j = 0; j < partition->overrides->values_num; j++)
+		{
+			zbx_lld_override_t	*override = partition->overrides->values[j];
+
+			if (SUCCEED != filter_evaluate(&override->filter, &lld_row->jp_row, partition->lld_macro_paths,
+					&partition->info))
+			{
+				continue;
+			}
+
+			zbx_vector_lld_override_ptr_append(&lld_row->overrides, override);
+
+			if (OVERRIDE_STOP_TRUE == override->stop)
+				break;
+		}
+
+#undef OVERRIDE_STOP_TRUE
+	}
+}
+
+static void	*lld_rows_partition_entry(void *args)
+{
+	sigset_t	mask;
+
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGTERM);
+	sigaddset(&mask, SIGUSR1);
+	sigaddset(&mask, SIGUSR2);
+	sigaddset(&mask, SIGHUP);
+	sigaddset(&mask, SIGQUIT);
+	sigaddset(&mask, SIGINT);
+
+	(void)pthread_sigmask(SIG_BLOCK, &mask, NULL);
+
+	zbx_init_regexp_env();
+
+	lld_rows_partition_filter((zbx_lld_rows_partition_t *)args);
+
+	zbx_deinit_regexp_env();
+
+	return NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: applies filter and overrides to LLD rows                          *
+ *                                                                            *
+ * Parameters: rows            - [IN/OUT] LLD rows, rows not passing filter   *
+ *                                        are freed and removed               *
+ *             filter          - [IN] LLD filter                              *
+ *             lld_macro_paths - [IN] use JSON path to extract from jp_row    *
+ *             overrides       - [IN]                                         *
+ *             info            - [OUT] warning description                    *
+ *                                                                            *
+ * Comments: Large row sets are partitioned and filtered in parallel threads. *
+ *           Filtering only reads rule configuration and each thread owns its *
+ *           rows, so the results are merged in the original row order.       *
+ *                                                                            *
+ ******************************************************************************/
+static void	lld_rows_filter(zbx_vector_lld_row_ptr_t *rows, const zbx_lld_filter_t *filter,
+		const zbx_vector_lld_macro_path_ptr_t *lld_macro_paths, const zbx_vector_lld_override_ptr_t *overrides,
+		char **info)
+{
+	zbx_lld_rows_partition_t	partitions[LLD_ROWS_THREADS_MAX];
+	int				partitions_num, rows_per_partition, offset = 0, threads_num = 0, i, err;
+	pthread_attr_t			attr;
+
+	if (0 == rows->values_num || (0 == filter->conditions.values_num && 0 == overrides->values_num))
+		return;
+
+	partitions_num = MIN(rows->values_num / LLD_ROWS_PARTITION_MIN, LLD_ROWS_THREADS_MAX);
+
+	if (1 > partitions_num)
+		partitions_num = 1;
+
+	rows_per_partition = (rows->values_num + partitions_num - 1) / partitions_num;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() rows:%d partitions:%d", __func__, rows->values_num, partitions_num);
+
+	for (i = 0; i < partitions_num; i++)
+	{
+		partitions[i].filter = filter;
+		partitions[i].lld_macro_paths = lld_macro_paths;
+		partitions[i].overrides = overrides;
+		partitions[i].rows = rows->values + offset;
+		partitions[i].rows_num = MIN(rows_per_partition, rows->values_num - offset);
+		partitions[i].info = NULL;
+
+		offset += partitions[i].rows_num;
+	}
+
+	if (1 < partitions_num)
+	{
+		zbx_pthread_init_attr(&attr);
+
+		/* the first partition is processed by the calling thread */
+		for (threads_num = 1; threads_num < partitions_num; threads_num++)
+		{
+			if (0 != (err = pthread_create(&partitions[threads_num].thread, &attr, lld_rows_partition_entry,
+					&partitions[threads_num])))
+			{
+				zabbix_log(LOG_LEVEL_WARNING, "cannot create LLD filtering thread: %s",
+						zbx_strerror(err));
+				break;
+			}
+		}
+
+		pthread_attr_destroy(&attr);
+	}
+	else
+		threads_num = 1;
+
+	lld_rows_partition_filter(&partitions[0]);
+
+	/* partitions without threads are processed sequentially */
+	for (i = threads_num; i < partitions_num; i++)
+		lld_rows_partition_filter(&partitions[i]);
+
+	for (i = 1; i < threads_num; i++)
+		pthread_join(partitions[i].thread, NULL);
+
+	for (i = 0; i < partitions_num; i++)
+	{
+		if (NULL != partitions[i].info)
+		{
+			*info = zbx_strdcat(*info, partitions[i].info);
+			zbx_free(partitions[i].info);
+		}
+	}
+
+	for (i = 0, offset = 0; i < rows->values_num; i++)
+	{
+		if (NULL != rows->values[i])
+			rows->values[offset++] = rows->values[i];
+	}
+
+	rows->values_num = offset;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() rows:%d", __func__, rows->values_num);
+}
+
+#undef LLD_ROWS_PARTITION_MIN
+#undef LLD_ROWS_THREADS_MAX
+
 static int	lld_rows_get(const char *value, zbx_lld_filter_t *filter, zbx_vector_lld_row_ptr_t *lld_rows,
 		const zbx_vector_lld_macro_path_ptr_t *lld_macro_paths, const zbx_vector_lld_override_ptr_t *overrides,
 		char **info, char **error)
@@ -1025,34 +1212,16 @@ static int	lld_rows_get(const char *value, zbx_lld_filter_t *filter, zbx_vector_
 		if (FAIL == zbx_json_brackets_open(p, &jp_row))
 			continue;
 
-		if (SUCCEED != filter_evaluate(filter, &jp_row, lld_macro_paths, info))
-			continue;
-
 		lld_row = (zbx_lld_row_t *)zbx_malloc(NULL, sizeof(zbx_lld_row_t));
 		zbx_vector_lld_row_ptr_append(lld_rows, lld_row);
 
 		lld_row->jp_row = jp_row;
 		zbx_vector_lld_item_link_ptr_create(&lld_row->item_links);
 		zbx_vector_lld_override_ptr_create(&lld_row->overrides);
-
-#define OVERRIDE_STOP_TRUE	1
-
-		for (int i = 0; i < overrides->values_num; i++)
-		{
-			zbx_lld_override_t	*override = overrides->values[i];
-
-			if (SUCCEED != filter_evaluate(&override->filter, &jp_row, lld_macro_paths, info))
-				continue;
-
-			zbx_vector_lld_override_ptr_append(&lld_row->overrides, override);
-
-			if (OVERRIDE_STOP_TRUE == override->stop)
-				break;
-		}
-
-#undef OVERRIDE_STOP_TRUE
 	}
 
+	lld_rows_filter(lld_rows, filter, lld_macro_paths, overrides, info);
+
 	ret = SUCCEED;
 out:
 	if (SUCCEED == ZBX_CHECK_LOG_LEVEL(LOG_LEVEL_TRACE))
@@ -1100,9 +1269,11 @@ static void	lld_row_free(zbx_lld_row_t *lld_row)
  *             error      - [OUT] Error or informational message. Will be set *
  *                               to empty string on successful discovery      *
  *                               without additional information.              *
+ *             timings    - [OUT] time spent in processing phases             *
  *                                                                            *
  ******************************************************************************/
-int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char **error)
+int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char **error,
+		zbx_lld_timings_t *timings)
 {
 #define LIFETIME_DURATION_GET(lt, lt_str)									\
 	do													\
@@ -1141,9 +1312,12 @@ int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char
 	zbx_dc_um_handle_t		*um_handle;
 	zbx_vector_lld_override_ptr_t	overrides;
 	zbx_vector_lld_row_ptr_t	lld_rows;
+	double				time_start;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() itemid:" ZBX_FS_UI64, __func__, lld_ruleid);
 
+	memset(timings, 0, sizeof(zbx_lld_timings_t));
+
 	um_handle = zbx_dc_open_user_macros();
 
 	zbx_vector_lld_row_ptr_create(&lld_rows);
@@ -1203,12 +1377,16 @@ int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char
 	if (SUCCEED != (ret = lld_overrides_load(&overrides, lld_ruleid, &item, error)))
 		goto out;
 
+	time_start = zbx_time();
+
 	if (SUCCEED != lld_rows_get(value, &filter, &lld_rows, &lld_macro_paths, &overrides, &info, error))
 	{
 		ret = FAIL;
 		goto out;
 	}
 
+	timings->phases[ZBX_LLD_PHASE_ROWS] = zbx_time() - time_start;
+
 	*error = zbx_strdup(*error, "");
 
 	now = time(NULL);
@@ -1216,6 +1394,8 @@ int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char
 	zbx_config_get(&cfg, ZBX_CONFIG_FLAGS_AUDITLOG_ENABLED | ZBX_CONFIG_FLAGS_AUDITLOG_MODE);
 	zbx_audit_init(cfg.auditlog_enabled, cfg.auditlog_mode, ZBX_AUDIT_LLD_CONTEXT);
 
+	time_start = zbx_time();
+
 	if (SUCCEED != lld_update_items(hostid, lld_ruleid, &lld_rows, &lld_macro_paths, error, &lifetime,
 			&enabled_lifetime, now))
 	{
@@ -1226,6 +1406,9 @@ int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char
 
 	lld_item_links_sort(&lld_rows);
 
+	timings->phases[ZBX_LLD_PHASE_ITEMS] = zbx_time() - time_start;
+	time_start = zbx_time();
+
 	if (SUCCEED != lld_update_triggers(hostid, lld_ruleid, &lld_rows, &lld_macro_paths, error, &lifetime,
 			&enabled_lifetime, now))
 	{
@@ -1234,6 +1417,9 @@ int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char
 		goto out;
 	}
 
+	timings->phases[ZBX_LLD_PHASE_TRIGGERS] = zbx_time() - time_start;
+	time_start = zbx_time();
+
 	if (SUCCEED != lld_update_graphs(hostid, lld_ruleid, &lld_rows, &lld_macro_paths, error, &lifetime, now))
 	{
 		zabbix_log(LOG_LEVEL_DEBUG, "cannot update/add graphs because parent host was removed while"
@@ -1241,8 +1427,13 @@ int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char
 		goto out;
 	}
 
+	timings->phases[ZBX_LLD_PHASE_GRAPHS] = zbx_time() - time_start;
+	time_start = zbx_time();
+
 	lld_update_hosts(lld_ruleid, &lld_rows, &lld_macro_paths, error, &lifetime, &enabled_lifetime, now);
 
+	timings->phases[ZBX_LLD_PHASE_HOSTS] = zbx_time() - time_start;
+
 	/* add informative warning to the error message about lack of data for macros used in filter */
 	if (NULL != info)
 		*error = zbx_strdcat(*error, info);
@@ -73,6 +73,8 @@ typedef struct
 	/* the number of queued LLD rules */
 	zbx_uint64_t			queued_num;
 
+	/* the last processing timings of LLD rules, indexed by rule item id */
+	zbx_hashset_t			rule_timings;
 }
 zbx_lld_manager_t;
 
@@ -158,6 +160,8 @@ static void	lld_manager_init(zbx_lld_manager_t *manager, zbx_get_config_forks_f
 
 	manager->queued_num = 0;
 
+	zbx_hashset_create(&manager->rule_timings, 0, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
@@ -356,15 +360,65 @@ static void	lld_process_queue(zbx_lld_manager_t *manager)
 	}
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: updates last processing timings of LLD rule                       *
+ *                                                                            *
+ * Parameters: manager - [IN]                                                 *
+ *             message - [IN] worker 'done' response                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	lld_update_rule_timings(zbx_lld_manager_t *manager, const zbx_ipc_message_t *message)
+{
+	zbx_lld_rule_info_t	*rule_info, rule_info_local = {0};
+
+	if (0 == message->size)
+		return;
+
+	zbx_lld_deserialize_done(message->data, &rule_info_local.itemid, &rule_info_local.timings);
+
+	if (NULL == (rule_info = (zbx_lld_rule_info_t *)zbx_hashset_search(&manager->rule_timings,
+			&rule_info_local)))
+	{
+		rule_info = (zbx_lld_rule_info_t *)zbx_hashset_insert(&manager->rule_timings, &rule_info_local,
+				sizeof(rule_info_local));
+	}
+	else
+		rule_info->timings = rule_info_local.timings;
+
+	rule_info->lastclock = time(NULL);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: removes timings of LLD rules not processed for a day              *
+ *                                                                            *
+ ******************************************************************************/
+static void	lld_prune_rule_timings(zbx_lld_manager_t *manager, time_t now)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_lld_rule_info_t	*rule_info;
+
+	zbx_hashset_iter_reset(&manager->rule_timings, &iter);
+
+	while (NULL != (rule_info = (zbx_lld_rule_info_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (SEC_PER_DAY < now - rule_info->lastclock)
+			zbx_hashset_iter_remove(&iter);
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: processes LLD worker 'done' response                              *
  *                                                                            *
  * Parameters: manager - [IN]                                                 *
  *             client  - [IN] worker's IPC client connection                  *
+ *             message - [IN] received message                                *
  *                                                                            *
  ******************************************************************************/
-static void	lld_process_result(zbx_lld_manager_t *manager, zbx_ipc_client_t *client)
+static void	lld_process_result(zbx_lld_manager_t *manager, zbx_ipc_client_t *client,
+		const zbx_ipc_message_t *message)
 {
 	zbx_lld_worker_t	*worker;
 	zbx_lld_rule_t		*rule;
@@ -374,6 +428,8 @@ static void	lld_process_result(zbx_lld_manager_t *manager, zbx_ipc_client_t *cli
 
 	worker = lld_get_worker_by_client(manager, client);
 
+	lld_update_rule_timings(manager, message);
+
 	zabbix_log(LOG_LEVEL_DEBUG, "discovery rule:" ZBX_FS_UI64 " has been processed", worker->rule->head->itemid);
 
 	rule = worker->rule;
@@ -435,6 +491,32 @@ static int	lld_diag_item_compare_values_desc(const void *d1, const void *d2)
 	return r2->values_num - r1->values_num;
 }
 
+static double	lld_timings_total(const zbx_lld_timings_t *timings)
+{
+	double	total = 0;
+
+	for (int i = 0; i < ZBX_LLD_PHASE_COUNT; i++)
+		total += timings->phases[i];
+
+	return total;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: Sorts LLD manager cache item view by total processing time in     *
+ *          descending order.                                                 *
+ *                                                                            *
+ ******************************************************************************/
+static int	lld_diag_item_compare_time_desc(const void *d1, const void *d2)
+{
+	zbx_lld_rule_info_t	*r1 = *(zbx_lld_rule_info_t **)d1;
+	zbx_lld_rule_info_t	*r2 = *(zbx_lld_rule_info_t **)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(lld_timings_total(&r2->timings), lld_timings_total(&r1->timings));
+
+	return 0;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: processes external top items request                              *
@@ -447,17 +529,18 @@ static int	lld_diag_item_compare_values_desc(const void *d1, const void *d2)
 static void	lld_process_top_items(zbx_lld_manager_t *manager, zbx_ipc_client_t *client,
 		const zbx_ipc_message_t *message)
 {
-	int				limit;
+	int				field, limit;
 	unsigned char			*data;
 	zbx_uint32_t			data_len;
 	zbx_vector_lld_rule_info_ptr_t	view;
 	zbx_hashset_iter_t		iter;
 	zbx_hashset_t			rule_infos;
 	zbx_lld_rule_t			*rule;
+	zbx_lld_rule_info_t		*timing;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	zbx_lld_deserialize_top_items_request(message->data, &limit);
+	zbx_lld_deserialize_top_items_request(message->data, &field, &limit);
 
 	zbx_hashset_create(&rule_infos, MAX(1000, (size_t)manager->rule_index.num_data), ZBX_DEFAULT_UINT64_HASH_FUNC,
 			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
@@ -486,7 +569,30 @@ static void	lld_process_top_items(zbx_lld_manager_t *manager, zbx_ipc_client_t *
 		}
 	}
 
-	zbx_vector_lld_rule_info_ptr_sort(&view, lld_diag_item_compare_values_desc);
+	zbx_hashset_iter_reset(&manager->rule_timings, &iter);
+
+	while (NULL != (timing = (zbx_lld_rule_info_t *)zbx_hashset_iter_next(&iter)))
+	{
+		zbx_lld_rule_info_t	*rule_info, rule_info_local = {.itemid = timing->itemid};
+
+		if (NULL == (rule_info = (zbx_lld_rule_info_t *)zbx_hashset_search(&rule_infos, timing)))
+		{
+			/* rules without queued values are reported only in processing time view */
+			if (ZBX_LLD_TOP_TIME != field)
+				continue;
+
+			rule_info = (zbx_lld_rule_info_t *)zbx_hashset_insert(&rule_infos, &rule_info_local,
+					sizeof(zbx_lld_rule_info_t));
+			zbx_vector_lld_rule_info_ptr_append(&view, rule_info);
+		}
+
+		rule_info->timings = timing->timings;
+	}
+
+	if (ZBX_LLD_TOP_TIME == field)
+		zbx_vector_lld_rule_info_ptr_sort(&view, lld_diag_item_compare_time_desc);
+	else
+		zbx_vector_lld_rule_info_ptr_sort(&view, lld_diag_item_compare_values_desc);
 
 	data_len = zbx_lld_serialize_top_items_result(&data, (const zbx_lld_rule_info_t **)view.values,
 			MIN(limit, view.values_num));
@@ -513,7 +619,7 @@ ZBX_THREAD_ENTRY(lld_manager_thread, args)
 	char			*error = NULL;
 	zbx_ipc_client_t	*client;
 	zbx_ipc_message_t	*message;
-	double			time_stat, time_now, sec, time_idle = 0;
+	double			time_stat, time_now, sec, time_idle = 0, time_prune;
 	zbx_lld_manager_t	manager;
 	zbx_uint64_t		processed_num = 0;
 	zbx_timespec_t		timeout = {1, 0};
@@ -540,6 +646,7 @@ ZBX_THREAD_ENTRY(lld_manager_thread, args)
 
 	/* initialize statistics */
 	time_stat = zbx_time();
+	time_prune = time_stat;
 
 	zbx_setproctitle("%s #%d started", get_process_type_string(process_type), process_num);
 
@@ -561,6 +668,12 @@ ZBX_THREAD_ENTRY(lld_manager_thread, args)
 			processed_num = 0;
 		}
 
+		if (SEC_PER_HOUR < time_now - time_prune)
+		{
+			lld_prune_rule_timings(&manager, (time_t)time_now);
+			time_prune = time_now;
+		}
+
 		zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_IDLE);
 		ret = zbx_ipc_service_recv(&lld_service, &timeout, &client, &message);
 		zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_BUSY);
@@ -583,7 +696,7 @@ ZBX_THREAD_ENTRY(lld_manager_thread, args)
 					lld_process_queue(&manager);
 					break;
 				case ZBX_IPC_LLD_DONE:
-					lld_process_result(&manager, client);
+					lld_process_result(&manager, client, message);
 					processed_num++;
 					manager.queued_num--;
 					break;
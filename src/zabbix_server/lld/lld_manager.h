@@ -53,13 +53,33 @@ typedef struct
 }
 zbx_lld_rule_t;
 
+/* LLD rule processing phases timed by workers */
+#define ZBX_LLD_PHASE_ROWS	0	/* row parsing, filtering and override matching */
+#define ZBX_LLD_PHASE_ITEMS	1
+#define ZBX_LLD_PHASE_TRIGGERS	2
+#define ZBX_LLD_PHASE_GRAPHS	3
+#define ZBX_LLD_PHASE_HOSTS	4
+#define ZBX_LLD_PHASE_COUNT	5
+
+typedef struct
+{
+	double	phases[ZBX_LLD_PHASE_COUNT];
+}
+zbx_lld_timings_t;
+
 typedef struct
 {
 	/* the LLD rule item id */
-	zbx_uint64_t	itemid;
+	zbx_uint64_t		itemid;
 
 	/* the number of queued values */
-	int		values_num;
+	int			values_num;
+
+	/* the last processing time by phases */
+	zbx_lld_timings_t	timings;
+
+	/* the last processing timestamp */
+	time_t			lastclock;
 }
 zbx_lld_rule_info_t;
 
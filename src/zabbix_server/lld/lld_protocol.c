@@ -75,6 +75,29 @@ void	zbx_lld_deserialize_item_value(const unsigned char *data, zbx_uint64_t *ite
 	}
 }
 
+zbx_uint32_t	zbx_lld_serialize_done(unsigned char **data, zbx_uint64_t itemid, const zbx_lld_timings_t *timings)
+{
+	unsigned char	*ptr;
+	zbx_uint32_t	data_len = 0;
+
+	zbx_serialize_prepare_value(data_len, itemid);
+	zbx_serialize_prepare_value(data_len, *timings);
+
+	*data = (unsigned char *)zbx_malloc(NULL, data_len);
+
+	ptr = *data;
+	ptr += zbx_serialize_value(ptr, itemid);
+	(void)zbx_serialize_value(ptr, *timings);
+
+	return data_len;
+}
+
+void	zbx_lld_deserialize_done(const unsigned char *data, zbx_uint64_t *itemid, zbx_lld_timings_t *timings)
+{
+	data += zbx_deserialize_value(data, itemid);
+	(void)zbx_deserialize_value(data, timings);
+}
+
 zbx_uint32_t	zbx_lld_serialize_diag_stats(unsigned char **data, zbx_uint64_t items_num, zbx_uint64_t values_num)
 {
 	unsigned char	*ptr;
@@ -99,19 +122,26 @@ static void	zbx_lld_deserialize_diag_stats(const unsigned char *data, zbx_uint64
 	(void)zbx_deserialize_value(data, values_num);
 }
 
-static zbx_uint32_t	zbx_lld_serialize_top_items_request(unsigned char **data, int limit)
+static zbx_uint32_t	zbx_lld_serialize_top_items_request(unsigned char **data, int field, int limit)
 {
+	unsigned char	*ptr;
 	zbx_uint32_t	data_len = 0;
 
+	zbx_serialize_prepare_value(data_len, field);
 	zbx_serialize_prepare_value(data_len, limit);
+
 	*data = (unsigned char *)zbx_malloc(NULL, data_len);
-	(void)zbx_serialize_value(*data, limit);
+
+	ptr = *data;
+	ptr += zbx_serialize_value(ptr, field);
+	(void)zbx_serialize_value(ptr, limit);
 
 	return data_len;
 }
 
-void	zbx_lld_deserialize_top_items_request(const unsigned char *data, int *limit)
+void	zbx_lld_deserialize_top_items_request(const unsigned char *data, int *field, int *limit)
 {
+	data += zbx_deserialize_value(data, field);
 	(void)zbx_deserialize_value(data, limit);
 }
 
@@ -125,6 +155,7 @@ zbx_uint32_t	zbx_lld_serialize_top_items_result(unsigned char **data, const zbx_
 	{
 		zbx_serialize_prepare_value(item_len, rule_infos[0]->itemid);
 		zbx_serialize_prepare_value(item_len, rule_infos[0]->values_num);
+		zbx_serialize_prepare_value(item_len, rule_infos[0]->timings);
 	}
 
 	zbx_serialize_prepare_value(data_len, num);
@@ -138,12 +169,14 @@ zbx_uint32_t	zbx_lld_serialize_top_items_result(unsigned char **data, const zbx_
 	{
 		ptr += zbx_serialize_value(ptr, rule_infos[i]->itemid);
 		ptr += zbx_serialize_value(ptr, rule_infos[i]->values_num);
+		ptr += zbx_serialize_value(ptr, rule_infos[i]->timings);
 	}
 
 	return data_len;
 }
 
-static void	zbx_lld_deserialize_top_items_result(const unsigned char *data, zbx_vector_uint64_pair_t *items)
+static void	zbx_lld_deserialize_top_items_result(const unsigned char *data,
+		zbx_vector_lld_rule_info_ptr_t *rule_infos)
 {
 	int	items_num;
 
@@ -151,17 +184,19 @@ static void	zbx_lld_deserialize_top_items_result(const unsigned char *data, zbx_
 
 	if (0 != items_num)
 	{
-		zbx_vector_uint64_pair_reserve(items, items_num);
+		zbx_vector_lld_rule_info_ptr_reserve(rule_infos, items_num);
 
 		for (int i = 0; i < items_num; i++)
 		{
-			zbx_uint64_pair_t	pair;
-			int			value;
+			zbx_lld_rule_info_t	*rule_info;
+
+			rule_info = (zbx_lld_rule_info_t *)zbx_malloc(NULL, sizeof(zbx_lld_rule_info_t));
+			data += zbx_deserialize_value(data, &rule_info->itemid);
+			data += zbx_deserialize_value(data, &rule_info->values_num);
+			data += zbx_deserialize_value(data, &rule_info->timings);
+			rule_info->lastclock = 0;
 
-			data += zbx_deserialize_value(data, &pair.first);
-			data += zbx_deserialize_value(data, &value);
-			pair.second = value;
-			zbx_vector_uint64_pair_append_ptr(items, &pair);
+			zbx_vector_lld_rule_info_ptr_append(rule_infos, rule_info);
 		}
 	}
 }
@@ -306,23 +341,24 @@ int	zbx_lld_get_diag_stats(zbx_uint64_t *items_num, zbx_uint64_t *values_num, ch
 
 /******************************************************************************
  *                                                                            *
- * Purpose: gets top N items by number of queued values                       *
+ * Purpose: gets top N items by number of queued values or processing time    *
  *                                                                            *
- * Parameters limit - [IN] number of top records to retrieve                  *
- *            items - [OUT] vector of top itemid, values_num pairs            *
- *            error - [OUT] error message                                     *
+ * Parameters field      - [IN] sorting field (ZBX_LLD_TOP_*)                 *
+ *            limit      - [IN] number of top records to retrieve             *
+ *            rule_infos - [OUT] vector of top rule infos                     *
+ *            error      - [OUT] error message                                *
  *                                                                            *
  * Return value: SUCCEED - top n items were returned successfully             *
  *               FAIL - otherwise                                             *
  *                                                                            *
  ******************************************************************************/
-int	zbx_lld_get_top_items(int limit, zbx_vector_uint64_pair_t *items, char **error)
+int	zbx_lld_get_top_items(int field, int limit, zbx_vector_lld_rule_info_ptr_t *rule_infos, char **error)
 {
 	int		ret;
 	unsigned char	*data, *result;
 	zbx_uint32_t	data_len;
 
-	data_len = zbx_lld_serialize_top_items_request(&data, limit);
+	data_len = zbx_lld_serialize_top_items_request(&data, field, limit);
 
 	if (SUCCEED != (ret = zbx_ipc_async_exchange(ZBX_IPC_SERVICE_LLD, ZBX_IPC_LLD_TOP_ITEMS, SEC_PER_MIN, data,
 			data_len, &result, error)))
@@ -330,7 +366,7 @@ int	zbx_lld_get_top_items(int limit, zbx_vector_uint64_pair_t *items, char **err
 		goto out;
 	}
 
-	zbx_lld_deserialize_top_items_result(result, items);
+	zbx_lld_deserialize_top_items_result(result, rule_infos);
 	zbx_free(result);
 out:
 	zbx_free(data);
@@ -46,6 +46,10 @@
 /* manager -> process */
 #define ZBX_IPC_LLD_TOP_ITEMS_RESULT	1403
 
+/* top items sorting fields */
+#define ZBX_LLD_TOP_VALUES	0
+#define ZBX_LLD_TOP_TIME	1
+
 zbx_uint32_t	zbx_lld_serialize_item_value(unsigned char **data, zbx_uint64_t itemid, zbx_uint64_t hostid,
 		const char *value, const zbx_timespec_t *ts, unsigned char meta, zbx_uint64_t lastlogsize, int mtime,
 		const char *error);
@@ -54,9 +58,13 @@ void	zbx_lld_deserialize_item_value(const unsigned char *data, zbx_uint64_t *ite
 		char **value, zbx_timespec_t *ts, unsigned char *meta, zbx_uint64_t *lastlogsize, int *mtime,
 		char **error);
 
+zbx_uint32_t	zbx_lld_serialize_done(unsigned char **data, zbx_uint64_t itemid, const zbx_lld_timings_t *timings);
+
+void	zbx_lld_deserialize_done(const unsigned char *data, zbx_uint64_t *itemid, zbx_lld_timings_t *timings);
+
 zbx_uint32_t	zbx_lld_serialize_diag_stats(unsigned char **data, zbx_uint64_t items_num, zbx_uint64_t values_num);
 
-void	zbx_lld_deserialize_top_items_request(const unsigned char *data, int *limit);
+void	zbx_lld_deserialize_top_items_request(const unsigned char *data, int *field, int *limit);
 
 zbx_uint32_t	zbx_lld_serialize_top_items_result(unsigned char **data, const zbx_lld_rule_info_t **rule_infos,
 		int num);
@@ -71,6 +79,6 @@ int	zbx_lld_get_queue_size(zbx_uint64_t *size, char **error);
 
 int	zbx_lld_get_diag_stats(zbx_uint64_t *items_num, zbx_uint64_t *values_num, char **error);
 
-int	zbx_lld_get_top_items(int limit, zbx_vector_uint64_pair_t *items, char **error);
+int	zbx_lld_get_top_items(int field, int limit, zbx_vector_lld_rule_info_ptr_t *rule_infos, char **error);
 
 #endif
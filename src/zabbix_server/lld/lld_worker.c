@@ -29,6 +29,7 @@
 #include "zbxcacheconfig.h"
 #include "zbxdb.h"
 #include "zbxdbhigh.h"
+#include "zbxescalations.h"
 
 /******************************************************************************
  *                                                                            *
@@ -52,11 +53,13 @@ static void	lld_register_worker(zbx_ipc_socket_t *socket)
  *          cache and database.                                               *
  *                                                                            *
  * Parameters: message - [IN] message with LLD request                        *
+ *             itemid  - [OUT] processed LLD rule                             *
+ *             timings - [OUT] time spent in processing phases                *
  *                                                                            *
  ******************************************************************************/
-static void	lld_process_task(const zbx_ipc_message_t *message)
+static void	lld_process_task(const zbx_ipc_message_t *message, zbx_uint64_t *itemid, zbx_lld_timings_t *timings)
 {
-	zbx_uint64_t		itemid, hostid, lastlogsize;
+	zbx_uint64_t		hostid, lastlogsize;
 	char			*value, *error;
 	zbx_timespec_t		ts;
 	zbx_item_diff_t		diff;
@@ -66,27 +69,31 @@ static void	lld_process_task(const zbx_ipc_message_t *message)
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	zbx_lld_deserialize_item_value(message->data, &itemid, &hostid, &value, &ts, &meta, &lastlogsize, &mtime,
+	memset(timings, 0, sizeof(zbx_lld_timings_t));
+
+	zbx_lld_deserialize_item_value(message->data, itemid, &hostid, &value, &ts, &meta, &lastlogsize, &mtime,
 			&error);
 
-	zbx_dc_config_get_items_by_itemids(&item, &itemid, &errcode, 1);
+	zbx_dc_config_get_items_by_itemids(&item, itemid, &errcode, 1);
 
 	if (SUCCEED != errcode)
 		goto out;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "processing discovery rule:" ZBX_FS_UI64, itemid);
+	zabbix_log(LOG_LEVEL_DEBUG, "processing discovery rule:" ZBX_FS_UI64, *itemid);
 
 	diff.flags = ZBX_FLAGS_ITEM_DIFF_UNSET;
 
 	if (NULL != error || NULL != value)
 	{
-		if (NULL == error && SUCCEED == lld_process_discovery_rule(itemid, value, &error))
+		if (NULL == error && SUCCEED == lld_process_discovery_rule(*itemid, value, &error, timings))
 			state = ITEM_STATE_NORMAL;
 		else
 			state = ITEM_STATE_NOTSUPPORTED;
 
 		if (state != item.state)
 		{
+			zbx_vector_escalation_new_ptr_t	escalations;
+
 			diff.state = state;
 			diff.flags |= ZBX_FLAGS_ITEM_DIFF_UPDATE_STATE;
 
@@ -95,7 +102,7 @@ static void	lld_process_task(const zbx_ipc_message_t *message)
 				zabbix_log(LOG_LEVEL_WARNING, "discovery rule \"%s:%s\" became supported",
 						item.host.host, item.key_orig);
 
-				zbx_add_event(EVENT_SOURCE_INTERNAL, EVENT_OBJECT_LLDRULE, itemid, &ts,
+				zbx_add_event(EVENT_SOURCE_INTERNAL, EVENT_OBJECT_LLDRULE, *itemid, &ts,
 						ITEM_STATE_NORMAL, NULL, NULL, NULL, 0, 0, NULL, 0, NULL, 0, NULL,
 						NULL, NULL);
 			}
@@ -104,16 +111,23 @@ static void	lld_process_task(const zbx_ipc_message_t *message)
 				zabbix_log(LOG_LEVEL_WARNING, "discovery rule \"%s:%s\" became not supported: %s",
 						item.host.host, item.key_orig, error);
 
-				zbx_add_event(EVENT_SOURCE_INTERNAL, EVENT_OBJECT_LLDRULE, itemid, &ts,
+				zbx_add_event(EVENT_SOURCE_INTERNAL, EVENT_OBJECT_LLDRULE, *itemid, &ts,
 						ITEM_STATE_NOTSUPPORTED, NULL, NULL, NULL, 0, 0, NULL, 0, NULL, 0,
 						NULL, NULL, error);
 			}
 
+			zbx_vector_escalation_new_ptr_create(&escalations);
+
 			zbx_db_begin();
-			zbx_process_events(NULL, NULL, NULL);
-			zbx_db_commit();
+			zbx_process_events(NULL, NULL, &escalations);
+
+			if (ZBX_DB_OK == zbx_db_commit())
+				zbx_start_escalations(NULL, &escalations);
 
 			zbx_clean_events();
+
+			zbx_vector_escalation_new_ptr_clear_ext(&escalations, zbx_escalation_new_ptr_free);
+			zbx_vector_escalation_new_ptr_destroy(&escalations);
 		}
 
 		/* with successful LLD processing LLD error will be set to empty string */
@@ -145,7 +159,7 @@ static void	lld_process_task(const zbx_ipc_message_t *message)
 		size_t				sql_alloc = 0, sql_offset = 0;
 
 		zbx_vector_item_diff_ptr_create(&diffs);
-		diff.itemid = itemid;
+		diff.itemid = *itemid;
 		zbx_vector_item_diff_ptr_append(&diffs, &diff);
 
 		zbx_db_save_item_changes(&sql, &sql_alloc, &sql_offset, &diffs, ZBX_FLAGS_ITEM_DIFF_UPDATE_DB);
@@ -172,7 +186,10 @@ ZBX_THREAD_ENTRY(lld_worker_thread, args)
 	zbx_ipc_socket_t	lld_socket;
 	zbx_ipc_message_t	message;
 	double			time_stat, time_idle = 0, time_now, time_read;
-	zbx_uint64_t		processed_num = 0;
+	zbx_uint64_t		processed_num = 0, itemid;
+	zbx_lld_timings_t	timings;
+	unsigned char		*data;
+	zbx_uint32_t		data_len;
 	zbx_thread_info_t	*info = &((zbx_thread_args_t *)args)->info;
 	int			server_num = ((zbx_thread_args_t *)args)->info.server_num,
 				process_num = ((zbx_thread_args_t *)args)->info.process_num;
@@ -234,8 +251,10 @@ ZBX_THREAD_ENTRY(lld_worker_thread, args)
 		switch (message.code)
 		{
 			case ZBX_IPC_LLD_TASK:
-				lld_process_task(&message);
-				zbx_ipc_socket_write(&lld_socket, ZBX_IPC_LLD_DONE, NULL, 0);
+				lld_process_task(&message, &itemid, &timings);
+				data_len = zbx_lld_serialize_done(&data, itemid, &timings);
+				zbx_ipc_socket_write(&lld_socket, ZBX_IPC_LLD_DONE, data, data_len);
+				zbx_free(data);
 				processed_num++;
 				break;
 		}
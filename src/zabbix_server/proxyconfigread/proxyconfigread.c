@@ -33,6 +33,7 @@
 #include "zbxversion.h"
 #include "zbxcomms.h"
 #include "zbxipcservice.h"
+#include "zbx_proxyconfig_constants.h"
 
 typedef struct
 {
@@ -127,6 +128,286 @@ static void	get_macro_secrets(const zbx_vector_keys_path_ptr_t *keys_paths, stru
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
+/*
+ * Binary proxy configuration table data format (ZBX_PROXYCONFIG_FORMAT_BINARY):
+ *
+ *   tables  - sequence of tables terminated by table with empty name
+ *   table   - name, fields_num, field names, rows_num, fields_num columns
+ *   column  - kinds length, kinds, values length, values
+ *   kinds   - 2 bit value kind per row (ZBX_PROXYCONFIG_VALUE_*), 4 rows per byte
+ *   values  - values of rows that are not null:
+ *               number - zigzag encoded difference from the previous number of the same column
+ *               string - length, bytes
+ *
+ * All lengths and numbers are compact (7 bits per byte) unsigned integers. The
+ * table data is sent after terminating zero of the json part of configuration
+ * data.
+ */
+typedef struct
+{
+	unsigned char	type;
+	zbx_uint64_t	last;
+	unsigned char	*kinds;
+	size_t		kinds_alloc;
+	size_t		kinds_offset;
+	unsigned char	*values;
+	size_t		values_alloc;
+	size_t		values_offset;
+}
+zbx_proxyconfig_column_t;
+
+typedef struct
+{
+	struct zbx_json			*j;
+	int				format;
+
+	/* binary format table data */
+	unsigned char			*data;
+	size_t				data_alloc;
+	size_t				data_offset;
+
+	/* columns of the table being written in binary format */
+	zbx_proxyconfig_column_t	*columns;
+	int				columns_num;
+	int				columns_alloc;
+	int				column;
+	zbx_uint64_t			rows_num;
+}
+zbx_proxyconfig_writer_t;
+
+static void	proxyconfig_writer_init(zbx_proxyconfig_writer_t *writer, struct zbx_json *j, int format)
+{
+	memset(writer, 0, sizeof(zbx_proxyconfig_writer_t));
+	writer->j = j;
+	writer->format = format;
+}
+
+static void	proxyconfig_writer_clear(zbx_proxyconfig_writer_t *writer)
+{
+	for (int i = 0; i < writer->columns_alloc; i++)
+	{
+		zbx_free(writer->columns[i].kinds);
+		zbx_free(writer->columns[i].values);
+	}
+
+	zbx_free(writer->columns);
+	zbx_free(writer->data);
+}
+
+static void	proxyconfig_bin_append(unsigned char **buf, size_t *buf_alloc, size_t *buf_offset, const void *data,
+		size_t size)
+{
+	if (*buf_offset + size > *buf_alloc)
+	{
+		if (0 == *buf_alloc)
+			*buf_alloc = 256;
+
+		while (*buf_offset + size > *buf_alloc)
+			*buf_alloc *= 2;
+
+		*buf = (unsigned char *)zbx_realloc(*buf, *buf_alloc);
+	}
+
+	memcpy(*buf + *buf_offset, data, size);
+	*buf_offset += size;
+}
+
+static void	proxyconfig_bin_append_uint64(unsigned char **buf, size_t *buf_alloc, size_t *buf_offset,
+		zbx_uint64_t value)
+{
+	unsigned char	tmp[ZBX_UINT64_COMPACT_LEN_MAX];
+
+	proxyconfig_bin_append(buf, buf_alloc, buf_offset, tmp, zbx_serialize_uint64_compact(tmp, value));
+}
+
+static void	proxyconfig_bin_append_str(unsigned char **buf, size_t *buf_alloc, size_t *buf_offset, const char *str)
+{
+	size_t	len = strlen(str);
+
+	proxyconfig_bin_append_uint64(buf, buf_alloc, buf_offset, (zbx_uint64_t)len);
+	proxyconfig_bin_append(buf, buf_alloc, buf_offset, str, len);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parse value of integer or identifier field that can be encoded as *
+ *          number without changing its text representation                   *
+ *                                                                            *
+ ******************************************************************************/
+static int	proxyconfig_parse_number(unsigned char type, const char *value, zbx_uint64_t *number)
+{
+	const char	*ptr;
+
+	switch (type)
+	{
+		case ZBX_TYPE_ID:
+		case ZBX_TYPE_UINT:
+		case ZBX_TYPE_INT:
+			break;
+		default:
+			return FAIL;
+	}
+
+	if ('0' == *value)
+	{
+		if ('\0' != value[1])
+			return FAIL;
+
+		*number = 0;
+		return SUCCEED;
+	}
+
+	for (ptr = value; '\0' != *ptr; ptr++)
+	{
+		if (0 == isdigit((unsigned char)*ptr))
+			return FAIL;
+	}
+
+	if (ptr == value || ZBX_MAX_UINT64_LEN - 1 < ptr - value)
+		return FAIL;
+
+	return zbx_is_uint64(value, number);
+}
+
+static void	proxyconfig_column_add(zbx_proxyconfig_column_t *column, zbx_uint64_t row, const char *value)
+{
+	unsigned char	kind;
+	zbx_uint64_t	number;
+
+	if (NULL == value)
+	{
+		kind = ZBX_PROXYCONFIG_VALUE_NULL;
+	}
+	else if (SUCCEED == proxyconfig_parse_number(column->type, value, &number))
+	{
+		zbx_uint64_t	delta = number - column->last;
+
+		proxyconfig_bin_append_uint64(&column->values, &column->values_alloc, &column->values_offset,
+				(delta << 1) ^ (0 != (delta >> 63) ? ZBX_MAX_UINT64 : 0));
+		column->last = number;
+		kind = ZBX_PROXYCONFIG_VALUE_NUMBER;
+	}
+	else
+	{
+		proxyconfig_bin_append_str(&column->values, &column->values_alloc, &column->values_offset, value);
+		kind = ZBX_PROXYCONFIG_VALUE_STRING;
+	}
+
+	if (0 == (row & 3))
+	{
+		unsigned char	zero = 0;
+
+		proxyconfig_bin_append(&column->kinds, &column->kinds_alloc, &column->kinds_offset, &zero, 1);
+	}
+
+	column->kinds[row >> 2] |= (unsigned char)(kind << ((row & 3) << 1));
+}
+
+static void	proxyconfig_writer_table_open(zbx_proxyconfig_writer_t *writer, const zbx_db_table_t *table)
+{
+	if (ZBX_PROXYCONFIG_FORMAT_JSON == writer->format)
+	{
+		zbx_json_addobject(writer->j, table->table);
+		return;
+	}
+
+	proxyconfig_bin_append_str(&writer->data, &writer->data_alloc, &writer->data_offset, table->table);
+	writer->columns_num = 0;
+	writer->rows_num = 0;
+}
+
+static void	proxyconfig_writer_add_column(zbx_proxyconfig_writer_t *writer, const char *name, unsigned char type)
+{
+	zbx_proxyconfig_column_t	*column;
+
+	if (ZBX_PROXYCONFIG_FORMAT_JSON == writer->format)
+	{
+		zbx_json_addstring(writer->j, NULL, name, ZBX_JSON_TYPE_STRING);
+		return;
+	}
+
+	if (writer->columns_num == writer->columns_alloc)
+	{
+		writer->columns_alloc = MAX(16, writer->columns_alloc * 2);
+		writer->columns = (zbx_proxyconfig_column_t *)zbx_realloc(writer->columns,
+				sizeof(zbx_proxyconfig_column_t) * (size_t)writer->columns_alloc);
+		memset(writer->columns + writer->columns_num, 0,
+				sizeof(zbx_proxyconfig_column_t) *
+				(size_t)(writer->columns_alloc - writer->columns_num));
+	}
+
+	column = &writer->columns[writer->columns_num++];
+	column->type = type;
+	column->last = 0;
+	column->kinds_offset = 0;
+	column->values_offset = 0;
+}
+
+static void	proxyconfig_writer_rows_open(zbx_proxyconfig_writer_t *writer)
+{
+	if (ZBX_PROXYCONFIG_FORMAT_JSON == writer->format)
+		zbx_json_addarray(writer->j, ZBX_PROTO_TAG_DATA);
+}
+
+static void	proxyconfig_writer_row_open(zbx_proxyconfig_writer_t *writer)
+{
+	if (ZBX_PROXYCONFIG_FORMAT_JSON == writer->format)
+		zbx_json_addarray(writer->j, NULL);
+	else
+		writer->column = 0;
+}
+
+static void	proxyconfig_writer_row_add(zbx_proxyconfig_writer_t *writer, const char *value, zbx_json_type_t type)
+{
+	if (ZBX_PROXYCONFIG_FORMAT_JSON == writer->format)
+	{
+		zbx_json_addstring(writer->j, NULL, value, type);
+		return;
+	}
+
+	if (writer->column >= writer->columns_num)
+	{
+		THIS_SHOULD_NEVER_HAPPEN;
+		return;
+	}
+
+	proxyconfig_column_add(&writer->columns[writer->column++], writer->rows_num, value);
+}
+
+static void	proxyconfig_writer_row_close(zbx_proxyconfig_writer_t *writer)
+{
+	if (ZBX_PROXYCONFIG_FORMAT_JSON == writer->format)
+		zbx_json_close(writer->j);
+	else
+		writer->rows_num++;
+}
+
+static void	proxyconfig_writer_table_close(zbx_proxyconfig_writer_t *writer)
+{
+	if (ZBX_PROXYCONFIG_FORMAT_JSON == writer->format)
+	{
+		zbx_json_close(writer->j);
+		zbx_json_close(writer->j);
+		return;
+	}
+
+	proxyconfig_bin_append_uint64(&writer->data, &writer->data_alloc, &writer->data_offset, writer->rows_num);
+
+	for (int i = 0; i < writer->columns_num; i++)
+	{
+		zbx_proxyconfig_column_t	*column = &writer->columns[i];
+
+		proxyconfig_bin_append_uint64(&writer->data, &writer->data_alloc, &writer->data_offset,
+				(zbx_uint64_t)column->kinds_offset);
+		proxyconfig_bin_append(&writer->data, &writer->data_alloc, &writer->data_offset, column->kinds,
+				column->kinds_offset);
+		proxyconfig_bin_append_uint64(&writer->data, &writer->data_alloc, &writer->data_offset,
+				(zbx_uint64_t)column->values_offset);
+		proxyconfig_bin_append(&writer->data, &writer->data_alloc, &writer->data_offset, column->values,
+				column->values_offset);
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: adds database row to proxy config json data                       *
@@ -134,15 +415,16 @@ static void	get_macro_secrets(const zbx_vector_keys_path_ptr_t *keys_paths, stru
  * Parameters: row    - [IN] database row to add                              *
  *             table  - [IN] table configuration                              *
  *             recids - [OUT] record identifiers (optional)                   *
- *             j      - [OUT] output json                                     *
+ *             writer - [OUT] configuration data writer                       *
  *                                                                            *
  ******************************************************************************/
 static void	proxyconfig_add_row(const zbx_db_row_t row, const zbx_db_table_t *table,
-		zbx_vector_uint64_t *recids, struct zbx_json *j)
+		zbx_vector_uint64_t *recids, zbx_proxyconfig_writer_t *writer)
 {
 	int	fld = 0;
 
-	zbx_json_addstring(j, NULL, row[fld++], ZBX_JSON_TYPE_INT);
+	proxyconfig_writer_row_open(writer);
+	proxyconfig_writer_row_add(writer, row[fld++], ZBX_JSON_TYPE_INT);
 
 	if (NULL != recids)
 	{
@@ -163,39 +445,58 @@ static void	proxyconfig_add_row(const zbx_db_row_t row, const zbx_db_table_t *ta
 			case ZBX_TYPE_UINT:
 			case ZBX_TYPE_ID:
 				if (SUCCEED != zbx_db_is_null(row[fld]))
-					zbx_json_addstring(j, NULL, row[fld], ZBX_JSON_TYPE_INT);
+					proxyconfig_writer_row_add(writer, row[fld], ZBX_JSON_TYPE_INT);
 				else
-					zbx_json_addstring(j, NULL, NULL, ZBX_JSON_TYPE_NULL);
+					proxyconfig_writer_row_add(writer, NULL, ZBX_JSON_TYPE_NULL);
 				break;
 			default:
-				zbx_json_addstring(j, NULL, row[fld], ZBX_JSON_TYPE_STRING);
+				proxyconfig_writer_row_add(writer, row[fld], ZBX_JSON_TYPE_STRING);
 				break;
 		}
 		fld++;
 	}
+
+	proxyconfig_writer_row_close(writer);
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: gets table fields, adds them to output json and sql select        *
+ * Purpose: gets table fields, adds them to output data and sql select        *
  *                                                                            *
  * Parameters: sql        - [IN/OUT] sql select string                        *
  *             sql_alloc  - [IN/OUT]                                          *
  *             sql_offset - [IN/OUT]                                          *
  *             table      - [IN]                                              *
  *             alias      - [IN] table alias                                  *
- *             j          - [OUT] output json                                 *
+ *             writer     - [OUT] configuration data writer                   *
  *                                                                            *
  ******************************************************************************/
 static void	proxyconfig_get_fields(char **sql, size_t *sql_alloc, size_t *sql_offset, const zbx_db_table_t *table,
-		const char *alias, struct zbx_json *j)
+		const char *alias, zbx_proxyconfig_writer_t *writer)
 {
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
 	zbx_snprintf_alloc(sql, sql_alloc, sql_offset, "select %s%s", alias, table->recid);
 
-	zbx_json_addarray(j, "fields");
-	zbx_json_addstring(j, NULL, table->recid, ZBX_JSON_TYPE_STRING);
+	if (ZBX_PROXYCONFIG_FORMAT_JSON == writer->format)
+	{
+		zbx_json_addarray(writer->j, "fields");
+	}
+	else
+	{
+		zbx_uint64_t	fields_num = 1;
+
+		for (int i = 0; 0 != table->fields[i].name; i++)
+		{
+			if (0 != (table->fields[i].flags & ZBX_PROXY))
+				fields_num++;
+		}
+
+		proxyconfig_bin_append_uint64(&writer->data, &writer->data_alloc, &writer->data_offset, fields_num);
+		proxyconfig_bin_append_str(&writer->data, &writer->data_alloc, &writer->data_offset, table->recid);
+	}
+
+	proxyconfig_writer_add_column(writer, table->recid, ZBX_TYPE_ID);
 
 	for (int i = 0; 0 != table->fields[i].name; i++)
 	{
@@ -206,10 +507,17 @@ static void	proxyconfig_get_fields(char **sql, size_t *sql_alloc, size_t *sql_of
 		zbx_strcpy_alloc(sql, sql_alloc, sql_offset, alias);
 		zbx_strcpy_alloc(sql, sql_alloc, sql_offset, table->fields[i].name);
 
-		zbx_json_addstring(j, NULL, table->fields[i].name, ZBX_JSON_TYPE_STRING);
+		if (ZBX_PROXYCONFIG_FORMAT_BINARY == writer->format)
+		{
+			proxyconfig_bin_append_str(&writer->data, &writer->data_alloc, &writer->data_offset,
+					table->fields[i].name);
+		}
+
+		proxyconfig_writer_add_column(writer, table->fields[i].name, table->fields[i].type);
 	}
 
-	zbx_json_close(j);
+	if (ZBX_PROXYCONFIG_FORMAT_JSON == writer->format)
+		zbx_json_close(writer->j);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
@@ -223,7 +531,7 @@ static void	proxyconfig_get_fields(char **sql, size_t *sql_alloc, size_t *sql_of
  *                                         NULL for globalmacro table                 *
  *             config_vault_db_path - [IN]                                            *
  *             keys_paths           - [OUT] vault macro path/key                      *
- *             j                    - [OUT] output json                               *
+ *             writer               - [OUT] configuration data writer                 *
  *             error                - [OUT] error message                             *
  *                                                                                    *
  * Return value: SUCCEED - data was read successfully                                 *
@@ -231,8 +539,8 @@ static void	proxyconfig_get_fields(char **sql, size_t *sql_alloc, size_t *sql_of
  *                                                                                    *
  **************************************************************************************/
 static int	proxyconfig_get_macro_updates(const char *table_name, const zbx_vector_uint64_t *hostids,
-		const char *config_vault_db_path, zbx_vector_keys_path_ptr_t *keys_paths, struct zbx_json *j,
-		char **error)
+		const char *config_vault_db_path, zbx_vector_keys_path_ptr_t *keys_paths,
+		zbx_proxyconfig_writer_t *writer, char **error)
 {
 	zbx_db_result_t		result;
 	zbx_db_row_t		row;
@@ -244,12 +552,12 @@ static int	proxyconfig_get_macro_updates(const char *table_name, const zbx_vecto
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
 	table = zbx_db_get_table(table_name);
-	zbx_json_addobject(j, table->table);
+	proxyconfig_writer_table_open(writer, table);
 
 	sql = (char *)zbx_malloc(NULL, sql_alloc);
 
-	proxyconfig_get_fields(&sql, &sql_alloc, &sql_offset, table, "", j);
-	zbx_json_addarray(j, "data");
+	proxyconfig_get_fields(&sql, &sql_alloc, &sql_offset, table, "", writer);
+	proxyconfig_writer_rows_open(writer);
 
 	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " from %s", table->table);
 
@@ -285,9 +593,7 @@ static int	proxyconfig_get_macro_updates(const char *table_name, const zbx_vecto
 		char		*path, *key;
 		int		i;
 
-		zbx_json_addarray(j, NULL);
-		proxyconfig_add_row(row, table, NULL, j);
-		zbx_json_close(j);
+		proxyconfig_add_row(row, table, NULL, writer);
 
 		ZBX_STR2UCHAR(type, row[3 + offset]);
 
@@ -341,8 +647,7 @@ next:
 	}
 	zbx_db_free_result(result);
 end:
-	zbx_json_close(j);
-	zbx_json_close(j);
+	proxyconfig_writer_table_close(writer);
 
 	ret = SUCCEED;
 out:
@@ -353,7 +658,8 @@ out:
 	return ret;
 }
 
-static int	proxyconfig_get_config_table_data(const zbx_dc_proxy_t *proxy, struct zbx_json *j, char **error)
+static int	proxyconfig_get_config_table_data(const zbx_dc_proxy_t *proxy, zbx_proxyconfig_writer_t *writer,
+		char **error)
 {
 	zbx_db_result_t			result;
 	zbx_db_row_t			row;
@@ -367,12 +673,12 @@ static int	proxyconfig_get_config_table_data(const zbx_dc_proxy_t *proxy, struct
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
 	table = zbx_db_get_table("config");
-	zbx_json_addobject(j, table->table);
+	proxyconfig_writer_table_open(writer, table);
 
 	sql = (char *)zbx_malloc(NULL, sql_alloc);
-	proxyconfig_get_fields(&sql, &sql_alloc, &sql_offset, table, alias, j);
+	proxyconfig_get_fields(&sql, &sql_alloc, &sql_offset, table, alias, writer);
 
-	zbx_json_addarray(j, ZBX_PROTO_TAG_DATA);
+	proxyconfig_writer_rows_open(writer);
 
 	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " from %s%s", table->table, alias_from);
 
@@ -386,9 +692,8 @@ static int	proxyconfig_get_config_table_data(const zbx_dc_proxy_t *proxy, struct
 
 	if (NULL != (row = zbx_db_fetch(result)))
 	{
-		zbx_json_addarray(j, NULL);
-
-		zbx_json_addstring(j, NULL, row[fld++], ZBX_JSON_TYPE_INT);
+		proxyconfig_writer_row_open(writer);
+		proxyconfig_writer_row_add(writer, row[fld++], ZBX_JSON_TYPE_INT);
 
 		for (int i = 0; 0 != table->fields[i].name; i++)
 		{
@@ -450,7 +755,7 @@ static int	proxyconfig_get_config_table_data(const zbx_dc_proxy_t *proxy, struct
 					goto out;
 				}
 
-				zbx_json_addstring(j, NULL, timeout_value, ZBX_JSON_TYPE_STRING);
+				proxyconfig_writer_row_add(writer, timeout_value, ZBX_JSON_TYPE_STRING);
 
 				continue;
 			}
@@ -461,23 +766,22 @@ static int	proxyconfig_get_config_table_data(const zbx_dc_proxy_t *proxy, struct
 				case ZBX_TYPE_UINT:
 				case ZBX_TYPE_ID:
 					if (SUCCEED != zbx_db_is_null(row[fld]))
-						zbx_json_addstring(j, NULL, row[fld], ZBX_JSON_TYPE_INT);
+						proxyconfig_writer_row_add(writer, row[fld], ZBX_JSON_TYPE_INT);
 					else
-						zbx_json_addstring(j, NULL, NULL, ZBX_JSON_TYPE_NULL);
+						proxyconfig_writer_row_add(writer, NULL, ZBX_JSON_TYPE_NULL);
 					break;
 				default:
-					zbx_json_addstring(j, NULL, row[fld], ZBX_JSON_TYPE_STRING);
+					proxyconfig_writer_row_add(writer, row[fld], ZBX_JSON_TYPE_STRING);
 					break;
 			}
 
 			fld++;
 		}
 
-		zbx_json_close(j);
+		proxyconfig_writer_row_close(writer);
 	}
 
-	zbx_json_close(j);
-	zbx_json_close(j);
+	proxyconfig_writer_table_close(writer);
 
 	ret = SUCCEED;
 out:
@@ -506,7 +810,7 @@ out:
  *             filter_name - [IN] filter field name used to filter rows       *
  *                                (optional)                                  *
  *             recids      - [OUT] selected record identifiers, sorted        *
- *             j           - [OUT] output json                                *
+ *             writer      - [OUT] configuration data writer                  *
  *             error       - [OUT] error message                              *
  *                                                                            *
  * Return value: SUCCEED - data was read successfully                         *
@@ -516,7 +820,7 @@ out:
 static int	proxyconfig_get_table_data_ext(const char *table_name, const char *key_name,
 		const zbx_vector_uint64_t *key_ids, const char *condition, const char *join,
 		const zbx_hashset_t *ids_filter, const char *filter_name, zbx_vector_uint64_t *recids,
-		struct zbx_json *j, char **error)
+		zbx_proxyconfig_writer_t *writer, char **error)
 {
 	const zbx_db_table_t	*table;
 	char			*sql = NULL;
@@ -527,7 +831,7 @@ static int	proxyconfig_get_table_data_ext(const char *table_name, const char *ke
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
 	table = zbx_db_get_table(table_name);
-	zbx_json_addobject(j, table->table);
+	proxyconfig_writer_table_open(writer, table);
 
 	if (NULL != ids_filter)
 	{
@@ -545,9 +849,9 @@ static int	proxyconfig_get_table_data_ext(const char *table_name, const char *ke
 	}
 
 	sql = (char *)zbx_malloc(NULL, sql_alloc);
-	proxyconfig_get_fields(&sql, &sql_alloc, &sql_offset, table, alias, j);
+	proxyconfig_get_fields(&sql, &sql_alloc, &sql_offset, table, alias, writer);
 
-	zbx_json_addarray(j, ZBX_PROTO_TAG_DATA);
+	proxyconfig_writer_rows_open(writer);
 
 	if ((NULL == key_ids || 0 != key_ids->values_num) && (NULL == ids_filter || 0 != ids_filter->num_data))
 	{
@@ -604,15 +908,12 @@ static int	proxyconfig_get_table_data_ext(const char *table_name, const char *ke
 					continue;
 			}
 
-			zbx_json_addarray(j, NULL);
-			proxyconfig_add_row(row, table, recids, j);
-			zbx_json_close(j);
+			proxyconfig_add_row(row, table, recids, writer);
 		}
 		zbx_db_free_result(result);
 	}
 
-	zbx_json_close(j);
-	zbx_json_close(j);
+	proxyconfig_writer_table_close(writer);
 
 	if (NULL != recids)
 		zbx_vector_uint64_sort(recids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
@@ -628,10 +929,10 @@ out:
 
 static int	proxyconfig_get_table_data(const char *table_name, const char *key_name,
 		const zbx_vector_uint64_t *key_ids, const char *condition, zbx_vector_uint64_t *recids,
-		struct zbx_json *j, char **error)
+		zbx_proxyconfig_writer_t *writer, char **error)
 {
-	return proxyconfig_get_table_data_ext(table_name, key_name, key_ids, condition, NULL, NULL, NULL, recids, j,
-			error);
+	return proxyconfig_get_table_data_ext(table_name, key_name, key_ids, condition, NULL, NULL, NULL, recids,
+			writer, error);
 }
 
 typedef struct
@@ -683,15 +984,15 @@ static zbx_proxyconfig_dep_item_t	*proxyconfig_dep_item_create(zbx_uint64_t item
  *                                                                            *
  * Parameters: hostids - [IN] target host identifiers                         *
  *             items   - [IN] selected item identifiers                       *
- *             j       - [OUT] output json                                    *
+ *             writer  - [OUT] configuration data writer                      *
  *             error   - [OUT] error message                                  *
  *                                                                            *
  * Return value: SUCCEED - data was read successfully                         *
  *               FAIL    - otherwise                                          *
  *                                                                            *
  ******************************************************************************/
-static int	proxyconfig_get_item_data(const zbx_vector_uint64_t *hostids, zbx_hashset_t *items, struct zbx_json *j,
-		char **error)
+static int	proxyconfig_get_item_data(const zbx_vector_uint64_t *hostids, zbx_hashset_t *items,
+		zbx_proxyconfig_writer_t *writer, char **error)
 {
 	const zbx_db_table_t	*table;
 	char			*sql;
@@ -728,12 +1029,12 @@ static int	proxyconfig_get_item_data(const zbx_vector_uint64_t *hostids, zbx_has
 		exit(EXIT_FAILURE);
 	}
 
-	zbx_json_addobject(j, table->table);
+	proxyconfig_writer_table_open(writer, table);
 
 	sql = (char *)zbx_malloc(NULL, sql_alloc);
-	proxyconfig_get_fields(&sql, &sql_alloc, &sql_offset, table, "", j);
+	proxyconfig_get_fields(&sql, &sql_alloc, &sql_offset, table, "", writer);
 
-	zbx_json_addarray(j, ZBX_PROTO_TAG_DATA);
+	proxyconfig_writer_rows_open(writer);
 
 	if (0 != hostids->values_num)
 	{
@@ -767,9 +1068,7 @@ static int	proxyconfig_get_item_data(const zbx_vector_uint64_t *hostids, zbx_has
 
 			if (ITEM_TYPE_DEPENDENT != atoi(row[fld_type]))
 			{
-				zbx_json_addarray(j, NULL);
-				proxyconfig_add_row(row, table, NULL, j);
-				zbx_json_close(j);
+				proxyconfig_add_row(row, table, NULL, writer);
 
 				zbx_hashset_insert(items, &itemid, sizeof(itemid));
 			}
@@ -797,9 +1096,7 @@ static int	proxyconfig_get_item_data(const zbx_vector_uint64_t *hostids, zbx_has
 
 					if (NULL != zbx_hashset_search(items, &dep_item->master_itemid))
 					{
-						zbx_json_addarray(j, NULL);
-						proxyconfig_add_row(dep_item->row, table, NULL, j);
-						zbx_json_close(j);
+						proxyconfig_add_row(dep_item->row, table, NULL, writer);
 
 						zbx_hashset_insert(items, &dep_item->itemid, sizeof(zbx_uint64_t));
 						proxyconfig_dep_item_free(dep_item);
@@ -813,8 +1110,7 @@ static int	proxyconfig_get_item_data(const zbx_vector_uint64_t *hostids, zbx_has
 		}
 	}
 
-	zbx_json_close(j);
-	zbx_json_close(j);
+	proxyconfig_writer_table_close(writer);
 
 	ret = SUCCEED;
 out:
@@ -833,14 +1129,15 @@ out:
  * Purpose: gets host and related table data from database                    *
  *                                                                            *
  * Parameters: hostids    - [IN] target host identifiers                      *
- *             j          - [OUT] output json                                 *
+ *             writer     - [OUT] configuration data writer                   *
  *             error      - [OUT] error message                               *
  *                                                                            *
  * Return value: SUCCEED - data was read successfully                         *
  *               FAIL    - otherwise                                          *
  *                                                                            *
  ******************************************************************************/
-static int	proxyconfig_get_host_data(const zbx_vector_uint64_t *hostids, struct zbx_json *j, char **error)
+static int	proxyconfig_get_host_data(const zbx_vector_uint64_t *hostids, zbx_proxyconfig_writer_t *writer,
+		char **error)
 {
 	zbx_vector_uint64_t	interfaceids;
 	int			ret = FAIL;
@@ -853,22 +1150,22 @@ static int	proxyconfig_get_host_data(const zbx_vector_uint64_t *hostids, struct
 	zbx_vector_uint64_create(&interfaceids);
 	zbx_hashset_create(&items, 1000, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
-	if (SUCCEED != proxyconfig_get_table_data("hosts", "hostid", hostids, NULL, NULL, j, error))
+	if (SUCCEED != proxyconfig_get_table_data("hosts", "hostid", hostids, NULL, NULL, writer, error))
 		goto out;
 
-	if (SUCCEED != proxyconfig_get_table_data("interface",  "hostid", hostids, NULL, &interfaceids, j, error))
+	if (SUCCEED != proxyconfig_get_table_data("interface",  "hostid", hostids, NULL, &interfaceids, writer, error))
 		goto out;
 
 	if (SUCCEED != proxyconfig_get_table_data("interface_snmp",  "interfaceid", &interfaceids, NULL, NULL,
-			j, error))
+			writer, error))
 	{
 		goto out;
 	}
 
-	if (SUCCEED != proxyconfig_get_table_data("host_inventory", "hostid", hostids, NULL, NULL, j, error))
+	if (SUCCEED != proxyconfig_get_table_data("host_inventory", "hostid", hostids, NULL, NULL, writer, error))
 		goto out;
 
-	if (SUCCEED != proxyconfig_get_item_data(hostids, &items, j, error))
+	if (SUCCEED != proxyconfig_get_item_data(hostids, &items, writer, error))
 		goto out;
 
 	if (0 != items.num_data)
@@ -878,20 +1175,20 @@ static int	proxyconfig_get_host_data(const zbx_vector_uint64_t *hostids, struct
 				hostids->values_num);
 	}
 
-	if (SUCCEED != proxyconfig_get_table_data_ext("item_rtdata", NULL, NULL, NULL, sql, &items, "itemid", NULL, j,
-			error))
+	if (SUCCEED != proxyconfig_get_table_data_ext("item_rtdata", NULL, NULL, NULL, sql, &items, "itemid", NULL,
+			writer, error))
 	{
 		goto out;
 	}
 
-	if (SUCCEED != proxyconfig_get_table_data_ext("item_preproc", NULL, NULL, NULL, sql, &items, "itemid", NULL, j,
-			error))
+	if (SUCCEED != proxyconfig_get_table_data_ext("item_preproc", NULL, NULL, NULL, sql, &items, "itemid", NULL,
+			writer, error))
 	{
 		goto out;
 	}
 
 	if (SUCCEED != proxyconfig_get_table_data_ext("item_parameter", NULL, NULL, NULL, sql, &items, "itemid", NULL,
-			j, error))
+			writer, error))
 	{
 		goto out;
 	}
@@ -912,14 +1209,14 @@ out:
  * Purpose: gets discovery rule and checks data from database                 *
  *                                                                            *
  * Parameters: proxy - [IN] target proxy                                      *
- *             j     - [OUT] output json                                      *
+ *             writer - [OUT] configuration data writer                       *
  *             error - [OUT] error message                                    *
  *                                                                            *
  * Return value: SUCCEED - data was read successfully                         *
  *               FAIL    - otherwise                                          *
  *                                                                            *
  ******************************************************************************/
-static int	proxyconfig_get_drules_data(const zbx_dc_proxy_t *proxy, struct zbx_json *j, char **error)
+static int	proxyconfig_get_drules_data(const zbx_dc_proxy_t *proxy, zbx_proxyconfig_writer_t *writer, char **error)
 {
 	zbx_vector_uint64_t	druleids;
 	zbx_vector_uint64_t	proxyids;
@@ -936,13 +1233,13 @@ static int	proxyconfig_get_drules_data(const zbx_dc_proxy_t *proxy, struct zbx_j
 
 	zbx_snprintf_alloc(&filter, &filter_alloc, &filter_offset, " status=%d", DRULE_STATUS_MONITORED);
 
-	if (SUCCEED != proxyconfig_get_table_data("drules", "proxyid", &proxyids, filter, &druleids, j,
-			error))
+	if (SUCCEED != proxyconfig_get_table_data("drules", "proxyid", &proxyids, filter, &druleids,
+			writer, error))
 	{
 		goto out;
 	}
 
-	if (SUCCEED != proxyconfig_get_table_data("dchecks", "druleid", &druleids, NULL, NULL, j, error))
+	if (SUCCEED != proxyconfig_get_table_data("dchecks", "druleid", &druleids, NULL, NULL, writer, error))
 		goto out;
 
 	ret = SUCCEED;
@@ -961,14 +1258,14 @@ out:
  * Purpose: gets global regular expression (regexps/expressions) data from    *
  *          database                                                          *
  *                                                                            *
- * Parameters: j     - [OUT] output json                                      *
+ * Parameters: writer - [OUT] configuration data writer                       *
  *             error - [OUT] error message                                    *
  *                                                                            *
  * Return value: SUCCEED - data was read successfully                         *
  *               FAIL    - otherwise                                          *
  *                                                                            *
  ******************************************************************************/
-static int	proxyconfig_get_expression_data(struct zbx_json *j, char **error)
+static int	proxyconfig_get_expression_data(zbx_proxyconfig_writer_t *writer, char **error)
 {
 	zbx_vector_uint64_t	regexpids;
 	int			ret = FAIL;
@@ -977,10 +1274,10 @@ static int	proxyconfig_get_expression_data(struct zbx_json *j, char **error)
 
 	zbx_vector_uint64_create(&regexpids);
 
-	if (SUCCEED != proxyconfig_get_table_data("regexps", NULL, NULL, NULL, &regexpids, j, error))
+	if (SUCCEED != proxyconfig_get_table_data("regexps", NULL, NULL, NULL, &regexpids, writer, error))
 		goto out;
 
-	if (SUCCEED != proxyconfig_get_table_data("expressions", "regexpid", &regexpids, NULL, NULL, j, error))
+	if (SUCCEED != proxyconfig_get_table_data("expressions", "regexpid", &regexpids, NULL, NULL, writer, error))
 		goto out;
 
 	ret = SUCCEED;
@@ -997,14 +1294,15 @@ out:
  * Purpose: gets httptest and related data from database                      *
  *                                                                            *
  * Parameters: httptestids - [IN] httptest identifiers                        *
- *             j           - [OUT] output json                                *
+ *             writer      - [OUT] configuration data writer                  *
  *             error       - [OUT] error message                              *
  *                                                                            *
  * Return value: SUCCEED - data was read successfully                         *
  *               FAIL    - otherwise                                          *
  *                                                                            *
  ******************************************************************************/
-static int	proxyconfig_get_httptest_data(const zbx_vector_uint64_t *httptestids, struct zbx_json *j, char **error)
+static int	proxyconfig_get_httptest_data(const zbx_vector_uint64_t *httptestids, zbx_proxyconfig_writer_t *writer,
+		char **error)
 {
 	zbx_vector_uint64_t	httpstepids;
 	int			ret = FAIL;
@@ -1013,23 +1311,35 @@ static int	proxyconfig_get_httptest_data(const zbx_vector_uint64_t *httptestids,
 
 	zbx_vector_uint64_create(&httpstepids);
 
-	if (SUCCEED != proxyconfig_get_table_data("httptest", "httptestid", httptestids, NULL, NULL, j, error))
+	if (SUCCEED != proxyconfig_get_table_data("httptest", "httptestid", httptestids, NULL, NULL, writer, error))
 		goto out;
 
-	if (SUCCEED != proxyconfig_get_table_data("httptestitem", "httptestid", httptestids, NULL, NULL, j, error))
+	if (SUCCEED != proxyconfig_get_table_data("httptestitem", "httptestid", httptestids, NULL, NULL, writer, error))
 		goto out;
 
-	if (SUCCEED != proxyconfig_get_table_data("httptest_field", "httptestid", httptestids, NULL, NULL, j, error))
+	if (SUCCEED != proxyconfig_get_table_data("httptest_field", "httptestid", httptestids, NULL, NULL,
+			writer, error))
+	{
 		goto out;
+	}
 
-	if (SUCCEED != proxyconfig_get_table_data("httpstep", "httptestid", httptestids, NULL, &httpstepids, j, error))
+	if (SUCCEED != proxyconfig_get_table_data("httpstep", "httptestid", httptestids, NULL, &httpstepids,
+			writer, error))
+	{
 		goto out;
+	}
 
-	if (SUCCEED != proxyconfig_get_table_data("httpstepitem", "httpstepid", &httpstepids, NULL, NULL, j, error))
+	if (SUCCEED != proxyconfig_get_table_data("httpstepitem", "httpstepid", &httpstepids, NULL, NULL,
+			writer, error))
+	{
 		goto out;
+	}
 
-	if (SUCCEED != proxyconfig_get_table_data("httpstep_field", "httpstepid", &httpstepids, NULL, NULL, j, error))
+	if (SUCCEED != proxyconfig_get_table_data("httpstep_field", "httpstepid", &httpstepids, NULL, NULL,
+			writer, error))
+	{
 		goto out;
+	}
 
 	ret = SUCCEED;
 out:
@@ -1132,12 +1442,12 @@ static void	proxyconfig_get_proxy_group_updates(const zbx_dc_proxy_t *proxy, zbx
  *                                                                            *
  * Parameters: proxy            - [IN] syncing proxy                          *
  *             revision         - [IN] host mapping revision                  *
- *             j                - [OUT] output json                           *
+ *             writer           - [OUT] configuration data writer             *
  *             error            - [OUT] error message                         *
  *                                                                            *
  ******************************************************************************/
-static int	proxyconfig_get_hostmap(const zbx_dc_proxy_t *proxy, zbx_uint64_t revision, struct zbx_json *j,
-		char **error)
+static int	proxyconfig_get_hostmap(const zbx_dc_proxy_t *proxy, zbx_uint64_t revision,
+		zbx_proxyconfig_writer_t *writer, char **error)
 {
 	char			*sql = NULL;
 	size_t			sql_alloc = 0, sql_offset = 0;
@@ -1147,9 +1457,9 @@ static int	proxyconfig_get_hostmap(const zbx_dc_proxy_t *proxy, zbx_uint64_t rev
 	int			ret = FAIL;
 
 	table = zbx_db_get_table("host_proxy");
-	zbx_json_addobject(j, table->table);
+	proxyconfig_writer_table_open(writer, table);
 
-	proxyconfig_get_fields(&sql, &sql_alloc, &sql_offset, table, "", j);
+	proxyconfig_get_fields(&sql, &sql_alloc, &sql_offset, table, "", writer);
 	sql_offset = 0;
 
 	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
@@ -1172,18 +1482,15 @@ static int	proxyconfig_get_hostmap(const zbx_dc_proxy_t *proxy, zbx_uint64_t rev
 		goto out;
 	}
 
-	zbx_json_addarray(j, ZBX_PROTO_TAG_DATA);
+	proxyconfig_writer_rows_open(writer);
 
 	while (NULL != (row = zbx_db_fetch(result)))
 	{
-		zbx_json_addarray(j, NULL);
-		proxyconfig_add_row(row, table, NULL, j);
-		zbx_json_close(j);
+		proxyconfig_add_row(row, table, NULL, writer);
 	}
 	zbx_db_free_result(result);
 
-	zbx_json_close(j);
-	zbx_json_close(j);
+	proxyconfig_writer_table_close(writer);
 
 	ret = SUCCEED;
 out:
@@ -1197,7 +1504,8 @@ static int	proxyconfig_get_tables(zbx_dc_proxy_t *proxy, zbx_uint64_t proxy_conf
 		zbx_uint64_t hostmap_revision, const char *failover_delay, const zbx_vector_uint64_t *del_hostproxyids,
 		const zbx_config_vault_t *config_vault, const char *config_source_ip,
 		const char *config_ssl_ca_location, const char *config_ssl_cert_location,
-		const char *config_ssl_key_location, struct zbx_json *j, zbx_proxyconfig_status_t *status, char **error)
+		const char *config_ssl_key_location, zbx_proxyconfig_writer_t *writer, zbx_proxyconfig_status_t *status,
+		char **error)
 {
 #define ZBX_PROXYCONFIG_SYNC_HOSTS		0x0001
 #define ZBX_PROXYCONFIG_SYNC_GMACROS		0x0002
@@ -1221,6 +1529,7 @@ static int	proxyconfig_get_tables(zbx_dc_proxy_t *proxy, zbx_uint64_t proxy_conf
 	zbx_vector_keys_path_ptr_t	keys_paths;
 	int				global_macros = FAIL, ret = FAIL;
 	zbx_uint64_t			flags = 0, proxy_group_revision = 0;
+	struct zbx_json			*j = writer->j;
 
 	zbx_vector_uint64_create(&hostids);
 	zbx_vector_uint64_create(&updated_hostids);
@@ -1290,21 +1599,22 @@ static int	proxyconfig_get_tables(zbx_dc_proxy_t *proxy, zbx_uint64_t proxy_conf
 	if (ZBX_PROXY_SYNC_NONE != hostmap_sync && 0 != proxy->proxy_groupid)
 		flags |= ZBX_PROXYCONFIG_SYNC_PROXY_LIST | ZBX_PROXYCONFIG_SYNC_HOSTMAP;
 
-	zbx_json_addobject(j, ZBX_PROTO_TAG_DATA);
+	if (ZBX_PROXYCONFIG_FORMAT_JSON == writer->format)
+		zbx_json_addobject(j, ZBX_PROTO_TAG_DATA);
 
 	if (0 != flags)
 	{
 		zbx_db_begin();
 
 		if (0 != (flags & ZBX_PROXYCONFIG_SYNC_HOSTS) &&
-				SUCCEED != proxyconfig_get_host_data(&updated_hostids, j, error))
+				SUCCEED != proxyconfig_get_host_data(&updated_hostids, writer, error))
 		{
 			goto out;
 		}
 
 		if (0 != (flags & ZBX_PROXYCONFIG_SYNC_GMACROS) && SUCCEED !=
 				proxyconfig_get_macro_updates("globalmacro", NULL, config_vault->db_path, &keys_paths,
-				j, error))
+				writer, error))
 		{
 			goto out;
 		}
@@ -1312,45 +1622,45 @@ static int	proxyconfig_get_tables(zbx_dc_proxy_t *proxy, zbx_uint64_t proxy_conf
 		if (0 != (flags & ZBX_PROXYCONFIG_SYNC_HMACROS))
 		{
 			if (SUCCEED != proxyconfig_get_table_data("hosts_templates", "hostid", &macro_hostids, NULL,
-					NULL, j, error))
+					NULL, writer, error))
 			{
 				goto out;
 			}
 
 			if (SUCCEED != proxyconfig_get_macro_updates("hostmacro", &macro_hostids, config_vault->db_path,
-					&keys_paths, j, error))
+					&keys_paths, writer, error))
 			{
 				goto out;
 			}
 		}
 
 		if (0 != (flags & ZBX_PROXYCONFIG_SYNC_DRULES) &&
-				SUCCEED != proxyconfig_get_drules_data(proxy, j, error))
+				SUCCEED != proxyconfig_get_drules_data(proxy, writer, error))
 		{
 			goto out;
 		}
 
 		if (0 != (flags & ZBX_PROXYCONFIG_SYNC_EXPRESSIONS) &&
-				SUCCEED != proxyconfig_get_expression_data(j, error))
+				SUCCEED != proxyconfig_get_expression_data(writer, error))
 		{
 			goto out;
 		}
 
 		if (0 != (flags & ZBX_PROXYCONFIG_SYNC_CONFIG) &&
-				SUCCEED != proxyconfig_get_config_table_data(proxy, j, error))
+				SUCCEED != proxyconfig_get_config_table_data(proxy, writer, error))
 		{
 			goto out;
 		}
 
 		if (0 != (flags & ZBX_PROXYCONFIG_SYNC_HTTPTESTS) &&
-				SUCCEED != proxyconfig_get_httptest_data(&httptestids, j, error))
+				SUCCEED != proxyconfig_get_httptest_data(&httptestids, writer, error))
 		{
 			goto out;
 		}
 
 		if (0 != (flags & ZBX_PROXYCONFIG_SYNC_AUTOREG) &&
-				SUCCEED != proxyconfig_get_table_data("config_autoreg_tls", NULL, NULL, NULL, NULL, j,
-						error))
+				SUCCEED != proxyconfig_get_table_data("config_autoreg_tls", NULL, NULL, NULL, NULL,
+						writer, error))
 		{
 			goto out;
 		}
@@ -1363,7 +1673,7 @@ static int	proxyconfig_get_tables(zbx_dc_proxy_t *proxy, zbx_uint64_t proxy_conf
 			zbx_vector_uint64_append(&proxy_groupids, proxy->proxy_groupid);
 
 			if (SUCCEED != proxyconfig_get_table_data("proxy", "proxy_groupid", &proxy_groupids,
-					NULL, NULL, j, error))
+					NULL, NULL, writer, error))
 			{
 				zbx_vector_uint64_destroy(&proxy_groupids);
 				goto out;
@@ -1378,12 +1688,21 @@ static int	proxyconfig_get_tables(zbx_dc_proxy_t *proxy, zbx_uint64_t proxy_conf
 
 			rev = (ZBX_PROXY_SYNC_FULL == hostmap_sync ? 0 : proxy_hostmap_revision);
 
-			if (FAIL == proxyconfig_get_hostmap(proxy, rev, j, error))
+			if (FAIL == proxyconfig_get_hostmap(proxy, rev, writer, error))
 				goto out;
 		}
 	}
 
-	zbx_json_close(j);
+	if (ZBX_PROXYCONFIG_FORMAT_JSON == writer->format)
+	{
+		zbx_json_close(j);
+	}
+	else
+	{
+		/* terminate table list with empty table name */
+		proxyconfig_bin_append_uint64(&writer->data, &writer->data_alloc, &writer->data_offset, 0);
+		zbx_json_addint64(j, ZBX_PROTO_TAG_CONFIG_FORMAT, writer->format);
+	}
 
 	if (0 != proxy->proxy_groupid)
 	{
@@ -1470,23 +1789,41 @@ out:
  *                                                                            *
  * Purpose: prepares proxy configuration data                                 *
  *                                                                            *
+ * Comments: When proxy requests binary configuration format the table data   *
+ *           is returned in data buffer (must be freed by caller) instead of  *
+ *           configuration json.                                              *
+ *                                                                            *
  ******************************************************************************/
 int	zbx_proxyconfig_get_data(zbx_dc_proxy_t *proxy, const struct zbx_json_parse *jp_request, struct zbx_json *j,
-		zbx_proxyconfig_status_t *status, const zbx_config_vault_t *config_vault,
-		const char *config_source_ip, const char *config_ssl_ca_location, const char *config_ssl_cert_location,
+		unsigned char **data, size_t *data_size, zbx_proxyconfig_status_t *status,
+		const zbx_config_vault_t *config_vault, const char *config_source_ip,
+		const char *config_ssl_ca_location, const char *config_ssl_cert_location,
 		const char *config_ssl_key_location, char **error)
 {
-	int			ret = FAIL;
-	char			token[ZBX_SESSION_TOKEN_SIZE + 1], tmp[ZBX_MAX_UINT64_LEN + 1], *failover_delay = NULL;
-	zbx_uint64_t		proxy_config_revision, proxy_hostmap_revision, hostmap_revision;
-	zbx_dc_revision_t	dc_revision;
-	zbx_vector_uint64_t	del_hostproxyids;
-	unsigned char		hostmap_sync;
+	int				ret = FAIL, format = ZBX_PROXYCONFIG_FORMAT_JSON;
+	char				token[ZBX_SESSION_TOKEN_SIZE + 1], tmp[ZBX_MAX_UINT64_LEN + 1],
+					*failover_delay = NULL;
+	zbx_uint64_t			proxy_config_revision, proxy_hostmap_revision, hostmap_revision;
+	zbx_dc_revision_t		dc_revision;
+	zbx_vector_uint64_t		del_hostproxyids;
+	unsigned char			hostmap_sync;
+	zbx_proxyconfig_writer_t	writer;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() proxyid:" ZBX_FS_UI64, __func__, proxy->proxyid);
 
+	*data = NULL;
+	*data_size = 0;
+
 	zbx_vector_uint64_create(&del_hostproxyids);
 
+	if (SUCCEED == zbx_json_value_by_name(jp_request, ZBX_PROTO_TAG_CONFIG_FORMAT, tmp, sizeof(tmp), NULL) &&
+			SUCCEED == zbx_is_uint31(tmp, &format))
+	{
+		format = MIN(format, ZBX_PROXYCONFIG_FORMAT_CURRENT);
+	}
+
+	proxyconfig_writer_init(&writer, j, format);
+
 	if (SUCCEED != zbx_json_value_by_name(jp_request, ZBX_PROTO_TAG_SESSION, token, sizeof(token), NULL))
 	{
 		*error = zbx_strdup(NULL, "cannot get session from proxy configuration request");
@@ -1544,7 +1881,7 @@ int	zbx_proxyconfig_get_data(zbx_dc_proxy_t *proxy, const struct zbx_json_parse
 		if (SUCCEED != (ret = proxyconfig_get_tables(proxy, proxy_config_revision, &dc_revision,
 				hostmap_sync, proxy_hostmap_revision, hostmap_revision, failover_delay,
 				&del_hostproxyids, config_vault, config_source_ip, config_ssl_ca_location,
-				config_ssl_cert_location, config_ssl_key_location, j, status, error)))
+				config_ssl_cert_location, config_ssl_key_location, &writer, status, error)))
 		{
 			goto out;
 		}
@@ -1552,6 +1889,13 @@ int	zbx_proxyconfig_get_data(zbx_dc_proxy_t *proxy, const struct zbx_json_parse
 		zbx_json_adduint64(j, ZBX_PROTO_TAG_CONFIG_REVISION, dc_revision.config);
 
 		zabbix_log(LOG_LEVEL_TRACE, "%s() configuration: %s", __func__, j->buffer);
+
+		if (ZBX_PROXYCONFIG_FORMAT_JSON != writer.format)
+		{
+			*data = writer.data;
+			*data_size = writer.data_offset;
+			writer.data = NULL;
+		}
 	}
 	else
 	{
@@ -1559,6 +1903,7 @@ int	zbx_proxyconfig_get_data(zbx_dc_proxy_t *proxy, const struct zbx_json_parse
 		ret = SUCCEED;
 	}
 out:
+	proxyconfig_writer_clear(&writer);
 	zbx_vector_uint64_destroy(&del_hostproxyids);
 
 	zbx_free(failover_delay);
@@ -1568,6 +1913,53 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compresses proxy configuration data for sending                   *
+ *                                                                            *
+ * Parameters: j           - [IN] configuration data json                     *
+ *             data        - [IN] binary table data (optional)                *
+ *             data_size   - [IN] binary table data size                      *
+ *             buffer      - [OUT] compressed data                            *
+ *             buffer_size - [OUT] compressed data size                       *
+ *             reserved    - [OUT] uncompressed data size                     *
+ *                                                                            *
+ * Return value: SUCCEED - data was compressed successfully                   *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: Binary table data is sent after terminating zero of json.        *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_proxyconfig_pack(const struct zbx_json *j, const unsigned char *data, size_t data_size, char **buffer,
+		size_t *buffer_size, size_t *reserved)
+{
+	int	ret;
+
+	if (NULL == data)
+	{
+		ret = zbx_compress(j->buffer, j->buffer_size, buffer, buffer_size);
+		*reserved = j->buffer_size;
+	}
+	else
+	{
+		char	*payload;
+
+		*reserved = j->buffer_size + 1 + data_size;
+		payload = (char *)zbx_malloc(NULL, *reserved);
+		memcpy(payload, j->buffer, j->buffer_size);
+		payload[j->buffer_size] = '\0';
+		memcpy(payload + j->buffer_size + 1, data, data_size);
+
+		ret = zbx_compress(payload, *reserved, buffer, buffer_size);
+		zbx_free(payload);
+	}
+
+	if (SUCCEED != ret)
+		zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
+
+	return ret;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: sends configuration tables to proxy from server                   *
@@ -1580,10 +1972,11 @@ void	zbx_send_proxyconfig(zbx_socket_t *sock, const struct zbx_json_parse *jp,
 		const char *config_ssl_key_location)
 {
 	char				*error = NULL, *buffer = NULL, *version_str = NULL;
+	unsigned char			*data = NULL;
 	struct zbx_json			j;
 	zbx_dc_proxy_t			proxy;
 	int				ret, flags = ZBX_TCP_PROTOCOL, loglevel, version_int;
-	size_t				buffer_size, reserved = 0;
+	size_t				buffer_size, reserved = 0, data_size;
 	zbx_proxyconfig_status_t	status = ZBX_PROXYCONFIG_STATUS_DATA;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
@@ -1620,8 +2013,9 @@ void	zbx_send_proxyconfig(zbx_socket_t *sock, const struct zbx_json_parse *jp,
 
 	zbx_json_init(&j, ZBX_JSON_STAT_BUF_LEN);
 
-	if (SUCCEED != zbx_proxyconfig_get_data(&proxy, jp, &j, &status, config_vault, config_source_ip,
-			config_ssl_ca_location, config_ssl_cert_location, config_ssl_key_location, &error))
+	if (SUCCEED != zbx_proxyconfig_get_data(&proxy, jp, &j, &data, &data_size, &status, config_vault,
+			config_source_ip, config_ssl_ca_location, config_ssl_cert_location, config_ssl_key_location,
+			&error))
 	{
 		(void)zbx_send_response_ext(sock, FAIL, error, NULL, flags, config_timeout);
 		zabbix_log(LOG_LEVEL_WARNING, "cannot collect configuration data for proxy \"%s\" at \"%s\": %s",
@@ -1631,15 +2025,11 @@ void	zbx_send_proxyconfig(zbx_socket_t *sock, const struct zbx_json_parse *jp,
 
 	loglevel = (ZBX_PROXYCONFIG_STATUS_DATA == status ? LOG_LEVEL_WARNING : LOG_LEVEL_DEBUG);
 
-	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
-	{
-		zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
+	if (SUCCEED != zbx_proxyconfig_pack(&j, data, data_size, &buffer, &buffer_size, &reserved))
 		goto clean;
-	}
-
-	reserved = j.buffer_size;
 
 	zbx_json_free(&j);	/* json buffer can be large, free as fast as possible */
+	zbx_free(data);
 
 	zabbix_log(loglevel, "sending configuration data to proxy \"%s\" at \"%s\", datalen "
 			ZBX_FS_SIZE_T ", bytes " ZBX_FS_SIZE_T " with compression ratio %.1f", proxy.name,
@@ -1659,6 +2049,7 @@ clean:
 out:
 	zbx_free(error);
 	zbx_free(buffer);
+	zbx_free(data);
 	zbx_free(version_str);
 #ifdef	HAVE_MALLOC_TRIM
 	/* avoid memory not being released back to the system if large proxy configuration is retrieved from database */
@@ -27,10 +27,14 @@ typedef enum {
 zbx_proxyconfig_status_t;
 
 int	zbx_proxyconfig_get_data(zbx_dc_proxy_t *proxy, const struct zbx_json_parse *jp_request, struct zbx_json *j,
-		zbx_proxyconfig_status_t *status, const zbx_config_vault_t *config_vault, const char *config_source_ip,
+		unsigned char **data, size_t *data_size, zbx_proxyconfig_status_t *status,
+		const zbx_config_vault_t *config_vault, const char *config_source_ip,
 		const char *config_ssl_ca_location, const char *config_ssl_cert_location,
 		const char *config_ssl_key_location, char **error);
 
+int	zbx_proxyconfig_pack(const struct zbx_json *j, const unsigned char *data, size_t data_size, char **buffer,
+		size_t *buffer_size, size_t *reserved);
+
 void	zbx_send_proxyconfig(zbx_socket_t *sock, const struct zbx_json_parse *jp,
 		const zbx_config_vault_t *config_vault, int config_timeout, int config_trapper_timeout,
 		const char *config_source_ip, const char *config_ssl_ca_location, const char *config_ssl_cert_location,
@@ -259,11 +259,12 @@ static int	proxy_send_configuration(zbx_dc_proxy_t *proxy, const zbx_config_vaul
 		const char *config_ssl_cert_location, const char *config_ssl_key_location)
 {
 	char				*error = NULL, *buffer = NULL;
+	unsigned char			*data = NULL;
 	int				ret, flags = ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS, loglevel;
 	zbx_socket_t			s;
 	struct zbx_json			j;
 	struct zbx_json_parse		jp;
-	size_t				buffer_size, reserved = 0;
+	size_t				buffer_size, reserved = 0, data_size;
 	zbx_proxyconfig_status_t	status = ZBX_PROXYCONFIG_STATUS_DATA;
 
 
@@ -292,23 +293,20 @@ static int	proxy_send_configuration(zbx_dc_proxy_t *proxy, const zbx_config_vaul
 
 	zbx_json_clean(&j);
 
-	if (SUCCEED != (ret = zbx_proxyconfig_get_data(proxy, &jp, &j, &status, config_vault, config_source_ip,
-			config_ssl_ca_location, config_ssl_cert_location, config_ssl_key_location, &error)))
+	if (SUCCEED != (ret = zbx_proxyconfig_get_data(proxy, &jp, &j, &data, &data_size, &status, config_vault,
+			config_source_ip, config_ssl_ca_location, config_ssl_cert_location, config_ssl_key_location,
+			&error)))
 	{
 		zabbix_log(LOG_LEVEL_ERR, "cannot collect configuration data for proxy \"%s\": %s",
 				proxy->name, error);
 		goto clean;
 	}
 
-	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
-	{
-		zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
-		ret = FAIL;
+	if (SUCCEED != (ret = zbx_proxyconfig_pack(&j, data, data_size, &buffer, &buffer_size, &reserved)))
 		goto clean;
-	}
 
-	reserved = j.buffer_size;
 	zbx_json_free(&j);	/* json buffer can be large, free as fast as possible */
+	zbx_free(data);
 
 	loglevel = (ZBX_PROXYCONFIG_STATUS_DATA == status ? LOG_LEVEL_WARNING : LOG_LEVEL_DEBUG);
 
@@ -350,6 +348,7 @@ clean:
 	disconnect_proxy(&s);
 out:
 	zbx_free(buffer);
+	zbx_free(data);
 	zbx_free(error);
 	zbx_json_free(&j);
 #ifdef	HAVE_MALLOC_TRIM
@@ -48,6 +48,7 @@
 #include "zbxdiscoverer.h"
 #include "zbxexport.h"
 #include "zbxself.h"
+#include "zbxprof.h"
 
 #include "zbxcfg.h"
 #include "zbxpinger.h"
@@ -139,8 +140,8 @@ static const char	*help_message[] = {
 	"      " ZBX_SECRETS_RELOAD "                  Reload secrets from Vault",
 	"      " ZBX_DIAGINFO "=section                Log internal diagnostic information of the",
 	"                                        section (historycache, preprocessing, alerting,",
-	"                                        lld, valuecache, locks, connector) or everything if section is",
-	"                                        not specified",
+	"                                        lld, valuecache, locks, connector, profiler,",
+	"                                        poller) or everything if section is not specified",
 	"      " ZBX_PROF_ENABLE "=target              Enable profiling, affects all processes if",
 	"                                        target is not specified",
 	"      " ZBX_PROF_DISABLE "=target             Disable profiling, affects all processes if",
@@ -281,6 +282,7 @@ int	config_forks[ZBX_PROCESS_TYPE_COUNT] = {
 	1, /* ZBX_PROCESS_TYPE_PG_MANAGER */
 	1, /* ZBX_PROCESS_TYPE_BROWSERPOLLER */
 	1, /* ZBX_PROCESS_TYPE_HA_MANAGER */
+	0, /* ZBX_PROCESS_TYPE_METRICS_EXPORTER */
 };
 
 static int	get_config_forks(unsigned char process_type)
@@ -305,6 +307,8 @@ static int	config_histsyncer_frequency	= 1;
 
 static int	zbx_config_listen_port		= ZBX_DEFAULT_SERVER_PORT;
 static char	*zbx_config_listen_ip		= NULL;
+static int	config_metrics_listen_port	= 0;
+static char	*config_metrics_listen_ip	= NULL;
 static char	*config_server		= NULL;		/* not used in zabbix_server, required for linking */
 
 static int	config_housekeeping_frequency	= 1;
@@ -323,6 +327,8 @@ static zbx_uint64_t	config_history_index_cache_size	= 4 * ZBX_MEBIBYTE;
 static zbx_uint64_t	config_trends_cache_size	= 4 * ZBX_MEBIBYTE;
 static zbx_uint64_t	config_trend_func_cache_size	= 4 * ZBX_MEBIBYTE;
 static zbx_uint64_t	config_value_cache_size		= 8 * ZBX_MEBIBYTE;
+static char		*config_value_cache_snapshot_file	= NULL;
+static char		*value_cache_snapshot_runid		= NULL;
 static zbx_uint64_t	config_vmware_cache_size	= 8 * ZBX_MEBIBYTE;
 
 static int	config_unreachable_period		= 45;
@@ -393,7 +399,8 @@ static	const zbx_events_funcs_t	events_cbs = {
 	.clean_events_cb		= zbx_clean_events,
 	.reset_event_recovery_cb	= zbx_reset_event_recovery,
 	.export_events_cb		= zbx_export_events,
-	.events_update_itservices_cb	= zbx_events_update_itservices
+	.events_update_itservices_cb	= zbx_events_update_itservices,
+	.start_escalations_cb		= zbx_events_start_escalations
 };
 
 typedef struct
@@ -622,6 +629,11 @@ static int	get_process_info_by_thread(int local_server_num, unsigned char *local
 		*local_process_type = ZBX_PROCESS_TYPE_PG_MANAGER;
 		*local_process_num = local_server_num - server_count + config_forks[ZBX_PROCESS_TYPE_PG_MANAGER];
 	}
+	else if (local_server_num <= (server_count += config_forks[ZBX_PROCESS_TYPE_METRICS_EXPORTER]))
+	{
+		*local_process_type = ZBX_PROCESS_TYPE_METRICS_EXPORTER;
+		*local_process_num = local_server_num - server_count + config_forks[ZBX_PROCESS_TYPE_METRICS_EXPORTER];
+	}
 	else
 		return FAIL;
 
@@ -701,6 +713,9 @@ static void	zbx_set_defaults(void)
 
 	if (0 != config_forks[ZBX_PROCESS_TYPE_DISCOVERER])
 		config_forks[ZBX_PROCESS_TYPE_DISCOVERYMANAGER] = 1;
+
+	if (0 != config_metrics_listen_port)
+		config_forks[ZBX_PROCESS_TYPE_METRICS_EXPORTER] = 1;
 }
 
 /******************************************************************************
@@ -756,6 +771,15 @@ static void	zbx_validate_config(ZBX_TASK_EX *task)
 		err = 1;
 	}
 
+	if (0 != config_metrics_listen_port && (1024 > config_metrics_listen_port ||
+			(0 != config_forks[ZBX_PROCESS_TYPE_TRAPPER] &&
+			config_metrics_listen_port == zbx_config_listen_port)))
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "invalid \"MetricsListenPort\" configuration parameter: must be 0 or"
+				" between 1024 and 32767 and differ from \"ListenPort\"");
+		err = 1;
+	}
+
 	if (SUCCEED != zbx_validate_export_type(zbx_config_export.type, NULL))
 	{
 		zabbix_log(LOG_LEVEL_CRIT, "invalid \"ExportType\" configuration parameter: %s",
@@ -922,6 +946,8 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 				ZBX_CONF_PARM_OPT,	0,			__UINT64_C(2) * ZBX_GIBIBYTE},
 		{"ValueCacheSize",		&config_value_cache_size,		ZBX_CFG_TYPE_UINT64,
 				ZBX_CONF_PARM_OPT,	0,			__UINT64_C(64) * ZBX_GIBIBYTE},
+		{"ValueCacheSnapshotFile",	&config_value_cache_snapshot_file,	ZBX_CFG_TYPE_STRING,
+				ZBX_CONF_PARM_OPT,	0,			0},
 		{"CacheUpdateFrequency",	&config_confsyncer_frequency,		ZBX_CFG_TYPE_INT,
 				ZBX_CONF_PARM_OPT,	1,			SEC_PER_HOUR},
 		{"HousekeepingFrequency",	&config_housekeeping_frequency,		ZBX_CFG_TYPE_INT,
@@ -948,6 +974,10 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 				ZBX_CONF_PARM_OPT,	0,			0},
 		{"ListenPort",			&zbx_config_listen_port,		ZBX_CFG_TYPE_INT,
 				ZBX_CONF_PARM_OPT,	1024,			32767},
+		{"MetricsListenIP",		&config_metrics_listen_ip,		ZBX_CFG_TYPE_STRING_LIST,
+				ZBX_CONF_PARM_OPT,	0,			0},
+		{"MetricsListenPort",		&config_metrics_listen_port,		ZBX_CFG_TYPE_INT,
+				ZBX_CONF_PARM_OPT,	0,			32767},
 		{"SourceIP",			&zbx_config_source_ip,			ZBX_CFG_TYPE_STRING,
 				ZBX_CONF_PARM_OPT,	0,			0},
 		{"DebugLevel",			&config_log_level,			ZBX_CFG_TYPE_INT,
@@ -1177,6 +1207,67 @@ static void	zbx_free_config(void)
 	zbx_strarr_free(&CONFIG_LOAD_MODULE);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if value cache snapshot should be saved and loaded         *
+ *                                                                            *
+ * Comments: In HA cluster other node might write history while this node is  *
+ *           stopped, making the snapshot stale, so it's supported only by    *
+ *           standalone server.                                               *
+ *                                                                            *
+ ******************************************************************************/
+static int	value_cache_snapshot_enabled(void)
+{
+	if (NULL == config_value_cache_snapshot_file || '\0' == *config_value_cache_snapshot_file)
+		return FAIL;
+
+	if (NULL != CONFIG_HA_NODE_NAME && '\0' != *CONFIG_HA_NODE_NAME)
+		return FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets identifier of the previous server run                        *
+ *                                                                            *
+ * Return value: the session identifier of the most recently accessed server  *
+ *               node or NULL if it cannot be determined                      *
+ *                                                                            *
+ * Comments: Must be called before HA manager registers the current run.      *
+ *           Every server run stores its session identifier in the node       *
+ *           registry, so value cache snapshot saved by other than the        *
+ *           previous run can be detected.                                    *
+ *                                                                            *
+ ******************************************************************************/
+static char	*value_cache_snapshot_get_runid(void)
+{
+	zbx_db_result_t	result;
+	zbx_db_row_t	row;
+	char		*runid = NULL;
+
+	if (NULL == (result = zbx_db_select_n("select ha_sessionid,lastaccess from ha_node order by lastaccess desc",
+			2)))
+	{
+		return NULL;
+	}
+
+	if (NULL != (row = zbx_db_fetch(result)))
+	{
+		int	lastaccess = atoi(row[1]);
+
+		runid = zbx_strdup(NULL, row[0]);
+
+		/* nodes accessed at the same time, the previous run cannot be identified */
+		if (NULL != (row = zbx_db_fetch(result)) && atoi(row[1]) == lastaccess)
+			zbx_free(runid);
+	}
+
+	zbx_db_free_result(result);
+
+	return runid;
+}
+
 static void	zbx_on_exit(int ret, void *on_exit_args)
 {
 	char	*error = NULL;
@@ -1213,6 +1304,14 @@ static void	zbx_on_exit(int ret, void *on_exit_args)
 
 		zbx_free_configuration_cache();
 
+		if (SUCCEED == ret && SUCCEED == value_cache_snapshot_enabled() &&
+				SUCCEED != zbx_vc_snapshot_save(config_value_cache_snapshot_file,
+						zbx_ha_get_sessionid(), &error))
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "cannot save value cache snapshot: %s", error);
+			zbx_free(error);
+		}
+
 		/* free history value cache */
 		zbx_vc_destroy();
 
@@ -1562,7 +1661,8 @@ static int	server_startup(zbx_socket_t *listen_sock, int *ha_stat, int *ha_failo
 							&events_cbs, config_proxyconfig_frequency,
 							config_proxydata_frequency};
 	zbx_thread_httppoller_args	httppoller_args = {zbx_config_source_ip, config_ssl_ca_location,
-							config_ssl_cert_location, config_ssl_key_location};
+							config_ssl_cert_location, config_ssl_key_location,
+							config_max_concurrent_checks_per_poller};
 	zbx_thread_discoverer_args	discoverer_args = {zbx_config_tls, get_zbx_program_type, get_zbx_progname,
 							zbx_config_timeout, config_forks[ZBX_PROCESS_TYPE_DISCOVERER],
 							zbx_config_source_ip, &events_cbs, zbx_discovery_open_server,
@@ -1615,6 +1715,10 @@ static int	server_startup(zbx_socket_t *listen_sock, int *ha_stat, int *ha_failo
 	zbx_thread_service_manager_args	service_manager_args = {.config_timeout = zbx_config_timeout,
 								.config_service_manager_sync_frequency =
 								config_service_manager_sync_frequency};
+	zbx_thread_metrics_exporter_args	metrics_exporter_args = {config_metrics_listen_ip,
+								config_metrics_listen_port, config_stats_allowed_ip,
+								config_startup_time, zbx_config_timeout,
+								config_tcp_max_backlog_size};
 
 	if (SUCCEED != zbx_init_database_cache(get_zbx_program_type, zbx_sync_server_history, config_history_cache_size,
 			config_history_index_cache_size, &config_trends_cache_size, &error))
@@ -1648,6 +1752,14 @@ static int	server_startup(zbx_socket_t *listen_sock, int *ha_stat, int *ha_failo
 		return FAIL;
 	}
 
+	if (SUCCEED == value_cache_snapshot_enabled())
+	{
+		zbx_vc_snapshot_load(config_value_cache_snapshot_file, value_cache_snapshot_runid);
+		zbx_free(value_cache_snapshot_runid);
+	}
+	else if (NULL != config_value_cache_snapshot_file && '\0' != *config_value_cache_snapshot_file)
+		zbx_vc_snapshot_remove(config_value_cache_snapshot_file);
+
 	if (SUCCEED != zbx_tfc_init(config_trend_func_cache_size, &error))
 	{
 		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize trends read cache: %s", error);
@@ -1933,6 +2045,10 @@ static int	server_startup(zbx_socket_t *listen_sock, int *ha_stat, int *ha_failo
 				thread_args.args = &poller_args;
 				zbx_thread_start(pg_manager_thread, &thread_args, &zbx_threads[i]);
 				break;
+			case ZBX_PROCESS_TYPE_METRICS_EXPORTER:
+				thread_args.args = &metrics_exporter_args;
+				zbx_thread_start(zbx_metrics_exporter_thread, &thread_args, &zbx_threads[i]);
+				break;
 			case ZBX_PROCESS_TYPE_BROWSERPOLLER:
 				poller_args.poller_type = ZBX_POLLER_TYPE_BROWSER;
 				thread_args.args = &poller_args;
@@ -2305,6 +2421,9 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 	if (SUCCEED != zbx_db_check_instanceid())
 		goto out;
 
+	if (SUCCEED == value_cache_snapshot_enabled())
+		value_cache_snapshot_runid = value_cache_snapshot_get_runid();
+
 	zbx_db_close();
 
 	if (FAIL == zbx_init_library_export(&zbx_config_export, &error))
@@ -2329,6 +2448,20 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 		exit(EXIT_FAILURE);
 	}
 
+	if (SUCCEED != zbx_prof_probes_init(get_config_forks, &error))
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize profiler: %s", error);
+		zbx_free(error);
+		exit(EXIT_FAILURE);
+	}
+
+	if (SUCCEED != zbx_async_agent_stats_init(get_config_forks(ZBX_PROCESS_TYPE_AGENT_POLLER), &error))
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize agent poller statistics: %s", error);
+		zbx_free(error);
+		exit(EXIT_FAILURE);
+	}
+
 	zbx_unset_exit_on_terminate();
 
 	ha_config->ha_node_name =	CONFIG_HA_NODE_NAME;
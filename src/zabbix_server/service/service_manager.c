@@ -1977,23 +1977,11 @@ void	service_get_rootcause_eventids(const zbx_service_t *parent, zbx_vector_uint
 
 /******************************************************************************
  *                                                                            *
- * Purpose: updates service and its parents statuses                          *
- *                                                                            *
- * Parameters: itservice       - [IN] service to update                       *
- *             ts              - [IN] update timestamp                        *
- *             alarms          - [OUT] alarms update queue                    *
- *             service_updates - [IN/OUT]                                     *
- *             flags           - [IN]                                         *
- *                                                                            *
- *                                                                            *
- * Comments: This function recalculates service status according to the       *
- *           algorithm and status of the children services. If the status     *
- *           has been changed, an alarm is generated and parent services      *
- *           (up until the root service) are updated too.                     *
+ * Purpose: calculates service status according to the algorithm, status     *
+ *          rules and status of the children services                         *
  *                                                                            *
  ******************************************************************************/
-static void	its_itservice_update_status(zbx_service_t *itservice, const zbx_timespec_t *ts,
-		zbx_vector_status_update_ptr_t *alarms, zbx_hashset_t *service_updates, int flags)
+static int	its_itservice_get_status(const zbx_service_t *itservice)
 {
 	int	status, rule_status;
 
@@ -2007,29 +1995,174 @@ static void	its_itservice_update_status(zbx_service_t *itservice, const zbx_time
 			status = rule_status;
 	}
 
-	if (itservice->status != status)
+	return status;
+}
+
+/* service waiting for status recalculation after changes in its children */
+typedef struct
+{
+	zbx_uint64_t	serviceid;
+	zbx_service_t	*service;
+	zbx_timespec_t	ts;
+	int		flags;
+
+	/* number of children that must be recalculated before this service */
+	int		children_num;
+
+	/* 1 if status of any child has been changed, 0 otherwise */
+	unsigned char	changed;
+}
+zbx_service_dirty_t;
+
+ZBX_PTR_VECTOR_DECL(service_dirty_ptr, zbx_service_dirty_t *)
+ZBX_PTR_VECTOR_IMPL(service_dirty_ptr, zbx_service_dirty_t *)
+
+static zbx_service_dirty_t	*service_dirty_get(zbx_hashset_t *dirty, zbx_service_t *service)
+{
+	zbx_service_dirty_t	*entry, entry_local = {.serviceid = service->serviceid};
+
+	if (NULL == (entry = (zbx_service_dirty_t *)zbx_hashset_search(dirty, &entry_local)))
+	{
+		entry_local.service = service;
+		entry = (zbx_service_dirty_t *)zbx_hashset_insert(dirty, &entry_local, sizeof(entry_local));
+	}
+
+	return entry;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: marks parent services for status recalculation                    *
+ *                                                                            *
+ * Parameters: dirty   - [IN/OUT] services waiting for recalculation          *
+ *             service - [IN] service with updated status                     *
+ *             ts      - [IN] update timestamp                                *
+ *             changed - [IN] 1 if service status has been changed            *
+ *             flags   - [IN] ZBX_FLAG_SERVICE_* flags                        *
+ *                                                                            *
+ ******************************************************************************/
+static void	service_mark_parents_dirty(zbx_hashset_t *dirty, const zbx_service_t *service,
+		const zbx_timespec_t *ts, unsigned char changed, int flags)
+{
+	for (int i = 0; i < service->parents.values_num; i++)
 	{
-		zbx_service_update_t	*update;
+		zbx_service_dirty_t	*entry;
+
+		entry = service_dirty_get(dirty, service->parents.values[i]);
+
+		if (0 > zbx_timespec_compare(&entry->ts, ts))
+			entry->ts = *ts;
+
+		entry->changed |= changed;
+		entry->flags |= flags;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: recalculates statuses of marked services and their parents        *
+ *                                                                            *
+ * Parameters: dirty           - [IN/OUT] services marked for recalculation   *
+ *             alarms          - [OUT] alarms update queue                    *
+ *             service_updates - [IN/OUT]                                     *
+ *                                                                            *
+ * Return value: number of recalculated services                              *
+ *                                                                            *
+ * Comments: Services are recalculated in topological order - every service   *
+ *           is recalculated once, after all its affected children. Status    *
+ *           changes are propagated to the parents only along the service     *
+ *           links of changed services (or of all affected services when      *
+ *           ZBX_FLAG_SERVICE_RECALCULATE flag is set).                       *
+ *                                                                            *
+ ******************************************************************************/
+static int	its_itservices_update_status(zbx_hashset_t *dirty, zbx_vector_status_update_ptr_t *alarms,
+		zbx_hashset_t *service_updates)
+{
+	zbx_vector_service_dirty_ptr_t	entries, ready;
+	zbx_service_dirty_t		*entry;
+	zbx_hashset_iter_t		iter;
+	int				recalculated_num = 0;
+
+	zbx_vector_service_dirty_ptr_create(&entries);
+	zbx_vector_service_dirty_ptr_create(&ready);
 
-		update = update_service(service_updates, itservice, status, ts);
-		update->alarm = its_updates_append(alarms, itservice->serviceid, status, ts->sec);
+	zbx_hashset_iter_reset(dirty, &iter);
+	while (NULL != (entry = (zbx_service_dirty_t *)zbx_hashset_iter_next(&iter)))
+		zbx_vector_service_dirty_ptr_append(&entries, entry);
 
-		/* update parent services */
-		for (int i = 0; i < itservice->parents.values_num; i++)
+	/* add all ancestors of the marked services to recalculate parents after their children */
+	for (int i = 0; i < entries.values_num; i++)
+	{
+		zbx_service_t	*service = entries.values[i]->service;
+
+		for (int j = 0; j < service->parents.values_num; j++)
 		{
-			its_itservice_update_status(itservice->parents.values[i], ts, alarms,
-					service_updates, flags);
+			zbx_service_dirty_t	entry_local = {.serviceid = service->parents.values[j]->serviceid};
+
+			if (NULL == zbx_hashset_search(dirty, &entry_local))
+			{
+				zbx_vector_service_dirty_ptr_append(&entries,
+						service_dirty_get(dirty, service->parents.values[j]));
+			}
 		}
 	}
-	else if (0 != (ZBX_FLAG_SERVICE_RECALCULATE & flags))
+
+	for (int i = 0; i < entries.values_num; i++)
+	{
+		zbx_service_t	*service = entries.values[i]->service;
+
+		for (int j = 0; j < service->parents.values_num; j++)
+			service_dirty_get(dirty, service->parents.values[j])->children_num++;
+	}
+
+	for (int i = 0; i < entries.values_num; i++)
 	{
-		/* update parent services */
-		for (int i = 0; i < itservice->parents.values_num; i++)
+		if (0 == entries.values[i]->children_num)
+			zbx_vector_service_dirty_ptr_append(&ready, entries.values[i]);
+	}
+
+	while (0 != ready.values_num)
+	{
+		zbx_service_t	*service;
+
+		entry = ready.values[ready.values_num - 1];
+		zbx_vector_service_dirty_ptr_remove_noorder(&ready, ready.values_num - 1);
+		service = entry->service;
+
+		if (0 != entry->changed || 0 != (entry->flags & ZBX_FLAG_SERVICE_RECALCULATE))
+		{
+			int	status;
+
+			recalculated_num++;
+
+			if (service->status != (status = its_itservice_get_status(service)))
+			{
+				zbx_service_update_t	*update;
+
+				update = update_service(service_updates, service, status, &entry->ts);
+				update->alarm = its_updates_append(alarms, service->serviceid, status, entry->ts.sec);
+
+				service_mark_parents_dirty(dirty, service, &entry->ts, 1, entry->flags);
+			}
+			else if (0 != (entry->flags & ZBX_FLAG_SERVICE_RECALCULATE))
+				service_mark_parents_dirty(dirty, service, &entry->ts, 0, entry->flags);
+		}
+
+		for (int i = 0; i < service->parents.values_num; i++)
 		{
-			its_itservice_update_status((zbx_service_t *)itservice->parents.values[i], ts, alarms,
-					service_updates, flags);
+			zbx_service_dirty_t	*parent;
+
+			parent = service_dirty_get(dirty, service->parents.values[i]);
+
+			if (0 == --parent->children_num)
+				zbx_vector_service_dirty_ptr_append(&ready, parent);
 		}
 	}
+
+	zbx_vector_service_dirty_ptr_destroy(&ready);
+	zbx_vector_service_dirty_ptr_destroy(&entries);
+
+	return recalculated_num;
 }
 
 static char	*service_get_event_name(zbx_service_manager_t *manager, const char *name, int status)
@@ -2552,14 +2685,16 @@ static void	db_update_services(zbx_service_manager_t *manager)
 	zbx_vector_status_update_ptr_t		alarms;
 	zbx_vector_service_problem_ptr_t	service_problems_new;
 	zbx_vector_uint64_t			service_problemids;
-	zbx_hashset_t				service_updates;
+	zbx_hashset_t				service_updates, dirty;
+	int					recalculated_num = 0;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() services:%d", __func__, manager->service_diffs.num_data);
 
 	zbx_vector_status_update_ptr_create(&alarms);
 	zbx_vector_service_problem_ptr_create(&service_problems_new);
 	zbx_vector_uint64_create(&service_problemids);
 	zbx_hashset_create(&service_updates, 100, service_update_hash_func, service_update_compare_func);
+	zbx_hashset_create(&dirty, 100, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	zbx_hashset_iter_reset(&manager->service_diffs, &iter);
 
@@ -2683,24 +2818,16 @@ static void	db_update_services(zbx_service_manager_t *manager)
 			update = update_service(&service_updates, service, status, &ts);
 			update->alarm = its_updates_append(&alarms, service->serviceid, service->status, ts.sec);
 
-			/* update parent services */
-			for (int i = 0; i < service->parents.values_num; i++)
-			{
-				its_itservice_update_status((zbx_service_t *)service->parents.values[i], &ts, &alarms,
-						&service_updates, service_diff->flags);
-			}
+			service_mark_parents_dirty(&dirty, service, &ts, 1, service_diff->flags);
 		}
 		else if (0 != (ZBX_FLAG_SERVICE_RECALCULATE & service_diff->flags))
-		{
-			/* update parent services */
-			for (int i = 0; i < service->parents.values_num; i++)
-			{
-				its_itservice_update_status((zbx_service_t *)service->parents.values[i], &ts, &alarms,
-						&service_updates, service_diff->flags);
-			}
-		}
+			service_mark_parents_dirty(&dirty, service, &ts, 0, service_diff->flags);
 	}
 
+	/* update parent services */
+	if (0 != dirty.num_data)
+		recalculated_num = its_itservices_update_status(&dirty, &alarms, &service_updates);
+
 	do
 	{
 		zbx_db_begin();
@@ -2711,13 +2838,15 @@ static void	db_update_services(zbx_service_manager_t *manager)
 	}
 	while (ZBX_DB_DOWN == zbx_db_commit());
 
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() recalculated:%d updated:%d", __func__, recalculated_num,
+			service_updates.num_data);
+
 	zbx_vector_uint64_destroy(&service_problemids);
 	zbx_vector_service_problem_ptr_destroy(&service_problems_new);
+	zbx_hashset_destroy(&dirty);
 	zbx_hashset_destroy(&service_updates);
 	zbx_vector_status_update_ptr_clear_ext(&alarms, zbx_status_update_free);
 	zbx_vector_status_update_ptr_destroy(&alarms);
-
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
 static void	recover_services_problem(zbx_service_manager_t *service_manager, const zbx_event_t *event)
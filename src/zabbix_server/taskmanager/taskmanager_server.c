@@ -43,6 +43,7 @@
 #include "zbxipcservice.h"
 #include "zbxstr.h"
 #include "zbxserialize.h"
+#include "zbxescalations.h"
 
 zbx_export_file_t		*problems_export = NULL;
 static zbx_export_file_t	*get_problems_export(void)
@@ -573,10 +574,13 @@ static void	notify_service_manager(const zbx_vector_ack_task_ptr_t *ack_tasks)
  *                                                                            *
  * Purpose: process acknowledgments for alerts sending                        *
  *                                                                            *
+ * Parameters: rtc         - [IN] RTC socket                                  *
+ *             ack_taskids - [IN]                                             *
+ *                                                                            *
  * Return value: number of successfully processed tasks                       *
  *                                                                            *
  ******************************************************************************/
-static int	tm_process_acknowledgments(zbx_vector_uint64_t *ack_taskids)
+static int	tm_process_acknowledgments(zbx_ipc_async_socket_t *rtc, zbx_vector_uint64_t *ack_taskids)
 {
 	zbx_db_row_t			row;
 	zbx_db_result_t			result;
@@ -633,8 +637,16 @@ static int	tm_process_acknowledgments(zbx_vector_uint64_t *ack_taskids)
 
 	if (0 < ack_tasks.values_num)
 	{
+		zbx_vector_escalation_new_ptr_t	escalations;
+
+		zbx_vector_escalation_new_ptr_create(&escalations);
+
 		zbx_vector_ack_task_ptr_sort(&ack_tasks, ZBX_DEFAULT_UINT64_PTR_COMPARE_FUNC);
-		processed_num = process_actions_by_acknowledgments(&ack_tasks);
+		processed_num = process_actions_by_acknowledgments(&ack_tasks, &escalations);
+
+		zbx_start_escalations(rtc, &escalations);
+		zbx_vector_escalation_new_ptr_clear_ext(&escalations, zbx_escalation_new_ptr_free);
+		zbx_vector_escalation_new_ptr_destroy(&escalations);
 
 		notify_service_manager(&ack_tasks);
 	}
@@ -1420,7 +1432,7 @@ static int	tm_process_tasks(zbx_ipc_async_socket_t *rtc, time_t now)
 	zbx_db_free_result(result);
 
 	if (0 < ack_taskids.values_num)
-		processed_num += tm_process_acknowledgments(&ack_taskids);
+		processed_num += tm_process_acknowledgments(rtc, &ack_taskids);
 
 	if (0 < check_now_taskids.values_num)
 		processed_num += tm_process_check_now(&check_now_taskids);
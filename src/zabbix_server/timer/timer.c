@@ -29,6 +29,9 @@
 #include "zbxservice.h"
 #include "zbxserialize.h"
 
+/* the period of full problem cache reload */
+#define ZBX_PROBLEM_CACHE_RELOAD_PERIOD	SEC_PER_HOUR
+
 /* addition data for event maintenance calculations to pair with zbx_event_suppress_query_t */
 typedef struct
 {
@@ -37,6 +40,22 @@ typedef struct
 }
 zbx_event_suppress_data_t;
 
+ZBX_PTR_VECTOR_IMPL(event_suppress_query_ptr, zbx_event_suppress_query_t*)
+
+/* open and recently resolved problems of the timer process, kept between maintenance updates */
+typedef struct
+{
+	zbx_vector_event_suppress_query_ptr_t	queries;	/* problem event queries sorted by eventid */
+	int					read_tags;	/* SUCCEED if problem tags are loaded */
+	time_t					reload_time;	/* the time of the last full load, 0 if */
+								/* problems are not loaded              */
+	zbx_uint64_t				tagid;		/* the last problem tag read by the     */
+								/* previous synchronization             */
+	zbx_uint64_t				tagid_from;	/* the problem tags after this id are   */
+								/* checked by the next synchronization  */
+}
+zbx_problem_cache_t;
+
 /******************************************************************************
  *                                                                            *
  * Purpose: logs host maintenance changes                                     *
@@ -220,8 +239,6 @@ static void	event_suppress_data_free(zbx_event_suppress_data_t *data)
 	zbx_free(data);
 }
 
-ZBX_PTR_VECTOR_IMPL(event_suppress_query_ptr, zbx_event_suppress_query_t*)
-
 static int	event_suppress_query_eventid_compare(const void *d1, const void *d2)
 {
 	const zbx_event_suppress_query_t	*ds1 = *(const zbx_event_suppress_query_t * const *)d1;
@@ -287,24 +304,33 @@ static int	event_suppress_data_eventid_compare(const void *d1, const void *d2)
 
 /******************************************************************************
  *                                                                            *
- * Purpose: Gets open, recently resolved and resolved problems with suppress  *
- *          data from database and prepares event query, event data           *
- *          structures.                                                       *
+ * Purpose: frees cached problems                                             *
  *                                                                            *
  ******************************************************************************/
-static void	db_get_query_events(zbx_vector_event_suppress_query_ptr_t *event_queries,
-		zbx_vector_event_suppress_data_ptr_t *event_data, int process_num, zbx_get_config_forks_f get_forks_cb)
+static void	problem_cache_clear(zbx_problem_cache_t *cache)
 {
-	zbx_db_row_t			row;
-	zbx_db_result_t			result;
-	zbx_event_suppress_data_t	*data = NULL;
-	zbx_uint64_t			eventid;
-	zbx_uint64_pair_t		pair;
-	zbx_vector_uint64_t		eventids;
-	int				read_tags;
-	const char			*tag_fields, *tag_join;
+	zbx_vector_event_suppress_query_ptr_clear_ext(&cache->queries, zbx_event_suppress_query_free);
+	cache->reload_time = 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: loads problems with their tags into cache                         *
+ *                                                                            *
+ * Parameters: cache        - [IN/OUT] the problem cache                      *
+ *             eventids     - [IN] the problems to load, NULL to load all     *
+ *                                 problems of the timer process              *
+ *             process_num  - [IN]                                            *
+ *             get_forks_cb - [IN]                                            *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_load_problems(zbx_problem_cache_t *cache, const zbx_vector_uint64_t *eventids, int process_num,
+		zbx_get_config_forks_f get_forks_cb)
+{
+	zbx_db_result_t	result;
+	const char	*tag_fields, *tag_join;
 
-	if (SUCCEED == (read_tags = zbx_dc_maintenance_has_tags()))
+	if (SUCCEED == cache->read_tags)
 	{
 		tag_fields = "t.tag,t.value";
 		tag_join = " left join problem_tag t on p.eventid=t.eventid";
@@ -315,21 +341,258 @@ static void	db_get_query_events(zbx_vector_event_suppress_query_ptr_t *event_que
 		tag_join = "";
 	}
 
-	/* get open or recently closed problems */
-	result = zbx_db_select("select p.eventid,p.objectid,p.r_eventid,%s"
-			" from problem p"
-			"%s"
-			" where p.source=%d"
-				" and p.object=%d"
-				" and " ZBX_SQL_MOD(p.eventid, %d) "=%d"
-			" order by p.eventid",
-			tag_fields, tag_join,
+	if (NULL == eventids)
+	{
+		result = zbx_db_select("select p.eventid,p.objectid,p.r_eventid,%s"
+				" from problem p"
+				"%s"
+				" where p.source=%d"
+					" and p.object=%d"
+					" and " ZBX_SQL_MOD(p.eventid, %d) "=%d"
+				" order by p.eventid",
+				tag_fields, tag_join,
+				EVENT_SOURCE_TRIGGERS, EVENT_OBJECT_TRIGGER, get_forks_cb(ZBX_PROCESS_TYPE_TIMER),
+				process_num - 1);
+
+		event_queries_fetch(result, &cache->queries);
+		zbx_db_free_result(result);
+
+		return;
+	}
+
+#define ZBX_EVENT_BATCH_SIZE	1000
+	for (int i = 0; i < eventids->values_num; i += ZBX_EVENT_BATCH_SIZE)
+	{
+		char	*sql = NULL;
+		size_t	sql_alloc = 0, sql_offset = 0;
+
+		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+				"select p.eventid,p.objectid,p.r_eventid,%s"
+				" from problem p"
+				"%s"
+				" where",
+				tag_fields, tag_join);
+		zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "p.eventid", eventids->values + i,
+				MIN(eventids->values_num - i, ZBX_EVENT_BATCH_SIZE));
+		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, " order by p.eventid");
+
+		result = zbx_db_select("%s", sql);
+		zbx_free(sql);
+
+		event_queries_fetch(result, &cache->queries);
+		zbx_db_free_result(result);
+	}
+#undef ZBX_EVENT_BATCH_SIZE
+
+	zbx_vector_event_suppress_query_ptr_sort(&cache->queries, ZBX_DEFAULT_UINT64_PTR_COMPARE_FUNC);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets problems with tags added since the previous synchronization  *
+ *                                                                            *
+ * Parameters: cache        - [IN/OUT] the problem cache                      *
+ *             eventids     - [OUT] the problems with new tags, sorted        *
+ *             process_num  - [IN]                                            *
+ *             get_forks_cb - [IN]                                            *
+ *                                                                            *
+ * Comments: Tags can be added to existing problems, for example by webhooks. *
+ *           Problem tag identifiers are increasing, but transactions might   *
+ *           commit them out of order, so tags added since the previous but   *
+ *           one synchronization are checked.                                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_get_tagged_problems(zbx_problem_cache_t *cache, zbx_vector_uint64_t *eventids, int process_num,
+		zbx_get_config_forks_f get_forks_cb)
+{
+	zbx_db_row_t	row;
+	zbx_db_result_t	result;
+	zbx_uint64_t	tagid, eventid, tagid_max = cache->tagid;
+
+	result = zbx_db_select("select problemtagid,eventid"
+			" from problem_tag"
+			" where problemtagid>" ZBX_FS_UI64
+				" and " ZBX_SQL_MOD(eventid, %d) "=%d",
+			cache->tagid_from, get_forks_cb(ZBX_PROCESS_TYPE_TIMER), process_num - 1);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		ZBX_STR2UINT64(tagid, row[0]);
+		ZBX_STR2UINT64(eventid, row[1]);
+
+		if (tagid > tagid_max)
+			tagid_max = tagid;
+
+		zbx_vector_uint64_append(eventids, eventid);
+	}
+	zbx_db_free_result(result);
+
+	zbx_vector_uint64_sort(eventids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_vector_uint64_uniq(eventids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+	cache->tagid_from = cache->tagid;
+	cache->tagid = tagid_max;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: synchronizes cached problems with problem table                   *
+ *                                                                            *
+ * Parameters: cache        - [IN/OUT] the problem cache                      *
+ *             process_num  - [IN]                                            *
+ *             get_forks_cb - [IN]                                            *
+ *                                                                            *
+ * Comments: Only problem identifiers and recovery events are read to find    *
+ *           removed, resolved and new problems. Tags are read for the new    *
+ *           problems and the problems with tags added after creation. All    *
+ *           problems are reloaded periodically or when maintenance tags      *
+ *           appear or disappear.                                             *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_sync_problem_cache(zbx_problem_cache_t *cache, int process_num, zbx_get_config_forks_f get_forks_cb)
+{
+	zbx_db_row_t				row;
+	zbx_db_result_t				result;
+	zbx_vector_event_suppress_query_ptr_t	queries;
+	zbx_vector_uint64_t			eventids, tagged_eventids;
+	zbx_uint64_t				eventid, r_eventid;
+	int					read_tags, i = 0;
+	time_t					now;
+
+	now = time(NULL);
+	read_tags = zbx_dc_maintenance_has_tags();
+
+	if (read_tags != cache->read_tags || now - cache->reload_time >= ZBX_PROBLEM_CACHE_RELOAD_PERIOD)
+		problem_cache_clear(cache);
+
+	if (0 == cache->reload_time)
+	{
+		cache->read_tags = read_tags;
+		cache->reload_time = now;
+
+		if (SUCCEED == read_tags)
+		{
+			result = zbx_db_select("select max(problemtagid) from problem_tag");
+
+			if (NULL != (row = zbx_db_fetch(result)))
+				ZBX_DBROW2UINT64(cache->tagid, row[0]);
+			else
+				cache->tagid = 0;
+
+			zbx_db_free_result(result);
+
+			cache->tagid_from = cache->tagid;
+		}
+
+		db_load_problems(cache, NULL, process_num, get_forks_cb);
+
+		return;
+	}
+
+	zbx_vector_event_suppress_query_ptr_create(&queries);
+	zbx_vector_event_suppress_query_ptr_reserve(&queries, (size_t)cache->queries.values_num);
+	zbx_vector_uint64_create(&eventids);
+	zbx_vector_uint64_create(&tagged_eventids);
+
+	if (SUCCEED == cache->read_tags)
+		db_get_tagged_problems(cache, &tagged_eventids, process_num, get_forks_cb);
+
+	result = zbx_db_select("select eventid,r_eventid"
+			" from problem"
+			" where source=%d"
+				" and object=%d"
+				" and " ZBX_SQL_MOD(eventid, %d) "=%d"
+			" order by eventid",
 			EVENT_SOURCE_TRIGGERS, EVENT_OBJECT_TRIGGER, get_forks_cb(ZBX_PROCESS_TYPE_TIMER),
 			process_num - 1);
 
-	event_queries_fetch(result, event_queries);
+	/* both problem rows and cached problems are sorted by eventid */
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		ZBX_STR2UINT64(eventid, row[0]);
+		ZBX_DBROW2UINT64(r_eventid, row[1]);
+
+		for (; i < cache->queries.values_num && cache->queries.values[i]->eventid < eventid; i++)
+			zbx_event_suppress_query_free(cache->queries.values[i]);
+
+		if (i < cache->queries.values_num && cache->queries.values[i]->eventid == eventid)
+		{
+			/* reload problems with new tags */
+			if (FAIL != zbx_vector_uint64_bsearch(&tagged_eventids, eventid,
+					ZBX_DEFAULT_UINT64_COMPARE_FUNC))
+			{
+				zbx_event_suppress_query_free(cache->queries.values[i++]);
+				zbx_vector_uint64_append(&eventids, eventid);
+				continue;
+			}
+
+			cache->queries.values[i]->r_eventid = r_eventid;
+			zbx_vector_event_suppress_query_ptr_append(&queries, cache->queries.values[i++]);
+		}
+		else
+			zbx_vector_uint64_append(&eventids, eventid);
+	}
 	zbx_db_free_result(result);
 
+	for (; i < cache->queries.values_num; i++)
+		zbx_event_suppress_query_free(cache->queries.values[i]);
+
+	zbx_vector_event_suppress_query_ptr_clear(&cache->queries);
+	zbx_vector_event_suppress_query_ptr_append_array(&cache->queries, queries.values, queries.values_num);
+
+	if (0 != eventids.values_num)
+		db_load_problems(cache, &eventids, process_num, get_forks_cb);
+
+	zbx_vector_uint64_destroy(&tagged_eventids);
+	zbx_vector_uint64_destroy(&eventids);
+	zbx_vector_event_suppress_query_ptr_destroy(&queries);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: Gets open, recently resolved and resolved problems with suppress  *
+ *          data from database and prepares event query, event data           *
+ *          structures.                                                       *
+ *                                                                            *
+ * Parameters: cache          - [IN/OUT] the problem cache                    *
+ *             event_queries  - [OUT] the cached problem and resolved event   *
+ *                                    queries sorted by eventid               *
+ *             resolved       - [OUT] the resolved event queries, not owned   *
+ *                                    by problem cache                        *
+ *             event_data     - [OUT] the event suppress data                 *
+ *             process_num    - [IN]                                          *
+ *             get_forks_cb   - [IN]                                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_get_query_events(zbx_problem_cache_t *cache, zbx_vector_event_suppress_query_ptr_t *event_queries,
+		zbx_vector_event_suppress_query_ptr_t *resolved, zbx_vector_event_suppress_data_ptr_t *event_data,
+		int process_num, zbx_get_config_forks_f get_forks_cb)
+{
+	zbx_db_row_t			row;
+	zbx_db_result_t			result;
+	zbx_event_suppress_data_t	*data = NULL;
+	zbx_uint64_t			eventid;
+	zbx_uint64_pair_t		pair;
+	zbx_vector_uint64_t		eventids;
+	const char			*tag_fields, *tag_join;
+
+	/* get open or recently closed problems */
+	db_sync_problem_cache(cache, process_num, get_forks_cb);
+
+	zbx_vector_event_suppress_query_ptr_reserve(event_queries, (size_t)cache->queries.values_num);
+
+	for (int i = 0; i < cache->queries.values_num; i++)
+	{
+		zbx_event_suppress_query_t	*query = cache->queries.values[i];
+
+		/* hosts and their maintenances are resolved again by every update */
+		zbx_vector_uint64_clear(&query->hostids);
+		zbx_vector_uint64_clear(&query->functionids);
+		zbx_vector_uint64_pair_clear(&query->maintenances);
+
+		zbx_vector_event_suppress_query_ptr_append(event_queries, query);
+	}
+
 	/* get event suppress data */
 
 	zbx_vector_uint64_create(&eventids);
@@ -370,11 +633,16 @@ static void	db_get_query_events(zbx_vector_event_suppress_query_ptr_t *event_que
 
 	if (0 != eventids.values_num)
 	{
-		if (SUCCEED == read_tags)
+		if (SUCCEED == cache->read_tags)
 		{
 			tag_fields = "t.tag,t.value";
 			tag_join = " left join event_tag t on e.eventid=t.eventid";
 		}
+		else
+		{
+			tag_fields = "null,null";
+			tag_join = "";
+		}
 
 		zbx_vector_uint64_uniq(&eventids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
@@ -399,10 +667,12 @@ static void	db_get_query_events(zbx_vector_event_suppress_query_ptr_t *event_que
 			result = zbx_db_select("%s", sql);
 			zbx_free(sql);
 
-			event_queries_fetch(result, event_queries);
+			event_queries_fetch(result, resolved);
 			zbx_db_free_result(result);
 		}
 #undef ZBX_EVENT_BATCH_SIZE
+		zbx_vector_event_suppress_query_ptr_append_array(event_queries, resolved->values,
+				resolved->values_num);
 		zbx_vector_event_suppress_query_ptr_sort(event_queries, ZBX_DEFAULT_UINT64_PTR_COMPARE_FUNC);
 	}
 
@@ -414,23 +684,26 @@ static void	db_get_query_events(zbx_vector_event_suppress_query_ptr_t *event_que
  * Purpose: Creates/Updates event suppress data to reflect latest maintenance *
  *          changes in cache.                                                 *
  *                                                                            *
- * Parameters: suppressed_num - [OUT]                                         *
+ * Parameters: problem_cache  - [IN/OUT]                                      *
+ *             suppressed_num - [OUT]                                         *
  *             process_num    - [IN]                                          *
  *             get_forks_cb   - [IN]                                          *
  *                                                                            *
  ******************************************************************************/
-static int	db_update_event_suppress_data(int *suppressed_num, int process_num, zbx_get_config_forks_f get_forks_cb)
+static int	db_update_event_suppress_data(zbx_problem_cache_t *problem_cache, int *suppressed_num,
+		int process_num, zbx_get_config_forks_f get_forks_cb)
 {
-	zbx_vector_event_suppress_query_ptr_t	event_queries;
+	zbx_vector_event_suppress_query_ptr_t	event_queries, resolved;
 	zbx_vector_event_suppress_data_ptr_t	event_data;
 	int					txn_rc = ZBX_DB_OK;
 
 	*suppressed_num = 0;
 
 	zbx_vector_event_suppress_query_ptr_create(&event_queries);
+	zbx_vector_event_suppress_query_ptr_create(&resolved);
 	zbx_vector_event_suppress_data_ptr_create(&event_data);
 
-	db_get_query_events(&event_queries, &event_data, process_num, get_forks_cb);
+	db_get_query_events(problem_cache, &event_queries, &resolved, &event_data, process_num, get_forks_cb);
 
 	if (0 != event_queries.values_num)
 	{
@@ -599,9 +872,12 @@ cleanup:
 	zbx_vector_event_suppress_data_ptr_clear_ext(&event_data, event_suppress_data_free);
 	zbx_vector_event_suppress_data_ptr_destroy(&event_data);
 
-	zbx_vector_event_suppress_query_ptr_clear_ext(&event_queries, zbx_event_suppress_query_free);
+	/* problem event queries are owned by problem cache */
 	zbx_vector_event_suppress_query_ptr_destroy(&event_queries);
 
+	zbx_vector_event_suppress_query_ptr_clear_ext(&resolved, zbx_event_suppress_query_free);
+	zbx_vector_event_suppress_query_ptr_destroy(&resolved);
+
 	return txn_rc;
 }
 
@@ -664,6 +940,7 @@ ZBX_THREAD_ENTRY(timer_thread, args)
 				server_num = thread_info->server_num,
 				process_num = thread_info->process_num;
 	unsigned char		process_type = thread_info->process_type;
+	zbx_problem_cache_t	problem_cache;
 
 	zbx_thread_timer_args	*args_in = (zbx_thread_timer_args *)(((zbx_thread_args_t *)args)->args);
 
@@ -678,6 +955,12 @@ ZBX_THREAD_ENTRY(timer_thread, args)
 
 	zbx_db_connect(ZBX_DB_CONNECT_NORMAL);
 
+	zbx_vector_event_suppress_query_ptr_create(&problem_cache.queries);
+	problem_cache.read_tags = FAIL;
+	problem_cache.reload_time = 0;
+	problem_cache.tagid = 0;
+	problem_cache.tagid_from = 0;
+
 	while (ZBX_IS_RUNNING())
 	{
 		double	sec = zbx_time();
@@ -718,8 +1001,8 @@ ZBX_THREAD_ENTRY(timer_thread, args)
 				if (SUCCEED == update)
 				{
 					zbx_dc_maintenance_set_update_flags();
-					while (ZBX_DB_DOWN == db_update_event_suppress_data(&events_num, process_num,
-							args_in->get_process_forks_cb_arg))
+					while (ZBX_DB_DOWN == db_update_event_suppress_data(&problem_cache,
+							&events_num, process_num, args_in->get_process_forks_cb_arg))
 						;
 
 					zbx_dc_maintenance_reset_update_flag(process_num);
@@ -741,8 +1024,8 @@ ZBX_THREAD_ENTRY(timer_thread, args)
 			zbx_setproctitle("%s #%d [%s, processing maintenances]", get_process_type_string(process_type),
 					process_num, info);
 
-			while (ZBX_DB_DOWN == db_update_event_suppress_data(&events_num, process_num,
-					args_in->get_process_forks_cb_arg))
+			while (ZBX_DB_DOWN == db_update_event_suppress_data(&problem_cache, &events_num,
+					process_num, args_in->get_process_forks_cb_arg))
 				;
 
 			info_offset = 0;
@@ -771,6 +1054,10 @@ ZBX_THREAD_ENTRY(timer_thread, args)
 		idle = 1;
 	}
 
+	problem_cache_clear(&problem_cache);
+	zbx_vector_event_suppress_query_ptr_destroy(&problem_cache.queries);
+	zbx_free(info);
+
 	zbx_setproctitle("%s #%d [terminated]", get_process_type_string(process_type), process_num);
 
 	while (1)
@@ -85,7 +85,9 @@ AC_DEFUN([CONF_TESTS],
 			tests/libs/zbxxml/Makefile
 			tests/libs/zbxodbc/Makefile
 			tests/libs/zbxip/Makefile
+			tests/libs/zbxprof/Makefile
 			tests/zabbix_server/Makefile
+			tests/zabbix_server/housekeeper/Makefile
 			tests/zabbix_server/pinger/Makefile
 			tests/zabbix_server/service/Makefile
 			tests/zabbix_server/trapper/Makefile
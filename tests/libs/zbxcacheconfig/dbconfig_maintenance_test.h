@@ -18,5 +18,6 @@
 int	dc_maintenance_match_tags_test(const zbx_dc_maintenance_t *maintenance, const zbx_vector_tags_ptr_t *tags);
 int	dc_check_maintenance_period_test(const zbx_dc_maintenance_t *maintenance,
 		const zbx_dc_maintenance_period_t *period, time_t now, time_t *running_since, time_t *running_until);
+int	dc_calculate_maintenance_next_update_test(const zbx_dc_maintenance_t *maintenance, time_t now);
 
 #endif
@@ -0,0 +1,127 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxmutexs.h"
+#include "zbxalgo.h"
+#include "zbxcacheconfig.h"
+
+#include "dbconfig.h"
+#include "dbconfig_maintenance_test.h"
+
+static int	get_time(const char *str, const char *name)
+{
+	zbx_timespec_t	ts;
+
+	if (ZBX_MOCK_SUCCESS != zbx_strtime_to_timespec(str, &ts))
+		fail_msg("Invalid '%s' format: %s", name, str);
+
+	return (int)ts.sec;
+}
+
+static void	get_periods(zbx_mock_handle_t handle, zbx_vector_ptr_t *periods)
+{
+	zbx_mock_error_t		mock_err;
+	zbx_mock_handle_t		hperiod;
+	zbx_dc_maintenance_period_t	*period;
+	const char			*type;
+
+	while (ZBX_MOCK_END_OF_VECTOR != (mock_err = (zbx_mock_vector_element(handle, &hperiod))))
+	{
+		period = (zbx_dc_maintenance_period_t *)zbx_malloc(NULL, sizeof(zbx_dc_maintenance_period_t));
+		memset(period, 0, sizeof(zbx_dc_maintenance_period_t));
+
+		type = zbx_mock_get_object_member_string(hperiod, "type");
+
+		if (0 == strcmp(type, "onetime"))
+		{
+			period->type = TIMEPERIOD_TYPE_ONETIME;
+			period->start_date = get_time(zbx_mock_get_object_member_string(hperiod, "start_date"),
+					"start_date");
+		}
+		else if (0 == strcmp(type, "daily"))
+			period->type = TIMEPERIOD_TYPE_DAILY;
+		else if (0 == strcmp(type, "weekly"))
+			period->type = TIMEPERIOD_TYPE_WEEKLY;
+		else if (0 == strcmp(type, "monthly"))
+			period->type = TIMEPERIOD_TYPE_MONTHLY;
+		else
+			fail_msg("unknown maintenance period type '%s'", type);
+
+		if (TIMEPERIOD_TYPE_ONETIME != period->type)
+			period->start_time = zbx_mock_get_object_member_int(hperiod, "start_time");
+
+		zbx_vector_ptr_append(periods, period);
+	}
+}
+
+static void	get_maintenance(zbx_dc_maintenance_t *maintenance)
+{
+	const char	*state;
+
+	maintenance->active_since = get_time(zbx_mock_get_parameter_string("in.maintenance.active_since"),
+			"active_since");
+	maintenance->active_until = get_time(zbx_mock_get_parameter_string("in.maintenance.active_until"),
+			"active_until");
+
+	state = zbx_mock_get_parameter_string("in.maintenance.state");
+
+	if (0 == strcmp(state, "running"))
+	{
+		maintenance->state = ZBX_MAINTENANCE_RUNNING;
+		maintenance->running_until = get_time(
+				zbx_mock_get_parameter_string("in.maintenance.running_until"), "running_until");
+	}
+	else if (0 == strcmp(state, "idle"))
+	{
+		maintenance->state = ZBX_MAINTENANCE_IDLE;
+		maintenance->running_until = 0;
+	}
+	else
+		fail_msg("unknown maintenance state '%s'", state);
+
+	get_periods(zbx_mock_get_parameter_handle("in.maintenance.periods"), &maintenance->periods);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_dc_maintenance_t	maintenance;
+	int			now, returned_time, expected_time;
+
+	ZBX_UNUSED(state);
+
+	if (0 != setenv("TZ", zbx_mock_get_parameter_string("in.timezone"), 1))
+		fail_msg("Cannot set 'TZ' environment variable: %s", zbx_strerror(errno));
+
+	tzset();
+
+	memset(&maintenance, 0, sizeof(maintenance));
+	zbx_vector_ptr_create(&maintenance.periods);
+
+	get_maintenance(&maintenance);
+	now = get_time(zbx_mock_get_parameter_string("in.now"), "now");
+
+	returned_time = dc_calculate_maintenance_next_update_test(&maintenance, now);
+	expected_time = get_time(zbx_mock_get_parameter_string("out.next_update"), "next_update");
+
+	zbx_mock_assert_time_eq("dc_calculate_maintenance_next_update return value", expected_time, returned_time);
+
+	zbx_vector_ptr_clear_ext(&maintenance.periods, zbx_ptr_free);
+	zbx_vector_ptr_destroy(&maintenance.periods);
+}
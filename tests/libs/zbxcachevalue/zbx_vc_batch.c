@@ -0,0 +1,95 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxcachevalue.h"
+#include "valuecache_test.h"
+#include "mocks/valuecache/valuecache_mock.h"
+
+#include "zbx_vc_common.h"
+
+void	zbx_vc_test_batch_setup(zbx_mock_handle_t *handle, zbx_uint64_t *itemid, unsigned char *value_type,
+		zbx_timespec_t *ts, int *err, zbx_vector_history_record_t *expected,
+		zbx_vector_history_record_t *returned, int *seconds, int *count)
+{
+	zbx_mock_handle_t	hrequests, hrequest;
+	zbx_mock_error_t	mock_err;
+	int			status, active_range, values_total, db_cached_from;
+
+	*handle = zbx_mock_get_parameter_handle("in.test");
+	zbx_vcmock_set_time(*handle, "time");
+
+	/* requests of items not in cache must be deferred without reading database */
+
+	zbx_vc_batch_begin();
+
+	hrequests = zbx_mock_get_object_member_handle(*handle, "batch");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (mock_err = (zbx_mock_vector_element(hrequests, &hrequest))))
+	{
+		if (ZBX_MOCK_SUCCESS != mock_err)
+			fail_msg("Cannot read batch request: %s", zbx_mock_error_string(mock_err));
+
+		zbx_vcmock_get_request_params(hrequest, itemid, value_type, seconds, count, ts);
+		*err = zbx_vc_get_values(*itemid, *value_type, returned, *seconds, *count, ts);
+		zbx_mock_assert_result_eq("zbx_vc_get_values() return value in batch", FAIL, *err);
+		zbx_mock_assert_int_eq("returned values in batch", 0, returned->values_num);
+
+		*err = zbx_vc_get_item_state(*itemid, &status, &active_range, &values_total, &db_cached_from);
+		zbx_mock_assert_result_eq("deferred item state", FAIL, *err);
+	}
+
+	zbx_mock_assert_int_eq("zbx_vc_batch_deferred_num()",
+			atoi(zbx_mock_get_parameter_string("out.deferred")), zbx_vc_batch_deferred_num());
+
+	/* items cached by other processes before the deferred requests are read */
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(*handle, "cached", &hrequests))
+	{
+		while (ZBX_MOCK_END_OF_VECTOR != (mock_err = (zbx_mock_vector_element(hrequests, &hrequest))))
+		{
+			zbx_vcmock_get_request_params(hrequest, itemid, value_type, seconds, count, ts);
+			zbx_vc_precache_values(*itemid, *value_type, *seconds, *count, ts);
+		}
+	}
+
+	zbx_vc_batch_end();
+	zbx_mock_assert_int_eq("zbx_vc_batch_deferred_num() after batch", 0, zbx_vc_batch_deferred_num());
+
+	/* repeat request after batch */
+
+	hrequest = zbx_mock_get_object_member_handle(*handle, "request");
+	zbx_vcmock_get_request_params(hrequest, itemid, value_type, seconds, count, ts);
+	*err = zbx_vc_get_values(*itemid, *value_type, returned, *seconds, *count, ts);
+	zbx_vc_flush_stats();
+	zbx_mock_assert_result_eq("zbx_vc_get_values() return value", SUCCEED, *err);
+
+	/* validate results */
+
+	zbx_vcmock_read_values(zbx_mock_get_parameter_handle("out.values"), *value_type, expected);
+	zbx_vcmock_check_records("Returned values", *value_type, expected, returned);
+
+	zbx_history_record_vector_clean(returned, *value_type);
+	zbx_history_record_vector_clean(expected, *value_type);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_vc_common_test_func(state, NULL, NULL, zbx_vc_test_batch_setup, 1);
+}
@@ -0,0 +1,73 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcachevalue.h"
+#include "valuecache_test.h"
+#include "mocks/valuecache/valuecache_mock.h"
+
+#include "zbx_vc_common.h"
+
+#define ZBX_VC_TEST_SNAPSHOT_PATH	"zbx_vc_snapshot.dat"
+#define ZBX_VC_TEST_SNAPSHOT_RUNID	"vcsnapshottestrun00000001"
+
+void	zbx_vc_test_snapshot_setup(zbx_mock_handle_t *handle, zbx_uint64_t *itemid, unsigned char *value_type,
+		zbx_timespec_t *ts, int *err, zbx_vector_history_record_t *expected,
+		zbx_vector_history_record_t *returned, int *seconds, int *count)
+{
+	char			*error = NULL;
+	const char		*runid = ZBX_VC_TEST_SNAPSHOT_RUNID;
+	zbx_mock_handle_t	hrunid;
+
+	ZBX_UNUSED(itemid);
+	ZBX_UNUSED(value_type);
+	ZBX_UNUSED(ts);
+	ZBX_UNUSED(expected);
+	ZBX_UNUSED(returned);
+	ZBX_UNUSED(seconds);
+	ZBX_UNUSED(count);
+
+	/* save cache contents and load them into emptied cache as after server restart */
+
+	*handle = zbx_mock_get_parameter_handle("in.test");
+	zbx_vcmock_set_time(*handle, "save time");
+
+	if (SUCCEED != (*err = zbx_vc_snapshot_save(ZBX_VC_TEST_SNAPSHOT_PATH, ZBX_VC_TEST_SNAPSHOT_RUNID, &error)))
+		fail_msg("Cannot save value cache snapshot: %s", error);
+
+	zbx_vc_reset();
+
+	zbx_vcmock_set_time(*handle, "load time");
+	zbx_vcmock_set_cache_size(*handle, "cache size");
+
+	/* snapshot saved by other than the previous server run must be discarded */
+	if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(*handle, "previous run", &hrunid) &&
+			ZBX_MOCK_SUCCESS != zbx_mock_string(hrunid, &runid))
+	{
+		fail_msg("Cannot read \"previous run\" parameter");
+	}
+
+	zbx_vc_snapshot_load(ZBX_VC_TEST_SNAPSHOT_PATH, runid);
+
+	zbx_mock_assert_int_eq("snapshot file removed after loading", -1, access(ZBX_VC_TEST_SNAPSHOT_PATH, F_OK));
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_vc_common_test_func(state, NULL, NULL, zbx_vc_test_snapshot_setup, 0);
+}
@@ -0,0 +1,83 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcompress.h"
+#include "zbxhistory.h"
+#include "history_elastic_test.h"
+
+void	__wrap_zbx_recalc_time_period(time_t *ts_from, int table_group);
+
+void	__wrap_zbx_recalc_time_period(time_t *ts_from, int table_group)
+{
+	ZBX_UNUSED(ts_from);
+	ZBX_UNUSED(table_group);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	char	*buf, *data, *bulk_buf = NULL, *uncompressed;
+	size_t	size, bulk_size = 0, uncompressed_size;
+	int	ret, expected_ret;
+
+	ZBX_UNUSED(state);
+
+	/* build bulk request data of the specified size from repeated pattern */
+	size = zbx_mock_get_parameter_uint64("in.size");
+	data = (char *)zbx_malloc(NULL, size + 1);
+
+	for (size_t i = 0; i < size; i++)
+		data[i] = "{\"index\":{}}\n"[i % 13];
+
+	data[size] = '\0';
+	buf = zbx_strdup(NULL, data);
+
+	ret = elastic_bulk_compress_test(&buf, &bulk_buf, &bulk_size);
+	expected_ret = zbx_mock_str_to_return_code(zbx_mock_get_parameter_string("out.return"));
+
+	zbx_mock_assert_result_eq("elastic_bulk_compress return value", expected_ret, ret);
+	zbx_mock_assert_ptr_eq("bulk request data", NULL, buf);
+
+	if (SUCCEED == ret)
+	{
+		if (bulk_size >= size)
+			fail_msg("compressed size " ZBX_FS_SIZE_T " is not less than " ZBX_FS_SIZE_T,
+					(zbx_fs_size_t)bulk_size, (zbx_fs_size_t)size);
+
+		uncompressed_size = size;
+		uncompressed = (char *)zbx_malloc(NULL, uncompressed_size);
+
+		if (SUCCEED != zbx_uncompress(bulk_buf, bulk_size, uncompressed, &uncompressed_size))
+			fail_msg("cannot uncompress bulk request: %s", zbx_compress_strerror());
+
+		zbx_mock_assert_uint64_eq("uncompressed size", size, uncompressed_size);
+
+		if (0 != memcmp(data, uncompressed, size))
+			fail_msg("uncompressed bulk request does not match the original data");
+
+		zbx_free(uncompressed);
+	}
+	else
+	{
+		zbx_mock_assert_uint64_eq("bulk request size", size, bulk_size);
+		zbx_mock_assert_str_eq("bulk request", data, bulk_buf);
+	}
+
+	zbx_free(bulk_buf);
+	zbx_free(data);
+}
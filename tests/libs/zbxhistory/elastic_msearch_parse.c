@@ -0,0 +1,229 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxjson.h"
+#include "zbxhistory.h"
+#include "history_elastic_test.h"
+
+void	__wrap_zbx_recalc_time_period(time_t *ts_from, int table_group);
+
+void	__wrap_zbx_recalc_time_period(time_t *ts_from, int table_group)
+{
+	ZBX_UNUSED(ts_from);
+	ZBX_UNUSED(table_group);
+}
+
+static void	add_hit(struct zbx_json *json, const char *clock, const char *ns, const char *value)
+{
+	zbx_json_addobject(json, NULL);
+	zbx_json_addobject(json, "_source");
+	zbx_json_addstring(json, "clock", clock, ZBX_JSON_TYPE_INT);
+	zbx_json_addstring(json, "ns", ns, ZBX_JSON_TYPE_INT);
+	zbx_json_addstring(json, "value", value, ZBX_JSON_TYPE_STRING);
+	zbx_json_close(json);
+	zbx_json_close(json);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: builds multi search response from test input                      *
+ *                                                                            *
+ * Comments: Each response is either search error, list of hits or number of  *
+ *           generated hits.                                                  *
+ *                                                                            *
+ ******************************************************************************/
+static void	get_response(zbx_mock_handle_t hresponses, struct zbx_json *json)
+{
+	zbx_mock_error_t	mock_err;
+	zbx_mock_handle_t	hresponse, hhits, hhit, hdata;
+	const char		*error;
+
+	zbx_json_init(json, ZBX_JSON_STAT_BUF_LEN);
+	zbx_json_addarray(json, "responses");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (mock_err = (zbx_mock_vector_element(hresponses, &hresponse))))
+	{
+		if (ZBX_MOCK_SUCCESS != mock_err)
+			fail_msg("Cannot read response: %s", zbx_mock_error_string(mock_err));
+
+		zbx_json_addobject(json, NULL);
+
+		if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hresponse, "error", &hdata) &&
+				ZBX_MOCK_SUCCESS == zbx_mock_string(hdata, &error))
+		{
+			zbx_json_addobject(json, "error");
+			zbx_json_addstring(json, "type", error, ZBX_JSON_TYPE_STRING);
+			zbx_json_close(json);
+			zbx_json_adduint64(json, "status", 500);
+		}
+		else
+		{
+			zbx_json_addobject(json, "hits");
+			zbx_json_addarray(json, "hits");
+
+			if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hresponse, "generate", &hdata))
+			{
+				int	num = zbx_mock_get_object_member_int(hresponse, "generate");
+
+				for (int i = 0; i < num; i++)
+				{
+					char	clock[16];
+
+					zbx_snprintf(clock, sizeof(clock), "%d", i + 1);
+					add_hit(json, clock, "0", clock);
+				}
+			}
+			else
+			{
+				hhits = zbx_mock_get_object_member_handle(hresponse, "hits");
+
+				while (ZBX_MOCK_SUCCESS == zbx_mock_vector_element(hhits, &hhit))
+				{
+					add_hit(json, zbx_mock_get_object_member_string(hhit, "clock"),
+							zbx_mock_get_object_member_string(hhit, "ns"),
+							zbx_mock_get_object_member_string(hhit, "value"));
+				}
+			}
+
+			zbx_json_close(json);
+			zbx_json_close(json);
+		}
+
+		zbx_json_close(json);
+	}
+
+	zbx_json_close(json);
+}
+
+static void	check_values(zbx_mock_handle_t hvalues, unsigned char value_type, int index,
+		const zbx_vector_history_record_t *values)
+{
+	zbx_mock_handle_t	hvalue;
+	int			i;
+	char			buffer[MAX_STRING_LEN], msg[64];
+
+	for (i = 0; ZBX_MOCK_SUCCESS == zbx_mock_vector_element(hvalues, &hvalue); i++)
+	{
+		if (i >= values->values_num)
+			fail_msg("search #%d returned %d values while more were expected", index, values->values_num);
+
+		zbx_snprintf(msg, sizeof(msg), "search #%d value #%d clock", index, i);
+		zbx_mock_assert_int_eq(msg, zbx_mock_get_object_member_int(hvalue, "clock"),
+				values->values[i].timestamp.sec);
+
+		zbx_snprintf(msg, sizeof(msg), "search #%d value #%d ns", index, i);
+		zbx_mock_assert_int_eq(msg, zbx_mock_get_object_member_int(hvalue, "ns"),
+				values->values[i].timestamp.ns);
+
+		zbx_history_value2str(buffer, sizeof(buffer), &values->values[i].value, value_type);
+		zbx_snprintf(msg, sizeof(msg), "search #%d value #%d", index, i);
+		zbx_mock_assert_str_eq(msg, zbx_mock_get_object_member_string(hvalue, "value"), buffer);
+	}
+
+	zbx_snprintf(msg, sizeof(msg), "search #%d number of values", index);
+	zbx_mock_assert_int_eq(msg, i, values->values_num);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_vector_history_record_t	*values;
+	zbx_vector_int32_t		reread;
+	struct zbx_json			json;
+	zbx_mock_handle_t		hresponses, hreread, hvalues, hsearch, hdata;
+	unsigned char			value_type;
+	int				searches_num, ret, i;
+	const char			*response;
+
+	ZBX_UNUSED(state);
+
+	value_type = zbx_mock_str_to_value_type(zbx_mock_get_parameter_string("in.value_type"));
+	searches_num = zbx_mock_get_parameter_int("in.searches");
+
+	values = (zbx_vector_history_record_t *)zbx_malloc(NULL, sizeof(zbx_vector_history_record_t) *
+			(size_t)searches_num);
+
+	for (i = 0; i < searches_num; i++)
+		zbx_history_record_vector_create(&values[i]);
+
+	zbx_vector_int32_create(&reread);
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter("in.response", &hdata))
+	{
+		if (ZBX_MOCK_SUCCESS != zbx_mock_string(hdata, &response))
+			fail_msg("Cannot read response");
+
+		ret = elastic_msearch_parse_test(response, value_type, searches_num, values, &reread);
+	}
+	else
+	{
+		hresponses = zbx_mock_get_parameter_handle("in.responses");
+		get_response(hresponses, &json);
+		ret = elastic_msearch_parse_test(json.buffer, value_type, searches_num, values, &reread);
+		zbx_json_free(&json);
+	}
+
+	zbx_mock_assert_result_eq("elastic_msearch_parse return value",
+			zbx_mock_str_to_return_code(zbx_mock_get_parameter_string("out.return")), ret);
+
+	if (SUCCEED == ret)
+	{
+		hreread = zbx_mock_get_parameter_handle("out.reread");
+
+		for (i = 0; ZBX_MOCK_SUCCESS == zbx_mock_vector_element(hreread, &hdata); i++)
+		{
+			int	index;
+
+			if (ZBX_MOCK_SUCCESS != zbx_mock_int(hdata, &index))
+				fail_msg("Cannot read reread index #%d", i);
+
+			if (i >= reread.values_num)
+				fail_msg("expected more than %d searches to reread", reread.values_num);
+
+			zbx_mock_assert_int_eq("reread search index", index, reread.values[i]);
+		}
+
+		zbx_mock_assert_int_eq("number of searches to reread", i, reread.values_num);
+
+		hvalues = zbx_mock_get_parameter_handle("out.values");
+
+		for (i = 0; ZBX_MOCK_SUCCESS == zbx_mock_vector_element(hvalues, &hsearch); i++)
+		{
+			if (i >= searches_num)
+				fail_msg("expected values of more than %d searches", searches_num);
+
+			/* check only the number of values for searches with generated hits */
+			if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hsearch, "count", &hdata))
+			{
+				zbx_mock_assert_int_eq("number of values",
+						zbx_mock_get_object_member_int(hsearch, "count"), values[i].values_num);
+			}
+			else
+			{
+				check_values(zbx_mock_get_object_member_handle(hsearch, "data"), value_type, i,
+						&values[i]);
+			}
+		}
+	}
+
+	for (i = 0; i < searches_num; i++)
+		zbx_history_record_vector_destroy(&values[i], value_type);
+
+	zbx_free(values);
+	zbx_vector_int32_destroy(&reread);
+}
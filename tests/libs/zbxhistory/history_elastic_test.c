@@ -0,0 +1,26 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "history_elastic_test.h"
+
+int	elastic_msearch_parse_test(const char *response, unsigned char value_type, int itemids_num,
+		zbx_vector_history_record_t *values, zbx_vector_int32_t *reread)
+{
+	return elastic_msearch_parse(response, value_type, itemids_num, values, reread);
+}
+
+int	elastic_bulk_compress_test(char **buf, char **bulk_buf, size_t *bulk_size)
+{
+	return elastic_bulk_compress(buf, bulk_buf, bulk_size);
+}
@@ -0,0 +1,181 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockutil.h"
+#include "zbxmockassert.h"
+#include "zbxcommon.h"
+#include "zbxvariant.h"
+#include "zbxsysinfo.h"
+
+#include "../../../src/libs/zbxpreproc/pp_protocol.c"
+
+static unsigned char	mock_str_to_variant(const char *str)
+{
+	if (0 == strcmp(str, "ZBX_VARIANT_ERR"))
+		return ZBX_VARIANT_ERR;
+
+	return zbx_mock_str_to_variant(str);
+}
+
+static void	mock_cache_value(zbx_mock_handle_t hvalue)
+{
+	AGENT_RESULT		result;
+	zbx_log_t		*log;
+	zbx_timespec_t		ts;
+	const char		*type, *value, *error = NULL;
+	unsigned char		state = ITEM_STATE_NORMAL;
+	zbx_mock_handle_t	handle;
+
+	zbx_init_agent_result(&result);
+
+	type = zbx_mock_get_object_member_string(hvalue, "type");
+	value = zbx_mock_get_object_member_string(hvalue, "value");
+
+	if (0 == strcmp(type, "ui64"))
+		SET_UI64_RESULT(&result, zbx_mock_get_object_member_uint64(hvalue, "value"));
+	else if (0 == strcmp(type, "dbl"))
+		SET_DBL_RESULT(&result, zbx_mock_get_object_member_float(hvalue, "value"));
+	else if (0 == strcmp(type, "str"))
+		SET_STR_RESULT(&result, zbx_strdup(NULL, value));
+	else if (0 == strcmp(type, "text"))
+		SET_TEXT_RESULT(&result, zbx_strdup(NULL, value));
+	else if (0 == strcmp(type, "msg"))
+		SET_MSG_RESULT(&result, zbx_strdup(NULL, value));
+	else if (0 == strcmp(type, "log"))
+	{
+		log = (zbx_log_t *)zbx_malloc(NULL, sizeof(zbx_log_t));
+		log->value = zbx_strdup(NULL, value);
+		log->source = zbx_strdup(NULL, zbx_mock_get_object_member_string(hvalue, "source"));
+		log->timestamp = zbx_mock_get_object_member_int(hvalue, "timestamp");
+		log->severity = zbx_mock_get_object_member_int(hvalue, "severity");
+		log->logeventid = zbx_mock_get_object_member_int(hvalue, "logeventid");
+		SET_LOG_RESULT(&result, log);
+	}
+	else if (0 != strcmp(type, "none"))
+		fail_msg("unknown value type \"%s\"", type);
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hvalue, "lastlogsize", &handle))
+	{
+		zbx_set_agent_result_meta(&result, zbx_mock_get_object_member_uint64(hvalue, "lastlogsize"),
+				zbx_mock_get_object_member_int(hvalue, "mtime"));
+	}
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hvalue, "error", &handle))
+	{
+		state = ITEM_STATE_NOTSUPPORTED;
+
+		if (ZBX_MOCK_SUCCESS != zbx_mock_string(handle, &error))
+			error = NULL;
+	}
+
+	if (ZBX_MOCK_SUCCESS != zbx_strtime_to_timespec(zbx_mock_get_object_member_string(hvalue, "ts"), &ts))
+		fail_msg("invalid value timestamp");
+
+	zbx_preprocess_item_value(zbx_mock_get_object_member_uint64(hvalue, "itemid"), 0,
+			ITEM_VALUE_TYPE_TEXT, 0, &result, &ts, state, (char *)error);
+
+	zbx_free_agent_result(&result);
+}
+
+static void	mock_check_value(zbx_mock_handle_t hvalue, zbx_uint64_t itemid, const zbx_variant_t *value,
+		const zbx_timespec_t *ts, const zbx_pp_value_opt_t *opt)
+{
+	zbx_timespec_t		ts_exp;
+	zbx_mock_handle_t	handle;
+	const char		*value_exp;
+
+	zbx_mock_assert_uint64_eq("itemid", zbx_mock_get_object_member_uint64(hvalue, "itemid"), itemid);
+	zbx_mock_assert_int_eq("variant type",
+			mock_str_to_variant(zbx_mock_get_object_member_string(hvalue, "variant")), value->type);
+
+	value_exp = zbx_mock_get_object_member_string(hvalue, "value");
+	zbx_mock_assert_str_eq("value", value_exp, zbx_variant_value_desc(value));
+
+	if (ZBX_MOCK_SUCCESS != zbx_strtime_to_timespec(zbx_mock_get_object_member_string(hvalue, "ts"), &ts_exp))
+		fail_msg("invalid value timestamp");
+
+	zbx_mock_assert_timespec_eq("timestamp", &ts_exp, ts);
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hvalue, "source", &handle))
+	{
+		zbx_mock_assert_int_eq("log flag", ZBX_PP_VALUE_OPT_LOG, opt->flags & ZBX_PP_VALUE_OPT_LOG);
+		zbx_mock_assert_str_eq("source", zbx_mock_get_object_member_string(hvalue, "source"), opt->source);
+		zbx_mock_assert_int_eq("severity", zbx_mock_get_object_member_int(hvalue, "severity"),
+				opt->severity);
+	}
+	else
+		zbx_mock_assert_int_eq("log flag", 0, opt->flags & ZBX_PP_VALUE_OPT_LOG);
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hvalue, "lastlogsize", &handle))
+	{
+		zbx_mock_assert_int_eq("meta flag", ZBX_PP_VALUE_OPT_META, opt->flags & ZBX_PP_VALUE_OPT_META);
+		zbx_mock_assert_uint64_eq("lastlogsize", zbx_mock_get_object_member_uint64(hvalue, "lastlogsize"),
+				opt->lastlogsize);
+		zbx_mock_assert_int_eq("mtime", zbx_mock_get_object_member_int(hvalue, "mtime"), opt->mtime);
+	}
+	else
+		zbx_mock_assert_int_eq("meta flag", 0, opt->flags & ZBX_PP_VALUE_OPT_META);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_mock_handle_t	hvalues, hvalue;
+	zbx_pp_batch_t		batch;
+	zbx_uint32_t		size;
+	zbx_uint64_t		itemid;
+	unsigned char		value_type, flags;
+	zbx_variant_t		value;
+	zbx_timespec_t		ts;
+	zbx_pp_value_opt_t	opt;
+	int			ret;
+
+	ZBX_UNUSED(state);
+
+	hvalues = zbx_mock_get_parameter_handle("in.values");
+
+	while (ZBX_MOCK_SUCCESS == zbx_mock_vector_element(hvalues, &hvalue))
+		mock_cache_value(hvalue);
+
+	size = preprocessor_pack_cached_values();
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("in.truncate"))
+		size -= zbx_mock_get_parameter_uint32("in.truncate");
+
+	ret = zbx_preprocessor_unpack_batch(&batch, cached_data, size);
+	zbx_mock_assert_result_eq("unpack batch", zbx_mock_str_to_return_code(zbx_mock_get_parameter_string(
+			"out.return")), ret);
+
+	if (SUCCEED != ret)
+		return;
+
+	hvalues = zbx_mock_get_parameter_handle("out.values");
+
+	while (SUCCEED == zbx_preprocessor_batch_next(&batch, &itemid, &value_type, &flags, &value, &ts, &opt))
+	{
+		if (ZBX_MOCK_SUCCESS != zbx_mock_vector_element(hvalues, &hvalue))
+			fail_msg("unexpected value of item " ZBX_FS_UI64, itemid);
+
+		mock_check_value(hvalue, itemid, &value, &ts, &opt);
+
+		zbx_variant_clear(&value);
+		zbx_pp_value_opt_clear(&opt);
+	}
+
+	if (ZBX_MOCK_END_OF_VECTOR != zbx_mock_vector_element(hvalues, &hvalue))
+		fail_msg("less values unpacked than expected");
+
+	zbx_mock_assert_uint64_eq("unpacked values", batch.values_num, batch.index);
+}
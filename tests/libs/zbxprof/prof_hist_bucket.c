@@ -0,0 +1,45 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "../../../src/libs/zbxprof/prof.c"
+
+void	zbx_mock_test_entry(void **state)
+{
+#ifdef ZBX_PROF_PROBES
+	zbx_uint64_t	ticks, bound;
+	int		index;
+
+	ZBX_UNUSED(state);
+
+	ticks = zbx_mock_get_parameter_uint64("in.ticks");
+
+	index = prof_hist_index(ticks);
+	zbx_mock_assert_int_eq("bucket index", (int)zbx_mock_get_parameter_uint64("out.index"), index);
+
+	bound = prof_hist_bound(index);
+	zbx_mock_assert_uint64_eq("bucket bound", zbx_mock_get_parameter_uint64("out.bound"), bound);
+
+	/* the last bucket collects all values above histogram range */
+	if (prof_hist_index(ZBX_MAX_UINT64) != index)
+		zbx_mock_assert_int_eq("value below bound", 1, ticks < bound);
+#else
+	ZBX_UNUSED(state);
+	skip();
+#endif
+}
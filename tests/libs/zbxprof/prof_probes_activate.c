@@ -0,0 +1,62 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "../../../src/libs/zbxprof/prof.c"
+
+void	zbx_mock_test_entry(void **state)
+{
+#ifdef ZBX_PROF_PROBES
+	zbx_prof_shmem_t	*shmem;
+	int			slots_num, slots_used;
+	size_t			size;
+
+	ZBX_UNUSED(state);
+
+	slots_num = (int)zbx_mock_get_parameter_uint64("in.slots_num");
+	slots_used = (int)zbx_mock_get_parameter_uint64("in.slots_used");
+
+	size = sizeof(zbx_prof_shmem_t) + sizeof(zbx_prof_slot_t) * (size_t)(slots_num - 1);
+	shmem = (zbx_prof_shmem_t *)zbx_malloc(NULL, size);
+	memset(shmem, 0, size);
+	shmem->slots_num = slots_num;
+	shmem->slots_used = slots_used;
+	prof_shmem = shmem;
+
+	prof_probes_activate();
+
+	zbx_mock_assert_int_eq("probes active", (int)zbx_mock_get_parameter_uint64("out.active"),
+			NULL != prof_slot_active);
+
+	/* a thread without free slot must not disable probes of other threads */
+	zbx_mock_assert_ptr_eq("shared histograms", shmem, prof_shmem);
+
+	zbx_prof_probe_start(ZBX_PROF_PROBE_DB_QUERY);
+	zbx_prof_probe_end(ZBX_PROF_PROBE_DB_QUERY);
+
+	if (NULL != prof_slot_active)
+		zbx_mock_assert_uint64_eq("probe samples", 1, prof_slot_active->hist[ZBX_PROF_PROBE_DB_QUERY].count);
+
+	prof_probes_deactivate();
+	prof_shmem = NULL;
+	zbx_free(shmem);
+#else
+	ZBX_UNUSED(state);
+	skip();
+#endif
+}
@@ -49,6 +49,8 @@ void	__wrap___zbx_shmem_free(const char *file, int line, zbx_shmem_info_t *info,
 void	__wrap_zbx_shmem_dump_stats(int level, zbx_shmem_info_t *info);
 int	__wrap_zbx_history_get_values(zbx_uint64_t itemid, int value_type, int start, int count, int end,
 		zbx_vector_history_record_t *values);
+int	__wrap_zbx_history_get_values_multi(const zbx_vector_uint64_t *itemids, int value_type, int start, int end,
+		zbx_vector_history_record_t *values);
 int	__wrap_zbx_history_add_values(const zbx_vector_ptr_t *history);
 void	__wrap_zbx_history_sql_init(zbx_history_iface_t *hist, unsigned char value_type);
 int	__wrap_zbx_history_elastic_init(zbx_history_iface_t *hist, unsigned char value_type, int config_log_slow_queries, char **error);
@@ -499,6 +501,12 @@ void	__wrap_zbx_mutex_destroy(zbx_mutex_t *mutex)
 int	__wrap_zbx_shmem_create(zbx_shmem_info_t **info, zbx_uint64_t size, const char *descr, const char *param,
 		int allow_oom, char **error)
 {
+	/* track free memory of the wrapped allocator to support cache memory checks */
+	vc_meminfo = (zbx_shmem_info_t *)zbx_malloc(NULL, sizeof(zbx_shmem_info_t));
+	memset(vc_meminfo, 0, sizeof(zbx_shmem_info_t));
+	vc_meminfo->total_size = vcmock_mem;
+	vc_meminfo->free_size = vcmock_mem;
+
 	*info = vc_meminfo;
 	ZBX_UNUSED(size);
 	ZBX_UNUSED(descr);
@@ -511,7 +519,10 @@ int	__wrap_zbx_shmem_create(zbx_shmem_info_t **info, zbx_uint64_t size, const ch
 
 void	__wrap_zbx_shmem_destroy(zbx_shmem_info_t *info)
 {
+	zbx_mock_assert_ptr_eq("Attempting to destroy unknown memory info block", vc_meminfo, info);
+
 	zbx_free(info);
+	vc_meminfo = NULL;
 }
 
 void	*__wrap___zbx_shmem_malloc(const char *file, int line, zbx_shmem_info_t *info, const void *old, size_t size)
@@ -529,6 +540,7 @@ void	*__wrap___zbx_shmem_malloc(const char *file, int line, zbx_shmem_info_t *in
 
 	psize = (size_t *)zbx_malloc(NULL, size + sizeof(size_t));
 	vcmock_mem -= size;
+	vc_meminfo->free_size = vcmock_mem;
 	*psize = size;
 
 	return (void *)(psize + 1);
@@ -550,6 +562,7 @@ void	*__wrap___zbx_shmem_realloc(const char *file, int line, zbx_shmem_info_t *i
 
 	psize = (size_t *)zbx_realloc(psize, size + sizeof(size_t));
 	vcmock_mem -= size;
+	vc_meminfo->free_size = vcmock_mem;
 	*psize = size;
 
 	return (void *)(psize + 1);
@@ -570,6 +583,7 @@ void	__wrap___zbx_shmem_free(const char *file, int line, zbx_shmem_info_t *info,
 	psize = (size_t *)((char *)ptr - sizeof(size_t));
 
 	vcmock_mem += *psize;
+	vc_meminfo->free_size = vcmock_mem;
 
 	zbx_free(psize);
 }
@@ -615,6 +629,15 @@ int	__wrap_zbx_history_get_values(zbx_uint64_t itemid, int value_type, int start
 	return SUCCEED;
 }
 
+int	__wrap_zbx_history_get_values_multi(const zbx_vector_uint64_t *itemids, int value_type, int start, int end,
+		zbx_vector_history_record_t *values)
+{
+	for (int i = 0; i < itemids->values_num; i++)
+		__wrap_zbx_history_get_values(itemids->values[i], value_type, start, 0, end, &values[i]);
+
+	return SUCCEED;
+}
+
 int	__wrap_zbx_history_add_values(const zbx_vector_ptr_t *history)
 {
 	int			i;
@@ -684,6 +707,9 @@ int	__wrap_zbx_elastic_version_get(void)
 void	zbx_vcmock_set_available_mem(size_t size)
 {
 	vcmock_mem = size;
+
+	if (NULL != vc_meminfo)
+		vc_meminfo->free_size = vcmock_mem;
 }
 
 /******************************************************************************
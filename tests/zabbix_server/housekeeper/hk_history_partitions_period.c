@@ -0,0 +1,91 @@
+/*
+** Copyright (C) 2001-2025 Zabbix SIA
+**
+** This program is free software: you can redistribute it and/or modify it under the terms of
+** the GNU Affero General Public License as published by the Free Software Foundation, version 3.
+**
+** This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+** without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+** See the GNU Affero General Public License for more details.
+**
+** You should have received a copy of the GNU Affero General Public License along with this program.
+** If not, see <https://www.gnu.org/licenses/>.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "../../../src/zabbix_server/housekeeper/housekeeper_server.c"
+
+static void	mock_read_item_cache(const char *path, zbx_hashset_t *item_cache)
+{
+	zbx_mock_handle_t	hitems, hitem;
+	zbx_mock_error_t	err;
+
+	zbx_hashset_create(item_cache, 10, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+	hitems = zbx_mock_get_parameter_handle(path);
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(hitems, &hitem))))
+	{
+		zbx_hk_item_cache_t	item_record = {0, 0};
+
+		if (ZBX_MOCK_SUCCESS != err || ZBX_MOCK_SUCCESS != (err = zbx_mock_uint64(hitem, &item_record.itemid)))
+			fail_msg("Cannot read cached itemid: %s", zbx_mock_error_string(err));
+
+		zbx_hashset_insert(item_cache, &item_record, sizeof(item_record));
+	}
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_hk_history_rule_t	rules[2];
+	unsigned char		mode = ZBX_HK_MODE_REGULAR, global;
+	int			period, history = 0, ret, now;
+	const char		*invalid;
+
+	ZBX_UNUSED(state);
+
+	memset(rules, 0, sizeof(rules));
+
+	global = (0 == strcmp(zbx_mock_get_parameter_string("in.override"), "yes") ? ZBX_HK_OPTION_ENABLED :
+			ZBX_HK_OPTION_DISABLED);
+	period = zbx_mock_get_parameter_int("in.period");
+	now = zbx_mock_get_parameter_int("in.now");
+
+	/* the first rule is the tested table, the second is the table of the item current value type */
+	for (int i = 0; i < 2; i++)
+	{
+		rules[i].table = (0 == i ? "history" : "history_uint");
+		rules[i].poption_mode = &mode;
+		rules[i].poption_global = &global;
+		rules[i].poption = &period;
+		rules[i].history_max = -1;
+	}
+
+	rules[0].history_max = zbx_mock_get_parameter_int("in.history_max");
+	mock_read_item_cache("in.cached", &rules[0].item_cache);
+
+	if (NULL != (invalid = zbx_mock_get_optional_parameter_string("in.invalid")))
+	{
+		zbx_uint64_t	itemid;
+
+		ZBX_STR2UINT64(itemid, invalid);
+		hk_history_item_invalidate(rules, 2, &rules[1], itemid);
+	}
+
+	ret = hk_history_partitions_period(&rules[0], now, &history);
+
+	zbx_mock_assert_result_eq("hk_history_partitions_period() return value",
+			zbx_mock_str_to_return_code(zbx_mock_get_parameter_string("out.return")), ret);
+
+	if (SUCCEED == ret)
+		zbx_mock_assert_int_eq("storage period", zbx_mock_get_parameter_int("out.history"), history);
+
+	zbx_mock_assert_int_eq("current value type table invalidated", NULL == invalid ? 0 : 1,
+			rules[1].history_invalid);
+
+	zbx_hashset_destroy(&rules[0].item_cache);
+}